@@ -32,6 +32,7 @@
 //*	Apr 21,	2024	<MLS> OGMA cameras gave me one of their low-end cameras https://getogma.com/
 //*	Apr 22,	2024	<MLS> Downloaded SDK from https://github.com/OGMAvision/OGMAcamSDK
 //*	Apr 23,	2024	<MLS> Created cameradriver_OGMA.cpp
+//*	Oct 17,	2026	<MLS> Image callback claims a readout slot with AllocateImageBuffer() for every frame
 //*****************************************************************************
 
 
@@ -1152,7 +1153,9 @@ HRESULT				ogmaResult;
 //
 // PDB
 
-			if ((cOGMAcamH != NULL) && (cCameraDataBuffer != NULL))
+			//*	the frame goes into the readout slot, never into the latest frame
+			//*	that a download may be using, PublishFrameSlot() hands it over
+			if ((cOGMAcamH != NULL) && AllocateImageBuffer(0))
 			{
 				//*	we do not want to read the image if an image save is in progress
 
@@ -1194,6 +1197,11 @@ HRESULT				ogmaResult;
 					CONSOLE_DEBUG_W_HEX("failed to pull image, ogmaResult = ", ogmaResult);
 				}
 			}
+			else if (cOGMAcamH != NULL)
+			{
+				//*	every slot is being downloaded, skip this frame
+				CONSOLE_DEBUG("No frame slot to read into");
+			}
 			else
 			{
 				CONSOLE_DEBUG("Internal error");
@@ -27,12 +27,15 @@
 //*	Apr 22,	2022	<MLS> Created cameradriver_sim.cpp
 //*	Mar  4,	2023	<MLS> CONFORMU-camera/simulator -> PASSED!!!!!!!!!!!!!!!!!!!!!
 //*	Jun 18,	2023	<MLS> Added Read_CoolerPowerLevel()
+//*	Oct 16,	2026	<MLS> Added Start_Video(), Stop_Video() and Read_VideoFrame() to drive the video pipeline
 //*****************************************************************************
 
 #if defined(_ENABLE_CAMERA_) && defined(_ENABLE_CAMERA_SIMULATOR_)
 
 #include	<stdlib.h>
 #include	<string.h>
+#include	<unistd.h>
+#include	<sys/time.h>
 
 
 #define _ENABLE_CONSOLE_DEBUG_
@@ -73,6 +76,8 @@ bool		isConnected;
 	cCameraID					=	deviceNum;
 	cCameraIsSiumlated			=	true;
 	cSimulatedState				=   kExposure_Idle;
+	cSimVideoImage				=	NULL;
+	cSimVideoImageLen			=	0;
 	cIsColorCam					=	true;
 	cIsCoolerCam				=	true;
 	strcpy(cDeviceManufAbrev,		"SIM");
@@ -146,6 +151,11 @@ bool		isConnected;
 CameraDriverSIM::~CameraDriverSIM(void)
 {
 	CONSOLE_DEBUG(__FUNCTION__);
+	if (cSimVideoImage != NULL)
+	{
+		free(cSimVideoImage);
+		cSimVideoImage	=	NULL;
+	}
 }
 
 
@@ -428,5 +438,111 @@ int					bytesPerPixel;
 	return(alpacaErrCode);
 }
 
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriverSIM::Start_Video(void)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_NotConnected;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	if (cCommonProp.Connected)
+	{
+		gettimeofday(&cCameraProp.Lastexposure_StartTime, NULL);
+		cSimNextFrameTime						=	cCameraProp.Lastexposure_StartTime;
+		cCameraProp.Lastexposure_duration_us	=	cCurrentExposure_us;
+		cInternalCameraState					=	kCameraState_TakingVideo;
+		alpacaErrCode							=	kASCOM_Err_Success;
+	}
+	else
+	{
+		strcpy(cLastCameraErrMsg, "Not connected");
+		CONSOLE_DEBUG(cLastCameraErrMsg);
+	}
+	return(alpacaErrCode);
+}
+
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriverSIM::Stop_Video(void)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	if (cInternalCameraState != kCameraState_TakingVideo)
+	{
+		alpacaErrCode	=	kASCOM_Err_UnspecifiedError;
+		strcpy(cLastCameraErrMsg, "Camera not taking video");
+	}
+	cInternalCameraState	=	kCameraState_Idle;
+	return(alpacaErrCode);
+}
+
+//*****************************************************************************
+//*	frames come out at the exposure time (no faster than 100 fps) like a real camera,
+//*	if the caller is late the next frame is returned right away
+//*****************************************************************************
+#define	kSimMinFrameTime_us	10000
+
+TYPE_ASCOM_STATUS	CameraDriverSIM::Read_VideoFrame(unsigned char *imageDataPtr, const long imageDataLen)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+int					bytesPerPixel;
+int32_t				frameTime_us;
+long				waitTime_us;
+struct timeval		currentTime;
+
+	if (cSimVideoImageLen != imageDataLen)
+	{
+		//*	the image size changed, draw a new one
+		if (cSimVideoImage != NULL)
+		{
+			free(cSimVideoImage);
+		}
+		cSimVideoImageLen	=	0;
+		cSimVideoImage		=	(unsigned char *)malloc(imageDataLen);
+		if (cSimVideoImage != NULL)
+		{
+			switch(cROIinfo.currentROIimageType)
+			{
+				case kImageType_RAW16:	bytesPerPixel	=	2;	break;
+				case kImageType_RGB24:	bytesPerPixel	=	3;	break;
+				default:				bytesPerPixel	=	1;	break;
+			}
+			CreateFakeImageData(cSimVideoImage, cROIinfo.currentROIwidth, cROIinfo.currentROIheight, bytesPerPixel);
+			cSimVideoImageLen	=	imageDataLen;
+		}
+	}
+
+	if (cSimVideoImage != NULL)
+	{
+		//*	wait for the next frame
+		frameTime_us	=	cCurrentExposure_us;
+		if (frameTime_us < kSimMinFrameTime_us)
+		{
+			frameTime_us	=	kSimMinFrameTime_us;
+		}
+		gettimeofday(&currentTime, NULL);
+		waitTime_us	=	((cSimNextFrameTime.tv_sec - currentTime.tv_sec) * 1000000L) +
+						(cSimNextFrameTime.tv_usec - currentTime.tv_usec);
+		if (waitTime_us > 0)
+		{
+			usleep(waitTime_us);
+		}
+		else
+		{
+			cSimNextFrameTime	=	currentTime;
+		}
+		cSimNextFrameTime.tv_usec	+=	frameTime_us;
+		cSimNextFrameTime.tv_sec	+=	cSimNextFrameTime.tv_usec / 1000000;
+		cSimNextFrameTime.tv_usec	=	cSimNextFrameTime.tv_usec % 1000000;
+
+		memcpy(imageDataPtr, cSimVideoImage, imageDataLen);
+	}
+	else
+	{
+		alpacaErrCode	=	kASCOM_Err_FailedToTakePicture;
+		strcpy(cLastCameraErrMsg, "Failed to allocate simulated video image");
+		CONSOLE_DEBUG(cLastCameraErrMsg);
+	}
+	return(alpacaErrCode);
+}
 
 #endif // defined(_ENABLE_CAMERA_) && defined(_ENABLE_CAMERA_SIMULATOR_)
@@ -17,6 +17,7 @@
 //*	<MLS>	=	Mark L Sproul
 //*****************************************************************************
 //*	May  4,	2022	<MLS> Created cameradriver_sim.h
+//*	Oct 16,	2026	<MLS> Added video simulation, Start_Video(), Stop_Video(), Read_VideoFrame()
 //*****************************************************************************
 //#include	"cameradriver_sim.h"
 
@@ -72,9 +73,9 @@ class CameraDriverSIM: public CameraDriver
 		virtual	TYPE_ASCOM_STATUS		Read_Offset(int *cameraOffsetValue);
 		virtual	TYPE_ASCOM_STATUS		Write_Offset(const int newOffsetValue);
 //
-//		virtual	TYPE_ASCOM_STATUS		Start_Video(void);
-//		virtual	TYPE_ASCOM_STATUS		Stop_Video(void);
-//		virtual	TYPE_ASCOM_STATUS		Take_Video(void);
+		virtual	TYPE_ASCOM_STATUS		Start_Video(void);
+		virtual	TYPE_ASCOM_STATUS		Stop_Video(void);
+		virtual	TYPE_ASCOM_STATUS		Read_VideoFrame(unsigned char *imageDataPtr, const long imageDataLen);
 //
 //		virtual	TYPE_ASCOM_STATUS		SetFlipMode(const int newFlipMode);
 //
@@ -95,5 +96,10 @@ class CameraDriverSIM: public CameraDriver
 	protected:
 		TYPE_EXPOSURE_STATUS			cSimulatedState;
 
+		//*	the fake image is drawn once, each video frame is a copy of it
+		unsigned char					*cSimVideoImage;
+		long							cSimVideoImageLen;
+		struct timeval					cSimNextFrameTime;
+
 };
 #endif // _CAMERA_DRIVER_SIM_H_
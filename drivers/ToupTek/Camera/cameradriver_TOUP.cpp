@@ -44,6 +44,7 @@
 //*	Mar  1,	2021	<PDB> Camera working in 16bit mode, reading image properly
 //*	Aug 27,	2023	<MLS> Updated Makefile to compile toup and touppi properly
 //*	Aug 27,	2023	<MLS> Changed to if (SUCCEEDED(toupResult)) as per .h file
+//*	Oct 17,	2026	<MLS> Image callback claims a readout slot with AllocateImageBuffer() for every frame
 //-----------------------------------------------------------------------------
 //*	Feb  4,	2120	<TODO> Add 16 bit readout to Toupcam
 //*	Feb 16,	2120	<TODO> Add gain setting to Toupcam
@@ -1009,7 +1010,9 @@ HRESULT				toupResult;
 //
 // PDB
 
-			if ((cToupCamH != NULL) && (cCameraDataBuffer != NULL))
+			//*	the frame goes into the readout slot, never into the latest frame
+			//*	that a download may be using, PublishFrameSlot() hands it over
+			if ((cToupCamH != NULL) && AllocateImageBuffer(0))
 			{
 				//*	we do not want to read the image if an image save is in progress
 
@@ -1051,6 +1054,11 @@ HRESULT				toupResult;
 					CONSOLE_DEBUG_W_HEX("failed to pull image, toupResult = ", toupResult);
 				}
 			}
+			else if (cToupCamH != NULL)
+			{
+				//*	every slot is being downloaded, skip this frame
+				CONSOLE_DEBUG("No frame slot to read into");
+			}
 			else
 			{
 				CONSOLE_DEBUG("Internal error");
@@ -61,7 +61,7 @@ class CameraDriverASI: public CameraDriver
 
 		virtual	TYPE_ASCOM_STATUS		Start_Video(void);
 		virtual	TYPE_ASCOM_STATUS		Stop_Video(void);
-		virtual	TYPE_ASCOM_STATUS		Take_Video(void);
+		virtual	TYPE_ASCOM_STATUS		Read_VideoFrame(unsigned char *imageDataPtr, const long imageDataLen);
 
 		virtual	bool					GetImage_ROI_info(void);
 
@@ -8,8 +8,12 @@
 //*		Limitations:
 //*			Does not differentiate nested constructs
 //*			Limited error handling
-//*			Keyword max length of 31 chars
-//*			Value max length of 63 chars
+//*			Keyword max length of 63 chars
+//*			Value max length of 255 chars
+//*
+//*		The results are still put in the fixed token lists that all of the callers use,
+//*		the tokenizing is done by json_tokenizer.c. Code that needs nesting, longer
+//*		strings or more tokens can use the JTK_ routines directly.
 //*
 //*****************************************************************************
 //*	Nov  8,	2018	<MLS> Started on json_parse library
@@ -33,10 +37,15 @@
 //*	Mar  5,	2020	<MLS> Added _DEBUG_ARRAY_
 //*	Mar  5,	2020	<MLS> Fixed bug when there is only one element in an array
 //*	Mar  5,	2020	<MLS> At start of an array, there was a limit of 32 chars for 1st data element
+//*	Oct 17,	2026	<MLS> SJP_ParseData() now uses the in place tokenizer (json_tokenizer.c)
+//*	Oct 17,	2026	<MLS> Old parser kept as SJP_ParseData_Legacy() for comparison
+//*	Oct 17,	2026	<MLS> Added SJP_ParseDataInPlace()
+//*	Oct 17,	2026	<MLS> Token lists are no longer memset on every parse
 //*****************************************************************************
 
 //#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <ctype.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -51,6 +60,12 @@
 
 
 #include	"json_parse.h"
+#include	"json_tokenizer.h"
+
+//*	each thread gets its own tokenizer, the memory is kept from one reply to the next
+static __thread JTK_Parser_t	gTokenizer;
+static __thread char			*gScratchBuffer		=	NULL;
+static __thread size_t			gScratchBufferSize	=	0;
 
 //**************************************************************************************
 void	SJP_Init(SJP_Parser_t *theParserDataStruct)
@@ -63,20 +78,23 @@ short		ii;
 		theParserDataStruct->tokenCount_Data	=	0;
 		theParserDataStruct->tokenCount_Errs	=	0;
 
-		//*	set all the strings to null
+		//*	set all the strings to null, the first char is all it takes
 		for (ii=0; ii < kSJP_MaxTokens_Hdr; ii++)
 		{
-			memset(&theParserDataStruct->headerList[ii], 0, sizeof(SJP_token_t));
+			theParserDataStruct->headerList[ii].keyword[0]		=	0;
+			theParserDataStruct->headerList[ii].valueString[0]	=	0;
 		}
 
 		for (ii=0; ii < kSJP_MaxTokens_Data; ii++)
 		{
-			memset(&theParserDataStruct->dataList[ii], 0, sizeof(SJP_token_t));
+			theParserDataStruct->dataList[ii].keyword[0]		=	0;
+			theParserDataStruct->dataList[ii].valueString[0]	=	0;
 		}
 
 		for (ii=0; ii < kSJP_MaxTokens_Errs; ii++)
 		{
-			memset(&theParserDataStruct->errorList[ii], 0, sizeof(SJP_token_t));
+			theParserDataStruct->errorList[ii].keyword[0]		=	0;
+			theParserDataStruct->errorList[ii].valueString[0]	=	0;
 		}
 	}
 }
@@ -299,11 +317,12 @@ enum
 };
 
 //**************************************************************************************
+//*	the original parser, kept so the output of SJP_ParseData() can be checked against it
 //*	returnCode < 0		Error code
 //*	returnCode == 0		No error
 //**************************************************************************************
-int	SJP_ParseData(	SJP_Parser_t	*theParser,
-					const char 		*jsonDataPtr)
+int	SJP_ParseData_Legacy(	SJP_Parser_t	*theParser,
+							const char 		*jsonDataPtr)
 {
 int			returnCode;
 int			dataLen;
@@ -676,6 +695,252 @@ bool		masterArrayFlag;
 }
 
 
+//**************************************************************************************
+//*	copies a string into a token field, cut off at the field size
+//**************************************************************************************
+static void	SJP_Private_CopyField(char *fieldPtr, const char *theString, const int fieldSize, const bool makeUpperCase)
+{
+int		cc;
+char	theChar;
+
+	cc	=	0;
+	while ((theString[cc] != 0) && (cc < (fieldSize - 1)))
+	{
+		theChar	=	theString[cc];
+		if (makeUpperCase && (theChar >= 'a') && (theChar <= 'z'))
+		{
+			theChar	-=	0x20;
+		}
+		fieldPtr[cc]	=	theChar;
+		cc++;
+	}
+	fieldPtr[cc]	=	0;
+}
+
+//**************************************************************************************
+typedef struct
+{
+	SJP_token_t		*tokenList;
+	short			*tokenCount;
+	int				tokenMax;
+	int				returnCode;
+} SJP_OutputList_t;
+
+//**************************************************************************************
+//*	entries with no keyword and no value are dropped, same as the old parser did
+//**************************************************************************************
+static void	SJP_Private_AddEntry(	SJP_OutputList_t	*outputList,
+									const char			*keyword,
+									const char			*valueString,
+									const bool			upperCaseValue)
+{
+SJP_token_t	*newEntry;
+
+	if ((keyword[0] != 0) || (valueString[0] != 0))
+	{
+		if (*outputList->tokenCount < outputList->tokenMax)
+		{
+			newEntry	=	&outputList->tokenList[*outputList->tokenCount];
+			SJP_Private_CopyField(newEntry->keyword,		keyword,		kSJP_MaxKeyLen,		true);
+			SJP_Private_CopyField(newEntry->valueString,	valueString,	kSJP_MaxValueLen,	upperCaseValue);
+			(*outputList->tokenCount)++;
+		}
+		else
+		{
+			outputList->returnCode	=	SJP_ExceededTokenCnt;
+		}
+	}
+}
+
+//**************************************************************************************
+static void	SJP_Private_EmptyEntry(SJP_token_t *tokenList, const int tokenIdx, const int tokenMax)
+{
+	if (tokenIdx < tokenMax)
+	{
+		tokenList[tokenIdx].keyword[0]		=	0;
+		tokenList[tokenIdx].valueString[0]	=	0;
+	}
+}
+
+//**************************************************************************************
+//*	turns the token tree back into the flat list the callers expect,
+//*	keys in upper case, "ARRAY", "ARRAY-NEXT" and "]" entries for the arrays
+//**************************************************************************************
+static int	SJP_Private_FillTokenLists(SJP_Parser_t *theParser, const JTK_Parser_t *tokenizer)
+{
+SJP_OutputList_t	outputList;
+const JTK_token_t	*token;
+const char			*keyword;
+uint32_t			tknIdx;
+int					openIdx;
+bool				masterArrayFlag;
+bool				firstInArray;
+bool				inArray;
+char				firstChar;
+
+	//*	the lists are not cleared, everything up to the counts gets written
+	//*	and the entry after the last one is emptied at the end
+	theParser->tokenCount_Hdr	=	0;
+	theParser->tokenCount_Data	=	0;
+	theParser->tokenCount_Errs	=	0;
+	outputList.tokenList	=	theParser->dataList;
+	outputList.tokenCount	=	&theParser->tokenCount_Data;
+	outputList.tokenMax		=	kSJP_MaxTokens_Data;
+	outputList.returnCode	=	0;
+
+	masterArrayFlag	=	false;
+	firstInArray	=	false;
+	openIdx			=	-1;
+	for (tknIdx=0; tknIdx <= tokenizer->tokenCnt; tknIdx++)
+	{
+		//*	close the objects and arrays that end in front of this token
+		while ((openIdx >= 0) && (tokenizer->tokens[openIdx].endIdx <= tknIdx))
+		{
+			if (tokenizer->tokens[openIdx].type == kJTK_Array)
+			{
+				SJP_Private_AddEntry(&outputList, "]", "", false);
+				masterArrayFlag	=	false;
+			}
+			else if (masterArrayFlag)
+			{
+				SJP_Private_AddEntry(&outputList, "ARRAY-NEXT", "", false);
+			}
+			openIdx	=	tokenizer->tokens[openIdx].parentIdx;
+		}
+		if (tknIdx < tokenizer->tokenCnt)
+		{
+			token	=	&tokenizer->tokens[tknIdx];
+			keyword	=	JTK_GetKey(tokenizer, tknIdx);
+			inArray	=	(token->parentIdx >= 0) && (tokenizer->tokens[token->parentIdx].type == kJTK_Array);
+
+			firstChar	=	keyword[0] & 0xdf;		//*	upper case, the only keys to check start with H, D or E
+			if ((firstChar != 'H') && (firstChar != 'D') && (firstChar != 'E'))
+			{
+				//*	not the start of a block
+			}
+			else if (strcasecmp(keyword, "HDR") == 0)
+			{
+				outputList.tokenList	=	theParser->headerList;
+				outputList.tokenCount	=	&theParser->tokenCount_Hdr;
+				outputList.tokenMax		=	kSJP_MaxTokens_Hdr;
+				*outputList.tokenCount	=	0;
+			}
+			else if (strcasecmp(keyword, "DATA") == 0)
+			{
+				outputList.tokenList	=	theParser->dataList;
+				outputList.tokenCount	=	&theParser->tokenCount_Data;
+				outputList.tokenMax		=	kSJP_MaxTokens_Data;
+				*outputList.tokenCount	=	0;
+			}
+			else if (strcasecmp(keyword, "ERROR") == 0)
+			{
+				outputList.tokenList	=	theParser->errorList;
+				outputList.tokenCount	=	&theParser->tokenCount_Errs;
+				outputList.tokenMax		=	kSJP_MaxTokens_Errs;
+				*outputList.tokenCount	=	0;
+			}
+
+			switch(token->type)
+			{
+				case kJTK_Object:
+					SJP_Private_AddEntry(&outputList, keyword, "", false);
+					openIdx			=	tknIdx;
+					firstInArray	=	false;
+					break;
+
+				case kJTK_Array:
+					SJP_Private_AddEntry(&outputList, keyword, "", false);
+					SJP_Private_AddEntry(&outputList, "ARRAY", "", false);
+					openIdx			=	tknIdx;
+					masterArrayFlag	=	true;
+					firstInArray	=	true;
+					break;
+
+				default:
+					//*	the old parser upper cased the first value in an array, some code expects that
+					SJP_Private_AddEntry(&outputList, keyword, JTK_GetValue(tokenizer, tknIdx), (inArray && firstInArray));
+					firstInArray	=	false;
+					break;
+			}
+		}
+	}
+	SJP_Private_EmptyEntry(theParser->headerList,	theParser->tokenCount_Hdr,	kSJP_MaxTokens_Hdr);
+	SJP_Private_EmptyEntry(theParser->dataList,		theParser->tokenCount_Data,	kSJP_MaxTokens_Data);
+	SJP_Private_EmptyEntry(theParser->errorList,	theParser->tokenCount_Errs,	kSJP_MaxTokens_Errs);
+	return(outputList.returnCode);
+}
+
+//**************************************************************************************
+//*	jsonData is changed, the strings are decoded and terminated in place.
+//*	an http header in front of the json is skipped
+//*	returnCode < 0		Error code
+//*	returnCode == 0		No error
+//**************************************************************************************
+int	SJP_ParseDataInPlace(	SJP_Parser_t	*theParser,
+							char			*jsonData,
+							const int		dataLen)
+{
+int		returnCode;
+int		jtkReturnCode;
+
+	if ((theParser != NULL) && (jsonData != NULL) && (dataLen >= 0))
+	{
+		JTK_Reset(&gTokenizer);
+		jtkReturnCode	=	JTK_Parse(&gTokenizer, jsonData, dataLen);
+		if (jtkReturnCode != kJTK_Complete)
+		{
+			//*	what was parsed is still used, the old parser did not report bad json either
+			CONSOLE_DEBUG_W_NUM("jtkReturnCode\t=", jtkReturnCode);
+		}
+		returnCode	=	SJP_Private_FillTokenLists(theParser, &gTokenizer);
+	}
+	else
+	{
+		returnCode	=	SJP_InvalidParameter;
+	}
+	return(returnCode);
+}
+
+//**************************************************************************************
+//*	returnCode < 0		Error code
+//*	returnCode == 0		No error
+//**************************************************************************************
+int	SJP_ParseData(	SJP_Parser_t	*theParser,
+					const char 		*jsonDataPtr)
+{
+int		returnCode;
+size_t	dataLen;
+char	*newBuffer;
+
+	returnCode	=	SJP_InvalidParameter;
+	if ((theParser != NULL) && (jsonDataPtr != NULL))
+	{
+		//*	the tokenizer works in place, the caller's data is left alone
+		dataLen	=	strlen(jsonDataPtr);
+		if ((dataLen + 1) > gScratchBufferSize)
+		{
+			newBuffer	=	(char *)realloc(gScratchBuffer, dataLen + 1);
+			if (newBuffer != NULL)
+			{
+				gScratchBuffer		=	newBuffer;
+				gScratchBufferSize	=	dataLen + 1;
+			}
+		}
+		if ((dataLen + 1) <= gScratchBufferSize)
+		{
+			memcpy(gScratchBuffer, jsonDataPtr, dataLen + 1);
+			returnCode	=	SJP_ParseDataInPlace(theParser, gScratchBuffer, dataLen);
+		}
+		else
+		{
+			CONSOLE_DEBUG("Out of memory");
+			returnCode	=	SJP_ParseData_Legacy(theParser, jsonDataPtr);
+		}
+	}
+	return(returnCode);
+}
+
+
 //*****************************************************************************
 //*	find a token in the table,
 //*	stops when the there is an empty element in the table
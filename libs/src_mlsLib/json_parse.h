@@ -7,6 +7,7 @@
 //*
 //*****************************************************************************
 //*	Oct 16,	2019	<MLS> Changed some int's to short's to save memory
+//*	Oct 17,	2026	<MLS> Added SJP_ParseDataInPlace() and SJP_ParseData_Legacy()
 //*****************************************************************************
 //#include	"json_parse.h"
 
@@ -98,6 +99,8 @@ typedef struct
 void	SJP_Init(SJP_Parser_t *theParserDataStruct);
 long	SJP_GetVersion(void);
 int		SJP_ParseData(SJP_Parser_t *theParser, const char  *jsonDataPtr);
+int		SJP_ParseDataInPlace(SJP_Parser_t *theParser, char *jsonData, const int dataLen);
+int		SJP_ParseData_Legacy(SJP_Parser_t *theParser, const char  *jsonDataPtr);
 bool	SJP_FindKeyWordString(const char *keyWord, SJP_token_t *tokenList, const short tokenCnt, char *valueString);
 void	SJP_DumpJsonData(SJP_Parser_t *theParser, const char *callingFunctionName);
 
@@ -0,0 +1,719 @@
+//*****************************************************************************
+//*	json_tokenizer.c
+//*		in place json tokenizer
+//*		written by Mark Sproul
+//*		unlimited use rights, modify and use as you wish
+//*
+//*		Nothing is copied, the tokens are offsets into the data that was
+//*		received. Strings are decoded in place (an escape is never shorter than
+//*		what it decodes to) and every value is null terminated where it sits.
+//*		There is no limit on the length of a key or value or on the number of tokens.
+//*
+//*		Nested objects and arrays are kept as a tree, each token knows its
+//*		parent and an object/array knows where its contents end.
+//*
+//*		Keys are put in a hash table as they are found, JTK_FindKey() is a
+//*		case insensitive lookup that does not depend on the number of tokens.
+//*
+//*		If the data ends in the middle, JTK_Parse() returns kJTK_NeedMore and
+//*		picks up where it left off when called again with more data.
+//*
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created json_tokenizer.c
+//*****************************************************************************
+
+#include	<string.h>
+#include	<strings.h>
+#include	<stdbool.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdio.h>
+
+//#define	_ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"json_tokenizer.h"
+
+#define	kJTK_StartTokenCnt		64
+#define	kJTK_StartHashSize		128
+
+//*****************************************************************************
+//*	what the tokenizer is expecting next
+enum
+{
+	kState_Start	=	0,		//*	skipping anything in front of the json
+	kState_KeyOrEnd,			//*	just after '{'
+	kState_Key,					//*	after a ',' in an object
+	kState_Colon,
+	kState_ValueOrEnd,			//*	just after '['
+	kState_Value,
+	kState_CommaOrEnd,
+	kState_Done
+};
+
+//*****************************************************************************
+void	JTK_Init(JTK_Parser_t *theParser)
+{
+	if (theParser != NULL)
+	{
+		memset(theParser, 0, sizeof(JTK_Parser_t));
+		JTK_Reset(theParser);
+	}
+}
+
+//*****************************************************************************
+void	JTK_Free(JTK_Parser_t *theParser)
+{
+	if (theParser != NULL)
+	{
+		if (theParser->tokens != NULL)
+		{
+			free(theParser->tokens);
+		}
+		if (theParser->hashTable != NULL)
+		{
+			free(theParser->hashTable);
+		}
+		memset(theParser, 0, sizeof(JTK_Parser_t));
+	}
+}
+
+//*****************************************************************************
+//*	ready for a new document, the memory is kept
+//*****************************************************************************
+void	JTK_Reset(JTK_Parser_t *theParser)
+{
+	if (theParser != NULL)
+	{
+		theParser->jsonData			=	NULL;
+		theParser->tokenCnt			=	0;
+		theParser->parseOffset		=	0;
+		theParser->openIdx			=	-1;
+		theParser->pendingKeyOffset	=	kJTK_NoKey;
+		theParser->state			=	kState_Start;
+		if (theParser->hashTable != NULL)
+		{
+			//*	all 0xff bytes is -1
+			memset(theParser->hashTable, 0xff, theParser->hashSize * sizeof(int32_t));
+		}
+	}
+}
+
+//*****************************************************************************
+static uint32_t	HashKey(const char *keyWord)
+{
+uint32_t	hashValue;
+uint8_t		theChar;
+
+	//*	FNV-1a on the lower case chars
+	hashValue	=	2166136261u;
+	while (*keyWord != 0)
+	{
+		theChar	=	*keyWord;
+		if ((theChar >= 'A') && (theChar <= 'Z'))
+		{
+			theChar	+=	0x20;
+		}
+		hashValue	^=	theChar;
+		hashValue	*=	16777619u;
+		keyWord++;
+	}
+	return(hashValue);
+}
+
+//*****************************************************************************
+static void	AddToHashTable(JTK_Parser_t *theParser, const int tokenIdx)
+{
+uint32_t	bucketIdx;
+
+	bucketIdx	=	HashKey(&theParser->jsonData[theParser->tokens[tokenIdx].keyOffset]) & (theParser->hashSize - 1);
+	theParser->tokens[tokenIdx].nextInBucket	=	theParser->hashTable[bucketIdx];
+	theParser->hashTable[bucketIdx]				=	tokenIdx;
+}
+
+//*****************************************************************************
+//*	keeps the table at least twice the number of tokens
+//*****************************************************************************
+static bool	GrowHashTable(JTK_Parser_t *theParser)
+{
+int32_t		*newTable;
+uint32_t	newSize;
+uint32_t	iii;
+bool		growOK;
+
+	growOK		=	true;
+	newSize		=	(theParser->hashSize > 0) ? (theParser->hashSize * 2) : kJTK_StartHashSize;
+	newTable	=	(int32_t *)realloc(theParser->hashTable, newSize * sizeof(int32_t));
+	if (newTable != NULL)
+	{
+		theParser->hashTable	=	newTable;
+		theParser->hashSize		=	newSize;
+		for (iii=0; iii<newSize; iii++)
+		{
+			theParser->hashTable[iii]	=	-1;
+		}
+		for (iii=0; iii<theParser->tokenCnt; iii++)
+		{
+			if (theParser->tokens[iii].keyOffset != kJTK_NoKey)
+			{
+				AddToHashTable(theParser, iii);
+			}
+		}
+	}
+	else
+	{
+		growOK	=	false;
+	}
+	return(growOK);
+}
+
+//*****************************************************************************
+//*	returns the new token index or -1 if out of memory
+//*****************************************************************************
+static int	AddToken(	JTK_Parser_t	*theParser,
+						const int		tokenType,
+						const uint32_t	valueOffset,
+						const uint32_t	valueLen)
+{
+JTK_token_t	*newTokens;
+JTK_token_t	*token;
+uint32_t	newMax;
+int			tokenIdx;
+
+	tokenIdx	=	-1;
+	if (theParser->tokenCnt >= theParser->tokenMax)
+	{
+		newMax		=	(theParser->tokenMax > 0) ? (theParser->tokenMax * 2) : kJTK_StartTokenCnt;
+		newTokens	=	(JTK_token_t *)realloc(theParser->tokens, newMax * sizeof(JTK_token_t));
+		if (newTokens != NULL)
+		{
+			theParser->tokens	=	newTokens;
+			theParser->tokenMax	=	newMax;
+		}
+	}
+	if ((theParser->tokenCnt * 2) >= theParser->hashSize)
+	{
+		GrowHashTable(theParser);
+	}
+	if ((theParser->tokenCnt < theParser->tokenMax) && ((theParser->tokenCnt * 2) < theParser->hashSize))
+	{
+		tokenIdx				=	theParser->tokenCnt;
+		token					=	&theParser->tokens[tokenIdx];
+		token->keyOffset		=	theParser->pendingKeyOffset;
+		token->valueOffset		=	valueOffset;
+		token->valueLen			=	valueLen;
+		token->endIdx			=	tokenIdx + 1;
+		token->parentIdx		=	theParser->openIdx;
+		token->nextInBucket		=	-1;
+		token->depth			=	0;
+		token->type				=	tokenType;
+		if (theParser->openIdx >= 0)
+		{
+			token->depth	=	theParser->tokens[theParser->openIdx].depth + 1;
+		}
+		theParser->tokenCnt++;
+		if (token->keyOffset != kJTK_NoKey)
+		{
+			AddToHashTable(theParser, tokenIdx);
+		}
+		theParser->pendingKeyOffset	=	kJTK_NoKey;
+	}
+	return(tokenIdx);
+}
+
+//*****************************************************************************
+static int	HexValue(const char theChar)
+{
+int		hexValue;
+
+	hexValue	=	0;
+	if ((theChar >= '0') && (theChar <= '9'))
+	{
+		hexValue	=	theChar - '0';
+	}
+	else if ((theChar >= 'a') && (theChar <= 'f'))
+	{
+		hexValue	=	theChar - 'a' + 10;
+	}
+	else if ((theChar >= 'A') && (theChar <= 'F'))
+	{
+		hexValue	=	theChar - 'A' + 10;
+	}
+	return(hexValue);
+}
+
+//*****************************************************************************
+static uint32_t	Get4Hex(const char *hexPtr)
+{
+	return((HexValue(hexPtr[0]) << 12) | (HexValue(hexPtr[1]) << 8) | (HexValue(hexPtr[2]) << 4) | HexValue(hexPtr[3]));
+}
+
+//*****************************************************************************
+//*	the string starts just after the opening quote.
+//*	returns false if the closing quote has not arrived yet, nothing is changed in that case.
+//*	otherwise the escapes are decoded in place, the string is null terminated,
+//*	*stringLen is the decoded length and *nextOffset is just past the closing quote.
+//*****************************************************************************
+static bool	ReadString(	char			*jsonData,
+						const uint32_t	dataLen,
+						const uint32_t	startOffset,
+						uint32_t		*stringLen,
+						uint32_t		*nextOffset)
+{
+uint32_t	srcIdx;
+uint32_t	dstIdx;
+uint32_t	quoteIdx;
+uint32_t	codePoint;
+uint32_t	lowSurrogate;
+uint32_t	slashCnt;
+char		*quotePtr;
+bool		hasEscapes;
+bool		complete;
+char		theChar;
+
+	//*	find the closing quote first, do not change anything until the whole string is here
+	hasEscapes	=	false;
+	complete	=	false;
+	srcIdx		=	startOffset;
+	while ((complete == false) && (srcIdx < dataLen))
+	{
+		quotePtr	=	(char *)memchr(&jsonData[srcIdx], '"', (dataLen - srcIdx));
+		if (quotePtr != NULL)
+		{
+			quoteIdx	=	quotePtr - jsonData;
+			//*	an odd number of back slashes in front of it means it is escaped
+			slashCnt	=	0;
+			while (((quoteIdx - slashCnt) > startOffset) && (jsonData[quoteIdx - slashCnt - 1] == '\\'))
+			{
+				slashCnt++;
+			}
+			if (slashCnt > 0)
+			{
+				hasEscapes	=	true;
+			}
+			complete	=	((slashCnt & 1) == 0);
+			srcIdx		=	complete ? quoteIdx : (quoteIdx + 1);
+		}
+		else
+		{
+			srcIdx	=	dataLen;
+		}
+	}
+	if (complete && (hasEscapes == false))
+	{
+		hasEscapes	=	(memchr(&jsonData[startOffset], '\\', (srcIdx - startOffset)) != NULL);
+	}
+
+	if (complete)
+	{
+		quoteIdx	=	srcIdx;
+		dstIdx		=	quoteIdx;
+		if (hasEscapes)
+		{
+			srcIdx	=	startOffset;
+			dstIdx	=	startOffset;
+			while (srcIdx < quoteIdx)
+			{
+				theChar	=	jsonData[srcIdx++];
+				if (theChar == '\\')
+				{
+					theChar	=	jsonData[srcIdx++];
+					switch(theChar)
+					{
+						case 'b':	jsonData[dstIdx++]	=	0x08;	break;
+						case 'f':	jsonData[dstIdx++]	=	0x0c;	break;
+						case 'n':	jsonData[dstIdx++]	=	0x0a;	break;
+						case 'r':	jsonData[dstIdx++]	=	0x0d;	break;
+						case 't':	jsonData[dstIdx++]	=	0x09;	break;
+
+						case 'u':
+							codePoint	=	0;
+							if ((srcIdx + 4) <= quoteIdx)
+							{
+								codePoint	=	Get4Hex(&jsonData[srcIdx]);
+								srcIdx		+=	4;
+							}
+							//*	a surrogate pair is 2 escapes
+							if ((codePoint >= 0xd800) && (codePoint <= 0xdbff) &&
+								((srcIdx + 6) <= quoteIdx) && (jsonData[srcIdx] == '\\') && (jsonData[srcIdx + 1] == 'u'))
+							{
+								lowSurrogate	=	Get4Hex(&jsonData[srcIdx + 2]);
+								if ((lowSurrogate >= 0xdc00) && (lowSurrogate <= 0xdfff))
+								{
+									codePoint	=	0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+									srcIdx		+=	6;
+								}
+							}
+							//*	utf-8, never longer than the escape it came from
+							if (codePoint < 0x80)
+							{
+								jsonData[dstIdx++]	=	codePoint;
+							}
+							else if (codePoint < 0x800)
+							{
+								jsonData[dstIdx++]	=	0xc0 | (codePoint >> 6);
+								jsonData[dstIdx++]	=	0x80 | (codePoint & 0x3f);
+							}
+							else if (codePoint < 0x10000)
+							{
+								jsonData[dstIdx++]	=	0xe0 | (codePoint >> 12);
+								jsonData[dstIdx++]	=	0x80 | ((codePoint >> 6) & 0x3f);
+								jsonData[dstIdx++]	=	0x80 | (codePoint & 0x3f);
+							}
+							else
+							{
+								jsonData[dstIdx++]	=	0xf0 | (codePoint >> 18);
+								jsonData[dstIdx++]	=	0x80 | ((codePoint >> 12) & 0x3f);
+								jsonData[dstIdx++]	=	0x80 | ((codePoint >> 6) & 0x3f);
+								jsonData[dstIdx++]	=	0x80 | (codePoint & 0x3f);
+							}
+							break;
+
+						//*	", \, / and anything unexpected are taken as is
+						default:
+							jsonData[dstIdx++]	=	theChar;
+							break;
+					}
+				}
+				else
+				{
+					jsonData[dstIdx++]	=	theChar;
+				}
+			}
+		}
+		jsonData[dstIdx]	=	0;
+		*stringLen			=	dstIdx - startOffset;
+		*nextOffset			=	quoteIdx + 1;
+	}
+	return(complete);
+}
+
+//*****************************************************************************
+static bool	IsDelimiter(const char theChar)
+{
+	return(((uint8_t)theChar <= 0x20) || (theChar == ',') || (theChar == '}') || (theChar == ']'));
+}
+
+//*****************************************************************************
+//*	returns the token type
+//*****************************************************************************
+static int	ClassifyValue(const char *valueString)
+{
+int		tokenType;
+
+	tokenType	=	kJTK_Number;
+	if ((valueString[0] >= '0') && (valueString[0] <= '9'))
+	{
+		//*	most of them are numbers
+	}
+	else if (strcmp(valueString, "true") == 0)
+	{
+		tokenType	=	kJTK_True;
+	}
+	else if (strcmp(valueString, "false") == 0)
+	{
+		tokenType	=	kJTK_False;
+	}
+	else if (strcmp(valueString, "null") == 0)
+	{
+		tokenType	=	kJTK_Null;
+	}
+	return(tokenType);
+}
+
+//*****************************************************************************
+int	JTK_Parse(JTK_Parser_t *theParser, char *jsonData, const uint32_t dataLen)
+{
+int			returnCode;
+uint32_t	pos;
+uint32_t	endPos;
+uint32_t	stringLen;
+char		theChar;
+char		delimiterChar;
+int			tokenIdx;
+int			openType;
+bool		waitingForData;
+
+	returnCode	=	kJTK_NeedMore;
+	if ((theParser != NULL) && (jsonData != NULL))
+	{
+		theParser->jsonData	=	jsonData;
+		pos					=	theParser->parseOffset;
+		delimiterChar		=	0;
+		waitingForData		=	false;
+
+		//*	skip an http header, it could have a '{' or '[' in it
+		if ((theParser->state == kState_Start) && (pos == 0) && (dataLen >= 5) && (strncmp(jsonData, "HTTP/", 5) == 0))
+		{
+			waitingForData	=	true;
+			pos				=	4;
+			while (waitingForData && ((pos + 4) <= dataLen))
+			{
+				if ((jsonData[pos] == '\r') && (strncmp(&jsonData[pos], "\r\n\r\n", 4) == 0))
+				{
+					waitingForData	=	false;
+				}
+				pos++;
+			}
+			pos	=	waitingForData ? 0 : (pos + 3);
+		}
+
+		while ((waitingForData == false) && (returnCode == kJTK_NeedMore) && (pos < dataLen))
+		{
+			//*	the char after a number was replaced by its terminating null
+			if (delimiterChar != 0)
+			{
+				theChar			=	delimiterChar;
+				delimiterChar	=	0;
+			}
+			else
+			{
+				theChar	=	jsonData[pos];
+			}
+
+			if (((uint8_t)theChar <= 0x20) && (theParser->state != kState_Start))
+			{
+				pos++;
+			}
+			else
+			{
+				switch(theParser->state)
+				{
+					case kState_Start:
+					case kState_Value:
+					case kState_ValueOrEnd:
+						if ((theChar == '{') || (theChar == '['))
+						{
+							openType	=	(theChar == '{') ? kJTK_Object : kJTK_Array;
+							tokenIdx	=	AddToken(theParser, openType, pos, 0);
+							if (tokenIdx >= 0)
+							{
+								theParser->openIdx	=	tokenIdx;
+								theParser->state	=	(openType == kJTK_Object) ? kState_KeyOrEnd : kState_ValueOrEnd;
+								pos++;
+							}
+							else
+							{
+								returnCode	=	kJTK_Err_NoMemory;
+							}
+						}
+						else if (theParser->state == kState_Start)
+						{
+							pos++;
+						}
+						else if ((theChar == ']') && (theParser->state == kState_ValueOrEnd))
+						{
+							//*	empty array
+							theParser->tokens[theParser->openIdx].endIdx	=	theParser->tokenCnt;
+							theParser->openIdx								=	theParser->tokens[theParser->openIdx].parentIdx;
+							theParser->state								=	(theParser->openIdx < 0) ? kState_Done : kState_CommaOrEnd;
+							pos++;
+						}
+						else if (theChar == '"')
+						{
+							if (ReadString(jsonData, dataLen, (pos + 1), &stringLen, &endPos))
+							{
+								tokenIdx	=	AddToken(theParser, kJTK_String, (pos + 1), stringLen);
+								if (tokenIdx >= 0)
+								{
+									theParser->state	=	kState_CommaOrEnd;
+									pos					=	endPos;
+								}
+								else
+								{
+									returnCode	=	kJTK_Err_NoMemory;
+								}
+							}
+							else
+							{
+								//*	wait for the rest of the string
+								waitingForData	=	true;
+							}
+						}
+						else if ((theChar == ',') || (theChar == ':') || (theChar == '}') || (theChar == ']'))
+						{
+							returnCode	=	kJTK_Err_Syntax;
+						}
+						else
+						{
+							//*	number, true, false or null
+							endPos	=	pos;
+							while ((endPos < dataLen) && (IsDelimiter(jsonData[endPos]) == false))
+							{
+								endPos++;
+							}
+							if (endPos < dataLen)
+							{
+								delimiterChar		=	jsonData[endPos];
+								jsonData[endPos]	=	0;
+								tokenIdx			=	AddToken(theParser, ClassifyValue(&jsonData[pos]), pos, (endPos - pos));
+								if (tokenIdx >= 0)
+								{
+									theParser->state	=	kState_CommaOrEnd;
+									pos					=	endPos;
+									if ((uint8_t)delimiterChar <= 0x20)
+									{
+										//*	white space, nothing more to do with it
+										delimiterChar	=	0;
+										pos++;
+									}
+								}
+								else
+								{
+									returnCode	=	kJTK_Err_NoMemory;
+								}
+							}
+							else
+							{
+								//*	the end of the value has not arrived yet
+								waitingForData	=	true;
+							}
+						}
+						break;
+
+					case kState_KeyOrEnd:
+					case kState_Key:
+						if (theChar == '"')
+						{
+							if (ReadString(jsonData, dataLen, (pos + 1), &stringLen, &endPos))
+							{
+								theParser->pendingKeyOffset	=	pos + 1;
+								theParser->state			=	kState_Colon;
+								pos							=	endPos;
+							}
+							else
+							{
+								waitingForData	=	true;
+							}
+						}
+						else if (theChar == '}')
+						{
+							theParser->tokens[theParser->openIdx].endIdx	=	theParser->tokenCnt;
+							theParser->openIdx								=	theParser->tokens[theParser->openIdx].parentIdx;
+							theParser->state								=	(theParser->openIdx < 0) ? kState_Done : kState_CommaOrEnd;
+							pos++;
+						}
+						else
+						{
+							returnCode	=	kJTK_Err_Syntax;
+						}
+						break;
+
+					case kState_Colon:
+						if (theChar == ':')
+						{
+							theParser->state	=	kState_Value;
+							pos++;
+						}
+						else
+						{
+							returnCode	=	kJTK_Err_Syntax;
+						}
+						break;
+
+					case kState_CommaOrEnd:
+						openType	=	theParser->tokens[theParser->openIdx].type;
+						if (theChar == ',')
+						{
+							theParser->state	=	(openType == kJTK_Object) ? kState_Key : kState_Value;
+							pos++;
+						}
+						else if (((theChar == '}') && (openType == kJTK_Object)) ||
+								((theChar == ']') && (openType == kJTK_Array)))
+						{
+							theParser->tokens[theParser->openIdx].endIdx	=	theParser->tokenCnt;
+							theParser->openIdx								=	theParser->tokens[theParser->openIdx].parentIdx;
+							theParser->state								=	(theParser->openIdx < 0) ? kState_Done : kState_CommaOrEnd;
+							pos++;
+						}
+						else
+						{
+							returnCode	=	kJTK_Err_Syntax;
+						}
+						break;
+
+					case kState_Done:
+					default:
+						pos	=	dataLen;
+						break;
+				}
+			}
+		}
+		//*	an unfinished string or value is parsed again from its start next time
+		theParser->parseOffset	=	pos;
+		if ((theParser->state == kState_Done) && (returnCode >= 0))
+		{
+			returnCode	=	kJTK_Complete;
+		}
+	}
+	else
+	{
+		returnCode	=	kJTK_Err_InvalidParameter;
+	}
+	return(returnCode);
+}
+
+//*****************************************************************************
+//*	the bucket is newest first, the first one in the document has the lowest index
+//*****************************************************************************
+static int	FindKeyInBucket(const JTK_Parser_t *theParser, const char *keyWord, const int parentIdx, const bool checkParent)
+{
+int		tokenIdx;
+int		foundIdx;
+
+	foundIdx	=	-1;
+	if ((theParser != NULL) && (keyWord != NULL) && (theParser->hashSize > 0) && (theParser->jsonData != NULL))
+	{
+		tokenIdx	=	theParser->hashTable[HashKey(keyWord) & (theParser->hashSize - 1)];
+		while (tokenIdx >= 0)
+		{
+			if (((checkParent == false) || (theParser->tokens[tokenIdx].parentIdx == parentIdx)) &&
+				(strcasecmp(&theParser->jsonData[theParser->tokens[tokenIdx].keyOffset], keyWord) == 0))
+			{
+				foundIdx	=	tokenIdx;
+			}
+			tokenIdx	=	theParser->tokens[tokenIdx].nextInBucket;
+		}
+	}
+	return(foundIdx);
+}
+
+//*****************************************************************************
+int	JTK_FindKey(const JTK_Parser_t *theParser, const char *keyWord)
+{
+	return(FindKeyInBucket(theParser, keyWord, -1, false));
+}
+
+//*****************************************************************************
+int	JTK_FindKeyInObject(const JTK_Parser_t *theParser, const int objectIdx, const char *keyWord)
+{
+	return(FindKeyInBucket(theParser, keyWord, objectIdx, true));
+}
+
+//*****************************************************************************
+const char	*JTK_GetKey(const JTK_Parser_t *theParser, const int tokenIdx)
+{
+const char	*keyString;
+
+	keyString	=	"";
+	if ((theParser != NULL) && (tokenIdx >= 0) && ((uint32_t)tokenIdx < theParser->tokenCnt) &&
+		(theParser->tokens[tokenIdx].keyOffset != kJTK_NoKey))
+	{
+		keyString	=	&theParser->jsonData[theParser->tokens[tokenIdx].keyOffset];
+	}
+	return(keyString);
+}
+
+//*****************************************************************************
+const char	*JTK_GetValue(const JTK_Parser_t *theParser, const int tokenIdx)
+{
+const char	*valueString;
+
+	valueString	=	"";
+	if ((theParser != NULL) && (tokenIdx >= 0) && ((uint32_t)tokenIdx < theParser->tokenCnt) &&
+		(theParser->tokens[tokenIdx].type != kJTK_Object) && (theParser->tokens[tokenIdx].type != kJTK_Array))
+	{
+		valueString	=	&theParser->jsonData[theParser->tokens[tokenIdx].valueOffset];
+	}
+	return(valueString);
+}
@@ -0,0 +1,115 @@
+//*****************************************************************************
+//*	json_tokenizer.h
+//*		in place json tokenizer
+//*		written by Mark Sproul
+//*		unlimited use rights, modify and use as you wish
+//*
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created json_tokenizer.h
+//*****************************************************************************
+//#include	"json_tokenizer.h"
+
+
+#ifndef _JSON_TOKENIZER_H_
+#define	_JSON_TOKENIZER_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kJTK_NoKey		0xffffffff
+
+//*****************************************************************************
+//*	token types
+enum
+{
+	kJTK_Object	=	1,
+	kJTK_Array,
+	kJTK_String,
+	kJTK_Number,		//*	any unquoted value that is not true, false or null
+	kJTK_True,
+	kJTK_False,
+	kJTK_Null
+};
+
+//*****************************************************************************
+//*	JTK_Parse() return codes, the errors are negative
+enum
+{
+	kJTK_Complete		=	0,		//*	the top level object or array is closed
+	kJTK_NeedMore		=	1,		//*	ran out of data, call again when more has arrived
+
+	kJTK_Err_InvalidParameter	=	-200,
+	kJTK_Err_Syntax,
+	kJTK_Err_NoMemory
+};
+
+//*****************************************************************************
+//*	everything is an offset into the data so the caller may move (realloc)
+//*	the data between calls while a reply is still arriving
+typedef struct
+{
+	uint32_t	keyOffset;			//*	kJTK_NoKey for array elements and the top level
+	uint32_t	valueOffset;		//*	strings and other values are null terminated in place
+	uint32_t	valueLen;
+	uint32_t	endIdx;				//*	object/array: index after the last token inside it
+	int32_t		parentIdx;			//*	-1 for the top level
+	int32_t		nextInBucket;		//*	key hash chain
+	uint16_t	depth;
+	uint8_t		type;
+} JTK_token_t;
+
+//*****************************************************************************
+typedef struct
+{
+	char		*jsonData;			//*	set by JTK_Parse(), changed in place
+	JTK_token_t	*tokens;			//*	in document order, parents before their children
+	uint32_t	tokenCnt;
+	uint32_t	tokenMax;
+	int32_t		*hashTable;			//*	newest token for each key hash
+	uint32_t	hashSize;			//*	power of 2
+
+	//*	where to pick up on the next call
+	uint32_t	parseOffset;
+	int32_t		openIdx;			//*	innermost object or array that is still open
+	uint32_t	pendingKeyOffset;
+	uint8_t		state;
+} JTK_Parser_t;
+
+//*	JTK_Init() before first use, JTK_Free() gives the memory back.
+//*	A parser can be used over and over, the memory is kept between documents
+void		JTK_Init(JTK_Parser_t *theParser);
+void		JTK_Free(JTK_Parser_t *theParser);
+void		JTK_Reset(JTK_Parser_t *theParser);
+
+//*	Tokenizes jsonData[0..dataLen-1] in place, strings get their escapes decoded
+//*	and every value is null terminated inside jsonData.
+//*	Anything in front of the first '{' or '[' is skipped, including an http header.
+//*	If it returns kJTK_NeedMore, append the rest of the data and call it again with
+//*	the same data (it may have moved) and the new length. Do not touch the bytes
+//*	already parsed.
+int			JTK_Parse(JTK_Parser_t *theParser, char *jsonData, const uint32_t dataLen);
+
+//*	case insensitive, the first token in the document with that key, -1 if none
+int			JTK_FindKey(const JTK_Parser_t *theParser, const char *keyWord);
+
+//*	case insensitive, only the members of one object
+int			JTK_FindKeyInObject(const JTK_Parser_t *theParser, const int objectIdx, const char *keyWord);
+
+//*	"" for tokens without a key / objects and arrays
+const char	*JTK_GetKey(const JTK_Parser_t *theParser, const int tokenIdx);
+const char	*JTK_GetValue(const JTK_Parser_t *theParser, const int tokenIdx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_JSON_TOKENIZER_H_
@@ -47,6 +47,15 @@
 //*	May 15,	2024	<MLS> Added JsonResponse_Add_Uint32()
 //*	May 17,	2024	<MLS> Added httpRetCode to JsonResponse_FinishHeader()
 //*	May 17,	2024	<MLS> Added httpRetCode to JsonResponse_Add_Finish()
+//*	Oct 16,	2026	<MLS> JsonResponse_Add_Finish() now sends HTTP/1.1 with keep-alive when possible
+//*	Oct 16,	2026	<MLS> Partial writes tell socket_listen the response is not framed
+//*	Oct 16,	2026	<MLS> Added TYPE_JsonWriter, keeps track of the length, no more strcat()
+//*	Oct 16,	2026	<MLS> JsonResponse_Add_xxx() routines are now wrappers for JsonWriter_Add_xxx()
+//*	Oct 16,	2026	<MLS> Header and data are sent with one writev()
+//*	Oct 16,	2026	<MLS> Added JsonResponse_ResetPhaseTimes() & JsonResponse_GetPhaseTimes()
+//*	Oct 17,	2026	<MLS> Only JsonResponse_Add_Finish() is timed, JsonWriter_Attach() always uses strlen()
+//*	Oct 17,	2026	<MLS> JsonWriter_Attach() keeps the length if the terminator has not moved
+//*	Oct 17,	2026	<MLS> Every JsonWriter_Add_xxx() call counts towards the json phase time again
 //*****************************************************************************
 
 
@@ -74,6 +83,9 @@
 	#include	<sys/types.h>
 	#include	<sys/socket.h>
 	#include	<netinet/in.h>
+	#include	<sys/uio.h>
+	#include	<time.h>
+	#define		_ENABLE_JSON_PHASE_TIMING_
 #endif		//	__IAR_SYSTEMS_ICC__
 
 //#define	_DEBUG_JSON_RESPONSE_
@@ -87,38 +99,204 @@
 
 #include 	"JsonDefs.h"
 #include	"JsonResponse.h"
+#include	"socket_listen.h"
 
 
+#ifdef _MAKE_JSON_PRETTY_
+	#define	kItemPrefix		"\t\t\""
+	#define	kBlockIndent	"\t"
+#else
+	#define	kItemPrefix		"\""
+	#define	kBlockIndent	""
+#endif
+
+//*****************************************************************************
+//*	the writer used by the JsonResponse_xxx() wrappers, one per thread
+//*	it is attached to whatever buffer the caller passes in
+//*****************************************************************************
+static __thread TYPE_JsonWriter	gJsonWriter;
+
+//*****************************************************************************
+//*	time spent building the JSON and time spent in writev(), per thread
+//*	the alpaca dispatcher resets these before each command and reads them after.
+//*	Every JsonWriter_Add_xxx() call is timed, so the time the drivers spend building
+//*	the reply is not counted as dispatch
+//*****************************************************************************
+#ifdef _ENABLE_JSON_PHASE_TIMING_
+typedef struct
+{
+	uint64_t	startTime_nS;
+	uint64_t	socketWriteAtStart_nS;
+} TYPE_JsonTimer;
+
+static __thread uint64_t	gJsonSerialize_nS;
+static __thread uint64_t	gJsonSocketWrite_nS;
+
+//*****************************************************************************
+static inline uint64_t	JsonTimer_GetNanoSecs(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(((uint64_t)timeSpec.tv_sec * 1000000000) + timeSpec.tv_nsec);
+}
+
+//*****************************************************************************
+static inline void	JsonTimer_Start(TYPE_JsonTimer *jsonTimer)
+{
+	jsonTimer->socketWriteAtStart_nS	=	gJsonSocketWrite_nS;
+	jsonTimer->startTime_nS				=	JsonTimer_GetNanoSecs();
+}
+
+//*****************************************************************************
+//*	anything written to the socket during this call is not counted as serialization
+//*****************************************************************************
+static inline void	JsonTimer_Stop(TYPE_JsonTimer *jsonTimer)
+{
+uint64_t	elapsed_nS;
+uint64_t	socketWrite_nS;
+
+	elapsed_nS		=	JsonTimer_GetNanoSecs() - jsonTimer->startTime_nS;
+	socketWrite_nS	=	gJsonSocketWrite_nS - jsonTimer->socketWriteAtStart_nS;
+	if (elapsed_nS > socketWrite_nS)
+	{
+		gJsonSerialize_nS	+=	elapsed_nS - socketWrite_nS;
+	}
+}
+#else
+	typedef int	TYPE_JsonTimer;
+	#define	JsonTimer_Start(x)	(void)(x)
+	#define	JsonTimer_Stop(x)	(void)(x)
+#endif // _ENABLE_JSON_PHASE_TIMING_
+
+//*****************************************************************************
+void	JsonResponse_ResetPhaseTimes(void)
+{
+#ifdef _ENABLE_JSON_PHASE_TIMING_
+	gJsonSerialize_nS	=	0;
+	gJsonSocketWrite_nS	=	0;
+#endif // _ENABLE_JSON_PHASE_TIMING_
+}
+
+//*****************************************************************************
+//*	returns microseconds since the last JsonResponse_ResetPhaseTimes() for this thread
+//*****************************************************************************
+void	JsonResponse_GetPhaseTimes(uint32_t *serialize_uS, uint32_t *socketWrite_uS)
+{
+#ifdef _ENABLE_JSON_PHASE_TIMING_
+	*serialize_uS	=	gJsonSerialize_nS / 1000;
+	*socketWrite_uS	=	gJsonSocketWrite_nS / 1000;
+#else
+	*serialize_uS	=	0;
+	*socketWrite_uS	=	0;
+#endif // _ENABLE_JSON_PHASE_TIMING_
+}
+
+//*****************************************************************************
+//*	the old API passes only the buffer, the callers are free to strcat() to it or
+//*	clear it between calls. The length from the last call is used if the buffer is the
+//*	same one and the terminator is still where it was left, strcat() moves it and
+//*	jsonTextBuffer[0] = 0 empties the start, anything else gets a strlen()
+//*****************************************************************************
+static TYPE_JsonWriter	*JsonWriter_Attach(const int socketFD, char *jsonTextBuffer, const int maxLen)
+{
+TYPE_JsonWriter	*writer;
+
+	if (jsonTextBuffer == NULL)
+	{
+		CONSOLE_DEBUG("jsonTextBuffer is NULL");
+		return(NULL);
+	}
+	writer	=	&gJsonWriter;
+	if ((writer->buffer != jsonTextBuffer) ||
+		(writer->length >= maxLen) ||
+		(jsonTextBuffer[writer->length] != 0) ||
+		((writer->length > 0) && (jsonTextBuffer[0] == 0)))
+	{
+		writer->buffer	=	jsonTextBuffer;
+		writer->length	=	strlen(jsonTextBuffer);
+	}
+	writer->socketFD	=	socketFD;
+	writer->maxLen		=	maxLen;
+	return(writer);
+}
+
+//*****************************************************************************
+void	JsonWriter_Init(TYPE_JsonWriter *writer, const int socketFD, char *jsonTextBuffer, const int maxLen)
+{
+	writer->socketFD	=	socketFD;
+	writer->buffer		=	jsonTextBuffer;
+	writer->maxLen		=	maxLen;
+	writer->length		=	0;
+	if (jsonTextBuffer != NULL)
+	{
+		jsonTextBuffer[0]	=	0;
+	}
+}
+
+//*****************************************************************************
+//*	the caller has made sure it fits
+//*****************************************************************************
+static inline void	JsonWriter_Append(TYPE_JsonWriter *writer, const char *textPtr, const int textLen)
+{
+	memcpy(&writer->buffer[writer->length], textPtr, textLen);
+	writer->length					+=	textLen;
+	writer->buffer[writer->length]	=	0;
+}
+
+#define	JsonWriter_AppendLiteral(writer, literal)	JsonWriter_Append(writer, literal, (sizeof(literal) - 1))
+
 //*****************************************************************************
 void	JsonResponse_CreateHeader(char *jsonTextBuffer)
 {
+TYPE_JsonWriter	*writer;
+
 	CONSOLE_DEBUG(__FUNCTION__);
 
-	if (jsonTextBuffer != NULL)
+	writer	=	JsonWriter_Attach(-1, jsonTextBuffer, kMaxJsonBuffLen);
+	if (writer != NULL)
 	{
-		strcpy(jsonTextBuffer, "{\r\n");
+		writer->length	=	0;
+		JsonWriter_AppendLiteral(writer, "{\r\n");
 	}
 }
 
 //*****************************************************************************
-//void	JsonResponse_FinishHeader(	char *jsonHdrBUffer, const char *jsonTextBuffer)
-void	JsonResponse_FinishHeader(const int httpRetCode,	char *jsonHdrBUffer, const char *jsonTextBuffer)
+enum
+{
+	kHttpConnection_Legacy	=	0,	//*	HTTP/1.0, no Connection header
+	kHttpConnection_KeepAlive,		//*	HTTP/1.1, connection stays open
+	kHttpConnection_Close			//*	HTTP/1.1, connection will be closed
+};
+
+//*****************************************************************************
+static void	JsonResponse_BuildHeader(	const int	httpRetCode,
+										char		*jsonHdrBUffer,
+										const int	contentLen,
+										const int	connectionType)
 {
-int		contentLen;
 char	lineBuff[64];
+char	httpVersion[16];
 
-	if ((jsonHdrBUffer != NULL) && (jsonTextBuffer != NULL))
+	if (jsonHdrBUffer != NULL)
 	{
-		contentLen	=	strlen(jsonTextBuffer);
 #ifdef _INCLUDE_HTTP_HEADER_
 		jsonHdrBUffer[0]	=	0;
+		if (connectionType == kHttpConnection_Legacy)
+		{
+			strcpy(httpVersion,	"HTTP/1.0");
+		}
+		else
+		{
+			strcpy(httpVersion,	"HTTP/1.1");
+		}
 		if (httpRetCode == 200)
 		{
-			strcpy(lineBuff,	"HTTP/1.0 200 OK\r\n");
+			sprintf(lineBuff, "%s 200 OK\r\n", httpVersion);
 		}
 		else
 		{
-			sprintf(lineBuff, "HTTP/1.0 %d BadRequest\r\n", httpRetCode);
+			sprintf(lineBuff, "%s %d BadRequest\r\n", httpVersion, httpRetCode);
 		}
 		strcat(jsonHdrBUffer,	lineBuff);
 		if (contentLen > 0)
@@ -134,6 +312,14 @@ char	lineBuff[64];
 		strcat(jsonHdrBUffer,	"Content-type: application/json; charset=utf-8\r\n");
 		strcat(jsonHdrBUffer,	"Server: AlpacaPi\r\n");
 		strcat(jsonHdrBUffer,	"Access-Control-Allow-Origin: *\r\n");
+		if (connectionType == kHttpConnection_KeepAlive)
+		{
+			strcat(jsonHdrBUffer,	"Connection: keep-alive\r\n");
+		}
+		else if (connectionType == kHttpConnection_Close)
+		{
+			strcat(jsonHdrBUffer,	"Connection: close\r\n");
+		}
 
 //		strcat(jsonHdrBUffer,	"Accept: text/html,application/json\r\n");
 //		strcat(jsonHdrBUffer,	"Accept-Language:en-US,en;q=0.8\r\n");
@@ -144,515 +330,506 @@ char	lineBuff[64];
 }
 
 //*****************************************************************************
-static int	JsonRespnse_XmitIfFull(	const int			socketFD,
-									char				*jsonTextBuffer,
-									const unsigned int	maxLen,
-									const int			payloadLen,
-									const bool			enableDebug)
+//*	this header is sent separately from the data, it stays HTTP/1.0
+//*	and the connection gets closed at the end of the response
+//*****************************************************************************
+//void	JsonResponse_FinishHeader(	char *jsonHdrBUffer, const char *jsonTextBuffer)
+void	JsonResponse_FinishHeader(const int httpRetCode,	char *jsonHdrBUffer, const char *jsonTextBuffer)
 {
-size_t	bufLen;
-int		bytesWritten	=	0;
+	if ((jsonHdrBUffer != NULL) && (jsonTextBuffer != NULL))
+	{
+		JsonResponse_BuildHeader(httpRetCode, jsonHdrBUffer, strlen(jsonTextBuffer), kHttpConnection_Legacy);
+	}
+}
 
-	if (jsonTextBuffer != NULL)
+//*****************************************************************************
+//*	formats the number directly into the buffer
+//*****************************************************************************
+static void	JsonWriter_AppendUint32(TYPE_JsonWriter *writer, uint32_t uIntValue)
+{
+char	digits[12];
+int		digitCnt;
+
+	digitCnt	=	0;
+	do
 	{
-		bufLen	=	strlen(jsonTextBuffer);
-		if ((bufLen + payloadLen) >=  maxLen)
-		{
-			if (enableDebug)
-			{
-				CONSOLE_DEBUG("Sending Data because xmit buffer is full");
-				CONSOLE_DEBUG_W_NUM("maxLen\t\t\t=", maxLen);
-				CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
-			}
-			//*	transmit the packet and reset
-			bytesWritten	=	write(socketFD, jsonTextBuffer, bufLen);
-		//	CONSOLE_DEBUG(__FUNCTION__);
-			if (bytesWritten < 0)
-			{
-				CONSOLE_DEBUG("Error writing to socket");
-			}
-		//	CONSOLE_DEBUG(__FUNCTION__);
-			jsonTextBuffer[0]	=	0;	//*	reset the buffer
-		//	CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
-		}
+		digits[digitCnt++]	=	'0' + (uIntValue % 10);
+		uIntValue			=	uIntValue / 10;
+	} while (uIntValue > 0);
+
+	while (digitCnt > 0)
+	{
+		writer->buffer[writer->length++]	=	digits[--digitCnt];
+	}
+	writer->buffer[writer->length]	=	0;
+}
+
+//*****************************************************************************
+static void	JsonWriter_AppendInt32(TYPE_JsonWriter *writer, const int32_t intValue)
+{
+	if (intValue < 0)
+	{
+		writer->buffer[writer->length++]	=	'-';
+		JsonWriter_AppendUint32(writer, (uint32_t)(-(int64_t)intValue));
 	}
 	else
 	{
-		CONSOLE_DEBUG("jsonTextBuffer is NULL");
+		JsonWriter_AppendUint32(writer, (uint32_t)intValue);
 	}
-	return(bytesWritten);
 }
 
+//*****************************************************************************
+//*	"itemName":
+//*****************************************************************************
+static void	JsonWriter_AppendItemName(TYPE_JsonWriter *writer, const char *itemName, const int nameLen)
+{
+	JsonWriter_AppendLiteral(writer, kItemPrefix);
+	if (itemName != NULL)
+	{
+		JsonWriter_Append(writer, itemName, nameLen);
+	}
+	JsonWriter_AppendLiteral(writer, "\":");
+}
 
 //*****************************************************************************
-void	JsonResponse_Add_HDR(char *jsonTextBuffer, const int maxLen)
+static void	JsonWriter_AppendEndOfLine(TYPE_JsonWriter *writer, bool includeTrailingComma)
 {
-	if (jsonTextBuffer != NULL)
+	if (includeTrailingComma)
 	{
-		if ((maxLen - strlen(jsonTextBuffer)) > 20)
-		{
-		#ifdef _MAKE_JSON_PRETTY_
-			strcat(jsonTextBuffer, "\t\"hdr\":\r\n");
-			strcat(jsonTextBuffer, "\t{\r\n");
-		#else
-			strcat(jsonTextBuffer, "\"hdr\":\r\n");
-			strcat(jsonTextBuffer, "{\r\n");
-		#endif
-		}
+		JsonWriter_AppendLiteral(writer, ",\r\n");
+	}
+	else
+	{
+		JsonWriter_AppendLiteral(writer, "\r\n");
 	}
 }
 
 //*****************************************************************************
-int	JsonResponse_Add_Data(	const int	socketFD,
-								char		*jsonTextBuffer,
-								const int	maxLen)
+//*	keeps calling writev() until it is all gone
+//*	returns the number of bytes written, -1 if nothing could be written
+//*****************************************************************************
+static int	JsonWriter_WriteV(const int socketFD, struct iovec *ioVector, int ioVectorCnt)
 {
-int		payloadLen;
+int		totalWritten;
 int		bytesWritten;
-
-	if (jsonTextBuffer != NULL)
+int		tryCount;
+#ifdef _ENABLE_JSON_PHASE_TIMING_
+uint64_t	startTime_nS;
+
+	startTime_nS	=	JsonTimer_GetNanoSecs();
+#endif // _ENABLE_JSON_PHASE_TIMING_
+	totalWritten	=	0;
+	tryCount		=	0;
+	while ((ioVectorCnt > 0) && (tryCount < 10))
 	{
-
-		payloadLen	=	20;
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
-
-		if ((maxLen - strlen(jsonTextBuffer)) > 20)
+		bytesWritten	=	writev(socketFD, ioVector, ioVectorCnt);
+		if (bytesWritten > 0)
 		{
-		#ifdef _MAKE_JSON_PRETTY_
-			strcat(jsonTextBuffer, "\t\"data\":\r\n");
-			strcat(jsonTextBuffer, "\t{\r\n");
-		#else
-			strcat(jsonTextBuffer, "\"data\":\r\n");
-			strcat(jsonTextBuffer, "{\r\n");
-		#endif
+			totalWritten	+=	bytesWritten;
+			//*	skip over what has been sent
+			while ((ioVectorCnt > 0) && (bytesWritten >= (int)ioVector->iov_len))
+			{
+				bytesWritten	-=	ioVector->iov_len;
+				ioVector++;
+				ioVectorCnt--;
+			}
+			if (ioVectorCnt > 0)
+			{
+				ioVector->iov_base	=	(char *)ioVector->iov_base + bytesWritten;
+				ioVector->iov_len	-=	bytesWritten;
+			}
+		}
+		else if ((bytesWritten < 0) && (errno == EINTR))
+		{
+			//*	try again
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("tryCount\t=", tryCount);
+			CONSOLE_DEBUG_W_NUM("Error writting to socket, socketFD\t=", socketFD);
+			CONSOLE_DEBUG_W_NUM("Error writting to socket, errno\t=", errno);
+			tryCount++;
 		}
 	}
-	return(bytesWritten);
+	if ((totalWritten == 0) && (ioVectorCnt > 0))
+	{
+		totalWritten	=	-1;
+	}
+#ifdef _ENABLE_JSON_PHASE_TIMING_
+	gJsonSocketWrite_nS	+=	JsonTimer_GetNanoSecs() - startTime_nS;
+#endif // _ENABLE_JSON_PHASE_TIMING_
+	return(totalWritten);
 }
 
+//*****************************************************************************
+//*	sends what is in the buffer and resets it
+//*****************************************************************************
+static int	JsonWriter_Flush(TYPE_JsonWriter *writer)
+{
+struct iovec	ioVector[1];
+int				bytesWritten	=	0;
 
+	if (writer->length > 0)
+	{
+		ioVector[0].iov_base	=	writer->buffer;
+		ioVector[0].iov_len		=	writer->length;
+		bytesWritten			=	JsonWriter_WriteV(writer->socketFD, ioVector, 1);
+	}
+	writer->length		=	0;
+	writer->buffer[0]	=	0;	//*	reset the buffer
+	return(bytesWritten);
+}
 
 //*****************************************************************************
-//*	if the buffer is getting full, it will be transmitted and the buffer will be reset
-int		JsonResponse_Add_String(const int	socketFD,
-								char		*jsonTextBuffer,
-								const int	maxLen,
-								const char	*itemName,
-								const char	*stringValue,
-								bool		includeTrailingComma)
-{
-int		payloadLen;
+static int	JsonWriter_XmitIfFull(TYPE_JsonWriter *writer, const int payloadLen)
+{
 int		bytesWritten	=	0;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer->length + payloadLen) >= writer->maxLen)
 	{
-		//*	calculate the length of what we are adding to the buffer
-		payloadLen	=	0;
-		if (itemName != NULL)
-		{
-			payloadLen	+=	strlen(itemName);
-		}
-		if (stringValue != NULL)
-		{
-			payloadLen	+=	strlen(stringValue);
-		}
-		payloadLen	+=	20;
-
-
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
-
-	#ifdef _MAKE_JSON_PRETTY_
-		strcat(jsonTextBuffer, "\t\t\"");
-	#else
-		strcat(jsonTextBuffer, "\"");
+	#ifdef _DEBUG_JSON_RESPONSE_
+		CONSOLE_DEBUG("Sending Data because xmit buffer is full");
+		CONSOLE_DEBUG_W_NUM("maxLen\t\t\t=", writer->maxLen);
+		CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", writer->length);
 	#endif
-
-		if (itemName != NULL)
+		//*	transmit the packet and reset
+		//*	the header has not been sent yet, so the Content-Length will not be complete
+		SocketListen_UnframedResponse(writer->socketFD);
+		bytesWritten	=	JsonWriter_Flush(writer);
+		if (bytesWritten < 0)
 		{
-			strcat(jsonTextBuffer, itemName);
+			CONSOLE_DEBUG("Error writing to socket");
 		}
-		strcat(jsonTextBuffer, "\":\"");
-		if (stringValue != NULL)
-		{
-			strcat(jsonTextBuffer, stringValue);
-		}
-		strcat(jsonTextBuffer, "\"");
-		if (includeTrailingComma)
-		{
-			strcat(jsonTextBuffer, ",");
-		}
-		strcat(jsonTextBuffer, "\r\n");
-
 	}
 	return(bytesWritten);
 }
 
 //*****************************************************************************
-int		JsonResponse_Add_Int32(	const int		socketFD,
-								char			*jsonTextBuffer,
-								const int		maxLen,
-								const char		*itemName,
-								const int32_t	intValue,
-								bool			includeTrailingComma)
+void	JsonResponse_Add_HDR(char *jsonTextBuffer, const int maxLen)
 {
-int		payloadLen;
-char	numberString[64];
-int		bytesWritten	=	0;
+TYPE_JsonWriter	*writer;
 
-	if (jsonTextBuffer != NULL)
+	writer	=	JsonWriter_Attach(-1, jsonTextBuffer, maxLen);
+	if (writer != NULL)
 	{
-		sprintf(numberString,	"%ld", (long)intValue);
-		//*	calculate the length of what we are adding to the buffer
-		payloadLen	=	strlen(numberString);
-		if (itemName != NULL)
+		if ((maxLen - writer->length) > 20)
 		{
-			payloadLen	+=	strlen(itemName);
+			JsonWriter_AppendLiteral(writer, kBlockIndent "\"hdr\":\r\n");
+			JsonWriter_AppendLiteral(writer, kBlockIndent "{\r\n");
 		}
+	}
+}
 
-		payloadLen	+=	20;
-
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
+//*****************************************************************************
+int	JsonWriter_Add_Data(TYPE_JsonWriter *writer)
+{
+TYPE_JsonTimer	jsonTimer;
+int		bytesWritten	=	0;
 
-	#ifdef _MAKE_JSON_PRETTY_
-		strcat(jsonTextBuffer,	"\t\t\"");
-	#else
-		strcat(jsonTextBuffer,	"\"");
-	#endif
-		strcat(jsonTextBuffer,	itemName);
-		strcat(jsonTextBuffer,	"\":");
-		strcat(jsonTextBuffer,	numberString);
-		if (includeTrailingComma)
+	if ((writer != NULL) && (writer->buffer != NULL))
+	{
+		JsonTimer_Start(&jsonTimer);
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, 20);
+		if ((writer->maxLen - writer->length) > 20)
 		{
-			strcat(jsonTextBuffer, ",");
+			JsonWriter_AppendLiteral(writer, kBlockIndent "\"data\":\r\n");
+			JsonWriter_AppendLiteral(writer, kBlockIndent "{\r\n");
 		}
-		strcat(jsonTextBuffer,	"\r\n");
-
+		JsonTimer_Stop(&jsonTimer);
 	}
 	return(bytesWritten);
 }
 
 //*****************************************************************************
-int		JsonResponse_Add_Uint32(	const int		socketFD,
-									char			*jsonTextBuffer,
-									const int		maxLen,
-									const char		*itemName,
-									const uint32_t	uIntValue,
-									bool			includeTrailingComma)
+//*	if the buffer is getting full, it will be transmitted and the buffer will be reset
+int	JsonWriter_Add_String(	TYPE_JsonWriter	*writer,
+							const char		*itemName,
+							const char		*stringValue,
+							bool			includeTrailingComma)
 {
-int				payloadLen;
-char			numberString[64];
-int				bytesWritten	=	0;
-unsigned long	myUnsignedLongValue;
+TYPE_JsonTimer	jsonTimer;
+int		nameLen;
+int		valueLen;
+int		bytesWritten	=	0;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer != NULL) && (writer->buffer != NULL))
 	{
-		myUnsignedLongValue	=	uIntValue;
-		sprintf(numberString,	"%ld", myUnsignedLongValue);
+		JsonTimer_Start(&jsonTimer);
 		//*	calculate the length of what we are adding to the buffer
-		payloadLen	=	strlen(numberString);
-		if (itemName != NULL)
-		{
-			payloadLen	+=	strlen(itemName);
-		}
-
-		payloadLen	+=	20;
+		nameLen		=	(itemName != NULL)		? strlen(itemName)		: 0;
+		valueLen	=	(stringValue != NULL)	? strlen(stringValue)	: 0;
 
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, (nameLen + valueLen + 20));
 
-	#ifdef _MAKE_JSON_PRETTY_
-		strcat(jsonTextBuffer,	"\t\t\"");
-	#else
-		strcat(jsonTextBuffer,	"\"");
-	#endif
-		strcat(jsonTextBuffer,	itemName);
-		strcat(jsonTextBuffer,	"\":");
-		strcat(jsonTextBuffer,	numberString);
-		if (includeTrailingComma)
+		JsonWriter_AppendItemName(writer, itemName, nameLen);
+		JsonWriter_AppendLiteral(writer, "\"");
+		if (stringValue != NULL)
 		{
-			strcat(jsonTextBuffer, ",");
+			JsonWriter_Append(writer, stringValue, valueLen);
 		}
-		strcat(jsonTextBuffer,	"\r\n");
-
+		JsonWriter_AppendLiteral(writer, "\"");
+		JsonWriter_AppendEndOfLine(writer, includeTrailingComma);
+		JsonTimer_Stop(&jsonTimer);
 	}
 	return(bytesWritten);
 }
 
 //*****************************************************************************
-int		JsonResponse_Add_Double(const int		socketFD,
-								char			*jsonTextBuffer,
-								const int		maxLen,
-								const char		*itemName,
-								const double	dblValue,
-								bool			includeTrailingComma)
+int	JsonWriter_Add_Int32(	TYPE_JsonWriter	*writer,
+							const char		*itemName,
+							const int32_t	intValue,
+							bool			includeTrailingComma)
 {
-int		payloadLen;
-char	numberString[64];
+TYPE_JsonTimer	jsonTimer;
+int		nameLen;
 int		bytesWritten	=	0;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer != NULL) && (writer->buffer != NULL))
 	{
-		sprintf(numberString, "%13.12f", dblValue);
-		//*	calculate the length of what we are adding to the buffer
-		payloadLen	=	strlen(numberString);
-		if (itemName != NULL)
-		{
-			payloadLen	+=	strlen(itemName);
-		}
-
-		payloadLen	+=	20;
+		JsonTimer_Start(&jsonTimer);
+		//*	11 digits is enough for any int32
+		nameLen			=	(itemName != NULL) ? strlen(itemName) : 0;
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, (nameLen + 11 + 20));
+
+		JsonWriter_AppendItemName(writer, itemName, nameLen);
+		JsonWriter_AppendInt32(writer, intValue);
+		JsonWriter_AppendEndOfLine(writer, includeTrailingComma);
+		JsonTimer_Stop(&jsonTimer);
+	}
+	return(bytesWritten);
+}
 
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
+//*****************************************************************************
+int	JsonWriter_Add_Uint32(	TYPE_JsonWriter	*writer,
+							const char		*itemName,
+							const uint32_t	uIntValue,
+							bool			includeTrailingComma)
+{
+TYPE_JsonTimer	jsonTimer;
+int		nameLen;
+int		bytesWritten	=	0;
 
-	#ifdef _MAKE_JSON_PRETTY_
-		strcat(jsonTextBuffer,	"\t\t\"");
-	#else
-		strcat(jsonTextBuffer,	"\"");
-	#endif
-		strcat(jsonTextBuffer,	itemName);
-		strcat(jsonTextBuffer,	"\":");
-		strcat(jsonTextBuffer,	numberString);
-		if (includeTrailingComma)
-		{
-			strcat(jsonTextBuffer, ",");
-		}
-		strcat(jsonTextBuffer,	"\r\n");
+	if ((writer != NULL) && (writer->buffer != NULL))
+	{
+		JsonTimer_Start(&jsonTimer);
+		nameLen			=	(itemName != NULL) ? strlen(itemName) : 0;
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, (nameLen + 11 + 20));
+
+		JsonWriter_AppendItemName(writer, itemName, nameLen);
+		JsonWriter_AppendUint32(writer, uIntValue);
+		JsonWriter_AppendEndOfLine(writer, includeTrailingComma);
+		JsonTimer_Stop(&jsonTimer);
 	}
 	return(bytesWritten);
 }
 
-
 //*****************************************************************************
-int		JsonResponse_Add_Bool(	const int		socketFD,
-								char			*jsonTextBuffer,
-								const int		maxLen,
-								const char		*itemName,
-								const bool		boolValue,
-								bool			includeTrailingComma)
+int	JsonWriter_Add_Double(	TYPE_JsonWriter	*writer,
+							const char		*itemName,
+							const double	dblValue,
+							bool			includeTrailingComma)
 {
-int		payloadLen;
+TYPE_JsonTimer	jsonTimer;
+int		nameLen;
+int		numberLen;
 int		bytesWritten	=	0;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer != NULL) && (writer->buffer != NULL))
 	{
-		//*	calculate the length of what we are adding to the buffer
-		payloadLen	=	0;
-		if (itemName != NULL)
+		JsonTimer_Start(&jsonTimer);
+		//*	64 is the size of the number string this used to be formatted into
+		nameLen			=	(itemName != NULL) ? strlen(itemName) : 0;
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, (nameLen + 64 + 20));
+
+		JsonWriter_AppendItemName(writer, itemName, nameLen);
+		numberLen	=	snprintf(&writer->buffer[writer->length], 64, "%13.12f", dblValue);
+		if (numberLen > 63)
 		{
-			payloadLen	+=	strlen(itemName);
+			numberLen	=	63;
 		}
+		writer->length	+=	numberLen;
+		JsonWriter_AppendEndOfLine(writer, includeTrailingComma);
+		JsonTimer_Stop(&jsonTimer);
+	}
+	return(bytesWritten);
+}
 
-		payloadLen	+=	20;
+//*****************************************************************************
+int	JsonWriter_Add_Bool(	TYPE_JsonWriter	*writer,
+							const char		*itemName,
+							const bool		boolValue,
+							bool			includeTrailingComma)
+{
+TYPE_JsonTimer	jsonTimer;
+int		nameLen;
+int		bytesWritten	=	0;
 
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
+	if ((writer != NULL) && (writer->buffer != NULL))
+	{
+		JsonTimer_Start(&jsonTimer);
+		nameLen			=	(itemName != NULL) ? strlen(itemName) : 0;
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, (nameLen + 20));
 
-	#ifdef _MAKE_JSON_PRETTY_
-		strcat(jsonTextBuffer, "\t\t\"");
-	#else
-		strcat(jsonTextBuffer, "\"");
-	#endif
-		strcat(jsonTextBuffer, itemName);
-		strcat(jsonTextBuffer, "\":");
+		JsonWriter_AppendItemName(writer, itemName, nameLen);
 		if (boolValue)
 		{
-			strcat(jsonTextBuffer, "true");
+			JsonWriter_AppendLiteral(writer, "true");
 		}
 		else
 		{
-			strcat(jsonTextBuffer, "false");
-		}
-		if (includeTrailingComma)
-		{
-			strcat(jsonTextBuffer, ",");
+			JsonWriter_AppendLiteral(writer, "false");
 		}
-		strcat(jsonTextBuffer, "\r\n");
-
+		JsonWriter_AppendEndOfLine(writer, includeTrailingComma);
+		JsonTimer_Stop(&jsonTimer);
 	}
 	return(bytesWritten);
 }
 
 //*****************************************************************************
-int		JsonResponse_Add_ArrayStart(const int		socketFD,
-									char			*jsonTextBuffer,
-									const int		maxLen,
-									const char		*itemName)
+int	JsonWriter_Add_ArrayStart(	TYPE_JsonWriter	*writer,
+								const char		*itemName)
 {
-int		payloadLen;
+TYPE_JsonTimer	jsonTimer;
+int		nameLen;
 int		bytesWritten	=	0;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer != NULL) && (writer->buffer != NULL))
 	{
-		//*	calculate the length of what we are adding to the buffer
-		payloadLen	=	0;
-		if (itemName != NULL)
-		{
-			payloadLen	+=	strlen(itemName);
-		}
-
-		payloadLen	+=	20;
-
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
-
-	#ifdef _MAKE_JSON_PRETTY_
-		strcat(jsonTextBuffer, "\t\t\"");
-	#else
-		strcat(jsonTextBuffer, "\"");
-	#endif
-		strcat(jsonTextBuffer, itemName);
-		strcat(jsonTextBuffer, "\":[");
-//		strcat(jsonTextBuffer, "\r\n");
+		JsonTimer_Start(&jsonTimer);
+		nameLen			=	(itemName != NULL) ? strlen(itemName) : 0;
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, (nameLen + 20));
 
+		JsonWriter_AppendItemName(writer, itemName, nameLen);
+		JsonWriter_AppendLiteral(writer, "[");
+		JsonTimer_Stop(&jsonTimer);
 	}
 	return(bytesWritten);
 }
 
 //*****************************************************************************
-int		JsonResponse_Add_ArrayEnd(	const int		socketFD,
-									char			*jsonTextBuffer,
-									const int		maxLen,
-									bool			includeTrailingComma)
+int	JsonWriter_Add_ArrayEnd(	TYPE_JsonWriter	*writer,
+								bool			includeTrailingComma)
 {
-int		payloadLen;
+TYPE_JsonTimer	jsonTimer;
 int		bytesWritten	=	0;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer != NULL) && (writer->buffer != NULL))
 	{
-		//*	calculate the length of what we are adding to the buffer
-		payloadLen	=	10;
-
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
-
-		strcat(jsonTextBuffer, "\t\t]");
-		if (includeTrailingComma)
-		{
-			strcat(jsonTextBuffer, ",");
-		}
-		strcat(jsonTextBuffer, "\r\n");
+		JsonTimer_Start(&jsonTimer);
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, 10);
 
+		JsonWriter_AppendLiteral(writer, "\t\t]");
+		JsonWriter_AppendEndOfLine(writer, includeTrailingComma);
+		JsonTimer_Stop(&jsonTimer);
 	}
 	return(bytesWritten);
 }
 
-
-
 //*****************************************************************************
-int		JsonResponse_Add_EndBlock(	const int		socketFD,
-									char			*jsonTextBuffer,
-									const int		maxLen,
-									bool			includeTrailingComma)
+int	JsonWriter_Add_EndBlock(	TYPE_JsonWriter	*writer,
+								bool			includeTrailingComma)
 {
-int		payloadLen;
+TYPE_JsonTimer	jsonTimer;
 int		bytesWritten	=	0;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer != NULL) && (writer->buffer != NULL))
 	{
-		//*	calculate the length of what we are adding to the buffer
-		payloadLen		=	8;
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
-
-	#ifdef _MAKE_JSON_PRETTY_
-		strcat(jsonTextBuffer, "\t}");
-	#else
-		strcat(jsonTextBuffer, "}");
-	#endif
-		if (includeTrailingComma)
-		{
-			strcat(jsonTextBuffer, ",");
-		}
-		strcat(jsonTextBuffer, "\r\n");
+		JsonTimer_Start(&jsonTimer);
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, 8);
 
+		JsonWriter_AppendLiteral(writer, kBlockIndent "}");
+		JsonWriter_AppendEndOfLine(writer, includeTrailingComma);
+		JsonTimer_Stop(&jsonTimer);
 	}
 	return(bytesWritten);
 }
 
 //*****************************************************************************
-int		JsonResponse_Add_RawText(	const int		socketFD,
-									char			*jsonTextBuffer,
-									const int		maxLen,
-									const char		*rawTextBuffer)
+int	JsonWriter_Add_RawText(	TYPE_JsonWriter	*writer,
+							const char		*rawTextBuffer)
 {
-int		payloadLen;
-int		bytesWritten	=	0;
+TYPE_JsonTimer	jsonTimer;
+int				payloadLen;
+int				bytesWritten	=	0;
+struct iovec	ioVector[1];
 
-#ifdef _DEBUG_JSON_RESPONSE_
-	if ((jsonTextBuffer != NULL) && (rawTextBuffer != NULL))
+	if ((writer != NULL) && (writer->buffer != NULL) && (rawTextBuffer != NULL))
 	{
-
+		JsonTimer_Start(&jsonTimer);
 		//*	calculate the length of what we are adding to the buffer
-		payloadLen	=	strlen(rawTextBuffer);
-		CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
-		CONSOLE_DEBUG_W_NUM("payloadLen            \t=", payloadLen);
-
-		bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen);
-		CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
-
-		strcat(jsonTextBuffer, rawTextBuffer);
-		CONSOLE_DEBUG(__FUNCTION__);
+		payloadLen		=	strlen(rawTextBuffer);
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, payloadLen);
+		if ((writer->length + payloadLen) < writer->maxLen)
+		{
+			JsonWriter_Append(writer, rawTextBuffer, payloadLen);
+		}
+		else
+		{
+			//*	bigger than the whole buffer, send it as is
+			ioVector[0].iov_base	=	(void *)rawTextBuffer;
+			ioVector[0].iov_len		=	payloadLen;
+			bytesWritten			+=	JsonWriter_WriteV(writer->socketFD, ioVector, 1);
+		}
+		JsonTimer_Stop(&jsonTimer);
 	}
 	else
 	{
 		CONSOLE_DEBUG("Internal error");
 	}
-#else
-	//*	calculate the length of what we are adding to the buffer
-	payloadLen	=	strlen(rawTextBuffer);
-
-	bytesWritten	=	JsonRespnse_XmitIfFull(socketFD, jsonTextBuffer, maxLen, payloadLen, false);
-
-	strcat(jsonTextBuffer, rawTextBuffer);
-#endif // _DEBUG_JSON_RESPONSE_
 	return(bytesWritten);
 }
 
 //*****************************************************************************
 //*	returns bytes written
 //*****************************************************************************
-int			JsonResponse_Add_Finish(const int		socketFD,
-									const int		httpRetCode,
-									char			*jsonTextBuffer,
-									bool			includeHeader)
+int	JsonWriter_Finish(	TYPE_JsonWriter	*writer,
+						const int		httpRetCode,
+						bool			includeHeader)
 {
-char	fullDataBuffer[kMaxJsonBuffLen];
-int		bytesWritten	=	0;
-
-//	CONSOLE_DEBUG(__FUNCTION__);
-//	CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
-//	CONSOLE_DEBUG_W_NUM("kMaxJsonBuffLen      \t=", kMaxJsonBuffLen);
-
-	fullDataBuffer[0]	=	0;
+TYPE_JsonTimer	jsonTimer;
+char			httpHeader[kMaxJsonHdrLen];
+struct iovec	ioVector[2];
+int				ioVectorCnt;
+int				bytesWritten	=	0;
+int				connectionType;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer != NULL) && (writer->buffer != NULL))
 	{
-		fullDataBuffer[0]	=	0;
-		strcat(jsonTextBuffer, "}\r\n");
-
-		if (strlen(jsonTextBuffer) >= sizeof(fullDataBuffer))
-		{
-			CONSOLE_DEBUG("Buffer overflow!!!!!!!!!!!");
-			CONSOLE_ABORT("Buffer overflow!!!!!!!!!!!");
-		}
+		JsonTimer_Start(&jsonTimer);
+		bytesWritten	=	JsonWriter_XmitIfFull(writer, 4);
+		JsonWriter_AppendLiteral(writer, "}\r\n");
 
-		//CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
+		ioVectorCnt	=	0;
 		if (includeHeader)
 		{
-			JsonResponse_FinishHeader(httpRetCode, fullDataBuffer, jsonTextBuffer);
+			//*	header and data go out together, the connection can be reused if the client wants
+			if (SocketListen_StartFramedResponse(writer->socketFD))
+			{
+				connectionType	=	kHttpConnection_KeepAlive;
+			}
+			else
+			{
+				connectionType	=	kHttpConnection_Close;
+			}
+			httpHeader[0]	=	0;
+			JsonResponse_BuildHeader(httpRetCode, httpHeader, writer->length, connectionType);
+			ioVector[ioVectorCnt].iov_base	=	httpHeader;
+			ioVector[ioVectorCnt].iov_len	=	strlen(httpHeader);
+			ioVectorCnt++;
 		}
 		else
 		{
-			fullDataBuffer[0]	=	0;
+			//*	somebody else sent the header
+			SocketListen_UnframedResponse(writer->socketFD);
 		}
-CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
-CONSOLE_DEBUG_W_NUM("len of fullDataBuffer\t=", strlen(fullDataBuffer));
-		strcat(fullDataBuffer, jsonTextBuffer);
-CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
-CONSOLE_DEBUG_W_NUM("len of fullDataBuffer\t=", strlen(fullDataBuffer));
-
-//		CONSOLE_DEBUG_W_STR("jsonTextBuffer=", jsonTextBuffer);
-//		CONSOLE_DEBUG_W_STR("Full json message=\r\n", fullDataBuffer);
-
-		bytesWritten	=	JsonResponse_SendTextBuffer(socketFD, fullDataBuffer);
-//		bytesWritten	=	JsonResponse_SendTextBuffer(socketFD, jsonTextBuffer);
-		jsonTextBuffer[0]	=	0;
-
+		ioVector[ioVectorCnt].iov_base	=	writer->buffer;
+		ioVector[ioVectorCnt].iov_len	=	writer->length;
+		ioVectorCnt++;
+
+		bytesWritten		+=	JsonWriter_WriteV(writer->socketFD, ioVector, ioVectorCnt);
+		writer->length		=	0;
+		writer->buffer[0]	=	0;
+		JsonTimer_Stop(&jsonTimer);
 	}
 	else
 	{
@@ -662,45 +839,197 @@ CONSOLE_DEBUG_W_NUM("len of fullDataBuffer\t=", strlen(fullDataBuffer));
 }
 
 //*****************************************************************************
-int	JsonResponse_SendTextBuffer(const int socketFD, char *jsonTextBuffer)
+//*	this is used to send data without a Content-Length, the connection will not be reused
+//*****************************************************************************
+int	JsonWriter_Send(TYPE_JsonWriter *writer)
 {
 int		bytesWritten	=	0;
-size_t	bufLen;
-int		tryCount;
-bool	keepTrying;
 
-	if (jsonTextBuffer != NULL)
+	if ((writer != NULL) && (writer->buffer != NULL))
 	{
-CONSOLE_DEBUG_W_NUM("len of jsonTextBuffer\t=", strlen(jsonTextBuffer));
-//		CONSOLE_DEBUG_W_STR("jsonTextBuffer\t=", jsonTextBuffer);
-		bufLen			=	strlen(jsonTextBuffer);
-		tryCount		=	0;
-		keepTrying		=	true;
-		while (keepTrying && (tryCount < 10))
-		{
-//CONSOLE_DEBUG_W_NUM("SSIZE_MAX\t=", SSIZE_MAX);
-CONSOLE_DEBUG_W_NUM("bufLen   \t=", bufLen);
-CONSOLE_DEBUG_W_NUM("Calling write with socketFD=", socketFD);
-			bytesWritten	=	write(socketFD, jsonTextBuffer, bufLen);
-CONSOLE_DEBUG_W_NUM("bytesWritten=", bytesWritten);
-			if (bytesWritten > 0)
-			{
-				keepTrying			=	false;
-				jsonTextBuffer[0]	=	0;	//*	reset the buffer
-			}
-			else
-			{
-				CONSOLE_DEBUG_W_NUM("tryCount\t=", tryCount);
-				CONSOLE_DEBUG_W_NUM("Error writting to socket, socketFD\t=", socketFD);
-				CONSOLE_DEBUG_W_NUM("Error writting to socket, errno\t=", errno);
-			//	sleep(1);
-			}
-			tryCount++;
-		}
+		SocketListen_UnframedResponse(writer->socketFD);
+		bytesWritten	=	JsonWriter_Flush(writer);
 	}
-	else
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+//*	The JsonResponse_xxx() routines are the original API.
+//*	They are used all over the drivers, they now just call the writer
+//*****************************************************************************
+int	JsonResponse_Add_Data(	const int	socketFD,
+							char		*jsonTextBuffer,
+							const int	maxLen)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_Data(JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen));
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_String(const int	socketFD,
+							char		*jsonTextBuffer,
+							const int	maxLen,
+							const char	*itemName,
+							const char	*stringValue,
+							bool		includeTrailingComma)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_String(	JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen),
+												itemName,
+												stringValue,
+												includeTrailingComma);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_Int32(	const int		socketFD,
+							char			*jsonTextBuffer,
+							const int		maxLen,
+							const char		*itemName,
+							const int32_t	intValue,
+							bool			includeTrailingComma)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_Int32(	JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen),
+												itemName,
+												intValue,
+												includeTrailingComma);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_Uint32(const int		socketFD,
+							char			*jsonTextBuffer,
+							const int		maxLen,
+							const char		*itemName,
+							const uint32_t	uIntValue,
+							bool			includeTrailingComma)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_Uint32(	JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen),
+												itemName,
+												uIntValue,
+												includeTrailingComma);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_Double(const int		socketFD,
+							char			*jsonTextBuffer,
+							const int		maxLen,
+							const char		*itemName,
+							const double	dblValue,
+							bool			includeTrailingComma)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_Double(	JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen),
+												itemName,
+												dblValue,
+												includeTrailingComma);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_Bool(	const int		socketFD,
+							char			*jsonTextBuffer,
+							const int		maxLen,
+							const char		*itemName,
+							const bool		boolValue,
+							bool			includeTrailingComma)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_Bool(	JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen),
+											itemName,
+											boolValue,
+											includeTrailingComma);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_ArrayStart(const int		socketFD,
+								char			*jsonTextBuffer,
+								const int		maxLen,
+								const char		*itemName)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_ArrayStart(JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen), itemName);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_ArrayEnd(	const int		socketFD,
+								char			*jsonTextBuffer,
+								const int		maxLen,
+								bool			includeTrailingComma)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_ArrayEnd(JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen), includeTrailingComma);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_EndBlock(	const int		socketFD,
+								char			*jsonTextBuffer,
+								const int		maxLen,
+								bool			includeTrailingComma)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_EndBlock(JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen), includeTrailingComma);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+int	JsonResponse_Add_RawText(	const int		socketFD,
+								char			*jsonTextBuffer,
+								const int		maxLen,
+								const char		*rawTextBuffer)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Add_RawText(JsonWriter_Attach(socketFD, jsonTextBuffer, maxLen), rawTextBuffer);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+//*	returns bytes written
+//*****************************************************************************
+int	JsonResponse_Add_Finish(const int		socketFD,
+							const int		httpRetCode,
+							char			*jsonTextBuffer,
+							bool			includeHeader)
+{
+int		bytesWritten;
+
+	bytesWritten	=	JsonWriter_Finish(	JsonWriter_Attach(socketFD, jsonTextBuffer, kMaxJsonBuffLen),
+											httpRetCode,
+											includeHeader);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+//*	this is used to send data without a Content-Length, the connection will not be reused
+//*****************************************************************************
+int	JsonResponse_SendTextBuffer(const int socketFD, char *jsonTextBuffer)
+{
+TYPE_JsonWriter	*writer;
+
+	writer	=	NULL;
+	if (jsonTextBuffer != NULL)
 	{
-		CONSOLE_DEBUG("jsonTextBuffer was NULL");
+		//*	this is also used for buffers other than the json text buffer, they can be any size
+		//*	and they are filled in with sprintf()/strcpy(), so the saved length can not be trusted
+		gJsonWriter.buffer	=	NULL;
+		writer				=	JsonWriter_Attach(socketFD, jsonTextBuffer, 0x7fffffff);
 	}
-	return(bytesWritten);
+	return(JsonWriter_Send(writer));
 }
@@ -100,9 +100,38 @@ int		JsonResponse_Add_RawText(	const int		socketFD,
 int		JsonResponse_SendTextBuffer(const int		socketFD,
 									char			*jsonTextBuffer);
 
+//*	per thread, time spent in the JsonResponse_Add_xxx() routines and writing to the socket
+void	JsonResponse_ResetPhaseTimes(void);
+void	JsonResponse_GetPhaseTimes(uint32_t *serialize_uS, uint32_t *socketWrite_uS);
+
 #define	INCLUDE_COMMA	true
 #define	NO_COMMA		false
 
+//*****************************************************************************
+//*	keeps track of the length of the text so nothing has to call strlen()
+//*****************************************************************************
+typedef struct
+{
+	int		socketFD;
+	char	*buffer;
+	int		length;
+	int		maxLen;
+} TYPE_JsonWriter;
+
+void	JsonWriter_Init(			TYPE_JsonWriter *writer, const int socketFD, char *jsonTextBuffer, const int maxLen);
+int		JsonWriter_Add_Data(		TYPE_JsonWriter *writer);
+int		JsonWriter_Add_String(		TYPE_JsonWriter *writer, const char *itemName, const char *stringValue,	bool includeTrailingComma);
+int		JsonWriter_Add_Int32(		TYPE_JsonWriter *writer, const char *itemName, const int32_t intValue,	bool includeTrailingComma);
+int		JsonWriter_Add_Uint32(		TYPE_JsonWriter *writer, const char *itemName, const uint32_t uIntValue,	bool includeTrailingComma);
+int		JsonWriter_Add_Double(		TYPE_JsonWriter *writer, const char *itemName, const double dblValue,	bool includeTrailingComma);
+int		JsonWriter_Add_Bool(		TYPE_JsonWriter *writer, const char *itemName, const bool boolValue,	bool includeTrailingComma);
+int		JsonWriter_Add_ArrayStart(	TYPE_JsonWriter *writer, const char *itemName);
+int		JsonWriter_Add_ArrayEnd(	TYPE_JsonWriter *writer, bool includeTrailingComma);
+int		JsonWriter_Add_EndBlock(	TYPE_JsonWriter *writer, bool includeTrailingComma);
+int		JsonWriter_Add_RawText(		TYPE_JsonWriter *writer, const char *rawTextBuffer);
+int		JsonWriter_Finish(			TYPE_JsonWriter *writer, const int httpRetCode, bool includeHeader);
+int		JsonWriter_Send(			TYPE_JsonWriter *writer);
+
 
 #ifdef __cplusplus
 }
@@ -18,6 +18,10 @@
 //*	Nov 29,	2022	<MLS> Added httpUserAgent to TYPE_GetPutRequestData struct
 //*	Nov 29,	2022	<MLS> Added clientIs_xxx  to TYPE_GetPutRequestData struct
 //*	May 17,	2024	<MLS> Added httpRetCode to TYPE_GetPutRequestData struct
+//*	Oct 16,	2026	<MLS> htmlData is now a pointer to the received data, no more 8K copy
+//*	Oct 16,	2026	<MLS> Added TYPE_RequestTokens, offsets into htmlData from a single pass
+//*	Oct 16,	2026	<MLS> Added TYPE_ParamIndex, decoded key/value pairs from contentData
+//*	Oct 16,	2026	<MLS> Added TYPE_RequestTiming, per phase timing of each request
 //*****************************************************************************
 //#include	"RequestData.h"
 
@@ -35,12 +39,15 @@
 //*****************************************************************************
 //*	the TYPE_GetPutRequestData simplifies parsing and passing of the
 //*	parsed data to subroutines
-#define	kHTMLbufLen			8192
 #define	kDeviceTypeMaxLen	64
 #define	kContentDataLen		4096
 #define	kMaxCommandLen		512
 #define	kHTTPbufLen			512
 #define	kUserAgentLen		256
+#define	kMaxPathSegments	8
+#define	kMaxHeaderTokens	32
+#define	kMaxRequestParams	48
+#define	kParamHashSlots		128		//*	must be a power of 2, more than kMaxRequestParams
 
 //*****************************************************************************
 typedef enum
@@ -60,6 +67,81 @@ typedef enum
 } TYPE_Client;
 
 
+//*****************************************************************************
+//*	offset and length of a piece of htmlData, nothing is copied
+typedef struct
+{
+	int		offset;
+	int		length;
+} TYPE_TokenSpan;
+
+//*****************************************************************************
+typedef struct
+{
+	TYPE_TokenSpan	name;
+	TYPE_TokenSpan	value;
+} TYPE_HeaderToken;
+
+//*****************************************************************************
+//*	PUT /api/v1/camera/0/exposuretime?abc=1 HTTP/1.1
+//*	method  target                          version
+//*	        path                      query
+//*	         segment[0..4]
+//*****************************************************************************
+typedef struct
+{
+	TYPE_TokenSpan		method;
+	TYPE_TokenSpan		target;
+	TYPE_TokenSpan		path;
+	TYPE_TokenSpan		query;
+	TYPE_TokenSpan		version;
+	int					segmentCnt;
+	TYPE_TokenSpan		segment[kMaxPathSegments];
+	int					headerCnt;
+	TYPE_HeaderToken	header[kMaxHeaderTokens];
+	TYPE_TokenSpan		body;
+} TYPE_RequestTokens;
+
+//*****************************************************************************
+//*	the query or form parameters, split and percent decoded once per request
+//*	keyOffset and valueOffset are into paramBuffer, both are null terminated
+typedef struct
+{
+	short		keyOffset;
+	short		valueOffset;
+	uint32_t	keyHash;			//*	case insensitive
+} TYPE_RequestParam;
+
+//*****************************************************************************
+typedef struct
+{
+	int					paramCnt;
+	TYPE_RequestParam	param[kMaxRequestParams];
+	int8_t				hashSlot[kParamHashSlots];		//*	index into param[], -1 if empty
+	char				paramBuffer[kContentDataLen + (2 * kMaxRequestParams)];
+} TYPE_ParamIndex;
+
+//*****************************************************************************
+//*	where the time goes while handling a request
+typedef enum
+{
+	kReqPhase_Parse		=	0,		//*	tokenize the request, decode the parameters
+	kReqPhase_LockWait,				//*	waiting for another thread using the same device
+	kReqPhase_Dispatch,				//*	the driver itself, i.e. the SDK calls
+	kReqPhase_Json,					//*	building the JSON response, every JsonWriter_Add_xxx() call
+	kReqPhase_SocketWrite,			//*	writing the JSON response to the socket
+
+	kReqPhase_last
+} TYPE_RequestPhase;
+
+//*****************************************************************************
+typedef struct
+{
+	uint64_t	startTime_nS;					//*	CLOCK_MONOTONIC when parsing started
+	uint32_t	phase_uS[kReqPhase_last];
+	uint32_t	total_uS;
+} TYPE_RequestTiming;
+
 //*****************************************************************************
 typedef struct	//	TYPE_GetPutRequestData
 {
@@ -68,7 +150,9 @@ typedef struct	//	TYPE_GetPutRequestData
 	int					deviceNumber;
 	char				get_putIndicator;
 	int					contentLength;
-	char				htmlData[kHTMLbufLen];
+	const char			*htmlData;				//*	points to the received data, valid for this request only
+	int					htmlDataLen;
+	TYPE_RequestTokens	tokens;
 	char				httpCmdString[kHTTPbufLen];
 	char				httpUserAgent[kUserAgentLen];
 	TYPE_Client			cHTTPclientType;
@@ -81,10 +165,12 @@ typedef struct	//	TYPE_GetPutRequestData
 	char				cmdBuffer[kMaxCommandLen];
 	char				deviceCommand[kMaxCommandLen];
 	char				contentData[kContentDataLen];
+	TYPE_ParamIndex		params;					//*	built from contentData by the parser
 	TYPE_ASCOM_STATUS	alpacaErrCode;
 	char				alpacaErrMsg[256];
 	char				ClientTransactionIDstr[64];
 	int					ClientTransactionID;
+	TYPE_RequestTiming	timing;
 	//----------------------------------------------------
 	//*	outgoing data
 	int					httpRetCode;
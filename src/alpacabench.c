@@ -0,0 +1,847 @@
+//*****************************************************************************
+//*
+//*	Name:			alpacabench.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Load generator and latency benchmark for Alpaca servers
+//*
+//*	Usage notes:	Uses sendrequest_lib.c and json_parse.c, the same code the clients use.
+//*					Point it at a running AlpacaPi (the simulators work fine) and it
+//*					reports requests/sec, latency percentiles, error counts and
+//*					MB/sec for imagearray downloads.
+//*
+//*		alpacabench -a 127.0.0.1 -p 6800 -d camera/0 -d telescope/0 -c 8 -r 200 -t 30
+//*		alpacabench -d camera/0 -m get=50,put=5,readall=20,devicestate=20,image=5
+//*
+//*		-a	IP address of the server (default 127.0.0.1)
+//*		-p	port (default 6800)
+//*		-d	device type/number, can be used more than once
+//*		-c	concurrency, number of threads sending requests (default 4)
+//*		-r	requests per second for all threads combined, 0 = as fast as possible (default 0)
+//*		-t	duration in seconds (default 10)
+//*		-m	mix of request types, weights (default get=70,put=5,readall=10,devicestate=10,image=5)
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created alpacabench.c
+//*	Oct 16,	2026	<MLS> Added request mix, rate limiting and latency histograms
+//*	Oct 16,	2026	<MLS> Added imagearray download with MB/sec
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<strings.h>
+#include	<ctype.h>
+#include	<unistd.h>
+#include	<time.h>
+#include	<errno.h>
+#include	<pthread.h>
+#include	<netdb.h>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<arpa/inet.h>
+#include	<netinet/in.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"alpaca_defs.h"
+#include	"json_parse.h"
+#include	"sendrequest_lib.h"
+#include	"latencyhistogram.h"
+
+char	gUserAgentAlpacaPiStr[80]	=	"User-Agent: AlpacaPi alpacabench\r\n";
+
+//*****************************************************************************
+enum
+{
+	kBench_Get	=	0,
+	kBench_Put,
+	kBench_Readall,
+	kBench_DeviceState,
+	kBench_Image,
+
+	kBench_last
+};
+
+static const char	*gBenchTypeNames[kBench_last]	=
+{
+	"get",
+	"put",
+	"readall",
+	"devicestate",
+	"image"
+};
+
+//*****************************************************************************
+//*	cheap properties to poll, these are what the clients ask for over and over
+//*****************************************************************************
+#define	kPropertiesPerDevice	3
+typedef struct
+{
+	char	deviceType[16];
+	char	getProperty[kPropertiesPerDevice][32];
+} TYPE_BenchDeviceProps;
+
+static const TYPE_BenchDeviceProps	gBenchDeviceProps[]	=
+{
+	{	"camera",		{	"camerastate",		"ccdtemperature",	"imageready"			}	},
+	{	"dome",			{	"azimuth",			"shutterstatus",	"slewing"				}	},
+	{	"filterwheel",	{	"position",			"names",			"focusoffsets"			}	},
+	{	"focuser",		{	"position",			"ismoving",			"temperature"			}	},
+	{	"rotator",		{	"position",			"ismoving",			"mechanicalposition"	}	},
+	{	"telescope",	{	"rightascension",	"declination",		"tracking"				}	},
+
+	//*	anything else gets the common properties
+	{	"",				{	"connected",		"name",				"description"			}	},
+};
+
+//*****************************************************************************
+#define	kMaxBenchDevices	16
+typedef struct
+{
+	char						deviceType[32];
+	int							deviceNum;
+	bool						isCamera;
+	const TYPE_BenchDeviceProps	*props;
+} TYPE_BenchDevice;
+
+//*****************************************************************************
+//*	the histogram is the same as the server side command timing (latencyhistogram.c)
+//*****************************************************************************
+typedef struct
+{
+	uint32_t	count;
+	uint32_t	errorCnt;			//*	could not connect, no response, bad http status
+	uint32_t	alpacaErrCnt;		//*	response had ErrorNumber != 0
+	uint64_t	latencySum_uS;
+	uint32_t	max_uS;
+	uint64_t	bytesRcvd;			//*	image data only
+	uint32_t	bucket[kLatencyBucketCnt];
+} TYPE_BenchStats;
+
+//*****************************************************************************
+typedef struct
+{
+	pthread_t		threadID;
+	int				threadIdx;
+	unsigned int	randomSeed;
+	uint32_t		transactionID;
+	SJP_Parser_t	jsonParser;
+	TYPE_BenchStats	stats[kBench_last];
+} TYPE_BenchWorker;
+
+//*****************************************************************************
+static struct sockaddr_in	gServerAddress;
+static char					gServerName[64]			=	"127.0.0.1";
+static int					gServerPort				=	kAlpacaPiDefaultPORT;
+static TYPE_BenchDevice		gBenchDevices[kMaxBenchDevices];
+static int					gBenchDeviceCnt			=	0;
+static int					gCameraDeviceIdx[kMaxBenchDevices];
+static int					gCameraDeviceCnt		=	0;
+static int					gConcurrency			=	4;
+static int					gRequestRate			=	0;		//*	per second, all threads
+static int					gDuration_Secs			=	10;
+static int					gMixWeight[kBench_last]	=	{	70,	5,	10,	10,	5	};
+static int					gMixTotal				=	0;
+static uint64_t				gBenchStart_uS;
+static uint64_t				gBenchEnd_uS;
+
+//*****************************************************************************
+static uint64_t	GetMicroSecs(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(((uint64_t)timeSpec.tv_sec * 1000000) + (timeSpec.tv_nsec / 1000));
+}
+
+//*****************************************************************************
+static uint32_t	BenchStats_Percentile(const TYPE_BenchStats *stats, const int percentile)
+{
+	return(LatencyHist_Percentile(stats->bucket, stats->count, stats->max_uS, percentile));
+}
+
+//*****************************************************************************
+static void	BenchStats_Record(TYPE_BenchStats *stats, const uint32_t latency_uS)
+{
+	stats->count++;
+	stats->latencySum_uS	+=	latency_uS;
+	stats->bucket[LatencyHist_BucketIndex(latency_uS)]++;
+	if (latency_uS > stats->max_uS)
+	{
+		stats->max_uS	=	latency_uS;
+	}
+}
+
+//*****************************************************************************
+static void	BenchStats_Merge(TYPE_BenchStats *totals, const TYPE_BenchStats *stats)
+{
+int		iii;
+
+	totals->count			+=	stats->count;
+	totals->errorCnt		+=	stats->errorCnt;
+	totals->alpacaErrCnt	+=	stats->alpacaErrCnt;
+	totals->latencySum_uS	+=	stats->latencySum_uS;
+	totals->bytesRcvd		+=	stats->bytesRcvd;
+	if (stats->max_uS > totals->max_uS)
+	{
+		totals->max_uS	=	stats->max_uS;
+	}
+	for (iii=0; iii<kLatencyBucketCnt; iii++)
+	{
+		totals->bucket[iii]	+=	stats->bucket[iii];
+	}
+}
+
+//*****************************************************************************
+//*	returns the alpaca error number from the response, 0 if there was none
+//*****************************************************************************
+static int	GetAlpacaErrorNumber(SJP_Parser_t *jsonParser)
+{
+int		jjj;
+
+	for (jjj=0; jjj<jsonParser->tokenCount_Data; jjj++)
+	{
+		if (strcasecmp(jsonParser->dataList[jjj].keyword, "ErrorNumber") == 0)
+		{
+			return(atoi(jsonParser->dataList[jjj].valueString));
+		}
+	}
+	return(0);
+}
+
+//*****************************************************************************
+//*	returns true if a valid json response was received
+//*****************************************************************************
+static bool	SendBenchRequest(	TYPE_BenchWorker		*worker,
+								const TYPE_BenchDevice	*device,
+								const int				benchType,
+								const int				propertyIdx,
+								int						*alpacaErrNum)
+{
+char	urlString[256];
+char	dataString[128];
+bool	validData;
+
+	worker->transactionID++;
+	switch(benchType)
+	{
+		case kBench_Put:
+			sprintf(urlString,	"/api/v1/%s/%d/connected", device->deviceType, device->deviceNum);
+			sprintf(dataString,	"Connected=true&ClientID=%d&ClientTransactionID=%u",
+								(worker->threadIdx + 1),
+								worker->transactionID);
+			validData	=	SendPutCommand(&gServerAddress, gServerPort, urlString, dataString, &worker->jsonParser);
+			break;
+
+		case kBench_Readall:
+		case kBench_DeviceState:
+			sprintf(urlString,	"/api/v1/%s/%d/%s?ClientID=%d&ClientTransactionID=%u",
+								device->deviceType,
+								device->deviceNum,
+								((benchType == kBench_Readall) ? "readall" : "devicestate"),
+								(worker->threadIdx + 1),
+								worker->transactionID);
+			validData	=	GetJsonResponse(&gServerAddress, gServerPort, urlString, NULL, &worker->jsonParser);
+			break;
+
+		case kBench_Get:
+		default:
+			sprintf(urlString,	"/api/v1/%s/%d/%s?ClientID=%d&ClientTransactionID=%u",
+								device->deviceType,
+								device->deviceNum,
+								device->props->getProperty[propertyIdx % kPropertiesPerDevice],
+								(worker->threadIdx + 1),
+								worker->transactionID);
+			validData	=	GetJsonResponse(&gServerAddress, gServerPort, urlString, NULL, &worker->jsonParser);
+			break;
+	}
+	*alpacaErrNum	=	0;
+	if (validData)
+	{
+		if (worker->jsonParser.tokenCount_Data > 0)
+		{
+			*alpacaErrNum	=	GetAlpacaErrorNumber(&worker->jsonParser);
+		}
+		else
+		{
+			validData	=	false;
+		}
+	}
+	return(validData);
+}
+
+//*****************************************************************************
+//*	downloads the image in binary form and throws it away
+//*	returns the number of bytes of image data, -1 on error
+//*****************************************************************************
+static long	DownloadImage(TYPE_BenchWorker *worker, const TYPE_BenchDevice *device)
+{
+char	urlString[256];
+char	readBuffer[64 * 1024];
+int		socketDesc;
+int		recvByteCnt;
+long	totalBytes;
+long	headerLen;
+bool	statusOK;
+char	*endOfHeader;
+
+	worker->transactionID++;
+	sprintf(urlString,	"/api/v1/%s/%d/imagearray?ClientID=%d&ClientTransactionID=%u",
+						device->deviceType,
+						device->deviceNum,
+						(worker->threadIdx + 1),
+						worker->transactionID);
+
+	socketDesc	=	OpenSocketAndSendRequest(&gServerAddress, gServerPort, "GET", urlString, NULL, READ_BINARY_IMAGE);
+	if (socketDesc < 0)
+	{
+		return(-1);
+	}
+	totalBytes	=	0;
+	headerLen	=	-1;
+	statusOK	=	false;
+	while ((recvByteCnt = recv(socketDesc, readBuffer, (sizeof(readBuffer) - 1), 0)) > 0)
+	{
+		if (headerLen < 0)
+		{
+			//*	the status line and the header are always in the first read
+			readBuffer[recvByteCnt]	=	0;
+			statusOK				=	(strncmp(readBuffer, "HTTP/1.", 7) == 0) && (strncmp(&readBuffer[9], "200", 3) == 0);
+			endOfHeader				=	strstr(readBuffer, "\r\n\r\n");
+			headerLen				=	(endOfHeader != NULL) ? ((endOfHeader - readBuffer) + 4) : 0;
+		}
+		totalBytes	+=	recvByteCnt;
+	}
+	close(socketDesc);
+
+	if ((statusOK == false) || (totalBytes <= headerLen))
+	{
+		return(-1);
+	}
+	return(totalBytes - headerLen);
+}
+
+//*****************************************************************************
+static int	PickBenchType(TYPE_BenchWorker *worker)
+{
+int		randomNum;
+int		iii;
+
+	randomNum	=	rand_r(&worker->randomSeed) % gMixTotal;
+	for (iii=0; iii<kBench_last; iii++)
+	{
+		if (randomNum < gMixWeight[iii])
+		{
+			return(iii);
+		}
+		randomNum	-=	gMixWeight[iii];
+	}
+	return(kBench_Get);
+}
+
+//*****************************************************************************
+static void	*BenchWorkerThread(void *arg)
+{
+TYPE_BenchWorker		*worker;
+const TYPE_BenchDevice	*device;
+TYPE_BenchStats			*stats;
+int						benchType;
+int						alpacaErrNum;
+bool					validData;
+long					imageBytes;
+uint64_t				interval_uS;
+uint64_t				nextSend_uS;
+uint64_t				startTime_uS;
+uint64_t				currentTime_uS;
+uint32_t				requestCnt;
+
+	worker		=	(TYPE_BenchWorker *)arg;
+	interval_uS	=	0;
+	if (gRequestRate > 0)
+	{
+		interval_uS	=	((uint64_t)gConcurrency * 1000000) / gRequestRate;
+	}
+	//*	spread the threads out over the first interval
+	nextSend_uS	=	gBenchStart_uS + ((interval_uS * worker->threadIdx) / gConcurrency);
+	requestCnt	=	0;
+
+	while ((currentTime_uS = GetMicroSecs()) < gBenchEnd_uS)
+	{
+		if (interval_uS > 0)
+		{
+			if (currentTime_uS < nextSend_uS)
+			{
+				usleep(nextSend_uS - currentTime_uS);
+			}
+			nextSend_uS	+=	interval_uS;
+			//*	if we fell behind, do not try to catch up with a burst
+			if ((nextSend_uS + interval_uS) < currentTime_uS)
+			{
+				nextSend_uS	=	currentTime_uS;
+			}
+		}
+
+		benchType	=	PickBenchType(worker);
+		if (benchType == kBench_Image)
+		{
+			device	=	&gBenchDevices[gCameraDeviceIdx[rand_r(&worker->randomSeed) % gCameraDeviceCnt]];
+		}
+		else
+		{
+			device	=	&gBenchDevices[rand_r(&worker->randomSeed) % gBenchDeviceCnt];
+		}
+		stats			=	&worker->stats[benchType];
+		startTime_uS	=	GetMicroSecs();
+		if (benchType == kBench_Image)
+		{
+			imageBytes		=	DownloadImage(worker, device);
+			validData		=	(imageBytes >= 0);
+			alpacaErrNum	=	0;
+			if (validData)
+			{
+				stats->bytesRcvd	+=	imageBytes;
+			}
+		}
+		else
+		{
+			validData	=	SendBenchRequest(worker, device, benchType, requestCnt, &alpacaErrNum);
+		}
+		BenchStats_Record(stats, (GetMicroSecs() - startTime_uS));
+		if (validData == false)
+		{
+			stats->errorCnt++;
+		}
+		else if (alpacaErrNum != 0)
+		{
+			stats->alpacaErrCnt++;
+		}
+		requestCnt++;
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+//*	there has to be an image before imagearray will return one
+//*****************************************************************************
+static void	PrepareCameras(void)
+{
+SJP_Parser_t	*jsonParser;
+char			urlString[256];
+char			valueString[64];
+int				iii;
+int				waitCnt;
+bool			imageReady;
+TYPE_BenchDevice	*device;
+
+	jsonParser	=	(SJP_Parser_t *)calloc(1, sizeof(SJP_Parser_t));
+	if (jsonParser == NULL)
+	{
+		return;
+	}
+	for (iii=0; iii<gCameraDeviceCnt; iii++)
+	{
+		device	=	&gBenchDevices[gCameraDeviceIdx[iii]];
+		printf("Taking an exposure on %s/%d for the imagearray tests\n", device->deviceType, device->deviceNum);
+
+		sprintf(urlString, "/api/v1/%s/%d/connected", device->deviceType, device->deviceNum);
+		SendPutCommand(&gServerAddress, gServerPort, urlString, "Connected=true&ClientID=1&ClientTransactionID=1", jsonParser);
+
+		sprintf(urlString, "/api/v1/%s/%d/startexposure", device->deviceType, device->deviceNum);
+		SendPutCommand(&gServerAddress, gServerPort, urlString, "Duration=0.01&Light=true&ClientID=1&ClientTransactionID=2", jsonParser);
+
+		imageReady	=	false;
+		waitCnt		=	0;
+		sprintf(urlString, "/api/v1/%s/%d/imageready?ClientID=1&ClientTransactionID=3", device->deviceType, device->deviceNum);
+		while ((imageReady == false) && (waitCnt < 100))
+		{
+			usleep(100 * 1000);
+			if (GetJsonResponse(&gServerAddress, gServerPort, urlString, NULL, jsonParser) &&
+				SJP_FindKeyWordString("VALUE", jsonParser->dataList, jsonParser->tokenCount_Data, valueString))
+			{
+				imageReady	=	(strcasecmp(valueString, "true") == 0);
+			}
+			waitCnt++;
+		}
+		if (imageReady == false)
+		{
+			printf("WARNING: %s/%d never reported imageready, image requests will fail\n", device->deviceType, device->deviceNum);
+		}
+	}
+	free(jsonParser);
+}
+
+//*****************************************************************************
+static void	PrintStatsLine(const char *typeName, const TYPE_BenchStats *stats, const double elapsed_Secs)
+{
+	printf("%-12s %8u %7u %7u %9.1f %9.3f %9.3f %9.3f %9.3f %9.3f",
+			typeName,
+			stats->count,
+			stats->errorCnt,
+			stats->alpacaErrCnt,
+			(stats->count / elapsed_Secs),
+			((stats->count > 0) ? ((stats->latencySum_uS / 1000.0) / stats->count) : 0.0),
+			(BenchStats_Percentile(stats, 50) / 1000.0),
+			(BenchStats_Percentile(stats, 90) / 1000.0),
+			(BenchStats_Percentile(stats, 99) / 1000.0),
+			(stats->max_uS / 1000.0));
+	if (stats->bytesRcvd > 0)
+	{
+		printf(" %9.2f", ((stats->bytesRcvd / (1024.0 * 1024.0)) / elapsed_Secs));
+	}
+	printf("\n");
+}
+
+//*****************************************************************************
+static void	PrintResults(TYPE_BenchWorker *workers, const double elapsed_Secs)
+{
+TYPE_BenchStats	*typeTotals;
+TYPE_BenchStats	*grandTotal;
+int				iii;
+int				jjj;
+
+	typeTotals	=	(TYPE_BenchStats *)calloc(kBench_last + 1, sizeof(TYPE_BenchStats));
+	if (typeTotals == NULL)
+	{
+		return;
+	}
+	grandTotal	=	&typeTotals[kBench_last];
+	for (iii=0; iii<gConcurrency; iii++)
+	{
+		for (jjj=0; jjj<kBench_last; jjj++)
+		{
+			BenchStats_Merge(&typeTotals[jjj], &workers[iii].stats[jjj]);
+			BenchStats_Merge(grandTotal, &workers[iii].stats[jjj]);
+		}
+	}
+
+	printf("\n");
+	printf("Server %s:%d, %d threads, %.1f seconds\n", gServerName, gServerPort, gConcurrency, elapsed_Secs);
+	printf("Latency in milli-seconds\n");
+	printf("%-12s %8s %7s %7s %9s %9s %9s %9s %9s %9s %9s\n",
+			"Type", "Count", "Errors", "AlpErr", "Req/sec", "Mean", "p50", "p90", "p99", "Max", "MB/sec");
+	for (jjj=0; jjj<kBench_last; jjj++)
+	{
+		if (typeTotals[jjj].count > 0)
+		{
+			PrintStatsLine(gBenchTypeNames[jjj], &typeTotals[jjj], elapsed_Secs);
+		}
+	}
+	PrintStatsLine("total", grandTotal, elapsed_Secs);
+	free(typeTotals);
+}
+
+//*****************************************************************************
+static bool	AddBenchDevice(const char *deviceString)
+{
+TYPE_BenchDevice	*device;
+const char			*slashPtr;
+int					typeLen;
+int					iii;
+
+	if (gBenchDeviceCnt >= kMaxBenchDevices)
+	{
+		printf("Too many devices, max is %d\n", kMaxBenchDevices);
+		return(false);
+	}
+	device		=	&gBenchDevices[gBenchDeviceCnt];
+	slashPtr	=	strchr(deviceString, '/');
+	typeLen		=	(slashPtr != NULL) ? (slashPtr - deviceString) : (int)strlen(deviceString);
+	if ((typeLen <= 0) || (typeLen >= (int)sizeof(device->deviceType)))
+	{
+		printf("Invalid device %s, should be type/number, i.e. camera/0\n", deviceString);
+		return(false);
+	}
+	for (iii=0; iii<typeLen; iii++)
+	{
+		device->deviceType[iii]	=	tolower(deviceString[iii]);
+	}
+	device->deviceType[typeLen]	=	0;
+	device->deviceNum			=	(slashPtr != NULL) ? atoi(slashPtr + 1) : 0;
+	device->isCamera			=	(strcmp(device->deviceType, "camera") == 0);
+
+	//*	find the properties to poll, the last entry is the default
+	iii	=	0;
+	while ((gBenchDeviceProps[iii].deviceType[0] != 0) &&
+			(strcmp(gBenchDeviceProps[iii].deviceType, device->deviceType) != 0))
+	{
+		iii++;
+	}
+	device->props	=	&gBenchDeviceProps[iii];
+	if (device->isCamera)
+	{
+		gCameraDeviceIdx[gCameraDeviceCnt++]	=	gBenchDeviceCnt;
+	}
+	gBenchDeviceCnt++;
+	return(true);
+}
+
+//*****************************************************************************
+//*	get=70,put=5,readall=10,devicestate=10,image=5
+//*	anything not listed gets a weight of 0
+//*****************************************************************************
+static bool	ParseMixString(const char *mixString)
+{
+char	myMixString[256];
+char	*tokenPtr;
+char	*savePtr;
+char	*equalsPtr;
+int		iii;
+bool	foundIt;
+
+	strncpy(myMixString, mixString, (sizeof(myMixString) - 1));
+	myMixString[sizeof(myMixString) - 1]	=	0;
+	for (iii=0; iii<kBench_last; iii++)
+	{
+		gMixWeight[iii]	=	0;
+	}
+	tokenPtr	=	strtok_r(myMixString, ",", &savePtr);
+	while (tokenPtr != NULL)
+	{
+		equalsPtr	=	strchr(tokenPtr, '=');
+		foundIt		=	false;
+		if (equalsPtr != NULL)
+		{
+			*equalsPtr	=	0;
+			for (iii=0; iii<kBench_last; iii++)
+			{
+				if (strcasecmp(tokenPtr, gBenchTypeNames[iii]) == 0)
+				{
+					gMixWeight[iii]	=	atoi(equalsPtr + 1);
+					foundIt			=	true;
+				}
+			}
+		}
+		if (foundIt == false)
+		{
+			printf("Invalid mix entry: %s\n", tokenPtr);
+			return(false);
+		}
+		tokenPtr	=	strtok_r(NULL, ",", &savePtr);
+	}
+	return(true);
+}
+
+//*****************************************************************************
+static bool	LookupServerAddress(void)
+{
+struct addrinfo	hints;
+struct addrinfo	*addrResult;
+int				returnCode;
+
+	memset(&gServerAddress, 0, sizeof(gServerAddress));
+	gServerAddress.sin_family	=	AF_INET;
+	gServerAddress.sin_port		=	htons(gServerPort);
+	if (inet_pton(AF_INET, gServerName, &gServerAddress.sin_addr) == 1)
+	{
+		return(true);
+	}
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family		=	AF_INET;
+	hints.ai_socktype	=	SOCK_STREAM;
+	returnCode			=	getaddrinfo(gServerName, NULL, &hints, &addrResult);
+	if (returnCode != 0)
+	{
+		printf("Can not find server %s: %s\n", gServerName, gai_strerror(returnCode));
+		return(false);
+	}
+	gServerAddress.sin_addr	=	((struct sockaddr_in *)addrResult->ai_addr)->sin_addr;
+	freeaddrinfo(addrResult);
+	return(true);
+}
+
+//*****************************************************************************
+static void	PrintHelp(const char *appName)
+{
+	printf("usage: %s [options]\n", appName);
+	printf("\t-a <address>     IP address or host name of the server (default 127.0.0.1)\n");
+	printf("\t-p <port>        port (default %d)\n", kAlpacaPiDefaultPORT);
+	printf("\t-d <type/num>    device to test, i.e. camera/0, can be used more than once\n");
+	printf("\t-c <count>       number of threads sending requests (default 4)\n");
+	printf("\t-r <rate>        requests per second, all threads combined, 0 = no limit (default 0)\n");
+	printf("\t-t <seconds>     how long to run (default 10)\n");
+	printf("\t-m <mix>         request mix (default get=70,put=5,readall=10,devicestate=10,image=5)\n");
+	printf("\n");
+	printf("The simulators in drivers/Simulator are the easiest thing to run this against\n");
+}
+
+//*****************************************************************************
+static bool	ProcessCmdLineArgs(int argc, char **argv)
+{
+int			ii;
+char		theChar;
+const char	*argValue;
+
+	ii	=	1;
+	while (ii < argc)
+	{
+		if ((argv[ii][0] == '-') && (argv[ii][1] != 0))
+		{
+			theChar		=	argv[ii][1];
+			argValue	=	NULL;
+			if (argv[ii][2] != 0)
+			{
+				argValue	=	&argv[ii][2];
+			}
+			else if ((ii + 1) < argc)
+			{
+				ii++;
+				argValue	=	argv[ii];
+			}
+			if ((argValue == NULL) && (theChar != 'h'))
+			{
+				printf("Option -%c needs a value\n", theChar);
+				return(false);
+			}
+			switch(theChar)
+			{
+				case 'a':
+					strncpy(gServerName, argValue, (sizeof(gServerName) - 1));
+					break;
+
+				case 'p':
+					gServerPort		=	atoi(argValue);
+					break;
+
+				case 'd':
+					if (AddBenchDevice(argValue) == false)
+					{
+						return(false);
+					}
+					break;
+
+				case 'c':
+					gConcurrency	=	atoi(argValue);
+					break;
+
+				case 'r':
+					gRequestRate	=	atoi(argValue);
+					break;
+
+				case 't':
+					gDuration_Secs	=	atoi(argValue);
+					break;
+
+				case 'm':
+					if (ParseMixString(argValue) == false)
+					{
+						return(false);
+					}
+					break;
+
+				case 'h':
+				default:
+					PrintHelp(argv[0]);
+					return(false);
+			}
+		}
+		else
+		{
+			PrintHelp(argv[0]);
+			return(false);
+		}
+		ii++;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+TYPE_BenchWorker	*workers;
+int					iii;
+int					returnCode;
+int					threadsStarted;
+uint64_t			benchFinish_uS;
+
+	if (ProcessCmdLineArgs(argc, argv) == false)
+	{
+		return(1);
+	}
+	if (gBenchDeviceCnt == 0)
+	{
+		AddBenchDevice("camera/0");
+	}
+	if ((gConcurrency <= 0) || (gDuration_Secs <= 0) || (gRequestRate < 0))
+	{
+		printf("Concurrency and duration must be more than 0\n");
+		return(1);
+	}
+	if ((gMixWeight[kBench_Image] > 0) && (gCameraDeviceCnt == 0))
+	{
+		printf("No camera in the device list, image requests are disabled\n");
+		gMixWeight[kBench_Image]	=	0;
+	}
+	gMixTotal	=	0;
+	for (iii=0; iii<kBench_last; iii++)
+	{
+		gMixTotal	+=	gMixWeight[iii];
+	}
+	if (gMixTotal <= 0)
+	{
+		printf("Nothing to do, the request mix is empty\n");
+		return(1);
+	}
+	if (LookupServerAddress() == false)
+	{
+		return(1);
+	}
+	if (gMixWeight[kBench_Image] > 0)
+	{
+		PrepareCameras();
+	}
+
+	workers	=	(TYPE_BenchWorker *)calloc(gConcurrency, sizeof(TYPE_BenchWorker));
+	if (workers == NULL)
+	{
+		printf("Failed to allocate memory for %d threads\n", gConcurrency);
+		return(1);
+	}
+
+	printf("Running %d threads for %d seconds against %s:%d\n", gConcurrency, gDuration_Secs, gServerName, gServerPort);
+	gBenchStart_uS	=	GetMicroSecs();
+	gBenchEnd_uS	=	gBenchStart_uS + ((uint64_t)gDuration_Secs * 1000000);
+	threadsStarted	=	0;
+	for (iii=0; iii<gConcurrency; iii++)
+	{
+		workers[iii].threadIdx	=	iii;
+		workers[iii].randomSeed	=	(unsigned int)(gBenchStart_uS + iii);
+		returnCode				=	pthread_create(&workers[iii].threadID, NULL, &BenchWorkerThread, &workers[iii]);
+		if (returnCode != 0)
+		{
+			CONSOLE_DEBUG_W_NUM("pthread_create() failed, errno\t=", returnCode);
+			break;
+		}
+		threadsStarted++;
+	}
+	for (iii=0; iii<threadsStarted; iii++)
+	{
+		pthread_join(workers[iii].threadID, NULL);
+	}
+	benchFinish_uS	=	GetMicroSecs();
+	gConcurrency	=	threadsStarted;
+
+	PrintResults(workers, ((benchFinish_uS - gBenchStart_uS) / 1000000.0));
+	free(workers);
+	return(0);
+}
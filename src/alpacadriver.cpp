@@ -200,6 +200,25 @@
 //*	Jan  4,	2025	<MLS> Added Supported Devices Table
 //*	Jan  4,	2025	<MLS> Added AddSupportedDevice() & DumpSupportedDeviceList()
 //*	Jan 10,	2025	<MLS> Added _ENABLE_CPU_NANOSECS_DISPLAY_
+//*	Oct 16,	2026	<MLS> HTTP requests are now processed by a pool of listen worker threads
+//*	Oct 16,	2026	<MLS> Added -w <count> command line option for number of worker threads
+//*	Oct 16,	2026	<MLS> Added listener statistics (in flight, queue depth) to stats page
+//*	Oct 16,	2026	<MLS> Limit copy of request into reqData->htmlData to kHTMLbufLen
+//*	Oct 16,	2026	<MLS> Added keep-alive / connection reuse counts to stats page
+//*	Oct 16,	2026	<MLS> Requests are now tokenized in a single pass, no copy of htmlData
+//*	Oct 16,	2026	<MLS> Each worker thread reuses its own TYPE_GetPutRequestData
+//*	Oct 16,	2026	<MLS> Added BuildCommandHashTables(), FindCmdFromTable() uses a perfect hash
+//*	Oct 16,	2026	<MLS> Added gDeviceRouteTable for device type/number lookup
+//*	Oct 16,	2026	<MLS> Parameters are decoded once into reqData->params, GetKeyWordArgument() looks them up
+//*	Oct 16,	2026	<MLS> Added per command latency histograms, OutputHTML_CmdTiming()
+//*	Oct 16,	2026	<MLS> Added slow request log, /stats/json
+//*	Oct 16,	2026	<MLS> Added -i <count> command line option for number of image save threads
+//*	Oct 17,	2026	<MLS> Added OutputHTML_DeviceStats(), devices can add their own stats to the stats page
+//*	Oct 17,	2026	<MLS> Added -m <options> command line option for the image buffer pool
+//*	Oct 17,	2026	<MLS> Added outgoing request (keep-alive client) statistics to stats page
+//*	Oct 17,	2026	<MLS> /stats/json sends the HTTP header first, the response can be more than one buffer
+//*	Oct 17,	2026	<MLS> Added ReleaseCmdProcessLock(), image downloads no longer block other commands
+//*	Oct 17,	2026	<MLS> FindCmdFromTable() finds the hash index from the table pointer, no list search
 //*****************************************************************************
 //*	to install code blocks 20
 //*	Step 1: sudo add-apt-repository ppa:codeblocks-devs/release
@@ -248,6 +267,7 @@
 #include	"alpacadriver_helper.h"
 #include	"eventlogging.h"
 #include	"socket_listen.h"
+#include	"sendrequest_lib.h"
 #include	"discoverythread.h"
 #include	"html_common.h"
 #include	"observatory_settings.h"
@@ -337,6 +357,8 @@
 
 
 AlpacaDriver	*gAlpacaDeviceList[kMaxDevices];
+//*	direct lookup by device type and alpaca device number, filled in by the constructor
+static AlpacaDriver	*gDeviceRouteTable[kDeviceType_last][kMaxDevices];
 bool			gKeepRunning								=	true;
 int				gDeviceCnt									=	0;
 bool			gLiveView									=	false;
@@ -353,6 +375,9 @@ char			gFullVersionString[128]						=	"";
 int				gAlpacaListenPort							=	kAlpacaPiDefaultPORT;	//*	6800 is the default
 uint32_t		gClientID									=	1;
 uint32_t		gServerTransactionID						=	1;		//*	we are the server, we will increment this each time a transaction occurs
+int				gListenWorkerThreadCnt						=	kSocketListen_DefaultWorkers;
+int				gImageSaveThreadCnt							=	1;		//*	camera image save writer threads
+static pthread_mutex_t	gRequestMutex						=	PTHREAD_MUTEX_INITIALIZER;	//*	for globals shared by the listen worker threads
 bool			gErrorLogging								=	false;	//*	write errors to log file if true
 bool			gConformLogging								=	false;	//*	log all commands to log file to match up with Conform
 bool			gImageDownloadInProgress					=	false;
@@ -373,6 +398,7 @@ int				gHTTP_OptionsRequestCnt						=	0;
 static void	OutputHTML_Form(TYPE_GetPutRequestData *reqData);
 static void	OutputHTML_html(TYPE_GetPutRequestData *reqData);
 static void	SendHtml_CompiledInfo(const int socketFD);
+static inline uint32_t	CmdHash(const char *theCmd, const uint32_t seed);
 
 
 //*****************************************************************************
@@ -553,6 +579,7 @@ int		iii;
 		gAlpacaDeviceList[iii]	=	NULL;
 	}
 	gDeviceCnt	=	0;
+	memset((void *)gDeviceRouteTable, 0, sizeof(gDeviceRouteTable));
 
 	for (iii=0; iii<kMaxSupportedDevices; iii++)
 	{
@@ -688,6 +715,13 @@ int		iii;
 	{
 		gAlpacaDeviceList[gDeviceCnt]	=	this;
 		gDeviceCnt++;
+		//*	the first one in the list wins, same as the linear search did
+		if ((cDeviceType >= 0) && (cDeviceType < kDeviceType_last) &&
+			(cAlpacaDeviceNum < kMaxDevices) &&
+			(gDeviceRouteTable[cDeviceType][cAlpacaDeviceNum] == NULL))
+		{
+			gDeviceRouteTable[cDeviceType][cAlpacaDeviceNum]	=	this;
+		}
 	}
 	else
 	{
@@ -706,6 +740,15 @@ int		iii;
 	{
 		memset(&cDeviceCmdStats[iii], 0, sizeof(TYPE_CMD_STATS));
 	}
+	for (iii=0; iii<kCmd_Common_last; iii++)
+	{
+		cCommonCmdTiming[iii]	=	NULL;
+	}
+	for (iii=0; iii<kDeviceCmdCnt; iii++)
+	{
+		cDeviceCmdTiming[iii]	=	NULL;
+	}
+	cCurrentCmdNum	=	-1;
 	GetAlpacaName(argDeviceType, cAlpacaName);
 	LogEvent(	cAlpacaName,
 				"Created",
@@ -717,6 +760,7 @@ int		iii;
 	cDriverThreadIsActive		=	false;
 	cDriverThreadKeepRunning	=	false;
 	cDriverThreadID				=	0;
+	pthread_mutex_init(&cCmdProcessMutex, NULL);
 
 #ifdef _ENABLE_BANDWIDTH_LOGGING_
 	BandWidthStatsInit();
@@ -747,6 +791,53 @@ int	iii;
 			gAlpacaDeviceList[iii]	=	NULL;
 		}
 	}
+	if ((cDeviceType >= 0) && (cDeviceType < kDeviceType_last) &&
+		(cAlpacaDeviceNum >= 0) && (cAlpacaDeviceNum < kMaxDevices) &&
+		(gDeviceRouteTable[cDeviceType][cAlpacaDeviceNum] == this))
+	{
+		gDeviceRouteTable[cDeviceType][cAlpacaDeviceNum]	=	NULL;
+	}
+	for (iii=0; iii<kCmd_Common_last; iii++)
+	{
+		if (cCommonCmdTiming[iii] != NULL)
+		{
+			free(cCommonCmdTiming[iii]);
+			cCommonCmdTiming[iii]	=	NULL;
+		}
+	}
+	for (iii=0; iii<kDeviceCmdCnt; iii++)
+	{
+		if (cDeviceCmdTiming[iii] != NULL)
+		{
+			free(cDeviceCmdTiming[iii]);
+			cDeviceCmdTiming[iii]	=	NULL;
+		}
+	}
+	pthread_mutex_destroy(&cCmdProcessMutex);
+}
+
+//*****************************************************************************
+//*	called from inside ProcessCommand() with cCmdProcessMutex locked.
+//*	the other worker threads may run commands for this device until RetakeCmdProcessLock(),
+//*	they reset the per command values, so they are saved here
+//*****************************************************************************
+void	AlpacaDriver::ReleaseCmdProcessLock(TYPE_CmdProcessState *cmdState)
+{
+	cmdState->sendJSONresponse			=	cSendJSONresponse;
+	cmdState->httpHeaderSent			=	cHttpHeaderSent;
+	cmdState->bytesWrittenForThisCmd	=	cBytesWrittenForThisCmd;
+	cmdState->currentCmdNum				=	cCurrentCmdNum;
+	pthread_mutex_unlock(&cCmdProcessMutex);
+}
+
+//*****************************************************************************
+void	AlpacaDriver::RetakeCmdProcessLock(TYPE_CmdProcessState *cmdState)
+{
+	pthread_mutex_lock(&cCmdProcessMutex);
+	cSendJSONresponse		=	cmdState->sendJSONresponse;
+	cHttpHeaderSent			=	cmdState->httpHeaderSent;
+	cBytesWrittenForThisCmd	=	cmdState->bytesWrittenForThisCmd;
+	cCurrentCmdNum			=	cmdState->currentCmdNum;
 }
 
 
@@ -1963,6 +2054,7 @@ char	getPutIndicator;
 	SocketWriteData(mySocketFD,	"</CENTER>\r\n");
 	SocketWriteData(mySocketFD,	"<P>\r\n");
 
+	OutputHTML_CmdTiming(reqData);
 
 #ifdef _ENABLE_BANDWIDTH_LOGGING_
 	//----------------------------------------------------------------------------------
@@ -2021,6 +2113,7 @@ void	AlpacaDriver::RecordCmdStats(int cmdNum, char getput, TYPE_ASCOM_STATUS alp
 {
 int		tblIdx;
 
+	cCurrentCmdNum	=	cmdNum;		//*	so the dispatcher can record the timing
 	//*	check for common command index ( > 1000)
 	if (cmdNum >= kCmd_Common_action)
 	{
@@ -2069,6 +2162,235 @@ int		tblIdx;
 	}
 }
 
+//*****************************************************************************
+//*	percentile is 1 to 100, the answer is never more than the max
+//*****************************************************************************
+static uint32_t	CmdTimingPercentile(const TYPE_CMD_TIMING *cmdTiming, const int percentile)
+{
+	return(LatencyHist_Percentile(cmdTiming->bucket, cmdTiming->count, cmdTiming->max_uS, percentile));
+}
+
+//*****************************************************************************
+//*	returns NULL if the command number is not valid or the histogram has not been used yet
+//*****************************************************************************
+TYPE_CMD_TIMING	*AlpacaDriver::GetCmdTimingPtr(const int cmdNum, const bool allocate)
+{
+TYPE_CMD_TIMING	**timingPtrPtr;
+int				tblIdx;
+
+	timingPtrPtr	=	NULL;
+	if (cmdNum >= kCmd_Common_action)
+	{
+		tblIdx	=	cmdNum - kCmd_Common_action;
+		if ((tblIdx >= 0) && (tblIdx < kCmd_Common_last))
+		{
+			timingPtrPtr	=	&cCommonCmdTiming[tblIdx];
+		}
+	}
+	else if ((cmdNum >= 0) && (cmdNum < kDeviceCmdCnt))
+	{
+		timingPtrPtr	=	&cDeviceCmdTiming[cmdNum];
+	}
+
+	if (timingPtrPtr == NULL)
+	{
+		return(NULL);
+	}
+	if ((*timingPtrPtr == NULL) && allocate)
+	{
+		*timingPtrPtr	=	(TYPE_CMD_TIMING *)calloc(1, sizeof(TYPE_CMD_TIMING));
+	}
+	return(*timingPtrPtr);
+}
+
+//*****************************************************************************
+//*	called with cCmdProcessMutex locked, after ProcessCommand()
+//*****************************************************************************
+void	AlpacaDriver::RecordCmdTiming(TYPE_GetPutRequestData *reqData)
+{
+TYPE_CMD_TIMING		*cmdTiming;
+TYPE_RequestTiming	*timing;
+int					iii;
+
+	cmdTiming	=	GetCmdTimingPtr(cCurrentCmdNum, true);
+	if (cmdTiming != NULL)
+	{
+		timing	=	&reqData->timing;
+		cmdTiming->count++;
+		cmdTiming->bucket[LatencyHist_BucketIndex(timing->total_uS)]++;
+		if (timing->total_uS > cmdTiming->max_uS)
+		{
+			cmdTiming->max_uS	=	timing->total_uS;
+		}
+		for (iii=0; iii<kReqPhase_last; iii++)
+		{
+			cmdTiming->phaseSum_uS[iii]	+=	timing->phase_uS[iii];
+		}
+	}
+}
+
+//*****************************************************************************
+static void	GenerateCmdTimingEntry(	const char				*cmdName,
+									const TYPE_CMD_TIMING	*cmdTiming,
+									char					*lineBuffer)
+{
+char	phaseBuffer[64];
+int		iii;
+
+	sprintf(lineBuffer,	"<TR><TD>%s</TD><TD>%u</TD><TD>%u</TD><TD>%u</TD><TD>%u</TD><TD>%u</TD>",
+							cmdName,
+							cmdTiming->count,
+							CmdTimingPercentile(cmdTiming, 50),
+							CmdTimingPercentile(cmdTiming, 90),
+							CmdTimingPercentile(cmdTiming, 99),
+							cmdTiming->max_uS);
+	for (iii=0; iii<kReqPhase_last; iii++)
+	{
+		sprintf(phaseBuffer, "<TD>%llu</TD>", (unsigned long long)(cmdTiming->phaseSum_uS[iii] / cmdTiming->count));
+		strcat(lineBuffer, phaseBuffer);
+	}
+	strcat(lineBuffer, "</TR>\r\n");
+}
+
+//*****************************************************************************
+//*	only the commands that have been used are listed
+//*****************************************************************************
+void	AlpacaDriver::OutputHTML_CmdTiming(TYPE_GetPutRequestData *reqData)
+{
+char			lineBuffer[512];
+int				mySocketFD;
+int				iii;
+char			cmdName[32];
+char			getPutIndicator;
+TYPE_CMD_TIMING	*cmdTiming;
+
+	mySocketFD	=	reqData->socket;
+
+	SocketWriteData(mySocketFD,	"<CENTER>\r\n");
+	SocketWriteData(mySocketFD,	"Command latency (micro-seconds)<BR>\r\n");
+	SocketWriteData(mySocketFD,	"<TABLE BORDER=1>\r\n");
+	sprintf(lineBuffer,	"<TR><TH>%s</TH><TH>%s</TH><TH>%s</TH><TH>%s</TH><TH>%s</TH><TH>%s</TH>"
+						"<TH>%s</TH><TH>%s</TH><TH>%s</TH><TH>%s</TH><TH>%s</TH></TR>\r\n",
+							"Command",
+							"Count",
+							"p50",
+							"p90",
+							"p99",
+							"Max",
+							"Avg Parse",
+							"Avg Lock Wait",
+							"Avg Dispatch",
+							"Avg JSON",
+							"Avg Write");
+	SocketWriteData(mySocketFD,	lineBuffer);
+
+	for (iii=0; iii<kCmd_Common_last; iii++)
+	{
+		cmdTiming	=	cCommonCmdTiming[iii];
+		if ((cmdTiming != NULL) && (cmdTiming->count > 0) &&
+			GetCmdNameFromTable((kCmd_Common_action + iii), cmdName, gCommonCmdTable, &getPutIndicator))
+		{
+			GenerateCmdTimingEntry(cmdName, cmdTiming, lineBuffer);
+			SocketWriteData(mySocketFD,	lineBuffer);
+		}
+	}
+	for (iii=0; iii<kDeviceCmdCnt; iii++)
+	{
+		cmdTiming	=	cDeviceCmdTiming[iii];
+		if ((cmdTiming != NULL) && (cmdTiming->count > 0) &&
+			GetCmdNameFromMyCmdTable(iii, cmdName, &getPutIndicator))
+		{
+			GenerateCmdTimingEntry(cmdName, cmdTiming, lineBuffer);
+			SocketWriteData(mySocketFD,	lineBuffer);
+		}
+	}
+	SocketWriteData(mySocketFD,	"</TABLE>\r\n");
+	SocketWriteData(mySocketFD,	"</CENTER>\r\n");
+	SocketWriteData(mySocketFD,	"<P>\r\n");
+}
+
+//*****************************************************************************
+static void	GenerateCmdTimingJSON(	TYPE_GetPutRequestData	*reqData,
+									const char				*cmdName,
+									const TYPE_CMD_TIMING	*cmdTiming,
+									const bool				firstEntry)
+{
+	JsonResponse_Add_RawText(	reqData->socket,
+								reqData->jsonTextBuffer,
+								kMaxJsonBuffLen,
+								(firstEntry ? "\t\t{\r\n" : ",\r\n\t\t{\r\n"));
+
+	JsonResponse_Add_String(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "Command",		cmdName,								INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "Count",			cmdTiming->count,						INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "p50_uS",		CmdTimingPercentile(cmdTiming, 50),		INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "p90_uS",		CmdTimingPercentile(cmdTiming, 90),		INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "p99_uS",		CmdTimingPercentile(cmdTiming, 99),		INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "max_uS",		cmdTiming->max_uS,						INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "avgParse_uS",	(cmdTiming->phaseSum_uS[kReqPhase_Parse] / cmdTiming->count),		INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "avgLockWait_uS",(cmdTiming->phaseSum_uS[kReqPhase_LockWait] / cmdTiming->count),	INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "avgDispatch_uS",(cmdTiming->phaseSum_uS[kReqPhase_Dispatch] / cmdTiming->count),	INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "avgJson_uS",	(cmdTiming->phaseSum_uS[kReqPhase_Json] / cmdTiming->count),		INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "avgWrite_uS",	(cmdTiming->phaseSum_uS[kReqPhase_SocketWrite] / cmdTiming->count),	NO_COMMA);
+
+	JsonResponse_Add_RawText(	reqData->socket,
+								reqData->jsonTextBuffer,
+								kMaxJsonBuffLen,
+								"\t\t}");
+}
+
+//*****************************************************************************
+//*	for device specific statistics on the stats page, the default has none
+//*****************************************************************************
+void	AlpacaDriver::OutputHTML_DeviceStats(TYPE_GetPutRequestData *reqData)
+{
+}
+
+//*****************************************************************************
+//*	outputs a "Commands" array, only the commands that have been used are listed
+//*****************************************************************************
+void	AlpacaDriver::OutputJSON_CmdTiming(TYPE_GetPutRequestData *reqData)
+{
+int				iii;
+char			cmdName[32];
+char			getPutIndicator;
+TYPE_CMD_TIMING	*cmdTiming;
+bool			firstEntry;
+
+	JsonResponse_Add_ArrayStart(reqData->socket,
+								reqData->jsonTextBuffer,
+								kMaxJsonBuffLen,
+								"Commands");
+	firstEntry	=	true;
+	for (iii=0; iii<kCmd_Common_last; iii++)
+	{
+		cmdTiming	=	cCommonCmdTiming[iii];
+		if ((cmdTiming != NULL) && (cmdTiming->count > 0) &&
+			GetCmdNameFromTable((kCmd_Common_action + iii), cmdName, gCommonCmdTable, &getPutIndicator))
+		{
+			GenerateCmdTimingJSON(reqData, cmdName, cmdTiming, firstEntry);
+			firstEntry	=	false;
+		}
+	}
+	for (iii=0; iii<kDeviceCmdCnt; iii++)
+	{
+		cmdTiming	=	cDeviceCmdTiming[iii];
+		if ((cmdTiming != NULL) && (cmdTiming->count > 0) &&
+			GetCmdNameFromMyCmdTable(iii, cmdName, &getPutIndicator))
+		{
+			GenerateCmdTimingJSON(reqData, cmdName, cmdTiming, firstEntry);
+			firstEntry	=	false;
+		}
+	}
+	if (firstEntry == false)
+	{
+		JsonResponse_Add_RawText(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "\r\n");
+	}
+	JsonResponse_Add_ArrayEnd(	reqData->socket,
+								reqData->jsonTextBuffer,
+								kMaxJsonBuffLen,
+								NO_COMMA);
+}
+
 
 
 #pragma mark -
@@ -2102,6 +2424,8 @@ int		bytesWritten;
 //	CONSOLE_DEBUG_W_STR("socket>\t", dataBuffer);
 #endif // _DEBUG_CONFORM_
 
+	//*	nothing written this way has a Content-Length, close the connection when done
+	SocketListen_UnframedResponse(socket);
 	bufferLen		=	strlen(dataBuffer);
 	bytesWritten	=	write(socket, dataBuffer, bufferLen);
 	if (bytesWritten < 0)
@@ -2909,131 +3233,491 @@ static void	SendHtml_CompiledInfo(const int socketFD)
 }
 
 //*****************************************************************************
-static void	SendHtml_Stats(TYPE_GetPutRequestData *reqData)
+static inline uint64_t	GetMonotonicNanoSecs(void)
 {
-char	lineBuffer[256];
-int		mySocketFD;
-int		iii;
+struct timespec	timeSpec;
 
-	if (reqData != NULL)
-	{
-		mySocketFD	=	reqData->socket;
-		SocketWriteData(mySocketFD,	gHtmlHeader_html);
-		sprintf(lineBuffer, "<title>%s</title>\r\n", gWebTitle);
-		SocketWriteData(mySocketFD,	lineBuffer);
-		SocketWriteData(mySocketFD,	gHtmlBodyStart);
-		SocketWriteData(mySocketFD,	"<header>\r\n");
-		SocketWriteData(mySocketFD,	"<h1>Alpaca device driver Web server</h1>\r\n");
-		sprintf(lineBuffer, "<h3>%s</h3>\r\n", gWebTitle);
-		SocketWriteData(mySocketFD,	lineBuffer);
-		SocketWriteData(mySocketFD,	"</header>\r\n");
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(((uint64_t)timeSpec.tv_sec * 1000000000) + timeSpec.tv_nsec);
+}
 
-		OutPutObservatoryInfoHTML(mySocketFD);
+//*****************************************************************************
+//*	slow request log, the most recent requests that took longer than kSlowRequestMin_uS
+//*****************************************************************************
+#define	kSlowRequestCnt		32
+#define	kSlowRequestMin_uS	(50 * 1000)
 
-		//====================================================
-		//*	output the request counts by user agent
-		SocketWriteData(mySocketFD,	"<section class=\"section\">\r\n");
-		SocketWriteData(mySocketFD,	"<h3>Requests by User-Agent</h3>\r\n");
-		SocketWriteData(mySocketFD,	"<table>\r\n");
-		SocketWriteData(mySocketFD,	"<thead><tr><th>User-Agent</th><th class=\"text-center\">Count</th></tr></thead>\r\n");
-		SocketWriteData(mySocketFD,	"<tbody>\r\n");
-		for (iii=0; iii<kHTTPclient_last; iii++)
+typedef struct
+{
+	time_t				timeStamp;
+	char				clientIPaddr[48];
+	TYPE_Client			clientType;
+	char				httpUserAgent[64];
+	char				deviceType[32];
+	int					deviceNumber;
+	char				deviceCommand[48];
+	char				get_putIndicator;
+	TYPE_ASCOM_STATUS	alpacaErrCode;
+	TYPE_RequestTiming	timing;
+} TYPE_SlowRequest;
+
+static TYPE_SlowRequest	gSlowRequests[kSlowRequestCnt];
+static int				gSlowRequestCount	=	0;		//*	total ever recorded, the ring index is this mod kSlowRequestCnt
+static pthread_mutex_t	gSlowRequestMutex	=	PTHREAD_MUTEX_INITIALIZER;
+
+//*****************************************************************************
+//*	copy a string that will be put into html or json, get rid of anything that would break it
+//*****************************************************************************
+static void	CopySafeString(char *destString, const char *sourceString, const int maxLen)
+{
+int		ccc;
+
+	ccc	=	0;
+	while ((sourceString[ccc] != 0) && (ccc < (maxLen - 1)))
+	{
+		if ((sourceString[ccc] < 0x20) || (strchr("\"\\<>&", sourceString[ccc]) != NULL))
 		{
-			SocketWriteData(mySocketFD,	"<tr>\r\n");
-			sprintf(lineBuffer, "<td>%s</td><td class=\"text-center\">%d</td>", gUserAgentNames[iii], gUserAgentCounters[iii]);
-			SocketWriteData(mySocketFD,	lineBuffer);
-			SocketWriteData(mySocketFD,	"</tr>\r\n");
+			destString[ccc]	=	'_';
 		}
-		SocketWriteData(mySocketFD,	"</tbody>\r\n");
-		SocketWriteData(mySocketFD,	"</table>\r\n");
-		SocketWriteData(mySocketFD,	"</section>\r\n");
-
-
-		for (iii=0; iii<gDeviceCnt; iii++)
+		else
 		{
-			if (gAlpacaDeviceList[iii] != NULL)
-			{
-				SendSeparateLine(mySocketFD);
-				gAlpacaDeviceList[iii]->OutputHTML_CmdStats(reqData);
-			}
+			destString[ccc]	=	sourceString[ccc];
 		}
-
-
-		SendSeparateLine(mySocketFD);
-		SendHtml_CompiledInfo(mySocketFD);
-
-		SocketWriteData(mySocketFD,	"</div>\r\n");
-		SocketWriteData(mySocketFD,	"</body></html>\r\n");
-	}
-	else
-	{
-	//	CONSOLE_DEBUG("reqData is NULL");
+		ccc++;
 	}
+	destString[ccc]	=	0;
 }
+
 //*****************************************************************************
-static char	gDocsIntro[]	=
+static void	RecordSlowRequest(TYPE_GetPutRequestData *reqData)
 {
-	"<p>\r\n"
-	"This page documents the arguments for the Alpaca commands.\r\n"
-	"The purpose of this page is to document the extra stuff that I have added to Alpaca in AlpacaPi.\r\n"
-	"Most of the standard commands are not documented here because full documentation can be found on the Alpaca/ASCOM web site.\r\n"
-	"Commands that are <span style=\"color: #ff00ff;\">magenta</span> are the ones that have been added and\r\n"
-	"are not part of the Alpaca standard definition.\r\n"
-//	"foo\r\n"
-//	"foo\r\n"
-	"</p>\r\n"
-};
+TYPE_SlowRequest	*slowRequest;
+
+	if (reqData->timing.total_uS >= kSlowRequestMin_uS)
+	{
+		pthread_mutex_lock(&gSlowRequestMutex);
+		slowRequest						=	&gSlowRequests[gSlowRequestCount % kSlowRequestCnt];
+		slowRequest->timeStamp			=	time(NULL);
+		slowRequest->clientType			=	reqData->cHTTPclientType;
+		slowRequest->deviceNumber		=	reqData->deviceNumber;
+		slowRequest->get_putIndicator	=	reqData->get_putIndicator;
+		slowRequest->alpacaErrCode		=	reqData->alpacaErrCode;
+		slowRequest->timing				=	reqData->timing;
+		CopySafeString(slowRequest->clientIPaddr,	reqData->clientIPaddr,	sizeof(slowRequest->clientIPaddr));
+		CopySafeString(slowRequest->httpUserAgent,	reqData->httpUserAgent,	sizeof(slowRequest->httpUserAgent));
+		CopySafeString(slowRequest->deviceType,		reqData->deviceType,	sizeof(slowRequest->deviceType));
+		CopySafeString(slowRequest->deviceCommand,	reqData->deviceCommand,	sizeof(slowRequest->deviceCommand));
+		gSlowRequestCount++;
+		pthread_mutex_unlock(&gSlowRequestMutex);
+	}
+}
 
 //*****************************************************************************
-static void	OutputHTML_DriverDocs(TYPE_GetPutRequestData *reqData)
+//*	newest first, returns the number copied
+//*****************************************************************************
+static int	GetSlowRequests(TYPE_SlowRequest *slowRequests)
 {
-char	lineBuffer[256];
-int		mySocketFD;
+int		slowRequestCnt;
 int		iii;
 
-	if (reqData != NULL)
-	{
-		mySocketFD	=	reqData->socket;
-		SocketWriteData(mySocketFD,	gHtmlHeader_html);
-		sprintf(lineBuffer, "<title>%s</title>\r\n", gWebTitle);
-		SocketWriteData(mySocketFD,	lineBuffer);
-		SocketWriteData(mySocketFD,	gHtmlBodyStart);
-		SocketWriteData(mySocketFD,	"<header>\r\n");
-		SocketWriteData(mySocketFD,	"<h1>Alpaca device driver Web server</h1>\r\n");
-		sprintf(lineBuffer, "<h3>%s</h3>\r\n", gWebTitle);
-		SocketWriteData(mySocketFD,	lineBuffer);
-		SocketWriteData(mySocketFD,	"</header>\r\n");
-
-		OutPutObservatoryInfoHTML(mySocketFD);
-
-		SocketWriteData(mySocketFD,	gDocsIntro);
-
-		for (iii=0; iii<gDeviceCnt; iii++)
-		{
-			if (gAlpacaDeviceList[iii] != NULL)
-			{
-				SendSeparateLine(mySocketFD);
-				gAlpacaDeviceList[iii]->OutputHTML_DriverDocs(reqData);
-			}
-		}
-
-		SendSeparateLine(mySocketFD);
-		SendHtml_CompiledInfo(mySocketFD);
-
-		SocketWriteData(mySocketFD,	"</div>\r\n");
-		SocketWriteData(mySocketFD,	"</body></html>\r\n");
-	}
-	else
+	pthread_mutex_lock(&gSlowRequestMutex);
+	slowRequestCnt	=	(gSlowRequestCount < kSlowRequestCnt) ? gSlowRequestCount : kSlowRequestCnt;
+	for (iii=0; iii<slowRequestCnt; iii++)
 	{
-	//	CONSOLE_DEBUG("reqData is NULL");
+		slowRequests[iii]	=	gSlowRequests[(gSlowRequestCount - 1 - iii) % kSlowRequestCnt];
 	}
+	pthread_mutex_unlock(&gSlowRequestMutex);
+	return(slowRequestCnt);
 }
 
 //*****************************************************************************
-static void	OutputHTML_ClassSize(int socketFD, const char *className, size_t classSize)
+static void	SendHtml_SlowRequests(const int socketFD)
 {
-char	lineBuffer[256];
-long	deltaSize;
+TYPE_SlowRequest	slowRequests[kSlowRequestCnt];
+int					slowRequestCnt;
+char				lineBuffer[512];
+char				timeString[32];
+int					iii;
+
+	slowRequestCnt	=	GetSlowRequests(slowRequests);
+
+	SocketWriteData(socketFD,	"<section class=\"section\">\r\n");
+	sprintf(lineBuffer, "<h3>Slow requests (more than %d milli-seconds)</h3>\r\n", (kSlowRequestMin_uS / 1000));
+	SocketWriteData(socketFD,	lineBuffer);
+	SocketWriteData(socketFD,	"<table>\r\n");
+	SocketWriteData(socketFD,	"<thead><tr><th>Time</th><th>Client</th><th>User-Agent</th><th>Command</th><th>Error</th>"
+								"<th>Total uS</th><th>Parse</th><th>Lock Wait</th><th>Dispatch</th><th>JSON</th><th>Write</th></tr></thead>\r\n");
+	SocketWriteData(socketFD,	"<tbody>\r\n");
+	for (iii=0; iii<slowRequestCnt; iii++)
+	{
+		strftime(timeString, sizeof(timeString), "%Y/%m/%d %H:%M:%S", localtime(&slowRequests[iii].timeStamp));
+		sprintf(lineBuffer, "<tr><td>%s</td><td>%s</td><td>%s<br>%s</td><td>%s %s/%d/%s</td><td>%d</td>",
+							timeString,
+							slowRequests[iii].clientIPaddr,
+							gUserAgentNames[slowRequests[iii].clientType],
+							slowRequests[iii].httpUserAgent,
+							((slowRequests[iii].get_putIndicator == 'P') ? "PUT" : "GET"),
+							slowRequests[iii].deviceType,
+							slowRequests[iii].deviceNumber,
+							slowRequests[iii].deviceCommand,
+							slowRequests[iii].alpacaErrCode);
+		SocketWriteData(socketFD,	lineBuffer);
+		sprintf(lineBuffer, "<td>%u</td><td>%u</td><td>%u</td><td>%u</td><td>%u</td><td>%u</td></tr>\r\n",
+							slowRequests[iii].timing.total_uS,
+							slowRequests[iii].timing.phase_uS[kReqPhase_Parse],
+							slowRequests[iii].timing.phase_uS[kReqPhase_LockWait],
+							slowRequests[iii].timing.phase_uS[kReqPhase_Dispatch],
+							slowRequests[iii].timing.phase_uS[kReqPhase_Json],
+							slowRequests[iii].timing.phase_uS[kReqPhase_SocketWrite]);
+		SocketWriteData(socketFD,	lineBuffer);
+	}
+	SocketWriteData(socketFD,	"</tbody>\r\n");
+	SocketWriteData(socketFD,	"</table>\r\n");
+	SocketWriteData(socketFD,	"</section>\r\n");
+}
+
+//*****************************************************************************
+static void	SendJson_SlowRequests(TYPE_GetPutRequestData *reqData)
+{
+TYPE_SlowRequest	slowRequests[kSlowRequestCnt];
+int					slowRequestCnt;
+char				commandString[128];
+int					iii;
+
+	slowRequestCnt	=	GetSlowRequests(slowRequests);
+
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "SlowRequestMin_uS",	kSlowRequestMin_uS,	INCLUDE_COMMA);
+	JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "SlowRequestCount",	gSlowRequestCount,	INCLUDE_COMMA);
+	JsonResponse_Add_ArrayStart(reqData->socket,
+								reqData->jsonTextBuffer,
+								kMaxJsonBuffLen,
+								"SlowRequests");
+	for (iii=0; iii<slowRequestCnt; iii++)
+	{
+		JsonResponse_Add_RawText(	reqData->socket,
+									reqData->jsonTextBuffer,
+									kMaxJsonBuffLen,
+									((iii == 0) ? "\t\t{\r\n" : ",\r\n\t\t{\r\n"));
+
+		sprintf(commandString, "%s/%d/%s",	slowRequests[iii].deviceType,
+											slowRequests[iii].deviceNumber,
+											slowRequests[iii].deviceCommand);
+
+		JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "Time",			slowRequests[iii].timeStamp,										INCLUDE_COMMA);
+		JsonResponse_Add_String(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "ClientIP",		slowRequests[iii].clientIPaddr,										INCLUDE_COMMA);
+		JsonResponse_Add_String(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "ClientType",	gUserAgentNames[slowRequests[iii].clientType],						INCLUDE_COMMA);
+		JsonResponse_Add_String(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "UserAgent",		slowRequests[iii].httpUserAgent,									INCLUDE_COMMA);
+		JsonResponse_Add_String(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "Method",		((slowRequests[iii].get_putIndicator == 'P') ? "PUT" : "GET"),		INCLUDE_COMMA);
+		JsonResponse_Add_String(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "Command",		commandString,														INCLUDE_COMMA);
+		JsonResponse_Add_Int32(	reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "ErrorNumber",	slowRequests[iii].alpacaErrCode,									INCLUDE_COMMA);
+		JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "total_uS",		slowRequests[iii].timing.total_uS,									INCLUDE_COMMA);
+		JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "parse_uS",		slowRequests[iii].timing.phase_uS[kReqPhase_Parse],					INCLUDE_COMMA);
+		JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "lockWait_uS",	slowRequests[iii].timing.phase_uS[kReqPhase_LockWait],				INCLUDE_COMMA);
+		JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "dispatch_uS",	slowRequests[iii].timing.phase_uS[kReqPhase_Dispatch],				INCLUDE_COMMA);
+		JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "json_uS",		slowRequests[iii].timing.phase_uS[kReqPhase_Json],					INCLUDE_COMMA);
+		JsonResponse_Add_Uint32(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "write_uS",		slowRequests[iii].timing.phase_uS[kReqPhase_SocketWrite],			NO_COMMA);
+
+		JsonResponse_Add_RawText(	reqData->socket,
+									reqData->jsonTextBuffer,
+									kMaxJsonBuffLen,
+									"\t\t}");
+	}
+	if (slowRequestCnt > 0)
+	{
+		JsonResponse_Add_RawText(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "\r\n");
+	}
+	JsonResponse_Add_ArrayEnd(	reqData->socket,
+								reqData->jsonTextBuffer,
+								kMaxJsonBuffLen,
+								INCLUDE_COMMA);
+}
+
+//*****************************************************************************
+//*	/stats/json
+//*	the command latency and the slow request log in a form that a program can use
+//*	this can be more than the json buffer holds, the header goes out first
+//*	and the connection is closed at the end, just like the temperature log
+//*****************************************************************************
+static void	SendJson_Stats(TYPE_GetPutRequestData *reqData)
+{
+char	deviceTypeString[32];
+int		iii;
+bool	firstEntry;
+char	httpHeader[500];
+
+	JsonResponse_FinishHeader(reqData->httpRetCode, httpHeader, "");
+	JsonResponse_SendTextBuffer(reqData->socket, httpHeader);
+
+	JsonResponse_CreateHeader(reqData->jsonTextBuffer);
+
+	SendJson_SlowRequests(reqData);
+
+	JsonResponse_Add_ArrayStart(reqData->socket,
+								reqData->jsonTextBuffer,
+								kMaxJsonBuffLen,
+								"Devices");
+	firstEntry	=	true;
+	for (iii=0; iii<gDeviceCnt; iii++)
+	{
+		if (gAlpacaDeviceList[iii] != NULL)
+		{
+			JsonResponse_Add_RawText(	reqData->socket,
+										reqData->jsonTextBuffer,
+										kMaxJsonBuffLen,
+										(firstEntry ? "\t\t{\r\n" : ",\r\n\t\t{\r\n"));
+			firstEntry	=	false;
+
+			GetDeviceTypeFromEnum(gAlpacaDeviceList[iii]->cDeviceType, deviceTypeString);
+			JsonResponse_Add_String(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "DeviceType",	deviceTypeString,								INCLUDE_COMMA);
+			JsonResponse_Add_Int32(	reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "DeviceNumber",	gAlpacaDeviceList[iii]->cAlpacaDeviceNum,		INCLUDE_COMMA);
+			JsonResponse_Add_String(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "DeviceName",	gAlpacaDeviceList[iii]->cCommonProp.Name,		INCLUDE_COMMA);
+			JsonResponse_Add_Int32(	reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "TotalCmds",		gAlpacaDeviceList[iii]->cTotalCmdsProcessed,	INCLUDE_COMMA);
+			JsonResponse_Add_Int32(	reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "TotalErrors",	gAlpacaDeviceList[iii]->cTotalCmdErrors,		INCLUDE_COMMA);
+			gAlpacaDeviceList[iii]->OutputJSON_CmdTiming(reqData);
+
+			JsonResponse_Add_RawText(	reqData->socket,
+										reqData->jsonTextBuffer,
+										kMaxJsonBuffLen,
+										"\t\t}");
+		}
+	}
+	if (firstEntry == false)
+	{
+		JsonResponse_Add_RawText(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen, "\r\n");
+	}
+	JsonResponse_Add_ArrayEnd(	reqData->socket,
+								reqData->jsonTextBuffer,
+								kMaxJsonBuffLen,
+								NO_COMMA);
+
+	JsonResponse_Add_Finish(reqData->socket,
+							reqData->httpRetCode,
+							reqData->jsonTextBuffer,
+							kNo_HTTP_Header);
+}
+
+//*****************************************************************************
+static void	SendHtml_ListenStatsRow(const int socketFD, const char *statName, const long current, const long maxValue)
+{
+char	lineBuffer[256];
+
+	if (maxValue >= 0)
+	{
+		sprintf(lineBuffer, "<tr><td>%s</td><td class=\"text-center\">%ld</td><td class=\"text-center\">%ld</td></tr>\r\n", statName, current, maxValue);
+	}
+	else
+	{
+		sprintf(lineBuffer, "<tr><td>%s</td><td class=\"text-center\">%ld</td><td></td></tr>\r\n", statName, current);
+	}
+	SocketWriteData(socketFD,	lineBuffer);
+}
+
+//*****************************************************************************
+static void	SendHtml_ListenStats(const int socketFD)
+{
+TYPE_SocketListenStats	listenStats;
+
+	SocketListen_GetStats(&listenStats);
+
+	SocketWriteData(socketFD,	"<section class=\"section\">\r\n");
+	SocketWriteData(socketFD,	"<h3>HTTP Listener</h3>\r\n");
+	SocketWriteData(socketFD,	"<table>\r\n");
+	SocketWriteData(socketFD,	"<thead><tr><th>Statistic</th><th class=\"text-center\">Current</th><th class=\"text-center\">Max</th></tr></thead>\r\n");
+	SocketWriteData(socketFD,	"<tbody>\r\n");
+	SendHtml_ListenStatsRow(socketFD,	"Worker threads",				listenStats.WorkerThreadCnt,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Connections in flight",		listenStats.ConnectionsInFlight,	listenStats.ConnectionsInFlight_Max);
+	SendHtml_ListenStatsRow(socketFD,	"Waiting for worker",			listenStats.QueueDepth,				listenStats.QueueDepth_Max);
+	SendHtml_ListenStatsRow(socketFD,	"Kernel accept queue",			listenStats.AcceptQueueDepth,		listenStats.AcceptQueueDepth_Max);
+	SendHtml_ListenStatsRow(socketFD,	"Accept queue backlog",			listenStats.AcceptQueueBacklog,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Connections accepted",			listenStats.ConnectionsAccepted,	-1);
+	SendHtml_ListenStatsRow(socketFD,	"Connections completed",		listenStats.ConnectionsCompleted,	-1);
+	SendHtml_ListenStatsRow(socketFD,	"Worker queue full",			listenStats.QueueFullCnt,			-1);
+	SendHtml_ListenStatsRow(socketFD,	"Accept errors",				listenStats.AcceptErrors,			-1);
+	SendHtml_ListenStatsRow(socketFD,	"Requests processed",			listenStats.RequestsProcessed,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Requests on reused connection",listenStats.RequestsOnReusedConn,	-1);
+	SendHtml_ListenStatsRow(socketFD,	"Pipelined requests",			listenStats.PipelinedRequests,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Idle keep-alive connections",	listenStats.IdleConnections,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Idle connections timed out",	listenStats.IdleTimeOutCnt,			-1);
+	SocketWriteData(socketFD,	"</tbody>\r\n");
+	SocketWriteData(socketFD,	"</table>\r\n");
+	SocketWriteData(socketFD,	"</section>\r\n");
+}
+
+//*****************************************************************************
+//*	requests this driver sends to other Alpaca devices (sendrequest_lib.c)
+//*****************************************************************************
+static void	SendHtml_ClientStats(const int socketFD)
+{
+TYPE_SendRequestStats	requestStats;
+char					lineBuffer[256];
+
+	SendRequest_GetStats(&requestStats);
+
+	SocketWriteData(socketFD,	"<section class=\"section\">\r\n");
+	SocketWriteData(socketFD,	"<h3>Outgoing requests</h3>\r\n");
+	SocketWriteData(socketFD,	"<table>\r\n");
+	SocketWriteData(socketFD,	"<thead><tr><th>Statistic</th><th class=\"text-center\">Count</th><th></th></tr></thead>\r\n");
+	SocketWriteData(socketFD,	"<tbody>\r\n");
+	SendHtml_ListenStatsRow(socketFD,	"Requests",						requestStats.RequestCnt,			-1);
+	SendHtml_ListenStatsRow(socketFD,	"Requests on reused connection",requestStats.ReusedConnCnt,			-1);
+	SendHtml_ListenStatsRow(socketFD,	"Re-opened after server close",	requestStats.ReconnectCnt,			-1);
+	SendHtml_ListenStatsRow(socketFD,	"Sockets opened",				requestStats.SocketOpenOKcnt,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Socket open errors",			requestStats.SocketOpenErrCnt,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Connections made",				requestStats.SocketConnOKcnt,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Connection errors",			requestStats.SocketConnErrCnt,		-1);
+	SendHtml_ListenStatsRow(socketFD,	"Idle keep-alive connections",	requestStats.IdleConnCnt,			-1);
+	sprintf(lineBuffer, "<tr><td>Connections per request</td><td class=\"text-center\">%1.3f</td><td></td></tr>\r\n",
+							requestStats.ConnectionsPerRequest);
+	SocketWriteData(socketFD,	lineBuffer);
+	sprintf(lineBuffer, "<tr><td>Bytes received</td><td class=\"text-center\">%llu</td><td></td></tr>\r\n",
+							(unsigned long long)requestStats.BytesReceived);
+	SocketWriteData(socketFD,	lineBuffer);
+	sprintf(lineBuffer, "<tr><td>Bytes per second (while waiting)</td><td class=\"text-center\">%1.0f</td><td></td></tr>\r\n",
+							requestStats.BytesPerSecond);
+	SocketWriteData(socketFD,	lineBuffer);
+	SocketWriteData(socketFD,	"</tbody>\r\n");
+	SocketWriteData(socketFD,	"</table>\r\n");
+	SocketWriteData(socketFD,	"</section>\r\n");
+}
+
+//*****************************************************************************
+static void	SendHtml_Stats(TYPE_GetPutRequestData *reqData)
+{
+char	lineBuffer[256];
+int		mySocketFD;
+int		iii;
+
+	if (reqData != NULL)
+	{
+		mySocketFD	=	reqData->socket;
+		SocketWriteData(mySocketFD,	gHtmlHeader_html);
+		sprintf(lineBuffer, "<title>%s</title>\r\n", gWebTitle);
+		SocketWriteData(mySocketFD,	lineBuffer);
+		SocketWriteData(mySocketFD,	gHtmlBodyStart);
+		SocketWriteData(mySocketFD,	"<header>\r\n");
+		SocketWriteData(mySocketFD,	"<h1>Alpaca device driver Web server</h1>\r\n");
+		sprintf(lineBuffer, "<h3>%s</h3>\r\n", gWebTitle);
+		SocketWriteData(mySocketFD,	lineBuffer);
+		SocketWriteData(mySocketFD,	"</header>\r\n");
+
+		OutPutObservatoryInfoHTML(mySocketFD);
+
+		//====================================================
+		//*	output the request counts by user agent
+		SocketWriteData(mySocketFD,	"<section class=\"section\">\r\n");
+		SocketWriteData(mySocketFD,	"<h3>Requests by User-Agent</h3>\r\n");
+		SocketWriteData(mySocketFD,	"<table>\r\n");
+		SocketWriteData(mySocketFD,	"<thead><tr><th>User-Agent</th><th class=\"text-center\">Count</th></tr></thead>\r\n");
+		SocketWriteData(mySocketFD,	"<tbody>\r\n");
+		for (iii=0; iii<kHTTPclient_last; iii++)
+		{
+			SocketWriteData(mySocketFD,	"<tr>\r\n");
+			sprintf(lineBuffer, "<td>%s</td><td class=\"text-center\">%d</td>", gUserAgentNames[iii], gUserAgentCounters[iii]);
+			SocketWriteData(mySocketFD,	lineBuffer);
+			SocketWriteData(mySocketFD,	"</tr>\r\n");
+		}
+		SocketWriteData(mySocketFD,	"</tbody>\r\n");
+		SocketWriteData(mySocketFD,	"</table>\r\n");
+		SocketWriteData(mySocketFD,	"</section>\r\n");
+
+		//====================================================
+		//*	output the listener statistics
+		SendHtml_ListenStats(mySocketFD);
+
+		//====================================================
+		//*	output the outgoing request statistics
+		SendHtml_ClientStats(mySocketFD);
+
+		//====================================================
+		//*	output the slow request log
+		SendHtml_SlowRequests(mySocketFD);
+
+		for (iii=0; iii<gDeviceCnt; iii++)
+		{
+			if (gAlpacaDeviceList[iii] != NULL)
+			{
+				SendSeparateLine(mySocketFD);
+				gAlpacaDeviceList[iii]->OutputHTML_CmdStats(reqData);
+				gAlpacaDeviceList[iii]->OutputHTML_DeviceStats(reqData);
+			}
+		}
+
+
+		SendSeparateLine(mySocketFD);
+		SendHtml_CompiledInfo(mySocketFD);
+
+		SocketWriteData(mySocketFD,	"</div>\r\n");
+		SocketWriteData(mySocketFD,	"</body></html>\r\n");
+	}
+	else
+	{
+	//	CONSOLE_DEBUG("reqData is NULL");
+	}
+}
+//*****************************************************************************
+static char	gDocsIntro[]	=
+{
+	"<p>\r\n"
+	"This page documents the arguments for the Alpaca commands.\r\n"
+	"The purpose of this page is to document the extra stuff that I have added to Alpaca in AlpacaPi.\r\n"
+	"Most of the standard commands are not documented here because full documentation can be found on the Alpaca/ASCOM web site.\r\n"
+	"Commands that are <span style=\"color: #ff00ff;\">magenta</span> are the ones that have been added and\r\n"
+	"are not part of the Alpaca standard definition.\r\n"
+//	"foo\r\n"
+//	"foo\r\n"
+	"</p>\r\n"
+};
+
+//*****************************************************************************
+static void	OutputHTML_DriverDocs(TYPE_GetPutRequestData *reqData)
+{
+char	lineBuffer[256];
+int		mySocketFD;
+int		iii;
+
+	if (reqData != NULL)
+	{
+		mySocketFD	=	reqData->socket;
+		SocketWriteData(mySocketFD,	gHtmlHeader_html);
+		sprintf(lineBuffer, "<title>%s</title>\r\n", gWebTitle);
+		SocketWriteData(mySocketFD,	lineBuffer);
+		SocketWriteData(mySocketFD,	gHtmlBodyStart);
+		SocketWriteData(mySocketFD,	"<header>\r\n");
+		SocketWriteData(mySocketFD,	"<h1>Alpaca device driver Web server</h1>\r\n");
+		sprintf(lineBuffer, "<h3>%s</h3>\r\n", gWebTitle);
+		SocketWriteData(mySocketFD,	lineBuffer);
+		SocketWriteData(mySocketFD,	"</header>\r\n");
+
+		OutPutObservatoryInfoHTML(mySocketFD);
+
+		SocketWriteData(mySocketFD,	gDocsIntro);
+
+		for (iii=0; iii<gDeviceCnt; iii++)
+		{
+			if (gAlpacaDeviceList[iii] != NULL)
+			{
+				SendSeparateLine(mySocketFD);
+				gAlpacaDeviceList[iii]->OutputHTML_DriverDocs(reqData);
+			}
+		}
+
+		SendSeparateLine(mySocketFD);
+		SendHtml_CompiledInfo(mySocketFD);
+
+		SocketWriteData(mySocketFD,	"</div>\r\n");
+		SocketWriteData(mySocketFD,	"</body></html>\r\n");
+	}
+	else
+	{
+	//	CONSOLE_DEBUG("reqData is NULL");
+	}
+}
+
+//*****************************************************************************
+static void	OutputHTML_ClassSize(int socketFD, const char *className, size_t classSize)
+{
+char	lineBuffer[256];
+long	deltaSize;
 long	myClassSize;
 
 	deltaSize	=	classSize - sizeof(AlpacaDriver);
@@ -3383,15 +4067,62 @@ int				returnCode;
 	CONSOLE_DEBUG_W_STR(__FUNCTION__, "Exit");
 }
 
+//*****************************************************************************
+//*	called with the device mutex locked, returns the time dispatching started
+//*****************************************************************************
+static uint64_t	StartDispatchTiming(AlpacaDriver			*alpacaDevice,
+									TYPE_GetPutRequestData	*reqData,
+									const uint64_t			lockStart_nS)
+{
+uint64_t	currentTime_nS;
+
+	currentTime_nS									=	GetMonotonicNanoSecs();
+	reqData->timing.phase_uS[kReqPhase_LockWait]	=	(currentTime_nS - lockStart_nS) / 1000;
+	alpacaDevice->cCurrentCmdNum					=	-1;
+	JsonResponse_ResetPhaseTimes();
+	return(currentTime_nS);
+}
+
+//*****************************************************************************
+//*	called with the device mutex locked, after ProcessCommand()
+//*	whatever was not spent on JSON or writing to the socket was spent in the driver
+//*****************************************************************************
+static void	FinishDispatchTiming(	AlpacaDriver			*alpacaDevice,
+									TYPE_GetPutRequestData	*reqData,
+									const uint64_t			dispatchStart_nS)
+{
+TYPE_RequestTiming	*timing;
+uint64_t			currentTime_nS;
+uint32_t			elapsed_uS;
+uint32_t			jsonAndWrite_uS;
+
+	timing			=	&reqData->timing;
+	currentTime_nS	=	GetMonotonicNanoSecs();
+	JsonResponse_GetPhaseTimes(&timing->phase_uS[kReqPhase_Json], &timing->phase_uS[kReqPhase_SocketWrite]);
+
+	elapsed_uS		=	(currentTime_nS - dispatchStart_nS) / 1000;
+	jsonAndWrite_uS	=	timing->phase_uS[kReqPhase_Json] + timing->phase_uS[kReqPhase_SocketWrite];
+	timing->phase_uS[kReqPhase_Dispatch]	=	(elapsed_uS > jsonAndWrite_uS) ? (elapsed_uS - jsonAndWrite_uS) : 0;
+	timing->total_uS						=	(currentTime_nS - timing->startTime_nS) / 1000;
+
+	alpacaDevice->RecordCmdTiming(reqData);
+}
+
 //*****************************************************************************
 static TYPE_ASCOM_STATUS	ProcessAlpacaCommand(	AlpacaDriver			*alpacaDevice,
 													TYPE_GetPutRequestData	*reqData,
 													long					byteCount)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InternalError;
+uint64_t			dispatchStart_nS;
 
 	if ((alpacaDevice != NULL) && (reqData != NULL))
 	{
+		//*	a different worker thread may be processing a command for this device,
+		//*	long image transfers give the lock up while they are sending, see ReleaseCmdProcessLock()
+		dispatchStart_nS	=	GetMonotonicNanoSecs();
+		pthread_mutex_lock(&alpacaDevice->cCmdProcessMutex);
+		dispatchStart_nS	=	StartDispatchTiming(alpacaDevice, reqData, dispatchStart_nS);
 
 		alpacaDevice->cBytesWrittenForThisCmd	=	0;
 		alpacaDevice->cHttpHeaderSent			=	false;
@@ -3434,19 +4165,36 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InternalError;
 			alpacaDevice->cBW_BytesSent[gTimeUnitsSinceTopOfHour]		+=	alpacaDevice->cBytesWrittenForThisCmd;
 		}
 #endif // _ENABLE_BANDWIDTH_LOGGING_
+		FinishDispatchTiming(alpacaDevice, reqData, dispatchStart_nS);
+		pthread_mutex_unlock(&alpacaDevice->cCmdProcessMutex);
+
+		RecordSlowRequest(reqData);
 	}
 
 	return(alpacaErrCode);
 }
 
+//*****************************************************************************
+//*	returns NULL if there is no such device
+//*****************************************************************************
+static inline AlpacaDriver	*FindDeviceRoute(const int deviceTypeEnum, const int deviceNumber)
+{
+	if ((deviceTypeEnum >= 0) && (deviceTypeEnum < kDeviceType_last) &&
+		(deviceNumber >= 0) && (deviceNumber < kMaxDevices))
+	{
+		return(gDeviceRouteTable[deviceTypeEnum][deviceNumber]);
+	}
+	return(NULL);
+}
+
 //*****************************************************************************
 static TYPE_ASCOM_STATUS	ProcessAlpacaAPIrequest(TYPE_GetPutRequestData	*reqData,
 													long					byteCount)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InternalError;
 int					deviceTypeEnum;
-int					iii;
 bool				deviceFound;
+AlpacaDriver		*devicePtr;
 
 #ifdef _DEBUG_MANAGEMENT_
 	CONSOLE_DEBUG(__FUNCTION__);
@@ -3463,27 +4211,11 @@ bool				deviceFound;
 	//*	now do something with the data
 	deviceTypeEnum	=	FindDeviceTypeByStringLowerCase(reqData->deviceType);
 	deviceFound		=	false;
-	if (deviceTypeEnum != kDeviceType_undefined)
+	devicePtr		=	FindDeviceRoute(deviceTypeEnum, reqData->deviceNumber);
+	if (devicePtr != NULL)
 	{
-		for (iii=0; iii<gDeviceCnt; iii++)
-		{
-			if (gAlpacaDeviceList[iii] != NULL)
-			{
-			#ifdef _DEBUG_CONFORM_
-			//	CONSOLE_DEBUG_W_NUM("gAlpacaDeviceList[iii]->cDeviceType\t=", gAlpacaDeviceList[iii]->cDeviceType);
-			//	CONSOLE_DEBUG_W_NUM("gAlpacaDeviceList[iii]->cAlpacaDeviceNum\t=", gAlpacaDeviceList[iii]->cAlpacaDeviceNum);
-			#endif // _DEBUG_CONFORM_
-
-				if ((gAlpacaDeviceList[iii]->cDeviceType == deviceTypeEnum) &&
-					(gAlpacaDeviceList[iii]->cAlpacaDeviceNum == reqData->deviceNumber))
-				{
-					deviceFound		=	true;
-					alpacaErrCode	=	ProcessAlpacaCommand(gAlpacaDeviceList[iii], reqData, byteCount);
-
-					break;
-				}
-			}
-		}
+		deviceFound		=	true;
+		alpacaErrCode	=	ProcessAlpacaCommand(devicePtr, reqData, byteCount);
 	}
 
 	if (deviceFound == false)
@@ -3526,38 +4258,40 @@ static TYPE_ASCOM_STATUS	ProcessManagementRequest(	TYPE_GetPutRequestData	*reqDa
 														long					byteCount)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InternalError;
-int					iii;
+AlpacaDriver		*devicePtr;
+uint64_t			dispatchStart_nS;
 
 //	CONSOLE_DEBUG("MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM");
 //	CONSOLE_DEBUG(__FUNCTION__);
 //	DumpRequestStructure(__FUNCTION__, reqData);
 
-	//*	step thru the list looking for management devices
-	for (iii=0; iii<gDeviceCnt; iii++)
-	{
-		if (gAlpacaDeviceList[iii] != NULL)
+	//*	there is only one management device
+	devicePtr	=	FindDeviceRoute(kDeviceType_Management, 0);
+	if (devicePtr != NULL)
+	{
+		dispatchStart_nS	=	GetMonotonicNanoSecs();
+		pthread_mutex_lock(&devicePtr->cCmdProcessMutex);
+		dispatchStart_nS	=	StartDispatchTiming(devicePtr, reqData, dispatchStart_nS);
+		devicePtr->cHttpHeaderSent		=	false;
+		alpacaErrCode	=	devicePtr->ProcessCommand(reqData);
+		devicePtr->cTotalCmdsProcessed++;
+		if (alpacaErrCode!= kASCOM_Err_Success)
 		{
-			if (gAlpacaDeviceList[iii]->cDeviceType == kDeviceType_Management)
-			{
-				gAlpacaDeviceList[iii]->cHttpHeaderSent			=	false;
-				alpacaErrCode	=	gAlpacaDeviceList[iii]->ProcessCommand(reqData);
-				gAlpacaDeviceList[iii]->cTotalCmdsProcessed++;
-				if (alpacaErrCode!= kASCOM_Err_Success)
-				{
-					gAlpacaDeviceList[iii]->cTotalCmdErrors++;
-				}
+			devicePtr->cTotalCmdErrors++;
+		}
 #ifdef _ENABLE_BANDWIDTH_LOGGING_
-				//*	this is for network stats
-				if (gTimeUnitsSinceTopOfHour < kMaxBandWidthSamples)
-				{
-					gAlpacaDeviceList[iii]->cBW_CmdsReceived[gTimeUnitsSinceTopOfHour]	+=	1;
-					gAlpacaDeviceList[iii]->cBW_BytesReceived[gTimeUnitsSinceTopOfHour]	+=	byteCount;
-		//-			gAlpacaDeviceList[iii]->cBW_BytesSent[gTimeUnitsSinceTopOfHour];
-				}
-#endif // _ENABLE_BANDWIDTH_LOGGING_
-				break;
-			}
+		//*	this is for network stats
+		if (gTimeUnitsSinceTopOfHour < kMaxBandWidthSamples)
+		{
+			devicePtr->cBW_CmdsReceived[gTimeUnitsSinceTopOfHour]	+=	1;
+			devicePtr->cBW_BytesReceived[gTimeUnitsSinceTopOfHour]	+=	byteCount;
 		}
+#endif // _ENABLE_BANDWIDTH_LOGGING_
+		reqData->alpacaErrCode	=	alpacaErrCode;
+		FinishDispatchTiming(devicePtr, reqData, dispatchStart_nS);
+		pthread_mutex_unlock(&devicePtr->cCmdProcessMutex);
+
+		RecordSlowRequest(reqData);
 	}
 	return(alpacaErrCode);
 }
@@ -3569,9 +4303,9 @@ static TYPE_ASCOM_STATUS	ProcessAlpacaSETUPrequest(	TYPE_GetPutRequestData	*reqD
 														long					byteCount)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InternalError;
-int					iii;
 int					deviceTypeEnum;
 bool				deviceFound;
+AlpacaDriver		*devicePtr;
 
 //	CONSOLE_DEBUG("/setup/ found");
 //	CONSOLE_DEBUG_W_STR("httpCmdString\t=", reqData->httpCmdString);
@@ -3593,22 +4327,17 @@ bool				deviceFound;
 
 		deviceTypeEnum	=	FindDeviceTypeByString(reqData->deviceType);
 		deviceFound		=	false;
-		for (iii=0; iii<gDeviceCnt; iii++)
+		devicePtr		=	FindDeviceRoute(deviceTypeEnum, reqData->deviceNumber);
+		if (devicePtr != NULL)
 		{
-			if (gAlpacaDeviceList[iii] != NULL)
-			{
-				if ((gAlpacaDeviceList[iii]->cDeviceType == deviceTypeEnum) &&
-					(gAlpacaDeviceList[iii]->cAlpacaDeviceNum == reqData->deviceNumber))
-				{
-					deviceFound		=	true;
-
-//					CONSOLE_DEBUG("Calling Setup_ProcessCommand() ---------------------------------------------");
-//					CONSOLE_DEBUG_W_STR("cAlpacaName         \t=",	gAlpacaDeviceList[iii]->cAlpacaName);
-//					CONSOLE_DEBUG_W_STR("deviceCommand       \t=",	reqData->deviceCommand);
-					gAlpacaDeviceList[iii]->Setup_ProcessCommand(reqData);
-					break;
-				}
-			}
+			deviceFound		=	true;
+
+//			CONSOLE_DEBUG("Calling Setup_ProcessCommand() ---------------------------------------------");
+//			CONSOLE_DEBUG_W_STR("cAlpacaName         \t=",	devicePtr->cAlpacaName);
+//			CONSOLE_DEBUG_W_STR("deviceCommand       \t=",	reqData->deviceCommand);
+			pthread_mutex_lock(&devicePtr->cCmdProcessMutex);
+			devicePtr->Setup_ProcessCommand(reqData);
+			pthread_mutex_unlock(&devicePtr->cCmdProcessMutex);
 		}
 		if (deviceFound)
 		{
@@ -3773,6 +4502,421 @@ int			returnCode;
 }
 
 
+//*****************************************************************************
+//*	find the end of the line starting at lineStart, either CR or LF
+//*****************************************************************************
+static inline int	FindEndOfLine(const char *htmlData, const int dataLen, const int lineStart)
+{
+int	iii;
+
+	iii	=	lineStart;
+	while ((iii < dataLen) && (htmlData[iii] != 0x0d) && (htmlData[iii] != 0x0a))
+	{
+		iii++;
+	}
+	return(iii);
+}
+
+//*****************************************************************************
+//*	skip the CR/LF (or LF/CR) at the end of a line
+//*****************************************************************************
+static inline int	SkipEndOfLine(const char *htmlData, const int dataLen, const int lineEnd)
+{
+int	iii;
+
+	iii	=	lineEnd;
+	if (iii < dataLen)
+	{
+		if ((htmlData[iii] == 0x0d) && ((iii + 1) < dataLen) && (htmlData[iii + 1] == 0x0a))
+		{
+			iii	+=	2;
+		}
+		else if ((htmlData[iii] == 0x0a) && ((iii + 1) < dataLen) && (htmlData[iii + 1] == 0x0d))
+		{
+			iii	+=	2;
+		}
+		else
+		{
+			iii++;
+		}
+	}
+	return(iii);
+}
+
+//*****************************************************************************
+//*	single pass through the request, records where everything is
+//*	nothing is copied, TYPE_TokenSpan is an offset and length into htmlData
+//*****************************************************************************
+static void	TokenizeRequest(const char *htmlData, const int dataLen, TYPE_RequestTokens *tokens)
+{
+int				iii;
+int				lineEnd;
+int				lineStart;
+int				targetEnd;
+int				colonIdx;
+int				valueStart;
+int				valueEnd;
+TYPE_TokenSpan	*segmentPtr;
+
+	tokens->segmentCnt		=	0;
+	tokens->headerCnt		=	0;
+	tokens->query.offset	=	0;
+	tokens->query.length	=	0;
+	tokens->version.offset	=	0;
+	tokens->version.length	=	0;
+
+	//----------------------------------------------------------
+	//*	request line, "PUT /api/v1/camera/0/exposuretime HTTP/1.1"
+	lineEnd	=	FindEndOfLine(htmlData, dataLen, 0);
+	iii		=	0;
+	while ((iii < lineEnd) && (htmlData[iii] != 0x20))
+	{
+		iii++;
+	}
+	tokens->method.offset	=	0;
+	tokens->method.length	=	iii;
+	while ((iii < lineEnd) && (htmlData[iii] == 0x20))
+	{
+		iii++;
+	}
+	tokens->target.offset	=	iii;
+
+	//*	the version is after the LAST space, decoded %20 can put spaces in the target
+	targetEnd	=	lineEnd;
+	while ((targetEnd > tokens->target.offset) && (htmlData[targetEnd - 1] == 0x20))
+	{
+		targetEnd--;
+	}
+	valueStart	=	targetEnd;
+	while ((valueStart > tokens->target.offset) && (htmlData[valueStart - 1] != 0x20))
+	{
+		valueStart--;
+	}
+	if ((valueStart > tokens->target.offset) && (strncmp(&htmlData[valueStart], "HTTP/", 5) == 0))
+	{
+		tokens->version.offset	=	valueStart;
+		tokens->version.length	=	targetEnd - valueStart;
+		targetEnd				=	valueStart;
+		while ((targetEnd > tokens->target.offset) && (htmlData[targetEnd - 1] == 0x20))
+		{
+			targetEnd--;
+		}
+	}
+	tokens->target.length	=	targetEnd - tokens->target.offset;
+
+	//*	path segments and query string
+	tokens->path.offset	=	tokens->target.offset;
+	iii					=	tokens->target.offset;
+	if ((iii < targetEnd) && (htmlData[iii] == '/'))
+	{
+		iii++;
+	}
+	segmentPtr			=	&tokens->segment[0];
+	segmentPtr->offset	=	iii;
+	while ((iii < targetEnd) && (htmlData[iii] != '?'))
+	{
+		if (htmlData[iii] == '/')
+		{
+			if (tokens->segmentCnt < (kMaxPathSegments - 1))
+			{
+				segmentPtr->length	=	iii - segmentPtr->offset;
+				tokens->segmentCnt++;
+				segmentPtr			=	&tokens->segment[tokens->segmentCnt];
+				segmentPtr->offset	=	iii + 1;
+			}
+		}
+		iii++;
+	}
+	tokens->path.length	=	iii - tokens->path.offset;
+	segmentPtr->length	=	iii - segmentPtr->offset;
+	if ((tokens->segmentCnt > 0) || (segmentPtr->length > 0))
+	{
+		tokens->segmentCnt++;
+	}
+	if (iii < targetEnd)
+	{
+		//*	skip the '?'
+		tokens->query.offset	=	iii + 1;
+		tokens->query.length	=	targetEnd - tokens->query.offset;
+	}
+
+	//----------------------------------------------------------
+	//*	header lines, up to the first empty line
+	lineStart	=	SkipEndOfLine(htmlData, dataLen, lineEnd);
+	while (lineStart < dataLen)
+	{
+		lineEnd	=	FindEndOfLine(htmlData, dataLen, lineStart);
+		if (lineEnd == lineStart)
+		{
+			//*	empty line, the rest is the body
+			lineStart	=	SkipEndOfLine(htmlData, dataLen, lineEnd);
+			break;
+		}
+		if (tokens->headerCnt < kMaxHeaderTokens)
+		{
+			colonIdx	=	lineStart;
+			while ((colonIdx < lineEnd) && (htmlData[colonIdx] != ':'))
+			{
+				colonIdx++;
+			}
+			if (colonIdx < lineEnd)
+			{
+				valueStart	=	colonIdx + 1;
+				while ((valueStart < lineEnd) && (htmlData[valueStart] == 0x20))
+				{
+					valueStart++;
+				}
+				valueEnd	=	lineEnd;
+				while ((valueEnd > valueStart) && (htmlData[valueEnd - 1] == 0x20))
+				{
+					valueEnd--;
+				}
+				tokens->header[tokens->headerCnt].name.offset	=	lineStart;
+				tokens->header[tokens->headerCnt].name.length	=	colonIdx - lineStart;
+				tokens->header[tokens->headerCnt].value.offset	=	valueStart;
+				tokens->header[tokens->headerCnt].value.length	=	valueEnd - valueStart;
+				tokens->headerCnt++;
+			}
+		}
+		lineStart	=	SkipEndOfLine(htmlData, dataLen, lineEnd);
+	}
+	if (lineStart > dataLen)
+	{
+		lineStart	=	dataLen;
+	}
+	tokens->body.offset	=	lineStart;
+	tokens->body.length	=	dataLen - lineStart;
+}
+
+//*****************************************************************************
+//*	returns the header value span, length -1 if not found
+//*****************************************************************************
+static TYPE_TokenSpan	FindRequestHeader(TYPE_GetPutRequestData *reqData, const char *headerName)
+{
+TYPE_TokenSpan	headerValue;
+int				nameLen;
+int				iii;
+
+	headerValue.offset	=	0;
+	headerValue.length	=	-1;
+	nameLen				=	strlen(headerName);
+	for (iii=0; iii<reqData->tokens.headerCnt; iii++)
+	{
+		if ((reqData->tokens.header[iii].name.length == nameLen) &&
+			(strncasecmp(&reqData->htmlData[reqData->tokens.header[iii].name.offset], headerName, nameLen) == 0))
+		{
+			headerValue	=	reqData->tokens.header[iii].value;
+			break;
+		}
+	}
+	return(headerValue);
+}
+
+//*****************************************************************************
+//*	copy a token to a null terminated string, truncates to fit
+//*****************************************************************************
+static void	CopyRequestToken(TYPE_GetPutRequestData *reqData, const TYPE_TokenSpan *token, char *destString, const int maxLen)
+{
+int	copyLen;
+
+	copyLen	=	token->length;
+	if (copyLen > (maxLen - 1))
+	{
+		copyLen	=	maxLen - 1;
+	}
+	if (copyLen > 0)
+	{
+		memcpy(destString, &reqData->htmlData[token->offset], copyLen);
+	}
+	else
+	{
+		copyLen	=	0;
+	}
+	destString[copyLen]	=	0;
+}
+
+
+//*****************************************************************************
+//*	returns -1 if not a hex digit
+//*****************************************************************************
+static inline int	HexDigitValue(const char theChar)
+{
+	if ((theChar >= '0') && (theChar <= '9'))
+	{
+		return(theChar - '0');
+	}
+	else if ((theChar >= 'A') && (theChar <= 'F'))
+	{
+		return(theChar - 'A' + 10);
+	}
+	else if ((theChar >= 'a') && (theChar <= 'f'))
+	{
+		return(theChar - 'a' + 10);
+	}
+	return(-1);
+}
+
+//*****************************************************************************
+//*	copies srcLen chars, decoding %xx escapes and dropping control chars (CR/LF)
+//*	this replaces FixEscapedChars() in socket_listen.c, which decoded the entire
+//*	request before it was split, so an escaped '&' or '=' broke the parameters
+//*	returns the length of the decoded string
+//*****************************************************************************
+static int	PercentDecode(const char *srcPtr, const int srcLen, char *dstPtr, const int dstMaxLen)
+{
+int		iii;
+int		ccc;
+int		hiBits;
+int		loBits;
+char	theChar;
+
+	ccc	=	0;
+	iii	=	0;
+	while ((iii < srcLen) && (ccc < (dstMaxLen - 1)))
+	{
+		theChar	=	srcPtr[iii++];
+		if ((theChar == '%') && ((iii + 1) < srcLen))
+		{
+			hiBits	=	HexDigitValue(srcPtr[iii]);
+			loBits	=	HexDigitValue(srcPtr[iii + 1]);
+			if ((hiBits >= 0) && (loBits >= 0))
+			{
+				theChar	=	(hiBits << 4) + loBits;
+				iii		+=	2;
+			}
+		}
+		if (((unsigned char)theChar >= 0x20) || (theChar == 0x09))
+		{
+			dstPtr[ccc++]	=	theChar;
+		}
+	}
+	dstPtr[ccc]	=	0;
+	return(ccc);
+}
+
+//*****************************************************************************
+static void	ParamIndex_Reset(TYPE_ParamIndex *paramIndex)
+{
+	paramIndex->paramCnt	=	0;
+	memset(paramIndex->hashSlot, -1, sizeof(paramIndex->hashSlot));
+}
+
+//*****************************************************************************
+//*	split the raw content into key/value pairs, decode each one separately
+//*	and index them by a case insensitive hash of the key
+//*****************************************************************************
+static void	ParamIndex_Build(TYPE_ParamIndex *paramIndex, const char *srcPtr, const int srcLen)
+{
+int					pairStart;
+int					pairEnd;
+int					equalIdx;
+int					bufIdx;
+int					keyLen;
+int					slotIdx;
+TYPE_RequestParam	*paramPtr;
+
+	ParamIndex_Reset(paramIndex);
+	bufIdx		=	0;
+	pairStart	=	0;
+	while ((pairStart < srcLen) && (paramIndex->paramCnt < kMaxRequestParams))
+	{
+		pairEnd		=	pairStart;
+		equalIdx	=	-1;
+		while ((pairEnd < srcLen) && (srcPtr[pairEnd] != '&'))
+		{
+			if ((srcPtr[pairEnd] == '=') && (equalIdx < 0))
+			{
+				equalIdx	=	pairEnd;
+			}
+			pairEnd++;
+		}
+		if (equalIdx < 0)
+		{
+			//*	a keyword with no "=", the argument is empty
+			equalIdx	=	pairEnd;
+		}
+
+		//*	room for the key, the value and 2 null terminators
+		if ((bufIdx + (pairEnd - pairStart) + 2) <= (int)sizeof(paramIndex->paramBuffer))
+		{
+			paramPtr			=	&paramIndex->param[paramIndex->paramCnt];
+			paramPtr->keyOffset	=	bufIdx;
+			keyLen				=	PercentDecode(	&srcPtr[pairStart],
+													(equalIdx - pairStart),
+													&paramIndex->paramBuffer[bufIdx],
+													(sizeof(paramIndex->paramBuffer) - bufIdx));
+			bufIdx					+=	keyLen + 1;
+			paramPtr->valueOffset	=	bufIdx;
+			if (equalIdx < pairEnd)
+			{
+				bufIdx	+=	PercentDecode(	&srcPtr[equalIdx + 1],
+											(pairEnd - equalIdx - 1),
+											&paramIndex->paramBuffer[bufIdx],
+											(sizeof(paramIndex->paramBuffer) - bufIdx));
+			}
+			else
+			{
+				paramIndex->paramBuffer[bufIdx]	=	0;
+			}
+			bufIdx	+=	1;
+
+			if (keyLen > 0)
+			{
+				paramPtr->keyHash	=	CmdHash(&paramIndex->paramBuffer[paramPtr->keyOffset], 0);
+				//*	linear probing keeps duplicate keys in the order they were received
+				slotIdx				=	paramPtr->keyHash & (kParamHashSlots - 1);
+				while (paramIndex->hashSlot[slotIdx] >= 0)
+				{
+					slotIdx	=	(slotIdx + 1) & (kParamHashSlots - 1);
+				}
+				paramIndex->hashSlot[slotIdx]	=	paramIndex->paramCnt;
+				paramIndex->paramCnt++;
+			}
+			else
+			{
+				//*	nothing to index, give the buffer space back
+				bufIdx	=	paramPtr->keyOffset;
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG("Parameter buffer overflow");
+			break;
+		}
+		pairStart	=	pairEnd + 1;
+	}
+}
+
+//*****************************************************************************
+//*	returns the index into param[], -1 if not found
+//*	conformU wants us accept any case on GET and strict case on PUT
+//*****************************************************************************
+static int	ParamIndex_Find(TYPE_ParamIndex *paramIndex, const char *keyword, const bool ignoreCase)
+{
+uint32_t			keyHash;
+int					slotIdx;
+int					paramIdx;
+const char			*keyPtr;
+
+	keyHash	=	CmdHash(keyword, 0);
+	slotIdx	=	keyHash & (kParamHashSlots - 1);
+	while (paramIndex->hashSlot[slotIdx] >= 0)
+	{
+		paramIdx	=	paramIndex->hashSlot[slotIdx];
+		if (paramIndex->param[paramIdx].keyHash == keyHash)
+		{
+			keyPtr	=	&paramIndex->paramBuffer[paramIndex->param[paramIdx].keyOffset];
+			if ((strcmp(keyPtr, keyword) == 0) ||
+				(ignoreCase && (strcasecmp(keyPtr, keyword) == 0)))
+			{
+				return(paramIdx);
+			}
+		}
+		slotIdx	=	(slotIdx + 1) & (kParamHashSlots - 1);
+	}
+	return(-1);
+}
+
 //*****************************************************************************
 //*
 //*	PUT /api/v1/filterwheel/0/connected HTTP/1.1
@@ -3788,22 +4932,12 @@ int			returnCode;
 //*
 //*	ClientTransactionID=31&ClientID=18194&Connected=False
 //*****************************************************************************
-static void	ParseHTMLdataIntoReqStruct(const char *htmlData, TYPE_GetPutRequestData	*reqData)
-{
-char			*contentLenPtr;
-char			lineBuff[1024];
-char			firstLine[1024];
-unsigned int	iii;
-unsigned int	ccc;
-unsigned int	sLen;
-int				lineCnt;
-char			theChar;
-bool			isContent;
-bool			isFirstLine;
-char			*queMrkPtr;
-char			*userAgentPtr;
-//int				htmlDataLen;
-int				contentDataLen;
+static void	ParseHTMLdataIntoReqStruct(const char *htmlData, const int htmlDataLen, TYPE_GetPutRequestData	*reqData)
+{
+TYPE_TokenSpan	headerValue;
+TYPE_TokenSpan	*contentToken;
+int				ccc;
+char			contentLenStr[32];
 
 #ifdef _DEBUG_HTML_
 	CONSOLE_DEBUG(__FUNCTION__);
@@ -3811,7 +4945,10 @@ int				contentDataLen;
 
 	if ((htmlData != NULL) && (reqData != NULL))
 	{
-//		htmlDataLen	=	strlen(htmlData);
+		//*	we keep a pointer to the request, not a copy
+		reqData->htmlData		=	htmlData;
+		reqData->htmlDataLen	=	htmlDataLen;
+		TokenizeRequest(htmlData, htmlDataLen, &reqData->tokens);
 
 		if (strncasecmp(htmlData, "GET", 3) == 0)
 		{
@@ -3834,41 +4971,26 @@ int				contentDataLen;
 
 		//*	extract the HTTP command
 		ccc	=	0;
-		while ((htmlData[ccc] >= 0x20) && (ccc < (kHTTPbufLen - 2)))
+		while ((ccc < htmlDataLen) && (htmlData[ccc] >= 0x20) && (ccc < (kHTTPbufLen - 2)))
 		{
 			reqData->httpCmdString[ccc]	=	htmlData[ccc];
 			ccc++;
 		}
 		reqData->httpCmdString[ccc]	=	0;
 
-		sLen		=	strlen(htmlData);
 #ifdef _DEBUG_HTML_
-		CONSOLE_DEBUG_W_NUM("htmlData length\t=", sLen);
-		CONSOLE_DEBUG_W_SIZE("sizeof(lineBuff)\t=", sizeof(lineBuff));
+		CONSOLE_DEBUG_W_NUM("htmlData length\t=", htmlDataLen);
+		CONSOLE_DEBUG_W_NUM("headerCnt\t=", reqData->tokens.headerCnt);
 #endif
 
-		//*	keep a copy of the entire thing
-		strcpy(reqData->htmlData, htmlData);
-
 		//========================================================================
 		//*	check for user agent
 		reqData->cHTTPclientType	=   kHTTPclient_NotSpecified;
-		userAgentPtr	=	strcasestr((char *)htmlData, "User-Agent:");
-		if (userAgentPtr != NULL)
+		headerValue					=	FindRequestHeader(reqData, "User-Agent");
+		if (headerValue.length >= 0)
 		{
 			//*	extract the "User-Agent:"
-			userAgentPtr	+=	11;
-			while (*userAgentPtr == 0x20)	//*	skip spaces
-			{
-				userAgentPtr++;
-			}
-			ccc	=	0;
-			while ((userAgentPtr[ccc] >= 0x20) && (ccc < (kUserAgentLen - 2)))
-			{
-				reqData->httpUserAgent[ccc]	=	userAgentPtr[ccc];
-				ccc++;
-			}
-			reqData->httpUserAgent[ccc]	=	0;
+			CopyRequestToken(reqData, &headerValue, reqData->httpUserAgent, (kUserAgentLen - 1));
 			//*	special case because "ConformUniversal/2.1.0+23787.e8effdcb04975452b0e7e529b87bcb851920d57a"
 			//*	is too long for the log file
 			if (strncmp(reqData->httpUserAgent, "ConformU", 8) == 0)
@@ -3953,115 +5075,36 @@ int				contentDataLen;
 			CONSOLE_DEBUG_W_NUM("reqData->cHTTPclientType out of range", reqData->cHTTPclientType);
 		}
 
-		//*	go through the entire data and treat them as separate lines of text
-		lineCnt		=	0;
-		isContent	=	false;
-		ccc			=	0;
-		theChar		=	0;
-		iii			=	0;
-		isFirstLine	=	true;
-		while (iii <= sLen)
+		headerValue	=	FindRequestHeader(reqData, "Content-Length");
+		if (headerValue.length > 0)
 		{
-			theChar		=	htmlData[iii];
-			if ((theChar >= 0x20) || (theChar == 0x09))
-			{
-				if (ccc < (sizeof(lineBuff) - 1))
-				{
-					lineBuff[ccc++]	=	theChar;
-					lineBuff[ccc]	=	0;
-				}
-				else
-				{
-					CONSOLE_DEBUG_W_STR("Buffer overflow:", lineBuff);
-				}
-			}
-			else
-			{
-				lineCnt++;
-				lineBuff[ccc]	=	0;
-				ccc				=	0;
-//				CONSOLE_DEBUG_W_STR("lineBuff\t=", lineBuff);
-				if (isFirstLine)
-				{
-					strcpy(firstLine, lineBuff);
-					isFirstLine	=	false;
-				}
-				//*	now lets see if this is anything we care about
-				if (strlen(lineBuff) > 0)
-				{
-					if (isContent)
-					{
-						contentDataLen	=	strlen(reqData->contentData);
-						if (contentDataLen + strlen(lineBuff) < (kContentDataLen -2))
-						{
-							strcat(reqData->contentData, lineBuff);
-						//	strcat(reqData->contentData, "\r\n");
-						}
-						else
-						{
-							CONSOLE_DEBUG_W_STR("contentData overflow:", lineBuff);
-						}
-					}
-					else
-					{
-						if (strncasecmp(lineBuff, "Content-Length", 14) == 0)
-						{
-							contentLenPtr	=	lineBuff;
-							contentLenPtr	+=	15;
-							while (*contentLenPtr == 0x20)
-							{
-								contentLenPtr++;
-							}
-							reqData->contentLength	=	atoi(contentLenPtr);
-					#ifdef _DEBUG_CONFORM_
-							CONSOLE_DEBUG("Content-Length: was found");
-					#endif // _DEBUG_CONFORM_
-
-						}
-					}
-				}
-				else
-				{
-					isContent	=	true;
-				}
+			CopyRequestToken(reqData, &headerValue, contentLenStr, sizeof(contentLenStr));
+			reqData->contentLength	=	atoi(contentLenStr);
+	#ifdef _DEBUG_CONFORM_
+			CONSOLE_DEBUG("Content-Length: was found");
+	#endif // _DEBUG_CONFORM_
+		}
 
-				//*	check the next char, make sure we dont process CR and LF
-				if ((theChar == 0x0d) && (htmlData[iii+1] == 0x0a))
-				{
-					//*	skip the line feed
-					iii++;
-				}
-				else if ((theChar == 0x0a) && (htmlData[iii+1] == 0x0d))
-				{
-					//*	skip the cr
-					iii++;
-				}
-			}
-			iii++;
+		//*	the get data is in a different location
+		if ((reqData->get_putIndicator == 'G') && (reqData->tokens.query.length > 0))
+		{
+			contentToken	=	&reqData->tokens.query;
 		}
-		if ((isContent) && (ccc > 0))
+		else
 		{
-			lineBuff[ccc]	=	0;
-			contentDataLen	=	strlen(reqData->contentData);
-			if (contentDataLen + strlen(lineBuff) < (kContentDataLen - 2))
-			{
-				strcat(reqData->contentData, lineBuff);
-			}
-			else
-			{
-				CONSOLE_DEBUG_W_STR("contentData overflow:", lineBuff);
-			}
+			contentToken	=	&reqData->tokens.body;
 		}
-		if (reqData->get_putIndicator == 'G')
+		//*	copy the content, dropping the line breaks
+		ccc	=	PercentDecode(	&htmlData[contentToken->offset],
+								contentToken->length,
+								reqData->contentData,
+								(kContentDataLen - 1));
+		if (ccc >= (kContentDataLen - 2))
 		{
-			//*	the get data is in a different location
-			queMrkPtr	=	strchr(firstLine, '?');
-			if (queMrkPtr != NULL)
-			{
-				queMrkPtr++;
-				strcpy(reqData->contentData, queMrkPtr);
-			}
+			CONSOLE_DEBUG("contentData overflow");
 		}
+		//*	the parameters are split before they are decoded
+		ParamIndex_Build(&reqData->params, &htmlData[contentToken->offset], contentToken->length);
 	#ifdef _DEBUG_CONFORM_
 		CONSOLE_DEBUG_W_STR("contentData\t=", reqData->contentData);
 	#endif // _DEBUG_CONFORM_
@@ -4170,128 +5213,77 @@ int					commandLen;
 //*****************************************************************************
 //*	Parse the full Alpaca request, trying to cover all variants
 //*	returns ENUM of request type
+//*	the path segments were already found by TokenizeRequest()
 //*****************************************************************************
 static int	ParseAlpacaRequest(TYPE_GetPutRequestData *reqData)
 {
 TYPE_REQUEST_TYPE	requestType;
-int					iii;
 int					ccc;
-int					cmdStartIdx;
+int					segmentCnt;
 bool				foundKeyWord;
-int					slashCounter;
-char				sLen;
-char				theChar;
 char				argumentString[256]			=	"";
 char				myRequestTypeString[64]		=	"";
 char				myAlpacaVersionString[64]	=	"";
 char				myDeviceString[64]			=	"";
 char				myDeviceNumString[64]		=	"";
 char				myDeviceCmdString[256]		=	"";
-int					cmdBuffLen;
 char				*delimPtr;
 
-//	CONSOLE_DEBUG("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
 //	CONSOLE_DEBUG(__FUNCTION__);
-//	DumpRequestStructure(__FUNCTION__, reqData);
 //	PUT /api/v1/camera/0/exposuretime HTTP/1.1
+//	        0   1  2      3 4
 
 	//*	copy the full command over
-	ccc		=	0;
-	sLen	=	strlen(reqData->httpCmdString);
-	cmdStartIdx	=	0;
-	while ((cmdStartIdx < sLen) && (reqData->httpCmdString[cmdStartIdx] > 0x20))
+	CopyRequestToken(reqData, &reqData->tokens.target, reqData->cmdBuffer, kMaxCommandLen);
+
+	segmentCnt	=	reqData->tokens.segmentCnt;
+	if (segmentCnt > 0)
 	{
-		cmdStartIdx++;
+		//*	the request type, i.e. api, or setup (see list above)
+		CopyRequestToken(reqData, &reqData->tokens.segment[0], myRequestTypeString, sizeof(myRequestTypeString));
 	}
-	while ((cmdStartIdx < sLen) && (reqData->httpCmdString[cmdStartIdx] <= 0x20))
+	if (segmentCnt > 1)
 	{
-		cmdStartIdx++;
+		CopyRequestToken(reqData, &reqData->tokens.segment[1], myAlpacaVersionString, sizeof(myAlpacaVersionString));
 	}
-	iii		=	cmdStartIdx;
-	while ((reqData->httpCmdString[iii] > 0x20) && (iii< sLen) && (ccc < (kMaxCommandLen - 1)))
+	if (segmentCnt > 2)
 	{
-		reqData->cmdBuffer[ccc++]	=	reqData->httpCmdString[iii++];
+		CopyRequestToken(reqData, &reqData->tokens.segment[2], myDeviceString, sizeof(myDeviceString));
 	}
-	reqData->cmdBuffer[ccc]	=	0;
-
-
-	slashCounter		=	0;
-	ccc					=	0;
-	iii					=	cmdStartIdx;	//*	start after "GET/PUT/POST " so that we can ignore the first space
-	argumentString[0]	=	0;
-	theChar				=	0;
-	while ((slashCounter < 6) && (iii < sLen) && (theChar != 0x20))
+	if (segmentCnt > 3)
 	{
-		theChar	=	reqData->httpCmdString[iii++];
-		if ((theChar == '/') || (theChar == 0x20))
-		{
-			argumentString[ccc]		=	0;
-			switch(slashCounter)
-			{
-				case 1:
-					//*	the request type, i.e. api, or setup (see list above)
-					strcpy(myRequestTypeString, argumentString);
-					break;
-				case 2:
-					strcpy(myAlpacaVersionString, argumentString);
-					break;
-				case 3:
-					strcpy(myDeviceString, argumentString);
-					break;
-				case 4:
-					strcpy(myDeviceNumString, argumentString);
-					break;
-				case 5:
-					strcpy(myDeviceCmdString, argumentString);
-					break;
-			}
-			ccc					=	0;
-			argumentString[0]	=	0;
-			slashCounter++;
-		}
-		else
-		{
-			argumentString[ccc++]	=	theChar;
-			argumentString[ccc]		=	0;
-		}
+		CopyRequestToken(reqData, &reqData->tokens.segment[3], myDeviceNumString, sizeof(myDeviceNumString));
+	}
+	if (segmentCnt > 4)
+	{
+		CopyRequestToken(reqData, &reqData->tokens.segment[4], myDeviceCmdString, sizeof(myDeviceCmdString));
 	}
 
-	//CONSOLE_DEBUG_W_NUM("slashCounter\t=",	slashCounter);
 	//---------------------------------------------------
-	if (slashCounter >= 3)
+	if (segmentCnt >= 2)
 	{
-		//CONSOLE_DEBUG_W_STR("myAlpacaVersionString\t=",	myAlpacaVersionString);
-
 		if (myAlpacaVersionString[0] == 'v')
 		{
 			reqData->alpacaVersion		=	myAlpacaVersionString[1] & 0x0f;
 		}
-		//CONSOLE_DEBUG_W_NUM("reqData->alpacaVersion\t=",	reqData->alpacaVersion);
 		strcpy(reqData->deviceType,		myDeviceString);
 	}
 
-	if (slashCounter >= 4)
+	if (segmentCnt >= 3)
 	{
-//		CONSOLE_DEBUG("Extracting command string");
 		//*	extract out the command itself for easier processing by the handlers
-		cmdBuffLen		=	strlen(myDeviceCmdString);
 		ccc				=	0;
 		while (	(myDeviceCmdString[ccc] > 0x20) &&
 				(myDeviceCmdString[ccc] != '&') &&
-				(myDeviceCmdString[ccc] != '?') &&
-				(ccc < cmdBuffLen ))
+				(myDeviceCmdString[ccc] != '?'))
 		{
 			reqData->deviceCommand[ccc]	=	myDeviceCmdString[ccc];
 			ccc++;
 		}
 		reqData->deviceCommand[ccc]	=	0;
-//		CONSOLE_DEBUG_W_NUM("cmdBuffLen            \t=",	cmdBuffLen);
-//		CONSOLE_DEBUG_W_STR("myDeviceCmdString     \t=",	myDeviceCmdString);
-//		CONSOLE_DEBUG_W_STR("reqData->deviceCommand\t=",	reqData->deviceCommand);
-
 	}
 
-	if (slashCounter > 5)
+	if (segmentCnt >= 5)
 	{
 		//*	check for valid device number,  CONFORMU throws -1 and "A"
 		if (isdigit(myDeviceNumString[0]))
@@ -4306,23 +5298,7 @@ char				*delimPtr;
 			reqData->deviceNumber	=	-1;
 		}
 	}
-//	else if ((slashCounter >= 3) && (strncasecmp(myDeviceCmdString, "/management", 11) == 0))
-	else if (slashCounter >= 3)
-	{
-		//	/management/v1/configureddevices
-//		CONSOLE_DEBUG("=====================================================");
-//		CONSOLE_DEBUG_W_NUM("Slash count >= 3", slashCounter);
-//		CONSOLE_DEBUG_W_STR("reqData->deviceCommand\t=",	reqData->deviceCommand);
-//		CONSOLE_DEBUG_W_STR("myDeviceCmdString     \t=",	myDeviceCmdString);
-//		CONSOLE_DEBUG_W_NUM("slashCounter          \t=",	slashCounter);
-//		CONSOLE_DEBUG_W_STR("myRequestTypeString   \t=",	myRequestTypeString);
-//		CONSOLE_DEBUG_W_STR("myAlpacaVersionString \t=",	myAlpacaVersionString);
-//		CONSOLE_DEBUG_W_STR("myDeviceString        \t=",	myDeviceString);
-//		CONSOLE_DEBUG_W_STR("myDeviceNumString     \t=",	myDeviceNumString);
-//		CONSOLE_DEBUG_W_STR("myDeviceCmdString     \t=",	myDeviceCmdString);
-//		CONSOLE_DEBUG_W_STR("reqData->deviceCommand\t=",	reqData->deviceCommand);
-	}
-	else
+	else if (segmentCnt < 2)
 	{
 		strcpy(reqData->deviceType,		"unknown");
 		reqData->deviceCommand[0]	=	0;
@@ -4338,7 +5314,7 @@ char				*delimPtr;
 	if (requestType == kRequestType_Managment)
 	{
 #ifdef _DEBUG_MANAGEMENT_
-		CONSOLE_DEBUG_W_NUM("slashCounter          \t=",	slashCounter);
+		CONSOLE_DEBUG_W_NUM("segmentCnt            \t=",	segmentCnt);
 		CONSOLE_DEBUG_W_STR("myRequestTypeString   \t=",	myRequestTypeString);
 		CONSOLE_DEBUG_W_STR("myAlpacaVersionString \t=",	myAlpacaVersionString);
 		CONSOLE_DEBUG_W_STR("myDeviceString        \t=",	myDeviceString);
@@ -4359,11 +5335,7 @@ char				*delimPtr;
 		//*	https://github.com/msproul/AlpacaPi/issues
 		//*	issue #29
 		//*	look for delimiter characters
-		delimPtr	=	strchr(reqData->deviceCommand, '?');
-		if (delimPtr != NULL)
-		{
-			*delimPtr	=	0;
-		}
+		//*	the '?' is already excluded by TokenizeRequest()
 		delimPtr	=	strchr(reqData->deviceCommand, '&');
 		if (delimPtr != NULL)
 		{
@@ -4374,22 +5346,6 @@ char				*delimPtr;
 		{
 			*delimPtr	=	0;
 		}
-//		CONSOLE_DEBUG_W_STR("reqData->deviceCommand\t=",	reqData->deviceCommand);
-//		DumpRequestStructure(__FUNCTION__, reqData);
-	}
-
-	//------------------------------------------------------------------
-	//*	check contentData for "HTTP...." at the end
-	sLen	=	strlen(reqData->contentData);
-	iii		=	sLen -1;
-	while ((iii > 1) && (reqData->contentData[iii] != 0x20))
-	{
-		iii--;
-	}
-	iii++;
-	if (strncmp(&reqData->contentData[iii], "HTTP", 4) == 0)
-	{
-		reqData->contentData[iii-1]	=	0;
 	}
 
 	//------------------------------------------------------------------
@@ -4438,11 +5394,73 @@ char				*delimPtr;
 }
 
 //*****************************************************************************
+//*****************************************************************************
+//*	/stats/json
+//*****************************************************************************
+static bool	IsStatsJsonRequest(TYPE_GetPutRequestData *reqData)
+{
+char	formatString[16];
+
+	formatString[0]	=	0;
+	if (reqData->tokens.segmentCnt > 1)
+	{
+		CopyRequestToken(reqData, &reqData->tokens.segment[1], formatString, sizeof(formatString));
+	}
+	return(strcasecmp(formatString, "json") == 0);
+}
+
+//*****************************************************************************
+//*	each worker thread gets its own request structure, allocated once
+//*	it is too big to put on the stack and zeroing all of it for every request
+//*	is a waste, only the parts the parser relies on are cleared
+//*****************************************************************************
+static __thread TYPE_GetPutRequestData	*gWorkerReqData	=	NULL;
+
+//*****************************************************************************
+static TYPE_GetPutRequestData	*GetWorkerRequestData(void)
+{
+TYPE_GetPutRequestData	*reqData;
+
+	if (gWorkerReqData == NULL)
+	{
+		gWorkerReqData	=	(TYPE_GetPutRequestData *)calloc(1, sizeof(TYPE_GetPutRequestData));
+		if (gWorkerReqData != NULL)
+		{
+			ParamIndex_Reset(&gWorkerReqData->params);
+		}
+		return(gWorkerReqData);
+	}
+	reqData							=	gWorkerReqData;
+	reqData->contentLength			=	0;
+	reqData->htmlData				=	NULL;
+	reqData->htmlDataLen			=	0;
+	reqData->cHTTPclientType		=	kHTTPclient_NotSpecified;
+	reqData->clientIs_AlpacaPi		=	false;
+	reqData->clientIs_ConformU		=	false;
+	reqData->clientIs_Conform		=	false;
+	reqData->alpacaVersion			=	0;
+	reqData->alpacaErrCode			=	kASCOM_Err_Success;
+	reqData->ClientTransactionID	=	0;
+	reqData->httpCmdString[0]		=	0;
+	reqData->httpUserAgent[0]		=	0;
+	reqData->deviceType[0]			=	0;
+	reqData->cmdBuffer[0]			=	0;
+	reqData->deviceCommand[0]		=	0;
+	reqData->contentData[0]			=	0;
+	ParamIndex_Reset(&reqData->params);
+	reqData->alpacaErrMsg[0]		=	0;
+	reqData->ClientTransactionIDstr[0]	=	0;
+	memset(&reqData->timing, 0, sizeof(TYPE_RequestTiming));
+	reqData->jsonHdrBuffer[0]		=	0;
+	reqData->jsonTextBuffer[0]		=	0;
+	return(reqData);
+}
+
 static int	ProcessGetPutRequest(const int socket, char *htmlData, long byteCount, const char *ipAddressString)
 {
 TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_InternalError;
 char					*parseChrPtr;
-TYPE_GetPutRequestData	reqData;
+TYPE_GetPutRequestData	*reqData;
 int						requestType;
 
 #ifdef _DEBUG_CONFORM_
@@ -4457,6 +5475,7 @@ int						requestType;
 int	previousUnitsSinceTopOfHour;
 int	iii;
 
+	pthread_mutex_lock(&gRequestMutex);
 	previousUnitsSinceTopOfHour	=	gTimeUnitsSinceTopOfHour;
 	gTimeUnitsSinceTopOfHour	=	(time(NULL) / 60) % kMaxBandWidthSamples;
 //	CONSOLE_DEBUG_W_NUM("gTimeUnitsSinceTopOfHour\t=", gTimeUnitsSinceTopOfHour);
@@ -4474,22 +5493,33 @@ int	iii;
 			}
 		}
 	}
+	pthread_mutex_unlock(&gRequestMutex);
 #endif // _ENABLE_BANDWIDTH_LOGGING_
 
-	memset(&reqData, 0, sizeof(TYPE_GetPutRequestData));
+	reqData	=	GetWorkerRequestData();
+	if (reqData == NULL)
+	{
+		CONSOLE_DEBUG("Failed to allocate request data");
+		SocketWriteData(socket,	gBadResponse400);
+		return(kASCOM_Err_InternalError);
+	}
 	//*	the TYPE_GetPutRequestData simplifies parsing and passing of the
 	//*	parsed data to subroutines
-	reqData.socket				=	socket;
-	reqData.httpRetCode			=	200;
-	reqData.get_putIndicator	=	htmlData[0];
-	reqData.requestTypeEnum		=	-1;
-	reqData.deviceNumber		=	-1;
-	strcpy(reqData.clientIPaddr, ipAddressString);
-
-	ParseHTMLdataIntoReqStruct(htmlData, &reqData);
-
-	requestType	=	ParseAlpacaRequest(&reqData);
-	LogRequest(&reqData);
+	reqData->timing.startTime_nS	=	GetMonotonicNanoSecs();
+	reqData->socket				=	socket;
+	reqData->httpRetCode		=	200;
+	reqData->get_putIndicator	=	htmlData[0];
+	reqData->requestTypeEnum	=	-1;
+	reqData->deviceNumber		=	-1;
+	strcpy(reqData->clientIPaddr, ipAddressString);
+
+	ParseHTMLdataIntoReqStruct(htmlData, byteCount, reqData);
+
+	requestType	=	ParseAlpacaRequest(reqData);
+	reqData->timing.phase_uS[kReqPhase_Parse]	=	(GetMonotonicNanoSecs() - reqData->timing.startTime_nS) / 1000;
+	pthread_mutex_lock(&gRequestMutex);
+	LogRequest(reqData);
+	pthread_mutex_unlock(&gRequestMutex);
 
 	parseChrPtr			=	htmlData;
 	parseChrPtr			+=	3;
@@ -4500,7 +5530,7 @@ int	iii;
 
 //	if (requestType != kRequestType_API)
 //	{
-//		DumpRequestStructure(__FUNCTION__, &reqData);
+//		DumpRequestStructure(__FUNCTION__, reqData);
 //	}
 
 #ifdef _DEBUG_MANAGEMENT_
@@ -4512,26 +5542,26 @@ int	iii;
 		//*	standard ALPACA api call
 		case kRequestType_API:
 			//*	Mar  3,	2023	<MLS> Make CONFORMU happy, check for valid device number
-			if (reqData.deviceNumber >= 0)
+			if (reqData->deviceNumber >= 0)
 			{
-				alpacaErrCode	=	ProcessAlpacaAPIrequest(&reqData, byteCount);
+				alpacaErrCode	=	ProcessAlpacaAPIrequest(reqData, byteCount);
 			}
 			else
 			{
-				CONSOLE_DEBUG_W_NUM("Invalid device number\t=",	reqData.deviceNumber);
-				DumpRequestStructure(__FUNCTION__, &reqData);
+				CONSOLE_DEBUG_W_NUM("Invalid device number\t=",	reqData->deviceNumber);
+				DumpRequestStructure(__FUNCTION__, reqData);
 				SocketWriteData(socket,	gBadResponse400);
 			}
 			break;
 
 		//*	statistics on class structure size
 		case kRequestType_ClassDocs:
-			OutputHTML_ClassDocs(&reqData);
+			OutputHTML_ClassDocs(reqData);
 			break;
 
 		//*	extra self documentation
 		case kRequestType_DriverDocs:
-			OutputHTML_DriverDocs(&reqData);
+			OutputHTML_DriverDocs(reqData);
 			break;
 
 		//*	extra - logging data
@@ -4542,40 +5572,47 @@ int	iii;
 		//*	standard ALPACA management
 		case kRequestType_Managment:
 //			CONSOLE_DEBUG(__FUNCTION__);
-			alpacaErrCode	=	ProcessManagementRequest(&reqData, byteCount);
+			alpacaErrCode	=	ProcessManagementRequest(reqData, byteCount);
 			break;
 
 		//*	standard ALPACA setup
 		case kRequestType_Setup:
-			alpacaErrCode	=	ProcessAlpacaSETUPrequest(&reqData, byteCount);
+			alpacaErrCode	=	ProcessAlpacaSETUPrequest(reqData, byteCount);
 			break;
 
 		//*	extra - stats
 		case kRequestType_Stats:
-			SendHtml_Stats(&reqData);
+			if (IsStatsJsonRequest(reqData))
+			{
+				SendJson_Stats(reqData);
+			}
+			else
+			{
+				SendHtml_Stats(reqData);
+			}
 			break;
 
 		case kRequestType_Web:
-			SendHtml_MainPage(&reqData);
+			SendHtml_MainPage(reqData);
 			break;
 
 		case kRequestType_GPS:
-			SendHtml_GPS(&reqData);
+			SendHtml_GPS(reqData);
 			break;
 
 		case kRequestType_TopLevel:
-			SendHtml_TopLevel(&reqData);
+			SendHtml_TopLevel(reqData);
 			break;
 
 		//*	this outputs a real HTML file from folder html
 		case kRequestType_HTML:
 		case kRequestType_Docs:
-			OutputHTML_html(&reqData);
+			OutputHTML_html(reqData);
 			break;
 
 		//*	this is for testing, will be deleted later
 		case kRequestType_Form:
-			OutputHTML_Form(&reqData);
+			OutputHTML_Form(reqData);
 			break;
 
 
@@ -4615,7 +5652,7 @@ int	iii;
 				{
 					CONSOLE_DEBUG_W_STR("Unknown http request\t=",	htmlData);
 					CONSOLE_DEBUG_W_STR("parseChrPtr\t=", parseChrPtr);
-					DumpRequestStructure(__FUNCTION__, &reqData);
+					DumpRequestStructure(__FUNCTION__, reqData);
 					SocketWriteData(socket,	gBadResponse400);
 				}
 			}
@@ -4674,12 +5711,16 @@ CONSOLE_DEBUG_W_STR("\r\n", htmlData);
 	{
 //		CONSOLE_DEBUG("Calling ProcessGetPutRequest");
 		returnCode	=	ProcessGetPutRequest(socket, htmlData, byteCount, ipAddressString);
+		pthread_mutex_lock(&gRequestMutex);
 		gServerTransactionID++;	//*	we are the "server"
+		pthread_mutex_unlock(&gRequestMutex);
 	}
 	else if (strncmp(htmlData, "OPTIONS", 7) == 0)
 	{
 		ProcessOptionsCommand(socket);
+		pthread_mutex_lock(&gRequestMutex);
 		gServerTransactionID++;	//*	we are the "server"
+		pthread_mutex_unlock(&gRequestMutex);
 	}
 	else if (byteCount > 0)
 	{
@@ -4701,6 +5742,7 @@ static void	*ListenThread(void *arg)
 //	CONSOLE_DEBUG(__FUNCTION__);
 
 	SocketListen_SetCallback(&AlpacaCallback);
+	SocketListen_SetWorkerCount(gListenWorkerThreadCnt);
 
 	SocketListen_Init(gAlpacaListenPort);
 
@@ -4730,12 +5772,17 @@ static void	PrintHelp(const char *appName)
 	printf("\t%-20s\t%s\r\n",	"-g...",			"GPS support not enabled in this build");
 #endif
 	printf("\t%-20s\t%s\r\n",	"-h",				"This help message");
+	printf("\t%-20s\t%s\r\n",	"-i <count>",		"Number of image save threads (default 1)");
 	printf("\t%-20s\t%s\r\n",	"-l",				"Live mode");
+#ifdef _ENABLE_CAMERA_
+	printf("\t%-20s\t%s\r\n",	"-m <options>",		"Image buffer pool, huge,lock,cache=<MB> (default none)");
+#endif
 	printf("\t%-20s\t%s\r\n",	"-p <port>",		"what port to use (default 6800)");
 	printf("\t%-20s\t%s\r\n",	"-q",				"quiet (less console messages)");
 	printf("\t%-20s\t%s\r\n",	"-s",				"Simulate camera image");
 	printf("\t%-20s\t%s\r\n",	"-t <profile>",		"Which telescope profile to use");
 	printf("\t%-20s\t%s\r\n",	"-v",				"verbose (more console messages default)");
+	printf("\t%-20s\t%s\r\n",	"-w <count>",		"Number of http worker threads (default 4)");
 }
 
 #ifdef _ENABLE_GLOBAL_GPS_
@@ -4758,6 +5805,35 @@ char	*slashPtr;
 }
 #endif // _ENABLE_GLOBAL_GPS_
 
+#ifdef _ENABLE_CAMERA_
+//*****************************************************************************
+//*	-m huge,lock,cache=512
+//*		huge		try huge pages for the image buffers
+//*		lock		mlock() the image buffers so they never get paged out
+//*		cache=<MB>	how much free image memory is kept for reuse
+//*****************************************************************************
+static void	ProcessImagePoolCmdArgs(const char *poolOptions)
+{
+bool	useHugePages;
+bool	lockMemory;
+size_t	maxCachedBytes;
+char	*cachePtr;
+
+	useHugePages	=	(strstr(poolOptions, "huge") != NULL);
+	lockMemory		=	(strstr(poolOptions, "lock") != NULL);
+	maxCachedBytes	=	kImagePool_DefaultMaxCached;
+	cachePtr		=	strstr((char *)poolOptions, "cache=");
+	if (cachePtr != NULL)
+	{
+		maxCachedBytes	=	atol(cachePtr + 6) * 1024L * 1024L;
+	}
+	CONSOLE_DEBUG_W_BOOL("Image pool huge pages\t=",	useHugePages);
+	CONSOLE_DEBUG_W_BOOL("Image pool mlock\t\t=",		lockMemory);
+	CONSOLE_DEBUG_W_LONG("Image pool cache MB\t=",		(long)(maxCachedBytes / (1024 * 1024)));
+	ImagePool_SetOptions(useHugePages, lockMemory, maxCachedBytes);
+}
+#endif // _ENABLE_CAMERA_
+
 //*****************************************************************************
 static void	ProcessCmdLineArgs(int argc, char **argv)
 {
@@ -4807,6 +5883,25 @@ int		newListenPort;
 					exit(0);	//*	help message
 					break;
 
+				//	"-i" number of image save threads
+				//*	either -i2 or -i 2
+				case 'i':
+					if (isdigit(argv[iii][2]))
+					{
+						gImageSaveThreadCnt	=	atoi(&argv[iii][2]);
+					}
+					else if (iii < (argc -1))
+					{
+						iii++;
+						gImageSaveThreadCnt	=	atoi(argv[iii]);
+					}
+					if (gImageSaveThreadCnt < 1)
+					{
+						CONSOLE_DEBUG("Invalid image save thread count, using 1");
+						gImageSaveThreadCnt	=	1;
+					}
+					break;
+
 				//	"-l" means live view
 				case 'l':
 				#ifdef _USE_OPENCV_
@@ -4816,6 +5911,22 @@ int		newListenPort;
 				#endif
 					break;
 
+			#ifdef _ENABLE_CAMERA_
+				//	"-m" image buffer pool options
+				//*	either -mhuge,lock or -m huge,lock
+				case 'm':
+					if (argv[iii][2] != 0)
+					{
+						ProcessImagePoolCmdArgs(&argv[iii][2]);
+					}
+					else if (iii < (argc -1))
+					{
+						iii++;
+						ProcessImagePoolCmdArgs(argv[iii]);
+					}
+					break;
+			#endif // _ENABLE_CAMERA_
+
 				//	-p specifies a port
 				case 'p':
 //					CONSOLE_DEBUG_W_STR("argv[iii]\t=", argv[iii])
@@ -4876,6 +5987,25 @@ int		newListenPort;
 				case 'v':
 					gVerbose	=	true;
 					break;
+
+				//	"-w" number of http worker threads
+				//*	either -w8 or -w 8
+				case 'w':
+					if (isdigit(argv[iii][2]))
+					{
+						gListenWorkerThreadCnt	=	atoi(&argv[iii][2]);
+					}
+					else if (iii < (argc -1))
+					{
+						iii++;
+						gListenWorkerThreadCnt	=	atoi(argv[iii]);
+					}
+					if ((gListenWorkerThreadCnt < 1) || (gListenWorkerThreadCnt > kSocketListen_MaxWorkers))
+					{
+						CONSOLE_DEBUG_W_NUM("Invalid worker thread count, using default", kSocketListen_DefaultWorkers);
+						gListenWorkerThreadCnt	=	kSocketListen_DefaultWorkers;
+					}
+					break;
 			}
 		}
 	}
@@ -5318,6 +6448,7 @@ int	imu_ReturnCode;
 	//--------------------------------------------------------
 	//*	create the various driver objects
 	CreateDriverObjects();
+	BuildCommandHashTables();
 //	DEBUG_TIMING("Timing step 3:");
 
 	//*********************************************************
@@ -5510,14 +6641,253 @@ uint32_t	milliSecs;
 	return(milliSecs);
 }
 
+//*****************************************************************************
+//*	Perfect hash index for the command tables
+//*	Each index covers one device command table plus gCommonCmdTable.
+//*	The seed is searched for at startup so that no two commands share a slot,
+//*	a lookup is one hash, one slot and one strcasecmp().
+//*	The indexes are built before the listen thread starts and are read only after that
+//*****************************************************************************
+#define	kCmdHashMaxTables	24
+#define	kCmdHashMaxSlots	2048
+#define	kCmdHashMaxSeeds	10000
+
+typedef struct
+{
+	const TYPE_CmdEntry	*cmdTable;
+	uint32_t			seed;
+	uint32_t			slotMask;
+	const TYPE_CmdEntry	**slot;
+} TYPE_CmdHashTable;
+
+static TYPE_CmdHashTable	gCmdHashTables[kCmdHashMaxTables];
+static int					gCmdHashTableCnt	=	0;
+
+//*	finds the index from the command table pointer, open addressing, less than half full
+#define	kCmdTableMapSlots	64
+static TYPE_CmdHashTable	*gCmdTableMap[kCmdTableMapSlots];
+
+//*****************************************************************************
+static inline uint32_t	CmdTableMapSlot(const TYPE_CmdEntry *theCmdTable)
+{
+	return(((uint32_t)((uintptr_t)theCmdTable >> 4) * 0x9e3779b9u) >> 26);
+}
+
+//*****************************************************************************
+//*	returns NULL if this table does not have an index
+//*****************************************************************************
+static inline TYPE_CmdHashTable	*FindCmdHashTable(const TYPE_CmdEntry *theCmdTable)
+{
+uint32_t			mapIdx;
+TYPE_CmdHashTable	*hashTable;
+
+	mapIdx		=	CmdTableMapSlot(theCmdTable);
+	hashTable	=	gCmdTableMap[mapIdx];
+	while ((hashTable != NULL) && (hashTable->cmdTable != theCmdTable))
+	{
+		mapIdx		=	(mapIdx + 1) & (kCmdTableMapSlots - 1);
+		hashTable	=	gCmdTableMap[mapIdx];
+	}
+	return(hashTable);
+}
+
+//*****************************************************************************
+//*	case insensitive FNV-1a with a final mix
+//*****************************************************************************
+static inline uint32_t	CmdHash(const char *theCmd, const uint32_t seed)
+{
+uint32_t	hashValue;
+uint32_t	theChar;
+
+	hashValue	=	2166136261u ^ (seed * 0x9e3779b9u);
+	while (*theCmd != 0)
+	{
+		theChar	=	(unsigned char)*theCmd;
+		if ((theChar >= 'A') && (theChar <= 'Z'))
+		{
+			theChar	+=	0x20;
+		}
+		hashValue	^=	theChar;
+		hashValue	*=	16777619u;
+		theCmd++;
+	}
+	hashValue	^=	hashValue >> 15;
+	hashValue	*=	0x2c1b3c6du;
+	hashValue	^=	hashValue >> 12;
+	return(hashValue);
+}
+
+//*****************************************************************************
+//*	adds the entries of theCmdTable that are not already in entryList
+//*	the first entry wins, same as the linear search did
+//*****************************************************************************
+static int	CollectCmdEntries(const TYPE_CmdEntry *theCmdTable, const TYPE_CmdEntry **entryList, int entryCnt, const int maxEntries)
+{
+int		iii;
+int		jjj;
+bool	isDuplicate;
+
+	iii	=	0;
+	while (theCmdTable[iii].commandName[0] != 0)
+	{
+		if (theCmdTable[iii].enumValue >= 0)
+		{
+			isDuplicate	=	false;
+			for (jjj=0; jjj<entryCnt; jjj++)
+			{
+				if (strcasecmp(theCmdTable[iii].commandName, entryList[jjj]->commandName) == 0)
+				{
+					isDuplicate	=	true;
+					break;
+				}
+			}
+			if ((isDuplicate == false) && (entryCnt < maxEntries))
+			{
+				entryList[entryCnt++]	=	&theCmdTable[iii];
+			}
+		}
+		iii++;
+	}
+	return(entryCnt);
+}
+
+//*****************************************************************************
+//*	returns true if the index was built
+//*****************************************************************************
+static bool	BuildCmdHashTable(const TYPE_CmdEntry *theCmdTable)
+{
+TYPE_CmdHashTable	*hashTable;
+const TYPE_CmdEntry	*entryList[kCmdHashMaxSlots / 2];
+int					entryCnt;
+uint32_t			slotCnt;
+uint32_t			seed;
+uint32_t			slotIdx;
+int					iii;
+bool				collision;
+
+	if (gCmdHashTableCnt >= kCmdHashMaxTables)
+	{
+		CONSOLE_DEBUG("Too many command tables");
+		return(false);
+	}
+	//*	check to see if we already have this one
+	if (FindCmdHashTable(theCmdTable) != NULL)
+	{
+		return(true);
+	}
+
+	entryCnt	=	CollectCmdEntries(theCmdTable,		entryList, 0,			(kCmdHashMaxSlots / 2));
+	entryCnt	=	CollectCmdEntries(gCommonCmdTable,	entryList, entryCnt,	(kCmdHashMaxSlots / 2));
+
+	//*	start with a load factor of 1/2 or less
+	slotCnt	=	16;
+	while (slotCnt < (uint32_t)(2 * entryCnt))
+	{
+		slotCnt	=	slotCnt * 2;
+	}
+
+	hashTable			=	&gCmdHashTables[gCmdHashTableCnt];
+	hashTable->slot		=	NULL;
+	while ((hashTable->slot == NULL) && (slotCnt <= kCmdHashMaxSlots))
+	{
+		hashTable->slot	=	(const TYPE_CmdEntry **)calloc(slotCnt, sizeof(TYPE_CmdEntry *));
+		if (hashTable->slot == NULL)
+		{
+			CONSOLE_DEBUG("Failed to allocate command hash table");
+			return(false);
+		}
+		for (seed=1; seed<kCmdHashMaxSeeds; seed++)
+		{
+			memset(hashTable->slot, 0, (slotCnt * sizeof(TYPE_CmdEntry *)));
+			collision	=	false;
+			for (iii=0; iii<entryCnt; iii++)
+			{
+				slotIdx	=	CmdHash(entryList[iii]->commandName, seed) & (slotCnt - 1);
+				if (hashTable->slot[slotIdx] != NULL)
+				{
+					collision	=	true;
+					break;
+				}
+				hashTable->slot[slotIdx]	=	entryList[iii];
+			}
+			if (collision == false)
+			{
+				break;
+			}
+		}
+		if (collision)
+		{
+			//*	no luck with this size, try a bigger one
+			free(hashTable->slot);
+			hashTable->slot	=	NULL;
+			slotCnt			=	slotCnt * 2;
+		}
+	}
+
+	if (hashTable->slot == NULL)
+	{
+		CONSOLE_DEBUG("Failed to find a perfect hash, using linear search");
+		return(false);
+	}
+	hashTable->cmdTable	=	theCmdTable;
+	hashTable->seed		=	seed;
+	hashTable->slotMask	=	slotCnt - 1;
+	gCmdHashTableCnt++;
+
+	slotIdx	=	CmdTableMapSlot(theCmdTable);
+	while (gCmdTableMap[slotIdx] != NULL)
+	{
+		slotIdx	=	(slotIdx + 1) & (kCmdTableMapSlots - 1);
+	}
+	gCmdTableMap[slotIdx]	=	hashTable;
+	return(true);
+}
+
+//*****************************************************************************
+//*	build the command hash tables for all of the devices that have been created
+//*	must be called before the listen thread is started
+//*****************************************************************************
+void	BuildCommandHashTables(void)
+{
+int		iii;
+
+	for (iii=0; iii<gDeviceCnt; iii++)
+	{
+		if ((gAlpacaDeviceList[iii] != NULL) && (gAlpacaDeviceList[iii]->cDriverCmdTablePtr != NULL))
+		{
+			BuildCmdHashTable(gAlpacaDeviceList[iii]->cDriverCmdTablePtr);
+		}
+	}
+	CONSOLE_DEBUG_W_NUM("Command hash tables\t=", gCmdHashTableCnt);
+}
+
 //*****************************************************************************
 //*	returns -1 if not found
 //*****************************************************************************
 int	FindCmdFromTable(const char *theCmd, const TYPE_CmdEntry *theCmdTable, int *cmdType)
 {
-int		iii;
-int		cmdEnumValue;
+int					iii;
+int					cmdEnumValue;
+TYPE_CmdHashTable	*hashTable;
+const TYPE_CmdEntry	*cmdEntry;
+
+	hashTable	=	FindCmdHashTable(theCmdTable);
+	if (hashTable != NULL)
+	{
+		cmdEnumValue	=	-1;
+		cmdEntry		=	hashTable->slot[CmdHash(theCmd, hashTable->seed) & hashTable->slotMask];
+		if ((cmdEntry != NULL) && (strcasecmp(theCmd, cmdEntry->commandName) == 0))
+		{
+			cmdEnumValue	=	cmdEntry->enumValue;
+			if (cmdType != NULL)
+			{
+				*cmdType	=	cmdEntry->get_put;
+			}
+		}
+		return(cmdEnumValue);
+	}
 
+	//*	no hash table for this one, do it the slow way
 	cmdEnumValue	=	-1;
 	iii				=	0;
 	while ((theCmdTable[iii].commandName[0] != 0) && (cmdEnumValue < 0))
@@ -5544,7 +6914,7 @@ int		cmdEnumValue;
 				cmdEnumValue	=	gCommonCmdTable[iii].enumValue;
 				if (cmdType != NULL)
 				{
-					*cmdType	=	theCmdTable[iii].get_put;
+					*cmdType	=	gCommonCmdTable[iii].get_put;
 				}
 			}
 			iii++;
@@ -5553,31 +6923,6 @@ int		cmdEnumValue;
 	return(cmdEnumValue);
 }
 
-//*****************************************************************************
-static void	GenerateInvertedCase(const char *charStr, char *invertedStr)
-{
-int	sLen;
-int	iii;
-
-	sLen	=	strlen(charStr);
-	for (iii=0; iii<sLen; iii++)
-	{
-		if (isupper(charStr[iii]))
-		{
-			invertedStr[iii]	=	tolower(charStr[iii]);
-		}
-		else if (islower(charStr[iii]))
-		{
-			invertedStr[iii]	=	toupper(charStr[iii]);
-		}
-		else
-		{
-			invertedStr[iii]	=	charStr[iii];
-		}
-	}
-	invertedStr[iii]	=	0;
-}
-
 //*****************************************************************************
 //*	This finds the unique keyword in the data string.
 //*	the keyword must be terminated with a "=" in order to return
@@ -5588,6 +6933,9 @@ int	iii;
 //*	argIsNumeric should be set to kArgumentIsNumeric/TRUE
 //*		IF the argument is a floating point number,
 //*		this allows for European strings with commas instead of periods
+//*
+//*	If dataSource is the contentData of the request being processed by this
+//*	thread, the parameter index built by the parser is used instead of scanning
 //*****************************************************************************
 bool	GetKeyWordArgument(	const char	*dataSource,
 							const char	*keyword,
@@ -5605,7 +6953,8 @@ char	myArgString[256];
 int		myArgLength;
 int		ccc;
 char	theChar;
-char	invertedCaseKeyWord[64];
+int		paramIdx;
+const char	*valuePtr;
 #ifdef _DEBUG_CONFORM_
 	CONSOLE_DEBUG(__FUNCTION__);
 	CONSOLE_DEBUG_W_STR("dataSource\t=", dataSource);
@@ -5614,10 +6963,35 @@ char	invertedCaseKeyWord[64];
 
 
 	foundKeyWord	=	false;
-	if ((dataSource != NULL) && (keyword != NULL) && (argument != NULL))
+	if ((dataSource != NULL) && (keyword != NULL) && (argument != NULL) &&
+		(gWorkerReqData != NULL) && (dataSource == gWorkerReqData->contentData))
+	{
+		if (dataSource[0] != 0)
+		{
+			argument[0]	=	0;
+			paramIdx	=	ParamIndex_Find(&gWorkerReqData->params, keyword, ingoreCase);
+			if (paramIdx >= 0)
+			{
+				foundKeyWord	=	true;
+				valuePtr		=	&gWorkerReqData->params.paramBuffer[gWorkerReqData->params.param[paramIdx].valueOffset];
+				//*	same rules as below, stops at the first space, leave room for the null termination
+				jjj				=	0;
+				while ((valuePtr[jjj] > 0x20) && (jjj < (maxArgLen - 2)))
+				{
+					argument[jjj]	=	valuePtr[jjj];
+					//*	in order to handle the comma char as a decimal point for Europe
+					if (argIsNumeric && (argument[jjj] == ','))
+					{
+						argument[jjj]	=	'.';	//*	replace with period
+					}
+					jjj++;
+				}
+				argument[jjj]	=	0;
+			}
+		}
+	}
+	else if ((dataSource != NULL) && (keyword != NULL) && (argument != NULL))
 	{
-		GenerateInvertedCase(keyword, invertedCaseKeyWord);
-
 		//*	this steps through the string looking for keywords
 		//*	Once the keyword is found, it MUST be followed by an "="
 		dataSrcLen	=	strlen(dataSource);
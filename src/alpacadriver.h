@@ -32,6 +32,10 @@
 //*	Nov 28,	2022	<MLS> Added cLastDeviceErrMsg
 //*	Sep 20,	2023	<MLS> Moved camera read thread to base class
 //*	Apr 29,	2024	<MLS> Added cSendJSONresponse to handle setupdialog
+//*	Oct 16,	2026	<MLS> Added cCmdProcessMutex, requests are now handled by multiple threads
+//*	Oct 16,	2026	<MLS> Added TYPE_CMD_TIMING, per command latency histograms
+//*	Oct 17,	2026	<MLS> Added OutputHTML_DeviceStats()
+//*	Oct 17,	2026	<MLS> Added ReleaseCmdProcessLock() & RetakeCmdProcessLock()
 //*****************************************************************************
 //#include	"alpacadriver.h"
 
@@ -101,6 +105,10 @@
 	#include	"gps_data.h"
 #endif
 
+#ifndef _LATENCYHISTOGRAM_H_
+	#include	"latencyhistogram.h"
+#endif
+
 
 
 #ifdef _USE_OPENCV_
@@ -152,6 +160,28 @@ typedef struct	//	TYPE_CMD_STATS
 
 } TYPE_CMD_STATS;
 
+//*****************************************************************************
+//*	kLatencyBucketCnt log-linear buckets, see latencyhistogram.h
+typedef struct	//	TYPE_CMD_TIMING
+{
+	uint32_t	count;
+	uint32_t	max_uS;
+	uint64_t	phaseSum_uS[kReqPhase_last];	//*	for the averages
+	uint32_t	bucket[kLatencyBucketCnt];		//*	total time of the request
+
+} TYPE_CMD_TIMING;
+
+//*****************************************************************************
+//*	the per command values that are saved while cCmdProcessMutex is given up
+typedef struct	//	TYPE_CmdProcessState
+{
+	bool	sendJSONresponse;
+	bool	httpHeaderSent;
+	int		bytesWrittenForThisCmd;
+	int		currentCmdNum;
+
+} TYPE_CmdProcessState;
+
 
 #define	kMagicCookieValue	0x55AA7777
 
@@ -237,6 +267,9 @@ class AlpacaDriver
 
 				void	OutputHTMLrowData(int socketFD, const char *string1, const char *string2);
 				void	OutputHTML_CmdStats(	TYPE_GetPutRequestData *reqData);
+				void	OutputHTML_CmdTiming(	TYPE_GetPutRequestData *reqData);
+				void	OutputJSON_CmdTiming(	TYPE_GetPutRequestData *reqData);
+		virtual	void	OutputHTML_DeviceStats(	TYPE_GetPutRequestData *reqData);
 
 				TYPE_ASCOM_STATUS		SendSupportedActions(TYPE_GetPutRequestData *reqData, const TYPE_CmdEntry *theCmdTable);
 				void					DumpCommonProperties(const char *callingFunctionName);
@@ -249,6 +282,13 @@ class AlpacaDriver
 
 				bool				cSendJSONresponse;		//*	False for setupdialog and camera binary data
 				bool				cHttpHeaderSent;
+				//*	commands are processed by more than one listen worker thread,
+				//*	cSendJSONresponse/cHttpHeaderSent/etc are per command, one command at a time per device
+				pthread_mutex_t		cCmdProcessMutex;
+				//*	a long transfer can let other commands for this device run,
+				//*	nothing but the request and its own data may be used until the lock is retaken
+				void				ReleaseCmdProcessLock(TYPE_CmdProcessState *cmdState);
+				void				RetakeCmdProcessLock(TYPE_CmdProcessState *cmdState);
 				bool				cRunStartupOperations;
 				bool				cVerboseDebug;
 				uint32_t			cMagicCookie;			//*	used to validate objects
@@ -293,6 +333,15 @@ class AlpacaDriver
 				TYPE_CMD_STATS		cCommonCmdStats[kCmd_Common_last];
 				TYPE_CMD_STATS		cDeviceCmdStats[kDeviceCmdCnt];
 
+				//=========================================================
+				//*	command latency, the histograms are allocated the first time a command is used
+				int					cCurrentCmdNum;			//*	set by RecordCmdStats(), -1 if not recorded
+				void				RecordCmdTiming(TYPE_GetPutRequestData *reqData);
+				TYPE_CMD_TIMING		*GetCmdTimingPtr(const int cmdNum, const bool allocate);
+
+				TYPE_CMD_TIMING		*cCommonCmdTiming[kCmd_Common_last];
+				TYPE_CMD_TIMING		*cDeviceCmdTiming[kDeviceCmdCnt];
+
 				//=========================================================
 				//*	discovery routines, allow a device to look for other devices
 				bool					SendDiscoveryQuery(void);
@@ -416,6 +465,7 @@ extern	AlpacaDriver	*gAlpacaDeviceList[];
 extern	int				gDeviceCnt;
 extern	bool			gLiveView;
 extern	bool			gAutoExposure;
+extern	int				gImageSaveThreadCnt;
 extern	bool			gDisplayImage;
 extern	bool			gSimulateCameraImage;
 extern	bool			gVerbose;
@@ -439,6 +489,7 @@ extern	const char		gHtmlHeader_html[];
 	extern "C" {
 #endif
 int				FindCmdFromTable(const char *theCmd, const TYPE_CmdEntry *theCmdTable, int *cmdType);
+void			BuildCommandHashTables(void);
 void			GenerateHTMLcmdLinkTable(int socketFD, const char *deviceName, const int deviceNum, const TYPE_CmdEntry *cmdTable);
 int				GetFilterWheelCnt(void);
 int				CountDevicesByType(const int deviceType);
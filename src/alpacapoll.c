@@ -0,0 +1,930 @@
+//*****************************************************************************
+//*
+//*	Name:			alpacapoll.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Background polling engine for the controller windows
+//*
+//*	Usage notes:	The controller windows used to call GetJsonResponse() for readall and
+//*					devicestate from RunBackgroundTasks(), on the window thread. Each window
+//*					waited for its own device, one device after another, and a device that was
+//*					off line held up every window for the full socket time out.
+//*
+//*					This runs one thread for all of the controllers. Each controller registers
+//*					its device and gets a handle. The window thread posts a url and comes back
+//*					later for the reply, nothing it calls here ever blocks.
+//*					The engine uses non-blocking sockets and poll(), so requests to different
+//*					hosts are all in progress at the same time. There is at most one request in
+//*					progress per handle, and each one has its own time out.
+//*					Connections are kept open between polls when the server allows it.
+//*
+//*					Replies are passed back through a lock free mailbox, each handle has 3
+//*					reply buffers. The engine fills one, publishes it by swapping its index into
+//*					readyReplyIdx and takes a free one for the next request. The window thread
+//*					swaps readyReplyIdx with -1 to get it and sets its bit in freeReplyMask when
+//*					it is done with it. There is always a free buffer for the engine, one can be
+//*					waiting in the mailbox and one can be held by the window thread.
+//*
+//*					Each handle keeps request, failure and latency counts for the window.
+//*
+//*					AlpacaPoll_WaitForReply() is for callers on their own thread, like the
+//*					discovery thread, that have nothing else to do until a reply comes in.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created alpacapoll.c
+//*	Oct 17,	2026	<MLS> Added AlpacaPoll_WaitForReply()
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<strings.h>
+#include	<unistd.h>
+#include	<errno.h>
+#include	<fcntl.h>
+#include	<poll.h>
+#include	<time.h>
+#include	<pthread.h>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<arpa/inet.h>
+#include	<netinet/in.h>
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"sendrequest_lib.h"
+#include	"alpacapoll.h"
+
+#define	kRepliesPerSlot			3
+#define	kAllRepliesFree			((1 << kRepliesPerSlot) - 1)
+#define	kReplyStartSize			(8 * 1024)
+#define	kReplyReadSize			4096
+#define	kXmitBuffLen			1024
+#define	kMaxPollWait_ms			1000
+
+//*	slotState
+enum
+{
+	kSlot_Free	=	0,
+	kSlot_Setup,				//*	being filled in by AlpacaPoll_Register()
+	kSlot_Active,
+	kSlot_Closing				//*	the engine closes the socket, frees the buffers and sets it free
+};
+
+//*	requestState
+enum
+{
+	kRequest_Idle	=	0,
+	kRequest_Filling,			//*	the window thread is copying the url
+	kRequest_Posted,
+	kRequest_Busy
+};
+
+//*	connState, only used by the engine thread
+enum
+{
+	kConn_Closed	=	0,
+	kConn_Connecting,
+	kConn_Sending,
+	kConn_Receiving,
+	kConn_Idle					//*	kept open by the server, waiting for the next request
+};
+
+//*****************************************************************************
+typedef struct
+{
+	//*	shared with the window thread, only accessed with the __atomic builtins
+	int						slotState;
+	int						requestState;
+	int						readyReplyIdx;		//*	-1 if nothing is waiting
+	int						freeReplyMask;
+
+	//*	written by the window thread while the slot is not in use by the engine
+	struct sockaddr_in		deviceAddress;
+	int						port;
+	char					urlString[kAlpacaPoll_MaxUrlLen];
+	int						requestTag;
+
+	//*	engine thread only
+	int						connState;
+	int						socketFD;
+	bool					connReused;
+	int						replyIdx;			//*	the reply being filled, -1 if none
+	char					xmitBuffer[kXmitBuffLen];
+	int						xmitLen;
+	int						xmitSent;
+	long					headerLen;
+	long					contentLength;
+	bool					serverKeepAlive;
+	uint32_t				startTime_ms;
+	uint64_t				totalLatency_ms;
+	uint32_t				goodReplyCnt;
+
+	//*	written by the engine, read by AlpacaPoll_GetStats()
+	TYPE_AlpacaPollStats	stats;
+
+	TYPE_AlpacaPollReply	replies[kRepliesPerSlot];
+} TYPE_PollSlot;
+
+static TYPE_PollSlot	gPollSlots[kAlpacaPoll_MaxDevices];
+static pthread_once_t	gPollOnce			=	PTHREAD_ONCE_INIT;
+static pthread_t		gPollThreadID;
+static bool				gPollThreadRunning	=	false;
+static int				gWakePipe[2]		=	{-1, -1};
+
+//*	bumped every time a reply is published, only used by AlpacaPoll_WaitForReply()
+static pthread_mutex_t	gReplyMutex			=	PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	gReplyCond			=	PTHREAD_COND_INITIALIZER;
+static uint32_t			gReplySequence		=	0;
+
+#define	ATOMIC_LOAD(ptr)			__atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define	ATOMIC_STORE(ptr, value)	__atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+
+//*****************************************************************************
+static uint32_t	GetMilliSecs(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return((currentTime.tv_sec * 1000) + (currentTime.tv_nsec / 1000000));
+}
+
+//*****************************************************************************
+static void	SetNonBlocking(int fileDesc)
+{
+int		flags;
+
+	flags	=	fcntl(fileDesc, F_GETFL, 0);
+	if (flags >= 0)
+	{
+		fcntl(fileDesc, F_SETFL, (flags | O_NONBLOCK));
+	}
+}
+
+//*****************************************************************************
+static void	WakeEngine(void)
+{
+char	wakeByte	=	'w';
+
+	if (gWakePipe[1] >= 0)
+	{
+		//*	non-blocking, if the pipe is full the engine is already awake
+		if (write(gWakePipe[1], &wakeByte, 1) < 0)
+		{
+		}
+	}
+}
+
+//*****************************************************************************
+static void	PollSlot_CloseSocket(TYPE_PollSlot *pollSlot)
+{
+	if (pollSlot->socketFD >= 0)
+	{
+		close(pollSlot->socketFD);
+	}
+	pollSlot->socketFD	=	-1;
+	pollSlot->connState	=	kConn_Closed;
+}
+
+//*****************************************************************************
+static void	PollSlot_UpdateStats(TYPE_PollSlot *pollSlot, const bool requestOK, const bool timedOut, const uint32_t latency_ms)
+{
+TYPE_AlpacaPollStats	*stats;
+
+	stats	=	&pollSlot->stats;
+	__atomic_store_n(&stats->RequestCnt, (stats->RequestCnt + 1), __ATOMIC_RELAXED);
+	if (requestOK)
+	{
+		pollSlot->goodReplyCnt++;
+		pollSlot->totalLatency_ms	+=	latency_ms;
+		__atomic_store_n(&stats->AvgLatency_ms, (uint32_t)(pollSlot->totalLatency_ms / pollSlot->goodReplyCnt), __ATOMIC_RELAXED);
+		if (latency_ms > stats->MaxLatency_ms)
+		{
+			__atomic_store_n(&stats->MaxLatency_ms, latency_ms, __ATOMIC_RELAXED);
+		}
+	}
+	else
+	{
+		__atomic_store_n(&stats->FailureCnt, (stats->FailureCnt + 1), __ATOMIC_RELAXED);
+		if (timedOut)
+		{
+			__atomic_store_n(&stats->TimeOutCnt, (stats->TimeOutCnt + 1), __ATOMIC_RELAXED);
+		}
+	}
+	__atomic_store_n(&stats->LastLatency_ms, latency_ms, __ATOMIC_RELAXED);
+}
+
+//*****************************************************************************
+//*	hands the reply to the window thread and makes the slot available for the next request
+//*****************************************************************************
+static void	PollSlot_FinishRequest(TYPE_PollSlot *pollSlot, const bool validData, const bool timedOut)
+{
+TYPE_AlpacaPollReply	*pollReply;
+uint32_t				latency_ms;
+int						previousIdx;
+bool					keepOpen;
+char					*statusPtr;
+
+	latency_ms	=	GetMilliSecs() - pollSlot->startTime_ms;
+	pollReply	=	&pollSlot->replies[pollSlot->replyIdx];
+
+	pollReply->validData	=	validData;
+	pollReply->latency_ms	=	latency_ms;
+	pollReply->httpStatus	=	0;
+	if (validData && (strncmp(pollReply->replyData, "HTTP/", 5) == 0))
+	{
+		statusPtr	=	strchr(pollReply->replyData, ' ');
+		if (statusPtr != NULL)
+		{
+			pollReply->httpStatus	=	atoi(statusPtr + 1);
+		}
+	}
+	PollSlot_UpdateStats(	pollSlot,
+							(validData && (pollReply->httpStatus >= 200) && (pollReply->httpStatus < 300)),
+							timedOut,
+							latency_ms);
+
+	keepOpen	=	(validData && pollSlot->serverKeepAlive && (pollSlot->contentLength >= 0) &&
+					(pollReply->dataLen == (pollSlot->headerLen + pollSlot->contentLength)));
+	if (keepOpen)
+	{
+		pollSlot->connState	=	kConn_Idle;
+	}
+	else
+	{
+		PollSlot_CloseSocket(pollSlot);
+	}
+
+	//*	publish it, if the last one was never picked up it goes back on the free list
+	previousIdx	=	__atomic_exchange_n(&pollSlot->readyReplyIdx, pollSlot->replyIdx, __ATOMIC_ACQ_REL);
+	if (previousIdx >= 0)
+	{
+		__atomic_fetch_or(&pollSlot->freeReplyMask, (1 << previousIdx), __ATOMIC_ACQ_REL);
+	}
+	pollSlot->replyIdx	=	-1;
+	ATOMIC_STORE(&pollSlot->requestState, kRequest_Idle);
+
+	pthread_mutex_lock(&gReplyMutex);
+	gReplySequence++;
+	pthread_cond_broadcast(&gReplyCond);
+	pthread_mutex_unlock(&gReplyMutex);
+}
+
+//*****************************************************************************
+//*	returns false if the connection could not be started
+//*****************************************************************************
+static bool	PollSlot_Connect(TYPE_PollSlot *pollSlot)
+{
+int		connRetCode;
+bool	connectOK;
+
+	connectOK			=	false;
+	pollSlot->connReused	=	false;
+	pollSlot->socketFD	=	socket(AF_INET, SOCK_STREAM, 0);
+	if (pollSlot->socketFD >= 0)
+	{
+		SetNonBlocking(pollSlot->socketFD);
+		connRetCode	=	connect(pollSlot->socketFD,
+								(struct sockaddr *)&pollSlot->deviceAddress,
+								sizeof(struct sockaddr_in));
+		if (connRetCode == 0)
+		{
+			pollSlot->connState	=	kConn_Sending;
+			connectOK			=	true;
+		}
+		else if (errno == EINPROGRESS)
+		{
+			pollSlot->connState	=	kConn_Connecting;
+			connectOK			=	true;
+		}
+		else
+		{
+			PollSlot_CloseSocket(pollSlot);
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_NUM("socket() failed, errno\t=", errno);
+	}
+	return(connectOK);
+}
+
+//*****************************************************************************
+static void	PollSlot_StartRequest(TYPE_PollSlot *pollSlot)
+{
+TYPE_AlpacaPollReply	*pollReply;
+char					ipString[32];
+int						freeMask;
+int						iii;
+bool					startOK;
+
+	startOK		=	false;
+	pollSlot->startTime_ms	=	GetMilliSecs();
+
+	//*	claim a free reply buffer
+	pollSlot->replyIdx	=	-1;
+	freeMask			=	ATOMIC_LOAD(&pollSlot->freeReplyMask);
+	for (iii=0; iii<kRepliesPerSlot; iii++)
+	{
+		if ((pollSlot->replyIdx < 0) && (freeMask & (1 << iii)))
+		{
+			pollSlot->replyIdx	=	iii;
+		}
+	}
+	if (pollSlot->replyIdx >= 0)
+	{
+		__atomic_fetch_and(&pollSlot->freeReplyMask, ~(1 << pollSlot->replyIdx), __ATOMIC_ACQ_REL);
+		pollReply	=	&pollSlot->replies[pollSlot->replyIdx];
+		if (pollReply->replyData == NULL)
+		{
+			pollReply->replyData	=	(char *)malloc(kReplyStartSize);
+			pollReply->bufferSize	=	(pollReply->replyData != NULL) ? kReplyStartSize : 0;
+		}
+		pollReply->requestTag	=	pollSlot->requestTag;
+		pollReply->dataLen		=	0;
+		if (pollReply->replyData != NULL)
+		{
+			pollReply->replyData[0]	=	0;
+
+			//*	same request GetJsonResponse() sends
+			inet_ntop(AF_INET, &pollSlot->deviceAddress.sin_addr.s_addr, ipString, INET_ADDRSTRLEN);
+			pollSlot->xmitLen	=	snprintf(	pollSlot->xmitBuffer,
+												kXmitBuffLen,
+												"GET %s HTTP/1.0\r\n"
+												"Host: %s:%d\r\n"
+												"%s"
+												"Accept: text/html,application/json\r\n"
+												"Accept-Language: en-US,en;q=0.5\r\n"
+												"Connection: keep-alive\r\n"
+												"\r\n",
+												pollSlot->urlString,
+												ipString,
+												pollSlot->port,
+												gUserAgentAlpacaPiStr);
+			pollSlot->xmitSent			=	0;
+			pollSlot->headerLen			=	-1;
+			pollSlot->contentLength		=	-1;
+			pollSlot->serverKeepAlive	=	false;
+			if ((pollSlot->xmitLen > 0) && (pollSlot->xmitLen < kXmitBuffLen))
+			{
+				if ((pollSlot->connState == kConn_Idle) && (pollSlot->socketFD >= 0))
+				{
+					pollSlot->connReused	=	true;
+					pollSlot->connState		=	kConn_Sending;
+					__atomic_store_n(&pollSlot->stats.ReusedConnCnt, (pollSlot->stats.ReusedConnCnt + 1), __ATOMIC_RELAXED);
+					startOK					=	true;
+				}
+				else
+				{
+					PollSlot_CloseSocket(pollSlot);
+					startOK	=	PollSlot_Connect(pollSlot);
+				}
+			}
+		}
+		if (startOK == false)
+		{
+			PollSlot_FinishRequest(pollSlot, false, false);
+		}
+	}
+	else
+	{
+		//*	can not happen unless the window thread holds more than one reply
+		CONSOLE_DEBUG("No free reply buffer");
+		PollSlot_UpdateStats(pollSlot, false, false, 0);
+		ATOMIC_STORE(&pollSlot->requestState, kRequest_Idle);
+	}
+}
+
+//*****************************************************************************
+//*	the server closed a kept open connection before we got any reply, try once on a new one
+//*****************************************************************************
+static void	PollSlot_RetryOrFail(TYPE_PollSlot *pollSlot)
+{
+bool	retryOK;
+
+	retryOK	=	false;
+	if (pollSlot->connReused && (pollSlot->replies[pollSlot->replyIdx].dataLen == 0))
+	{
+		PollSlot_CloseSocket(pollSlot);
+		pollSlot->xmitSent	=	0;
+		retryOK				=	PollSlot_Connect(pollSlot);
+	}
+	if (retryOK == false)
+	{
+		PollSlot_CloseSocket(pollSlot);
+		PollSlot_FinishRequest(pollSlot, false, false);
+	}
+}
+
+//*****************************************************************************
+static void	PollSlot_Send(TYPE_PollSlot *pollSlot)
+{
+int		sendRetCode;
+
+	sendRetCode	=	send(	pollSlot->socketFD,
+							&pollSlot->xmitBuffer[pollSlot->xmitSent],
+							(pollSlot->xmitLen - pollSlot->xmitSent),
+							MSG_NOSIGNAL);
+	if (sendRetCode > 0)
+	{
+		pollSlot->xmitSent	+=	sendRetCode;
+		if (pollSlot->xmitSent >= pollSlot->xmitLen)
+		{
+			pollSlot->connState	=	kConn_Receiving;
+		}
+	}
+	else if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+	{
+		PollSlot_RetryOrFail(pollSlot);
+	}
+}
+
+//*****************************************************************************
+//*	looks for the end of the http header, Content-Length and keep-alive
+//*****************************************************************************
+static void	PollSlot_ParseHeader(TYPE_PollSlot *pollSlot, char *replyData)
+{
+char	*endOfHdrPtr;
+char	*linePtr;
+
+	endOfHdrPtr	=	strstr(replyData, "\r\n\r\n");
+	if (endOfHdrPtr != NULL)
+	{
+		pollSlot->headerLen			=	(endOfHdrPtr - replyData) + 4;
+		//*	HTTP/1.1 replies default to keep-alive
+		pollSlot->serverKeepAlive	=	(strncmp(replyData, "HTTP/1.1", 8) == 0);
+		linePtr						=	strstr(replyData, "\r\n");
+		while ((linePtr != NULL) && (linePtr < endOfHdrPtr))
+		{
+			linePtr	+=	2;
+			if (strncasecmp(linePtr, "Content-Length:", 15) == 0)
+			{
+				pollSlot->contentLength	=	atol(linePtr + 15);
+			}
+			else if (strncasecmp(linePtr, "Connection: close", 17) == 0)
+			{
+				pollSlot->serverKeepAlive	=	false;
+			}
+			else if (strncasecmp(linePtr, "Connection: keep-alive", 22) == 0)
+			{
+				pollSlot->serverKeepAlive	=	true;
+			}
+			linePtr	=	strstr(linePtr, "\r\n");
+		}
+	}
+}
+
+//*****************************************************************************
+static void	PollSlot_Receive(TYPE_PollSlot *pollSlot)
+{
+TYPE_AlpacaPollReply	*pollReply;
+char					*newBuffer;
+int						newSize;
+int						recvByteCnt;
+bool					keepReading;
+
+	pollReply	=	&pollSlot->replies[pollSlot->replyIdx];
+	keepReading	=	true;
+	while (keepReading)
+	{
+		//*	make room for another read and the terminating null
+		if ((pollReply->bufferSize - pollReply->dataLen) < (kReplyReadSize + 1))
+		{
+			newSize		=	pollReply->bufferSize * 2;
+			newBuffer	=	NULL;
+			if (newSize <= kAlpacaPoll_MaxReplySize)
+			{
+				newBuffer	=	(char *)realloc(pollReply->replyData, newSize);
+			}
+			if (newBuffer != NULL)
+			{
+				pollReply->replyData	=	newBuffer;
+				pollReply->bufferSize	=	newSize;
+			}
+			else
+			{
+				CONSOLE_DEBUG_W_NUM("Reply too large, dataLen\t=", pollReply->dataLen);
+				PollSlot_CloseSocket(pollSlot);
+				PollSlot_FinishRequest(pollSlot, false, false);
+				keepReading	=	false;
+			}
+		}
+		if (keepReading)
+		{
+			recvByteCnt	=	recv(	pollSlot->socketFD,
+									&pollReply->replyData[pollReply->dataLen],
+									(pollReply->bufferSize - pollReply->dataLen - 1),
+									MSG_NOSIGNAL);
+			if (recvByteCnt > 0)
+			{
+				pollReply->dataLen							+=	recvByteCnt;
+				pollReply->replyData[pollReply->dataLen]	=	0;
+				if (pollSlot->headerLen < 0)
+				{
+					PollSlot_ParseHeader(pollSlot, pollReply->replyData);
+				}
+				if ((pollSlot->headerLen >= 0) && (pollSlot->contentLength >= 0) &&
+					(pollReply->dataLen >= (pollSlot->headerLen + pollSlot->contentLength)))
+				{
+					PollSlot_FinishRequest(pollSlot, true, false);
+					keepReading	=	false;
+				}
+			}
+			else if ((recvByteCnt < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)))
+			{
+				//*	wait for more
+				keepReading	=	false;
+			}
+			else if (pollReply->dataLen > 0)
+			{
+				//*	closed by the server, that is the end of an HTTP/1.0 reply with no Content-Length
+				PollSlot_CloseSocket(pollSlot);
+				PollSlot_FinishRequest(pollSlot, (pollSlot->headerLen >= 0), false);
+				keepReading	=	false;
+			}
+			else
+			{
+				PollSlot_RetryOrFail(pollSlot);
+				keepReading	=	false;
+			}
+		}
+	}
+}
+
+//*****************************************************************************
+static void	PollSlot_HandleEvents(TYPE_PollSlot *pollSlot, const short revents)
+{
+int			socketErr;
+socklen_t	optionLen;
+
+	if (pollSlot->connState == kConn_Connecting)
+	{
+		socketErr	=	0;
+		optionLen	=	sizeof(socketErr);
+		getsockopt(pollSlot->socketFD, SOL_SOCKET, SO_ERROR, &socketErr, &optionLen);
+		if (socketErr == 0)
+		{
+			pollSlot->connState	=	kConn_Sending;
+		}
+		else
+		{
+			PollSlot_CloseSocket(pollSlot);
+			PollSlot_FinishRequest(pollSlot, false, false);
+		}
+	}
+	if (pollSlot->connState == kConn_Sending)
+	{
+		PollSlot_Send(pollSlot);
+	}
+	else if ((pollSlot->connState == kConn_Receiving) && (revents & (POLLIN | POLLHUP | POLLERR)))
+	{
+		PollSlot_Receive(pollSlot);
+	}
+}
+
+//*****************************************************************************
+static void	PollSlot_Release(TYPE_PollSlot *pollSlot)
+{
+int		iii;
+
+	PollSlot_CloseSocket(pollSlot);
+	for (iii=0; iii<kRepliesPerSlot; iii++)
+	{
+		if (pollSlot->replies[iii].replyData != NULL)
+		{
+			free(pollSlot->replies[iii].replyData);
+		}
+		memset(&pollSlot->replies[iii], 0, sizeof(TYPE_AlpacaPollReply));
+	}
+	pollSlot->replyIdx	=	-1;
+	ATOMIC_STORE(&pollSlot->slotState, kSlot_Free);
+}
+
+//*****************************************************************************
+static void	*AlpacaPoll_Thread(void *arg)
+{
+TYPE_PollSlot	*pollSlots;
+TYPE_PollSlot	*pollSlot;
+struct pollfd	pollFDs[kAlpacaPoll_MaxDevices + 1];
+int				pollSlotIdx[kAlpacaPoll_MaxDevices + 1];
+int				pollCnt;
+int				pollWait_ms;
+int				timeLeft_ms;
+int				slotState;
+int				iii;
+uint32_t		currentMillis;
+char			drainBuff[64];
+
+	pollSlots	=	(TYPE_PollSlot *)arg;
+	while (gPollThreadRunning)
+	{
+		pollFDs[0].fd		=	gWakePipe[0];
+		pollFDs[0].events	=	POLLIN;
+		pollFDs[0].revents	=	0;
+		pollCnt				=	1;
+		pollWait_ms			=	kMaxPollWait_ms;
+		currentMillis		=	GetMilliSecs();
+		for (iii=0; iii<kAlpacaPoll_MaxDevices; iii++)
+		{
+			pollSlot	=	&pollSlots[iii];
+			slotState	=	ATOMIC_LOAD(&pollSlot->slotState);
+			if (slotState == kSlot_Closing)
+			{
+				PollSlot_Release(pollSlot);
+			}
+			else if (slotState == kSlot_Active)
+			{
+				if (ATOMIC_LOAD(&pollSlot->requestState) == kRequest_Posted)
+				{
+					ATOMIC_STORE(&pollSlot->requestState, kRequest_Busy);
+					PollSlot_StartRequest(pollSlot);
+				}
+				if ((pollSlot->connState == kConn_Connecting) ||
+					(pollSlot->connState == kConn_Sending) ||
+					(pollSlot->connState == kConn_Receiving))
+				{
+					timeLeft_ms	=	kAlpacaPoll_TimeOut_ms - (int)(currentMillis - pollSlot->startTime_ms);
+					if (timeLeft_ms <= 0)
+					{
+						PollSlot_CloseSocket(pollSlot);
+						PollSlot_FinishRequest(pollSlot, false, true);
+					}
+					else
+					{
+						pollFDs[pollCnt].fd			=	pollSlot->socketFD;
+						pollFDs[pollCnt].events		=	(pollSlot->connState == kConn_Receiving) ? POLLIN : POLLOUT;
+						pollFDs[pollCnt].revents	=	0;
+						pollSlotIdx[pollCnt]		=	iii;
+						pollCnt++;
+						if (timeLeft_ms < pollWait_ms)
+						{
+							pollWait_ms	=	timeLeft_ms;
+						}
+					}
+				}
+			}
+		}
+
+		if (poll(pollFDs, pollCnt, pollWait_ms) > 0)
+		{
+			if (pollFDs[0].revents & POLLIN)
+			{
+				while (read(gWakePipe[0], drainBuff, sizeof(drainBuff)) > 0)
+				{
+				}
+			}
+			for (iii=1; iii<pollCnt; iii++)
+			{
+				if (pollFDs[iii].revents != 0)
+				{
+					PollSlot_HandleEvents(&pollSlots[pollSlotIdx[iii]], pollFDs[iii].revents);
+				}
+			}
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+static void	AlpacaPoll_StartEngine(void)
+{
+int		iii;
+int		threadErr;
+
+	for (iii=0; iii<kAlpacaPoll_MaxDevices; iii++)
+	{
+		memset(&gPollSlots[iii], 0, sizeof(TYPE_PollSlot));
+		gPollSlots[iii].socketFD		=	-1;
+		gPollSlots[iii].replyIdx		=	-1;
+		gPollSlots[iii].readyReplyIdx	=	-1;
+	}
+	if (pipe(gWakePipe) == 0)
+	{
+		SetNonBlocking(gWakePipe[0]);
+		SetNonBlocking(gWakePipe[1]);
+		gPollThreadRunning	=	true;
+		threadErr			=	pthread_create(&gPollThreadID, NULL, &AlpacaPoll_Thread, gPollSlots);
+		if (threadErr != 0)
+		{
+			CONSOLE_DEBUG_W_NUM("pthread_create() failed, threadErr\t=", threadErr);
+			gPollThreadRunning	=	false;
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_NUM("pipe() failed, errno\t=", errno);
+	}
+}
+
+//*****************************************************************************
+int	AlpacaPoll_Register(struct sockaddr_in *deviceAddress, const int port)
+{
+TYPE_PollSlot	*pollSlot;
+int				pollHandle;
+int				iii;
+int				expectedState;
+
+	pthread_once(&gPollOnce, AlpacaPoll_StartEngine);
+
+	pollHandle	=	-1;
+	if (gPollThreadRunning)
+	{
+		iii	=	0;
+		while ((pollHandle < 0) && (iii < kAlpacaPoll_MaxDevices))
+		{
+			expectedState	=	kSlot_Free;
+			if (__atomic_compare_exchange_n(&gPollSlots[iii].slotState,
+											&expectedState,
+											kSlot_Setup,
+											false,
+											__ATOMIC_ACQ_REL,
+											__ATOMIC_ACQUIRE))
+			{
+				pollHandle	=	iii;
+			}
+			iii++;
+		}
+	}
+	if (pollHandle >= 0)
+	{
+		pollSlot				=	&gPollSlots[pollHandle];
+		pollSlot->deviceAddress	=	*deviceAddress;
+		pollSlot->port			=	port;
+		pollSlot->deviceAddress.sin_family	=	AF_INET;
+		pollSlot->deviceAddress.sin_port	=	htons(port);
+		pollSlot->urlString[0]	=	0;
+		pollSlot->requestTag	=	0;
+		pollSlot->connState		=	kConn_Closed;
+		pollSlot->socketFD		=	-1;
+		pollSlot->replyIdx		=	-1;
+		pollSlot->totalLatency_ms	=	0;
+		pollSlot->goodReplyCnt	=	0;
+		memset(&pollSlot->stats, 0, sizeof(TYPE_AlpacaPollStats));
+		pollSlot->requestState	=	kRequest_Idle;
+		pollSlot->readyReplyIdx	=	-1;
+		pollSlot->freeReplyMask	=	kAllRepliesFree;
+		ATOMIC_STORE(&pollSlot->slotState, kSlot_Active);
+	}
+	else
+	{
+		CONSOLE_DEBUG("No poll slot available");
+	}
+	return(pollHandle);
+}
+
+//*****************************************************************************
+//*	any reply from GetReply() must have been released first
+//*****************************************************************************
+void	AlpacaPoll_Unregister(const int pollHandle)
+{
+	if ((pollHandle >= 0) && (pollHandle < kAlpacaPoll_MaxDevices))
+	{
+		ATOMIC_STORE(&gPollSlots[pollHandle].slotState, kSlot_Closing);
+		WakeEngine();
+	}
+}
+
+//*****************************************************************************
+bool	AlpacaPoll_PostRequest(const int pollHandle, const char *urlString, const int requestTag)
+{
+TYPE_PollSlot	*pollSlot;
+int				expectedState;
+bool			postedOK;
+
+	postedOK	=	false;
+	if ((pollHandle >= 0) && (pollHandle < kAlpacaPoll_MaxDevices) && (strlen(urlString) < kAlpacaPoll_MaxUrlLen))
+	{
+		pollSlot		=	&gPollSlots[pollHandle];
+		expectedState	=	kRequest_Idle;
+		if ((ATOMIC_LOAD(&pollSlot->slotState) == kSlot_Active) &&
+			__atomic_compare_exchange_n(&pollSlot->requestState,
+										&expectedState,
+										kRequest_Filling,
+										false,
+										__ATOMIC_ACQ_REL,
+										__ATOMIC_ACQUIRE))
+		{
+			strcpy(pollSlot->urlString, urlString);
+			pollSlot->requestTag	=	requestTag;
+			ATOMIC_STORE(&pollSlot->requestState, kRequest_Posted);
+			WakeEngine();
+			postedOK	=	true;
+		}
+	}
+	return(postedOK);
+}
+
+//*****************************************************************************
+bool	AlpacaPoll_IsBusy(const int pollHandle)
+{
+bool	isBusy;
+
+	isBusy	=	false;
+	if ((pollHandle >= 0) && (pollHandle < kAlpacaPoll_MaxDevices))
+	{
+		isBusy	=	(ATOMIC_LOAD(&gPollSlots[pollHandle].requestState) != kRequest_Idle);
+	}
+	return(isBusy);
+}
+
+//*****************************************************************************
+TYPE_AlpacaPollReply	*AlpacaPoll_GetReply(const int pollHandle)
+{
+TYPE_AlpacaPollReply	*pollReply;
+int						replyIdx;
+
+	pollReply	=	NULL;
+	if ((pollHandle >= 0) && (pollHandle < kAlpacaPoll_MaxDevices))
+	{
+		replyIdx	=	__atomic_exchange_n(&gPollSlots[pollHandle].readyReplyIdx, -1, __ATOMIC_ACQ_REL);
+		if (replyIdx >= 0)
+		{
+			pollReply	=	&gPollSlots[pollHandle].replies[replyIdx];
+		}
+	}
+	return(pollReply);
+}
+
+//*****************************************************************************
+void	AlpacaPoll_ReleaseReply(const int pollHandle, TYPE_AlpacaPollReply *pollReply)
+{
+int		replyIdx;
+
+	if ((pollHandle >= 0) && (pollHandle < kAlpacaPoll_MaxDevices) && (pollReply != NULL))
+	{
+		replyIdx	=	pollReply - gPollSlots[pollHandle].replies;
+		if ((replyIdx >= 0) && (replyIdx < kRepliesPerSlot))
+		{
+			__atomic_fetch_or(&gPollSlots[pollHandle].freeReplyMask, (1 << replyIdx), __ATOMIC_ACQ_REL);
+		}
+	}
+}
+
+//*****************************************************************************
+void	AlpacaPoll_GetStats(const int pollHandle, TYPE_AlpacaPollStats *pollStats)
+{
+TYPE_AlpacaPollStats	*stats;
+
+	memset(pollStats, 0, sizeof(TYPE_AlpacaPollStats));
+	if ((pollHandle >= 0) && (pollHandle < kAlpacaPoll_MaxDevices))
+	{
+		stats	=	&gPollSlots[pollHandle].stats;
+		pollStats->RequestCnt		=	__atomic_load_n(&stats->RequestCnt,		__ATOMIC_RELAXED);
+		pollStats->FailureCnt		=	__atomic_load_n(&stats->FailureCnt,		__ATOMIC_RELAXED);
+		pollStats->TimeOutCnt		=	__atomic_load_n(&stats->TimeOutCnt,		__ATOMIC_RELAXED);
+		pollStats->LastLatency_ms	=	__atomic_load_n(&stats->LastLatency_ms,	__ATOMIC_RELAXED);
+		pollStats->AvgLatency_ms	=	__atomic_load_n(&stats->AvgLatency_ms,	__ATOMIC_RELAXED);
+		pollStats->MaxLatency_ms	=	__atomic_load_n(&stats->MaxLatency_ms,	__ATOMIC_RELAXED);
+		pollStats->ReusedConnCnt	=	__atomic_load_n(&stats->ReusedConnCnt,	__ATOMIC_RELAXED);
+	}
+}
+
+//*****************************************************************************
+//*	waits until a reply has been published for any handle since the last call.
+//*	replySequence belongs to the caller, start it at 0.
+//*	returns false if nothing came in before the time out
+//*****************************************************************************
+bool	AlpacaPoll_WaitForReply(uint32_t *replySequence, const int timeOut_ms)
+{
+struct timespec	endTime;
+bool			newReply;
+
+	clock_gettime(CLOCK_REALTIME, &endTime);
+	endTime.tv_sec	+=	timeOut_ms / 1000;
+	endTime.tv_nsec	+=	(timeOut_ms % 1000) * 1000000L;
+	if (endTime.tv_nsec >= 1000000000L)
+	{
+		endTime.tv_sec	+=	1;
+		endTime.tv_nsec	-=	1000000000L;
+	}
+
+	pthread_mutex_lock(&gReplyMutex);
+	while ((gReplySequence == *replySequence) &&
+			(pthread_cond_timedwait(&gReplyCond, &gReplyMutex, &endTime) == 0))
+	{
+	}
+	newReply		=	(gReplySequence != *replySequence);
+	*replySequence	=	gReplySequence;
+	pthread_mutex_unlock(&gReplyMutex);
+	return(newReply);
+}
@@ -0,0 +1,79 @@
+//**************************************************************************
+//*	Name:			alpacapoll.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Background polling engine for the controller windows
+//*
+//*****************************************************************************
+//#include	"alpacapoll.h"
+
+#ifndef _ALPACAPOLL_H_
+#define	_ALPACAPOLL_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#include	<netinet/in.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kAlpacaPoll_MaxDevices		64
+#define	kAlpacaPoll_MaxUrlLen		128
+#define	kAlpacaPoll_TimeOut_ms		5000
+#define	kAlpacaPoll_MaxReplySize	(512 * 1024)
+
+//*****************************************************************************
+//*	one reply, the data is the complete http reply (header and body), null terminated
+//*	it can be handed straight to SJP_ParseDataInPlace()
+typedef struct
+{
+	bool		validData;			//*	a complete reply was received
+	int			httpStatus;			//*	200 etc, 0 if there was no reply
+	int			requestTag;			//*	whatever was passed to AlpacaPoll_PostRequest()
+	uint32_t	latency_ms;
+	int			dataLen;
+	char		*replyData;
+	int			bufferSize;
+} TYPE_AlpacaPollReply;
+
+//*****************************************************************************
+typedef struct
+{
+	uint32_t	RequestCnt;			//*	finished, good or not
+	uint32_t	FailureCnt;			//*	no reply, time out or http status other than 2xx
+	uint32_t	TimeOutCnt;
+	uint32_t	LastLatency_ms;
+	uint32_t	AvgLatency_ms;		//*	of the good replies
+	uint32_t	MaxLatency_ms;
+	uint32_t	ReusedConnCnt;		//*	requests sent on a connection that was already open
+} TYPE_AlpacaPollStats;
+
+//*	Register() starts the engine thread the first time, returns a handle or -1 if all slots are in use
+int		AlpacaPoll_Register(struct sockaddr_in *deviceAddress, const int port);
+void	AlpacaPoll_Unregister(const int pollHandle);
+
+//*	None of these block, they can be called from the window thread.
+//*	PostRequest() returns false if the previous request for this handle is still in progress,
+//*	GetReply() returns NULL if there is nothing new, every reply must be given back with ReleaseReply()
+bool					AlpacaPoll_PostRequest(const int pollHandle, const char *urlString, const int requestTag);
+bool					AlpacaPoll_IsBusy(const int pollHandle);
+TYPE_AlpacaPollReply	*AlpacaPoll_GetReply(const int pollHandle);
+void					AlpacaPoll_ReleaseReply(const int pollHandle, TYPE_AlpacaPollReply *pollReply);
+void					AlpacaPoll_GetStats(const int pollHandle, TYPE_AlpacaPollStats *pollStats);
+
+//*	This one does block, it is for callers that run on their own thread
+bool					AlpacaPoll_WaitForReply(uint32_t *replySequence, const int timeOut_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_ALPACAPOLL_H_
@@ -0,0 +1,395 @@
+//*****************************************************************************
+//*
+//*	Name:			alpacapollbench.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Times a polling pass over several devices, one at a time against alpacapoll.c
+//*
+//*	Usage notes:	Starts a number of loopback devices, each one answers every request after
+//*					a delay, and optionally one device that never answers at all.
+//*					The old way is what RunBackgroundTasks() did, GetJsonResponse() to one
+//*					device after another. The new way posts a request to every device through
+//*					alpacapoll.c and waits for the replies.
+//*					The time reported is how long until every device that does answer has been
+//*					heard from. Every reply is checked to be from the device it was sent to.
+//*
+//*		alpacapollbench -n 8 -d 50 -r 3
+//*
+//*		-n	number of devices (default 8)
+//*		-d	delay in milliseconds before each device answers (default 50)
+//*		-r	number of polling passes (default 3)
+//*		-x	do not include the device that never answers
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created alpacapollbench.c
+//*	Oct 17,	2026	<MLS> Loopback devices moved to benchresponder.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<strings.h>
+#include	<unistd.h>
+#include	<time.h>
+#include	<errno.h>
+#include	<pthread.h>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<arpa/inet.h>
+#include	<netinet/in.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"json_parse.h"
+#include	"sendrequest_lib.h"
+#include	"alpacapoll.h"
+#include	"benchresponder.h"
+
+char	gUserAgentAlpacaPiStr[80]	=	"User-Agent: AlpacaPi alpacapollbench\r\n";
+
+#define	kMaxBenchDevices	32
+
+//*****************************************************************************
+typedef struct
+{
+	TYPE_BenchResponder	responder;
+	int					pollHandle;
+} TYPE_BenchDevice;
+
+static TYPE_BenchDevice	gDevices[kMaxBenchDevices + 1];
+static int				gDeviceCnt			=	8;
+static int				gReplyDelay_ms		=	50;
+static int				gPassCnt			=	3;
+static bool				gIncludeHungDevice	=	true;
+
+//*****************************************************************************
+static uint64_t	GetMicroSecs(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(((uint64_t)timeSpec.tv_sec * 1000000) + (timeSpec.tv_nsec / 1000));
+}
+
+//*****************************************************************************
+static void	Device_ReplyProc(TYPE_BenchResponder *responder, const char *requestBuff, char *bodyBuff, const size_t bodyBuffLen)
+{
+	(void)requestBuff;
+	snprintf(bodyBuff, bodyBuffLen,	"{\"ErrorNumber\":0,\"ErrorMessage\":\"\",\"devicenum\":%d}",
+									responder->responderNum);
+}
+
+//*****************************************************************************
+static bool	CheckReply(SJP_Parser_t *jsonParser, const int deviceNum)
+{
+int		jjj;
+bool	replyOK;
+
+	replyOK	=	false;
+	for (jjj=0; jjj<jsonParser->tokenCount_Data; jjj++)
+	{
+		if (strcasecmp(jsonParser->dataList[jjj].keyword, "devicenum") == 0)
+		{
+			replyOK	=	(atoi(jsonParser->dataList[jjj].valueString) == deviceNum);
+		}
+	}
+	return(replyOK);
+}
+
+//*****************************************************************************
+//*	one device after another, the way RunBackgroundTasks() did it
+//*****************************************************************************
+static uint64_t	RunPass_OneAtATime(int *errorCnt)
+{
+SJP_Parser_t	jsonParser;
+char			urlString[64];
+uint64_t		startTime;
+uint64_t		liveDone_uS;
+int				iii;
+bool			validData;
+
+	liveDone_uS	=	0;
+	startTime	=	GetMicroSecs();
+	for (iii=0; iii<(gDeviceCnt + (gIncludeHungDevice ? 1 : 0)); iii++)
+	{
+		SJP_Init(&jsonParser);
+		sprintf(urlString, "/api/v1/switch/%d/readall", gDevices[iii].responder.responderNum);
+		validData	=	GetJsonResponse(&gDevices[iii].responder.deviceAddress, gDevices[iii].responder.port, urlString, NULL, &jsonParser);
+		if (gDevices[iii].responder.neverAnswers == false)
+		{
+			if ((validData == false) || (CheckReply(&jsonParser, gDevices[iii].responder.responderNum) == false))
+			{
+				(*errorCnt)++;
+			}
+			liveDone_uS	=	GetMicroSecs() - startTime;
+		}
+	}
+	//*	the hung device is last, it still holds up the next pass by the time out
+	return(liveDone_uS);
+}
+
+//*****************************************************************************
+//*	posts to every device and waits for the ones that answer
+//*****************************************************************************
+static uint64_t	RunPass_AlpacaPoll(int *errorCnt, int *skippedCnt)
+{
+SJP_Parser_t			jsonParser;
+TYPE_AlpacaPollReply	*pollReply;
+char					urlString[64];
+bool					gotReply[kMaxBenchDevices + 1];
+uint64_t				startTime;
+uint64_t				elapsed_uS;
+int						pendingCnt;
+int						iii;
+
+	startTime	=	GetMicroSecs();
+	pendingCnt	=	0;
+	for (iii=0; iii<(gDeviceCnt + (gIncludeHungDevice ? 1 : 0)); iii++)
+	{
+		gotReply[iii]	=	true;
+		sprintf(urlString, "/api/v1/switch/%d/readall", gDevices[iii].responder.responderNum);
+		if (AlpacaPoll_PostRequest(gDevices[iii].pollHandle, urlString, iii))
+		{
+			if (gDevices[iii].responder.neverAnswers == false)
+			{
+				gotReply[iii]	=	false;
+				pendingCnt++;
+			}
+		}
+		else
+		{
+			//*	still waiting on the last one, which is what happens to the hung device
+			(*skippedCnt)++;
+		}
+	}
+
+	elapsed_uS	=	0;
+	while ((pendingCnt > 0) && (elapsed_uS < ((kAlpacaPoll_TimeOut_ms + 1000) * 1000)))
+	{
+		for (iii=0; iii<gDeviceCnt; iii++)
+		{
+			pollReply	=	AlpacaPoll_GetReply(gDevices[iii].pollHandle);
+			if (pollReply != NULL)
+			{
+				if (gotReply[iii] == false)
+				{
+					gotReply[iii]	=	true;
+					pendingCnt--;
+				}
+				SJP_Init(&jsonParser);
+				if ((pollReply->validData == false) || (pollReply->httpStatus != 200) ||
+					(pollReply->requestTag != iii) ||
+					(SJP_ParseDataInPlace(&jsonParser, pollReply->replyData, pollReply->dataLen) != 0) ||
+					(CheckReply(&jsonParser, gDevices[iii].responder.responderNum) == false))
+				{
+					(*errorCnt)++;
+				}
+				AlpacaPoll_ReleaseReply(gDevices[iii].pollHandle, pollReply);
+			}
+		}
+		usleep(200);
+		elapsed_uS	=	GetMicroSecs() - startTime;
+	}
+	*errorCnt	+=	pendingCnt;
+	return(elapsed_uS);
+}
+
+//*****************************************************************************
+static void	PrintPollStats(void)
+{
+TYPE_AlpacaPollStats	pollStats;
+int						iii;
+
+	printf("\n%-8s %8s %8s %8s %8s %8s %8s %8s\n", "device", "requests", "failed", "timeout", "reused", "last ms", "avg ms", "max ms");
+	for (iii=0; iii<(gDeviceCnt + (gIncludeHungDevice ? 1 : 0)); iii++)
+	{
+		AlpacaPoll_GetStats(gDevices[iii].pollHandle, &pollStats);
+		printf("%-8d %8u %8u %8u %8u %8u %8u %8u%s\n",
+					gDevices[iii].responder.responderNum,
+					pollStats.RequestCnt,
+					pollStats.FailureCnt,
+					pollStats.TimeOutCnt,
+					pollStats.ReusedConnCnt,
+					pollStats.LastLatency_ms,
+					pollStats.AvgLatency_ms,
+					pollStats.MaxLatency_ms,
+					(gDevices[iii].responder.neverAnswers ? "   (never answers)" : ""));
+	}
+}
+
+//*****************************************************************************
+static void	PrintHelp(const char *appName)
+{
+	printf("usage: %s [options]\n", appName);
+	printf("\t-n <count>       number of devices (default 8, max %d)\n", kMaxBenchDevices);
+	printf("\t-d <millisecs>   delay before each device answers (default 50)\n");
+	printf("\t-r <count>       number of polling passes (default 3)\n");
+	printf("\t-x               do not include the device that never answers\n");
+}
+
+//*****************************************************************************
+static bool	ProcessCmdLineArgs(int argc, char **argv)
+{
+int			ii;
+char		theChar;
+const char	*argValue;
+
+	ii	=	1;
+	while (ii < argc)
+	{
+		if ((argv[ii][0] == '-') && (argv[ii][1] != 0))
+		{
+			theChar		=	argv[ii][1];
+			argValue	=	NULL;
+			if ((theChar == 'x') || (theChar == 'h'))
+			{
+				//*	no value
+			}
+			else if (argv[ii][2] != 0)
+			{
+				argValue	=	&argv[ii][2];
+			}
+			else if ((ii + 1) < argc)
+			{
+				ii++;
+				argValue	=	argv[ii];
+			}
+			switch(theChar)
+			{
+				case 'n':
+				case 'd':
+				case 'r':
+					if (argValue == NULL)
+					{
+						printf("Option -%c needs a value\n", theChar);
+						return(false);
+					}
+					if (theChar == 'n')
+					{
+						gDeviceCnt		=	atoi(argValue);
+					}
+					else if (theChar == 'd')
+					{
+						gReplyDelay_ms	=	atoi(argValue);
+					}
+					else
+					{
+						gPassCnt		=	atoi(argValue);
+					}
+					break;
+
+				case 'x':
+					gIncludeHungDevice	=	false;
+					break;
+
+				case 'h':
+				default:
+					PrintHelp(argv[0]);
+					return(false);
+			}
+		}
+		else
+		{
+			PrintHelp(argv[0]);
+			return(false);
+		}
+		ii++;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+uint64_t	oneAtATime_uS;
+uint64_t	alpacaPoll_uS;
+int			oneAtATimeErrCnt;
+int			alpacaPollErrCnt;
+int			skippedCnt;
+int			iii;
+
+	if (ProcessCmdLineArgs(argc, argv) == false)
+	{
+		return(1);
+	}
+	if ((gDeviceCnt <= 0) || (gDeviceCnt > kMaxBenchDevices) || (gPassCnt <= 0) || (gReplyDelay_ms < 0))
+	{
+		PrintHelp(argv[0]);
+		return(1);
+	}
+
+	for (iii=0; iii<gDeviceCnt; iii++)
+	{
+		if (BenchResponder_Start(&gDevices[iii].responder, iii, false, gReplyDelay_ms, Device_ReplyProc) == false)
+		{
+			printf("Failed to start loopback device %d\n", iii);
+			return(1);
+		}
+	}
+	if (gIncludeHungDevice && (BenchResponder_Start(&gDevices[gDeviceCnt].responder, gDeviceCnt, true, gReplyDelay_ms, Device_ReplyProc) == false))
+	{
+		printf("Failed to start the device that never answers\n");
+		return(1);
+	}
+	for (iii=0; iii<(gDeviceCnt + (gIncludeHungDevice ? 1 : 0)); iii++)
+	{
+		gDevices[iii].pollHandle	=	AlpacaPoll_Register(&gDevices[iii].responder.deviceAddress, gDevices[iii].responder.port);
+		if (gDevices[iii].pollHandle < 0)
+		{
+			printf("AlpacaPoll_Register() failed\n");
+			return(1);
+		}
+	}
+
+	printf("%d devices, %d ms reply delay%s\n",	gDeviceCnt,
+												gReplyDelay_ms,
+												(gIncludeHungDevice ? ", plus one that never answers" : ""));
+	printf("%-6s %18s %18s %8s\n", "pass", "one at a time ms", "alpacapoll ms", "skipped");
+	oneAtATimeErrCnt	=	0;
+	alpacaPollErrCnt	=	0;
+	for (iii=0; iii<gPassCnt; iii++)
+	{
+		skippedCnt		=	0;
+		oneAtATime_uS	=	RunPass_OneAtATime(&oneAtATimeErrCnt);
+		alpacaPoll_uS	=	RunPass_AlpacaPoll(&alpacaPollErrCnt, &skippedCnt);
+		printf("%-6d %18.1f %18.1f %8d\n",	(iii + 1),
+											(oneAtATime_uS / 1000.0),
+											(alpacaPoll_uS / 1000.0),
+											skippedCnt);
+	}
+
+	if (gIncludeHungDevice)
+	{
+		//*	let the hung request time out so it shows in the stats
+		while (AlpacaPoll_IsBusy(gDevices[gDeviceCnt].pollHandle))
+		{
+			usleep(10000);
+		}
+		AlpacaPoll_ReleaseReply(gDevices[gDeviceCnt].pollHandle, AlpacaPoll_GetReply(gDevices[gDeviceCnt].pollHandle));
+	}
+	PrintPollStats();
+
+	printf("\nErrors: one at a time %d, alpacapoll %d\n", oneAtATimeErrCnt, alpacaPollErrCnt);
+	printf("%s\n", ((oneAtATimeErrCnt == 0) && (alpacaPollErrCnt == 0)) ? "All replies matched" : "FAILED");
+	return(((oneAtATimeErrCnt == 0) && (alpacaPollErrCnt == 0)) ? 0 : 1);
+}
@@ -0,0 +1,191 @@
+//*****************************************************************************
+//*
+//*	Name:			benchresponder.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Fake alpaca device on a loopback port, used by the bench programs
+//*
+//*	Usage notes:	Listens on a loopback port picked by the system and answers every
+//*					request with an HTTP/1.1 keep-alive JSON reply after replyDelay_ms.
+//*					The body is filled in by replyProc so each bench can tag the reply
+//*					with whatever it needs to check that it came from the right place.
+//*					Each connection gets its own thread, so requests to the same responder
+//*					on different connections are answered at the same time.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created benchresponder.c from alpacapollbench.c and discoverybench.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	<pthread.h>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<arpa/inet.h>
+#include	<netinet/in.h>
+
+#include	"benchresponder.h"
+
+//*****************************************************************************
+typedef struct
+{
+	TYPE_BenchResponder	*responder;
+	int					clientSocket;
+} TYPE_BenchConnection;
+
+//*****************************************************************************
+//*	answers requests on one connection until the client closes it
+//*****************************************************************************
+static void	*ConnectionThread(void *arg)
+{
+TYPE_BenchConnection	*connection;
+char					requestBuff[2048];
+char					bodyBuff[256];
+char					replyBuff[512];
+int						requestLen;
+int						recvByteCnt;
+int						replyLen;
+bool					keepGoing;
+
+	connection	=	(TYPE_BenchConnection *)arg;
+	keepGoing	=	true;
+	while (keepGoing)
+	{
+		requestLen		=	0;
+		requestBuff[0]	=	0;
+		while (strstr(requestBuff, "\r\n\r\n") == NULL)
+		{
+			recvByteCnt	=	recv(connection->clientSocket, (requestBuff + requestLen), (sizeof(requestBuff) - 1 - requestLen), 0);
+			if ((recvByteCnt <= 0) || ((requestLen + recvByteCnt) >= (int)(sizeof(requestBuff) - 1)))
+			{
+				keepGoing	=	false;
+				break;
+			}
+			requestLen				+=	recvByteCnt;
+			requestBuff[requestLen]	=	0;
+		}
+		if (keepGoing)
+		{
+			usleep(connection->responder->replyDelay_ms * 1000);
+			bodyBuff[0]	=	0;
+			connection->responder->replyProc(connection->responder, requestBuff, bodyBuff, sizeof(bodyBuff));
+			replyLen	=	snprintf(replyBuff, sizeof(replyBuff),	"HTTP/1.1 200 OK\r\n"
+																	"Content-Type: application/json\r\n"
+																	"Content-Length: %d\r\n"
+																	"Connection: keep-alive\r\n"
+																	"\r\n"
+																	"%s",
+																	(int)strlen(bodyBuff),
+																	bodyBuff);
+			if ((replyLen >= (int)sizeof(replyBuff)) ||
+				(send(connection->clientSocket, replyBuff, replyLen, MSG_NOSIGNAL) != replyLen))
+			{
+				keepGoing	=	false;
+			}
+		}
+	}
+	close(connection->clientSocket);
+	free(connection);
+	return(NULL);
+}
+
+//*****************************************************************************
+static void	*ResponderThread(void *arg)
+{
+TYPE_BenchResponder		*responder;
+TYPE_BenchConnection	*connection;
+int						clientSocket;
+pthread_t				threadID;
+
+	responder	=	(TYPE_BenchResponder *)arg;
+	while ((clientSocket = accept(responder->listenSocket, NULL, NULL)) >= 0)
+	{
+		connection	=	(TYPE_BenchConnection *)malloc(sizeof(TYPE_BenchConnection));
+		if (connection != NULL)
+		{
+			connection->responder		=	responder;
+			connection->clientSocket	=	clientSocket;
+			if (pthread_create(&threadID, NULL, &ConnectionThread, connection) == 0)
+			{
+				pthread_detach(threadID);
+			}
+			else
+			{
+				close(clientSocket);
+				free(connection);
+			}
+		}
+		else
+		{
+			close(clientSocket);
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+bool	BenchResponder_Start(	TYPE_BenchResponder	*responder,
+								const int			responderNum,
+								const bool			neverAnswers,
+								const int			replyDelay_ms,
+								BenchReplyProc		replyProc)
+{
+socklen_t	addrLen;
+pthread_t	threadID;
+bool		startedOK;
+
+	memset(responder, 0, sizeof(TYPE_BenchResponder));
+	responder->responderNum		=	responderNum;
+	responder->neverAnswers		=	neverAnswers;
+	responder->replyDelay_ms	=	replyDelay_ms;
+	responder->replyProc		=	replyProc;
+	startedOK					=	false;
+	responder->listenSocket		=	socket(AF_INET, SOCK_STREAM, 0);
+	if (responder->listenSocket >= 0)
+	{
+		responder->deviceAddress.sin_family			=	AF_INET;
+		responder->deviceAddress.sin_addr.s_addr	=	htonl(INADDR_LOOPBACK);
+		responder->deviceAddress.sin_port			=	0;
+		addrLen										=	sizeof(responder->deviceAddress);
+		if ((bind(responder->listenSocket, (struct sockaddr *)&responder->deviceAddress, sizeof(responder->deviceAddress)) == 0) &&
+			(listen(responder->listenSocket, 8) == 0) &&
+			(getsockname(responder->listenSocket, (struct sockaddr *)&responder->deviceAddress, &addrLen) == 0))
+		{
+			responder->port	=	ntohs(responder->deviceAddress.sin_port);
+			if (neverAnswers)
+			{
+				startedOK	=	true;
+			}
+			else
+			{
+				startedOK	=	(pthread_create(&threadID, NULL, &ResponderThread, responder) == 0);
+			}
+		}
+		else
+		{
+			close(responder->listenSocket);
+			responder->listenSocket	=	-1;
+		}
+	}
+	return(startedOK);
+}
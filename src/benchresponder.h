@@ -0,0 +1,53 @@
+//**************************************************************************
+//*	Name:			benchresponder.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Fake alpaca device on a loopback port, used by the bench programs
+//*
+//*****************************************************************************
+//#include	"benchresponder.h"
+
+#ifndef _BENCHRESPONDER_H_
+#define	_BENCHRESPONDER_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#include	<stddef.h>
+#include	<netinet/in.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+typedef struct TYPE_BenchResponder	TYPE_BenchResponder;
+
+//*	called on the connection thread for every request, fills in the JSON body of the reply
+typedef void (*BenchReplyProc)(TYPE_BenchResponder *responder, const char *requestBuff, char *bodyBuff, const size_t bodyBuffLen);
+
+//*****************************************************************************
+struct TYPE_BenchResponder
+{
+	int					responderNum;
+	int					listenSocket;
+	struct sockaddr_in	deviceAddress;
+	int					port;
+	bool				neverAnswers;
+	int					replyDelay_ms;
+	BenchReplyProc		replyProc;
+};
+
+//*	the responder that never answers is never accept()ed, the connections sit in the backlog
+bool	BenchResponder_Start(	TYPE_BenchResponder	*responder,
+								const int			responderNum,
+								const bool			neverAnswers,
+								const int			replyDelay_ms,
+								BenchReplyProc		replyProc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_BENCHRESPONDER_H_
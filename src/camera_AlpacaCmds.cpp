@@ -3,6 +3,7 @@
 //*		This file is used by both the driver and the controller
 //*****************************************************************************
 //*	Jul  1,	2023	<MLS> Created camera_AlpacaCmds.cpp
+//*	Oct 17,	2026	<MLS> Added mjpeg
 //*****************************************************************************
 
 
@@ -94,6 +95,7 @@ TYPE_CmdEntry	gCameraCmdTable[]	=
 	{	"flip",						kCmd_Camera_flip,					kCmdType_BOTH	},
 	{	"framerate",				kCmd_Camera_framerate,				kCmdType_GET	},
 	{	"livemode",					kCmd_Camera_livemode,				kCmdType_BOTH	},
+	{	"mjpeg",					kCmd_Camera_mjpeg,					kCmdType_GET	},
 	{	"rgbarray",					kCmd_Camera_rgbarray,				kCmdType_GET	},
 	{	"saveallimages",			kCmd_Camera_saveallimages,			kCmdType_BOTH	},
 
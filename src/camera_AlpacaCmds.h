@@ -2,6 +2,7 @@
 //*	camera_AlpacaCmds.h
 //*****************************************************************************
 //*	Jun 30,	2023	<MLS> Created camera_AlpacaCmds.h
+//*	Oct 17,	2026	<MLS> Added kCmd_Camera_mjpeg
 //*****************************************************************************
 //#include	"camera_AlpacaCmds.h"
 
@@ -113,6 +114,7 @@ enum
 	kCmd_Camera_flip,
 	kCmd_Camera_framerate,
 	kCmd_Camera_livemode,
+	kCmd_Camera_mjpeg,
 	kCmd_Camera_rgbarray,
 	kCmd_Camera_settelescopeinfo,
 	kCmd_Camera_saveallimages,
@@ -220,6 +220,31 @@
 //*	Jun 28,	2024	<MLS> Removed all "if (reqData != NULL)" from cameradriver.cpp
 //*	Jul  6,	2024	<EZT> Several fixes dealing with tranmitted data size of binary image data
 //*	Nov 22,	2024	<MLS> Reverted back to 8 bit RGB binary images, need 32 bit official simulator to fully test
+//*	Oct 16,	2026	<MLS> Binary imagearray response is now HTTP/1.1 with keep-alive when possible
+//*	Oct 16,	2026	<MLS> Added frame slot ring, downloads hold a reference to the frame they are sending
+//*	Oct 16,	2026	<MLS> SaveImageData() queues the image for the save writer threads
+//*	Oct 16,	2026	<MLS> Sequence and live mode wait when the save queue is full
+//*	Oct 16,	2026	<MLS> Added save queue statistics to readall
+//*	Oct 16,	2026	<MLS> BuildBinaryImage_xxx() now use the blocked transpose kernels in imagebytes.c
+//*	Oct 16,	2026	<MLS> Get_Imagearray_Binary() streams the image in 1 MB chunks instead of a full frame copy
+//*	Oct 16,	2026	<MLS> Removed BuildBinaryImage_Raw8/16/32/RGB24(), replaced by ImageBytes_TransposeColumns()
+//*	Oct 16,	2026	<MLS> Replaced Send_imagearray_xxx() and Send_RGBarray_xxx() with imagearrayjson.c
+//*	Oct 16,	2026	<MLS> rgbarray RAW16 now uses the high byte of each pixel, it was using the low byte
+//*	Oct 16,	2026	<MLS> Added frame statistics to readall (Get_Readall_FrameStats())
+//*	Oct 16,	2026	<MLS> Put_StartVideo() now starts the video pipeline, added Get_Readall_Video()
+//*	Oct 16,	2026	<MLS> Added Read_VideoFrame(), Take_Video() moved to cameradriver_video.cpp
+//*	Oct 17,	2026	<MLS> Added format=ser option to startvideo
+//*	Oct 17,	2026	<MLS> Added mjpeg command, MJPEG live view stream
+//*	Oct 17,	2026	<MLS> imagearray takes optional startx,starty,numx,numy,bin,binmode,bitdepth
+//*	Oct 17,	2026	<MLS> imagearray bytes sent are now counted in the bandwidth statistics
+//*	Oct 17,	2026	<MLS> Frame slot, download and reduced image buffers now come from imagepool.c
+//*	Oct 17,	2026	<MLS> Added image pool statistics to readall and the stats page
+//*	Oct 17,	2026	<MLS> SendImageChunk() replaced by SocketListen_SendAll()
+//*	Oct 17,	2026	<MLS> imagearray gives up the command lock while the image is being sent
+//*	Oct 17,	2026	<MLS> Frame slots are sized by the image type, the slot count comes from a memory budget
+//*	Oct 17,	2026	<MLS> Automatic image saving is disabled again, as it was before the save writers
+//*	Oct 17,	2026	<MLS> Get_Imagearray_Binary() allocates its buffer before the response is started
+//*	Oct 17,	2026	<MLS> The frame statistics are behind a pointer, a reduced frame on the stack is small
 //*****************************************************************************
 //*	Jan  1,	2119	<TODO> ----------------------------------------
 //*	Jun 26,	2119	<TODO> Add support for sub frames
@@ -239,6 +264,7 @@
 #include	<stdlib.h>
 #include	<string.h>
 #include	<sys/time.h>
+#include	<sys/socket.h>
 #include	<sys/stat.h>
 #include	<sys/types.h>
 #include	<time.h>
@@ -272,6 +298,7 @@
 #endif
 
 #include	"JsonResponse.h"
+#include	"socket_listen.h"
 #include	"eventlogging.h"
 #include	"helper_functions.h"
 
@@ -282,6 +309,9 @@
 #include	"alpacadriver.h"
 #include	"alpacadriver_helper.h"
 #include	"cameradriver.h"
+#include	"imagebytes.h"
+#include	"imagearrayjson.h"
+#include	"imagereduce.h"
 #ifdef _ENABLE_FITS_
 	#include	"cameradriver_auxinfo.h"
 #endif // _ENABLE_FITS_
@@ -442,6 +472,7 @@ CameraDriver::CameraDriver(void)
 	:AlpacaDriver(kDeviceType_Camera)
 {
 int			mkdirErrCode;
+int			iii;
 char		myImageDataDir[]	=	"/media/pi/rpdata/imagedata";
 
 	CONSOLE_DEBUG(__FUNCTION__);
@@ -530,9 +561,87 @@ char		myImageDataDir[]	=	"/media/pi/rpdata/imagedata";
 	//*	init the data buffers to nothing
 	cInternalCameraState			=	kCameraState_Idle;
 	cCameraDataBuffer				=	NULL;
-	cCameraBGRbuffer				=	NULL;
 
 	cCameraDataBuffLen				=	0;
+	memset((void *)cFrameSlot, 0, sizeof(cFrameSlot));
+	for (iii=0; iii<kMaxFrameSlotCnt; iii++)
+	{
+		pthread_mutex_init(&cFrameSlot[iii].statsMutex, NULL);
+	}
+	cFrameSlotCnt					=	kMaxFrameSlotCnt;
+	cFrameSlotMemBudget				=	((sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE)) / 100) * kFrameSlotMemPercent;
+	cReadoutSlotIdx					=	-1;
+	cLatestFrameSlotIdx				=	-1;
+	pthread_mutex_init(&cFrameSlotMutex, NULL);
+	pthread_cond_init(&cFrameSlotReleased, NULL);
+
+	//*	the save writer threads are started when the first image is saved
+	memset((void *)cSaveQueue, 0, sizeof(cSaveQueue));
+	cSaveQueueHead					=	0;
+	cSaveQueueCount					=	0;
+	cSaveJobsActive					=	0;
+	cSaveWriterCnt					=	0;
+	cSaveWriterKeepRunning			=	true;
+	cSaveJobsCompleted				=	0;
+	cSaveJobsDropped				=	0;
+	cSaveWriteLast_us				=	0;
+	cSaveWriteMax_us				=	0;
+	cSaveWriteTotal_us				=	0;
+	cSaveBytesWritten				=	0;
+	pthread_mutex_init(&cSaveQueueMutex, NULL);
+	pthread_cond_init(&cSaveQueueNotEmpty, NULL);
+	pthread_cond_init(&cSaveQueueNotFull, NULL);
+
+	cVideoCreateTimeStampFile		=	true;
+	cVideoTimeStampFilePtr			=	NULL;
+	cVideoFormat					=	kVideoFormat_AVI;
+	memset((void *)&cSERfile, 0, sizeof(cSERfile));
+	cSERfile.fileDesc				=	-1;
+
+	//*	the video frame pool is allocated when video is started
+	memset((void *)cVideoFramePool, 0, sizeof(cVideoFramePool));
+	cVideoFreeCount					=	0;
+	cVideoQueueHead					=	0;
+	cVideoQueueCount				=	0;
+	cVideoQueueHighWater			=	0;
+	cVideoDropBuffer				=	NULL;
+	cVideoFrameSize					=	0;
+	cVideoFrameWidth				=	0;
+	cVideoFrameHeight				=	0;
+	cVideoImageType					=	kImageType_RAW8;
+	cVideoEncoderRunning			=	false;
+	cVideoEncoderKeepRunning		=	false;
+	cVideoFramesEncoded				=	0;
+	cVideoFramesDropped				=	0;
+	cVideoEncodeLast_us				=	0;
+	cVideoEncodeMax_us				=	0;
+	cVideoEncodeTotal_us			=	0;
+	pthread_mutex_init(&cVideoMutex, NULL);
+	pthread_cond_init(&cVideoQueueNotEmpty, NULL);
+
+	//*	MJPEG live view, the encoder thread is started by the first viewer
+	memset((void *)cMJPEGviewer, 0, sizeof(cMJPEGviewer));
+	for (iii=0; iii<kMaxMJPEGviewers; iii++)
+	{
+		cMJPEGviewer[iii].socketFD		=	-1;
+		cMJPEGviewer[iii].cameraDriver	=	this;
+		pthread_cond_init(&cMJPEGviewer[iii].imageReady, NULL);
+	}
+	cMJPEGviewerCnt					=	0;
+	cMJPEGframeSeq					=	0;
+	cMJPEGencoderRunning			=	false;
+	cMJPEGkeepRunning				=	false;
+	cMJPEGframesEncoded				=	0;
+	cMJPEGframesDropped				=	0;
+	cMJPEGviewersTotal				=	0;
+	cMJPEGencodeLast_us				=	0;
+	cMJPEGencodeMax_us				=	0;
+	cMJPEGencodeTotal_us			=	0;
+	cMJPEGrateFrameCnt				=	0;
+	cMJPEGframeRate					=	0.0;
+	gettimeofday(&cMJPEGrateStartTime, NULL);
+	pthread_mutex_init(&cMJPEGmutex, NULL);
+	pthread_cond_init(&cMJPEGnewFrame, NULL);
 	cAutoAdjustExposure				=	gAutoExposure;
 	cAutoAdjustStepSz_us			=	5;
 	cSequenceDelay_us				=	0;
@@ -574,9 +683,6 @@ char		myImageDataDir[]	=	"/media/pi/rpdata/imagedata";
 	cVideoOverlayColor				=	CV_RGB(255,	0,	0);
 	cSideBarBlk						=	CV_RGB(0,	0,	0);
 
-	cVideoCreateTimeStampFile		=	true;
-	cVideoTimeStampFilePtr			=	NULL;
-
 	LoadAlpacaImage();
 #endif // _USE_OPENCV_
 	cAVIfourCC						=	0;
@@ -696,9 +802,43 @@ int	iii;
 //**************************************************************************************
 CameraDriver::~CameraDriver(void)
 {
+int		iii;
+
 	//*	this really never gets called since we dont really have an exit command
 	CONSOLE_DEBUG(__FUNCTION__);
 	Cooler_TurnOff();
+	//*	let the writers finish what is in the queue, they are holding frame slots
+	StopSaveWriterThreads();
+	VideoPipeline_Stop();
+	MJPEG_Stop();
+	for (iii=0; iii<kMaxFrameSlotCnt; iii++)
+	{
+		if (cFrameSlot[iii].dataBuffer != NULL)
+		{
+			ImagePool_Free(cFrameSlot[iii].dataBuffer);
+			cFrameSlot[iii].dataBuffer	=	NULL;
+		}
+		if (cFrameSlot[iii].frameStats != NULL)
+		{
+			free(cFrameSlot[iii].frameStats);
+			cFrameSlot[iii].frameStats	=	NULL;
+		}
+		pthread_mutex_destroy(&cFrameSlot[iii].statsMutex);
+	}
+	cCameraDataBuffer	=	NULL;
+	pthread_cond_destroy(&cFrameSlotReleased);
+	pthread_mutex_destroy(&cFrameSlotMutex);
+	pthread_cond_destroy(&cSaveQueueNotEmpty);
+	pthread_cond_destroy(&cSaveQueueNotFull);
+	pthread_mutex_destroy(&cSaveQueueMutex);
+	pthread_cond_destroy(&cVideoQueueNotEmpty);
+	pthread_mutex_destroy(&cVideoMutex);
+	for (iii=0; iii<kMaxMJPEGviewers; iii++)
+	{
+		pthread_cond_destroy(&cMJPEGviewer[iii].imageReady);
+	}
+	pthread_cond_destroy(&cMJPEGnewFrame);
+	pthread_mutex_destroy(&cMJPEGmutex);
 }
 
 //*****************************************************************************
@@ -1402,6 +1542,18 @@ char				httpHeader[500];
 			}
 			break;
 
+		case kCmd_Camera_mjpeg:
+			if (reqData->get_putIndicator == 'G')
+			{
+				alpacaErrCode	=	Get_MJPEG(reqData, alpacaErrMsg);
+			}
+			else
+			{
+				alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+				GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Put not allowed for mjpeg");
+			}
+			break;
+
 		case kCmd_Camera_saveallimages:
 			if (reqData->get_putIndicator == 'P')
 			{
@@ -4028,265 +4180,8 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_NotImplemented;
 //*****************************************************************************
 //*	returns byte count
 //*****************************************************************************
-int	CameraDriver::BuildBinaryImage_Raw8(	unsigned char 	*binaryDataBuffer,
-											int				startOffset,
-											int				bufferSize)
-{
-int		xxx;
-int		yyy;
-int		ccc;
-int		pixelIndex;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
-	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
-		{
-			pixelIndex	=	xxx;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < bufferSize)
-				{
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth;
-			}
-		}
-	}
-	else
-	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
-	}
-	return(ccc);
-}
-
-//*****************************************************************************
-//*	returns byte count
-//*****************************************************************************
-int	CameraDriver::BuildBinaryImage_Raw8_16bit(	unsigned char	*binaryDataBuffer,
-												int				startOffset,
-												int				bufferSize)
-{
-int		xxx;
-int		yyy;
-int		ccc;
-int		pixelIndex;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
-	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
-		{
-			pixelIndex	=	xxx;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < bufferSize)
-				{
-					//*	its little endian, 16 bit
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-				}
-				else
-				{
-					CONSOLE_DEBUG("Binary data buffer overflow");
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth;
-			}
-		}
-	}
-	else
-	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
-	}
-	return(ccc);
-}
-
-//*****************************************************************************
-//*	returns byte count
-//*****************************************************************************
-int	CameraDriver::BuildBinaryImage_Raw8_32bit(	unsigned char	*binaryDataBuffer,
-												int				startOffset,
-												int				bufferSize)
-{
-int		xxx;
-int		yyy;
-int		ccc;
-int		pixelIndex;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
-	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
-		{
-			pixelIndex	=	xxx;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < bufferSize)
-				{
-					//*	its little endian, 16 bit value in 32 bit word
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	0;
-				}
-				else
-				{
-					CONSOLE_DEBUG("Binary data buffer overflow");
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth;
-			}
-		}
-	}
-	else
-	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
-	}
-	return(ccc);
-}
-
-//*****************************************************************************
-//! \brief BuildBinaryImage_Raw16
-//!
-//! \param foo
-//! \param bar
-//! \return byte count
-//!
-//!
-//*****************************************************************************
-//*	returns byte count
-//*****************************************************************************
-int	CameraDriver::BuildBinaryImage_Raw16(	unsigned char 	*binaryDataBuffer,
-											int				startOffset,
-											int				bufferSize)
-{
-int		xxx;
-int		yyy;
-int		ccc;
-int		pixelIndex;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
-	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
-		{
-			for (yyy=0; yyy<cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				pixelIndex	=	yyy * cLastExposure_ROIinfo.currentROIwidth * 2;
-				pixelIndex	+=	xxx * 2;
-				if (ccc < bufferSize)
-				{
-					//*	the outgoing data is little-endian 16 bit
-					//*	we are converting an 8 bit value to a 16 bit value, unsigned
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex++] & 0x00ff);
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex++] & 0x00ff);
-				}
-
-			//	pixelIndex++;
-			}
-		}
-	}
-	else
-	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
-	}
-	return(ccc);
-}
-
-//*****************************************************************************
-//*	returns byte count
-//*****************************************************************************
-int	CameraDriver::BuildBinaryImage_Raw32(	unsigned char 	*binaryDataBuffer,
-											int				startOffset,
-											int				bufferSize)
-{
-int		xxx;
-int		yyy;
-int		ccc;
-int		pixelIndex;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
-	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
-		{
-			for (yyy=0; yyy<cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				pixelIndex	=	yyy * cLastExposure_ROIinfo.currentROIwidth * 2;
-				pixelIndex	+=	xxx * 2;
-				if (ccc < bufferSize)
-				{
-					//*	the outgoing data is little-endian 32 bit
-					//*	we are converting a 16 bit value to a 32 bit value, unsigned
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex++] & 0x00ff);
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex++] & 0x00ff);
-				}
-
-			//	pixelIndex++;
-			}
-		}
-	}
-	else
-	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
-	}
-	return(ccc);
-}
-
-//*****************************************************************************
-//*	returns byte count
-//*****************************************************************************
-int	CameraDriver::BuildBinaryImage_RGB24(	unsigned char 	*binaryDataBuffer,
-											int				startOffset,
-											int				bufferSize)
-{
-int		xxx;
-int		yyy;
-int		ccc;
-int		pixelIndex;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-
-	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
-	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
-		{
-			pixelIndex	=	xxx * 3;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < bufferSize)
-				{
-					//*	red data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 2] & 0x00ff);
-
-					//*	green data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 1] & 0x00ff);
-
-					//*	blue data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth * 3;
-			}
-		}
-	}
-	else
-	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
-	}
-	return(ccc);
-}
-
-//*****************************************************************************
-//*	returns byte count
-//*****************************************************************************
-int	CameraDriver::BuildBinaryImage_RGB24_32bit(	uint32_t 	*binaryDataBuffer,
+int	CameraDriver::BuildBinaryImage_RGB24_32bit(	TYPE_FrameSlot	*frameSlot,
+												uint32_t 	*binaryDataBuffer,
 												int			startOffset,
 												int			bufferSize)
 {
@@ -4299,33 +4194,33 @@ int		pixelCntMax;
 	CONSOLE_DEBUG(__FUNCTION__);
 
 	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
+	if (frameSlot->dataBuffer != NULL)
 	{
 		pixelCntMax	=	bufferSize / 4;
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+		for (xxx=0; xxx<frameSlot->roiInfo.currentROIwidth; xxx++)
 		{
 			pixelIndex	=	xxx * 3;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
+			for (yyy=0; yyy < frameSlot->roiInfo.currentROIheight; yyy++)
 			{
 				if (ccc < pixelCntMax)
 				{
 					//*	openCV uses BGR instead of RGB
 					//*	red data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 2] & 0x00ff) << 24;
+					binaryDataBuffer[ccc++]	=	(frameSlot->dataBuffer[pixelIndex + 2] & 0x00ff) << 24;
 
 					//*	green data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 1] & 0x00ff) << 24;
+					binaryDataBuffer[ccc++]	=	(frameSlot->dataBuffer[pixelIndex + 1] & 0x00ff) << 24;
 
 					//*	blue data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff) << 24;
+					binaryDataBuffer[ccc++]	=	(frameSlot->dataBuffer[pixelIndex] & 0x00ff) << 24;
 				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth * 3;
+				pixelIndex	+=	frameSlot->roiInfo.currentROIwidth * 3;
 			}
 		}
 	}
 	else
 	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
+		CONSOLE_DEBUG("frameSlot->dataBuffer is NULL");
 	}
 	return(ccc);
 }
@@ -4333,7 +4228,8 @@ int		pixelCntMax;
 //*****************************************************************************
 //*	returns byte count
 //*****************************************************************************
-int	CameraDriver::BuildBinaryImage_RGBx16(	unsigned char 	*binaryDataBuffer,
+int	CameraDriver::BuildBinaryImage_RGBx16(	TYPE_FrameSlot	*frameSlot,
+											unsigned char 	*binaryDataBuffer,
 											int				startOffset,
 											int				bufferSize)
 {
@@ -4345,27 +4241,27 @@ int		pixelIndex;
 	CONSOLE_DEBUG(__FUNCTION__);
 
 	ccc	=	startOffset;
-	for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+	for (xxx=0; xxx<frameSlot->roiInfo.currentROIwidth; xxx++)
 	{
 		pixelIndex	=	xxx * 3;
-		for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
+		for (yyy=0; yyy < frameSlot->roiInfo.currentROIheight; yyy++)
 		{
 			if (ccc < bufferSize)
 			{
 				//*	output data is 16 bit, little endian, we have RGB 24 bit (3 bytes)
 				//*	red data
 				binaryDataBuffer[ccc++]	=	0;
-				binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 2] & 0x00ff);
+				binaryDataBuffer[ccc++]	=	(frameSlot->dataBuffer[pixelIndex + 2] & 0x00ff);
 
 				//*	green data
 				binaryDataBuffer[ccc++]	=	0;
-				binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 1] & 0x00ff);
+				binaryDataBuffer[ccc++]	=	(frameSlot->dataBuffer[pixelIndex + 1] & 0x00ff);
 
 				//*	blue data
 				binaryDataBuffer[ccc++]	=	0;
-				binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
+				binaryDataBuffer[ccc++]	=	(frameSlot->dataBuffer[pixelIndex] & 0x00ff);
 			}
-			pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth * 3;
+			pixelIndex	+=	frameSlot->roiInfo.currentROIwidth * 3;
 		}
 	}
 	return(ccc);
@@ -4389,10 +4285,16 @@ static void	GetAlpacaImageDataTypeString(int dataType, char *dataTypeString)
 	}
 }
 
+//*****************************************************************************
+//*	imagearray binary is converted and sent this many bytes at a time
+#define	kImageBytesChunkSize	(1024 * 1024)
+
 //*****************************************************************************
 //*	https://ascom-standards.org/Developer/AlpacaImageBytes.pdf
 //*****************************************************************************
-TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_Binary(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_Binary(	TYPE_GetPutRequestData	*reqData,
+												char					*alpacaErrMsg,
+												TYPE_FrameSlot			*frameSlot)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InvalidOperation;
 TYPE_BinaryImageHdr	binaryImageHdr;
@@ -4401,14 +4303,20 @@ int					totalPixels;
 int					dataPayloadSize;
 size_t				bufferSize;
 unsigned char 		*binaryDataBuffer;
-int					imgDataOffset;
-size_t				bytesWritten;
+size_t				chunkOffset;
+size_t				columnBytes;
+int					columnsPerChunk;
+int					startColumn;
+int					columnCnt;
+int					imageBytesFormat;
+size_t				totalBytesWritten;
+bool				sendOK;
 char				httpHeader[1024];
 char				lineBuff[128];
 size_t				httpHeaderSize;
-int					returnedDataLen;
 char				dataTypeString[32];
 bool				xmit16BitAs32Bit	=	false;
+TYPE_CmdProcessState	cmdState;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 
@@ -4425,21 +4333,21 @@ bool				xmit16BitAs32Bit	=	false;
 	binaryImageHdr.ImageElementType			=	kAlpacaImageData_Int32;					//	Element type of the source image array
 	binaryImageHdr.TransmissionElementType	=	kAlpacaImageData_UInt16;				//	Element type as sent over the network
 	binaryImageHdr.Rank						=	2;										//	Image array rank
-	binaryImageHdr.Dimension1				=	cLastExposure_ROIinfo.currentROIwidth;	//	Length of image array first dimension
-	binaryImageHdr.Dimension2				=	cLastExposure_ROIinfo.currentROIheight;	//	Length of image array second dimension
+	binaryImageHdr.Dimension1				=	frameSlot->roiInfo.currentROIwidth;	//	Length of image array first dimension
+	binaryImageHdr.Dimension2				=	frameSlot->roiInfo.currentROIheight;	//	Length of image array second dimension
 	binaryImageHdr.Dimension3				=	0;										//	Length of image array third dimension (0 for 2D array)
 
 
 	binaryImageHdr.ClientTransactionID		=	reqData->ClientTransactionID;
 	binaryImageHdr.ServerTransactionID		=	gServerTransactionID;
 
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIimageType\t=",		cLastExposure_ROIinfo.currentROIimageType);
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIwidth\t=",		cLastExposure_ROIinfo.currentROIwidth);
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIheight\t=",	cLastExposure_ROIinfo.currentROIheight);
-	totalPixels		=	cLastExposure_ROIinfo.currentROIwidth * cLastExposure_ROIinfo.currentROIheight;
+	CONSOLE_DEBUG_W_NUM("frameSlot->roiInfo.currentROIimageType\t=",		frameSlot->roiInfo.currentROIimageType);
+	CONSOLE_DEBUG_W_NUM("frameSlot->roiInfo.currentROIwidth\t=",		frameSlot->roiInfo.currentROIwidth);
+	CONSOLE_DEBUG_W_NUM("frameSlot->roiInfo.currentROIheight\t=",	frameSlot->roiInfo.currentROIheight);
+	totalPixels		=	frameSlot->roiInfo.currentROIwidth * frameSlot->roiInfo.currentROIheight;
 	bytesPerPixel	=	6;
 
-	switch(cLastExposure_ROIinfo.currentROIimageType)
+	switch(frameSlot->roiInfo.currentROIimageType)
 	{
 		case kImageType_RAW8:
 		case kImageType_Y8:
@@ -4531,178 +4439,181 @@ bool				xmit16BitAs32Bit	=	false;
 	CONSOLE_DEBUG_W_NUM("totalPixels\t\t=",				totalPixels);
 	CONSOLE_DEBUG_W_NUM("dataPayloadSize\t\t=",			dataPayloadSize);
 
-	//*	time to build the HTTP header
-	strcpy(httpHeader,	"HTTP/1.0 200 OK\r\n");
-	sprintf(lineBuff,	"Content-Length: %d\r\n", dataPayloadSize);
-	strcat(httpHeader,	lineBuff);
-	//*	fix by EZT 7/6/2024
-	strcat(httpHeader,	"Content-type: application/imagebytes\r\n");
-//	strcat(httpHeader,	"Content-type: application/imagebytes; charset=utf-8\r\n");
+	//*	which kernel in imagebytes.c does the conversion
+	imageBytesFormat	=	-1;
+	switch(frameSlot->roiInfo.currentROIimageType)
+	{
+		case kImageType_RAW8:
+		case kImageType_Y8:
+		case kImageType_MONO8:
+			switch (binaryImageHdr.TransmissionElementType)
+			{
+				case kAlpacaImageData_Byte:		imageBytesFormat	=	kImageBytes_Raw8;			break;
+				case kAlpacaImageData_Int16:	imageBytesFormat	=	kImageBytes_Raw8_16bit;		break;
+				case kAlpacaImageData_Int32:	imageBytesFormat	=	kImageBytes_Raw8_32bit;		break;
+				default:
+					CONSOLE_DEBUG_W_NUM("Image type not handled:", binaryImageHdr.TransmissionElementType);
+					break;
+			}
+			break;
 
-	strcat(httpHeader,	"Server: AlpacaPi\r\n");
-	strcat(httpHeader, "\r\n");
+		case kImageType_RAW16:
+			imageBytesFormat	=	xmit16BitAs32Bit ? kImageBytes_Raw16_32bit : kImageBytes_Raw16;
+			break;
 
-	httpHeaderSize	=	strlen(httpHeader);
+		case kImageType_RGB24:
+			//*	fix by EZT 7/6/2024
+			imageBytesFormat	=	kImageBytes_BGR24_RGB;
+			break;
 
-	bufferSize		=	httpHeaderSize + dataPayloadSize;
+		default:
+			CONSOLE_DEBUG_W_NUM("frameSlot->roiInfo.currentROIimageType\t=",	frameSlot->roiInfo.currentROIimageType);
+			CONSOLE_DEBUG_W_NUM("frameSlot->roiInfo.currentROIwidth    \t=",	frameSlot->roiInfo.currentROIwidth);
+			CONSOLE_DEBUG_W_NUM("frameSlot->roiInfo.currentROIheight   \t=",	frameSlot->roiInfo.currentROIheight);
+			break;
+	}
+	CONSOLE_DEBUG_W_NUM("imageBytesFormat\t\t=",	imageBytesFormat);
 
 	//--------------------------------------------------------------------
-	//*	make sure we have valid data
-	if ((cCameraDataBuffer != NULL) && (totalPixels > 0))
-	{
-		//*	allocate one big buffer and put the entire image into it
-		binaryDataBuffer	=	(unsigned char *)calloc((bufferSize + 1000), 1);
-		if (binaryDataBuffer != NULL)
+	//*	make sure we have valid data and a buffer before anything is sent,
+	//*	until the response is started the error still goes out as a normal JSON reply
+	binaryDataBuffer	=	NULL;
+	if ((frameSlot->dataBuffer != NULL) && (totalPixels > 0))
+	{
+		//*	the image is converted and sent a few columns at a time,
+		//*	the buffer only has to hold one chunk no matter how big the sensor is.
+		//*	send() returns as soon as the chunk is in the socket buffer,
+		//*	so the next chunk gets converted while the kernel is sending this one
+		columnBytes		=	(size_t)frameSlot->roiInfo.currentROIheight * bytesPerPixel;
+		if (binaryImageHdr.Dimension3 != 0)
 		{
-			//*	copy the HTTP header
-			memcpy(binaryDataBuffer, httpHeader, httpHeaderSize);
-
-//			CONSOLE_DEBUG_W_STR("binaryDataBuffer\t=",			binaryDataBuffer);
-			//*	copy over the header
-			memcpy(&binaryDataBuffer[httpHeaderSize], &binaryImageHdr, sizeof(TYPE_BinaryImageHdr));
-
-			//*	imgDataOffset is the index to put the image data
-			imgDataOffset		=	httpHeaderSize;
-			imgDataOffset		+=	sizeof(TYPE_BinaryImageHdr);
+			columnBytes	*=	binaryImageHdr.Dimension3;
+		}
+		if ((imageBytesFormat >= 0) &&
+			(columnBytes != ((size_t)frameSlot->roiInfo.currentROIheight * ImageBytes_GetOutputBytesPerPixel(imageBytesFormat))))
+		{
+			CONSOLE_DEBUG_W_NUM("Header does not match the conversion, imageBytesFormat\t=", imageBytesFormat);
+			imageBytesFormat	=	-1;
+		}
+		columnsPerChunk	=	kImageBytesChunkSize / columnBytes;
+		if (columnsPerChunk < 1)
+		{
+			columnsPerChunk	=	1;
+		}
+		if (columnsPerChunk > frameSlot->roiInfo.currentROIwidth)
+		{
+			columnsPerChunk	=	frameSlot->roiInfo.currentROIwidth;
+		}
+		//*	the HTTP header is not built yet, leave room for the largest one
+		bufferSize			=	sizeof(httpHeader) + sizeof(TYPE_BinaryImageHdr) + (columnsPerChunk * columnBytes);
+		CONSOLE_DEBUG_W_NUM("columnsPerChunk\t\t=",	columnsPerChunk);
+		CONSOLE_DEBUG_W_SIZE("bufferSize\t\t=",		bufferSize);
 
-			CONSOLE_DEBUG_W_SIZE("httpHeaderSize             \t=",	httpHeaderSize);
-			CONSOLE_DEBUG_W_SIZE("sizeof(TYPE_BinaryImageHdr)\t=",	sizeof(TYPE_BinaryImageHdr));
-			CONSOLE_DEBUG_W_NUM("imgDataOffset               \t=",	imgDataOffset);
+		binaryDataBuffer	=	(unsigned char *)ImagePool_Alloc(bufferSize);
+		if (binaryDataBuffer == NULL)
+		{
+			CONSOLE_DEBUG_W_SIZE("Failed to allocate data buffer of size", bufferSize);
+			alpacaErrCode	=	kASCOM_Err_FailedUnknown;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to allocate the image send buffer");
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG("Image does not exist");
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Image data does not exist");
+	}
 
-			//*	now copy the image over
-			returnedDataLen	=	0;
-			CONSOLE_DEBUG_W_NUM("currentROIimageType    \t=",	cLastExposure_ROIinfo.currentROIimageType);
-			CONSOLE_DEBUG_W_NUM("TransmissionElementType\t=",	binaryImageHdr.TransmissionElementType);
+	if (binaryDataBuffer != NULL)
+	{
+		//*	time to build the HTTP header
+		strcpy(httpHeader,	"HTTP/1.1 200 OK\r\n");
+		sprintf(lineBuff,	"Content-Length: %d\r\n", dataPayloadSize);
+		strcat(httpHeader,	lineBuff);
+		//*	fix by EZT 7/6/2024
+		strcat(httpHeader,	"Content-type: application/imagebytes\r\n");
+	//	strcat(httpHeader,	"Content-type: application/imagebytes; charset=utf-8\r\n");
 
-			switch(cLastExposure_ROIinfo.currentROIimageType)
-			{
-				case kImageType_RAW8:
-				case kImageType_Y8:
-				case kImageType_MONO8:
-					CONSOLE_DEBUG("kImageType_RAW8");
-					switch (binaryImageHdr.TransmissionElementType)
-					{
-						case kAlpacaImageData_Byte:
-							returnedDataLen	=	BuildBinaryImage_Raw8(binaryDataBuffer, imgDataOffset, bufferSize);
-							break;
-
-						case kAlpacaImageData_Int16:
-							returnedDataLen	=	BuildBinaryImage_Raw8_16bit(binaryDataBuffer, imgDataOffset, bufferSize);
-							break;
-
-						case kAlpacaImageData_Int32:
-							returnedDataLen	=	BuildBinaryImage_Raw8_32bit(binaryDataBuffer, imgDataOffset, bufferSize);
-							break;
-
-						default:
-							CONSOLE_DEBUG_W_NUM("Image type not handled:", binaryImageHdr.TransmissionElementType);
-							returnedDataLen	=	0;
-							break;
-					}
-					CONSOLE_DEBUG_W_SIZE("bufferSize     \t\t=",	bufferSize);
-					CONSOLE_DEBUG_W_NUM( "returnedDataLen\t\t=",	returnedDataLen);
-					break;
+		strcat(httpHeader,	"Server: AlpacaPi\r\n");
+		//*	the Content-Length is exact, the connection can be reused
+		if (SocketListen_StartFramedResponse(reqData->socket))
+		{
+			strcat(httpHeader,	"Connection: keep-alive\r\n");
+		}
+		else
+		{
+			strcat(httpHeader,	"Connection: close\r\n");
+		}
+		strcat(httpHeader, "\r\n");
 
-				case kImageType_RAW16:
-					CONSOLE_DEBUG("kImageType_RAW16");
-					if (xmit16BitAs32Bit)
-					{
-						returnedDataLen	=	BuildBinaryImage_Raw32(binaryDataBuffer, imgDataOffset, bufferSize);
-					}
-					else
-					{
-						returnedDataLen	=	BuildBinaryImage_Raw16(binaryDataBuffer, imgDataOffset, bufferSize);
-					}
-					break;
+		httpHeaderSize	=	strlen(httpHeader);
 
-				case kImageType_RGB24:
-					//*	fix by EZT 7/6/2024
-					CONSOLE_DEBUG("kImageType_RGB24");
-					//if (bytesPerPixel == 3)
-					//{
-					//	returnedDataLen	=	BuildBinaryImage_RGB24(binaryDataBuffer, imgDataOffset, bufferSize);
-					//}
-					//else
-					//{
-					//+	binaryImageHdr.TransmissionElementType	=	kAlpacaImageData_Int32;	//	Element type as sent over the network
-					//+	returnedDataLen	=	BuildBinaryImage_RGB24_32bit((uint32_t *)binaryDataBuffer, imgDataOffset, bufferSize);
-						returnedDataLen	=	BuildBinaryImage_RGB24(binaryDataBuffer, imgDataOffset, bufferSize);
-					//}
-					break;
+		//*	the HTTP header and the ImageBytes header go out with the first chunk
+		memcpy(binaryDataBuffer, httpHeader, httpHeaderSize);
+		memcpy(&binaryDataBuffer[httpHeaderSize], &binaryImageHdr, sizeof(TYPE_BinaryImageHdr));
+		chunkOffset			=	httpHeaderSize + sizeof(TYPE_BinaryImageHdr);
 
-				default:
-					CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIimageType\t=",	cLastExposure_ROIinfo.currentROIimageType);
-					CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIwidth    \t=",	cLastExposure_ROIinfo.currentROIwidth);
-					CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIheight   \t=",	cLastExposure_ROIinfo.currentROIheight);
-				//	CONSOLE_ABORT(__FUNCTION__);
-					returnedDataLen	=	0;
-					break;
+		totalBytesWritten	=	0;
+		sendOK				=	true;
+		startColumn			=	0;
+		//*	the frame slot is held, camerastate/abortexposure etc can run while this is sent
+		ReleaseCmdProcessLock(&cmdState);
+		while (sendOK && (startColumn < frameSlot->roiInfo.currentROIwidth))
+		{
+			columnCnt	=	frameSlot->roiInfo.currentROIwidth - startColumn;
+			if (columnCnt > columnsPerChunk)
+			{
+				columnCnt	=	columnsPerChunk;
 			}
-
-			CONSOLE_DEBUG_W_SIZE("bufferSize\t\t=", bufferSize);
-			//*	if the data buffer is small, send it as one block
-		//	if (bufferSize < (20 * 1000000))
-			if (1)
+			if (imageBytesFormat >= 0)
 			{
-				CONSOLE_DEBUG_W_SIZE("Writting to TCP socket, bufferSize\t=", bufferSize);
-				bytesWritten	=	write(reqData->socket, binaryDataBuffer, bufferSize);
-				CONSOLE_DEBUG_W_SIZE("bytesWritten\t\t=", bytesWritten);
-				if (bytesWritten < bufferSize)
-				{
-					CONSOLE_DEBUG("FAILED!!! to transmit entire data block!!!!!!!!!!!!!!!");
-				}
-				else
-				{
-					alpacaErrCode	=	kASCOM_Err_Success;
-				}
+				ImageBytes_TransposeColumns(&binaryDataBuffer[chunkOffset],
+											frameSlot->dataBuffer,
+											frameSlot->roiInfo.currentROIwidth,
+											frameSlot->roiInfo.currentROIheight,
+											startColumn,
+											columnCnt,
+											imageBytesFormat);
 			}
 			else
 			{
-			//*	send the data as multiple blocks
-			size_t			totalBytesWritten;
-			size_t			bytesPerBlock;
-			size_t			dataLeftToSend;
-			unsigned char 	*dataPointer;
-
-				CONSOLE_DEBUG("transmitting image data in blocks");
-			#define		kXmitBlockSize	(2 * 1000000)
-				totalBytesWritten	=	0;
-				dataPointer			=	binaryDataBuffer;
-				while (totalBytesWritten < bufferSize)
-				{
-					dataLeftToSend		=	bufferSize - totalBytesWritten;
-					if (dataLeftToSend > kXmitBlockSize)
-					{
-						bytesPerBlock	=	kXmitBlockSize;
-					}
-					else
-					{
-						bytesPerBlock	=	dataLeftToSend;
-					}
-					CONSOLE_DEBUG_W_SIZE("write() bytesPerBlock\t\t=", bytesPerBlock);
-					bytesWritten		=	write(reqData->socket, dataPointer, bytesPerBlock);
-					totalBytesWritten	+=	bytesWritten;
-					dataPointer			+=	bytesWritten;
-
-					CONSOLE_DEBUG_W_SIZE("bytesWritten\t\t=", bytesWritten);
-				}
+				//*	the Content-Length has been promised, unknown image types get zeros
+				memset(&binaryDataBuffer[chunkOffset], 0, (columnCnt * columnBytes));
+			}
+			sendOK				=	SocketListen_SendAll(reqData->socket, binaryDataBuffer, (chunkOffset + (columnCnt * columnBytes)));
+			if (sendOK)
+			{
+				totalBytesWritten	+=	chunkOffset + (columnCnt * columnBytes);
 			}
-			free(binaryDataBuffer);
+			chunkOffset			=	0;
+			startColumn			+=	columnCnt;
+		}
+		RetakeCmdProcessLock(&cmdState);
+		CONSOLE_DEBUG_W_SIZE("totalBytesWritten\t=", totalBytesWritten);
+		cBytesWrittenForThisCmd	+=	totalBytesWritten;
+		if (sendOK)
+		{
+			alpacaErrCode	=	kASCOM_Err_Success;
 		}
 		else
 		{
-			CONSOLE_DEBUG_W_SIZE("Failed to allocate data buffer of size", bufferSize);
+			CONSOLE_DEBUG("FAILED!!! to transmit entire data block!!!!!!!!!!!!!!!");
+			SocketListen_UnframedResponse(reqData->socket);
 		}
+		ImagePool_Free(binaryDataBuffer);
 	}
 	else
 	{
-		CONSOLE_DEBUG("Image does not exist");
+		//*	nothing has been sent, let the caller send the error as JSON
+		cSendJSONresponse	=	true;
+		cHttpHeaderSent		=	false;
 	}
 	return(alpacaErrCode);
 }
 
 //*****************************************************************************
-TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_JSON(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_JSON(	TYPE_GetPutRequestData	*reqData,
+												char					*alpacaErrMsg,
+												TYPE_FrameSlot			*frameSlot)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
 TYPE_ASCOM_STATUS	tempErrCode;
@@ -4711,7 +4622,10 @@ int					mySocket;
 char				imageTimeString[64];
 double				exposureTimeSecs;
 int					imgRank;
+int					jsonFormat;
+long				jsonBytesSent;
 char				httpHeader[500];
+TYPE_CmdProcessState	cmdState;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 //	CONSOLE_DEBUG_W_STR("htmlData\t=",		reqData->htmlData);
@@ -4726,7 +4640,7 @@ char				httpHeader[500];
 
 	//========================================================================================
 	//*	record the time the image was taken
-	FormatTimeString_time_t(&cCameraProp.Lastexposure_StartTime.tv_sec, imageTimeString);
+	FormatTimeString_time_t(&frameSlot->exposureStartTime.tv_sec, imageTimeString);
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(mySocket,
 									reqData->jsonTextBuffer,
 									kMaxJsonBuffLen,
@@ -4736,7 +4650,7 @@ char				httpHeader[500];
 
 	//========================================================================================
 	//*	record the exposure time
-	exposureTimeSecs	=	(cCameraProp.Lastexposure_duration_us * 1.0) /
+	exposureTimeSecs	=	(frameSlot->exposureDuration_us * 1.0) /
 							1000000.0;
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
 									reqData->jsonTextBuffer,
@@ -4764,19 +4678,19 @@ char				httpHeader[500];
 
 	//*	get the ROI information which has the current image type
 //	GetImage_ROI_info();
-	pixelCount	=	cLastExposure_ROIinfo.currentROIwidth * cLastExposure_ROIinfo.currentROIheight;
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIwidth\t=",		cLastExposure_ROIinfo.currentROIwidth);
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIheight\t=",	cLastExposure_ROIinfo.currentROIheight);
+	pixelCount	=	frameSlot->roiInfo.currentROIwidth * frameSlot->roiInfo.currentROIheight;
+	CONSOLE_DEBUG_W_NUM("frameSlot->roiInfo.currentROIwidth\t=",		frameSlot->roiInfo.currentROIwidth);
+	CONSOLE_DEBUG_W_NUM("frameSlot->roiInfo.currentROIheight\t=",	frameSlot->roiInfo.currentROIheight);
 	CONSOLE_DEBUG_W_NUM("pixelCount\t=", pixelCount);
 
 	CONSOLE_DEBUG_W_NUM("cCameraProp.ImageReady\t=", cCameraProp.ImageReady);
-//	CONSOLE_DEBUG_W_HEX("cCameraDataBuffer\t=", cCameraDataBuffer);
-	if (cCameraProp.ImageReady && (cCameraDataBuffer != NULL))
+//	CONSOLE_DEBUG_W_HEX("frameSlot->dataBuffer\t=", frameSlot->dataBuffer);
+	if (frameSlot->dataBuffer != NULL)
 	{
 		alpacaErrCode	=	kASCOM_Err_Success;
 		//========================================================================================
 		//*	record the image type
-//+			Read_ImageTypeString(cLastExposure_ROIinfo.currentROIimageType, asiImageTypeString);
+//+			Read_ImageTypeString(frameSlot->roiInfo.currentROIimageType, asiImageTypeString);
 //+			cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(mySocket,
 //+									reqData->jsonTextBuffer,
 //+									kMaxJsonBuffLen,
@@ -4788,14 +4702,14 @@ char				httpHeader[500];
 										reqData->jsonTextBuffer,
 										kMaxJsonBuffLen,
 										"xsize",
-										cLastExposure_ROIinfo.currentROIwidth,
+										frameSlot->roiInfo.currentROIwidth,
 										INCLUDE_COMMA);
 
 		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(mySocket,
 										reqData->jsonTextBuffer,
 										kMaxJsonBuffLen,
 										"ysize",
-										cLastExposure_ROIinfo.currentROIheight,
+										frameSlot->roiInfo.currentROIheight,
 										INCLUDE_COMMA);
 
 //		CONSOLE_DEBUG(__FUNCTION__);
@@ -4808,7 +4722,7 @@ char				httpHeader[500];
 										INCLUDE_COMMA);
 
 		//*	determine the RANK of the image we are about to send.
-		switch(cLastExposure_ROIinfo.currentROIimageType)
+		switch(frameSlot->roiInfo.currentROIimageType)
 		{
 			case kImageType_RGB24:
 				imgRank	=	3;
@@ -4838,42 +4752,44 @@ char				httpHeader[500];
 		JsonResponse_SendTextBuffer(mySocket, reqData->jsonTextBuffer);
 
 		CONSOLE_DEBUG_W_NUM("pixelCount\t=", pixelCount);
-		switch(cLastExposure_ROIinfo.currentROIimageType)
+		jsonFormat	=	-1;
+		switch(frameSlot->roiInfo.currentROIimageType)
 		{
 			case kImageType_RAW8:
 			case kImageType_Y8:
 			case kImageType_MONO8:
-				CONSOLE_DEBUG("kImageType_RAW8");
-				Send_imagearray_raw8(	mySocket,
-										cCameraDataBuffer,
-										cLastExposure_ROIinfo.currentROIheight,		//*	# of rows
-										cLastExposure_ROIinfo.currentROIwidth,		//*	# of columns
-										pixelCount);
+				jsonFormat	=	kImageArrayJSON_Raw8;
 				break;
 
 			case kImageType_RAW16:
-				CONSOLE_DEBUG("kImageType_RAW16");
-				Send_imagearray_raw16(	mySocket,
-										(uint16_t *)cCameraDataBuffer,
-										cLastExposure_ROIinfo.currentROIheight,		//*	# of rows
-										cLastExposure_ROIinfo.currentROIwidth,		//*	# of columns
-										pixelCount);
+				jsonFormat	=	kImageArrayJSON_Raw16;
 				break;
 
 			case kImageType_RGB24:
-				CONSOLE_DEBUG("kImageType_RGB24");
-
-				Send_imagearray_rgb24(	mySocket,
-										cCameraDataBuffer,
-										cLastExposure_ROIinfo.currentROIheight,		//*	# of rows
-										cLastExposure_ROIinfo.currentROIwidth,		//*	# of columns
-										pixelCount);
+				jsonFormat	=	kImageArrayJSON_BGR24;
 				break;
 
-
 			default:
 				break;
 		}
+		if (jsonFormat >= 0)
+		{
+			//*	0 threads = one per cpu
+			//*	the frame slot is held, camerastate/abortexposure etc can run while this is sent
+			ReleaseCmdProcessLock(&cmdState);
+			jsonBytesSent	=	ImageArrayJSON_Send(mySocket,
+													frameSlot->dataBuffer,
+													frameSlot->roiInfo.currentROIwidth,
+													frameSlot->roiInfo.currentROIheight,
+													jsonFormat,
+													0);
+			RetakeCmdProcessLock(&cmdState);
+			CONSOLE_DEBUG_W_LONG("jsonBytesSent\t=", jsonBytesSent);
+			if (jsonBytesSent > 0)
+			{
+				cBytesWrittenForThisCmd	+=	jsonBytesSent;
+			}
+		}
 
 
 		cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayEnd(	mySocket,
@@ -4898,294 +4814,267 @@ char				httpHeader[500];
 }
 
 //*****************************************************************************
-TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+//*	imagearray?startx=1000&starty=800&numx=512&numy=512&bin=2&binmode=sum&bitdepth=8
+//*	all of them are optional, the sub frame is in pixels of the frame that was taken.
+//*	if any of them are there, reducedFrame gets a copy of the frame with its own
+//*	data buffer (the caller has to free it), the frame slot and cLastExposure_ROIinfo are not changed
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_Reduce(	TYPE_GetPutRequestData	*reqData,
+												char					*alpacaErrMsg,
+												TYPE_FrameSlot			*frameSlot,
+												TYPE_FrameSlot			*reducedFrame,
+												bool					*frameWasReduced)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+char				argumentString[32];
+int					startX;
+int					startY;
+int					numX;
+int					numY;
+int					binFactor;
+int					binMode;
+int					srcBitDepth;
+int					dstBitDepth;
+int					srcFormat;
+int					dstWidth;
+int					dstHeight;
+long				bufferSize;
+bool				argumentFound;
+bool				reduceOK;
+
+	*frameWasReduced	=	false;
+	startX				=	0;
+	startY				=	0;
+	numX				=	frameSlot->roiInfo.currentROIwidth;
+	numY				=	frameSlot->roiInfo.currentROIheight;
+	binFactor			=	1;
+	binMode				=	kImageReduce_Mean;
+	argumentFound		=	false;
+
+	switch(frameSlot->roiInfo.currentROIimageType)
+	{
+		case kImageType_RAW8:
+		case kImageType_Y8:
+		case kImageType_MONO8:
+			srcFormat	=	kImageReduce_Mono8;
+			srcBitDepth	=	8;
+			break;
 
-	CONSOLE_DEBUG(__FUNCTION__);
+		case kImageType_RAW16:
+			srcFormat	=	kImageReduce_Mono16;
+			srcBitDepth	=	16;
+			break;
 
-	if (cCameraProp.ImageReady)
+		case kImageType_RGB24:
+			srcFormat	=	kImageReduce_BGR24;
+			srcBitDepth	=	8;
+			break;
+
+		default:
+			srcFormat	=	-1;
+			srcBitDepth	=	8;
+			break;
+	}
+	dstBitDepth	=	srcBitDepth;
+
+	if (GetKeyWordArgument(reqData->contentData, "startx", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		startX			=	atoi(argumentString);
+		argumentFound	=	true;
+	}
+	if (GetKeyWordArgument(reqData->contentData, "starty", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		startY			=	atoi(argumentString);
+		argumentFound	=	true;
+	}
+	//*	the default size is whatever is left after the start
+	numX	-=	startX;
+	numY	-=	startY;
+	if (GetKeyWordArgument(reqData->contentData, "numx", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		numX			=	atoi(argumentString);
+		argumentFound	=	true;
+	}
+	if (GetKeyWordArgument(reqData->contentData, "numy", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		numY			=	atoi(argumentString);
+		argumentFound	=	true;
+	}
+	if (GetKeyWordArgument(reqData->contentData, "bin", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		binFactor		=	atoi(argumentString);
+		argumentFound	=	true;
+	}
+	if (GetKeyWordArgument(reqData->contentData, "binmode", argumentString, (sizeof(argumentString) -1), kIgnoreCase))
 	{
-		if (strcasestr(reqData->htmlData, "application/imagebytes") != NULL)
+		if (strcasecmp(argumentString, "sum") == 0)
 		{
-			alpacaErrCode	=	Get_Imagearray_Binary(reqData, alpacaErrMsg);
+			binMode	=	kImageReduce_Sum;
+		}
+		else if (strcasecmp(argumentString, "mean") == 0)
+		{
+			binMode	=	kImageReduce_Mean;
 		}
 		else
 		{
-			alpacaErrCode	=	Get_Imagearray_JSON(reqData, alpacaErrMsg);
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "binmode must be sum or mean");
 		}
+		argumentFound	=	true;
 	}
-	else
+	if (GetKeyWordArgument(reqData->contentData, "bitdepth", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
 	{
-		alpacaErrCode	=	kASCOM_Err_InvalidOperation;
-		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "No image available");
-
-	}
-	return(alpacaErrCode);
-}
-
-
-//*****************************************************************************
-void	CameraDriver::Send_imagearray_rgb24(	const int		socketFD,
-												unsigned char	*pixelPtr,
-												const int		numRows,
-												const int		numClms,
-												const int		pixelCount)
-{
-unsigned char	*myPixelPtr;
-uint32_t		pixelValue_Red;
-uint32_t		pixelValue_Grn;
-uint32_t		pixelValue_Blu;
-char			lineBuff[256];
-int				xxx;
-int				yyy;
-int				bufLen;
-int				bytesWritten;
-char			longBuffer[1024];
-int				dataElementCnt;
-int				pixelIndex;
-int				totalValuesWritten;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-	CONSOLE_DEBUG_W_NUM("numRows\t=", numRows);
-	CONSOLE_DEBUG_W_NUM("numClms\t=", numClms);
-
-	totalValuesWritten	=	0;
-	myPixelPtr			=	pixelPtr;
-	if (myPixelPtr != NULL)
-	{
-		totalValuesWritten	=	0;
-		dataElementCnt		=	0;
-		longBuffer[0]		=	0;
-		//*	step across from left to right
-		for (xxx=0; xxx < numClms; xxx++)
-		{
-			if ((xxx % 100) == 0)
-			{
-				CONSOLE_DEBUG_W_NUM("xxx\t=", xxx);
-			}
-			strcpy(longBuffer, "[\n");
-			dataElementCnt	=	0;
-			pixelIndex		=	xxx * 3;
-			//*	step through the rows (going from top to bottom)
-			for (yyy=0; yyy < numRows; yyy++)
-			{
-				//*	openCV uses BGR instead of RGB
-				//*	https://docs.opencv.org/master/df/d24/tutorial_js_image_display.html
-				pixelValue_Red		=	((myPixelPtr[pixelIndex + 2] & 0x00ff) << 8);
-				pixelValue_Grn		=	((myPixelPtr[pixelIndex + 1] & 0x00ff) << 8);
-				pixelValue_Blu		=	((myPixelPtr[pixelIndex + 0] & 0x00ff) << 8);
-
-				//	[65535,65535,65535],
-				sprintf(lineBuff, "[%d,%d,%d]", pixelValue_Red, pixelValue_Grn, pixelValue_Blu);
-				if (yyy < (numRows - 1))
-				{
-					strcat(lineBuff, ",");
-				}
-				strcat(longBuffer, lineBuff);
-				dataElementCnt++;
-				if (dataElementCnt >= 50)
-				{
-				//	printf("xxx=%3d\t>>%s\r\n", xxx, longBuffer);
-					strcat(longBuffer, "\n");
-					bufLen			=	strlen(longBuffer);
-					bytesWritten	=	write(socketFD, longBuffer, bufLen);
-					dataElementCnt	=	0;
-					longBuffer[0]	=	0;
-				}
-				//*	advance to the next row
-				pixelIndex	+=	(3 * numClms);
-
-				totalValuesWritten++;
-			}
-			if (xxx < (numClms - 1))
-			{
-				strcat(longBuffer, "],\n");
-			}
-			else
-			{
-				strcat(longBuffer, "]\n");
-			}
-			bufLen			=	strlen(longBuffer);
-			bytesWritten	=	write(socketFD, longBuffer, bufLen);
-			dataElementCnt	=	0;
-			longBuffer[0]	=	0;
-			if (bytesWritten <= 0)
-			{
-				CONSOLE_DEBUG("Write Error");
-			}
+		dstBitDepth		=	atoi(argumentString);
+		argumentFound	=	true;
+		if ((dstBitDepth != 8) && (dstBitDepth != 16))
+		{
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "bitdepth must be 8 or 16");
+		}
+		else if ((srcFormat == kImageReduce_BGR24) && (dstBitDepth != 8))
+		{
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Color images are only available as 8 bit");
 		}
-		CONSOLE_DEBUG(__FUNCTION__);
 	}
-	CONSOLE_DEBUG_W_NUM("totalValuesWritten\t=", totalValuesWritten);
-	CONSOLE_DEBUG("Done");
-}
-
-//*****************************************************************************
-void	CameraDriver::Send_imagearray_raw8(		const int		socketFD,
-												unsigned char	*pixelPtr,
-												const int		numRows,
-												const int		numClms,
-												const int		pixelCount)
-{
-unsigned char	*myPixelPtr;
-int				pixelValue;
-char			lineBuff[256];
-int				xxx;
-int				yyy;
-int				bufLen;
-int				bytesWritten;
-char			longBuffer[2048];
-int				dataElementCnt;
-int				pixelIndex;
-int				totalValuesWritten;
 
-	CONSOLE_DEBUG(__FUNCTION__);
-	CONSOLE_DEBUG_W_NUM("numRows\t=", numRows);
-	CONSOLE_DEBUG_W_NUM("numClms\t=", numClms);
-
-	totalValuesWritten	=	0;
-	myPixelPtr			=	pixelPtr;
-	if (myPixelPtr != NULL)
+	if ((alpacaErrCode == kASCOM_Err_Success) && argumentFound)
 	{
-		totalValuesWritten	=	0;
-		dataElementCnt		=	0;
-		longBuffer[0]		=	0;
-		//*	Alpaca JSON has column order first, i.e. all the pixels down the first column, then then the 2nd column etc...
-		for (xxx=0; xxx < numClms; xxx++)
+		if (srcFormat < 0)
 		{
-			if ((xxx % 500) == 0)
-			{
-				CONSOLE_DEBUG_W_NUM("xxx\t=", xxx);
-			}
-
-			strcpy(longBuffer, "[");
-			dataElementCnt	=	0;
-			pixelIndex		=	xxx;
-			//*	stop at n-1 so we can do the last one without a comma
-			for (yyy=0; yyy < (numRows - 1); yyy++)
-			{
-				pixelValue		=	((myPixelPtr[pixelIndex] & 0x00ff) << 8);
-				sprintf(lineBuff, "%d,", pixelValue);
-				strcat(longBuffer, lineBuff);
-				bufLen	=	strlen(longBuffer);
-
-				dataElementCnt++;
-				if (dataElementCnt >= 100)
-				{
-					strcat(longBuffer, "\n");
-					bufLen			=	strlen(longBuffer);
-					bytesWritten	=	write(socketFD, longBuffer, bufLen);
-					dataElementCnt	=	0;
-					longBuffer[0]	=	0;
-				}
-				pixelIndex	+=	numClms;
+			alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Image type can not be reduced");
+		}
+		else if ((binFactor < 1) || (binFactor > kImageReduce_MaxBin))
+		{
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "bin must be 1 to 16");
+		}
+		else if ((startX < 0) || (startY < 0) || (numX < binFactor) || (numY < binFactor) ||
+				((startX + numX) > frameSlot->roiInfo.currentROIwidth) ||
+				((startY + numY) > frameSlot->roiInfo.currentROIheight))
+		{
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Sub frame is outside of the image");
+		}
+	}
 
-				totalValuesWritten++;
-			}
-			//*	now do the last one WITHOUT the comma
-			pixelValue		=	((myPixelPtr[pixelIndex] & 0x00ff) << 8);
-			sprintf(lineBuff, "%d]", pixelValue);
-			totalValuesWritten++;
-			if (xxx < (numClms - 1))
+	//*	nothing to do if they asked for the whole frame the way it is
+	if ((alpacaErrCode == kASCOM_Err_Success) && argumentFound &&
+		((startX != 0) || (startY != 0) ||
+		(numX != frameSlot->roiInfo.currentROIwidth) || (numY != frameSlot->roiInfo.currentROIheight) ||
+		(binFactor != 1) || (dstBitDepth != srcBitDepth)))
+	{
+		dstWidth	=	numX / binFactor;
+		dstHeight	=	numY / binFactor;
+		bufferSize	=	(long)dstWidth * dstHeight * ImageReduce_GetOutputBytesPerPixel(srcFormat, dstBitDepth);
+
+		memset((void *)reducedFrame, 0, sizeof(TYPE_FrameSlot));
+		reducedFrame->dataBuffer			=	(unsigned char *)ImagePool_Alloc(bufferSize);
+		reducedFrame->dataBuffLen			=	bufferSize;
+		reducedFrame->frameNumber			=	frameSlot->frameNumber;
+		reducedFrame->exposureStartTime		=	frameSlot->exposureStartTime;
+		reducedFrame->exposureEndTime		=	frameSlot->exposureEndTime;
+		reducedFrame->exposureDuration_us	=	frameSlot->exposureDuration_us;
+		reducedFrame->roiInfo				=	frameSlot->roiInfo;
+		reducedFrame->roiInfo.currentROIwidth	=	dstWidth;
+		reducedFrame->roiInfo.currentROIheight	=	dstHeight;
+		reducedFrame->roiInfo.currentROIbin		=	frameSlot->roiInfo.currentROIbin * binFactor;
+		if (srcFormat != kImageReduce_BGR24)
+		{
+			reducedFrame->roiInfo.currentROIimageType	=	(dstBitDepth == 16) ? kImageType_RAW16 : kImageType_RAW8;
+			if ((dstBitDepth == 8) && (srcBitDepth == 8))
 			{
-				strcat(lineBuff, ",");
+				//*	keep Y8/MONO8
+				reducedFrame->roiInfo.currentROIimageType	=	frameSlot->roiInfo.currentROIimageType;
 			}
-			strcat(lineBuff, "\n");
+		}
 
-			strcat(longBuffer, lineBuff);
-			bufLen			=	strlen(longBuffer);
-			bytesWritten	=	write(socketFD, longBuffer, bufLen);
-			if (bytesWritten <= 0)
+		reduceOK	=	false;
+		if (reducedFrame->dataBuffer != NULL)
+		{
+			reduceOK	=	ImageReduce_Frame(	frameSlot->dataBuffer,
+												frameSlot->roiInfo.currentROIwidth,
+												frameSlot->roiInfo.currentROIheight,
+												srcFormat,
+												startX,
+												startY,
+												numX,
+												numY,
+												binFactor,
+												binMode,
+												dstBitDepth,
+												reducedFrame->dataBuffer);
+		}
+		if (reduceOK)
+		{
+			*frameWasReduced	=	true;
+			CONSOLE_DEBUG_W_LONG("Reduced image size\t=", bufferSize);
+		}
+		else
+		{
+			if (reducedFrame->dataBuffer != NULL)
 			{
-				CONSOLE_DEBUG("Write Error");
+				ImagePool_Free(reducedFrame->dataBuffer);
+				reducedFrame->dataBuffer	=	NULL;
 			}
+			alpacaErrCode	=	kASCOM_Err_InternalError;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to create the reduced image");
 		}
 	}
-	CONSOLE_DEBUG_W_NUM("totalValuesWritten\t=", totalValuesWritten);
-	CONSOLE_DEBUG("Done");
+	return(alpacaErrCode);
 }
 
-
 //*****************************************************************************
-void	CameraDriver::Send_imagearray_raw16(	const int	socketFD,
-												uint16_t	*pixelPtr,
-												const int	numRows,
-												const int	numClms,
-												const int	pixelCount)
+TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
 {
-uint16_t		*myPixelPtr;
-uint32_t		pixelValue;
-char			lineBuff[256];
-int				xxx;
-int				yyy;
-int				bufLen;
-int				bytesWritten;
-char			longBuffer[1024];
-int				dataElementCnt;
-int				pixelIndex;
-int				totalValuesWritten;
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+TYPE_FrameSlot		*frameSlot;
+TYPE_FrameSlot		reducedFrame;
+TYPE_FrameSlot		*sendFrame;
+bool				frameWasReduced;
 
 	CONSOLE_DEBUG(__FUNCTION__);
-	CONSOLE_DEBUG_W_NUM("numRows\t=", numRows);
-	CONSOLE_DEBUG_W_NUM("numClms\t=", numClms);
 
-	totalValuesWritten	=	0;
-	myPixelPtr			=	pixelPtr;
-	if (myPixelPtr != NULL)
+	//*	hold a reference to the frame so the camera can not read into it while we are sending it
+	frameSlot	=	NULL;
+	if (cCameraProp.ImageReady)
+	{
+		frameSlot	=	AcquireLatestFrame();
+	}
+	if (frameSlot != NULL)
 	{
-		totalValuesWritten	=	0;
-		dataElementCnt		=	0;
-		longBuffer[0]		=	0;
-		for (xxx=0; xxx < numClms; xxx++)
+		alpacaErrCode	=	Get_Imagearray_Reduce(reqData, alpacaErrMsg, frameSlot, &reducedFrame, &frameWasReduced);
+		if (alpacaErrCode == kASCOM_Err_Success)
 		{
-			if ((xxx % 500) == 0)
-			{
-				CONSOLE_DEBUG_W_NUM("xxx\t=", xxx);
-			}
-			strcpy(longBuffer, "[");
-			dataElementCnt	=	0;
-			pixelIndex		=	xxx;
-			//*	stop at n-1 so we can do the last one without a comma
-			for (yyy=0; yyy < (numRows - 1); yyy++)
-			{
-				pixelValue		=	((myPixelPtr[pixelIndex] & 0x0ffff));
-				sprintf(lineBuff, "%d,", pixelValue);
-				strcat(longBuffer, lineBuff);
-				dataElementCnt++;
-				if (dataElementCnt >= 100)
-				{
-					strcat(longBuffer, "\n");
-					bufLen			=	strlen(longBuffer);
-					bytesWritten	=	write(socketFD, longBuffer, bufLen);
-					dataElementCnt	=	0;
-					longBuffer[0]	=	0;
-				}
-				pixelIndex	+=	numClms;
-
-				totalValuesWritten++;
-			}
-			//*	now do the last one WITHOUT the comma
-			pixelValue		=	((myPixelPtr[pixelIndex] & 0x0ffff));
-			sprintf(lineBuff, "%d]", pixelValue);
-			totalValuesWritten++;
-			if (xxx < (numClms - 1))
+			sendFrame	=	frameWasReduced ? &reducedFrame : frameSlot;
+			if (strcasestr(reqData->htmlData, "application/imagebytes") != NULL)
 			{
-				strcat(lineBuff, ",");
+				alpacaErrCode	=	Get_Imagearray_Binary(reqData, alpacaErrMsg, sendFrame);
 			}
-			strcat(lineBuff, "\n");
-
-			strcat(longBuffer, lineBuff);
-			bufLen			=	strlen(longBuffer);
-			bytesWritten	=	write(socketFD, longBuffer, bufLen);
-			if (bytesWritten <= 0)
+			else
 			{
-				CONSOLE_DEBUG("Write Error");
+				alpacaErrCode	=	Get_Imagearray_JSON(reqData, alpacaErrMsg, sendFrame);
 			}
 		}
+		else
+		{
+			//*	nothing has been sent yet, the error needs the normal header
+			cHttpHeaderSent	=	false;
+		}
+		if (frameWasReduced)
+		{
+			ImagePool_Free(reducedFrame.dataBuffer);
+		}
+		ReleaseFrame(frameSlot);
+	}
+	else
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "No image available");
+
 	}
-	CONSOLE_DEBUG_W_NUM("totalValuesWritten\t=", totalValuesWritten);
-	CONSOLE_DEBUG("Done");
+	return(alpacaErrCode);
 }
 
 
@@ -5197,15 +5086,14 @@ TYPE_ASCOM_STATUS	CameraDriver::Get_RGBarray(TYPE_GetPutRequestData *reqData, ch
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
 int					pixelCount;
-int					pixelLimit;
-int					iii;
 int					mySocket;
 unsigned char		*pixelPtr;
-uint32_t			pixelValue;
-char				lineBuff[256];
+int					jsonFormat;
+long				jsonBytesSent;
 char				imageTimeString[256];
 double				exposureTimeSecs;
 TYPE_ASCOM_STATUS	tempSensorErr;
+TYPE_FrameSlot		*frameSlot;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	gImageDownloadInProgress	=	true;
@@ -5254,17 +5142,25 @@ TYPE_ASCOM_STATUS	tempSensorErr;
 
 		}
 	}
-	//*	get the ROI information which has the current image type
-	GetImage_ROI_info();
-	pixelCount	=	cROIinfo.currentROIwidth * cROIinfo.currentROIheight;
+	//*	the ROI information that goes with the image is kept in the frame slot
+	frameSlot	=	NULL;
+	pixelCount	=	0;
+	if (cCameraProp.ImageReady)
+	{
+		frameSlot	=	AcquireLatestFrame();
+	}
+	if (frameSlot != NULL)
+	{
+		pixelCount	=	frameSlot->roiInfo.currentROIwidth * frameSlot->roiInfo.currentROIheight;
+	}
 	CONSOLE_DEBUG_W_NUM("pixelCount\t=", pixelCount);
 
 	CONSOLE_DEBUG_W_NUM("cCameraProp.ImageReady\t=", cCameraProp.ImageReady);
-	if (cCameraProp.ImageReady && (cCameraDataBuffer != NULL))
+	if ((frameSlot != NULL) && (frameSlot->dataBuffer != NULL))
 	{
 		//========================================================================================
 		//*	record the image type
-//+			Read_ImageTypeString(cROIinfo.currentROIimageType, asiImageTypeString);
+//+			Read_ImageTypeString(frameSlot->roiInfo.currentROIimageType, asiImageTypeString);
 //+			cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(mySocket,
 //+									reqData->jsonTextBuffer,
 //+									kBuffSize_MaxSpeed,
@@ -5276,14 +5172,14 @@ TYPE_ASCOM_STATUS	tempSensorErr;
 										reqData->jsonTextBuffer,
 										kBuffSize_MaxSpeed,
 										"xsize",
-										cROIinfo.currentROIwidth,
+										frameSlot->roiInfo.currentROIwidth,
 										INCLUDE_COMMA);
 
 		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(mySocket,
 										reqData->jsonTextBuffer,
 										kBuffSize_MaxSpeed,
 										"ysize",
-										cROIinfo.currentROIheight,
+										frameSlot->roiInfo.currentROIheight,
 										INCLUDE_COMMA);
 
 //		CONSOLE_DEBUG(__FUNCTION__);
@@ -5306,90 +5202,42 @@ TYPE_ASCOM_STATUS	tempSensorErr;
 										reqData->jsonTextBuffer,
 										kBuffSize_MaxSpeed,
 										gValueString);
-		pixelPtr	=	cCameraDataBuffer;
+		pixelPtr	=	frameSlot->dataBuffer;
 		CONSOLE_DEBUG_W_NUM("pixelCount\t=", pixelCount);
 
 		//*	Flush the json buffer
 		JsonResponse_SendTextBuffer(mySocket, reqData->jsonTextBuffer);
 
-		//====================================================================
-		//*	this is broken up the way it is to increase transmission speed
-		iii		=	0;
-		switch(cROIinfo.currentROIimageType)
+		jsonFormat	=	-1;
+		switch(frameSlot->roiInfo.currentROIimageType)
 		{
-			//====================================================================
 			case kImageType_RGB24:
-				Send_RGBarray_rgb24(mySocket, pixelPtr, pixelCount);
+				jsonFormat	=	kImageArrayJSON_RGB_BGR24;
 				break;
 
-			//====================================================================
 			case kImageType_RAW8:
 			case kImageType_MONO8:
-				CONSOLE_DEBUG("kImageType_RAW8");
-				Send_RGBarray_raw8(mySocket, pixelPtr, pixelCount);
+			case kImageType_Y8:
+				jsonFormat	=	kImageArrayJSON_RGB_Gray8;
 				break;
 
-			//====================================================================
 			case kImageType_RAW16:
-				CONSOLE_DEBUG("kImageType_RAW16");
-				pixelLimit	=	pixelCount - 1;
-				iii	=	0;
-				while (iii < pixelLimit)
-				{
-					pixelValue		=	(pixelPtr[0] & 0x00ff);
-					pixelValue		=	pixelValue * 0x010101;
-					pixelPtr		+=	2;
-					sprintf(lineBuff, "%d,\n", pixelValue);
-					cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocket,
-													reqData->jsonTextBuffer,
-													kBuffSize_MaxSpeed,
-													lineBuff);
-					iii++;
-				}
-				//*	now do the last one WITHOUT the comma
-				pixelValue		=	(pixelPtr[0] & 0x00ff);
-				pixelValue		=	pixelValue * 0x010101;
-				pixelPtr		+=	2;
-				sprintf(lineBuff, "%d\n", pixelValue);
-				cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocket,
-												reqData->jsonTextBuffer,
-												kBuffSize_MaxSpeed,
-												lineBuff);
-				break;
-
-			//====================================================================
-			case kImageType_Y8:
-				CONSOLE_DEBUG("kImageType_Y8");
-				pixelLimit	=	pixelCount - 1;
-				iii	=	0;
-				while (iii < pixelLimit)
-				{
-					pixelValue		=	(pixelPtr[0] & 0x00ff);
-					pixelValue		=	pixelValue * 0x010101;
-					pixelPtr		+=	1;
-					sprintf(lineBuff, "%d,\n", pixelValue);
-					cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocket,
-													reqData->jsonTextBuffer,
-													kBuffSize_MaxSpeed,
-													lineBuff);
-					iii++;
-				}
-				//*	now do the last one WITHOUT the comma
-				pixelValue		=	(pixelPtr[0] & 0x00ff);
-				pixelValue		=	pixelValue * 0x010101;
-				pixelPtr		+=	1;
-				sprintf(lineBuff, "%d\n", pixelValue);
-				cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocket,
-												reqData->jsonTextBuffer,
-												kBuffSize_MaxSpeed,
-												lineBuff);
+				jsonFormat	=	kImageArrayJSON_RGB_Gray16;
 				break;
 
-			//====================================================================
 			case kImageType_Invalid:
 			case kImageType_last:
 				break;
-
+		}
+		if (jsonFormat >= 0)
+		{
+			jsonBytesSent	=	ImageArrayJSON_Send(mySocket,
+													pixelPtr,
+													frameSlot->roiInfo.currentROIwidth,
+													frameSlot->roiInfo.currentROIheight,
+													jsonFormat,
+													0);
+			CONSOLE_DEBUG_W_LONG("jsonBytesSent\t=", jsonBytesSent);
 		}
 
 
@@ -5406,153 +5254,12 @@ TYPE_ASCOM_STATUS	tempSensorErr;
 		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "No image available");
 	}
 //	CONSOLE_DEBUG_W_STR(__FUNCTION__, "--exit");
-	gImageDownloadInProgress	=	false;
-	return(alpacaErrCode);
-}
-
-//*****************************************************************************
-void	CameraDriver::Send_RGBarray_rgb24(	const int		socketFD,
-											unsigned char	*pixelPtr,
-											const int		pixelCount)
-{
-unsigned char	*myPixelPtr;
-uint32_t		pixelValue;
-char			lineBuff[512];
-int				pixelLimit;
-int				iii;
-int				bufLen;
-int				bytesWritten;
-int				totalBytesWritten;
-char			longBuffer[2048];
-int				dataElementCnt;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-
-	pixelLimit			=	pixelCount - 1;
-	myPixelPtr			=	pixelPtr;
-	totalBytesWritten	=	0;
-	if (myPixelPtr != NULL)
-	{
-		longBuffer[0]	=	0;
-		dataElementCnt	=	0;
-		for (iii=0; iii < pixelLimit; iii++)
-		{
-			if ((iii % 50000) == 0)
-			{
-				CONSOLE_DEBUG_W_NUM("iii\t=", iii);
-			}
-
-			pixelValue		=	((myPixelPtr[0] & 0x00ff) << 16);
-			pixelValue		+=	((myPixelPtr[1] & 0x00ff) << 8);
-			pixelValue		+=	((myPixelPtr[2] & 0x00ff));
-
-			myPixelPtr		+=	3;
-
-			sprintf(lineBuff, "%d,\n", pixelValue);
-			strcat(longBuffer, lineBuff);
-			dataElementCnt++;
-			if (dataElementCnt >= 50)
-			{
-				strcat(longBuffer, "\n");
-				bufLen				=	strlen(longBuffer);
-
-				bytesWritten		=	write(socketFD, longBuffer, bufLen);
-				totalBytesWritten	+=	bytesWritten;
-				dataElementCnt		=	0;
-				longBuffer[0]		=	0;
-			}
-		}
-		CONSOLE_DEBUG("Main loop Done");
-		//*	now do the last one WITHOUT the comma
-		pixelValue		=	(myPixelPtr[0] << 16) +
-							(myPixelPtr[1] << 8) +
-							(myPixelPtr[2]);
-		sprintf(lineBuff, "%d", pixelValue);
-		strcat(longBuffer, lineBuff);
-		strcat(longBuffer, "\n");
-		bufLen				=	strlen(longBuffer);
-		CONSOLE_DEBUG_W_NUM("bufLen\t=", bufLen);
-		bytesWritten		=	write(socketFD, longBuffer, bufLen);
-		totalBytesWritten	+=	bytesWritten;
-
-		CONSOLE_DEBUG_W_NUM("totalBytesWritten\t=", totalBytesWritten);
-	}
-	else
-	{
-		CONSOLE_DEBUG("myPixelPtr is NULL");
-	}
-
-
-	CONSOLE_DEBUG("Done");
-
-}
-
-//*****************************************************************************
-void	CameraDriver::Send_RGBarray_raw8(	const int		socketFD,
-											unsigned char	*pixelPtr,
-											const int		pixelCount)
-{
-uint32_t		pixelValue;
-char			lineBuff[256];
-int				pixelLimit;
-int				iii;
-int				bufLen;
-int				bytesWritten;
-char			longBuffer[2000];
-int				dataElementCnt;
-
-	CONSOLE_DEBUG(__FUNCTION__);
-	CONSOLE_DEBUG_W_NUM("pixelCount\t=", pixelCount);
-
-	pixelLimit	=	pixelCount - 1;
-	if (pixelPtr != NULL)
-	{
-		longBuffer[0]	=	0;
-		dataElementCnt	=	0;
-		for (iii=0; iii < pixelLimit; iii++)
-		{
-			if ((iii % 500000) == 0)
-			{
-				CONSOLE_DEBUG_W_NUM("iii\t=", iii);
-			}
-			pixelValue		=	(pixelPtr[iii] & 0x00ff);
-			pixelValue		=	pixelValue * 0x010101;
-			sprintf(lineBuff, "%d,\n", pixelValue);
-//			sprintf(lineBuff, "%d,", pixelValue);
-			strcat(longBuffer, lineBuff);
-			dataElementCnt++;
-			if (dataElementCnt >= 25)
-			{
-				bufLen			=	strlen(longBuffer);
-				bytesWritten	=	write(socketFD, longBuffer, bufLen);
-				dataElementCnt	=	0;
-				longBuffer[0]	=	0;
-			}
-		}
-		CONSOLE_DEBUG("Main loop Done");
-		//*	now do the last one WITHOUT the comma
-		pixelValue		=	(pixelPtr[iii] & 0x00ff);
-		pixelValue		=	pixelValue * 0x010101;
-		pixelPtr		+=	1;
-		sprintf(lineBuff, "%d", pixelValue);
-		strcat(longBuffer, lineBuff);
-
-		strcat(longBuffer, "\n");
-		bufLen			=	strlen(longBuffer);
-		bytesWritten	=	write(socketFD, longBuffer, bufLen);
-		if (bytesWritten <= 0)
-		{
-			CONSOLE_DEBUG("Write Error");
-		}
-		dataElementCnt	=	0;
-	}
-	else
+	if (frameSlot != NULL)
 	{
-		CONSOLE_DEBUG("pixelPtr is NULL");
-
+		ReleaseFrame(frameSlot);
 	}
-	CONSOLE_DEBUG("Done");
-
+	gImageDownloadInProgress	=	false;
+	return(alpacaErrCode);
 }
 
 //*****************************************************************************
@@ -6263,60 +5970,253 @@ double				deltaExp_secs;
 }
 
 //*****************************************************************************
-//*	if buffer size is <= zero, figure out the size
+//*	the number of bytes in one frame at the current ROI and image type
 //*****************************************************************************
-bool	CameraDriver::AllocateImageBuffer(long bufferSize)
+long	CameraDriver::GetFrameBufferSize(void)
 {
-int32_t		myBufferSize;
-bool		successFlag;
-
-//	CONSOLE_DEBUG(__FUNCTION__);
+long	pixelCount;
+int		bytesPerPixel;
 
-	successFlag			=	false;
-	if (bufferSize > 0)
+	if ((cROIinfo.currentROIwidth > 0) && (cROIinfo.currentROIheight > 0))
 	{
-		myBufferSize	=	bufferSize;
+		pixelCount	=	(long)cROIinfo.currentROIwidth * cROIinfo.currentROIheight;
 	}
 	else
 	{
-		myBufferSize	=	cCameraProp.CameraXsize * cCameraProp.CameraYsize * 4;
-	}
-	if ((cCameraDataBuffer != NULL) && (myBufferSize <= cCameraDataBuffLen))
-	{
-		//*	everything is OK
-//		CONSOLE_DEBUG_W_LONG("everything is OK, current buff size\t=", cCameraDataBuffLen);
-		successFlag			=	true;
+		pixelCount	=	(long)cCameraProp.CameraXsize * cCameraProp.CameraYsize;
 	}
-	else
+	switch(cROIinfo.currentROIimageType)
 	{
-		if (cCameraDataBuffer != NULL)
-		{
-			CONSOLE_DEBUG("Freeing existing buffer");
-			//*	buffer is not big enough, free it so we can allocate a new one
-			free(cCameraDataBuffer);
-			cCameraDataBuffer	=	NULL;
-			cCameraDataBuffLen	=	0;
-		}
+		case kImageType_RAW8:
+		case kImageType_Y8:
+		case kImageType_MONO8:
+			bytesPerPixel	=	1;
+			break;
 
-		CONSOLE_DEBUG_W_NUM("myBufferSize\t=", myBufferSize);
-		cCameraDataBuffer	=	(unsigned char *)malloc(myBufferSize + 128);
-		if (cCameraDataBuffer != NULL)
-		{
-			CONSOLE_DEBUG("cCameraDataBuffer allocated");
-			cCameraDataBuffLen	=	myBufferSize;
-			successFlag			=	true;
-		}
-		else
-		{
-			CONSOLE_DEBUG("cCameraDataBuffer FAILED");
-			cCameraDataBuffLen	=	0;
-			successFlag			=	false;
+		case kImageType_RAW16:
+			bytesPerPixel	=	2;
+			break;
+
+		case kImageType_RGB24:
+		default:
+			//*	the image type is not known yet, use the largest one
+			bytesPerPixel	=	3;
+			break;
+	}
+	return(pixelCount * bytesPerPixel);
+}
+
+//*****************************************************************************
+//*	if buffer size is <= zero, figure out the size
+//*
+//*	The camera always reads into a slot that no download is using and that
+//*	is not the latest frame, cCameraDataBuffer is pointed at that slot.
+//*	The slot stays the readout slot until PublishFrameSlot() is called,
+//*	so calling this more than once for the same frame is OK.
+//*
+//*	Only as many slots as fit in cFrameSlotMemBudget are used,
+//*	an idle slot above that gives its buffer back to the pool.
+//*****************************************************************************
+bool	CameraDriver::AllocateImageBuffer(long bufferSize)
+{
+long			myBufferSize;
+bool			successFlag;
+int				iii;
+int				waitRetCode;
+struct timespec	waitUntil;
+TYPE_FrameSlot	*frameSlot;
+unsigned char	*unusedBuffers[kMaxFrameSlotCnt];
+int				unusedBuffCnt;
+
+//	CONSOLE_DEBUG(__FUNCTION__);
+
+	successFlag			=	false;
+	if (bufferSize > 0)
+	{
+		myBufferSize	=	bufferSize;
+	}
+	else
+	{
+		myBufferSize	=	GetFrameBufferSize();
+	}
+
+	//*	find a free slot to read into
+	unusedBuffCnt	=	0;
+	pthread_mutex_lock(&cFrameSlotMutex);
+	if (cReadoutSlotIdx < 0)
+	{
+		cFrameSlotCnt	=	kMaxFrameSlotCnt;
+		if (myBufferSize > 0)
+		{
+			cFrameSlotCnt	=	cFrameSlotMemBudget / myBufferSize;
+		}
+		if (cFrameSlotCnt < kMinFrameSlotCnt)
+		{
+			cFrameSlotCnt	=	kMinFrameSlotCnt;
+		}
+		if (cFrameSlotCnt > kMaxFrameSlotCnt)
+		{
+			cFrameSlotCnt	=	kMaxFrameSlotCnt;
+		}
+		for (iii=cFrameSlotCnt; iii<kMaxFrameSlotCnt; iii++)
+		{
+			if ((iii != cLatestFrameSlotIdx) && (cFrameSlot[iii].refCount == 0) && (cFrameSlot[iii].dataBuffer != NULL))
+			{
+				unusedBuffers[unusedBuffCnt++]	=	cFrameSlot[iii].dataBuffer;
+				cFrameSlot[iii].dataBuffer		=	NULL;
+				cFrameSlot[iii].dataBuffLen		=	0;
+			}
+		}
+
+		clock_gettime(CLOCK_REALTIME, &waitUntil);
+		waitUntil.tv_sec	+=	kFrameSlotWait_Secs;
+		waitRetCode			=	0;
+		while ((cReadoutSlotIdx < 0) && (waitRetCode == 0))
+		{
+			for (iii=0; iii<cFrameSlotCnt; iii++)
+			{
+				if ((iii != cLatestFrameSlotIdx) && (cFrameSlot[iii].refCount == 0))
+				{
+					cReadoutSlotIdx	=	iii;
+					break;
+				}
+			}
+			if (cReadoutSlotIdx < 0)
+			{
+				//*	every slot is being downloaded, wait for one to be released
+				CONSOLE_DEBUG("Waiting for a free frame slot");
+				waitRetCode	=	pthread_cond_timedwait(&cFrameSlotReleased, &cFrameSlotMutex, &waitUntil);
+			}
 		}
 	}
+	frameSlot	=	NULL;
+	if (cReadoutSlotIdx >= 0)
+	{
+		frameSlot	=	&cFrameSlot[cReadoutSlotIdx];
+	}
+	pthread_mutex_unlock(&cFrameSlotMutex);
+
+	for (iii=0; iii<unusedBuffCnt; iii++)
+	{
+		ImagePool_Free(unusedBuffers[iii]);
+	}
+
+	//*	nobody else can get to the readout slot, it is OK to work on it without the lock
+	if (frameSlot == NULL)
+	{
+		CONSOLE_DEBUG("No free frame slot, all frames are being downloaded");
+		cCameraDataBuffer	=	NULL;
+		cCameraDataBuffLen	=	0;
+	}
+	else if ((frameSlot->dataBuffer != NULL) && (myBufferSize <= frameSlot->dataBuffLen) && (frameSlot->dataBuffLen <= (myBufferSize * 2)))
+	{
+		//*	everything is OK
+//		CONSOLE_DEBUG_W_LONG("everything is OK, current buff size\t=", frameSlot->dataBuffLen);
+		successFlag			=	true;
+	}
+	else
+	{
+		if (frameSlot->dataBuffer != NULL)
+		{
+			CONSOLE_DEBUG("Freeing existing buffer");
+			//*	buffer is not big enough (or far too big for the budget), give it back to the pool
+			ImagePool_Free(frameSlot->dataBuffer);
+			frameSlot->dataBuffer	=	NULL;
+			frameSlot->dataBuffLen	=	0;
+		}
+
+		CONSOLE_DEBUG_W_LONG("myBufferSize\t=", myBufferSize);
+		frameSlot->dataBuffer	=	(unsigned char *)ImagePool_Alloc(myBufferSize + 128);
+		if (frameSlot->dataBuffer != NULL)
+		{
+			CONSOLE_DEBUG("cCameraDataBuffer allocated");
+			frameSlot->dataBuffLen	=	myBufferSize;
+			successFlag				=	true;
+		}
+		else
+		{
+			CONSOLE_DEBUG("cCameraDataBuffer FAILED");
+			frameSlot->dataBuffLen	=	0;
+			successFlag				=	false;
+		}
+	}
+	if (frameSlot != NULL)
+	{
+		cCameraDataBuffer	=	frameSlot->dataBuffer;
+		cCameraDataBuffLen	=	frameSlot->dataBuffLen;
+	}
 //	CONSOLE_DEBUG(__FUNCTION__);
 	return(successFlag);
 }
 
+//*****************************************************************************
+//*	the readout slot becomes the latest frame,
+//*	called after Read_ImageData() was successful.
+//*	cCameraDataBuffer still points to it for the saving and display code
+//*****************************************************************************
+void	CameraDriver::PublishFrameSlot(void)
+{
+TYPE_FrameSlot	*frameSlot;
+
+	pthread_mutex_lock(&cFrameSlotMutex);
+	if (cReadoutSlotIdx >= 0)
+	{
+		frameSlot						=	&cFrameSlot[cReadoutSlotIdx];
+		frameSlot->frameNumber			=	cFramesRead;
+		frameSlot->roiInfo				=	cLastExposure_ROIinfo;
+		frameSlot->exposureStartTime	=	cCameraProp.Lastexposure_StartTime;
+		frameSlot->exposureEndTime		=	cCameraProp.Lastexposure_EndTime;
+		frameSlot->exposureDuration_us	=	cCameraProp.Lastexposure_duration_us;
+		//*	new data, the statistics get calculated again when they are asked for
+		if (frameSlot->frameStats != NULL)
+		{
+			frameSlot->frameStats->valid	=	false;
+		}
+
+		cLatestFrameSlotIdx				=	cReadoutSlotIdx;
+		cReadoutSlotIdx					=	-1;
+	}
+	pthread_mutex_unlock(&cFrameSlotMutex);
+
+	//*	only wakes up the live view encoder, it does the work on its own thread
+	MJPEG_NewFrame();
+}
+
+//*****************************************************************************
+//*	returns the latest frame with a reference held, NULL if there is none.
+//*	every non NULL return must be matched with ReleaseFrame()
+//*****************************************************************************
+TYPE_FrameSlot	*CameraDriver::AcquireLatestFrame(void)
+{
+TYPE_FrameSlot	*frameSlot;
+
+	frameSlot	=	NULL;
+	pthread_mutex_lock(&cFrameSlotMutex);
+	if ((cLatestFrameSlotIdx >= 0) && (cFrameSlot[cLatestFrameSlotIdx].dataBuffer != NULL))
+	{
+		frameSlot	=	&cFrameSlot[cLatestFrameSlotIdx];
+		frameSlot->refCount++;
+	}
+	pthread_mutex_unlock(&cFrameSlotMutex);
+	return(frameSlot);
+}
+
+//*****************************************************************************
+void	CameraDriver::ReleaseFrame(TYPE_FrameSlot *frameSlot)
+{
+	pthread_mutex_lock(&cFrameSlotMutex);
+	if (frameSlot->refCount > 0)
+	{
+		frameSlot->refCount--;
+	}
+	else
+	{
+		CONSOLE_DEBUG("Frame slot released too many times");
+	}
+	pthread_cond_signal(&cFrameSlotReleased);
+	pthread_mutex_unlock(&cFrameSlotMutex);
+}
+
 
 
 #pragma mark -
@@ -6327,6 +6227,8 @@ TYPE_ASCOM_STATUS	CameraDriver::Put_StartVideo(TYPE_GetPutRequestData *reqData,
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_NotImplemented;
 char				recordTimeStr[32];
 bool				recTimeFound;
+char				videoFormatStr[32];
+bool				videoFormatOK;
 int					videoIsColor;
 char				filePath[128];
 #ifdef _USE_OPENCV_
@@ -6346,153 +6248,206 @@ char				filePath[128];
 											kArgumentIsNumeric);
 //		CONSOLE_DEBUG_W_NUM("cInternalCameraState\t=", cInternalCameraState);
 
-	switch(cInternalCameraState)
+	//*	format=ser writes the raw frames, format=avi goes through openCV, it stays set for the next video
+	videoFormatOK	=	true;
+	if (GetKeyWordArgument(reqData->contentData, "format", videoFormatStr, (sizeof(videoFormatStr) -1)))
 	{
-		case kCameraState_Idle:
-			CONSOLE_DEBUG("kCameraState_Idle");
-			cCameraProp.SavedImageCnt	=	0;		//*	start video
-			cNumVideoFramesSaved		=	0;
-			cFrameRate					=	0;
+		if (strcasecmp(videoFormatStr, "ser") == 0)
+		{
+			cVideoFormat	=	kVideoFormat_SER;
+		}
+		else if (strcasecmp(videoFormatStr, "avi") == 0)
+		{
+			cVideoFormat	=	kVideoFormat_AVI;
+		}
+		else
+		{
+			videoFormatOK	=	false;
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Invalid video format, must be avi or ser");
+		}
+	}
 
-			if (recTimeFound)
-			{
-				cNumFramesToSave	=	0;
-				cVideoDuration_secs	=	AsciiToDouble(recordTimeStr);
-			}
-			else
-			{
-				cNumFramesToSave	=	500;
-				cVideoDuration_secs	=	0;
-			}
-			CONSOLE_DEBUG_W_DBL("cVideoDuration_secs\t=", cVideoDuration_secs);
-			CONSOLE_DEBUG_W_NUM("cNumFramesToSave\t=", cNumFramesToSave);
+	if (videoFormatOK)
+	{
+		switch(cInternalCameraState)
+		{
+			case kCameraState_Idle:
+				CONSOLE_DEBUG("kCameraState_Idle");
+				cCameraProp.SavedImageCnt	=	0;		//*	start video
+				cNumVideoFramesSaved		=	0;
+				cFrameRate					=	0;
 
-			alpacaErrCode			=	Start_Video();
-			CONSOLE_DEBUG_W_NUM("Start_Video() returned:\t=", alpacaErrCode);
-			if (alpacaErrCode == 0)
-			{
-				videoIsColor		=	1;
-				GenerateFileNameRoot();
-				strcpy(filePath, gImageDataDir);
-				strcat(filePath, "/");
-				strcat(filePath, cFileNameRoot);
-				strcat(filePath, ".avi");
+				if (recTimeFound)
+				{
+					cNumFramesToSave	=	0;
+					cVideoDuration_secs	=	AsciiToDouble(recordTimeStr);
+				}
+				else
+				{
+					cNumFramesToSave	=	500;
+					cVideoDuration_secs	=	0;
+				}
+				CONSOLE_DEBUG_W_DBL("cVideoDuration_secs\t=", cVideoDuration_secs);
+				CONSOLE_DEBUG_W_NUM("cNumFramesToSave\t=", cNumFramesToSave);
 
-				//	http://www.fourcc.org/codecs.php
-				switch(cROIinfo.currentROIimageType)
+				alpacaErrCode			=	Start_Video();
+				CONSOLE_DEBUG_W_NUM("Start_Video() returned:\t=", alpacaErrCode);
+				if (alpacaErrCode == 0)
 				{
-					case kImageType_RGB24:
-					//	CV_FOURCC_DEFAULT,
-					//	CV_FOURCC('M', 'J', 'L', 'S'),
-					//	CV_FOURCC('M', 'J', 'P', 'G'),		//*	MJPG -> motion jpeg
-					//	CV_FOURCC('P', 'I', 'M', '1'),		//*	MPEG-1
-					//	fourCC	=	CV_FOURCC('R', 'G', 'B', '8');
-					//	fourCC	=	CV_FOURCC('M', 'P', '4', '2');		//*	MP42 -> MPEG-4  WORKS!!
-					//
-					//	-1,									//*	user selectable dialog box
-			#ifdef _USE_OPENCV_
+					videoIsColor		=	1;
+					GenerateFileNameRoot();
+					if (cVideoFormat == kVideoFormat_SER)
+					{
+						//*	raw frames straight from the camera, no encoding
+						strcpy(filePath, gImageDataDir);
+						strcat(filePath, "/");
+						strcat(filePath, cFileNameRoot);
+						strcat(filePath, ".ser");
+						if (VideoPipeline_CreateSERfile(filePath) == false)
+						{
+							Stop_Video();
+							cInternalCameraState	=	kCameraState_Idle;
+							alpacaErrCode			=	kASCOM_Err_FailedToTakePicture;
+							GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to create SER file");
+						}
+					}
+					else
+					{
+						strcpy(filePath, gImageDataDir);
+						strcat(filePath, "/");
+						strcat(filePath, cFileNameRoot);
+						strcat(filePath, ".avi");
+
+						//	http://www.fourcc.org/codecs.php
+						switch(cROIinfo.currentROIimageType)
+						{
+							case kImageType_RGB24:
+							//	CV_FOURCC_DEFAULT,
+							//	CV_FOURCC('M', 'J', 'L', 'S'),
+							//	CV_FOURCC('M', 'J', 'P', 'G'),		//*	MJPG -> motion jpeg
+							//	CV_FOURCC('P', 'I', 'M', '1'),		//*	MPEG-1
+							//	fourCC	=	CV_FOURCC('R', 'G', 'B', '8');
+							//	fourCC	=	CV_FOURCC('M', 'P', '4', '2');		//*	MP42 -> MPEG-4  WORKS!!
+							//
+							//	-1,									//*	user selectable dialog box
+					#ifdef _USE_OPENCV_
+							#if (CV_MAJOR_VERSION >= 3)
+								fourCC	=	cv::VideoWriter::fourcc('R', 'G', 'B', 'T');
+							#else
+								fourCC	=	CV_FOURCC('R', 'G', 'B', 'T');
+							#endif
+					#endif // _USE_OPENCV_
+								videoIsColor		=	1;
+								break;
+
+							default:
+					#ifdef _USE_OPENCV_
+							//	fourCC	=	CV_FOURCC('Y', '8', '0', '0');		//*	writes, but cant be read
+							#if (CV_MAJOR_VERSION >= 3)
+								fourCC	=	cv::VideoWriter::fourcc('Y', '8', ' ', ' ');		//*	writes, but cant be read
+							#else
+								fourCC	=	CV_FOURCC('Y', '8', ' ', ' ');		//*	writes, but cant be read
+							#endif
+					#endif // _USE_OPENCV_
+								videoIsColor		=	0;
+								break;
+						}
+				#ifdef _USE_OPENCV_
+						cOpenCV_videoWriter	=	NULL;
 					#if (CV_MAJOR_VERSION >= 3)
-						fourCC	=	cv::VideoWriter::fourcc('R', 'G', 'B', 'T');
+						fourCC				=	cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
 					#else
-						fourCC	=	CV_FOURCC('R', 'G', 'B', 'T');
+						fourCC				=	CV_FOURCC('M', 'J', 'P', 'G'),
 					#endif
-			#endif // _USE_OPENCV_
-						videoIsColor		=	1;
-						break;
 
-					default:
-			#ifdef _USE_OPENCV_
-					//	fourCC	=	CV_FOURCC('Y', '8', '0', '0');		//*	writes, but cant be read
-					#if (CV_MAJOR_VERSION >= 3)
-						fourCC	=	cv::VideoWriter::fourcc('Y', '8', ' ', ' ');		//*	writes, but cant be read
+					#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+						//*	make the compiler happy
+						CONSOLE_DEBUG_W_NUM("videoIsColor\t=", videoIsColor);
+
+						cOpenCV_videoWriter	=	new cv::VideoWriter(	filePath,
+																		fourCC,
+																		30.0,
+																		cv::Size(cROIinfo.currentROIwidth, cROIinfo.currentROIheight),
+																		videoIsColor);
 					#else
-						fourCC	=	CV_FOURCC('Y', '8', ' ', ' ');		//*	writes, but cant be read
+						cOpenCV_videoWriter	=	cvCreateVideoWriter(	filePath,
+																		fourCC,
+																		30.0,
+																		cvSize(cROIinfo.currentROIwidth, cROIinfo.currentROIheight),
+																		videoIsColor);
 					#endif
-			#endif // _USE_OPENCV_
-						videoIsColor		=	0;
-						break;
-				}
-		#ifdef _USE_OPENCV_
-				cOpenCV_videoWriter	=	NULL;
-			#if (CV_MAJOR_VERSION >= 3)
-				fourCC				=	cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
-			#else
-				fourCC				=	CV_FOURCC('M', 'J', 'P', 'G'),
-			#endif
-
-			#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
-				//*	make the compiler happy
-				CONSOLE_DEBUG_W_NUM("videoIsColor\t=", videoIsColor);
-
-				cOpenCV_videoWriter	=	new cv::VideoWriter(	filePath,
-																fourCC,
-																30.0,
-																cv::Size(cCameraProp.CameraXsize, cCameraProp.CameraYsize),
-																videoIsColor);
-			#else
-				cOpenCV_videoWriter	=	cvCreateVideoWriter(	filePath,
-																fourCC,
-																30.0,
-																cvSize(cCameraProp.CameraXsize, cCameraProp.CameraYsize),
-																videoIsColor);
-			#endif
-				CONSOLE_DEBUG_W_HEX("fourCC\t=", fourCC);
-				cAVIfourCC			=	fourCC;
-				if (cOpenCV_videoWriter == NULL)
-				{
-					CONSOLE_DEBUG("Failed to create video writer");
-					cInternalCameraState	=	kCameraState_Idle;
-					alpacaErrCode			=	kASCOM_Err_FailedToTakePicture;
-					GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to create video writer (openCv)");
-				//	CONSOLE_ABORT("");
+						CONSOLE_DEBUG_W_HEX("fourCC\t=", fourCC);
+						cAVIfourCC			=	fourCC;
+						if (cOpenCV_videoWriter == NULL)
+						{
+							CONSOLE_DEBUG("Failed to create video writer");
+							cInternalCameraState	=	kCameraState_Idle;
+							alpacaErrCode			=	kASCOM_Err_FailedToTakePicture;
+							GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to create video writer (openCv)");
+						//	CONSOLE_ABORT("");
+
+						}
+				#endif // _USE_OPENCV_
+					}
 
-				}
-		#endif // _USE_OPENCV_
-				//=============================================
-				if (cVideoCreateTimeStampFile)
-				{
-					GenerateFileNameRoot();
-					strcpy(filePath, gImageDataDir);
-					strcat(filePath, "/");
-					strcat(filePath, cFileNameRoot);
-					strcat(filePath, ".csv");
+					//=============================================
+					if ((alpacaErrCode == kASCOM_Err_Success) && cVideoCreateTimeStampFile)
+					{
+						GenerateFileNameRoot();
+						strcpy(filePath, gImageDataDir);
+						strcat(filePath, "/");
+						strcat(filePath, cFileNameRoot);
+						strcat(filePath, ".csv");
+
+						cVideoTimeStampFilePtr	=	fopen(filePath, "w");
+						if (cVideoTimeStampFilePtr != NULL)
+						{
+						//	fprintf(cVideoTimeStampFilePtr, "#Time Stamp File:%s\r\n", filePath);
+						//	fprintf(cVideoTimeStampFilePtr, "#------------------------------------\r\n");
+							fprintf(cVideoTimeStampFilePtr, "#FrameNum,TimeStamp,ExposureTime\r\n");
+						}
+					}
 
-					cVideoTimeStampFilePtr	=	fopen(filePath, "w");
-					if (cVideoTimeStampFilePtr != NULL)
+					//=============================================
+					//*	frames are captured by Take_Video() and written by the encoder thread
+					if ((alpacaErrCode == kASCOM_Err_Success) && (VideoPipeline_Start() == false))
 					{
-					//	fprintf(cVideoTimeStampFilePtr, "#Time Stamp File:%s\r\n", filePath);
-					//	fprintf(cVideoTimeStampFilePtr, "#------------------------------------\r\n");
-						fprintf(cVideoTimeStampFilePtr, "#FrameNum,TimeStamp,ExposureTime\r\n");
+						CONSOLE_DEBUG("Failed to start the video pipeline");
+						Stop_Video();
+						VideoPipeline_Finish(false);
+						alpacaErrCode			=	kASCOM_Err_FailedToTakePicture;
+						GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to allocate the video frame pool");
 					}
 				}
-			}
-			else
-			{
-				CONSOLE_DEBUG_W_NUM("Start_Video() failed with error\t=", alpacaErrCode);
-				CONSOLE_DEBUG_W_STR("cLastCameraErrMsg              \t=", cLastCameraErrMsg);
-				strcpy(alpacaErrMsg, cLastCameraErrMsg);
-				CONSOLE_DEBUG_W_STR("alpacaErrMsg                   \t=", alpacaErrMsg);
-			}
-			break;
+				else
+				{
+					CONSOLE_DEBUG_W_NUM("Start_Video() failed with error\t=", alpacaErrCode);
+					CONSOLE_DEBUG_W_STR("cLastCameraErrMsg              \t=", cLastCameraErrMsg);
+					strcpy(alpacaErrMsg, cLastCameraErrMsg);
+					CONSOLE_DEBUG_W_STR("alpacaErrMsg                   \t=", alpacaErrMsg);
+				}
+				break;
 
-		case kCameraState_TakingPicture:
-			alpacaErrCode	=	kASCOM_Err_CameraBusy;
-			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Single frame exposure in progress");
-			CONSOLE_DEBUG(alpacaErrMsg);
-			break;
+			case kCameraState_TakingPicture:
+				alpacaErrCode	=	kASCOM_Err_CameraBusy;
+				GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Single frame exposure in progress");
+				CONSOLE_DEBUG(alpacaErrMsg);
+				break;
 
-		case kCameraState_StartVideo:
-			CONSOLE_DEBUG("kCameraState_StartVideo");
-			break;
+			case kCameraState_StartVideo:
+				CONSOLE_DEBUG("kCameraState_StartVideo");
+				break;
 
-		case kCameraState_TakingVideo:
-			CONSOLE_DEBUG("kCameraState_TakingVideo");
-			alpacaErrCode	=	kASCOM_Err_CameraBusy;
-			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Video exposure in progress");
-			break;
+			case kCameraState_TakingVideo:
+				CONSOLE_DEBUG("kCameraState_TakingVideo");
+				alpacaErrCode	=	kASCOM_Err_CameraBusy;
+				GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Video exposure in progress");
+				break;
 
-		default:
-			break;
+			default:
+				break;
+		}
 	}
 	return(alpacaErrCode);
 }
@@ -6613,11 +6568,14 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_NotImplemented;
 }
 
 //*****************************************************************************
-TYPE_ASCOM_STATUS	CameraDriver::Take_Video(void)
+//*	Take_Video() is in cameradriver_video.cpp, cameras only need to supply Read_VideoFrame()
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Read_VideoFrame(unsigned char *imageDataPtr, const long imageDataLen)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_NotImplemented;
 
-	strcpy(cLastCameraErrMsg, "Not finished-");
+	//*	this should be over ridden
+	strcpy(cLastCameraErrMsg, "Needs to be overloaded:-");
 	strcat(cLastCameraErrMsg, __FILE__);
 	strcat(cLastCameraErrMsg, ":");
 	strcat(cLastCameraErrMsg, __FUNCTION__);
@@ -7357,6 +7315,13 @@ uint32_t			elapsedMilliSecs;
 					startNextFrame	=	true;
 				}
 
+				//*	dont start another exposure until the save writers have caught up
+				if (startNextFrame && IsSaveQueueFull())
+				{
+					startNextFrame	=	false;
+					delayMicroSecs	=	10000;
+				}
+
 				if (startNextFrame)
 				{
 					CONSOLE_DEBUG_W_NUM("Starting next image in sequence", cNumFramesToSave);
@@ -7379,6 +7344,12 @@ uint32_t			elapsedMilliSecs;
 
 		case kImageMode_Live:
 			CONSOLE_DEBUG("kImageMode_Live");
+			if ((cSaveNextImage || cSaveAllImages) && IsSaveQueueFull())
+			{
+				//*	wait for the save writers to catch up
+				delayMicroSecs	=	10000;
+			}
+			else
 			{
 				SetLastExposureInfo();
 				alpacaErrCode	=	Start_CameraExposure(cCurrentExposure_us);
@@ -7460,6 +7431,8 @@ TYPE_ASCOM_STATUS	alpacaErrCode;
 			{
 				//*	record the time the exposure ended
 				gettimeofday(&cCameraProp.Lastexposure_EndTime, NULL);
+				//*	downloads can now get to this frame, the next exposure reads into a different slot
+				PublishFrameSlot();
 				cNewImageReadyToDisplay		=	true;
 				cCameraProp.ImageReady		=	true;
 //				CONSOLE_DEBUG("cCameraProp.ImageReady set to TRUE!!!!!!!!!!!!!!");
@@ -8119,6 +8092,7 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
 int					mySocketFD;
 char				lineBuff[128];
 int					fitsHdrIdx;
+TYPE_FITS_RECORD	*fitsHeaderCopy;
 
 	mySocketFD	=	reqData->socket;
 
@@ -8132,18 +8106,28 @@ int					fitsHdrIdx;
 									kMaxJsonBuffLen,
 									"\n");
 
-	fitsHdrIdx	=	0;
-	while (cFitsHeader[fitsHdrIdx].fitsRec[0] != 0)
+	//*	the save writer threads update cFitsHeader, work from a copy
+	fitsHeaderCopy	=	(TYPE_FITS_RECORD *)malloc(sizeof(cFitsHeader));
+	if (fitsHeaderCopy != NULL)
 	{
-		strcpy(lineBuff, "\"");
-		strcat(lineBuff, cFitsHeader[fitsHdrIdx].fitsRec);
-		strcat(lineBuff, "\",\n");
+		pthread_mutex_lock(&cSaveQueueMutex);
+		memcpy(fitsHeaderCopy, cFitsHeader, sizeof(cFitsHeader));
+		pthread_mutex_unlock(&cSaveQueueMutex);
 
-		cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
-										reqData->jsonTextBuffer,
-										kMaxJsonBuffLen,
-										lineBuff);
-		fitsHdrIdx++;
+		fitsHdrIdx	=	0;
+		while ((fitsHdrIdx < kMaxFitsRecords) && (fitsHeaderCopy[fitsHdrIdx].fitsRec[0] != 0))
+		{
+			strcpy(lineBuff, "\"");
+			strcat(lineBuff, fitsHeaderCopy[fitsHdrIdx].fitsRec);
+			strcat(lineBuff, "\",\n");
+
+			cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
+											reqData->jsonTextBuffer,
+											kMaxJsonBuffLen,
+											lineBuff);
+			fitsHdrIdx++;
+		}
+		free(fitsHeaderCopy);
 	}
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
 									reqData->jsonTextBuffer,
@@ -8771,6 +8755,21 @@ char				textBuffer[128];
 														gConformLogging,
 														INCLUDE_COMMA);
 
+	//*	background image saving
+	Get_Readall_SaveQueue(reqData);
+
+	//*	statistics of the latest frame
+	Get_Readall_FrameStats(reqData);
+
+	//*	video capture pipeline
+	Get_Readall_Video(reqData);
+
+	//*	MJPEG live view
+	Get_Readall_MJPEG(reqData);
+
+	//*	shared image buffer pool
+	Get_Readall_ImagePool(reqData);
+
 	//*	color information
 #ifdef _USE_OPENCV_
 uint16_t	myRed;
@@ -8809,6 +8808,458 @@ uint16_t	myBlu;
 }
 
 
+//*****************************************************************************
+//*	save queue depth, write latency and throughput
+//*****************************************************************************
+void	CameraDriver::Get_Readall_SaveQueue(TYPE_GetPutRequestData *reqData)
+{
+int			mySocket;
+int			queueDepth;
+int			writerCnt;
+uint32_t	jobsCompleted;
+uint32_t	jobsDropped;
+uint32_t	writeLast_us;
+uint32_t	writeMax_us;
+uint64_t	writeTotal_us;
+uint64_t	bytesWritten;
+double		avgWrite_ms;
+double		megaBytesPerSec;
+
+	mySocket	=	reqData->socket;
+
+	//*	take a snapshot so we dont hold the lock while sending
+	pthread_mutex_lock(&cSaveQueueMutex);
+	queueDepth		=	cSaveQueueCount + cSaveJobsActive;
+	writerCnt		=	cSaveWriterCnt;
+	jobsCompleted	=	cSaveJobsCompleted;
+	jobsDropped		=	cSaveJobsDropped;
+	writeLast_us	=	cSaveWriteLast_us;
+	writeMax_us		=	cSaveWriteMax_us;
+	writeTotal_us	=	cSaveWriteTotal_us;
+	bytesWritten	=	cSaveBytesWritten;
+	pthread_mutex_unlock(&cSaveQueueMutex);
+
+	avgWrite_ms		=	0.0;
+	megaBytesPerSec	=	0.0;
+	if ((jobsCompleted > 0) && (writeTotal_us > 0))
+	{
+		avgWrite_ms		=	(writeTotal_us / 1000.0) / jobsCompleted;
+		megaBytesPerSec	=	(bytesWritten * 1.0) / writeTotal_us;	//*	bytes per microsecond == MB per second
+	}
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-depth",
+														queueDepth,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-max",
+														kSaveQueueDepth,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-writers",
+														writerCnt,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-saved",
+														jobsCompleted,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-dropped",
+														jobsDropped,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-write-last-ms",
+														(writeLast_us / 1000.0),
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-write-avg-ms",
+														avgWrite_ms,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-write-max-ms",
+														(writeMax_us / 1000.0),
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"savequeue-MBps",
+														megaBytesPerSec,
+														INCLUDE_COMMA);
+}
+
+//*****************************************************************************
+//*	video frames captured, encoded and dropped, queue depth and encode time
+//*****************************************************************************
+void	CameraDriver::Get_Readall_Video(TYPE_GetPutRequestData *reqData)
+{
+int			mySocket;
+uint32_t	framesCaptured;
+uint32_t	framesEncoded;
+uint32_t	framesDropped;
+int			queueDepth;
+int			queueHighWater;
+uint32_t	encodeMax_us;
+uint64_t	encodeTotal_us;
+double		avgEncode_ms;
+
+	mySocket	=	reqData->socket;
+
+	//*	take a snapshot so we dont hold the lock while sending
+	pthread_mutex_lock(&cVideoMutex);
+	framesCaptured	=	cNumVideoFramesSaved;
+	framesEncoded	=	cVideoFramesEncoded;
+	framesDropped	=	cVideoFramesDropped;
+	queueDepth		=	cVideoQueueCount;
+	queueHighWater	=	cVideoQueueHighWater;
+	encodeMax_us	=	cVideoEncodeMax_us;
+	encodeTotal_us	=	cVideoEncodeTotal_us;
+	pthread_mutex_unlock(&cVideoMutex);
+
+	avgEncode_ms	=	0.0;
+	if (framesEncoded > 0)
+	{
+		avgEncode_ms	=	(encodeTotal_us / 1000.0) / framesEncoded;
+	}
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"video-captured",
+														framesCaptured,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"video-encoded",
+														framesEncoded,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"video-dropped",
+														framesDropped,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"video-queue-depth",
+														queueDepth,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"video-queue-highwater",
+														queueHighWater,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"video-pool-size",
+														kVideoFramePoolSize,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"video-encode-avg-ms",
+														avgEncode_ms,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"video-encode-max-ms",
+														(encodeMax_us / 1000.0),
+														INCLUDE_COMMA);
+}
+
+//*****************************************************************************
+//*	the image pool is shared by all of the cameras
+//*****************************************************************************
+void	CameraDriver::Get_Readall_ImagePool(TYPE_GetPutRequestData *reqData)
+{
+int					mySocket;
+TYPE_ImagePoolStats	poolStats;
+
+	mySocket	=	reqData->socket;
+	ImagePool_GetStats(&poolStats);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"imagepool-mapped-mb",
+														(poolStats.bytesMapped / (1024.0 * 1024.0)),
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"imagepool-highwater-mb",
+														(poolStats.highWaterMapped / (1024.0 * 1024.0)),
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"imagepool-inuse-mb",
+														(poolStats.bytesInUse / (1024.0 * 1024.0)),
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"imagepool-cached-mb",
+														(poolStats.bytesCached / (1024.0 * 1024.0)),
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"imagepool-fragmentation-pct",
+														poolStats.fragmentation_pct,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"imagepool-mmaps",
+														(uint32_t)poolStats.mapCnt,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"imagepool-hits",
+														(uint32_t)poolStats.poolHits,
+														INCLUDE_COMMA);
+}
+
+//*****************************************************************************
+//*	camera statistics on the stats page
+//*****************************************************************************
+void	CameraDriver::OutputHTML_DeviceStats(TYPE_GetPutRequestData *reqData)
+{
+	OutputHTML_MJPEGstats(reqData);
+	OutputHTML_ImagePoolStats(reqData);
+}
+
+//*****************************************************************************
+//*	the image pool is shared, all cameras show the same numbers
+//*****************************************************************************
+void	CameraDriver::OutputHTML_ImagePoolStats(TYPE_GetPutRequestData *reqData)
+{
+int					mySocketFD;
+TYPE_ImagePoolStats	poolStats;
+size_t				classSize;
+int					inUseCnt;
+int					cachedCnt;
+char				lineBuffer[512];
+int					iii;
+
+	mySocketFD	=	reqData->socket;
+	ImagePool_GetStats(&poolStats);
+
+	SocketWriteData(mySocketFD,	"<CENTER>\r\n");
+	SocketWriteData(mySocketFD,	"Image buffer pool<BR>\r\n");
+	SocketWriteData(mySocketFD,	"<TABLE BORDER=1>\r\n");
+	sprintf(lineBuffer, "<TR><TD>Mapped (now/high water)</TD><TD>%1.1f / %1.1f MB</TD></TR>\r\n",
+								(poolStats.bytesMapped / (1024.0 * 1024.0)),
+								(poolStats.highWaterMapped / (1024.0 * 1024.0)));
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>In use</TD><TD>%d buffers, %1.1f MB</TD></TR>\r\n",
+								poolStats.buffersInUse,
+								(poolStats.bytesInUse / (1024.0 * 1024.0)));
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>Cached</TD><TD>%d buffers, %1.1f MB</TD></TR>\r\n",
+								poolStats.buffersCached,
+								(poolStats.bytesCached / (1024.0 * 1024.0)));
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>Size class rounding</TD><TD>%1.1f %%</TD></TR>\r\n",	poolStats.fragmentation_pct);
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>Allocations (pool hits)</TD><TD>%llu (%llu)</TD></TR>\r\n",
+								(unsigned long long)poolStats.allocCnt,
+								(unsigned long long)poolStats.poolHits);
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>mmap / munmap (huge pages)</TD><TD>%llu / %llu (%llu)</TD></TR>\r\n",
+								(unsigned long long)poolStats.mapCnt,
+								(unsigned long long)poolStats.unmapCnt,
+								(unsigned long long)poolStats.hugePageCnt);
+	SocketWriteData(mySocketFD,	lineBuffer);
+	if (poolStats.lockFailCnt > 0)
+	{
+		sprintf(lineBuffer, "<TR><TD>mlock failures</TD><TD>%llu</TD></TR>\r\n",	(unsigned long long)poolStats.lockFailCnt);
+		SocketWriteData(mySocketFD,	lineBuffer);
+	}
+	SocketWriteData(mySocketFD,	"</TABLE>\r\n");
+
+	SocketWriteData(mySocketFD,	"<TABLE BORDER=1>\r\n");
+	SocketWriteData(mySocketFD,	"<TR><TH>Size class</TH><TH>In use</TH><TH>Cached</TH></TR>\r\n");
+	iii	=	0;
+	while (ImagePool_GetClassStats(iii, &classSize, &inUseCnt, &cachedCnt))
+	{
+		if ((inUseCnt > 0) || (cachedCnt > 0))
+		{
+			sprintf(lineBuffer, "<TR><TD>%1.2f MB</TD><TD>%d</TD><TD>%d</TD></TR>\r\n",
+									(classSize / (1024.0 * 1024.0)),
+									inUseCnt,
+									cachedCnt);
+			SocketWriteData(mySocketFD,	lineBuffer);
+		}
+		iii++;
+	}
+	SocketWriteData(mySocketFD,	"</TABLE>\r\n");
+	SocketWriteData(mySocketFD,	"</CENTER>\r\n");
+}
+
+//*****************************************************************************
+//*	statistics of the latest frame, they are only calculated once per frame
+//*****************************************************************************
+void	CameraDriver::Get_Readall_FrameStats(TYPE_GetPutRequestData *reqData)
+{
+int						mySocket;
+TYPE_FrameSlot			*frameSlot;
+const TYPE_FrameStats	*frameStats;
+TYPE_ChannelStats		allStats;
+uint32_t				frameNumber;
+uint32_t				saturatedPixelCnt;
+double					saturationPrct;
+double					calcTime_ms;
+bool					statsValid;
+
+	mySocket	=	reqData->socket;
+
+	//*	take a copy so we dont hold the frame while sending
+	statsValid	=	false;
+	frameSlot	=	NULL;
+	if (cCameraProp.ImageReady)
+	{
+		frameSlot	=	AcquireLatestFrame();
+	}
+	if (frameSlot != NULL)
+	{
+		frameStats	=	GetFrameStats(frameSlot);
+		if (frameStats != NULL)
+		{
+			allStats			=	frameStats->all;
+			frameNumber			=	frameSlot->frameNumber;
+			saturatedPixelCnt	=	frameStats->saturatedPixelCnt;
+			saturationPrct		=	CalculateSaturation(frameStats);
+			calcTime_ms			=	frameStats->calcTime_ms;
+			statsValid			=	true;
+		}
+		ReleaseFrame(frameSlot);
+	}
+
+	if (statsValid)
+	{
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-frame",
+															frameNumber,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-min",
+															allStats.minValue,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-max",
+															allStats.maxValue,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-mean",
+															allStats.mean,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-stddev",
+															allStats.stdDev,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-median",
+															allStats.median,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-p01",
+															allStats.percentile01,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-p99",
+															allStats.percentile99,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-saturated",
+															saturatedPixelCnt,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-saturated-prct",
+															saturationPrct,
+															INCLUDE_COMMA);
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"framestats-calc-ms",
+															calcTime_ms,
+															INCLUDE_COMMA);
+	}
+}
+
 //*****************************************************************************
 bool	CameraDriver::GetCmdNameFromMyCmdTable(const int cmdNumber, char *comandName, char *getPut)
 {
@@ -9152,7 +9603,6 @@ bool	foundFlag	=	true;
 		case kCmd_Camera_gains:					//*	Gains supported by the camera
 		case kCmd_Camera_hasshutter:			//*	Indicates whether the camera has a mechanical shutter
 		case kCmd_Camera_heatsinktemperature:	//*	Returns the current heat sink temperature.
-		case kCmd_Camera_imagearray:			//*	Returns an array of integers containing the exposure pixel values
 		case kCmd_Camera_imagearrayvariant:		//*	Returns an array of int containing the exposure pixel values
 		case kCmd_Camera_imageready:			//*	Indicates that an image is ready to be downloaded
 		case kCmd_Camera_IsPulseGuiding:		//*	Indicates that the camera is pulse guideing.
@@ -9200,6 +9650,8 @@ bool	foundFlag	=	true;
 		case kCmd_Camera_filenameoptions:	strcpy(agumentString, "includecamera=BOOL");	break;
 		case kCmd_Camera_flip:				strcpy(agumentString, "flip=INT (0,1,2,3)");	break;
 		case kCmd_Camera_livemode:			strcpy(agumentString, "livemode=BOOL");			break;
+		case kCmd_Camera_mjpeg:				strcpy(agumentString, "width=INT, height=INT (default width=640)");	break;
+		case kCmd_Camera_imagearray:		strcpy(agumentString, "Optional: startx=INT, starty=INT, numx=INT, numy=INT, bin=INT, binmode=sum/mean, bitdepth=8/16");	break;
 		case kCmd_Camera_settelescopeinfo:	strcpy(agumentString, "RefID,Telescope,Focuser,Filterwheel,Object,Prefix,Suffix,auxtext");			break;
 		case kCmd_Camera_saveallimages:		strcpy(agumentString, "saveallimages=BOOL");						break;
 		case kCmd_Camera_saveasFITS:		strcpy(agumentString, "saveasfits=BOOL");							break;
@@ -9207,7 +9659,7 @@ bool	foundFlag	=	true;
 		case kCmd_Camera_saveasPNG:			strcpy(agumentString, "saveaspng=BOOL");							break;
 		case kCmd_Camera_saveasRAW:			strcpy(agumentString, "saveasraw=BOOL");							break;
 		case kCmd_Camera_startsequence:		strcpy(agumentString, "count=INT, delay=FLOAT, deltaduration=FLOAT");	break;
-		case kCmd_Camera_startvideo:		strcpy(agumentString, "recordtime=FLOAT");								break;
+		case kCmd_Camera_startvideo:		strcpy(agumentString, "recordtime=FLOAT, format=avi|ser");							break;
 
 
 #ifdef _ENABLE_FITS_
@@ -29,6 +29,13 @@
 //*	Jun  4,	2023	<MLS> Added cSaveAsFITS, cSaveAsJPEG, cSaveAsPNG, cSaveAsRAW
 //*	Aug 31,	2023	<MLS> Adding support for GPS, specifically the QHY174-GPS
 //*	Apr 19,	2024	<MLS> Added kImageType_MONO8
+//*	Oct 16,	2026	<MLS> Added TYPE_FrameSlot, ring of reference counted image buffers
+//*	Oct 16,	2026	<MLS> Added TYPE_SaveJob, images are saved by background writer threads
+//*	Oct 16,	2026	<MLS> Added frame statistics to TYPE_FrameSlot, calculated once per frame
+//*	Oct 16,	2026	<MLS> Added TYPE_VideoFrame, video capture pipeline with a separate encoder thread
+//*	Oct 17,	2026	<MLS> Added TYPE_VIDEO_FORMAT, video can be recorded as a SER file
+//*	Oct 17,	2026	<MLS> Added TYPE_MJPEGviewer, MJPEG live view stream
+//*	Oct 17,	2026	<MLS> Added Get_Imagearray_Reduce(), sub frame/bin/bit depth for imagearray
 //*****************************************************************************
 //#include	"cameradriver.h"
 
@@ -94,6 +101,9 @@
 #include	"observatory_settings.h"
 
 #include	"camera_defs.h"
+#include	"framestats.h"
+#include	"serfile.h"
+#include	"imagepool.h"
 
 #define	kImageDataDir_Default		"imagedata"
 
@@ -186,6 +196,100 @@ typedef struct	//	TYPE_IMAGE_ROI_Info
 } TYPE_IMAGE_ROI_Info;
 
 
+//*****************************************************************************
+//*	Frame slots
+//*	the camera reads into a free slot while downloads hold references to older ones.
+//*	the ROI and the timestamps travel with the data so a new exposure
+//*	cannot change what an in-progress download is sending
+//*	each queued save job also holds a reference to its frame.
+//*	each slot is the size of one frame at the current ROI and image type, and the number
+//*	of slots in use comes from kFrameSlotMemPercent of the physical memory,
+//*	with fewer slots the readout waits for the save queue or a download to let go
+//*****************************************************************************
+#define		kSaveQueueDepth			4
+#define		kMinFrameSlotCnt		3						//*	the readout, the latest frame and one download
+#define		kMaxFrameSlotCnt		(kSaveQueueDepth + 3)	//*	room for the save queue as well
+#define		kFrameSlotMemPercent	25
+#define		kFrameSlotWait_Secs		5
+typedef struct	//	TYPE_FrameSlot
+{
+	unsigned char			*dataBuffer;
+	long					dataBuffLen;
+	int						refCount;				//*	number of downloads using this frame
+	uint32_t				frameNumber;
+	TYPE_IMAGE_ROI_Info		roiInfo;
+	struct timeval			exposureStartTime;
+	struct timeval			exposureEndTime;
+	int32_t					exposureDuration_us;
+
+	//*	filled in by GetFrameStats() the first time they are needed,
+	//*	the histograms are about 256K so they are allocated then as well.
+	//*	A reduced imagearray frame is a plain copy of the fields above and never has them
+	pthread_mutex_t			statsMutex;
+	TYPE_FrameStats			*frameStats;
+} TYPE_FrameSlot;
+
+
+//*****************************************************************************
+//*	Video frames
+//*	the capture side takes a free frame from the pool, reads the camera into it and
+//*	queues it for the encoder thread, which draws the overlay, writes the video file
+//*	and puts the frame back in the pool. When the pool is empty the sensor frame is
+//*	still read (into a scratch buffer) so the camera never stalls, and it is counted as dropped
+//*****************************************************************************
+#define		kVideoFramePoolSize		8
+typedef struct	//	TYPE_VideoFrame
+{
+	unsigned char			*dataBuffer;
+	uint32_t				frameNumber;
+	struct timeval			timeStamp;				//*	when the frame came off the camera
+	int32_t					exposureDuration_us;
+} TYPE_VideoFrame;
+
+//*****************************************************************************
+//*	AVI goes through openCV with the overlay, SER is the raw sensor data
+typedef enum
+{
+	kVideoFormat_AVI	=	0,
+	kVideoFormat_SER
+} TYPE_VIDEO_FORMAT;
+
+//*****************************************************************************
+//*	MJPEG live view
+//*	each new frame is shrunk and compressed once for each size that is being watched,
+//*	every viewer of that size gets the same bytes. Each viewer has its own sender thread
+//*	and at most one image waiting, a newer image replaces it (counted as dropped),
+//*	so a slow viewer only slows itself down
+//*****************************************************************************
+#define		kMaxMJPEGviewers		8
+#define		kMJPEGdefaultWidth		640
+typedef struct	//	TYPE_MJPEGimage
+{
+	unsigned char			*jpegData;
+	long					jpegLen;
+	int						refCount;				//*	the encoder plus each viewer that has not sent it yet
+	uint32_t				frameNumber;
+} TYPE_MJPEGimage;
+
+typedef struct	//	TYPE_MJPEGviewer
+{
+	bool					inUse;
+	int						socketFD;				//*	detached from the listener, closed by the viewer thread
+	class CameraDriver		*cameraDriver;
+	pthread_cond_t			imageReady;
+	TYPE_MJPEGimage			*pendingImage;			//*	next image to send, NULL if none
+	uint32_t				lastFrameNumber;		//*	last frame given to this viewer
+	bool					haveFrame;
+	int						maxWidth;				//*	as requested, 0 = no limit
+	int						maxHeight;
+	char					clientIPaddr[48];
+	struct timeval			connectTime;
+	uint32_t				framesSent;
+	uint32_t				framesDropped;
+	uint64_t				bytesSent;
+} TYPE_MJPEGviewer;
+
+
 //*****************************************************************************
 //*	this is for keeping track of other saved data for the FITS header
 #define		kMaxFileNameLen		128
@@ -209,6 +313,77 @@ typedef struct	//	TYPE_FILENAME
 #define	SAVE_AVI	true
 
 
+//*****************************************************************************
+//*	Save jobs
+//*	everything the save routines need is copied into the job when the frame is read out,
+//*	the writer threads never look at the live camera settings for per frame data
+//*****************************************************************************
+#define		kMaxSaveWriterThreads	4
+typedef struct	//	TYPE_SaveJob
+{
+	TYPE_FrameSlot			*frameSlot;				//*	reference held until the job is done, NULL for header only
+	unsigned char			*imageData;
+	TYPE_IMAGE_ROI_Info		roiInfo;
+	TYPE_CameraProperties	cameraProp;				//*	includes the exposure times
+	int						ccdTempErrCode;
+	char					fileNameRoot[256];
+	char					objectName[kObjectNameMaxLen + 1];
+	TYPE_IMAGE_MODE			imageMode;
+	int						imageSeqNumber;
+	int						numFramesRequested;
+	double					frameRate;
+
+	bool					saveAsFITS;
+	bool					saveAsJPEG;
+	bool					saveAsPNG;
+
+	//*	values from the other devices at the time of the exposure
+	bool					filterPosValid;
+	int						filterPosition;
+	bool					filterNameValid;
+	char					filterName[48];
+	bool					focuserValid;
+	long					focuserPosition;
+	double					focuserTemperature;
+	double					focuserVoltage;
+
+	int32_t					minHistogramValue;
+	int32_t					maxHistogramValue;
+	int32_t					peakHistogramValue;
+
+#ifdef _ENABLE_IMU_
+	bool					imuAvailable;
+	bool					imuEulerValid;
+	bool					imuQuatValid;
+	double					imuHeading;
+	double					imuRoll;
+	double					imuPitch;
+	double					imuWWW;
+	double					imuXXX;
+	double					imuYYY;
+	double					imuZZZ;
+	int						imuCal_Gyro;
+	int						imuCal_Acce;
+	int						imuCal_Magn;
+	int						imuCal_Syst;
+#endif // _ENABLE_IMU_
+
+#ifdef _USE_OPENCV_
+#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+	cv::Mat					*openCV_ImagePtr;		//*	copy of cOpenCV_ImagePtr, includes the overlay
+#else
+	IplImage				*openCV_ImagePtr;
+#endif // _USE_OPENCV_CPP_
+#endif // _USE_OPENCV_
+
+	TYPE_FILENAME			otherDataProducts[kMaxDataProducts];
+	int						otherDataCnt;
+
+	struct timeval			queuedTime;
+	uint64_t				bytesWritten;
+} TYPE_SaveJob;
+
+
 
 //**************************************************************************************
 //*	image flip, this is the ZWO definition, we will adopt that
@@ -259,6 +434,11 @@ class CameraDriver: public AlpacaDriver
 
 				void	SaveImageData(void);
 				void	SaveNextImage(void);
+				bool	IsSaveQueueFull(void);
+				void	RunSaveWriter(void);
+				void	RunVideoEncoder(void);
+				void	RunMJPEGencoder(void);
+				void	RunMJPEGviewer(TYPE_MJPEGviewer *viewer);
 				void	SetLastExposureInfo(void);
 	protected:
 		//*	Camera routines for all cameras
@@ -359,16 +539,15 @@ class CameraDriver: public AlpacaDriver
 		TYPE_ASCOM_STATUS	Put_SubExposureDuration(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
 
 
-		TYPE_ASCOM_STATUS	Get_Imagearray_JSON(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
-		TYPE_ASCOM_STATUS	Get_Imagearray_Binary(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
-		int					BuildBinaryImage_Raw8(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_Raw8_16bit(	unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_Raw8_32bit(	unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_Raw16(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_Raw32(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_RGB24(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_RGB24_32bit(	uint32_t		*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_RGBx16(		unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
+		TYPE_ASCOM_STATUS	Get_Imagearray_JSON(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg, TYPE_FrameSlot *frameSlot);
+		TYPE_ASCOM_STATUS	Get_Imagearray_Binary(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg, TYPE_FrameSlot *frameSlot);
+		TYPE_ASCOM_STATUS	Get_Imagearray_Reduce(	TYPE_GetPutRequestData	*reqData,
+													char					*alpacaErrMsg,
+													TYPE_FrameSlot			*frameSlot,
+													TYPE_FrameSlot			*reducedFrame,
+													bool					*frameWasReduced);
+		int					BuildBinaryImage_RGB24_32bit(	TYPE_FrameSlot *frameSlot, uint32_t		*binaryDataBuffer, int startOffset, int bufferSize);
+		int					BuildBinaryImage_RGBx16(		TYPE_FrameSlot *frameSlot, unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
 
 		//-------------------------------------------------------------------------------------------------
 		//*	Added by MLS
@@ -426,6 +605,15 @@ class CameraDriver: public AlpacaDriver
 
 		TYPE_ASCOM_STATUS	Get_RGBarray(			TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
 virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+		void				Get_Readall_SaveQueue(	TYPE_GetPutRequestData *reqData);
+		void				Get_Readall_FrameStats(	TYPE_GetPutRequestData *reqData);
+		void				Get_Readall_Video(		TYPE_GetPutRequestData *reqData);
+		void				Get_Readall_MJPEG(		TYPE_GetPutRequestData *reqData);
+		void				Get_Readall_ImagePool(	TYPE_GetPutRequestData *reqData);
+		TYPE_ASCOM_STATUS	Get_MJPEG(				TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+virtual	void				OutputHTML_DeviceStats(	TYPE_GetPutRequestData *reqData);
+		void				OutputHTML_MJPEGstats(	TYPE_GetPutRequestData *reqData);
+		void				OutputHTML_ImagePoolStats(TYPE_GetPutRequestData *reqData);
 
 		//*	these are borrowed from the telescope device
 		TYPE_ASCOM_STATUS	Get_ApertureArea(			TYPE_GetPutRequestData *reqData, char *alpacaErrMsg, const char *responseString);
@@ -435,53 +623,63 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 
 
 				bool	AllocateImageBuffer(long bufferSize);
+				long	GetFrameBufferSize(void);
+				void	PublishFrameSlot(void);
+		TYPE_FrameSlot	*AcquireLatestFrame(void);
+				void	ReleaseFrame(TYPE_FrameSlot *frameSlot);
 
 				void	GenerateFileNameRoot(void);
 				void	WriteFireCaptureTextFile(void);
-				void	WriteIMUtextFile(void);
-
-
-				void	Send_imagearray_rgb24(	const int		socketFD,
-												unsigned char	*pixelPtr,
-												const int		numRows,
-												const int		numClms,
-												const int		pixelCount);
-				void	Send_imagearray_raw8(	const int		socketFD,
-												unsigned char	*pixelPtr,
-												const int		numRows,
-												const int		numClms,
-												const int		pixelCount);
-				void	Send_imagearray_raw16(	const int		socketFD,
-												uint16_t		*pixelPtr,
-												const int		numRows,
-												const int		numClms,
-												const int		pixelCount);
-
-				void	Send_RGBarray_rgb24(const int socketFD, unsigned char *pixelPtr, const int pixelCount);
-				void	Send_RGBarray_raw8(const int socketFD, unsigned char *pixelPtr, const int pixelCount);
+				void	WriteIMUtextFile(TYPE_SaveJob *saveJob);
+
+				void	FillSaveJob(TYPE_SaveJob *saveJob);
+				void	FreeSaveJob(TYPE_SaveJob *saveJob);
+				bool	QueueSaveJob(TYPE_SaveJob *saveJob);
+				void	StartSaveWriterThreads(void);
+				void	StopSaveWriterThreads(void);
+				void	SaveImageJob(TYPE_SaveJob *saveJob);
+				void	AddSavedFileSize(TYPE_SaveJob *saveJob, const char *filePath);
+
+				//*	video capture pipeline (cameradriver_video.cpp)
+				bool	VideoPipeline_Start(void);
+				void	VideoPipeline_Stop(void);
+				void	VideoPipeline_Finish(const bool recordingComplete);
+				bool	VideoPipeline_CreateSERfile(const char *filePath);
+		TYPE_VideoFrame	*VideoPipeline_GetFreeFrame(void);
+				void	VideoPipeline_QueueFrame(TYPE_VideoFrame *videoFrame);
+				void	VideoPipeline_ReturnFrame(TYPE_VideoFrame *videoFrame);
+				void	EncodeVideoFrame(TYPE_VideoFrame *videoFrame);
+
+				//*	MJPEG live view (cameradriver_mjpeg.cpp)
+				void	MJPEG_NewFrame(void);
+				void	MJPEG_Stop(void);
+		TYPE_MJPEGimage	*MJPEG_EncodeFrame(TYPE_FrameSlot *frameSlot, const int maxWidth, const int maxHeight);
+				void	MJPEG_DistributeFrame(TYPE_FrameSlot *frameSlot);
+				void	MJPEG_ReleaseImage(TYPE_MJPEGimage *mjpegImage);
+
 
 			#ifdef _ENABLE_FITS_
-				int		SaveImageAsFITS(bool headerOnly=false);
-				void	CreateFitsBGRimage(void);
+				int		SaveImageAsFITS(bool headerOnly=false, TYPE_SaveJob *saveJob=NULL);
+		unsigned char	*CreateFitsBGRimage(TYPE_SaveJob *saveJob);
 				void	WriteFITS_Seperator(fitsfile *fitsFilePtr, const char *blockName);
 
-				void	WriteFITS_CameraInfo(		fitsfile *fitsFilePtr);
+				void	WriteFITS_CameraInfo(		fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob);
 				void	WriteFITS_EnvironmentInfo(	fitsfile *fitsFilePtr);
-				void	WriteFITS_FilterwheelInfo(	fitsfile *fitsFilePtr);
-				void	WriteFITS_FocuserInfo(		fitsfile *fitsFilePtr);
-				void	WriteFITS_ObservationInfo(	fitsfile *fitsFilePtr, bool includeAnalysis);
+				void	WriteFITS_FilterwheelInfo(	fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob);
+				void	WriteFITS_FocuserInfo(		fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob);
+				void	WriteFITS_ObservationInfo(	fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob, bool includeAnalysis);
 				void	WriteFITS_ObservatoryInfo(	fitsfile *fitsFilePtr);
 				void	WriteFITS_RotatorInfo(		fitsfile *fitsFilePtr);
 				void	WriteFITS_SoftwareInfo(		fitsfile *fitsFilePtr);
-				void	WriteFITS_TelescopeInfo(	fitsfile *fitsFilePtr);
+				void	WriteFITS_TelescopeInfo(	fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob);
 				void	WriteFITS_VersionInfo(		fitsfile *fitsFilePtr);
-				void	WriteFITS_MoonInfo(			fitsfile *fitsFilePtr);
+				void	WriteFITS_MoonInfo(			fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob);
 				void	WriteFITS_GPSinfo(			fitsfile *fitsFilePtr);
 				void	WriteFITS_QHY_GPSinfo(		fitsfile *fitsFilePtr);
 				void	WriteFITS_Global_GPSinfo(	fitsfile *fitsFilePtr);
 
 			#ifdef _ENABLE_IMU_
-				void	WriteFITS_IMUinfo(			fitsfile *fitsFilePtr);
+				void	WriteFITS_IMUinfo(			fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob);
 			#endif
 
 				TYPE_ASCOM_STATUS	Get_FitsHeader(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
@@ -508,7 +706,7 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 			#endif
 
 			#ifdef _ENABLE_JPEGLIB_
-				void	SaveUsingJpegLib(void);
+				void	SaveUsingJpegLib(TYPE_SaveJob *saveJob);
 			#endif	//	_ENABLE_JPEGLIB_
 				void	SaveUsingPNGlib(void);
 
@@ -529,7 +727,7 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 		void			DisplayLiveImage(void);
 		void			DisplayLiveImage_wSideBar(void);
 		int				CreateOpenCVImage(const unsigned char *imageDataPtr);
-		int				SaveOpenCVImage(void);
+		int				SaveOpenCVImage(TYPE_SaveJob *saveJob);
 		void			SetOpenCVcallbackFunction(const char *windowName);
 		void			ProcessMouseEvent(int event, int xxx, int yyy, int flags);
 		void			DrawOpenCVoverlay(void);
@@ -549,11 +747,9 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 	#endif	//	_USE_OPENCV_
 		//*****************************************************************************
 		//*	image analysis routines
-		uint32_t		CalculateMaxPixValue(void);
-		uint32_t		CalculateMinPixValue(void);
-		uint32_t		CountSaturationPixels(void);
-		double			CalculateSaturation(void);
-		float			CalculateHistogramMax(void);
+		const TYPE_FrameStats	*GetFrameStats(TYPE_FrameSlot *frameSlot);
+		double					CalculateSaturation(const TYPE_FrameStats *frameStats);
+		float					CalculateHistogramMax(const TYPE_FrameStats *frameStats);
 
 		//*****************************************************************************
 
@@ -588,6 +784,7 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 		virtual	TYPE_ASCOM_STATUS		Start_Video(void);
 		virtual	TYPE_ASCOM_STATUS		Stop_Video(void);
 		virtual	TYPE_ASCOM_STATUS		Take_Video(void);
+		virtual	TYPE_ASCOM_STATUS		Read_VideoFrame(unsigned char *imageDataPtr, const long imageDataLen);
 
 		virtual	TYPE_ASCOM_STATUS		SetFlipMode(const int newFlipMode);
 
@@ -697,8 +894,34 @@ protected:
 	//*****************************************************************************
 	bool				cNewImageReadyToDisplay;
 	long				cCameraDataBuffLen;
-	unsigned char		*cCameraDataBuffer;
-	unsigned char		*cCameraBGRbuffer;			//*	Blue, Green, Red, for FITS
+	unsigned char		*cCameraDataBuffer;			//*	points into the readout slot (or the latest frame)
+
+	//*	ring of image buffers, cFrameSlotMutex protects the indexes and the ref counts
+	pthread_mutex_t		cFrameSlotMutex;
+	pthread_cond_t		cFrameSlotReleased;
+	TYPE_FrameSlot		cFrameSlot[kMaxFrameSlotCnt];
+	int					cFrameSlotCnt;				//*	slots that fit in cFrameSlotMemBudget
+	long				cFrameSlotMemBudget;		//*	bytes for all of the frame slots
+	int					cReadoutSlotIdx;			//*	slot the camera is reading into, -1 = none
+	int					cLatestFrameSlotIdx;		//*	most recent completed frame, -1 = none
+
+	//*	background image saving, cSaveQueueMutex protects the queue and the statistics
+	pthread_mutex_t		cSaveQueueMutex;
+	pthread_cond_t		cSaveQueueNotEmpty;
+	pthread_cond_t		cSaveQueueNotFull;
+	TYPE_SaveJob		cSaveQueue[kSaveQueueDepth];
+	int					cSaveQueueHead;				//*	index of the oldest job
+	int					cSaveQueueCount;			//*	jobs waiting for a writer
+	int					cSaveJobsActive;			//*	jobs being written
+	int					cSaveWriterCnt;
+	bool				cSaveWriterKeepRunning;
+	pthread_t			cSaveWriterThreadID[kMaxSaveWriterThreads];
+	uint32_t			cSaveJobsCompleted;
+	uint32_t			cSaveJobsDropped;
+	uint32_t			cSaveWriteLast_us;
+	uint32_t			cSaveWriteMax_us;
+	uint64_t			cSaveWriteTotal_us;
+	uint64_t			cSaveBytesWritten;
 
 	int					cAVIfourCC;					//*	the fourCC mode used in the avi file
 
@@ -738,6 +961,52 @@ protected:
 	bool				cVideoCreateTimeStampFile;
 	FILE				*cVideoTimeStampFilePtr;
 
+	//*	video pipeline, cVideoMutex protects the pool, the queue and the counters
+	//*	cNumVideoFramesSaved counts the frames that made it into the queue
+	pthread_mutex_t		cVideoMutex;
+	pthread_cond_t		cVideoQueueNotEmpty;
+	TYPE_VideoFrame		cVideoFramePool[kVideoFramePoolSize];
+	int					cVideoFreeList[kVideoFramePoolSize];	//*	indexes of the frames not in use
+	int					cVideoFreeCount;
+	int					cVideoQueue[kVideoFramePoolSize];		//*	frames waiting for the encoder
+	int					cVideoQueueHead;						//*	index of the oldest frame
+	int					cVideoQueueCount;
+	int					cVideoQueueHighWater;
+	unsigned char		*cVideoDropBuffer;						//*	sensor frames with no free buffer are read into here
+	long				cVideoFrameSize;
+	int					cVideoFrameWidth;
+	int					cVideoFrameHeight;
+	TYPE_IMAGE_TYPE		cVideoImageType;
+	bool				cVideoEncoderRunning;
+	bool				cVideoEncoderKeepRunning;
+	pthread_t			cVideoEncoderThreadID;
+	uint32_t			cVideoFramesEncoded;
+	uint32_t			cVideoFramesDropped;
+	uint32_t			cVideoEncodeLast_us;
+	uint32_t			cVideoEncodeMax_us;
+	uint64_t			cVideoEncodeTotal_us;
+	TYPE_VIDEO_FORMAT	cVideoFormat;
+	TYPE_SERfile		cSERfile;								//*	fileDesc is -1 when not open
+
+	//*	MJPEG live view, cMJPEGmutex protects the viewers, the images and the counters
+	pthread_mutex_t		cMJPEGmutex;
+	pthread_cond_t		cMJPEGnewFrame;
+	TYPE_MJPEGviewer	cMJPEGviewer[kMaxMJPEGviewers];
+	int					cMJPEGviewerCnt;
+	uint32_t			cMJPEGframeSeq;							//*	bumped for each new frame and each new viewer
+	bool				cMJPEGencoderRunning;
+	bool				cMJPEGkeepRunning;
+	pthread_t			cMJPEGencoderThreadID;
+	uint32_t			cMJPEGframesEncoded;					//*	one per frame per size
+	uint32_t			cMJPEGframesDropped;					//*	all viewers, including ones that have left
+	uint32_t			cMJPEGviewersTotal;
+	uint32_t			cMJPEGencodeLast_us;
+	uint32_t			cMJPEGencodeMax_us;
+	uint64_t			cMJPEGencodeTotal_us;
+	uint32_t			cMJPEGrateFrameCnt;
+	struct timeval		cMJPEGrateStartTime;
+	double				cMJPEGframeRate;						//*	frames per second going out to the viewers
+
 
 	struct timeval		cDownloadStartTime;
 	struct timeval		cDownloadEndTime;
@@ -846,16 +1115,15 @@ public:
 	bool				cRotatorInfoValid;
 	bool				cFilterWheelInfoValid;
 
-	void			AddToDataProductsList(const char *newDataProductName, const char *newDatacomment=NULL);
-	TYPE_FILENAME	cOtherDataProducts[kMaxDataProducts];
-	int				cOtherDataCnt;
+	void			AddToDataProductsList(TYPE_SaveJob *saveJob, const char *newDataProductName, const char *newDatacomment=NULL);
 
 
 #ifdef _INCLUDE_HISTOGRAM_
 	//*****************************************************************************
 	//*	image analysis data
 	void		CalculateHistogramArray(void);
-	void		SaveHistogramFile(void);
+	void		CalculateSaveJobHistogram(TYPE_SaveJob *saveJob);
+	void		SaveHistogramFile(TYPE_SaveJob *saveJob);
 
 	int32_t		cHistogramLum[256];
 	int32_t		cHistogramRed[256];
@@ -906,4 +1174,15 @@ extern	const char			*gCameraStateStrings[];
 void	GetImageTypeString(TYPE_IMAGE_TYPE imageType, char *imageTypeString);
 void	*StartCameraReadThread(void *arg);
 
+#ifdef _USE_OPENCV_
+//*	openCV images with their pixels in the image pool (cameradriver_save.cpp)
+#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+	cv::Mat		*OpenCV_CreatePooledImage(const int width, const int height, const int cvType);
+	void		OpenCV_ReleasePooledImage(cv::Mat **imagePtr);
+#else
+	IplImage	*OpenCV_CreatePooledImage(const int width, const int height, const int depth, const int channels);
+	void		OpenCV_ReleasePooledImage(IplImage **imagePtr);
+#endif // _USE_OPENCV_CPP_
+#endif // _USE_OPENCV_
+
 #endif		//	_CAMERA_DRIVER_H_
@@ -45,11 +45,17 @@
 //*	Jan 12,	2020	<MLS> Added better limit checking to AutoAdjustExposure()
 //*	Feb 15,	2020	<MLS> Fixed negative exposure bug in AutoAdjustExposure()
 //*	Apr 22,	2024	<MLS> Added support for kImageType_MONO8 (8 bit image type)
+//*	Oct 16,	2026	<MLS> Min/Max/Saturation can now be calculated on any image buffer (save jobs)
+//*	Oct 16,	2026	<MLS> Replaced the separate min/max/saturation passes with GetFrameStats()
+//*	Oct 16,	2026	<MLS> AutoAdjustExposure() and CalculateHistogramArray() use the cached frame stats
+//*	Oct 17,	2026	<MLS> Added CalculateSaveJobHistogram(), the histogram of a save job is done by the writer
+//*	Oct 17,	2026	<MLS> GetFrameStats() allocates the frame statistics the first time they are needed
 //**************************************************************************
 
 #ifdef _ENABLE_CAMERA_
 
 #include	<stdio.h>
+#include	<stdlib.h>
 #include	<string.h>
 
 #if defined(__arm__)
@@ -62,273 +68,82 @@
 #include	"alpacadriver.h"
 #include	"alpacadriver_helper.h"
 #include	"cameradriver.h"
+#include	"framestats.h"
 
 
 
 //**************************************************************************
-//*	Calculate the minimum pixel value for the current data buffer
+//*	returns -1 if there is no frame stats format for the image type
 //**************************************************************************
-uint32_t	CameraDriver::CalculateMinPixValue(void)
+static int	GetFrameStatsFormat(TYPE_IMAGE_TYPE imageType)
 {
-uint32_t		minPixelValue;
-uint32_t		imageDataLen;
-uint32_t		currPixValue;
-uint32_t		ii;
-uint32_t		cc;
-uint16_t		*imageDataPtr16bit;
-uint8_t			*imageDataPtr8bit;
-uint32_t		redValue;
-uint32_t		grnValue;
-uint32_t		bluValue;
-
-//	CONSOLE_DEBUG(__FUNCTION__);
-
-	minPixelValue	=	65535;
-	imageDataLen	=	cCameraProp.CameraXsize * cCameraProp.CameraYsize;
-
-	if (cCameraDataBuffer != NULL)
-	{
-		GetImage_ROI_info();
-
-		switch(cROIinfo.currentROIimageType)
-		{
-			case kImageType_RAW8:
-			case kImageType_MONO8:
-			case kImageType_Y8:
-				imageDataPtr8bit	=	(uint8_t *)cCameraDataBuffer;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					currPixValue	=	imageDataPtr8bit[ii] & 0x00ff;
-					if (currPixValue < minPixelValue)
-					{
-						minPixelValue	=	currPixValue;
-					}
-				}
-				break;
-
-			case kImageType_RAW16:
-				imageDataPtr16bit	=	(uint16_t *)cCameraDataBuffer;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					currPixValue	=	imageDataPtr16bit[ii] & 0x00ffff;
-					if (currPixValue < minPixelValue)
-					{
-						minPixelValue	=	currPixValue;
-					}
-				}
-				break;
+int		frameStatsFormat;
 
+	switch(imageType)
+	{
+		case kImageType_RAW8:
+		case kImageType_MONO8:
+		case kImageType_Y8:
+			frameStatsFormat	=	kFrameStats_Mono8;
+			break;
 
-			case kImageType_RGB24:
-				imageDataPtr8bit	=	(uint8_t *)cCameraDataBuffer;
-				cc					=	0;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					redValue	=	imageDataPtr8bit[cc + 0] & 0x00ff;
-					grnValue	=	imageDataPtr8bit[cc + 1] & 0x00ff;
-					bluValue	=	imageDataPtr8bit[cc + 2] & 0x00ff;
-					if (redValue < minPixelValue)
-					{
-						minPixelValue	=	redValue;
-					}
-					if (grnValue < minPixelValue)
-					{
-						minPixelValue	=	grnValue;
-					}
-					if (bluValue < minPixelValue)
-					{
-						minPixelValue	=	bluValue;
-					}
-					cc	+=	3;
-				}
-				break;
-
-			default:
-				minPixelValue	=	0;
-				break;
+		case kImageType_RAW16:
+			frameStatsFormat	=	kFrameStats_Mono16;
+			break;
 
-		}
+		case kImageType_RGB24:
+			frameStatsFormat	=	kFrameStats_BGR24;
+			break;
 
+		default:
+			frameStatsFormat	=	-1;
+			break;
 	}
-	CONSOLE_DEBUG_W_NUM("minPixelValue\t=",	minPixelValue);
-	return(minPixelValue);
+	return(frameStatsFormat);
 }
 
 //**************************************************************************
-//*	Calculate the maximum pixel value for the current data buffer
+//*	The statistics are calculated the first time they are asked for and kept
+//*	with the frame, the FITS writer, auto exposure and readall all share them.
+//*	The caller has to hold a reference to one of the cFrameSlot[] slots.
+//*	Returns NULL if the image type is not supported
 //**************************************************************************
-uint32_t	CameraDriver::CalculateMaxPixValue(void)
+const TYPE_FrameStats	*CameraDriver::GetFrameStats(TYPE_FrameSlot *frameSlot)
 {
-uint32_t		maxPixelValue;
-uint32_t		imageDataLen;
-uint32_t		currPixValue;
-uint32_t		ii;
-uint32_t		cc;
-uint16_t		*imageDataPtr16bit;
-uint8_t			*imageDataPtr8bit;
-uint32_t		redValue;
-uint32_t		grnValue;
-uint32_t		bluValue;
-
-//	CONSOLE_DEBUG(__FUNCTION__);
-
-	maxPixelValue	=	0;
-	imageDataLen	=	cCameraProp.CameraXsize * cCameraProp.CameraYsize;
-
-	if (cCameraDataBuffer != NULL)
-	{
-		GetImage_ROI_info();
+const TYPE_FrameStats	*frameStats;
+int						frameStatsFormat;
 
-		switch(cROIinfo.currentROIimageType)
+	frameStats	=	NULL;
+	if ((frameSlot != NULL) && (frameSlot->dataBuffer != NULL))
+	{
+		pthread_mutex_lock(&frameSlot->statsMutex);
+		if (frameSlot->frameStats == NULL)
 		{
-			case kImageType_RAW8:
-			case kImageType_MONO8:
-			case kImageType_Y8:
-				imageDataPtr8bit	=	(uint8_t *)cCameraDataBuffer;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					currPixValue	=	imageDataPtr8bit[ii] & 0x00ff;
-					if (currPixValue > maxPixelValue)
-					{
-						maxPixelValue	=	currPixValue;
-					}
-				}
-				break;
-
-			case kImageType_RAW16:
-				imageDataPtr16bit	=	(uint16_t *)cCameraDataBuffer;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					currPixValue	=	imageDataPtr16bit[ii] & 0x00ffff;
-					if (currPixValue > maxPixelValue)
-					{
-						maxPixelValue	=	currPixValue;
-					}
-				}
-				break;
-
-
-			case kImageType_RGB24:
-				imageDataPtr8bit	=	(uint8_t *)cCameraDataBuffer;
-				cc					=	0;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					redValue	=	imageDataPtr8bit[cc + 0] & 0x00ff;
-					grnValue	=	imageDataPtr8bit[cc + 1] & 0x00ff;
-					bluValue	=	imageDataPtr8bit[cc + 2] & 0x00ff;
-					if (redValue > maxPixelValue)
-					{
-						maxPixelValue	=	redValue;
-					}
-					if (grnValue > maxPixelValue)
-					{
-						maxPixelValue	=	grnValue;
-					}
-					if (bluValue > maxPixelValue)
-					{
-						maxPixelValue	=	bluValue;
-					}
-					cc	+=	3;
-				}
-				break;
-
-			default:
-				maxPixelValue	=	0;
-				break;
-
+			frameSlot->frameStats	=	(TYPE_FrameStats *)calloc(1, sizeof(TYPE_FrameStats));
 		}
-
-	}
-//	CONSOLE_DEBUG_W_INT32("maxPixelValue\t=", maxPixelValue);
-	return(maxPixelValue);
-}
-
-
-//**************************************************************************
-//*	Count the number of pixels at saturation
-//*		for raw8, a saturated pixel is one that has a value of 255
-//*		for raw16, a saturated pixel is one that has a value of 65535
-//*		for RGB24, if any of the 3 RGB values is 255, then that pixel is at saturation
-//**************************************************************************
-uint32_t	CameraDriver::CountSaturationPixels(void)
-{
-uint32_t		imageDataLen;
-uint32_t		currPixValue;
-uint32_t		saturatedPixCnt;
-uint32_t		ii;
-uint32_t		cc;
-uint32_t		redValue;
-uint32_t		grnValue;
-uint32_t		bluValue;
-uint16_t		*imageDataPtr16bit;
-uint8_t			*imageDataPtr8bit;
-
-//	CONSOLE_DEBUG(__FUNCTION__);
-
-	imageDataLen	=	cCameraProp.CameraXsize * cCameraProp.CameraYsize;
-	saturatedPixCnt	=	0;
-
-	if (cCameraDataBuffer != NULL)
-	{
-		GetImage_ROI_info();
-
-		switch(cROIinfo.currentROIimageType)
+		if ((frameSlot->frameStats != NULL) && (frameSlot->frameStats->valid == false))
 		{
-			case kImageType_RAW8:
-			case kImageType_MONO8:
-			case kImageType_Y8:
-				imageDataPtr8bit	=	(uint8_t *)cCameraDataBuffer;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					currPixValue	=	imageDataPtr8bit[ii] & 0x00ff;
-					if (currPixValue == 0x0ff)
-					{
-						saturatedPixCnt++;
-					}
-				}
-				break;
-
-			case kImageType_RAW16:
-				imageDataPtr16bit	=	(uint16_t *)cCameraDataBuffer;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					currPixValue	=	imageDataPtr16bit[ii] & 0x00ffff;
-					if (currPixValue == 0x0ffff)
-					{
-						saturatedPixCnt++;
-					}
-				}
-				break;
-
-
-			case kImageType_RGB24:
-				imageDataPtr8bit	=	(uint8_t *)cCameraDataBuffer;
-				cc					=	0;
-				for (ii=0; ii<imageDataLen; ii++)
-				{
-					redValue	=	imageDataPtr8bit[cc + 0] & 0x00ff;
-					grnValue	=	imageDataPtr8bit[cc + 1] & 0x00ff;
-					bluValue	=	imageDataPtr8bit[cc + 2] & 0x00ff;
-					if ((redValue == 0x0ff) || (grnValue == 0x0ff) || (bluValue == 0x0ff))
-					{
-						saturatedPixCnt++;
-					}
-					cc	+=	3;
-				}
-				break;
-
-			default:
-				saturatedPixCnt	=	0;
-				break;
-
+			frameStatsFormat	=	GetFrameStatsFormat(frameSlot->roiInfo.currentROIimageType);
+			if (frameStatsFormat >= 0)
+			{
+				FrameStats_Calculate(	frameSlot->frameStats,
+										frameSlot->dataBuffer,
+										frameSlot->roiInfo.currentROIwidth,
+										frameSlot->roiInfo.currentROIheight,
+										frameStatsFormat,
+										0);
+				CONSOLE_DEBUG_W_DBL("Frame stats time (ms)\t=", frameSlot->frameStats->calcTime_ms);
+			}
+		}
+		if ((frameSlot->frameStats != NULL) && frameSlot->frameStats->valid)
+		{
+			frameStats	=	frameSlot->frameStats;
 		}
+		pthread_mutex_unlock(&frameSlot->statsMutex);
 	}
-
-	return(saturatedPixCnt);
+	return(frameStats);
 }
 
-
-
 //**************************************************************************
 //*	Calculate the percentage of saturated pixels
 //*		for raw8, a saturated pixel is one that has a value of 255
@@ -336,21 +151,16 @@ uint8_t			*imageDataPtr8bit;
 //*		for RGB24, if any of the 3 RGB values is 255, then that pixel is at saturation
 //*	Return value is a percentage, (0.0 -> 100.0)
 //**************************************************************************
-double	CameraDriver::CalculateSaturation(void)
+double	CameraDriver::CalculateSaturation(const TYPE_FrameStats *frameStats)
 {
 double			saturatedPrct;
-uint32_t		saturatedPixCnt;
-uint32_t		imageDataLen;
-
-//	CONSOLE_DEBUG(__FUNCTION__);
-
-	saturatedPixCnt	=	CountSaturationPixels();
-	imageDataLen	=	cCameraProp.CameraXsize * cCameraProp.CameraYsize;
-	saturatedPrct	=	(saturatedPixCnt * 100.0) / imageDataLen;
 
-//	CONSOLE_DEBUG_W_INT32("saturatedPixCnt\t=",	saturatedPixCnt);
+	saturatedPrct	=	0.0;
+	if ((frameStats != NULL) && (frameStats->pixelCount > 0))
+	{
+		saturatedPrct	=	(frameStats->saturatedPixelCnt * 100.0) / frameStats->pixelCount;
+	}
 //	CONSOLE_DEBUG_W_DBL("saturatedPrct\t=",		saturatedPrct);
-
 	return(saturatedPrct);
 }
 
@@ -358,39 +168,15 @@ uint32_t		imageDataLen;
 //**************************************************************************
 //*	returns the maximum pixel value as a percentage
 //**************************************************************************
-float	CameraDriver::CalculateHistogramMax(void)
+float	CameraDriver::CalculateHistogramMax(const TYPE_FrameStats *frameStats)
 {
 float			histogramMaxPrct;
-uint32_t		maxPixelValue;
-
-//	CONSOLE_DEBUG(__FUNCTION__);
-
-	maxPixelValue	=	CalculateMaxPixValue();
-//	CONSOLE_DEBUG_W_INT32("maxPixelValue\t",	maxPixelValue);
 
-	switch(cROIinfo.currentROIimageType)
+	histogramMaxPrct	=	0;
+	if ((frameStats != NULL) && (frameStats->saturationValue > 0))
 	{
-		case kImageType_RAW8:
-		case kImageType_MONO8:
-		case kImageType_Y8:
-		case kImageType_RGB24:
-			histogramMaxPrct	=	(100.0 * maxPixelValue) / 255.0;
-			break;
-
-		case kImageType_RAW16:
-			histogramMaxPrct	=	(100.0 * maxPixelValue) / 65535.0;
-			break;
-
-
-			break;
-
-		default:
-			histogramMaxPrct	=	0;
-			break;
-
+		histogramMaxPrct	=	(100.0 * frameStats->all.maxValue) / frameStats->saturationValue;
 	}
-
-
 	return(histogramMaxPrct);
 }
 
@@ -399,18 +185,39 @@ uint32_t		maxPixelValue;
 void	CameraDriver::AutoAdjustExposure(void)
 {
 //uint32_t	maxPixelValue;
-float			saturationPrct;
-float			histogrmMaxPrct;
-float			histogramErr;
-long			exposureAdjustment_us;	//*	micro-seconds
+float					saturationPrct;
+float					histogrmMaxPrct;
+float					histogramErr;
+long					exposureAdjustment_us;	//*	micro-seconds
+TYPE_FrameSlot			*frameSlot;
+const TYPE_FrameStats	*frameStats;
+bool					statsValid;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 
-	saturationPrct	=	CalculateSaturation();
-	histogrmMaxPrct	=	CalculateHistogramMax();
+	//*	the statistics of the frame that was just read out, shared with the FITS header
+	statsValid		=	false;
+	saturationPrct	=	0.0;
+	histogrmMaxPrct	=	0.0;
+	frameSlot		=	AcquireLatestFrame();
+	if (frameSlot != NULL)
+	{
+		frameStats	=	GetFrameStats(frameSlot);
+		if (frameStats != NULL)
+		{
+			saturationPrct	=	CalculateSaturation(frameStats);
+			histogrmMaxPrct	=	CalculateHistogramMax(frameStats);
+			statsValid		=	true;
+		}
+		ReleaseFrame(frameSlot);
+	}
 	CONSOLE_DEBUG_W_DBL("saturationPrct\t=",	saturationPrct);
 
-	if ((histogrmMaxPrct >= 90.0) && (histogrmMaxPrct < 100.0))
+	if (statsValid == false)
+	{
+		CONSOLE_DEBUG("No frame statistics, exposure not changed");
+	}
+	else if ((histogrmMaxPrct >= 90.0) && (histogrmMaxPrct < 100.0))
 	{
 		CONSOLE_DEBUG_W_DBL("PERFECT: Histogram %\t=",	histogrmMaxPrct);
 	}
@@ -546,148 +353,160 @@ long			exposureAdjustment_us;	//*	micro-seconds
 
 #ifdef _INCLUDE_HISTOGRAM_
 //*****************************************************************************
-void	CameraDriver::CalculateHistogramArray(void)
+//*	fills in the 256 entry arrays from the frame statistics, 16 bit data is shifted right 8 bits
+//*****************************************************************************
+static void	FillHistogramArrays(const TYPE_FrameStats	*frameStats,
+								int32_t					*histogramLum,
+								int32_t					*histogramRed,
+								int32_t					*histogramGrn,
+								int32_t					*histogramBlu)
 {
-int32_t			imageDataLen;
-int32_t			currPixValue;
 int32_t			iii;
-int32_t			ccc;
-uint16_t		*imageDataPtr16bit;
-uint8_t			*imageDataPtr8bit;
-int32_t			redValue;
-int32_t			grnValue;
-int32_t			bluValue;
 int32_t			lumValue;		//*	luminance value
-int32_t			peakPixelIdx;
-int32_t			peakPixelCount;
-bool			lookingForMin;
+const uint32_t	*histogram;
+
+	//*	clear out the histogram data array
+	memset(histogramLum,	0,	(256 * sizeof(int32_t)));
+	memset(histogramRed,	0,	(256 * sizeof(int32_t)));
+	memset(histogramGrn,	0,	(256 * sizeof(int32_t)));
+	memset(histogramBlu,	0,	(256 * sizeof(int32_t)));
+
+	switch(frameStats->format)
+	{
+		case kFrameStats_Mono8:
+			histogram	=	FrameStats_GetHistogram(frameStats, 0);
+			for (iii=0; iii<256; iii++)
+			{
+				histogramLum[iii]	=	histogram[iii];
+			}
+			break;
+
+		case kFrameStats_Mono16:
+			histogram	=	FrameStats_GetHistogram(frameStats, 0);
+			for (iii=0; iii<65536; iii++)
+			{
+				histogramLum[iii >> 8]	+=	histogram[iii];
+			}
+			break;
+
+		case kFrameStats_BGR24:
+			for (iii=0; iii<256; iii++)
+			{
+				histogramRed[iii]	=	FrameStats_GetHistogram(frameStats, 0)[iii];
+				histogramGrn[iii]	=	FrameStats_GetHistogram(frameStats, 1)[iii];
+				histogramBlu[iii]	=	FrameStats_GetHistogram(frameStats, 2)[iii];
+			}
+
+			//*	now calculate the luminance
+			for (iii=0; iii<256; iii++)
+			{
+				lumValue	=	histogramRed[iii];
+				lumValue	+=	histogramGrn[iii];
+				lumValue	+=	histogramBlu[iii];
+				lumValue	=	(lumValue / 3);
+
+				histogramLum[iii]	=	lumValue;
+			}
+			break;
+
+		default:
+			break;
+
+	}
+}
+
+//*****************************************************************************
+//*	go through the luminance array and find the min, max and peak values
+//*****************************************************************************
+static void	FindHistogramLimits(const int32_t	*histogramLum,
+								int32_t			*minValue,
+								int32_t			*maxValue,
+								int32_t			*peakValue)
+{
+int32_t		iii;
+int32_t		peakPixelIdx;
+int32_t		peakPixelCount;
+bool		lookingForMin;
+
+	*minValue			=	0;
+	*maxValue			=	0;
+	peakPixelIdx		=	-1;
+	peakPixelCount		=	0;
+	lookingForMin		=	true;
+	for (iii=0; iii<256; iii++)
+	{
+		//*	find the minimum value
+		if (lookingForMin && (histogramLum[iii] > 0))
+		{
+			*minValue		=	iii;
+			lookingForMin	=	false;
+		}
+		//*	find the maximum value
+		if (histogramLum[iii] > 0)
+		{
+			*maxValue	=	iii;
+		}
+		//*	find the peak value
+		if (histogramLum[iii] > peakPixelCount)
+		{
+			peakPixelIdx	=	iii;
+			peakPixelCount	=	histogramLum[iii];
+		}
+	}
+	*peakValue	=	peakPixelIdx;
+}
+
+//*****************************************************************************
+//*	the 256 entry arrays are for the live display and the .csv file,
+//*	they are filled in from the frame statistics
+//*****************************************************************************
+void	CameraDriver::CalculateHistogramArray(void)
+{
+int32_t					iii;
+TYPE_FrameSlot			*frameSlot;
+const TYPE_FrameStats	*frameStats;
 
 	SETUP_TIMING();
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	START_TIMING();
 
-	imageDataLen	=	cCameraProp.CameraXsize * cCameraProp.CameraYsize;
+	frameStats	=	NULL;
+	frameSlot	=	AcquireLatestFrame();
+	if (frameSlot != NULL)
+	{
+		frameStats	=	GetFrameStats(frameSlot);
+	}
 
-	if (cCameraDataBuffer != NULL)
+	if (frameStats != NULL)
 	{
-		cPeakHistogramValue	=	0;
-		cMaxHistogramValue	=	0;
-		cMaxHistogramPixCnt	=	0;
 		cMaxRedValue		=	0;
 		cMaxGrnValue		=	0;
 		cMaxBluValue		=	0;
 		cMaxGryValue		=	0;
 
-		//*	clear out the histogram data array
-		memset(cHistogramLum,	0,	sizeof(cHistogramLum));
-		memset(cHistogramRed,	0,	sizeof(cHistogramRed));
-		memset(cHistogramGrn,	0,	sizeof(cHistogramGrn));
-		memset(cHistogramBlu,	0,	sizeof(cHistogramBlu));
-
-		//*	figure out what type of image it is
-		GetImage_ROI_info();
-		switch(cROIinfo.currentROIimageType)
+		FillHistogramArrays(frameStats, cHistogramLum, cHistogramRed, cHistogramGrn, cHistogramBlu);
+		switch(frameStats->format)
 		{
-			case kImageType_RAW8:
-			case kImageType_MONO8:
-			case kImageType_Y8:
-				imageDataPtr8bit	=	(uint8_t *)cCameraDataBuffer;
-				for (iii=0; iii<imageDataLen; iii++)
-				{
-					currPixValue	=	imageDataPtr8bit[iii] & 0x00ff;
-
-					cHistogramLum[currPixValue]++;
-
-					if (currPixValue > cMaxGryValue)
-					{
-						cMaxGryValue	=	currPixValue;
-					}
-				}
+			case kFrameStats_Mono8:
+				cMaxGryValue	=	frameStats->all.maxValue;
 				break;
 
-			case kImageType_RAW16:
-				imageDataPtr16bit	=	(uint16_t *)cCameraDataBuffer;
-				for (iii=0; iii<imageDataLen; iii++)
-				{
-					//*	for 16 bit data, we shift it right 8 bits
-					currPixValue	=	imageDataPtr16bit[iii] & 0x00ffff;
-					currPixValue	=	(currPixValue >> 8) & 0x00ff;
-					cHistogramLum[currPixValue]++;
-				}
+			case kFrameStats_Mono16:
+				cMaxGryValue	=	frameStats->all.maxValue >> 8;
 				break;
 
-
-			case kImageType_RGB24:
-				imageDataPtr8bit	=	(uint8_t *)cCameraDataBuffer;
-				ccc					=	0;
-				for (iii=0; iii<imageDataLen; iii++)
-				{
-					//*	openCV uses BGR instead of RGB
-					//*	https://docs.opencv.org/master/df/d24/tutorial_js_image_display.html
-					bluValue	=	imageDataPtr8bit[ccc + 0] & 0x00ff;
-					grnValue	=	imageDataPtr8bit[ccc + 1] & 0x00ff;
-					redValue	=	imageDataPtr8bit[ccc + 2] & 0x00ff;
-					cHistogramRed[redValue]++;
-					cHistogramGrn[grnValue]++;
-					cHistogramBlu[bluValue]++;
-
-					if (redValue > cMaxRedValue)
-					{
-						cMaxRedValue	=	redValue;
-					}
-					if (grnValue > cMaxGrnValue)
-					{
-						cMaxGrnValue	=	grnValue;
-					}
-					if (bluValue > cMaxBluValue)
-					{
-						cMaxBluValue	=	bluValue;
-					}
-					ccc	+=	3;
-				}
-				//*	now calculate the luminance
-				for (iii=0; iii<256; iii++)
-				{
-					lumValue	=	cHistogramRed[iii];
-					lumValue	+=	cHistogramGrn[iii];
-					lumValue	+=	cHistogramBlu[iii];
-					lumValue	=	(lumValue / 3);
-
-					cHistogramLum[iii]	=	lumValue;
-				}
-
+			case kFrameStats_BGR24:
+				cMaxRedValue	=	frameStats->channel[0].maxValue;
+				cMaxGrnValue	=	frameStats->channel[1].maxValue;
+				cMaxBluValue	=	frameStats->channel[2].maxValue;
 				break;
 
 			default:
 				break;
 
 		}
-		//*	now go through the array and find the peak value and max value
-		peakPixelIdx		=	-1;
-		peakPixelCount		=	0;
-		lookingForMin		=	true;
-		for (iii=0; iii<256; iii++)
-		{
-			//*	find the minimum value
-			if (lookingForMin && (cHistogramLum[iii] > 0))
-			{
-				cMinHistogramValue	=	iii;
-				lookingForMin		=	false;
-			}
-			//*	find the maximum value
-			if (cHistogramLum[iii] > 0)
-			{
-				cMaxHistogramValue	=	iii;
-			}
-			//*	find the peak value
-			if (cHistogramLum[iii] > peakPixelCount)
-			{
-				peakPixelIdx	=	iii;
-				peakPixelCount	=	cHistogramLum[iii];
-			}
-		}
-		cPeakHistogramValue	=	peakPixelIdx;
+		FindHistogramLimits(cHistogramLum, &cMinHistogramValue, &cMaxHistogramValue, &cPeakHistogramValue);
 
 		//*	look for maximum pixel counts
 		cMaxHistogramPixCnt	=	0;
@@ -719,19 +538,52 @@ bool			lookingForMin;
 	}
 	else
 	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
+		CONSOLE_DEBUG("No frame statistics");
+	}
+	if (frameSlot != NULL)
+	{
+		ReleaseFrame(frameSlot);
 	}
 }
 
 //*****************************************************************************
-void	CameraDriver::SaveHistogramFile(void)
+//*	runs on a save writer thread, works on the frame of the job
+//*	and does not touch the arrays used by the live display
+//*****************************************************************************
+void	CameraDriver::CalculateSaveJobHistogram(TYPE_SaveJob *saveJob)
+{
+const TYPE_FrameStats	*frameStats;
+int32_t					histogramLum[256];
+int32_t					histogramRed[256];
+int32_t					histogramGrn[256];
+int32_t					histogramBlu[256];
+
+	frameStats	=	NULL;
+	if (saveJob->frameSlot != NULL)
+	{
+		frameStats	=	GetFrameStats(saveJob->frameSlot);
+	}
+	if (frameStats != NULL)
+	{
+		FillHistogramArrays(frameStats, histogramLum, histogramRed, histogramGrn, histogramBlu);
+		FindHistogramLimits(histogramLum,	&saveJob->minHistogramValue,
+											&saveJob->maxHistogramValue,
+											&saveJob->peakHistogramValue);
+	}
+}
+
+//*****************************************************************************
+//*	the histogram arrays are not part of the save job,
+//*	this has to be called before the next frame is read out
+//*****************************************************************************
+void	CameraDriver::SaveHistogramFile(TYPE_SaveJob *saveJob)
 {
 char	csvPathName[256];
 char	csvFileName[256];
 int		ii;
 FILE	*csvFile;
 
-	strcpy(csvFileName, cFileNameRoot);
+	strcpy(csvFileName, saveJob->fileNameRoot);
 	strcat(csvFileName, ".csv");
 
 	strcpy(csvPathName, gImageDataDir);
@@ -741,7 +593,7 @@ FILE	*csvFile;
 	csvFile	=	fopen(csvPathName, "w");
 	if (csvFile != NULL)
 	{
-		if (cROIinfo.currentROIimageType == kImageType_RGB24)
+		if (saveJob->roiInfo.currentROIimageType == kImageType_RGB24)
 		{
 			//*	print out lum, red, grn, blu
 			for (ii=0; ii<256; ii++)
@@ -761,7 +613,7 @@ FILE	*csvFile;
 		}
 
 		fclose(csvFile);
-		AddToDataProductsList(csvFileName, "Histogram data");
+		AddToDataProductsList(saveJob, csvFileName, "Histogram data");
 	}
 	else
 	{
@@ -106,6 +106,10 @@
 //*	Apr 22,	2024	<MLS> Added support for kImageType_MONO8 (8 bit image type)
 //*	Nov 18,	2024	<MLS> Added local path option for saving file in case specified path fails
 //*	Dec  2,	2024	<MLS> Added COPYRGHT to FITS header
+//*	Oct 16,	2026	<MLS> FITS files are written from a TYPE_SaveJob on a save writer thread
+//*	Oct 16,	2026	<MLS> CreateFitsBGRimage() now returns a buffer owned by the caller
+//*	Oct 16,	2026	<MLS> DATAMIN/DATAMAX/SATPIXEL come from the cached frame statistics
+//*	Oct 17,	2026	<MLS> CreateFitsBGRimage() buffer comes from the image pool, free it with ImagePool_Free()
 //*****************************************************************************
 //*	https://heasarc.gsfc.nasa.gov/docs/software/fitsio/c/c_user/cfitsio.html
 //*****************************************************************************
@@ -402,7 +406,7 @@ void	CameraDriver::UpdateRotatorLink(void)
 //*	http://iraf.noao.edu/projects/ccdmosaic/imagedef/fitsdic.html
 //*	https://diffractionlimited.com/help/maximdl/FITS_File_Header_Definitions.htm
 //*****************************************************************************
-int	CameraDriver::SaveImageAsFITS(bool headerOnly)
+int	CameraDriver::SaveImageAsFITS(bool headerOnly, TYPE_SaveJob *saveJob)
 {
 fitsfile		*fitsFilePtr;
 int				fitsRetCode;
@@ -422,13 +426,21 @@ uint32_t		startMillisecs;
 uint32_t		stopMillisecs;
 uint32_t		deltaMillisecs;
 int				iii;
+TYPE_SaveJob	localSaveJob;
+unsigned char	*bgrBuffer;
+bool			usedLocalPath;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 	startMillisecs	=	millis();
 
-	GenerateFileNameRoot();
-	strcpy(imageFileName, cFileNameRoot);
-	strcpy(imageFileName, cFileNameRoot);
+	if (saveJob == NULL)
+	{
+		//*	header only (AVI) files are written directly, everything comes from the current settings
+		memset(&localSaveJob, 0, sizeof(TYPE_SaveJob));
+		FillSaveJob(&localSaveJob);
+		saveJob	=	&localSaveJob;
+	}
+	strcpy(imageFileName, saveJob->fileNameRoot);
 	strcat(imageFileName, ".fits");
 
 	strcpy(imageFilePath, gImageDataDir);
@@ -443,8 +455,8 @@ int				iii;
 
 
 
-	naxes[0]		=	cCameraProp.CameraXsize;
-	naxes[1]		=	cCameraProp.CameraYsize;
+	naxes[0]		=	saveJob->cameraProp.CameraXsize;
+	naxes[1]		=	saveJob->cameraProp.CameraYsize;
 	naxes[2]		=	3;				//*	only used for color RGB images (3 planes)
 	axisCnt			=	2;				//*	for all formats except RGB
 	fits_bitpix		=	SHORT_IMG;
@@ -454,7 +466,7 @@ int				iii;
 	//*	for information about the BZERO data element, refer to
 	//*		https://docs.astropy.org/en/stable/io/fits/usage/image.html
 
-	switch(cROIinfo.currentROIimageType)
+	switch(saveJob->roiInfo.currentROIimageType)
 	{
 		case kImageType_RAW8:
 		case kImageType_MONO8:
@@ -502,8 +514,9 @@ int				iii;
 	}
 
 
-	fitsStatus	=	0;
-	fitsRetCode	=	fits_create_file(&fitsFilePtr, imageFilePath, &fitsStatus);
+	usedLocalPath	=	false;
+	fitsStatus		=	0;
+	fitsRetCode		=	fits_create_file(&fitsFilePtr, imageFilePath, &fitsStatus);
 	//------------------------------------------------------------------------------------------
 	//*	if it failed to create, try the local path
 	if (fitsRetCode != 0)
@@ -513,8 +526,9 @@ int				iii;
 		if (strcmp(imageFilePath, localFilePath) != 0)
 		{
 			CONSOLE_DEBUG_W_STR("Trying alternate path:", localFilePath)
-			fitsStatus	=	0;
-			fitsRetCode	=	fits_create_file(&fitsFilePtr, localFilePath, &fitsStatus);
+			fitsStatus		=	0;
+			fitsRetCode		=	fits_create_file(&fitsFilePtr, localFilePath, &fitsStatus);
+			usedLocalPath	=	true;
 		}
 	}
 
@@ -546,7 +560,7 @@ int				iii;
 
 		//============================================================
 		//*	output info about the observation
-		WriteFITS_ObservationInfo(fitsFilePtr, (headerOnly == false));
+		WriteFITS_ObservationInfo(fitsFilePtr, saveJob, (headerOnly == false));
 
 		//*	leave FILENAME here so we dont have to pass the filename to the routine
 		fitsStatus	=	0;
@@ -554,7 +568,7 @@ int				iii;
 												imageFileName,
 												"Orig filename", &fitsStatus);
 		//*	were any other data products created
-		if (cOtherDataCnt > 0)
+		if (saveJob->otherDataCnt > 0)
 		{
 		char	tagString[64];
 
@@ -563,12 +577,12 @@ int				iii;
 													(char *)"Other data products created",
 													NULL, &fitsStatus);
 
-			for (iii=0; iii<cOtherDataCnt; iii++)
+			for (iii=0; iii<saveJob->otherDataCnt; iii++)
 			{
 				sprintf(tagString, "FILENAM%d", (iii + 1));
 				fits_write_key(fitsFilePtr, TSTRING,	tagString,
-														cOtherDataProducts[iii].filename,
-														cOtherDataProducts[iii].comment,
+														saveJob->otherDataProducts[iii].filename,
+														saveJob->otherDataProducts[iii].comment,
 														&fitsStatus);
 			}
 		}
@@ -582,8 +596,7 @@ int				iii;
 
 		if (headerOnly)
 		{
-			strcpy(aviFileName, cFileNameRoot);
-			strcpy(aviFileName, cFileNameRoot);
+			strcpy(aviFileName, saveJob->fileNameRoot);
 			strcat(aviFileName, ".avi");
 
 			fitsStatus	=	0;
@@ -594,24 +607,24 @@ int				iii;
 
 		//============================================================
 		//*	Camera info
-		WriteFITS_CameraInfo(fitsFilePtr);
+		WriteFITS_CameraInfo(fitsFilePtr, saveJob);
 
 		//============================================================
 		//*	Telescope info
-		WriteFITS_TelescopeInfo(fitsFilePtr);
+		WriteFITS_TelescopeInfo(fitsFilePtr, saveJob);
 
 #ifdef _ENABLE_IMU_
 		//============================================================
 		//*	Telescope info
-		if (IMU_IsAvailable())
+		if (saveJob->imuAvailable)
 		{
-			WriteFITS_IMUinfo(fitsFilePtr);
+			WriteFITS_IMUinfo(fitsFilePtr, saveJob);
 		}
 #endif
 
 		//============================================================
 		//*	Focuser info
-		WriteFITS_FocuserInfo(fitsFilePtr);
+		WriteFITS_FocuserInfo(fitsFilePtr, saveJob);
 
 		//============================================================
 		//*	Rotator info
@@ -619,7 +632,7 @@ int				iii;
 
 		//============================================================
 		//*	Filterwheel info
-		WriteFITS_FilterwheelInfo(fitsFilePtr);
+		WriteFITS_FilterwheelInfo(fitsFilePtr, saveJob);
 
 		//============================================================
 		//*	Observatory info
@@ -631,7 +644,7 @@ int				iii;
 
 		//============================================================
 		//*	Moon information
-		WriteFITS_MoonInfo(fitsFilePtr);
+		WriteFITS_MoonInfo(fitsFilePtr, saveJob);
 
 		//============================================================
 		//*	GPS information
@@ -650,13 +663,13 @@ int				iii;
 		WriteFITS_Seperator(fitsFilePtr, "");
 		//------------------------------------------------------------------------
 		//*	now deal with the image data
-		if ((cCameraDataBuffer != NULL) && (headerOnly == false))
+		if ((saveJob->imageData != NULL) && (headerOnly == false))
 		{
 		LONGLONG		nelements;
 		long			fpixelArray[4];
 
 //			CONSOLE_DEBUG("Writing image data to FITS file");
-			nelements	=	cCameraProp.CameraXsize * cCameraProp.CameraYsize;
+			nelements	=	saveJob->cameraProp.CameraXsize * saveJob->cameraProp.CameraYsize;
 
 
 			fpixelArray[0]	=	1;
@@ -664,7 +677,7 @@ int				iii;
 			fpixelArray[2]	=	1;		//*	RGB images only
 			fitsStatus		=	0;
 //			CONSOLE_DEBUG_W_INT32("nelements\t=", (long)nelements);
-			switch(cROIinfo.currentROIimageType)
+			switch(saveJob->roiInfo.currentROIimageType)
 			{
 				case kImageType_RAW8:
 				case kImageType_RAW16:
@@ -673,24 +686,25 @@ int				iii;
 														fitsDataType,
 														fpixelArray,
 														nelements,
-														cCameraDataBuffer,
+														saveJob->imageData,
 														&fitsStatus);
 					break;
 
 
 				//	Fits doesn't support RGB, it has to be 3 arrays, B, G, R
 				case kImageType_RGB24:
-					CreateFitsBGRimage();
+					bgrBuffer	=	CreateFitsBGRimage(saveJob);
 //					CONSOLE_DEBUG(__FUNCTION__);
-					if (cCameraBGRbuffer != NULL)
+					if (bgrBuffer != NULL)
 					{
-						nelements		=	3 * cCameraProp.CameraXsize * cCameraProp.CameraYsize;
+						nelements		=	3 * saveJob->cameraProp.CameraXsize * saveJob->cameraProp.CameraYsize;
 						fitsRetCode		=	fits_write_pix(	fitsFilePtr,
 												fitsDataType,
 												fpixelArray,
 												nelements,
-												cCameraBGRbuffer,
+												bgrBuffer,
 												&fitsStatus);
+						ImagePool_Free(bgrBuffer);
 					}
 					break;
 
@@ -756,13 +770,24 @@ int				iii;
 		fitsStatus	=	0;
 		fits_write_chksum(fitsFilePtr, &fitsStatus);
 
+		//*	cFitsHeader is shared by all of the writer threads
+		pthread_mutex_lock(&cSaveQueueMutex);
 		ExtractFitsHeader(fitsFilePtr);
+		pthread_mutex_unlock(&cSaveQueueMutex);
 
 		fitsStatus	=	0;
 		fitsRetCode	=	fits_close_file(fitsFilePtr, &fitsStatus);
 		if (fitsRetCode == 0)
 		{
 //			CONSOLE_DEBUG("fits_close_file = SUCCESS");
+			if (usedLocalPath)
+			{
+				AddSavedFileSize(saveJob, localFilePath);
+			}
+			else
+			{
+				AddSavedFileSize(saveJob, imageFilePath);
+			}
 		}
 		else
 		{
@@ -899,13 +924,12 @@ char	lineBuff[128];
 #pragma mark -
 
 //*****************************************************************************
-void	CameraDriver::WriteFITS_CameraInfo(fitsfile *fitsFilePtr)
+void	CameraDriver::WriteFITS_CameraInfo(fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob)
 {
 int		fitsStatus;
 char	stringBuf[128];
 double	megaPixels;
 int		intValue;
-int		ccdTempErrCode;
 char	instrumentString[128];
 
 //	CONSOLE_DEBUG(__FUNCTION__);
@@ -964,34 +988,34 @@ char	instrumentString[128];
 	}
 	//-------------------------------------------------------------------------------
 	//*	Camera FPGA version (QHY, TOUPTEK)
-	if (strlen(cCameraProp.FPGAversion) > 0)
+	if (strlen(saveJob->cameraProp.FPGAversion) > 0)
 	{
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr,	TSTRING,
 									"CAMFPGA",
-									cCameraProp.FPGAversion,
+									saveJob->cameraProp.FPGAversion,
 									"Camera FPGA version", &fitsStatus);
 	}
 	//-------------------------------------------------------------------------------
 	//*	Camera production date (TOUPTEK)
-	if (strlen(cCameraProp.ProductionDate) > 0)
+	if (strlen(saveJob->cameraProp.ProductionDate) > 0)
 	{
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr,	TSTRING,
 									"CAMPROD",
-									cCameraProp.ProductionDate,
+									saveJob->cameraProp.ProductionDate,
 									"Camera Production Date", &fitsStatus);
 	}
 
 	//-------------------------------------------------------------------------------
 	//*	output info about the sensor
-	if (strlen(cCameraProp.SensorName) > 0)
+	if (strlen(saveJob->cameraProp.SensorName) > 0)
 	{
 		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TSTRING, "DETECTOR",	cCameraProp.SensorName,		NULL, &fitsStatus);
+		fits_write_key(fitsFilePtr, TSTRING, "DETECTOR",	saveJob->cameraProp.SensorName,		NULL, &fitsStatus);
 	}
 
-	sprintf(stringBuf, "[1:%d,1:%d]", cCameraProp.CameraXsize, cCameraProp.CameraYsize);
+	sprintf(stringBuf, "[1:%d,1:%d]", saveJob->cameraProp.CameraXsize, saveJob->cameraProp.CameraYsize);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING, "DETSIZE",	stringBuf,		"Detector size", &fitsStatus);
 
@@ -1002,79 +1026,79 @@ char	instrumentString[128];
 
 	//-------------------------------------------------------------------------------
 	fitsStatus	=	0;
-	fits_write_key(fitsFilePtr, TINT,		"IMAGEW",	&cCameraProp.CameraXsize,	NULL, &fitsStatus);
+	fits_write_key(fitsFilePtr, TINT,		"IMAGEW",	&saveJob->cameraProp.CameraXsize,	NULL, &fitsStatus);
 
 	fitsStatus	=	0;
-	fits_write_key(fitsFilePtr, TINT,		"IMAGEH",	&cCameraProp.CameraYsize,	NULL, &fitsStatus);
+	fits_write_key(fitsFilePtr, TINT,		"IMAGEH",	&saveJob->cameraProp.CameraYsize,	NULL, &fitsStatus);
 
 
 	//-------------------------------------------------------------------------------
 	//*	image mode from camera
-	GetImageTypeString(cROIinfo.currentROIimageType, stringBuf);
+	GetImageTypeString(saveJob->roiInfo.currentROIimageType, stringBuf);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING,	"IMGTYPE",
 											stringBuf,
 											"Image mode from camera", &fitsStatus);
 
 	//-------------------------------------------------------------------------------
-	ccdTempErrCode	=	Read_SensorTemp();
-	if (ccdTempErrCode == 0)
+	//*	the temperature was read when the frame was read out
+	if (saveJob->ccdTempErrCode == 0)
 	{
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TDOUBLE,	"CCD-TEMP",
-												&cCameraProp.CCDtemperature,
+												&saveJob->cameraProp.CCDtemperature,
 												"Degrees C", &fitsStatus);
 	}
 
 	//-------------------------------------------------------------------------------
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TDOUBLE,	"XPIXSZ",
-											&cCameraProp.PixelSizeX,
+											&saveJob->cameraProp.PixelSizeX,
 											"X Pixel size in microns", &fitsStatus);
 
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TDOUBLE,	"YPIXSZ",
-											&cCameraProp.PixelSizeY,
+											&saveJob->cameraProp.PixelSizeY,
 											"Y Pixel size in microns", &fitsStatus);
 
 
 	fitsStatus	=	0;
-	fits_write_key(fitsFilePtr, TINT,		"XBINNING",	&cCameraProp.BinX,	NULL, &fitsStatus);
+	fits_write_key(fitsFilePtr, TINT,		"XBINNING",	&saveJob->cameraProp.BinX,	NULL, &fitsStatus);
 
 	fitsStatus	=	0;
-	fits_write_key(fitsFilePtr, TINT,		"YBINNING",	&cCameraProp.BinY,	NULL, &fitsStatus);
+	fits_write_key(fitsFilePtr, TINT,		"YBINNING",	&saveJob->cameraProp.BinY,	NULL, &fitsStatus);
 
 	//-------------------------------------------------------------------------------
 	//*	record the Electrons per ADU, if present
-	if (cCameraProp.ElectronsPerADU > 0.0)
+	if (saveJob->cameraProp.ElectronsPerADU > 0.0)
 	{
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TDOUBLE,	"EGAIN",
-												&cCameraProp.ElectronsPerADU,
+												&saveJob->cameraProp.ElectronsPerADU,
 												"Electrons Per ADU",
 												&fitsStatus);
 	}
 
 	//-------------------------------------------------------------------------------
 	//*	record the camera gain, if present
-	if (cCameraProp.GainMax > 0)
+	if (saveJob->cameraProp.GainMax > 0)
 	{
-		sprintf(stringBuf, "Camera gain [%d:%d]", cCameraProp.GainMin, cCameraProp.GainMax);
+		sprintf(stringBuf, "Camera gain [%d:%d]", saveJob->cameraProp.GainMin, saveJob->cameraProp.GainMax);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr,		TINT,		"GAIN",
-													&cCameraProp.Gain,
+													&saveJob->cameraProp.Gain,
 													stringBuf,
 													&fitsStatus);
 	}
 
 	//-------------------------------------------------------------------------------
 	//*	record the pixel offset, if present
-	if (cCameraProp.OffsetMax > 0)
+	if (saveJob->cameraProp.OffsetMax > 0)
 	{
-		sprintf(stringBuf, "Camera offset [%d:%d]", cCameraProp.OffsetMin, cCameraProp.OffsetMax);
+		sprintf(stringBuf, "Camera offset [%d:%d]", saveJob->cameraProp.OffsetMin, saveJob->cameraProp.OffsetMax);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr,		TINT,		"OFFSET",
-													&cCameraProp.Offset,
+													&saveJob->cameraProp.Offset,
 													stringBuf,
 													&fitsStatus);
 	}
@@ -1082,7 +1106,7 @@ char	instrumentString[128];
 	//-------------------------------------------------------------------------------
 	//*	ATIK dusk software uses this keyword
 	intValue	=	cIsColorCam;
-	if (cROIinfo.currentROIimageType == kImageType_RGB24)
+	if (saveJob->roiInfo.currentROIimageType == kImageType_RGB24)
 	{
 		intValue	=	true;
 	}
@@ -1106,7 +1130,7 @@ char	instrumentString[128];
 	//*	readout mode is defined by SBIG
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr,		TINT,		"READOUTM",
-												&cCameraProp.ReadOutMode,
+												&saveJob->cameraProp.ReadOutMode,
 												"TBD",
 												&fitsStatus);
 
@@ -1142,20 +1166,20 @@ char	instrumentString[128];
 
 	//-------------------------------------------------------------------------------
 	//*	sensor name
-	if (strlen(cCameraProp.SensorName) > 0)
+	if (strlen(saveJob->cameraProp.SensorName) > 0)
 	{
 		strcpy(stringBuf, "Camera Sensor: ");
-		strcat(stringBuf, cCameraProp.SensorName);
+		strcat(stringBuf, saveJob->cameraProp.SensorName);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TSTRING, "COMMENT",	stringBuf,		NULL, &fitsStatus);
 	}
 
 	//-------------------------------------------------------------------------------
-	sprintf(stringBuf, "Camera image size: %d x %d", cCameraProp.CameraXsize, cCameraProp.CameraYsize);
+	sprintf(stringBuf, "Camera image size: %d x %d", saveJob->cameraProp.CameraXsize, saveJob->cameraProp.CameraYsize);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING, "COMMENT",	stringBuf,		NULL, &fitsStatus);
 
-	megaPixels	=	(1.0 * cCameraProp.CameraXsize * cCameraProp.CameraYsize) / (1024 * 1024);
+	megaPixels	=	(1.0 * saveJob->cameraProp.CameraXsize * saveJob->cameraProp.CameraYsize) / (1024 * 1024);
 	sprintf(stringBuf, "Camera image size: %1.1f megapixels", megaPixels);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING, "COMMENT",	stringBuf,		NULL, &fitsStatus);
@@ -1190,18 +1214,18 @@ char	instrumentString[128];
 	fits_write_key(fitsFilePtr, TSTRING, "COMMENT",	stringBuf,		NULL, &fitsStatus);
 
 	//-------------------------------------------------------------------------------
-	sprintf(stringBuf, "Image Shutter: %d microseconds ", cCameraProp.Lastexposure_duration_us);
+	sprintf(stringBuf, "Image Shutter: %d microseconds ", saveJob->cameraProp.Lastexposure_duration_us);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING, "COMMENT",	stringBuf,		NULL, &fitsStatus);
 
 
 	//-------------------------------------------------------------------------------
 	//*	this was kept here so we dont have to read the CCD temperature twice
-	if (ccdTempErrCode == 0)
+	if (saveJob->ccdTempErrCode == 0)
 	{
 		sprintf(stringBuf, "Image Sensor Temperature: %1.1f deg C, %1.1f deg F",
-									cCameraProp.CCDtemperature,
-									((cCameraProp.CCDtemperature * 9.0/5.0) + 32.0));
+									saveJob->cameraProp.CCDtemperature,
+									((saveJob->cameraProp.CCDtemperature * 9.0/5.0) + 32.0));
 	}
 	else
 	{
@@ -1342,19 +1366,12 @@ bool		printDomeDataSrc;
 }
 
 //*****************************************************************************
-void	CameraDriver::WriteFITS_FilterwheelInfo(fitsfile *fitsFilePtr)
+void	CameraDriver::WriteFITS_FilterwheelInfo(fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob)
 {
 int		fitsStatus;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
-#ifdef _ENABLE_FILTERWHEEL_
-	if (cConnectedFilterWheel == NULL)
-	{
-		UpdateFilterwheelLink();
-	}
-#endif	//	_ENABLE_FILTERWHEEL_
-
 	if (cFilterWheelInfoValid || cTS_info.hasFilterwheel)
 	{
 		WriteFITS_Seperator(fitsFilePtr, "Filter wheel Info");
@@ -1362,10 +1379,6 @@ int		fitsStatus;
 	#ifdef _ENABLE_FILTERWHEEL_
 		if (cFilterWheelInfoValid && (cConnectedFilterWheel != NULL))
 		{
-		int		fwAlpacaErr;		//*	filter wheel alpaca error code
-		int		filterPosition;
-		char	filterPositionName[48];
-
 //			CONSOLE_DEBUG("We have valid filterwheel info");
 //			CONSOLE_DEBUG("Calling Read_CurrentFilterPositon");
 //			CONSOLE_DEBUG_W_STR("cAlpacaName           \t=", cConnectedFilterWheel->cAlpacaName);
@@ -1401,30 +1414,28 @@ int		fitsStatus;
 														"Serial Number", &fitsStatus);
 			}
 
-			fwAlpacaErr	=	cConnectedFilterWheel->Read_CurrentFilterPositon(&filterPosition);
-			if (fwAlpacaErr == kASCOM_Err_Success)
+			//*	the position was read when the frame was read out
+			if (saveJob->filterPosValid)
 			{
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TINT,		"FILPOS",
-														&filterPosition,
+														&saveJob->filterPosition,
 														"Filter wheel position", &fitsStatus);
 			}
 			else
 			{
-				CONSOLE_DEBUG_W_NUM("cConnectedFilterWheel->Read_CurrentFilterPositon returned ERROR:", fwAlpacaErr);
+				CONSOLE_DEBUG("cConnectedFilterWheel->Read_CurrentFilterPositon returned ERROR");
 			}
-//			CONSOLE_DEBUG("Calling Read_CurrentFilterName");
-			fwAlpacaErr	=	cConnectedFilterWheel->Read_CurrentFilterName(filterPositionName);
-			if (fwAlpacaErr == kASCOM_Err_Success)
+			if (saveJob->filterNameValid)
 			{
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TSTRING,	"FILTER",
-														filterPositionName,
+														saveJob->filterName,
 														"Name of current filter", &fitsStatus);
 			}
 			else
 			{
-				CONSOLE_DEBUG_W_NUM("cConnectedFilterWheel->Read_CurrentFilterName returned ERROR:", fwAlpacaErr);
+				CONSOLE_DEBUG("cConnectedFilterWheel->Read_CurrentFilterName returned ERROR");
 			}
 //			CONSOLE_DEBUG("Done with filter wheel stuff");
 		}
@@ -1451,21 +1462,13 @@ int		fitsStatus;
 }
 
 //*****************************************************************************
-void	CameraDriver::WriteFITS_FocuserInfo(fitsfile *fitsFilePtr)
+void	CameraDriver::WriteFITS_FocuserInfo(fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob)
 {
 //int		fitsRetCode;
 int		fitsStatus;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
-#ifdef _ENABLE_FOCUSER_
-
-	if (cConnectedFocuser == NULL)
-	{
-		UpdateFocuserLink();
-	}
-#endif	//	_ENABLE_FOCUSER_
-
 	if (cFocuserInfoValid || (strlen(cTS_info.focuser) > 0))
 	{
 		WriteFITS_Seperator(fitsFilePtr, "Focuser Info");
@@ -1479,17 +1482,16 @@ int		fitsStatus;
 		}
 
 	#ifdef _ENABLE_FOCUSER_
-		if (cConnectedFocuser != NULL)
+		if ((cConnectedFocuser != NULL) && saveJob->focuserValid)
 		{
-		long	focuserPosition;
 		char	dataBuff[128];
 		char	lineBuff[128];
 		double	dblValue;
 
-			focuserPosition	=	cConnectedFocuser->GetFocuserPosition();
+			//*	position, temperature and voltage are from when the frame was read out
 			fitsStatus	=	0;
 			fits_write_key(fitsFilePtr, TINT,		"TELFOCUS",
-													&focuserPosition,
+													&saveJob->focuserPosition,
 													"Telescope Focuser position", &fitsStatus);
 
 			//*	manufacturer
@@ -1542,7 +1544,7 @@ int		fitsStatus;
 			}
 
 			//*	Temperature
-			dblValue	=	cConnectedFocuser->GetFocuserTemperature();
+			dblValue	=	saveJob->focuserTemperature;
 			if (dblValue != 0.0)
 			{
 
@@ -1558,7 +1560,7 @@ int		fitsStatus;
 			}
 
 			//*	Voltage
-			dblValue	=	cConnectedFocuser->GetFocuserVoltage();
+			dblValue	=	saveJob->focuserVoltage;
 			if (dblValue > 1.0)
 			{
 				sprintf(lineBuff, "Focuser Voltage: %1.1f", dblValue);
@@ -1708,21 +1710,22 @@ char	stringBuf[128];
 
 
 //*****************************************************************************
-void	CameraDriver::WriteFITS_ObservationInfo(fitsfile *fitsFilePtr, bool includeAnalysis)
+void	CameraDriver::WriteFITS_ObservationInfo(fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob, bool includeAnalysis)
 {
 int				fitsStatus;
 double			exposureTime_Secs;
 struct tm		utcTime;
 struct tm		siderealTime;
 char			stringBuf[128];
-unsigned long	minmaxPixelValue;
-unsigned long	staurationValue;
-unsigned long	saturationPixCount;
+int				minmaxPixelValue;
+int				staurationValue;
+int				saturationPixCount;
 double			saturationPrcnt;
 double			modifiedJulianDate;
 struct tm		*localTime;
 time_t			epochTimeSecs;
 struct tm		myLocalTime;
+const TYPE_FrameStats	*frameStats;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
@@ -1730,7 +1733,7 @@ struct tm		myLocalTime;
 
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING,	"OBJECT",
-											cObjectName,
+											saveJob->objectName,
 											"Observation title", &fitsStatus);
 
 	if (strlen(gObseratorySettings.Observer) > 0)
@@ -1746,12 +1749,12 @@ struct tm		myLocalTime;
 	}
 
 	//*	format the time of exposure start
-	FormatTimeStringISO8601(&cCameraProp.Lastexposure_StartTime, stringBuf);
+	FormatTimeStringISO8601(&saveJob->cameraProp.Lastexposure_StartTime, stringBuf);
 //	CONSOLE_DEBUG_W_STR("stringBuf:", stringBuf);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING, "DATE-OBS",	stringBuf,		"UTC date of observation", &fitsStatus);
 
-	gmtime_r(&cCameraProp.Lastexposure_StartTime.tv_sec, &utcTime);
+	gmtime_r(&saveJob->cameraProp.Lastexposure_StartTime.tv_sec, &utcTime);
 	CalcSiderealTime(&utcTime, &siderealTime, gObseratorySettings.Longitude_deg);
 	FormatTimeString_TM(&siderealTime, stringBuf);
 	fitsStatus	=	0;
@@ -1761,7 +1764,7 @@ struct tm		myLocalTime;
 
 	//==============================================================
 	//*	include the local time as well
-	localTime		=	localtime(&cCameraProp.Lastexposure_StartTime.tv_sec);
+	localTime		=	localtime(&saveJob->cameraProp.Lastexposure_StartTime.tv_sec);
 	FormatTimeString_TM(localTime, stringBuf);
 
 	fitsStatus	=	0;
@@ -1779,13 +1782,13 @@ struct tm		myLocalTime;
 											&fitsStatus);
 
 	//==============================================================
-	modifiedJulianDate	=	Julian_CalcMJD(&cCameraProp.Lastexposure_StartTime);
+	modifiedJulianDate	=	Julian_CalcMJD(&saveJob->cameraProp.Lastexposure_StartTime);
 	fitsStatus			=	0;
 	fits_write_key(fitsFilePtr, TDOUBLE,	"MJD-OBS",
 											&modifiedJulianDate,
 											"MJD of observation", &fitsStatus);
 
-	modifiedJulianDate	=	Julian_CalcMJD(&cCameraProp.Lastexposure_EndTime);
+	modifiedJulianDate	=	Julian_CalcMJD(&saveJob->cameraProp.Lastexposure_EndTime);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TDOUBLE,	"MJDEND",
 											&modifiedJulianDate,
@@ -1793,31 +1796,31 @@ struct tm		myLocalTime;
 
 	//==============================================================
 	fitsStatus	=	0;
-	exposureTime_Secs	=	(cCameraProp.Lastexposure_duration_us * 1.0) / 1000000.0;
+	exposureTime_Secs	=	(saveJob->cameraProp.Lastexposure_duration_us * 1.0) / 1000000.0;
 	fits_write_key(fitsFilePtr, TDOUBLE,	"EXPTIME",
 											&exposureTime_Secs,
 											"Exposure time (seconds)", &fitsStatus);
 
-	if ((cImageMode == kImageMode_Sequence) && (cImageSeqNumber > 0))
+	if ((saveJob->imageMode == kImageMode_Sequence) && (saveJob->imageSeqNumber > 0))
 	{
-		sprintf(stringBuf, "Image Sequence Number (of %d)", cNumFramesRequested);
+		sprintf(stringBuf, "Image Sequence Number (of %d)", saveJob->numFramesRequested);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TINT,		"IMAGEID",
-												&cImageSeqNumber,
+												&saveJob->imageSeqNumber,
 												stringBuf,
 												&fitsStatus);
 	}
-	else if (cCameraProp.SavedImageCnt > 1)
+	else if (saveJob->cameraProp.SavedImageCnt > 1)
 	{
-		sprintf(stringBuf, "Frames saved: %d", cCameraProp.SavedImageCnt);
+		sprintf(stringBuf, "Frames saved: %d", saveJob->cameraProp.SavedImageCnt);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 												stringBuf,
 												NULL, &fitsStatus);
 
-		if (cFrameRate > 0.01)
+		if (saveJob->frameRate > 0.01)
 		{
-			sprintf(stringBuf, "Frame rate: %1.2f (fps)", cFrameRate);
+			sprintf(stringBuf, "Frame rate: %1.2f (fps)", saveJob->frameRate);
 			fitsStatus	=	0;
 			fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 													stringBuf,
@@ -1826,12 +1829,17 @@ struct tm		myLocalTime;
 	}
 
 
-	if (includeAnalysis)
+	//*	the statistics are calculated once per frame and shared with auto exposure and readall
+	frameStats	=	NULL;
+	if (includeAnalysis && (saveJob->frameSlot != NULL))
+	{
+		frameStats	=	GetFrameStats(saveJob->frameSlot);
+	}
+	if (frameStats != NULL)
 	{
 		//============================================================
 		//*	Image analysis stuff
-
-		minmaxPixelValue	=	CalculateMinPixValue();
+		minmaxPixelValue	=	frameStats->all.minValue;
 		if (minmaxPixelValue < 65535)
 		{
 			fitsStatus	=	0;
@@ -1840,7 +1848,7 @@ struct tm		myLocalTime;
 												"Minimum pixel value", &fitsStatus);
 		}
 
-		minmaxPixelValue	=	CalculateMaxPixValue();
+		minmaxPixelValue	=	frameStats->all.maxValue;
 		if (minmaxPixelValue > 0)
 		{
 			fitsStatus	=	0;
@@ -1849,27 +1857,19 @@ struct tm		myLocalTime;
 												"Maximum pixel value", &fitsStatus);
 		}
 
-		if (cROIinfo.currentROIimageType == kImageType_RAW16)
-		{
-			staurationValue	=	0x0ffff;
-		}
-		else
-		{
-			staurationValue	=	0x0ff;
-		}
-
+		staurationValue	=	frameStats->saturationValue;
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TINT,	"SATURATE",
 											&staurationValue,
 											"Saturation Value", &fitsStatus);
 
-		saturationPixCount	=	CountSaturationPixels();
+		saturationPixCount	=	frameStats->saturatedPixelCnt;
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TINT,	"SATPIXEL",
 											&saturationPixCount,
 											"Saturation pixel count", &fitsStatus);
 
-		saturationPrcnt		=	CalculateSaturation();
+		saturationPrcnt		=	CalculateSaturation(frameStats);
 //		CONSOLE_DEBUG_W_DBL("saturationPrcnt\t: ",		saturationPrcnt);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TDOUBLE,	"SATUPRCT",
@@ -1879,14 +1879,14 @@ struct tm		myLocalTime;
 		//---------------------------------------------------------------------------------------
 		//*	Histogram information
 		//*	this histogram was already calculated before the FITS routine was called.
-		if (cROIinfo.currentROIimageType == kImageType_RAW16)
+		if (saveJob->roiInfo.currentROIimageType == kImageType_RAW16)
 		{
 			fitsStatus	=	0;
 			fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 													(char *)"For 16 bit data, the histogram is based on the high 8 bits",
 													NULL, &fitsStatus);
 		}
-		else if (cROIinfo.currentROIimageType == kImageType_RGB24)
+		else if (saveJob->roiInfo.currentROIimageType == kImageType_RGB24)
 		{
 			fitsStatus	=	0;
 			fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
@@ -1894,19 +1894,19 @@ struct tm		myLocalTime;
 													NULL, &fitsStatus);
 		}
 
-		sprintf(stringBuf, "Min histogram value: %d", cMinHistogramValue);
+		sprintf(stringBuf, "Min histogram value: %d", saveJob->minHistogramValue);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 												stringBuf,
 												NULL, &fitsStatus);
 
-		sprintf(stringBuf, "Peak histogram value: %d", cPeakHistogramValue);
+		sprintf(stringBuf, "Peak histogram value: %d", saveJob->peakHistogramValue);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 												stringBuf,
 												NULL, &fitsStatus);
 
-		sprintf(stringBuf, "Max histogram value: %d", cMaxHistogramValue);
+		sprintf(stringBuf, "Max histogram value: %d", saveJob->maxHistogramValue);
 		fitsStatus	=	0;
 		fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 												stringBuf,
@@ -2094,7 +2094,7 @@ char	fitsVersionStr[32];
 }
 
 //*****************************************************************************
-void	CameraDriver::WriteFITS_TelescopeInfo(fitsfile *fitsFilePtr)
+void	CameraDriver::WriteFITS_TelescopeInfo(fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob)
 {
 int		ii;
 int		fitsStatus;
@@ -2192,15 +2192,15 @@ double	f_ratio;
 													stringBuf,
 													NULL, &fitsStatus);
 
-			angularResolution_perPixel	=	Calc_AngularResolutionPerPixel(cTS_info.focalLen_mm, cCameraProp.PixelSizeX);
+			angularResolution_perPixel	=	Calc_AngularResolutionPerPixel(cTS_info.focalLen_mm, saveJob->cameraProp.PixelSizeX);
 			sprintf(stringBuf, "Angular resolution per pixel: %5.4f (arc-seconds / pixel)",	angularResolution_perPixel);
 			fitsStatus	=	0;
 			fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 													stringBuf,
 													NULL, &fitsStatus);
 
-			fov_arcSeconds_X	=	Calc_FieldOfView_arcSecs(cTS_info.focalLen_mm, cCameraProp.PixelSizeX, cCameraProp.CameraXsize);
-			fov_arcSeconds_Y	=	Calc_FieldOfView_arcSecs(cTS_info.focalLen_mm, cCameraProp.PixelSizeX, cCameraProp.CameraYsize);
+			fov_arcSeconds_X	=	Calc_FieldOfView_arcSecs(cTS_info.focalLen_mm, saveJob->cameraProp.PixelSizeX, saveJob->cameraProp.CameraXsize);
+			fov_arcSeconds_Y	=	Calc_FieldOfView_arcSecs(cTS_info.focalLen_mm, saveJob->cameraProp.PixelSizeX, saveJob->cameraProp.CameraYsize);
 			sprintf(stringBuf, "Field of view: %1.1f x %1.1f (arc-minutes)", (fov_arcSeconds_X / 60.0), (fov_arcSeconds_Y / 60.0));
 			fitsStatus	=	0;
 			fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
@@ -2292,7 +2292,7 @@ int		fitsStatus;
 }
 
 //*****************************************************************************
-void	CameraDriver::WriteFITS_MoonInfo(fitsfile *fitsFilePtr)
+void	CameraDriver::WriteFITS_MoonInfo(fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob)
 {
 int				fitsStatus;
 struct tm		*linuxTime;
@@ -2311,8 +2311,8 @@ TYPE_MoonPhase	moonPhaseInfo;
 	WriteFITS_Seperator(fitsFilePtr, "Moon Info");
 	//-------------------------------------------------------------
 	//*	use the start of exposure time
-	linuxTime		=	gmtime(&cCameraProp.Lastexposure_StartTime.tv_sec);
-	FormatTimeStringISO8601(&cCameraProp.Lastexposure_StartTime, timeString);
+	linuxTime		=	gmtime(&saveJob->cameraProp.Lastexposure_StartTime.tv_sec);
+	FormatTimeStringISO8601(&saveJob->cameraProp.Lastexposure_StartTime, timeString);
 
 	currentYear		=	(1900 + linuxTime->tm_year);
 	currentMonth	=	(1 + linuxTime->tm_mon);
@@ -2548,7 +2548,7 @@ TYPE_MoonPhase	moonPhaseInfo;
 
 #ifdef _ENABLE_IMU_
 //**************************************************************************
-void	CameraDriver::WriteFITS_IMUinfo(fitsfile *fitsFilePtr)
+void	CameraDriver::WriteFITS_IMUinfo(fitsfile *fitsFilePtr, TYPE_SaveJob *saveJob)
 {
 int		fitsStatus;
 char	lineBuff[80];
@@ -2562,20 +2562,20 @@ char	lineBuff[80];
 											(char *)"Using bno055 sensor attached to camera",
 											NULL, &fitsStatus);
 
-	if (cIMU_EulerValid)
+	if (saveJob->imuEulerValid)
 	{
 		fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 												(char *)"IMU Euler Data",
 												NULL, &fitsStatus);
 		//*	use the values that were read when the image was taken
 		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_HEAD",	&cIMU_Heading,	NULL, &fitsStatus);
+		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_HEAD",	&saveJob->imuHeading,	NULL, &fitsStatus);
 
 		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_ROLL",	&cIMU_Roll,		NULL, &fitsStatus);
+		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_ROLL",	&saveJob->imuRoll,		NULL, &fitsStatus);
 
 		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_PTCH",	&cIMU_Pitch,		NULL, &fitsStatus);
+		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_PTCH",	&saveJob->imuPitch,		NULL, &fitsStatus);
 	}
 	else
 	{
@@ -2584,7 +2584,7 @@ char	lineBuff[80];
 												NULL, &fitsStatus);
 	}
 
-	if (cIMU_QuatValid)
+	if (saveJob->imuQuatValid)
 	{
 		fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 												(char *)"IMU Quaternion Data",
@@ -2592,16 +2592,16 @@ char	lineBuff[80];
 
 		//*	use the values that were read when the image was taken
 		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_W",	&cIMU_www,	NULL, &fitsStatus);
+		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_W",	&saveJob->imuWWW,	NULL, &fitsStatus);
 
 		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_X",	&cIMU_xxx,	NULL, &fitsStatus);
+		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_X",	&saveJob->imuXXX,	NULL, &fitsStatus);
 
 		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_Y",	&cIMU_yyy,	NULL, &fitsStatus);
+		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_Y",	&saveJob->imuYYY,	NULL, &fitsStatus);
 
 		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_Z",	&cIMU_zzz,	NULL, &fitsStatus);
+		fits_write_key(fitsFilePtr, TDOUBLE,	"IMU_Z",	&saveJob->imuZZZ,	NULL, &fitsStatus);
 	}
 	else
 	{
@@ -2617,19 +2617,19 @@ char	lineBuff[80];
 											NULL, &fitsStatus);
 
 	//*	use the values that were read when the image was taken
-	sprintf(lineBuff,	"IMU-Cal-Gyro=%d",	cIMU_Cal_Gyro);
+	sprintf(lineBuff,	"IMU-Cal-Gyro=%d",	saveJob->imuCal_Gyro);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",	lineBuff,	NULL, &fitsStatus);
 
-	sprintf(lineBuff,	"IMU-Cal-Acce=%d",	cIMU_Cal_Acce);
+	sprintf(lineBuff,	"IMU-Cal-Acce=%d",	saveJob->imuCal_Acce);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",	lineBuff,	NULL, &fitsStatus);
 
-	sprintf(lineBuff,	"IMU-Cal-Magn=%d",	cIMU_Cal_Magn);
+	sprintf(lineBuff,	"IMU-Cal-Magn=%d",	saveJob->imuCal_Magn);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",	lineBuff,	NULL, &fitsStatus);
 
-	sprintf(lineBuff,	"IMU-Cal-Syst=%d",	cIMU_Cal_Syst);
+	sprintf(lineBuff,	"IMU-Cal-Syst=%d",	saveJob->imuCal_Syst);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",	lineBuff,	NULL, &fitsStatus);
 }
@@ -2694,7 +2694,7 @@ int				leftOverCount;
 #endif
 
 //*****************************************************************************
-void		CameraDriver::CreateFitsBGRimage(void)
+unsigned char	*CameraDriver::CreateFitsBGRimage(TYPE_SaveJob *saveJob)
 {
 long			frameBufSize;
 long			iii;
@@ -2702,22 +2702,21 @@ long			ppp;
 unsigned char	*redBufPtr;
 unsigned char	*grnBufPtr;
 unsigned char	*bluBufPtr;
+unsigned char	*bgrBuffer;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
-	frameBufSize	=	cCameraProp.CameraXsize * cCameraProp.CameraYsize;
-	if (cCameraDataBuffer != NULL)
+	bgrBuffer		=	NULL;
+	frameBufSize	=	saveJob->cameraProp.CameraXsize * saveJob->cameraProp.CameraYsize;
+	if (saveJob->imageData != NULL)
 	{
-		if (cCameraBGRbuffer == NULL)
+		//*	each writer thread needs its own buffer
+		bgrBuffer	=	(unsigned char *)ImagePool_Alloc((frameBufSize * 3) + 100);
+		if (bgrBuffer != NULL)
 		{
-			cCameraBGRbuffer	=	(unsigned char *)malloc((frameBufSize * 3) + 100);
-		}
-
-		if (cCameraBGRbuffer != NULL)
-		{
-			bluBufPtr	=	cCameraBGRbuffer;
-			grnBufPtr	=	cCameraBGRbuffer + frameBufSize;
-			redBufPtr	=	cCameraBGRbuffer + frameBufSize + frameBufSize;
+			bluBufPtr	=	bgrBuffer;
+			grnBufPtr	=	bgrBuffer + frameBufSize;
+			redBufPtr	=	bgrBuffer + frameBufSize + frameBufSize;
 		#ifdef __ARM_NEON
 			//:2379 [CreateFitsBGRimage  ] CreateFitsBGRimage
 			//:2402 [CreateFitsBGRimage  ] Using CPU to Deinterleave 307
@@ -2734,7 +2733,7 @@ unsigned char	*bluBufPtr;
 			{
 				CONSOLE_DEBUG("Using NEON instructions for de-interleave");
 
-				NEON_Deinterleave_RGB(cCameraDataBuffer, redBufPtr, grnBufPtr, bluBufPtr, frameBufSize);
+				NEON_Deinterleave_RGB(saveJob->imageData, redBufPtr, grnBufPtr, bluBufPtr, frameBufSize);
 			}
 			else
 		#endif // __ARM_NEON
@@ -2743,21 +2742,21 @@ unsigned char	*bluBufPtr;
 				iii	=	0;
 				for (ppp=0; ppp<frameBufSize; ppp++)
 				{
-					redBufPtr[ppp]	=	cCameraDataBuffer[iii++];
-					grnBufPtr[ppp]	=	cCameraDataBuffer[iii++];
-					bluBufPtr[ppp]	=	cCameraDataBuffer[iii++];
+					redBufPtr[ppp]	=	saveJob->imageData[iii++];
+					grnBufPtr[ppp]	=	saveJob->imageData[iii++];
+					bluBufPtr[ppp]	=	saveJob->imageData[iii++];
 				}
 				DEBUG_TIMING("Using CPU to Deinterleave");
 			}
 		}
 		else
 		{
-			CONSOLE_DEBUG("Failed to allocated cCameraBGRbuffer");
+			CONSOLE_DEBUG("Failed to allocated bgrBuffer");
 		}
 
 	}
 //	CONSOLE_DEBUG(__FUNCTION__);
-
+	return(bgrBuffer);
 }
 
 
@@ -30,6 +30,7 @@
 //*	Jan 29,	2020	<MLS> Can save jpegs using libjpeg instead of opencv
 //*	Jan 29,	2020	<MLS> Successfully saving jpegs on NVidia/jetson
 //*	Sep 10,	2023	<MLS> Test lib jpeg routines again, working fine
+//*	Oct 16,	2026	<MLS> SaveUsingJpegLib() now works from a TYPE_SaveJob
 //*****************************************************************************
 
 
@@ -49,7 +50,7 @@
 
 
 //**************************************************************************************
-void	CameraDriver::SaveUsingJpegLib(void)
+void	CameraDriver::SaveUsingJpegLib(TYPE_SaveJob *saveJob)
 {
 struct jpeg_compress_struct	jinfo;
 struct jpeg_error_mgr		jerr;
@@ -62,7 +63,7 @@ char						imageFilePath[128];
 //	CONSOLE_DEBUG(__FUNCTION__);
 
 
-	strcpy(imageFileName, cFileNameRoot);
+	strcpy(imageFileName, saveJob->fileNameRoot);
 	strcat(imageFileName, "-libjpeg");
 	strcat(imageFileName, ".jpg");
 
@@ -80,8 +81,8 @@ char						imageFilePath[128];
 	{
 		jpeg_stdio_dest(&jinfo, outputFile);
 
-		jinfo.image_width		=	cCameraProp.CameraXsize;
-		jinfo.image_height		=	cCameraProp.CameraYsize;
+		jinfo.image_width		=	saveJob->cameraProp.CameraXsize;
+		jinfo.image_height		=	saveJob->cameraProp.CameraYsize;
 		jinfo.input_components	=	3;
 		jinfo.in_color_space	=	JCS_RGB;
 
@@ -90,11 +91,11 @@ char						imageFilePath[128];
 
 		jpeg_start_compress(&jinfo, TRUE);
 
-		row_stride				=	cCameraProp.CameraXsize * 3;
+		row_stride				=	saveJob->cameraProp.CameraXsize * 3;
 
 		while (jinfo.next_scanline < jinfo.image_height)
 		{
-			row_pointer[0]	=	&cCameraDataBuffer[jinfo.next_scanline * row_stride];
+			row_pointer[0]	=	&saveJob->imageData[jinfo.next_scanline * row_stride];
 			jpeg_write_scanlines(&jinfo, row_pointer, 1);
 
 		}
@@ -102,7 +103,7 @@ char						imageFilePath[128];
 
 		fclose(outputFile);
 
-		AddToDataProductsList(imageFileName, "jpeglib");
+		AddToDataProductsList(saveJob, imageFileName, "jpeglib");
 	}
 	else
 	{
@@ -0,0 +1,875 @@
+//**************************************************************************
+//*	Name:			cameradriver_mjpeg.cpp
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	MJPEG live view stream for all cameras
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistribution of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Usage notes:
+//*		http://camera:port/api/v1/camera/0/mjpeg?width=800
+//*		can be used directly in an <img> tag or opened in a browser or VLC.
+//*
+//*		Live view used to mean each viewer downloading the full imagearray or
+//*		polling the saved jpeg, so every extra viewer cost another full frame.
+//*		Now PublishFrameSlot() only signals the encoder thread. The encoder takes
+//*		the latest frame, shrinks it (imagescale.c) and compresses it once for each
+//*		size being watched, and hands the same image to every viewer of that size.
+//*
+//*		Each viewer has its own thread sending a multipart/x-mixed-replace stream.
+//*		A viewer only ever has one image waiting, if a newer one shows up before
+//*		it has been sent it replaces the old one and that is counted as dropped.
+//*		The camera and the other viewers never wait for a slow viewer.
+//*
+//*		The socket is detached from the listener (SocketListen_DetachSocket())
+//*		so the stream does not tie up one of the listen worker threads.
+//*
+//*		Frames only show up while the camera is taking pictures, normally in live mode.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created cameradriver_mjpeg.cpp
+//*	Oct 17,	2026	<MLS> Added Get_MJPEG(), RunMJPEGencoder(), RunMJPEGviewer()
+//*	Oct 17,	2026	<MLS> Added live view statistics to readall and the stats page
+//*	Oct 17,	2026	<MLS> The scaled image buffer comes from the image pool
+//*	Oct 17,	2026	<MLS> Renamed OutputHTML_DeviceStats() to OutputHTML_MJPEGstats()
+//*	Oct 17,	2026	<MLS> The stream threads are only compiled with _MJPEG_SUPPORTED_
+//*	Oct 17,	2026	<MLS> Uses SocketListen_SendAll() instead of its own send loop
+//*****************************************************************************
+
+#ifdef _ENABLE_CAMERA_
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<errno.h>
+#include	<unistd.h>
+#include	<poll.h>
+#include	<pthread.h>
+#include	<sys/time.h>
+#include	<sys/socket.h>
+
+#ifdef _ENABLE_JPEGLIB_
+	#include	<jpeglib.h>
+	#include	<jerror.h>
+#endif
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"JsonResponse.h"
+#include	"socket_listen.h"
+#include	"helper_functions.h"
+
+#include	"alpacadriver.h"
+#include	"alpacadriver_helper.h"
+#include	"cameradriver.h"
+#include	"imagescale.h"
+
+#if defined(_ENABLE_JPEGLIB_) || defined(_USE_OPENCV_)
+	#define	_MJPEG_SUPPORTED_
+#endif
+
+#define	kMJPEGboundary			"alpacapimjpeg"
+#define	kMJPEGquality			75
+#define	kMJPEGmaxSize			16384
+#define	kMJPEGsendTimeOut_secs	10		//*	a viewer that cannot take data for this long is dropped
+
+#ifdef _MJPEG_SUPPORTED_
+//*****************************************************************************
+static void	*MJPEGencoderThread(void *arg)
+{
+CameraDriver	*cameraDriverPtr;
+
+	cameraDriverPtr	=	(CameraDriver *)arg;
+	if (cameraDriverPtr != NULL)
+	{
+		if (cameraDriverPtr->cMagicCookie == kMagicCookieValue)
+		{
+			cameraDriverPtr->RunMJPEGencoder();
+		}
+		else
+		{
+			CONSOLE_DEBUG("cMagicCookie is invalid  !!!!!!!!!!!!!!!!!!!!!!!!!!!!");
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+static void	*MJPEGviewerThread(void *arg)
+{
+TYPE_MJPEGviewer	*viewer;
+
+	viewer	=	(TYPE_MJPEGviewer *)arg;
+	if ((viewer != NULL) && (viewer->cameraDriver != NULL))
+	{
+		if (viewer->cameraDriver->cMagicCookie == kMagicCookieValue)
+		{
+			viewer->cameraDriver->RunMJPEGviewer(viewer);
+		}
+		else
+		{
+			CONSOLE_DEBUG("cMagicCookie is invalid  !!!!!!!!!!!!!!!!!!!!!!!!!!!!");
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+//*	browsers do not send anything after the request, so readable means closed
+//*****************************************************************************
+static bool	MJPEG_ViewerStillConnected(const int socketFD)
+{
+struct pollfd	pollInfo;
+char			readBuffer[256];
+bool			connected;
+
+	connected			=	true;
+	pollInfo.fd			=	socketFD;
+	pollInfo.events		=	POLLIN | POLLRDHUP;
+	pollInfo.revents	=	0;
+	if (poll(&pollInfo, 1, 0) > 0)
+	{
+		if (pollInfo.revents & (POLLERR | POLLHUP | POLLRDHUP | POLLNVAL))
+		{
+			connected	=	false;
+		}
+		else if (pollInfo.revents & POLLIN)
+		{
+			if (recv(socketFD, readBuffer, sizeof(readBuffer), MSG_DONTWAIT) == 0)
+			{
+				connected	=	false;
+			}
+		}
+	}
+	return(connected);
+}
+
+#endif // _MJPEG_SUPPORTED_
+
+//*****************************************************************************
+//*	GET /api/v1/camera/0/mjpeg?width=640&height=480
+//*	both are optional, the image keeps the aspect ratio of the frame
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Get_MJPEG(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode;
+#ifdef _MJPEG_SUPPORTED_
+char				argumentString[32];
+int					maxWidth;
+int					maxHeight;
+int					viewerIdx;
+int					threadErr;
+int					iii;
+TYPE_MJPEGviewer	*viewer;
+pthread_t			viewerThreadID;
+pthread_attr_t		threadAttr;
+struct timeval		timeoutLength;
+char				httpHeader[512];
+
+	alpacaErrCode	=	kASCOM_Err_Success;
+	maxWidth		=	kMJPEGdefaultWidth;
+	maxHeight		=	0;
+	if (GetKeyWordArgument(reqData->contentData, "width", argumentString, (sizeof(argumentString) -1)))
+	{
+		maxWidth	=	atoi(argumentString);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "height", argumentString, (sizeof(argumentString) -1)))
+	{
+		maxHeight	=	atoi(argumentString);
+	}
+	if ((maxWidth < 0) || (maxWidth > kMJPEGmaxSize) || (maxHeight < 0) || (maxHeight > kMJPEGmaxSize))
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidValue;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "width/height out of range");
+	}
+
+	//*	the encoder thread stays running once it has been started
+	if ((alpacaErrCode == kASCOM_Err_Success) && (cMJPEGencoderRunning == false))
+	{
+		cMJPEGkeepRunning	=	true;
+		threadErr			=	pthread_create(&cMJPEGencoderThreadID, NULL, &MJPEGencoderThread, this);
+		if (threadErr == 0)
+		{
+			cMJPEGencoderRunning	=	true;
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("ERROR: pthread_create() returned\t=", threadErr);
+			alpacaErrCode	=	kASCOM_Err_InternalError;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to start the MJPEG encoder");
+		}
+	}
+
+	viewerIdx	=	-1;
+	if (alpacaErrCode == kASCOM_Err_Success)
+	{
+		pthread_mutex_lock(&cMJPEGmutex);
+		for (iii=0; iii<kMaxMJPEGviewers; iii++)
+		{
+			if ((viewerIdx < 0) && (cMJPEGviewer[iii].inUse == false))
+			{
+				viewerIdx	=	iii;
+				cMJPEGviewer[iii].inUse	=	true;
+			}
+		}
+		pthread_mutex_unlock(&cMJPEGmutex);
+		if (viewerIdx < 0)
+		{
+			alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Too many MJPEG viewers");
+		}
+	}
+
+	//*	from here on the socket belongs to the viewer thread, no JSON response
+	if ((alpacaErrCode == kASCOM_Err_Success) && SocketListen_DetachSocket(reqData->socket))
+	{
+		cSendJSONresponse	=	false;
+		viewer				=	&cMJPEGviewer[viewerIdx];
+
+		timeoutLength.tv_sec	=	kMJPEGsendTimeOut_secs;
+		timeoutLength.tv_usec	=	0;
+		setsockopt(reqData->socket, SOL_SOCKET, SO_SNDTIMEO, &timeoutLength, sizeof(timeoutLength));
+
+		strcpy(httpHeader,	"HTTP/1.0 200 OK\r\n");
+		strcat(httpHeader,	"Content-Type: multipart/x-mixed-replace; boundary=" kMJPEGboundary "\r\n");
+		strcat(httpHeader,	"Cache-Control: no-cache, no-store\r\n");
+		strcat(httpHeader,	"Pragma: no-cache\r\n");
+		strcat(httpHeader,	"Access-Control-Allow-Origin: *\r\n");
+		strcat(httpHeader,	"Connection: close\r\n");
+		strcat(httpHeader,	"\r\n");
+
+		pthread_mutex_lock(&cMJPEGmutex);
+		viewer->socketFD		=	reqData->socket;
+		viewer->pendingImage	=	NULL;
+		viewer->haveFrame		=	false;
+		viewer->lastFrameNumber	=	0;
+		viewer->maxWidth		=	maxWidth;
+		viewer->maxHeight		=	maxHeight;
+		viewer->framesSent		=	0;
+		viewer->framesDropped	=	0;
+		viewer->bytesSent		=	0;
+		strncpy(viewer->clientIPaddr, reqData->clientIPaddr, (sizeof(viewer->clientIPaddr) - 1));
+		viewer->clientIPaddr[sizeof(viewer->clientIPaddr) - 1]	=	0;
+		gettimeofday(&viewer->connectTime, NULL);
+		pthread_mutex_unlock(&cMJPEGmutex);
+
+		threadErr	=	-1;
+		if (SocketListen_SendAll(viewer->socketFD, httpHeader, strlen(httpHeader)))
+		{
+			pthread_attr_init(&threadAttr);
+			pthread_attr_setdetachstate(&threadAttr, PTHREAD_CREATE_DETACHED);
+			threadErr	=	pthread_create(&viewerThreadID, &threadAttr, &MJPEGviewerThread, viewer);
+			pthread_attr_destroy(&threadAttr);
+		}
+
+		pthread_mutex_lock(&cMJPEGmutex);
+		if (threadErr == 0)
+		{
+			cMJPEGviewerCnt++;
+			cMJPEGviewersTotal++;
+			//*	so the new viewer gets the latest frame without waiting for the next one
+			cMJPEGframeSeq++;
+			pthread_cond_signal(&cMJPEGnewFrame);
+			CONSOLE_DEBUG_W_STR("MJPEG viewer connected from", viewer->clientIPaddr);
+		}
+		else
+		{
+			CONSOLE_DEBUG("Failed to start the MJPEG viewer");
+			close(viewer->socketFD);
+			viewer->socketFD	=	-1;
+			viewer->inUse		=	false;
+		}
+		pthread_mutex_unlock(&cMJPEGmutex);
+	}
+	else if (alpacaErrCode == kASCOM_Err_Success)
+	{
+		//*	the request did not come from the listener
+		pthread_mutex_lock(&cMJPEGmutex);
+		cMJPEGviewer[viewerIdx].inUse	=	false;
+		pthread_mutex_unlock(&cMJPEGmutex);
+		alpacaErrCode	=	kASCOM_Err_InternalError;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Unable to stream on this connection");
+	}
+#else
+	alpacaErrCode	=	kASCOM_Err_NotImplemented;
+	GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "MJPEG needs openCV or libjpeg");
+#endif // _MJPEG_SUPPORTED_
+	return(alpacaErrCode);
+}
+
+//*****************************************************************************
+//*	called by PublishFrameSlot() for every frame
+//*****************************************************************************
+void	CameraDriver::MJPEG_NewFrame(void)
+{
+	if (cMJPEGencoderRunning)
+	{
+		pthread_mutex_lock(&cMJPEGmutex);
+		cMJPEGframeSeq++;
+		pthread_cond_signal(&cMJPEGnewFrame);
+		pthread_mutex_unlock(&cMJPEGmutex);
+	}
+}
+
+#ifdef _MJPEG_SUPPORTED_
+//*****************************************************************************
+//*	the encoder thread waits for a new frame while anyone is watching
+//*****************************************************************************
+void	CameraDriver::RunMJPEGencoder(void)
+{
+TYPE_FrameSlot	*frameSlot;
+uint32_t		lastFrameSeq;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	pthread_mutex_lock(&cMJPEGmutex);
+	lastFrameSeq	=	cMJPEGframeSeq;
+	while (cMJPEGkeepRunning)
+	{
+		if ((cMJPEGframeSeq == lastFrameSeq) || (cMJPEGviewerCnt == 0))
+		{
+			pthread_cond_wait(&cMJPEGnewFrame, &cMJPEGmutex);
+		}
+		else
+		{
+			lastFrameSeq	=	cMJPEGframeSeq;
+			pthread_mutex_unlock(&cMJPEGmutex);
+
+			frameSlot	=	AcquireLatestFrame();
+			if (frameSlot != NULL)
+			{
+				MJPEG_DistributeFrame(frameSlot);
+				ReleaseFrame(frameSlot);
+			}
+			pthread_mutex_lock(&cMJPEGmutex);
+		}
+	}
+	pthread_mutex_unlock(&cMJPEGmutex);
+	CONSOLE_DEBUG_W_NUM("MJPEG encoder exiting, frames encoded\t=", cMJPEGframesEncoded);
+}
+
+//*****************************************************************************
+//*	compresses the frame once for each size that a viewer wants
+//*	and gives it to every viewer that has not had this frame yet
+//*****************************************************************************
+void	CameraDriver::MJPEG_DistributeFrame(TYPE_FrameSlot *frameSlot)
+{
+TYPE_MJPEGimage		*mjpegImage;
+TYPE_MJPEGviewer	*viewer;
+int					sizeList[kMaxMJPEGviewers][2];
+int					sizeCnt;
+int					iii;
+int					sss;
+bool				alreadyListed;
+bool				frameSent;
+struct timeval		startTime;
+struct timeval		endTime;
+uint32_t			encodeTime_us;
+double				elapsedSecs;
+
+	//*	make a list of the sizes that need this frame
+	sizeCnt	=	0;
+	pthread_mutex_lock(&cMJPEGmutex);
+	for (iii=0; iii<kMaxMJPEGviewers; iii++)
+	{
+		viewer	=	&cMJPEGviewer[iii];
+		if (viewer->inUse && (viewer->socketFD >= 0) &&
+			((viewer->haveFrame == false) || (viewer->lastFrameNumber != frameSlot->frameNumber)))
+		{
+			alreadyListed	=	false;
+			for (sss=0; sss<sizeCnt; sss++)
+			{
+				if ((sizeList[sss][0] == viewer->maxWidth) && (sizeList[sss][1] == viewer->maxHeight))
+				{
+					alreadyListed	=	true;
+				}
+			}
+			if (alreadyListed == false)
+			{
+				sizeList[sizeCnt][0]	=	viewer->maxWidth;
+				sizeList[sizeCnt][1]	=	viewer->maxHeight;
+				sizeCnt++;
+			}
+		}
+	}
+	pthread_mutex_unlock(&cMJPEGmutex);
+
+	frameSent	=	false;
+	for (sss=0; sss<sizeCnt; sss++)
+	{
+		gettimeofday(&startTime, NULL);
+		mjpegImage	=	MJPEG_EncodeFrame(frameSlot, sizeList[sss][0], sizeList[sss][1]);
+		gettimeofday(&endTime, NULL);
+		encodeTime_us	=	((endTime.tv_sec - startTime.tv_sec) * 1000000) + (endTime.tv_usec - startTime.tv_usec);
+
+		if (mjpegImage != NULL)
+		{
+			pthread_mutex_lock(&cMJPEGmutex);
+			cMJPEGframesEncoded++;
+			cMJPEGencodeLast_us		=	encodeTime_us;
+			cMJPEGencodeTotal_us	+=	encodeTime_us;
+			if (encodeTime_us > cMJPEGencodeMax_us)
+			{
+				cMJPEGencodeMax_us	=	encodeTime_us;
+			}
+			for (iii=0; iii<kMaxMJPEGviewers; iii++)
+			{
+				viewer	=	&cMJPEGviewer[iii];
+				if (viewer->inUse && (viewer->socketFD >= 0) &&
+					(viewer->maxWidth == sizeList[sss][0]) && (viewer->maxHeight == sizeList[sss][1]) &&
+					((viewer->haveFrame == false) || (viewer->lastFrameNumber != frameSlot->frameNumber)))
+				{
+					if (viewer->pendingImage != NULL)
+					{
+						//*	the viewer has not finished sending the last one, it never will now
+						MJPEG_ReleaseImage(viewer->pendingImage);
+						viewer->framesDropped++;
+						cMJPEGframesDropped++;
+					}
+					mjpegImage->refCount++;
+					viewer->pendingImage	=	mjpegImage;
+					viewer->lastFrameNumber	=	frameSlot->frameNumber;
+					viewer->haveFrame		=	true;
+					pthread_cond_signal(&viewer->imageReady);
+					frameSent				=	true;
+				}
+			}
+			//*	the encoder's reference
+			MJPEG_ReleaseImage(mjpegImage);
+			pthread_mutex_unlock(&cMJPEGmutex);
+		}
+	}
+
+	//*	frame rate going out to the viewers, updated about once a second
+	if (frameSent)
+	{
+		gettimeofday(&endTime, NULL);
+		pthread_mutex_lock(&cMJPEGmutex);
+		cMJPEGrateFrameCnt++;
+		elapsedSecs	=	(endTime.tv_sec - cMJPEGrateStartTime.tv_sec) +
+						((endTime.tv_usec - cMJPEGrateStartTime.tv_usec) / 1000000.0);
+		if (elapsedSecs >= 1.0)
+		{
+			cMJPEGframeRate		=	cMJPEGrateFrameCnt / elapsedSecs;
+			cMJPEGrateFrameCnt	=	0;
+			cMJPEGrateStartTime	=	endTime;
+		}
+		pthread_mutex_unlock(&cMJPEGmutex);
+	}
+}
+
+//*****************************************************************************
+//*	returns a new image with a reference count of 1, NULL on failure
+//*****************************************************************************
+TYPE_MJPEGimage	*CameraDriver::MJPEG_EncodeFrame(TYPE_FrameSlot *frameSlot, const int maxWidth, const int maxHeight)
+{
+TYPE_MJPEGimage	*mjpegImage;
+unsigned char	*scaledImage;
+int				scaleFormat;
+int				channelCnt;
+int				scaledWidth;
+int				scaledHeight;
+bool			swapRedBlue;
+#if defined(_ENABLE_JPEGLIB_)
+struct jpeg_compress_struct	jinfo;
+struct jpeg_error_mgr		jerr;
+JSAMPROW					rowPointer[1];
+unsigned char				*jpegBuffer;
+unsigned long				jpegSize;
+#endif
+
+	mjpegImage	=	NULL;
+	switch(frameSlot->roiInfo.currentROIimageType)
+	{
+		case kImageType_RAW16:	scaleFormat	=	kImageScale_Mono16;	break;
+		case kImageType_RGB24:	scaleFormat	=	kImageScale_BGR24;	break;
+		default:				scaleFormat	=	kImageScale_Mono8;	break;
+	}
+	channelCnt	=	ImageScale_OutputChannels(scaleFormat);
+	ImageScale_FitSize(	frameSlot->roiInfo.currentROIwidth,
+						frameSlot->roiInfo.currentROIheight,
+						maxWidth,
+						maxHeight,
+						&scaledWidth,
+						&scaledHeight);
+
+	//*	libjpeg wants RGB, openCV wants BGR
+#if defined(_ENABLE_JPEGLIB_)
+	swapRedBlue	=	true;
+#else
+	swapRedBlue	=	false;
+#endif
+	scaledImage	=	(unsigned char *)ImagePool_Alloc((long)scaledWidth * scaledHeight * channelCnt);
+	if ((scaledImage != NULL) &&
+		ImageScale_BoxDownsample(	frameSlot->dataBuffer,
+									frameSlot->roiInfo.currentROIwidth,
+									frameSlot->roiInfo.currentROIheight,
+									scaleFormat,
+									scaledImage,
+									scaledWidth,
+									scaledHeight,
+									swapRedBlue))
+	{
+		mjpegImage	=	(TYPE_MJPEGimage *)calloc(1, sizeof(TYPE_MJPEGimage));
+		if (mjpegImage != NULL)
+		{
+			mjpegImage->refCount	=	1;
+			mjpegImage->frameNumber	=	frameSlot->frameNumber;
+		#if defined(_ENABLE_JPEGLIB_)
+			jpegBuffer		=	NULL;
+			jpegSize		=	0;
+			jinfo.err		=	jpeg_std_error(&jerr);
+			jpeg_create_compress(&jinfo);
+			jpeg_mem_dest(&jinfo, &jpegBuffer, &jpegSize);
+
+			jinfo.image_width		=	scaledWidth;
+			jinfo.image_height		=	scaledHeight;
+			jinfo.input_components	=	channelCnt;
+			jinfo.in_color_space	=	(channelCnt == 3) ? JCS_RGB : JCS_GRAYSCALE;
+			jpeg_set_defaults(&jinfo);
+			jpeg_set_quality(&jinfo, kMJPEGquality, TRUE);
+			jpeg_start_compress(&jinfo, TRUE);
+			while (jinfo.next_scanline < jinfo.image_height)
+			{
+				rowPointer[0]	=	&scaledImage[(long)jinfo.next_scanline * scaledWidth * channelCnt];
+				jpeg_write_scanlines(&jinfo, rowPointer, 1);
+			}
+			jpeg_finish_compress(&jinfo);
+			jpeg_destroy_compress(&jinfo);
+
+			//*	libjpeg allocated it with malloc()
+			mjpegImage->jpegData	=	jpegBuffer;
+			mjpegImage->jpegLen		=	jpegSize;
+		#elif defined(_USE_OPENCV_)
+			cv::Mat				scaledMat(	scaledHeight,
+											scaledWidth,
+											((channelCnt == 3) ? CV_8UC3 : CV_8UC1),
+											scaledImage);
+			std::vector<uchar>	jpegBuffer;
+			std::vector<int>	jpegParams;
+
+		#if (CV_MAJOR_VERSION >= 3)
+			jpegParams.push_back(cv::IMWRITE_JPEG_QUALITY);
+		#else
+			jpegParams.push_back(CV_IMWRITE_JPEG_QUALITY);
+		#endif
+			jpegParams.push_back(kMJPEGquality);
+			if (cv::imencode(".jpg", scaledMat, jpegBuffer, jpegParams))
+			{
+				mjpegImage->jpegData	=	(unsigned char *)malloc(jpegBuffer.size());
+				if (mjpegImage->jpegData != NULL)
+				{
+					memcpy(mjpegImage->jpegData, jpegBuffer.data(), jpegBuffer.size());
+					mjpegImage->jpegLen	=	jpegBuffer.size();
+				}
+			}
+		#endif
+			if (mjpegImage->jpegData == NULL)
+			{
+				CONSOLE_DEBUG("Failed to create the jpeg image");
+				free(mjpegImage);
+				mjpegImage	=	NULL;
+			}
+		}
+	}
+	if (scaledImage != NULL)
+	{
+		ImagePool_Free(scaledImage);
+	}
+	return(mjpegImage);
+}
+
+//*****************************************************************************
+//*	cMJPEGmutex must be locked
+//*****************************************************************************
+void	CameraDriver::MJPEG_ReleaseImage(TYPE_MJPEGimage *mjpegImage)
+{
+	mjpegImage->refCount--;
+	if (mjpegImage->refCount <= 0)
+	{
+		if (mjpegImage->jpegData != NULL)
+		{
+			free(mjpegImage->jpegData);
+		}
+		free(mjpegImage);
+	}
+}
+
+//*****************************************************************************
+//*	one of these runs for each viewer, it owns the socket and closes it when done
+//*****************************************************************************
+void	CameraDriver::RunMJPEGviewer(TYPE_MJPEGviewer *viewer)
+{
+TYPE_MJPEGimage	*mjpegImage;
+struct timespec	waitUntil;
+char			partHeader[128];
+bool			keepSending;
+bool			sendOK;
+
+	keepSending	=	true;
+	pthread_mutex_lock(&cMJPEGmutex);
+	while (keepSending)
+	{
+		if ((viewer->pendingImage == NULL) && cMJPEGkeepRunning)
+		{
+			//*	wake up once a second to see if the viewer has gone away
+			clock_gettime(CLOCK_REALTIME, &waitUntil);
+			waitUntil.tv_sec	+=	1;
+			pthread_cond_timedwait(&viewer->imageReady, &cMJPEGmutex, &waitUntil);
+		}
+		mjpegImage				=	viewer->pendingImage;
+		viewer->pendingImage	=	NULL;
+		keepSending				=	cMJPEGkeepRunning;
+		pthread_mutex_unlock(&cMJPEGmutex);
+
+		if (keepSending && (mjpegImage != NULL))
+		{
+			sprintf(partHeader,	"--" kMJPEGboundary "\r\n"
+								"Content-Type: image/jpeg\r\n"
+								"Content-Length: %ld\r\n"
+								"\r\n",
+								mjpegImage->jpegLen);
+			sendOK	=	SocketListen_SendAll(viewer->socketFD, partHeader, strlen(partHeader));
+			sendOK	=	sendOK && SocketListen_SendAll(viewer->socketFD, mjpegImage->jpegData, mjpegImage->jpegLen);
+			sendOK	=	sendOK && SocketListen_SendAll(viewer->socketFD, "\r\n", 2);
+			keepSending	=	sendOK;
+		}
+		else if (keepSending)
+		{
+			keepSending	=	MJPEG_ViewerStillConnected(viewer->socketFD);
+		}
+
+		pthread_mutex_lock(&cMJPEGmutex);
+		if (mjpegImage != NULL)
+		{
+			if (keepSending)
+			{
+				viewer->framesSent++;
+				viewer->bytesSent	+=	mjpegImage->jpegLen;
+			}
+			MJPEG_ReleaseImage(mjpegImage);
+		}
+	}
+
+	CONSOLE_DEBUG_W_STR("MJPEG viewer disconnected", viewer->clientIPaddr);
+	if (viewer->pendingImage != NULL)
+	{
+		MJPEG_ReleaseImage(viewer->pendingImage);
+		viewer->pendingImage	=	NULL;
+	}
+	close(viewer->socketFD);
+	viewer->socketFD	=	-1;
+	viewer->inUse		=	false;
+	cMJPEGviewerCnt--;
+	pthread_mutex_unlock(&cMJPEGmutex);
+}
+
+#endif // _MJPEG_SUPPORTED_
+
+//*****************************************************************************
+//*	the viewer threads are detached, wait for them to notice and clean up
+//*****************************************************************************
+void	CameraDriver::MJPEG_Stop(void)
+{
+int		iii;
+int		waitCnt;
+
+	if (cMJPEGencoderRunning)
+	{
+		pthread_mutex_lock(&cMJPEGmutex);
+		cMJPEGkeepRunning	=	false;
+		pthread_cond_broadcast(&cMJPEGnewFrame);
+		for (iii=0; iii<kMaxMJPEGviewers; iii++)
+		{
+			if (cMJPEGviewer[iii].inUse && (cMJPEGviewer[iii].socketFD >= 0))
+			{
+				//*	gets a viewer out of a blocked send()
+				shutdown(cMJPEGviewer[iii].socketFD, SHUT_RDWR);
+				pthread_cond_signal(&cMJPEGviewer[iii].imageReady);
+			}
+		}
+		pthread_mutex_unlock(&cMJPEGmutex);
+
+		pthread_join(cMJPEGencoderThreadID, NULL);
+		cMJPEGencoderRunning	=	false;
+
+		waitCnt	=	0;
+		while ((cMJPEGviewerCnt > 0) && (waitCnt < 200))
+		{
+			usleep(10000);
+			waitCnt++;
+		}
+	}
+}
+
+//*****************************************************************************
+void	CameraDriver::Get_Readall_MJPEG(TYPE_GetPutRequestData *reqData)
+{
+int			mySocket;
+int			viewerCnt;
+uint32_t	framesEncoded;
+uint32_t	framesDropped;
+uint32_t	encodeMax_us;
+uint64_t	encodeTotal_us;
+double		frameRate;
+double		avgEncode_ms;
+
+	mySocket	=	reqData->socket;
+
+	pthread_mutex_lock(&cMJPEGmutex);
+	viewerCnt		=	cMJPEGviewerCnt;
+	framesEncoded	=	cMJPEGframesEncoded;
+	framesDropped	=	cMJPEGframesDropped;
+	encodeMax_us	=	cMJPEGencodeMax_us;
+	encodeTotal_us	=	cMJPEGencodeTotal_us;
+	frameRate		=	(viewerCnt > 0) ? cMJPEGframeRate : 0.0;
+	pthread_mutex_unlock(&cMJPEGmutex);
+
+	avgEncode_ms	=	0.0;
+	if (framesEncoded > 0)
+	{
+		avgEncode_ms	=	(encodeTotal_us / 1000.0) / framesEncoded;
+	}
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"mjpeg-viewers",
+														viewerCnt,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"mjpeg-fps",
+														frameRate,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"mjpeg-encoded",
+														framesEncoded,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"mjpeg-dropped",
+														framesDropped,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"mjpeg-encode-avg-ms",
+														avgEncode_ms,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"mjpeg-encode-max-ms",
+														(encodeMax_us / 1000.0),
+														INCLUDE_COMMA);
+}
+
+//*****************************************************************************
+//*	live view statistics on the stats page
+//*****************************************************************************
+void	CameraDriver::OutputHTML_MJPEGstats(TYPE_GetPutRequestData *reqData)
+{
+TYPE_MJPEGviewer	viewerCopy[kMaxMJPEGviewers];
+int					mySocketFD;
+int					viewerCnt;
+uint32_t			viewersTotal;
+uint32_t			framesEncoded;
+uint32_t			framesDropped;
+uint32_t			encodeLast_us;
+uint32_t			encodeMax_us;
+uint64_t			encodeTotal_us;
+double				frameRate;
+double				avgEncode_ms;
+struct timeval		currentTime;
+char				lineBuffer[512];
+int					iii;
+
+	mySocketFD	=	reqData->socket;
+
+	pthread_mutex_lock(&cMJPEGmutex);
+	memcpy(viewerCopy, cMJPEGviewer, sizeof(viewerCopy));
+	viewerCnt		=	cMJPEGviewerCnt;
+	viewersTotal	=	cMJPEGviewersTotal;
+	framesEncoded	=	cMJPEGframesEncoded;
+	framesDropped	=	cMJPEGframesDropped;
+	encodeLast_us	=	cMJPEGencodeLast_us;
+	encodeMax_us	=	cMJPEGencodeMax_us;
+	encodeTotal_us	=	cMJPEGencodeTotal_us;
+	frameRate		=	(viewerCnt > 0) ? cMJPEGframeRate : 0.0;
+	pthread_mutex_unlock(&cMJPEGmutex);
+
+	avgEncode_ms	=	0.0;
+	if (framesEncoded > 0)
+	{
+		avgEncode_ms	=	(encodeTotal_us / 1000.0) / framesEncoded;
+	}
+
+	SocketWriteData(mySocketFD,	"<CENTER>\r\n");
+	SocketWriteData(mySocketFD,	"MJPEG live view<BR>\r\n");
+	SocketWriteData(mySocketFD,	"<TABLE BORDER=1>\r\n");
+	sprintf(lineBuffer, "<TR><TD>Viewers</TD><TD>%d (%u total)</TD></TR>\r\n",	viewerCnt, viewersTotal);
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>Frame rate</TD><TD>%1.2f fps</TD></TR>\r\n",	frameRate);
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>Frames encoded</TD><TD>%u</TD></TR>\r\n",		framesEncoded);
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>Encode time (last/avg/max)</TD><TD>%1.1f / %1.1f / %1.1f ms</TD></TR>\r\n",
+								(encodeLast_us / 1000.0),
+								avgEncode_ms,
+								(encodeMax_us / 1000.0));
+	SocketWriteData(mySocketFD,	lineBuffer);
+	sprintf(lineBuffer, "<TR><TD>Frames dropped (all viewers)</TD><TD>%u</TD></TR>\r\n",	framesDropped);
+	SocketWriteData(mySocketFD,	lineBuffer);
+	SocketWriteData(mySocketFD,	"</TABLE>\r\n");
+
+	if (viewerCnt > 0)
+	{
+		gettimeofday(&currentTime, NULL);
+		SocketWriteData(mySocketFD,	"<TABLE BORDER=1>\r\n");
+		SocketWriteData(mySocketFD,	"<TR><TH>Viewer</TH><TH>Max size</TH><TH>Sent</TH><TH>Dropped</TH><TH>MBytes</TH><TH>Seconds</TH></TR>\r\n");
+		for (iii=0; iii<kMaxMJPEGviewers; iii++)
+		{
+			if (viewerCopy[iii].inUse && (viewerCopy[iii].socketFD >= 0))
+			{
+				sprintf(lineBuffer, "<TR><TD>%s</TD><TD>%d x %d</TD><TD>%u</TD><TD>%u</TD><TD>%1.1f</TD><TD>%ld</TD></TR>\r\n",
+									viewerCopy[iii].clientIPaddr,
+									viewerCopy[iii].maxWidth,
+									viewerCopy[iii].maxHeight,
+									viewerCopy[iii].framesSent,
+									viewerCopy[iii].framesDropped,
+									(viewerCopy[iii].bytesSent / (1024.0 * 1024.0)),
+									(long)(currentTime.tv_sec - viewerCopy[iii].connectTime.tv_sec));
+				SocketWriteData(mySocketFD,	lineBuffer);
+			}
+		}
+		SocketWriteData(mySocketFD,	"</TABLE>\r\n");
+	}
+	SocketWriteData(mySocketFD,	"</CENTER>\r\n");
+}
+
+#endif // _ENABLE_CAMERA_
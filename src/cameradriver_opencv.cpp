@@ -40,6 +40,7 @@
 //*	Apr 19,	2020	<MLS> Fixed cross hair location when using sidebar
 //*	Feb 21,	2021	<MLS> Added CloseLiveImage(), live window now closes properly
 //*	Feb 23,	2022	<MLS> Working on converting C++ versions of opencv
+//*	Oct 17,	2026	<MLS> Live display image pixels now come from the image pool
 //*****************************************************************************
 
 #if defined(_ENABLE_CAMERA_) && defined(_USE_OPENCV_)
@@ -284,17 +285,17 @@ void	CameraDriver::OpenLiveImage(void)
 			case kImageType_RAW8:
 			case kImageType_Y8:
 				CONSOLE_DEBUG("Creating cOpenCV_LiveDisplayPtr - kImageType_RAW8")
-				cOpenCV_LiveDisplayPtr	=	cvCreateImage(cvSize(cLiveDisplayWidth, cLiveDisplayHeight), IPL_DEPTH_8U, 1);
+				cOpenCV_LiveDisplayPtr	=	OpenCV_CreatePooledImage(cLiveDisplayWidth, cLiveDisplayHeight, IPL_DEPTH_8U, 1);
 				break;
 
 			case kImageType_RAW16:
 				CONSOLE_DEBUG("Creating cOpenCV_LiveDisplayPtr - kImageType_RAW16")
-				cOpenCV_LiveDisplayPtr	=	cvCreateImage(cvSize(cLiveDisplayWidth, cLiveDisplayHeight), IPL_DEPTH_16U, 1);
+				cOpenCV_LiveDisplayPtr	=	OpenCV_CreatePooledImage(cLiveDisplayWidth, cLiveDisplayHeight, IPL_DEPTH_16U, 1);
 				break;
 
 			case kImageType_RGB24:
 				CONSOLE_DEBUG("Creating cOpenCV_LiveDisplayPtr - kImageType_RGB24")
-				cOpenCV_LiveDisplayPtr	=	cvCreateImage(cvSize(cLiveDisplayWidth, cLiveDisplayHeight), IPL_DEPTH_8U, 3);
+				cOpenCV_LiveDisplayPtr	=	OpenCV_CreatePooledImage(cLiveDisplayWidth, cLiveDisplayHeight, IPL_DEPTH_8U, 3);
 				break;
 
 			default:
@@ -319,8 +320,8 @@ int	iii;
 #else
 	if (cOpenCV_LiveDisplayPtr != NULL)
 	{
-		CONSOLE_DEBUG("Calling cvReleaseImage(&cOpenCV_LiveDisplayPtr)");
-		cvReleaseImage(&cOpenCV_LiveDisplayPtr);
+		CONSOLE_DEBUG("Calling OpenCV_ReleasePooledImage(&cOpenCV_LiveDisplayPtr)");
+		OpenCV_ReleasePooledImage(&cOpenCV_LiveDisplayPtr);
 		cOpenCV_LiveDisplayPtr	=	NULL;
 	}
 	else
@@ -521,8 +522,7 @@ CvRect		myCVrect;
 				if (cOpenCV_LiveDisplayPtr->depth != cOpenCV_ImagePtr->depth)
 				{
 					CONSOLE_DEBUG("Image format has changed!!! re-creating live view image");
-					cvReleaseImage(&cOpenCV_LiveDisplayPtr);
-					cOpenCV_LiveDisplayPtr	=	NULL;
+					OpenCV_ReleasePooledImage(&cOpenCV_LiveDisplayPtr);
 				}
 			}
 			//*	we have to create a liveDisp image to display
@@ -547,12 +547,12 @@ CvRect		myCVrect;
 				{
 					case 8:
 						CONSOLE_DEBUG("Creating cOpenCV_LiveDisplayPtr - 8 bit")
-						cOpenCV_LiveDisplayPtr	=	cvCreateImage(cvSize(windowWidth, windowHeight), IPL_DEPTH_8U, 3);
+						cOpenCV_LiveDisplayPtr	=	OpenCV_CreatePooledImage(windowWidth, windowHeight, IPL_DEPTH_8U, 3);
 						break;
 
 					case 16:
 						CONSOLE_DEBUG("Creating cOpenCV_LiveDisplayPtr - 16 bit")
-						cOpenCV_LiveDisplayPtr	=	cvCreateImage(cvSize(windowWidth, windowHeight), IPL_DEPTH_16U, 3);
+						cOpenCV_LiveDisplayPtr	=	OpenCV_CreatePooledImage(windowWidth, windowHeight, IPL_DEPTH_16U, 3);
 						break;
 
 					default:
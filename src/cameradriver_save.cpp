@@ -37,6 +37,12 @@
 //*	Jul 25,	2022	<MLS> Increased # of decimal points in WriteIMUtextFile()
 //*	Oct  5,	2022	<MLS> Added ReadIMUdata()
 //*	Jun 13,	2023	<MLS> Added checking for valid IMU
+//*	Oct 16,	2026	<MLS> SaveImageData() now queues a TYPE_SaveJob, files are written by writer threads
+//*	Oct 16,	2026	<MLS> Added FillSaveJob(), QueueSaveJob(), SaveImageJob(), RunSaveWriter()
+//*	Oct 17,	2026	<MLS> Added OpenCV_CreatePooledImage(), openCV image pixels come from the image pool
+//*	Oct 17,	2026	<MLS> CreateOpenCVImage() only re-creates the image when the size or type changes
+//*	Oct 17,	2026	<MLS> The histogram values for a save job are calculated by the writer thread
+//*	Oct 17,	2026	<MLS> StopSaveWriterThreads() joins the writers instead of waiting 5 seconds
 //*****************************************************************************
 
 #ifdef _ENABLE_CAMERA_
@@ -45,7 +51,10 @@
 //#define	_ENABLE_PNG_
 
 #include	<stdio.h>
+#include	<stdlib.h>
 #include	<string.h>
+#include	<pthread.h>
+#include	<sys/stat.h>
 
 #define _ENABLE_CONSOLE_DEBUG_
 #include	"ConsoleDebug.h"
@@ -72,11 +81,14 @@
 	#include "imu_lib_bno055.h"
 #endif
 
+//*****************************************************************************
+//*	Called from the state machine after the image has been read out.
+//*	Only the things that have to be captured at the time of the exposure are done here,
+//*	the files are written by the save writer threads
 //*****************************************************************************
 void	CameraDriver::SaveImageData(void)
 {
-int		iii;
-
+TYPE_SaveJob	saveJob;
 
 	CONSOLE_DEBUG_W_NUM("cSaveNextImage\t=", cSaveNextImage);
 	CONSOLE_DEBUG_W_NUM("cSaveAllImages\t=", cSaveAllImages);
@@ -84,45 +96,381 @@ int		iii;
 	cTotalFramesSaved++;
 	CONSOLE_DEBUG_W_NUM("cCameraProp.SavedImageCnt=", cCameraProp.SavedImageCnt);
 
-
-	for (iii=0; iii<kMaxDataProducts; iii++)
+	memset(&saveJob, 0, sizeof(TYPE_SaveJob));
+	saveJob.frameSlot	=	AcquireLatestFrame();
+	if (saveJob.frameSlot != NULL)
 	{
-		memset(&cOtherDataProducts[iii], 0, sizeof(TYPE_FILENAME));
-	}
-	cOtherDataCnt	=	0;
+		saveJob.imageData	=	saveJob.frameSlot->dataBuffer;
 
-	if (cCameraDataBuffer != NULL)
-	{
 	#ifdef _ENABLE_IMU_
 		//*	we want to do this first so the readings are closest to the time we took the picture
 		if (IMU_IsAvailable())
 		{
 			ReadIMUdata();
-			WriteIMUtextFile();
+		}
+	#endif
+
+		FillSaveJob(&saveJob);
+
+	#ifdef _USE_OPENCV_
+		//*	the live image gets re-created for the next frame, the writer gets its own copy
+		if ((cOpenCV_ImagePtr != NULL) && (saveJob.saveAsJPEG || saveJob.saveAsPNG))
+		{
+		#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+			saveJob.openCV_ImagePtr	=	OpenCV_CreatePooledImage(	cOpenCV_ImagePtr->cols,
+																cOpenCV_ImagePtr->rows,
+																cOpenCV_ImagePtr->type());
+			if (saveJob.openCV_ImagePtr != NULL)
+			{
+				cOpenCV_ImagePtr->copyTo(*saveJob.openCV_ImagePtr);
+			}
+		#else
+			saveJob.openCV_ImagePtr	=	OpenCV_CreatePooledImage(	cOpenCV_ImagePtr->width,
+																cOpenCV_ImagePtr->height,
+																cOpenCV_ImagePtr->depth,
+																cOpenCV_ImagePtr->nChannels);
+			if (saveJob.openCV_ImagePtr != NULL)
+			{
+				cvCopy(cOpenCV_ImagePtr, saveJob.openCV_ImagePtr);
+			}
+		#endif // _USE_OPENCV_CPP_
+		}
+	#endif	//	_USE_OPENCV_
+
+		if (QueueSaveJob(&saveJob) == false)
+		{
+			FreeSaveJob(&saveJob);
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG("There is no frame to save");
+	}
+	cSaveNextImage	=	false;
+}
+
+//*****************************************************************************
+//*	copy everything that is needed to write the files,
+//*	the frame slot and the image data are set by the caller
+//*****************************************************************************
+void	CameraDriver::FillSaveJob(TYPE_SaveJob *saveJob)
+{
+	GenerateFileNameRoot();
+	strcpy(saveJob->fileNameRoot,	cFileNameRoot);
+	strcpy(saveJob->objectName,		cObjectName);
+
+	if (saveJob->frameSlot != NULL)
+	{
+		saveJob->roiInfo	=	saveJob->frameSlot->roiInfo;
+	}
+	else
+	{
+		GetImage_ROI_info();
+		saveJob->roiInfo	=	cROIinfo;
+	}
+	saveJob->ccdTempErrCode		=	Read_SensorTemp();
+	saveJob->cameraProp			=	cCameraProp;
+	saveJob->imageMode			=	cImageMode;
+	saveJob->imageSeqNumber		=	cImageSeqNumber;
+	saveJob->numFramesRequested	=	cNumFramesRequested;
+	saveJob->frameRate			=	cFrameRate;
+	saveJob->saveAsFITS			=	cSaveAsFITS;
+	saveJob->saveAsJPEG			=	cSaveAsJPEG;
+	saveJob->saveAsPNG			=	cSaveAsPNG;
+
+#ifdef _ENABLE_FILTERWHEEL_
+	if (cConnectedFilterWheel == NULL)
+	{
+		UpdateFilterwheelLink();
+	}
+	if (cFilterWheelInfoValid && (cConnectedFilterWheel != NULL))
+	{
+		saveJob->filterPosValid		=	(cConnectedFilterWheel->Read_CurrentFilterPositon(&saveJob->filterPosition) == kASCOM_Err_Success);
+		saveJob->filterNameValid	=	(cConnectedFilterWheel->Read_CurrentFilterName(saveJob->filterName) == kASCOM_Err_Success);
+	}
+#endif	//	_ENABLE_FILTERWHEEL_
+
+#ifdef _ENABLE_FOCUSER_
+	if (cConnectedFocuser == NULL)
+	{
+		UpdateFocuserLink();
+	}
+	if (cConnectedFocuser != NULL)
+	{
+		saveJob->focuserValid		=	true;
+		saveJob->focuserPosition	=	cConnectedFocuser->GetFocuserPosition();
+		saveJob->focuserTemperature	=	cConnectedFocuser->GetFocuserTemperature();
+		saveJob->focuserVoltage		=	cConnectedFocuser->GetFocuserVoltage();
+	}
+#endif	//	_ENABLE_FOCUSER_
+
+#ifdef _ENABLE_IMU_
+	saveJob->imuAvailable	=	IMU_IsAvailable();
+	saveJob->imuEulerValid	=	cIMU_EulerValid;
+	saveJob->imuQuatValid	=	cIMU_QuatValid;
+	saveJob->imuHeading		=	cIMU_Heading;
+	saveJob->imuRoll		=	cIMU_Roll;
+	saveJob->imuPitch		=	cIMU_Pitch;
+	saveJob->imuWWW			=	cIMU_www;
+	saveJob->imuXXX			=	cIMU_xxx;
+	saveJob->imuYYY			=	cIMU_yyy;
+	saveJob->imuZZZ			=	cIMU_zzz;
+	saveJob->imuCal_Gyro	=	cIMU_Cal_Gyro;
+	saveJob->imuCal_Acce	=	cIMU_Cal_Acce;
+	saveJob->imuCal_Magn	=	cIMU_Cal_Magn;
+	saveJob->imuCal_Syst	=	cIMU_Cal_Syst;
+#endif // _ENABLE_IMU_
+	gettimeofday(&saveJob->queuedTime, NULL);
+}
+
+//*****************************************************************************
+void	CameraDriver::FreeSaveJob(TYPE_SaveJob *saveJob)
+{
+#ifdef _USE_OPENCV_
+	if (saveJob->openCV_ImagePtr != NULL)
+	{
+		OpenCV_ReleasePooledImage(&saveJob->openCV_ImagePtr);
+	}
+#endif	//	_USE_OPENCV_
+	if (saveJob->frameSlot != NULL)
+	{
+		ReleaseFrame(saveJob->frameSlot);
+		saveJob->frameSlot	=	NULL;
+		saveJob->imageData	=	NULL;
+	}
+}
+
+//*****************************************************************************
+//*	jobs being written count against the queue depth as well,
+//*	they are still holding a frame slot
+//*****************************************************************************
+bool	CameraDriver::IsSaveQueueFull(void)
+{
+bool	queueIsFull;
+
+	pthread_mutex_lock(&cSaveQueueMutex);
+	queueIsFull	=	((cSaveQueueCount + cSaveJobsActive) >= kSaveQueueDepth);
+	pthread_mutex_unlock(&cSaveQueueMutex);
+	return(queueIsFull);
+}
+
+//*****************************************************************************
+//*	returns false if the job could not be queued, the caller still owns it.
+//*	The sequencer checks IsSaveQueueFull() before starting an exposure,
+//*	so normally this never has to wait
+//*****************************************************************************
+bool	CameraDriver::QueueSaveJob(TYPE_SaveJob *saveJob)
+{
+bool			jobQueued;
+int				waitRetCode;
+int				queueIdx;
+struct timespec	waitUntil;
+
+	StartSaveWriterThreads();
+
+	jobQueued	=	false;
+	pthread_mutex_lock(&cSaveQueueMutex);
+	if (cSaveWriterCnt > 0)
+	{
+		clock_gettime(CLOCK_REALTIME, &waitUntil);
+		waitUntil.tv_sec	+=	kFrameSlotWait_Secs;
+		waitRetCode			=	0;
+		while (((cSaveQueueCount + cSaveJobsActive) >= kSaveQueueDepth) && (waitRetCode == 0))
+		{
+			CONSOLE_DEBUG("Save queue is full, waiting");
+			waitRetCode	=	pthread_cond_timedwait(&cSaveQueueNotFull, &cSaveQueueMutex, &waitUntil);
+		}
+		if ((cSaveQueueCount + cSaveJobsActive) < kSaveQueueDepth)
+		{
+			queueIdx				=	(cSaveQueueHead + cSaveQueueCount) % kSaveQueueDepth;
+			cSaveQueue[queueIdx]	=	*saveJob;
+			cSaveQueueCount++;
+			jobQueued				=	true;
+			pthread_cond_signal(&cSaveQueueNotEmpty);
+		}
+	}
+	if (jobQueued == false)
+	{
+		cSaveJobsDropped++;
+	}
+	pthread_mutex_unlock(&cSaveQueueMutex);
+
+	if (jobQueued == false)
+	{
+		CONSOLE_DEBUG_W_STR("Image was NOT saved:", saveJob->fileNameRoot);
+	}
+	return(jobQueued);
+}
+
+//*****************************************************************************
+static void	*SaveWriterThread(void *arg)
+{
+CameraDriver	*cameraDriverPtr;
+
+	cameraDriverPtr	=	(CameraDriver *)arg;
+	if (cameraDriverPtr != NULL)
+	{
+		if (cameraDriverPtr->cMagicCookie == kMagicCookieValue)
+		{
+			cameraDriverPtr->RunSaveWriter();
+		}
+		else
+		{
+			CONSOLE_DEBUG("cMagicCookie is invalid  !!!!!!!!!!!!!!!!!!!!!!!!!!!!");
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+//*	the writer threads are started the first time an image is saved
+//*****************************************************************************
+void	CameraDriver::StartSaveWriterThreads(void)
+{
+int		threadErr;
+int		threadCnt;
+
+	threadCnt	=	gImageSaveThreadCnt;
+	if (threadCnt < 1)
+	{
+		threadCnt	=	1;
+	}
+	if (threadCnt > kMaxSaveWriterThreads)
+	{
+		threadCnt	=	kMaxSaveWriterThreads;
+	}
+
+	pthread_mutex_lock(&cSaveQueueMutex);
+	while (cSaveWriterKeepRunning && (cSaveWriterCnt < threadCnt))
+	{
+		threadErr	=	pthread_create(&cSaveWriterThreadID[cSaveWriterCnt], NULL, &SaveWriterThread, this);
+		if (threadErr != 0)
+		{
+			CONSOLE_DEBUG_W_NUM("ERROR: pthread_create() returned\t=", threadErr);
+			break;
+		}
+		cSaveWriterCnt++;
+	}
+	pthread_mutex_unlock(&cSaveQueueMutex);
+}
+
+//*****************************************************************************
+//*	the writers finish the jobs that are already in the queue before they exit.
+//*	This does not return until every writer has been joined, the writers are
+//*	using the frame slots and the queue that the destructor tears down
+//*****************************************************************************
+void	CameraDriver::StopSaveWriterThreads(void)
+{
+int		writerCnt;
+int		iii;
+
+	pthread_mutex_lock(&cSaveQueueMutex);
+	cSaveWriterKeepRunning	=	false;
+	pthread_cond_broadcast(&cSaveQueueNotEmpty);
+	//*	no writer exits until cSaveWriterKeepRunning is false and none can be started after it is
+	writerCnt				=	cSaveWriterCnt;
+	pthread_mutex_unlock(&cSaveQueueMutex);
+
+	for (iii=0; iii<writerCnt; iii++)
+	{
+		pthread_join(cSaveWriterThreadID[iii], NULL);
+	}
+}
+
+//*****************************************************************************
+void	CameraDriver::RunSaveWriter(void)
+{
+TYPE_SaveJob	saveJob;
+struct timeval	startTime;
+struct timeval	endTime;
+uint32_t		writeTime_us;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	while (true)
+	{
+		pthread_mutex_lock(&cSaveQueueMutex);
+		while ((cSaveQueueCount == 0) && cSaveWriterKeepRunning)
+		{
+			pthread_cond_wait(&cSaveQueueNotEmpty, &cSaveQueueMutex);
+		}
+		if (cSaveQueueCount == 0)
+		{
+			//*	we have been told to stop and the queue is empty
+			cSaveWriterCnt--;
+			pthread_cond_broadcast(&cSaveQueueNotFull);
+			pthread_mutex_unlock(&cSaveQueueMutex);
+			break;
+		}
+		saveJob			=	cSaveQueue[cSaveQueueHead];
+		cSaveQueueHead	=	(cSaveQueueHead + 1) % kSaveQueueDepth;
+		cSaveQueueCount--;
+		cSaveJobsActive++;
+		pthread_mutex_unlock(&cSaveQueueMutex);
+
+		gettimeofday(&startTime, NULL);
+		SaveImageJob(&saveJob);
+		FreeSaveJob(&saveJob);
+		gettimeofday(&endTime, NULL);
+
+		writeTime_us	=	((endTime.tv_sec - startTime.tv_sec) * 1000000) + (endTime.tv_usec - startTime.tv_usec);
+
+		pthread_mutex_lock(&cSaveQueueMutex);
+		cSaveJobsActive--;
+		cSaveJobsCompleted++;
+		cSaveWriteLast_us	=	writeTime_us;
+		cSaveWriteTotal_us	+=	writeTime_us;
+		cSaveBytesWritten	+=	saveJob.bytesWritten;
+		if (writeTime_us > cSaveWriteMax_us)
+		{
+			cSaveWriteMax_us	=	writeTime_us;
+		}
+		pthread_cond_signal(&cSaveQueueNotFull);
+		pthread_mutex_unlock(&cSaveQueueMutex);
+	}
+}
+
+//*****************************************************************************
+//*	runs on a save writer thread
+//*****************************************************************************
+void	CameraDriver::SaveImageJob(TYPE_SaveJob *saveJob)
+{
+	CONSOLE_DEBUG_W_STR("Saving", saveJob->fileNameRoot);
+	if (saveJob->imageData != NULL)
+	{
+	#ifdef _ENABLE_IMU_
+		if (saveJob->imuAvailable)
+		{
+			WriteIMUtextFile(saveJob);
 		}
 	#endif
 
 	#ifdef _INCLUDE_HISTOGRAM_
-		CalculateHistogramArray();
+		//*	min/max/peak for the FITS header, done here so the camera thread does not wait for it
+		CalculateSaveJobHistogram(saveJob);
+
 		//*	Apr 15,	2022	<MLS> Disabled Histogram to speed up saving files
-		//	SaveHistogramFile();
+		//	SaveHistogramFile(saveJob);
 	#endif // _INCLUDE_HISTOGRAM_
 
 
 	#ifdef _USE_OPENCV_
-		if (cSaveAsJPEG || cSaveAsPNG)
+		if (saveJob->saveAsJPEG || saveJob->saveAsPNG)
 		{
-			SaveOpenCVImage();
+			SaveOpenCVImage(saveJob);
 		}
 	#endif	//	_USE_OPENCV_
 
 
 	#if defined(_ENABLE_JPEGLIB_)
-int		bytesPerPixel;
-		bytesPerPixel		=	cOpenCV_ImagePtr->step[1];
-		if (cSaveAsJPEG && (bytesPerPixel!= 2))
+		if (saveJob->saveAsJPEG && (saveJob->openCV_ImagePtr != NULL))
 		{
-			SaveUsingJpegLib();
+		int		bytesPerPixel;
+
+			bytesPerPixel		=	saveJob->openCV_ImagePtr->step[1];
+			if (bytesPerPixel != 2)
+			{
+				SaveUsingJpegLib(saveJob);
+			}
 		}
 	#endif	//	_ENABLE_JPEGLIB_
 
@@ -134,9 +482,9 @@ int		bytesPerPixel;
 
 	//*	we want FITS to be last so it can include info about other save data products
 	#ifdef _ENABLE_FITS_
-		if (cSaveAsFITS)
+		if (saveJob->saveAsFITS)
 		{
-			SaveImageAsFITS();
+			SaveImageAsFITS(false, saveJob);
 		}
 	#endif // _ENABLE_FITS_
 	#if defined(_JETSON_) && defined(_FIND_STARS_)
@@ -148,7 +496,7 @@ int		bytesPerPixel;
 		CONSOLE_DEBUG("Calling ProcessORB_Image!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
 		SETUP_TIMING();
 
-		keyPointCnt	=	ProcessORB_Image(cOpenCV_Image);
+		keyPointCnt	=	ProcessORB_Image(saveJob->openCV_ImagePtr);
 
 		DEBUG_TIMING("Time to complete ORB");
 		CONSOLE_DEBUG_W_LONG("keyPointCnt\t=", keyPointCnt);
@@ -156,9 +504,9 @@ int		bytesPerPixel;
 		CONSOLE_DEBUG("Saving ORB Image *****************************************");
 		strcpy(imageFilePath, gImageDataDir);
 		strcat(imageFilePath, "/");
-		strcat(imageFilePath, cFileNameRoot);
+		strcat(imageFilePath, saveJob->fileNameRoot);
 		strcat(imageFilePath, "-orb.jpg");
-		openCVerr	=	cvSaveImage(imageFilePath, cOpenCV_Image, quality);
+		openCVerr	=	cvSaveImage(imageFilePath, saveJob->openCV_ImagePtr, quality);
 		if (openCVerr != 0)
 		{
 			CONSOLE_DEBUG_W_NUM("cvSaveImage returned\t=", openCVerr);
@@ -167,39 +515,91 @@ int		bytesPerPixel;
 	}
 	else
 	{
-		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
+		CONSOLE_DEBUG("imageData is NULL");
 	}
-	cSaveNextImage	=	false;
-
 }
 
 //*****************************************************************************
-void	CameraDriver::AddToDataProductsList(const char *newDataProductName, const char *newDatacomment)
+void	CameraDriver::AddToDataProductsList(TYPE_SaveJob *saveJob, const char *newDataProductName, const char *newDatacomment)
 {
 int		fileNameLen;
+char	filePath[256];
 
-	if (cOtherDataCnt < kMaxDataProducts)
+	if (saveJob->otherDataCnt < kMaxDataProducts)
 	{
 		fileNameLen	=	strlen(newDataProductName);
 		if (fileNameLen < kMaxFileNameLen)
 		{
-			strcpy(cOtherDataProducts[cOtherDataCnt].filename, newDataProductName);
+			strcpy(saveJob->otherDataProducts[saveJob->otherDataCnt].filename, newDataProductName);
 			if (newDatacomment != NULL)
 			{
-				strcpy(cOtherDataProducts[cOtherDataCnt].comment, newDatacomment);
+				strcpy(saveJob->otherDataProducts[saveJob->otherDataCnt].comment, newDatacomment);
 			}
-			cOtherDataCnt++;
+			saveJob->otherDataCnt++;
 		}
 	}
 	else
 	{
-		CONSOLE_DEBUG("cOtherDataProducts list is full");
+		CONSOLE_DEBUG("otherDataProducts list is full");
+	}
+	//*	all of the other data products are in the image data directory
+	sprintf(filePath, "%s/%s", gImageDataDir, newDataProductName);
+	AddSavedFileSize(saveJob, filePath);
+}
+
+//*****************************************************************************
+//*	for the MB/sec save statistics
+//*****************************************************************************
+void	CameraDriver::AddSavedFileSize(TYPE_SaveJob *saveJob, const char *filePath)
+{
+struct stat	fileStatus;
+
+	if (stat(filePath, &fileStatus) == 0)
+	{
+		saveJob->bytesWritten	+=	fileStatus.st_size;
 	}
 }
 
 
 #if defined(_USE_OPENCV_)
 #if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+//*****************************************************************************
+//*	the Mat only points at the pool buffer, nothing may re-allocate it
+//*****************************************************************************
+cv::Mat	*OpenCV_CreatePooledImage(const int width, const int height, const int cvType)
+{
+cv::Mat		*imagePtr;
+size_t		rowBytes;
+void		*pixelData;
+
+	imagePtr	=	NULL;
+	rowBytes	=	width * CV_ELEM_SIZE(cvType);
+	pixelData	=	ImagePool_Alloc(rowBytes * height);
+	if (pixelData != NULL)
+	{
+		imagePtr	=	new cv::Mat(height, width, cvType, pixelData, rowBytes);
+	}
+	else
+	{
+		CONSOLE_DEBUG("Failed to allocate image memory");
+	}
+	return(imagePtr);
+}
+
+//*****************************************************************************
+void	OpenCV_ReleasePooledImage(cv::Mat **imagePtr)
+{
+void	*pixelData;
+
+	if (*imagePtr != NULL)
+	{
+		pixelData	=	(void *)(*imagePtr)->datastart;
+		delete *imagePtr;
+		ImagePool_Free(pixelData);
+		*imagePtr	=	NULL;
+	}
+}
+
 //*****************************************************************************
 //*	using "C++" interface
 //*****************************************************************************
@@ -209,6 +609,7 @@ int				returnCode	=	0;
 int				width;
 int				height;
 int				imageDataLen;
+int				cvType;
 
 //	CONSOLE_DEBUG("++++++++++++++++++++++++++++++++++++++++++++++++++++++++");
 //	CONSOLE_DEBUG("+++++           OpenCV++ not finished              +++++");
@@ -218,16 +619,6 @@ int				imageDataLen;
 	CONSOLE_DEBUG(__FUNCTION__);
 
 	GenerateFileNameRoot();
-	if (cOpenCV_ImagePtr != NULL)
-	{
-		delete cOpenCV_ImagePtr;
-		cOpenCV_ImagePtr	=	NULL;
-	}
-	if (cOpenCV_LiveDisplayPtr != NULL)
-	{
-		delete cOpenCV_LiveDisplayPtr;
-		cOpenCV_LiveDisplayPtr	=	NULL;
-	}
 	width			=	cCameraProp.CameraXsize;
 	height			=	cCameraProp.CameraYsize;
 	GetImage_ROI_info();
@@ -238,31 +629,47 @@ int				imageDataLen;
 		case kImageType_MONO8:
 			CONSOLE_DEBUG("kImageType_RAW8");
 			//	9/20/2022
-			//cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_8UC3);
-			cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_8UC1);
+			//cvType			=	CV_8UC3;
+			cvType				=	CV_8UC1;
 			imageDataLen		=	width * height;
 			break;
 
 		case kImageType_RAW16:
 			CONSOLE_DEBUG("kImageType_RAW16");
-			cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_16UC1);
+			cvType				=	CV_16UC1;
 			imageDataLen		=	width * height * 2;
 			break;
 
 
 		case kImageType_RGB24:
 			CONSOLE_DEBUG("kImageType_RGB24");
-			cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_8UC3);
+			cvType				=	CV_8UC3;
 			imageDataLen		=	width * height * 3;
 			break;
 
 		case kImageType_Y8:
 		default:
-			cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_8UC1);
+			cvType				=	CV_8UC1;
 			imageDataLen		=	width * height;
 			break;
 	}
 
+	//*	the image is only re-created when the size or the type changes
+	if ((cOpenCV_ImagePtr != NULL) &&
+		((cOpenCV_ImagePtr->cols != width) || (cOpenCV_ImagePtr->rows != height) || (cOpenCV_ImagePtr->type() != cvType)))
+	{
+		OpenCV_ReleasePooledImage(&cOpenCV_ImagePtr);
+		if (cOpenCV_LiveDisplayPtr != NULL)
+		{
+			delete cOpenCV_LiveDisplayPtr;
+			cOpenCV_LiveDisplayPtr	=	NULL;
+		}
+	}
+	if (cOpenCV_ImagePtr == NULL)
+	{
+		cOpenCV_ImagePtr	=	OpenCV_CreatePooledImage(width, height, cvType);
+	}
+
 	if (imageDataPtr != NULL)
 	{
 		if (cOpenCV_ImagePtr != NULL)
@@ -332,7 +739,7 @@ int				imageDataLen;
 //*****************************************************************************
 //*	using "C++" interface
 //*****************************************************************************
-int	CameraDriver::SaveOpenCVImage(void)
+int	CameraDriver::SaveOpenCVImage(TYPE_SaveJob *saveJob)
 {
 int			bytesPerPixel;
 int			openCVerr;
@@ -342,31 +749,32 @@ char		imageFilePath[128];
 	CONSOLE_DEBUG_W_STR(__FUNCTION__, "Using C++ openCV calls");
 	SETUP_TIMING();
 
-	if (cOpenCV_ImagePtr != NULL)
+	if (saveJob->openCV_ImagePtr != NULL)
 	{
 
-		bytesPerPixel		=	cOpenCV_ImagePtr->step[1];
+		bytesPerPixel		=	saveJob->openCV_ImagePtr->step[1];
 		CONSOLE_DEBUG_W_NUM("bytesPerPixel\t=",	bytesPerPixel);
 		if (bytesPerPixel != 0)
 		{
 			//--------------------------------------------------------------------------------------------
 			//*	JPEG does not work on 16 bit images
-			if (cSaveAsJPEG && (bytesPerPixel != 2))
+			if (saveJob->saveAsJPEG && (bytesPerPixel != 2))
 			{
 				//*	save as JPEG
-				strcpy(imageFileName, cFileNameRoot);
+				strcpy(imageFileName, saveJob->fileNameRoot);
 				strcat(imageFileName, ".jpg");
 
 				strcpy(imageFilePath, gImageDataDir);
 				strcat(imageFilePath, "/");
 				strcat(imageFilePath, imageFileName);
 
-				strcpy(cLastJpegImageName, imageFilePath);	//*	save the full image path for the web server
-
-				openCVerr	=	cv::imwrite(imageFilePath, *cOpenCV_ImagePtr);
+				openCVerr	=	cv::imwrite(imageFilePath, *saveJob->openCV_ImagePtr);
 				if (openCVerr == 1)
 				{
-					AddToDataProductsList(imageFileName, "JPEG image-openCV");
+					pthread_mutex_lock(&cSaveQueueMutex);
+					strcpy(cLastJpegImageName, imageFilePath);	//*	save the full image path for the web server
+					pthread_mutex_unlock(&cSaveQueueMutex);
+					AddToDataProductsList(saveJob, imageFileName, "JPEG image-openCV");
 				}
 				else
 				{
@@ -375,24 +783,24 @@ char		imageFilePath[128];
 			}
 
 			//--------------------------------------------------------------------------------------------
-			if (cSaveAsPNG)
+			if (saveJob->saveAsPNG)
 			{
 //				SETUP_TIMING();
 //				//*	OpenCV png file creation takes WAY too long, use caution
 //				START_TIMING();
 
 				//*	save as png
-				strcpy(imageFileName, cFileNameRoot);
+				strcpy(imageFileName, saveJob->fileNameRoot);
 				strcat(imageFileName, ".png");
 
 				strcpy(imageFilePath, gImageDataDir);
 				strcat(imageFilePath, "/");
 				strcat(imageFilePath, imageFileName);
 
-				openCVerr	=	cv::imwrite(imageFilePath, *cOpenCV_ImagePtr);
+				openCVerr	=	cv::imwrite(imageFilePath, *saveJob->openCV_ImagePtr);
 				if (openCVerr == 1)
 				{
-					AddToDataProductsList(imageFileName, "PNG image-openCV");
+					AddToDataProductsList(saveJob, imageFileName, "PNG image-openCV");
 				}
 				else
 				{
@@ -411,7 +819,7 @@ char		imageFilePath[128];
 	}
 	else
 	{
-		CONSOLE_DEBUG("cOpenCV_ImagePtr is NULL!!!!!!");
+		CONSOLE_DEBUG("openCV_ImagePtr is NULL!!!!!!");
 	}
 	return(0);
 }
@@ -420,6 +828,44 @@ char		imageFilePath[128];
 //*****************************************************************************
 //*	wget http://192.168.0.201:6800/api/v1.0.0-oas3/camera/0/startexposure%20Content-Type:%20-dDuration=0.011&Light=true
 //*	wget http://192.168.0.201:6800/api/v1.0.0-oas3/camera/0/imagearray
+//*****************************************************************************
+IplImage	*OpenCV_CreatePooledImage(const int width, const int height, const int depth, const int channels)
+{
+IplImage	*imagePtr;
+void		*pixelData;
+
+	imagePtr	=	cvCreateImageHeader(cvSize(width, height), depth, channels);
+	if (imagePtr != NULL)
+	{
+		pixelData	=	ImagePool_Alloc(imagePtr->imageSize);
+		if (pixelData != NULL)
+		{
+			cvSetData(imagePtr, pixelData, imagePtr->widthStep);
+		}
+		else
+		{
+			CONSOLE_DEBUG("Failed to allocate image memory");
+			cvReleaseImageHeader(&imagePtr);
+			imagePtr	=	NULL;
+		}
+	}
+	return(imagePtr);
+}
+
+//*****************************************************************************
+void	OpenCV_ReleasePooledImage(IplImage **imagePtr)
+{
+void	*pixelData;
+
+	if (*imagePtr != NULL)
+	{
+		pixelData	=	(*imagePtr)->imageDataOrigin;
+		cvReleaseImageHeader(imagePtr);
+		ImagePool_Free(pixelData);
+		*imagePtr	=	NULL;
+	}
+}
+
 //*****************************************************************************
 //*	using "C" interface
 //*****************************************************************************
@@ -430,6 +876,8 @@ int				returnCode	=	0;
 int				width;
 int				height;
 int				imageDataLen;
+int				imageDepth;
+int				imageChannels;
 int				openCVimageWidth;
 int				bytesPerPixel;
 int				bytesPerPixel2;	//*	calculated 2 different ways
@@ -440,16 +888,6 @@ int				bytesPerPixel2;	//*	calculated 2 different ways
 
 	GenerateFileNameRoot();
 
-	if (cOpenCV_ImagePtr != NULL)
-	{
-		cvReleaseImage(&cOpenCV_ImagePtr);
-		cOpenCV_ImagePtr	=	NULL;
-	}
-	if (cOpenCV_LiveDisplayPtr != NULL)
-	{
-		cvReleaseImage(&cOpenCV_LiveDisplayPtr);
-		cOpenCV_LiveDisplayPtr	=	NULL;
-	}
 	width			=	cCameraProp.CameraXsize;
 	height			=	cCameraProp.CameraYsize;
 	GetImage_ROI_info();
@@ -459,33 +897,53 @@ int				bytesPerPixel2;	//*	calculated 2 different ways
 //	CONSOLE_DEBUG_W_NUM("height\t=",	height);
 //	CONSOLE_DEBUG_W_NUM("w * h\t=",		(width * height));
 
+	imageDepth		=	0;
+	imageChannels	=	0;
 	switch(cROIinfo.currentROIimageType)
 	{
 		case kImageType_RAW8:
 		//	CONSOLE_DEBUG("kImageType_RAW8");
-			cOpenCV_ImagePtr	=	cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
+			imageDepth			=	IPL_DEPTH_8U;
+			imageChannels		=	1;
 			imageDataLen		=	width * height;
 			break;
 
 		case kImageType_RAW16:
 		//	CONSOLE_DEBUG("kImageType_RAW16");
-			cOpenCV_ImagePtr	=	cvCreateImage(cvSize(width, height), IPL_DEPTH_16U, 1);
+			imageDepth			=	IPL_DEPTH_16U;
+			imageChannels		=	1;
 			imageDataLen		=	width * height * 2;
 			break;
 
 
 		case kImageType_RGB24:
 		//	CONSOLE_DEBUG("kImageType_RGB24");
-			cOpenCV_ImagePtr	=	cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 3);
+			imageDepth			=	IPL_DEPTH_8U;
+			imageChannels		=	3;
 			imageDataLen		=	width * height * 3;
 			break;
 
 		case kImageType_Y8:
 		default:
-			cOpenCV_ImagePtr	=	NULL;
 			break;
 
 	}
+
+	//*	the image is only re-created when the size or the type changes
+	if ((cOpenCV_ImagePtr != NULL) &&
+		((cOpenCV_ImagePtr->width != width) || (cOpenCV_ImagePtr->height != height) ||
+		(cOpenCV_ImagePtr->depth != imageDepth) || (cOpenCV_ImagePtr->nChannels != imageChannels)))
+	{
+		OpenCV_ReleasePooledImage(&cOpenCV_ImagePtr);
+		if (cOpenCV_LiveDisplayPtr != NULL)
+		{
+			OpenCV_ReleasePooledImage(&cOpenCV_LiveDisplayPtr);
+		}
+	}
+	if ((cOpenCV_ImagePtr == NULL) && (imageChannels > 0))
+	{
+		cOpenCV_ImagePtr	=	OpenCV_CreatePooledImage(width, height, imageDepth, imageChannels);
+	}
 	DEBUG_TIMING("Stop point 1 (milliseconds)\t=");
 
 	if (imageDataPtr != NULL)
@@ -560,7 +1018,7 @@ int				bytesPerPixel2;	//*	calculated 2 different ways
 //*****************************************************************************
 //*	using "C" interface
 //*****************************************************************************
-int	CameraDriver::SaveOpenCVImage(void)
+int	CameraDriver::SaveOpenCVImage(TYPE_SaveJob *saveJob)
 {
 int			bytesPerPixel;
 int			openCVerr;
@@ -572,24 +1030,26 @@ int			quality[3] = {16, 200, 0};
 	CONSOLE_DEBUG(__FUNCTION__);
 	SETUP_TIMING();
 
-	if (cOpenCV_ImagePtr != NULL)
+	if (saveJob->openCV_ImagePtr != NULL)
 	{
-		bytesPerPixel		=	(cOpenCV_ImagePtr->depth / 8) * cOpenCV_ImagePtr->nChannels;
+		bytesPerPixel		=	(saveJob->openCV_ImagePtr->depth / 8) * saveJob->openCV_ImagePtr->nChannels;
 		if (bytesPerPixel != 2)
 		{
 			//*	save as JPEG
-			strcpy(imageFileName, cFileNameRoot);
+			strcpy(imageFileName, saveJob->fileNameRoot);
 			strcat(imageFileName, ".jpg");
 
 			strcpy(imageFilePath, gImageDataDir);
 			strcat(imageFilePath, "/");
 			strcat(imageFilePath, imageFileName);
 
-			strcpy(cLastJpegImageName, imageFilePath);	//*	save the full image path for the web server
-			openCVerr	=	cvSaveImage(imageFilePath, cOpenCV_ImagePtr, quality);
+			openCVerr	=	cvSaveImage(imageFilePath, saveJob->openCV_ImagePtr, quality);
 			if (openCVerr == 1)
 			{
-				AddToDataProductsList(imageFileName, "JPEG image-openCV");
+				pthread_mutex_lock(&cSaveQueueMutex);
+				strcpy(cLastJpegImageName, imageFilePath);	//*	save the full image path for the web server
+				pthread_mutex_unlock(&cSaveQueueMutex);
+				AddToDataProductsList(saveJob, imageFileName, "JPEG image-openCV");
 			}
 			else
 			{
@@ -597,25 +1057,24 @@ int			quality[3] = {16, 200, 0};
 			}
 		}
 	#ifdef _ENABLE_PNG_
-		if (cOpenCV_ImagePtr->depth == 16)
+		if (saveJob->openCV_ImagePtr->depth == 16)
 		{
 			SETUP_TIMING();
 			//*	OpenCV png file creation takes WAY too long, use caution
 			START_TIMING();
 			//*	save as PNG
-			strcpy(imageFileName, cFileNameRoot);
+			strcpy(imageFileName, saveJob->fileNameRoot);
 			strcat(imageFileName, ".png");
 
 			strcpy(imageFilePath, gImageDataDir);
 			strcat(imageFilePath, "/");
 			strcat(imageFilePath, imageFileName);
 
-			strcpy(cLastJpegImageName, imageFilePath);	//*	save the full image path for the web server
-			openCVerr	=	cvSaveImage(imageFilePath, cOpenCV_ImagePtr, quality);
+			openCVerr	=	cvSaveImage(imageFilePath, saveJob->openCV_ImagePtr, quality);
 			DEBUG_TIMING("Time to create PNG file=");
 			if (openCVerr == 1)
 			{
-				AddToDataProductsList(imageFileName, "PNG image-openCV");
+				AddToDataProductsList(saveJob, imageFileName, "PNG image-openCV");
 			}
 			else
 			{
@@ -627,7 +1086,7 @@ int			quality[3] = {16, 200, 0};
 		long	keyPointCnt;
 		//*	this is an attempt at finding the locations of all of the stars in an image.
 
-		keyPointCnt	=	ProcessORB_Image(cOpenCV_ImagePtr, cFileNameRoot);
+		keyPointCnt	=	ProcessORB_Image(saveJob->openCV_ImagePtr, saveJob->fileNameRoot);
 
 	#endif // _ENABLE_STAR_SEARCH_
 	}
@@ -851,7 +1310,7 @@ int		imuRetCode;
 }
 
 //**************************************************************************
-void	CameraDriver::WriteIMUtextFile(void)
+void	CameraDriver::WriteIMUtextFile(TYPE_SaveJob *saveJob)
 {
 char	imageFileName[64];
 char	imageFilePath[128];
@@ -859,7 +1318,7 @@ FILE	*filePointer;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 
-	strcpy(imageFileName, cFileNameRoot);
+	strcpy(imageFileName, saveJob->fileNameRoot);
 	strcat(imageFileName, "-imu.txt");
 
 
@@ -870,38 +1329,38 @@ FILE	*filePointer;
 	if (filePointer != NULL)
 	{
 		fprintf(filePointer, "#using bno055 sensor\r\n");
-		fprintf(filePointer, "Image   =%s\r\n",		cFileNameRoot);
-		if (cIMU_EulerValid)
+		fprintf(filePointer, "Image   =%s\r\n",		saveJob->fileNameRoot);
+		if (saveJob->imuEulerValid)
 		{
-			fprintf(filePointer, "Heading =%3.5f\r\n",	cIMU_Heading);
-			fprintf(filePointer, "Roll    =%3.5f\r\n",	cIMU_Roll);
-			fprintf(filePointer, "Pitch   =%3.5f\r\n",	cIMU_Pitch);
+			fprintf(filePointer, "Heading =%3.5f\r\n",	saveJob->imuHeading);
+			fprintf(filePointer, "Roll    =%3.5f\r\n",	saveJob->imuRoll);
+			fprintf(filePointer, "Pitch   =%3.5f\r\n",	saveJob->imuPitch);
 		}
 		else
 		{
 			fprintf(filePointer, "Error getting IMU data\r\n");
 		}
 
-		if (cIMU_QuatValid)
+		if (saveJob->imuQuatValid)
 		{
-			fprintf(filePointer, "www   =%3.5f\r\n",	cIMU_www);
-			fprintf(filePointer, "xxx   =%3.5f\r\n",	cIMU_xxx);
-			fprintf(filePointer, "yyy   =%3.5f\r\n",	cIMU_yyy);
-			fprintf(filePointer, "zzz   =%3.5f\r\n",	cIMU_zzz);
+			fprintf(filePointer, "www   =%3.5f\r\n",	saveJob->imuWWW);
+			fprintf(filePointer, "xxx   =%3.5f\r\n",	saveJob->imuXXX);
+			fprintf(filePointer, "yyy   =%3.5f\r\n",	saveJob->imuYYY);
+			fprintf(filePointer, "zzz   =%3.5f\r\n",	saveJob->imuZZZ);
 		}
 		else
 		{
 			fprintf(filePointer, "Error getting IMU data\r\n");
 		}
 		fprintf(filePointer,	"IMU-Calibration values 0=uncalibrated 3 = fully calibrated\r\n");
-		fprintf(filePointer,	"IMU-Cal-Gyro   =%d\r\n",	cIMU_Cal_Gyro);
-		fprintf(filePointer,	"IMU-Cal-Acce   =%d\r\n",	cIMU_Cal_Acce);
-		fprintf(filePointer,	"IMU-Cal-Magn   =%d\r\n",	cIMU_Cal_Magn);
-		fprintf(filePointer,	"IMU-Cal-Syst   =%d\r\n",	cIMU_Cal_Syst);
+		fprintf(filePointer,	"IMU-Cal-Gyro   =%d\r\n",	saveJob->imuCal_Gyro);
+		fprintf(filePointer,	"IMU-Cal-Acce   =%d\r\n",	saveJob->imuCal_Acce);
+		fprintf(filePointer,	"IMU-Cal-Magn   =%d\r\n",	saveJob->imuCal_Magn);
+		fprintf(filePointer,	"IMU-Cal-Syst   =%d\r\n",	saveJob->imuCal_Syst);
 
 		fclose(filePointer);
 
-		AddToDataProductsList(imageFileName, "IMU data");
+		AddToDataProductsList(saveJob, imageFileName, "IMU data");
 	}
 	else
 	{
@@ -0,0 +1,645 @@
+//**************************************************************************
+//*	Name:			cameradriver_video.cpp
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Video capture pipeline for all cameras
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistribution of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Usage notes:
+//*		Take_Video() is called by the state machine while the camera is in kCameraState_TakingVideo.
+//*		It only reads the camera (Read_VideoFrame(), camera specific) and queues the frame.
+//*		The overlay, the time stamp file and the video file are done by the encoder thread,
+//*		so a slow encode no longer costs a sensor frame unless the whole pool is in use.
+//*
+//*		capture		->	queue		->	encoder thread	->	free list	->	capture
+//*
+//*		Counters (see Get_Readall_Video())
+//*			cNumVideoFramesSaved	frames read into the pool and queued
+//*			cVideoFramesEncoded		frames written to the video file
+//*			cVideoFramesDropped		frames read while every buffer was in use
+//*			cVideoQueueHighWater	most frames ever waiting for the encoder
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created cameradriver_video.cpp
+//*	Oct 16,	2026	<MLS> Added VideoPipeline_Start(), VideoPipeline_Stop(), RunVideoEncoder()
+//*	Oct 16,	2026	<MLS> Take_Video() is now common to all cameras, moved from cameradriver_ASI.cpp
+//*	Oct 17,	2026	<MLS> Added VideoPipeline_CreateSERfile(), raw frames can be written to a SER file
+//*	Oct 17,	2026	<MLS> Video frame buffers come from the image pool
+//*****************************************************************************
+
+#ifdef _ENABLE_CAMERA_
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<pthread.h>
+#include	<sys/time.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"helper_functions.h"
+
+#include	"alpacadriver.h"
+#include	"alpacadriver_helper.h"
+#include	"cameradriver.h"
+
+#define	kTextBoxHeight	35
+
+//*****************************************************************************
+static void	*VideoEncoderThread(void *arg)
+{
+CameraDriver	*cameraDriverPtr;
+
+	cameraDriverPtr	=	(CameraDriver *)arg;
+	if (cameraDriverPtr != NULL)
+	{
+		if (cameraDriverPtr->cMagicCookie == kMagicCookieValue)
+		{
+			cameraDriverPtr->RunVideoEncoder();
+		}
+		else
+		{
+			CONSOLE_DEBUG("cMagicCookie is invalid  !!!!!!!!!!!!!!!!!!!!!!!!!!!!");
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+//*	allocates the frame pool for the current ROI and starts the encoder thread.
+//*	called by Put_StartVideo() after the video file has been created
+//*****************************************************************************
+bool	CameraDriver::VideoPipeline_Start(void)
+{
+int		bytesPerPixel;
+int		iii;
+int		threadErr;
+bool	allocOK;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	VideoPipeline_Stop();
+
+	cVideoFrameWidth	=	cROIinfo.currentROIwidth;
+	cVideoFrameHeight	=	cROIinfo.currentROIheight;
+	cVideoImageType		=	cROIinfo.currentROIimageType;
+	switch(cVideoImageType)
+	{
+		case kImageType_RAW16:	bytesPerPixel	=	2;	break;
+		case kImageType_RGB24:	bytesPerPixel	=	3;	break;
+		default:				bytesPerPixel	=	1;	break;
+	}
+	cVideoFrameSize		=	(long)cVideoFrameWidth * cVideoFrameHeight * bytesPerPixel;
+	CONSOLE_DEBUG_W_LONG("cVideoFrameSize\t=", cVideoFrameSize);
+
+	allocOK	=	false;
+	if (cVideoFrameSize > 0)
+	{
+		allocOK	=	true;
+		for (iii=0; iii<kVideoFramePoolSize; iii++)
+		{
+			cVideoFramePool[iii].dataBuffer	=	(unsigned char *)ImagePool_Alloc(cVideoFrameSize);
+			if (cVideoFramePool[iii].dataBuffer == NULL)
+			{
+				allocOK	=	false;
+			}
+		}
+		cVideoDropBuffer	=	(unsigned char *)ImagePool_Alloc(cVideoFrameSize);
+		if (cVideoDropBuffer == NULL)
+		{
+			allocOK	=	false;
+		}
+	}
+
+	if (allocOK)
+	{
+		pthread_mutex_lock(&cVideoMutex);
+		for (iii=0; iii<kVideoFramePoolSize; iii++)
+		{
+			cVideoFreeList[iii]	=	iii;
+		}
+		cVideoFreeCount				=	kVideoFramePoolSize;
+		cVideoQueueHead				=	0;
+		cVideoQueueCount			=	0;
+		cVideoQueueHighWater		=	0;
+		cVideoFramesEncoded			=	0;
+		cVideoFramesDropped			=	0;
+		cVideoEncodeLast_us			=	0;
+		cVideoEncodeMax_us			=	0;
+		cVideoEncodeTotal_us		=	0;
+		cVideoEncoderKeepRunning	=	true;
+		pthread_mutex_unlock(&cVideoMutex);
+
+		//*	the frame rate is measured from here
+		gettimeofday(&cCameraProp.Lastexposure_StartTime, NULL);
+
+		threadErr	=	pthread_create(&cVideoEncoderThreadID, NULL, &VideoEncoderThread, this);
+		if (threadErr == 0)
+		{
+			cVideoEncoderRunning	=	true;
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("ERROR: pthread_create() returned\t=", threadErr);
+			allocOK	=	false;
+		}
+	}
+
+	if (allocOK == false)
+	{
+		CONSOLE_DEBUG("Failed to start the video pipeline");
+		VideoPipeline_Stop();
+	}
+	return(allocOK);
+}
+
+//*****************************************************************************
+//*	the encoder writes whatever is still in the queue before it exits
+//*****************************************************************************
+void	CameraDriver::VideoPipeline_Stop(void)
+{
+int		iii;
+
+	if (cVideoEncoderRunning)
+	{
+		pthread_mutex_lock(&cVideoMutex);
+		cVideoEncoderKeepRunning	=	false;
+		pthread_cond_broadcast(&cVideoQueueNotEmpty);
+		pthread_mutex_unlock(&cVideoMutex);
+
+		pthread_join(cVideoEncoderThreadID, NULL);
+		cVideoEncoderRunning	=	false;
+	}
+
+	pthread_mutex_lock(&cVideoMutex);
+	for (iii=0; iii<kVideoFramePoolSize; iii++)
+	{
+		if (cVideoFramePool[iii].dataBuffer != NULL)
+		{
+			ImagePool_Free(cVideoFramePool[iii].dataBuffer);
+			cVideoFramePool[iii].dataBuffer	=	NULL;
+		}
+	}
+	if (cVideoDropBuffer != NULL)
+	{
+		ImagePool_Free(cVideoDropBuffer);
+		cVideoDropBuffer	=	NULL;
+	}
+	cVideoFreeCount		=	0;
+	cVideoQueueCount	=	0;
+	pthread_mutex_unlock(&cVideoMutex);
+}
+
+//*****************************************************************************
+//*	recordingComplete is false when the start failed part way through,
+//*	in that case there is nothing worth describing in the FITS header
+//*****************************************************************************
+void	CameraDriver::VideoPipeline_Finish(const bool recordingComplete)
+{
+	CONSOLE_DEBUG(__FUNCTION__);
+	VideoPipeline_Stop();
+
+	CONSOLE_DEBUG_W_NUM("Video frames captured\t=",	cNumVideoFramesSaved);
+	CONSOLE_DEBUG_W_NUM("Video frames encoded \t=",	cVideoFramesEncoded);
+	CONSOLE_DEBUG_W_NUM("Video frames dropped \t=",	cVideoFramesDropped);
+	CONSOLE_DEBUG_W_NUM("Queue high water     \t=",	cVideoQueueHighWater);
+
+#ifdef _USE_OPENCV_
+	if (cOpenCV_videoWriter != NULL)
+	{
+	#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+		cOpenCV_videoWriter->release();
+		delete cOpenCV_videoWriter;
+	#else
+		cvReleaseVideoWriter(&cOpenCV_videoWriter);
+	#endif
+		cOpenCV_videoWriter	=	NULL;
+		CONSOLE_DEBUG("cOpenCV_videoWriter released");
+	}
+#endif // _USE_OPENCV_
+
+	if (cVideoTimeStampFilePtr != NULL)
+	{
+		fclose(cVideoTimeStampFilePtr);
+		cVideoTimeStampFilePtr	=	NULL;
+	}
+
+	if (cSERfile.fileDesc >= 0)
+	{
+		if (SERfile_Close(&cSERfile) == false)
+		{
+			CONSOLE_DEBUG("Write error on the SER file, it may be incomplete");
+		}
+	}
+
+	if (recordingComplete)
+	{
+		gettimeofday(&cCameraProp.Lastexposure_EndTime, NULL);
+	#ifdef _ENABLE_FITS_
+		SaveImageAsFITS(SAVE_AVI);
+	#endif // _ENABLE_FITS_
+		WriteFireCaptureTextFile();
+	}
+	cInternalCameraState	=	kCameraState_Idle;
+}
+
+//*****************************************************************************
+//*	the SER file gets the sensor data as is, 16 bit frames stay 16 bit.
+//*	VideoPipeline_Start() sizes the frames from the same ROI info
+//*****************************************************************************
+bool	CameraDriver::VideoPipeline_CreateSERfile(const char *filePath)
+{
+bool	fileOK;
+int		colorID;
+int		pixelDepth;
+
+	CONSOLE_DEBUG_W_STR("Creating", filePath);
+	colorID		=	kSER_Mono;
+	pixelDepth	=	8;
+	switch(cROIinfo.currentROIimageType)
+	{
+		case kImageType_RGB24:
+			colorID		=	kSER_BGR;
+			break;
+
+		case kImageType_RAW16:
+			pixelDepth	=	16;
+			//*	fall through
+		case kImageType_RAW8:
+			if (cCameraProp.SensorType == kSensorType_RGGB)
+			{
+				//*	the bayer offset shifts which color the top left pixel is
+				switch(((cCameraProp.BayerOffsetY & 0x01) << 1) | (cCameraProp.BayerOffsetX & 0x01))
+				{
+					case 0:
+						colorID	=	kSER_BayerRGGB;
+						break;
+
+					case 1:
+						colorID	=	kSER_BayerGRBG;
+						break;
+
+					case 2:
+						colorID	=	kSER_BayerGBRG;
+						break;
+
+					case 3:
+						colorID	=	kSER_BayerBGGR;
+						break;
+				}
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	fileOK	=	SERfile_Create(	&cSERfile,
+								filePath,
+								cROIinfo.currentROIwidth,
+								cROIinfo.currentROIheight,
+								colorID,
+								pixelDepth,
+								gObseratorySettings.Observer,
+								cCommonProp.Name,
+								cTelescopeModel,
+								cNumFramesToSave);
+	if (fileOK == false)
+	{
+		CONSOLE_DEBUG_W_STR("Failed to create", filePath);
+	}
+	return(fileOK);
+}
+
+//*****************************************************************************
+//*	returns NULL if every frame is in the queue or being encoded
+//*****************************************************************************
+TYPE_VideoFrame	*CameraDriver::VideoPipeline_GetFreeFrame(void)
+{
+TYPE_VideoFrame	*videoFrame;
+
+	videoFrame	=	NULL;
+	pthread_mutex_lock(&cVideoMutex);
+	if (cVideoFreeCount > 0)
+	{
+		cVideoFreeCount--;
+		videoFrame	=	&cVideoFramePool[cVideoFreeList[cVideoFreeCount]];
+	}
+	pthread_mutex_unlock(&cVideoMutex);
+	return(videoFrame);
+}
+
+//*****************************************************************************
+void	CameraDriver::VideoPipeline_QueueFrame(TYPE_VideoFrame *videoFrame)
+{
+int		frameIdx;
+int		queueTail;
+
+	frameIdx	=	videoFrame - cVideoFramePool;
+
+	pthread_mutex_lock(&cVideoMutex);
+	cNumVideoFramesSaved++;
+	videoFrame->frameNumber		=	cNumVideoFramesSaved;
+
+	queueTail				=	(cVideoQueueHead + cVideoQueueCount) % kVideoFramePoolSize;
+	cVideoQueue[queueTail]	=	frameIdx;
+	cVideoQueueCount++;
+	if (cVideoQueueCount > cVideoQueueHighWater)
+	{
+		cVideoQueueHighWater	=	cVideoQueueCount;
+	}
+	pthread_cond_signal(&cVideoQueueNotEmpty);
+	pthread_mutex_unlock(&cVideoMutex);
+}
+
+//*****************************************************************************
+void	CameraDriver::VideoPipeline_ReturnFrame(TYPE_VideoFrame *videoFrame)
+{
+	pthread_mutex_lock(&cVideoMutex);
+	cVideoFreeList[cVideoFreeCount]	=	videoFrame - cVideoFramePool;
+	cVideoFreeCount++;
+	pthread_mutex_unlock(&cVideoMutex);
+}
+
+//*****************************************************************************
+void	CameraDriver::RunVideoEncoder(void)
+{
+int				frameIdx;
+struct timeval	startTime;
+struct timeval	endTime;
+uint32_t		encodeTime_us;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	while (true)
+	{
+		pthread_mutex_lock(&cVideoMutex);
+		while ((cVideoQueueCount == 0) && cVideoEncoderKeepRunning)
+		{
+			pthread_cond_wait(&cVideoQueueNotEmpty, &cVideoMutex);
+		}
+		if (cVideoQueueCount == 0)
+		{
+			//*	we have been told to stop and the queue is empty
+			pthread_mutex_unlock(&cVideoMutex);
+			break;
+		}
+		frameIdx		=	cVideoQueue[cVideoQueueHead];
+		cVideoQueueHead	=	(cVideoQueueHead + 1) % kVideoFramePoolSize;
+		cVideoQueueCount--;
+		pthread_mutex_unlock(&cVideoMutex);
+
+		gettimeofday(&startTime, NULL);
+		EncodeVideoFrame(&cVideoFramePool[frameIdx]);
+		gettimeofday(&endTime, NULL);
+
+		encodeTime_us	=	((endTime.tv_sec - startTime.tv_sec) * 1000000) + (endTime.tv_usec - startTime.tv_usec);
+
+		pthread_mutex_lock(&cVideoMutex);
+		cVideoFramesEncoded++;
+		cVideoEncodeLast_us		=	encodeTime_us;
+		cVideoEncodeTotal_us	+=	encodeTime_us;
+		if (encodeTime_us > cVideoEncodeMax_us)
+		{
+			cVideoEncodeMax_us	=	encodeTime_us;
+		}
+		cVideoFreeList[cVideoFreeCount]	=	frameIdx;
+		cVideoFreeCount++;
+		pthread_mutex_unlock(&cVideoMutex);
+	}
+	CONSOLE_DEBUG_W_NUM("Video encoder exiting, frames encoded\t=", cVideoFramesEncoded);
+}
+
+//*****************************************************************************
+//*	runs on the encoder thread, the frame buffer belongs to us until we return
+//*****************************************************************************
+void	CameraDriver::EncodeVideoFrame(TYPE_VideoFrame *videoFrame)
+{
+char		timeStampString[64];
+double		timeStampSecs;
+
+	FormatTimeStringISO8601(&videoFrame->timeStamp, timeStampString);
+
+	//*	this has to be before the openCV code, it changes RAW16 frames in place
+	if (cSERfile.fileDesc >= 0)
+	{
+		SERfile_AddFrame(&cSERfile, videoFrame->dataBuffer, &videoFrame->timeStamp);
+	}
+
+#ifdef _USE_OPENCV_
+	if (cOpenCV_videoWriter != NULL)
+	{
+	unsigned char	*pixelPtr;
+	long			pixelCount;
+	long			iii;
+	int				channelCnt;
+	char			overlayString[256];
+
+		pixelPtr	=	videoFrame->dataBuffer;
+		channelCnt	=	1;
+		switch(cVideoImageType)
+		{
+			case kImageType_RAW16:
+				//*	the video file is 8 bits, keep the high byte (done in place, the frame gets reused anyway)
+				pixelCount	=	(long)cVideoFrameWidth * cVideoFrameHeight;
+				for (iii=0; iii<pixelCount; iii++)
+				{
+					pixelPtr[iii]	=	pixelPtr[(iii * 2) + 1];
+				}
+				break;
+
+			case kImageType_RGB24:
+				channelCnt	=	3;
+				break;
+
+			default:
+				break;
+		}
+		sprintf(overlayString, "S-%s,%s", cObjectName, cAuxTextTag);
+
+	#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+		cv::Mat		videoImage(	cVideoFrameHeight,
+								cVideoFrameWidth,
+								((channelCnt == 3) ? CV_8UC3 : CV_8UC1),
+								pixelPtr);
+		cv::Scalar	overlayColor;
+		cv::Point	textPoint;
+
+		overlayColor	=	(channelCnt == 3) ? cVideoOverlayColor : cv::Scalar(255);
+
+		//*	first erase the text area
+		cv::rectangle(	videoImage,
+						cv::Point(0,				(videoImage.rows - kTextBoxHeight)),
+						cv::Point(videoImage.cols,	videoImage.rows),
+						cSideBarBlk,
+					#if (CV_MAJOR_VERSION >= 3)
+						cv::FILLED,
+					#else
+						CV_FILLED,
+					#endif
+						8,
+						0);
+
+		textPoint.x	=	5;
+		textPoint.y	=	videoImage.rows - 10;
+		cv::putText(videoImage, timeStampString, textPoint, cv::FONT_HERSHEY_DUPLEX, 1.0, overlayColor);
+
+		textPoint.x	=	videoImage.cols / 2;
+		cv::putText(videoImage, overlayString, textPoint, cv::FONT_HERSHEY_DUPLEX, 1.0, overlayColor);
+
+		cOpenCV_videoWriter->write(videoImage);
+	#else
+		IplImage	*videoImage;
+		CvPoint		textPoint;
+
+		videoImage	=	cvCreateImageHeader(cvSize(cVideoFrameWidth, cVideoFrameHeight), IPL_DEPTH_8U, channelCnt);
+		if (videoImage != NULL)
+		{
+			cvSetData(videoImage, pixelPtr, (cVideoFrameWidth * channelCnt));
+
+			//*	first erase the text area
+			cvRectangle(	videoImage,
+							cvPoint(0,					(videoImage->height - kTextBoxHeight)),
+							cvPoint(videoImage->width,	videoImage->height),
+							cSideBarBlk,
+							CV_FILLED,
+							8,
+							0);
+		#ifdef _ENABLE_CVFONT_
+			textPoint.x	=	5;
+			textPoint.y	=	videoImage->height - 10;
+			cvPutText(videoImage, timeStampString, textPoint, &cOverlayTextFont, cVideoOverlayColor);
+
+			textPoint.x	=	videoImage->width / 2;
+			cvPutText(videoImage, overlayString, textPoint, &cOverlayTextFont, cVideoOverlayColor);
+		#endif // _ENABLE_CVFONT_
+
+			cvWriteFrame(cOpenCV_videoWriter, videoImage);
+			cvReleaseImageHeader(&videoImage);
+		}
+	#endif
+	}
+#endif // _USE_OPENCV_
+
+	if (cVideoTimeStampFilePtr != NULL)
+	{
+		timeStampSecs	=	videoFrame->timeStamp.tv_sec;
+		timeStampSecs	+=	videoFrame->timeStamp.tv_usec / 1000000.0;
+
+		fprintf(cVideoTimeStampFilePtr, "%d,%s,%1.3f\r\n",	videoFrame->frameNumber,
+															timeStampString,
+															timeStampSecs);
+	}
+}
+
+//*****************************************************************************
+//*	called by the state machine while taking video, one sensor frame per call.
+//*	the camera is always read, if there is no free frame the data goes into
+//*	cVideoDropBuffer and is counted as dropped
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Take_Video(void)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode;
+TYPE_VideoFrame		*videoFrame;
+unsigned char		*captureBuffer;
+int					deltaSecs;
+bool				timeToStop;
+
+	alpacaErrCode	=	kASCOM_Err_Success;
+	if (cVideoEncoderRunning)
+	{
+		deltaSecs	=	0;
+		timeToStop	=	false;
+
+		videoFrame	=	VideoPipeline_GetFreeFrame();
+		if (videoFrame != NULL)
+		{
+			captureBuffer	=	videoFrame->dataBuffer;
+		}
+		else
+		{
+			captureBuffer	=	cVideoDropBuffer;
+		}
+
+		alpacaErrCode	=	Read_VideoFrame(captureBuffer, cVideoFrameSize);
+		if (alpacaErrCode == kASCOM_Err_Success)
+		{
+			gettimeofday(&cCameraProp.Lastexposure_EndTime, NULL);
+			if (videoFrame != NULL)
+			{
+				videoFrame->timeStamp			=	cCameraProp.Lastexposure_EndTime;
+				videoFrame->exposureDuration_us	=	cCurrentExposure_us;
+				VideoPipeline_QueueFrame(videoFrame);
+
+				if ((cNumVideoFramesSaved % 100) == 0)
+				{
+					CONSOLE_DEBUG_W_NUM("cNumVideoFramesSaved\t=", cNumVideoFramesSaved);
+				}
+				//*	Aug 11,	2020	<MLS> Added auto exposure to video output
+				if (cAutoAdjustExposure && ((cNumVideoFramesSaved % 10) == 0))
+				{
+					AutoAdjustExposure();
+				}
+			}
+			else
+			{
+				pthread_mutex_lock(&cVideoMutex);
+				cVideoFramesDropped++;
+				pthread_mutex_unlock(&cVideoMutex);
+			}
+
+			//*	calculate frames per sec
+			deltaSecs	=	cCameraProp.Lastexposure_EndTime.tv_sec - cCameraProp.Lastexposure_StartTime.tv_sec;
+			if (deltaSecs > 0)
+			{
+				cFrameRate	=	(cNumVideoFramesSaved * 1.0) / deltaSecs;
+			}
+		}
+		else
+		{
+			if (videoFrame != NULL)
+			{
+				VideoPipeline_ReturnFrame(videoFrame);
+			}
+			CONSOLE_DEBUG_W_NUM("Read_VideoFrame() returned\t=", alpacaErrCode);
+			if (alpacaErrCode == kASCOM_Err_NotImplemented)
+			{
+				timeToStop	=	true;
+			}
+		}
+
+		//*	do we have a limit on the number of frames
+		if ((cNumFramesToSave > 0) && (cNumVideoFramesSaved >= cNumFramesToSave))
+		{
+			timeToStop	=	true;
+		}
+		if ((cVideoDuration_secs > 0) && (deltaSecs >= cVideoDuration_secs))
+		{
+			timeToStop	=	true;
+		}
+		if (timeToStop)
+		{
+			CONSOLE_DEBUG("time to stop taking video");
+			Stop_Video();
+			VideoPipeline_Finish(true);
+		}
+	}
+	return(alpacaErrCode);
+}
+
+#endif // _ENABLE_CAMERA_
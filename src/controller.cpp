@@ -115,6 +115,10 @@
 //*	Mar 21,	2024	<MLS> Added DrawWidgetTextBox_MonoSpace()
 //*	Mar 26,	2024	<MLS> Added RunFastBackgroundTasks()
 //*	Mar 27,	2024	<MLS> Added SetRunFastBackgroundMode()
+//*	Oct 17,	2026	<MLS> readall and devicestate are now polled in the background by alpacapoll.c
+//*	Oct 17,	2026	<MLS> Added PostStatusRequests() and ProcessStatusReplies()
+//*	Oct 17,	2026	<MLS> ProcessStatusReplies() skips GetStatus_SubClass() while off line
+//*	Oct 17,	2026	<MLS> Added AlpacaSetOnLineState()
 //*****************************************************************************
 
 
@@ -443,6 +447,9 @@ char		myWindowName[128];
 	cDeviceStateNameStart		=	-1;
 	cDeviceStateValueStart		=	-1;
 	cDeviceStateStats			=	-1;
+	cDeviceStatePollStats		=	-1;
+	cPollHandle_ReadAll			=	-1;
+	cPollHandle_DeviceState		=	-1;
 
 	cRemote_Platform[0]			=	0;
 	cRemote_CPUinfo[0]			=	0;
@@ -653,6 +660,8 @@ int		iii;
 		usleep(500);
 	}
 #endif // _USE_BACKGROUND_THREAD_
+	AlpacaPoll_Unregister(cPollHandle_ReadAll);
+	AlpacaPoll_Unregister(cPollHandle_DeviceState);
 
 	CONSOLE_DEBUG_W_STR(__FUNCTION__, cWindowName);
 	//*	if we are the active window, make sure we dont get any more key presses
@@ -857,12 +866,14 @@ void	Controller::SetupWindowControls(void)
 void	Controller::SetDeviceStateTabInfo(	const int	tabNumber,
 											const int	nameStartWidgetIdx,
 											const int	valueStartWidgetIdx,
-											const int	statusWidgetIdx)
+											const int	statusWidgetIdx,
+											const int	pollStatsWidgetIdx)
 {
 	cDeviceStateTabNum		=	tabNumber;
 	cDeviceStateNameStart	=	nameStartWidgetIdx;
 	cDeviceStateValueStart	=	valueStartWidgetIdx;
 	cDeviceStateStats		=	statusWidgetIdx;
+	cDeviceStatePollStats	=	pollStatsWidgetIdx;
 }
 
 //*****************************************************************************
@@ -974,10 +985,8 @@ bool	Controller::AlpacaGetStatus_OneAAT(void)
 bool	Controller::AlpacaGetStatus(void)
 {
 bool	validData;
-bool	previousOnLineState;
 
 //	CONSOLE_DEBUG_W_STR(__FUNCTION__, cWindowName);
-	previousOnLineState	=   cOnLine;
 	if (cHas_readall)
 	{
 		validData	=	AlpacaGetStatus_ReadAll(cAlpacaDeviceTypeStr, cAlpacaDevNum);
@@ -988,6 +997,16 @@ bool	previousOnLineState;
 		validData	=	AlpacaGetStatus_OneAAT();	//*	One At A Time
 	}
 	GetStatus_SubClass();
+	AlpacaSetOnLineState(validData);
+	return(validData);
+}
+
+//*****************************************************************************
+void	Controller::AlpacaSetOnLineState(const bool validData)
+{
+bool	previousOnLineState;
+
+	previousOnLineState	=   cOnLine;
 	if (validData)
 	{
 		if (cOnLine == false)
@@ -1005,7 +1024,82 @@ bool	previousOnLineState;
 	{
 		UpdateOnlineStatus();
 	}
-	return(validData);
+}
+
+//*****************************************************************************
+//*	starts the background reads, the replies are handled by ProcessStatusReplies()
+//*	returns false if readall could not be posted because the last one is still going
+//*****************************************************************************
+bool	Controller::PostStatusRequests(void)
+{
+char	alpacaString[128];
+bool	readAllPosted;
+
+	readAllPosted	=	false;
+	if (cPollHandle_ReadAll < 0)
+	{
+		cPollHandle_ReadAll		=	AlpacaPoll_Register(&cDeviceAddress, cPort);
+		cPollHandle_DeviceState	=	AlpacaPoll_Register(&cDeviceAddress, cPort);
+	}
+	//*	does this device have "DeviceState"
+	if (cOnLine && cHas_DeviceState)
+	{
+		sprintf(alpacaString,	"/api/v1/%s/%d/devicestate", cAlpacaDeviceTypeStr, cAlpacaDevNum);
+		AlpacaPoll_PostRequest(cPollHandle_DeviceState, alpacaString, 0);
+	}
+	if (cHas_readall)
+	{
+		sprintf(alpacaString,	"/api/v1/%s/%d/readall", cAlpacaDeviceTypeStr, cAlpacaDevNum);
+		readAllPosted	=	AlpacaPoll_PostRequest(cPollHandle_ReadAll, alpacaString, 0);
+	}
+	return(readAllPosted);
+}
+
+//*****************************************************************************
+//*	called every time through RunBackgroundTasks(), never waits for anything
+//*****************************************************************************
+void	Controller::ProcessStatusReplies(void)
+{
+SJP_Parser_t			jsonParser;
+TYPE_AlpacaPollReply	*pollReply;
+bool					validData;
+
+	pollReply	=	AlpacaPoll_GetReply(cPollHandle_DeviceState);
+	if (pollReply != NULL)
+	{
+		if (pollReply->validData)
+		{
+			SJP_Init(&jsonParser);
+			SJP_ParseDataInPlace(&jsonParser, pollReply->replyData, pollReply->dataLen);
+			AlpacaProcessDeviceStateReply(&jsonParser, cAlpacaDeviceTypeStr, cAlpacaDevNum);
+		}
+		AlpacaPoll_ReleaseReply(cPollHandle_DeviceState, pollReply);
+		UpdatePollStatsEntry();
+	}
+
+	pollReply	=	AlpacaPoll_GetReply(cPollHandle_ReadAll);
+	if (pollReply != NULL)
+	{
+		validData	=	pollReply->validData;
+		if (validData)
+		{
+			SJP_Init(&jsonParser);
+			SJP_ParseDataInPlace(&jsonParser, pollReply->replyData, pollReply->dataLen);
+			AlpacaProcessReadAllReply(&jsonParser, cAlpacaDeviceTypeStr, cAlpacaDevNum);
+		}
+		AlpacaPoll_ReleaseReply(cPollHandle_ReadAll, pollReply);
+
+		//*	the same as AlpacaGetStatus() does after a readall, except that
+		//*	the sub class reads block, they are skipped while the device is off line
+		AlpacaSetOnLineState(validData);
+		if (cOnLine)
+		{
+			GetStatus_SubClass();
+		}
+		UpdateStatusData();
+		UpdateConnectedStatusIndicator();
+		UpdatePollStatsEntry();
+	}
 }
 #endif // _CONTROLLER_USES_ALPACA_
 
@@ -1070,12 +1164,15 @@ void	Controller::RunBackgroundTasks(const char *callingFunction, bool enableDebu
 uint32_t	deltaSeconds;
 bool		validData;
 bool		needToUpdate;
+bool		forceUpdate;
+bool		readAllPosted;
 uint32_t	currentMillis;
 
 	needToUpdate	=	false;
 	currentMillis	=	millis();
 	deltaSeconds	=	(currentMillis - cLastUpdate_milliSecs) / 1000;
 
+	forceUpdate		=	cForceAlpacaUpdate;
 	if ((deltaSeconds >= cUpdateDelta_secs) || cForceAlpacaUpdate)	//*	force update is set when a switch is clicked
 	{
 		needToUpdate		=	true;
@@ -1091,27 +1188,28 @@ uint32_t	currentMillis;
 		//*	is the IP address valid
 		if (cValidIPaddr)
 		{
-			//*	does this device have "DeviceState"
-			if (cOnLine && cHas_DeviceState)
+			//*	readall and devicestate are read in the background by alpacapoll.c,
+			//*	the replies are handled by ProcessStatusReplies()
+			readAllPosted	=	PostStatusRequests();
+			if ((cHas_readall == false) || (cPollHandle_ReadAll < 0))
 			{
-				validData	=	AlpacaGetStatus_DeviceState();
-			}
-//			else if (cAlpacaDeviceType != kDeviceType_Management)
-//			{
-//				CONSOLE_DEBUG_W_BOOL("cOnLine         \t=", cOnLine);
-//				CONSOLE_DEBUG_W_BOOL("cHas_DeviceState\t=", cHas_DeviceState);
-//				CONSOLE_DEBUG_W_BOOL("cValidIPaddr    \t=", cValidIPaddr);
-//			}
-			//----------------------------------
-			validData		=	AlpacaGetStatus();
+				//----------------------------------
+				//*	the one at a time reads are still done here
+				validData		=	AlpacaGetStatus();
 
-			if (validData == false)
+				if (validData == false)
+				{
+				//	CONSOLE_DEBUG("Failed to get data");
+				}
+//				CONSOLE_DEBUG("Calling UpdateStatusData()");
+				UpdateStatusData();
+				UpdateConnectedStatusIndicator();
+			}
+			else if ((readAllPosted == false) && forceUpdate)
 			{
-			//	CONSOLE_DEBUG("Failed to get data");
+				//*	the last readall has not finished yet, try again next time
+				cForceAlpacaUpdate	=	true;
 			}
-//			CONSOLE_DEBUG("Calling UpdateStatusData()");
-			UpdateStatusData();
-			UpdateConnectedStatusIndicator();
 		}
 		else
 		{
@@ -1124,6 +1222,7 @@ uint32_t	currentMillis;
 		}
 		cLastUpdate_milliSecs	=	millis();
 	}
+	ProcessStatusReplies();
 #endif // _CONTROLLER_USES_ALPACA_
 }
 
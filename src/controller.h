@@ -2,6 +2,7 @@
 //*****************************************************************************
 //*	Dec  7,	2022	<MLS> Changed kDefaultUpdateDelta from 4 to 5 (seconds)
 //*	Dec 20,	2022	<MLS> Added cHas_temperaturelog
+//*	Oct 17,	2026	<MLS> Added cPollHandle_ReadAll and cPollHandle_DeviceState for alpacapoll.c
 //*****************************************************************************
 
 //#include	"controller.h"
@@ -61,6 +62,10 @@
 #ifndef _ALPACA_HELPER_H_
 	#include	"alpacadriver_helper.h"
 #endif
+//-------------------------------------
+#ifndef _ALPACAPOLL_H_
+	#include	"alpacapoll.h"
+#endif
 
 
 #ifndef kMagicCookieValue
@@ -199,7 +204,8 @@ class Controller
 				void	SetDeviceStateTabInfo(	const int	tabNumber,
 												const int	nameStartWidgetIdx,
 												const int	valueStartWidgetIdx,
-												const int	statusWidgetIdx);
+												const int	statusWidgetIdx,
+												const int	pollStatsWidgetIdx);
 
 
 				void	DrawOneWidget(const int widgetIdx);
@@ -393,6 +399,11 @@ class Controller
 		int					cDeviceStateNameStart;
 		int					cDeviceStateValueStart;
 		int					cDeviceStateStats;
+		int					cDeviceStatePollStats;
+
+		//*	readall and devicestate are read in the background by alpacapoll.c
+		int					cPollHandle_ReadAll;
+		int					cPollHandle_DeviceState;
 
 		TYPE_CommonProperties	cCommonProp;
 
@@ -441,6 +452,10 @@ class Controller
 	private:
 				void	GetStartUpData(void);
 				bool	AlpacaGetStatus(void);
+				void	AlpacaSetOnLineState(const bool validData);
+				bool	PostStatusRequests(void);
+				void	ProcessStatusReplies(void);
+				void	UpdatePollStatsEntry(void);
 	public:
 				bool	AlpacaGetSupportedActions(		sockaddr_in	*deviceAddress,
 														int			devicePort,
@@ -476,6 +491,9 @@ class Controller
 														const char	*deviceTypeStr,
 														const int	deviceNum,
 														const bool	enableDebug=false);
+				void	AlpacaProcessDeviceStateReply(	SJP_Parser_t	*jsonParser,
+														const char		*deviceTypeStr,
+														const int		deviceNum);
 		virtual	void	UpdateDeviceStateEntry(const int index, const char *nameString, const char *valueString);
 
 				int		LookupCmdInCmdTable(const char *commandString, TYPE_CmdEntry *commandTable, TYPE_CmdEntry *alternateTable = NULL);
@@ -488,6 +506,9 @@ class Controller
 													const char	*deviceTypeStr,
 													const int	deviceNum,
 													const bool	enableDebug=false);
+				void	AlpacaProcessReadAllReply(	SJP_Parser_t	*jsonParser,
+													const char		*deviceTypeStr,
+													const int		deviceNum);
 
 
 		virtual	bool	AlpacaProcessReadAll(		const char	*deviceTypeStr,
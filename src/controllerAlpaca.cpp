@@ -58,6 +58,9 @@
 //*	Jul  1,	2023	<MLS> Added SetCommandLookupTable() with TYPE_CmdEntry
 //*	Jul  1,	2023	<MLS> Added LookupCmdInCmdTable()
 //*	Jul  1,	2023	<MLS> Added SetAlternateLookupTable()
+//*	Oct 17,	2026	<MLS> Split AlpacaProcessReadAllReply() out of AlpacaGetStatus_ReadAll()
+//*	Oct 17,	2026	<MLS> Split AlpacaProcessDeviceStateReply() out of AlpacaGetStatus_DeviceState()
+//*	Oct 17,	2026	<MLS> Added UpdatePollStatsEntry()
 //*****************************************************************************
 
 #ifdef _CONTROLLER_USES_ALPACA_
@@ -625,10 +628,6 @@ bool	Controller::AlpacaGetStatus_ReadAll(	sockaddr_in	*deviceAddress,
 SJP_Parser_t	jsonParser;
 bool			validData;
 char			alpacaString[128];
-int				jjj;
-bool			dataWasHandled	=	true;
-int				keywordEnum;
-int				notHandledCnt;
 
 #ifdef _DEBUG_READALL_
 	CONSOLE_DEBUG("-----------------------------------------------------------------");
@@ -649,104 +648,116 @@ int				notHandledCnt;
 		{
 			SJP_DumpJsonData(&jsonParser, __FUNCTION__);
 		}
-		cLastAlpacaErrNum	=	kASCOM_Err_Success;
+		AlpacaProcessReadAllReply(&jsonParser, deviceTypeStr, deviceNum);
+	}
+	return(validData);
+}
+
+//*****************************************************************************
+//*	the readall reply has been received and parsed, by AlpacaGetStatus_ReadAll()
+//*	or in the background by alpacapoll.c
+//*****************************************************************************
+void	Controller::AlpacaProcessReadAllReply(	SJP_Parser_t	*jsonParser,
+												const char		*deviceTypeStr,
+												const int		deviceNum)
+{
+int				jjj;
+bool			dataWasHandled	=	true;
+int				keywordEnum;
+int				notHandledCnt;
 
-		//----------------------------------------------------------------
-		//*	there are 2 ways of doing this, the 2nd way was added Jun 26,2023
-		//*	this new way looks up in pre-defined table the command
-		//*	and passes the enum value for the keyword instead of the keyword string.
-		//*	this makes the subclass readall parser easier to read
-		//*	each subclass should only implement ONE of these methods.
-		//*	however there is nothing stopping the subclass from doing the lookup itself
-		//----------------------------------------------------------------
+	cLastAlpacaErrNum	=	kASCOM_Err_Success;
+
+	//----------------------------------------------------------------
+	//*	there are 2 ways of doing this, the 2nd way was added Jun 26,2023
+	//*	this new way looks up in pre-defined table the command
+	//*	and passes the enum value for the keyword instead of the keyword string.
+	//*	this makes the subclass readall parser easier to read
+	//*	each subclass should only implement ONE of these methods.
+	//*	however there is nothing stopping the subclass from doing the lookup itself
+	//----------------------------------------------------------------
 //		SJP_DumpJsonData(&jsonParser, __FUNCTION__);
-		notHandledCnt	=	0;
-		for (jjj=0; jjj<jsonParser.tokenCount_Data; jjj++)
+	notHandledCnt	=	0;
+	for (jjj=0; jjj<jsonParser->tokenCount_Data; jjj++)
+	{
+		//*	check for valid string
+		if (strlen(jsonParser->dataList[jjj].keyword) > 0)
 		{
-			//*	check for valid string
-			if (strlen(jsonParser.dataList[jjj].keyword) > 0)
-			{
-				//*	special debugging
+			//*	special debugging
 //				if (cAlpacaDeviceType == kDeviceType_Telescope)
 //				{
 //					CONSOLE_DEBUG_W_2STR(	deviceTypeStr,
-//											jsonParser.dataList[jjj].keyword,
-//											jsonParser.dataList[jjj].valueString);
+//											jsonParser->dataList[jjj].keyword,
+//											jsonParser->dataList[jjj].valueString);
 //				}
-				dataWasHandled	=	false;
-				//-------------------------------------------------------------------------------------
-				//*	Look for the command in the COMMON command list AND the Extras list
-				keywordEnum		=	LookupCmdInCmdTable(jsonParser.dataList[jjj].keyword, gCommonCmdTable, gExtrasCmdTable);
+			dataWasHandled	=	false;
+			//-------------------------------------------------------------------------------------
+			//*	Look for the command in the COMMON command list AND the Extras list
+			keywordEnum		=	LookupCmdInCmdTable(jsonParser->dataList[jjj].keyword, gCommonCmdTable, gExtrasCmdTable);
+			if (keywordEnum >= 0)
+			{
+				dataWasHandled	=	AlpacaProcessReadAll_CommonIdx(	deviceTypeStr,
+																	deviceNum,
+																	keywordEnum,
+																	jsonParser->dataList[jjj].valueString);
+			}
+			else if (cCommandEntryPtr != NULL)
+			{
+				keywordEnum	=	LookupCmdInCmdTable(jsonParser->dataList[jjj].keyword, cCommandEntryPtr, cAlternateEntryPtr);
+			}
+
+			if (dataWasHandled == false)
+			{
 				if (keywordEnum >= 0)
 				{
-					dataWasHandled	=	AlpacaProcessReadAll_CommonIdx(	deviceTypeStr,
-																		deviceNum,
-																		keywordEnum,
-																		jsonParser.dataList[jjj].valueString);
+					dataWasHandled	=	AlpacaProcessReadAllIdx(deviceTypeStr,
+																deviceNum,
+																keywordEnum,
+																jsonParser->dataList[jjj].valueString);
+				}
+				else if (strncasecmp(jsonParser->dataList[jjj].keyword, "COMMENT", 7) == 0)
+				{
+					dataWasHandled	=	true;
 				}
-				else if (cCommandEntryPtr != NULL)
+				else if (strcasestr(jsonParser->dataList[jjj].keyword, "-STR") != NULL)
 				{
-					keywordEnum	=	LookupCmdInCmdTable(jsonParser.dataList[jjj].keyword, cCommandEntryPtr, cAlternateEntryPtr);
+					dataWasHandled	=	true;
 				}
 
+				//*	one last try
 				if (dataWasHandled == false)
 				{
-					if (keywordEnum >= 0)
-					{
-						dataWasHandled	=	AlpacaProcessReadAllIdx(deviceTypeStr,
-																	deviceNum,
-																	keywordEnum,
-																	jsonParser.dataList[jjj].valueString);
-					}
-					else if (strncasecmp(jsonParser.dataList[jjj].keyword, "COMMENT", 7) == 0)
-					{
-						dataWasHandled	=	true;
-					}
-					else if (strcasestr(jsonParser.dataList[jjj].keyword, "-STR") != NULL)
-					{
-						dataWasHandled	=	true;
-					}
-
-					//*	one last try
-					if (dataWasHandled == false)
-					{
-						dataWasHandled	=	AlpacaProcessReadAll(	deviceTypeStr,
-																	deviceNum,
-																	jsonParser.dataList[jjj].keyword,
-																	jsonParser.dataList[jjj].valueString);
-					}
-					if (dataWasHandled == false)
-					{
-						notHandledCnt++;
-					#ifdef _DEBUG_READALL_
-						CONSOLE_DEBUG_W_2STR(	"NOT HANDLED:",
-												jsonParser.dataList[jjj].keyword,
-												jsonParser.dataList[jjj].valueString);
-					#endif
-					}
+					dataWasHandled	=	AlpacaProcessReadAll(	deviceTypeStr,
+																deviceNum,
+																jsonParser->dataList[jjj].keyword,
+																jsonParser->dataList[jjj].valueString);
+				}
+				if (dataWasHandled == false)
+				{
+					notHandledCnt++;
+				#ifdef _DEBUG_READALL_
+					CONSOLE_DEBUG_W_2STR(	"NOT HANDLED:",
+											jsonParser->dataList[jjj].keyword,
+											jsonParser->dataList[jjj].valueString);
+				#endif
 				}
-//				CONSOLE_DEBUG_W_BOOL("dataWasHandled\t=",	dataWasHandled);
 			}
-			else
-			{
+//				CONSOLE_DEBUG_W_BOOL("dataWasHandled\t=",	dataWasHandled);
+		}
+		else
+		{
 //				//*	special debugging
 //				if (cAlpacaDeviceType == kDeviceType_Telescope)
 //				{
 //					CONSOLE_DEBUG_W_2STR(	deviceTypeStr,
-//											jsonParser.dataList[jjj].keyword,
-//											jsonParser.dataList[jjj].valueString);
+//											jsonParser->dataList[jjj].keyword,
+//											jsonParser->dataList[jjj].valueString);
 //				}
-			}
 		}
 	}
-	else
-	{
-		dataWasHandled	=	false;
-	}
 #ifdef _DEBUG_READALL_
 	CONSOLE_DEBUG_W_NUM("notHandledCnt\t=", notHandledCnt);
 #endif
-	return(validData);
 }
 
 //*****************************************************************************
@@ -2157,14 +2168,6 @@ bool	Controller::AlpacaGetStatus_DeviceState(	sockaddr_in	*deviceAddress,
 SJP_Parser_t	jsonParser;
 bool			validData;
 char			alpacaString[128];
-int				jjj;
-bool			foundName;
-bool			foundValue;
-char			nameString[64];
-char			valueString[128];
-int				valuePairIdx;
-int				keywordEnum;
-bool			dataWasHandled;
 
 //	CONSOLE_DEBUG(cWindowName);
 //	CONSOLE_DEBUG_W_STR("Requesting 'DeviceState' for", deviceTypeStr);
@@ -2182,74 +2185,94 @@ bool			dataWasHandled;
 										&jsonParser);
 	if (validData)
 	{
-		cDeviceStateReadCnt++;
 		if (enableDebug)
 		{
 			SJP_DumpJsonData(&jsonParser, __FUNCTION__);
 		}
-		foundName		=	false;
-		foundValue		=	false;
-		valuePairIdx	=	0;
-		cLastAlpacaErrNum	=	kASCOM_Err_Success;
-		for (jjj=0; jjj<jsonParser.tokenCount_Data; jjj++)
+		AlpacaProcessDeviceStateReply(&jsonParser, deviceTypeStr, deviceNum);
+	}
+	else
+	{
+		CONSOLE_DEBUG("GetJsonResponse failed")
+	}
+	return(validData);
+}
+
+//*****************************************************************************
+//*	the devicestate reply has been received and parsed, by AlpacaGetStatus_DeviceState()
+//*	or in the background by alpacapoll.c
+//*****************************************************************************
+void	Controller::AlpacaProcessDeviceStateReply(	SJP_Parser_t	*jsonParser,
+													const char		*deviceTypeStr,
+													const int		deviceNum)
+{
+int				jjj;
+bool			foundName;
+bool			foundValue;
+char			nameString[64];
+char			valueString[128];
+int				valuePairIdx;
+int				keywordEnum;
+bool			dataWasHandled;
+
+	cDeviceStateReadCnt++;
+	foundName		=	false;
+	foundValue		=	false;
+	valuePairIdx	=	0;
+	cLastAlpacaErrNum	=	kASCOM_Err_Success;
+	for (jjj=0; jjj<jsonParser->tokenCount_Data; jjj++)
+	{
+//			CONSOLE_DEBUG_W_STR(jsonParser->dataList[jjj].keyword, jsonParser->dataList[jjj].valueString);
+		if (strncasecmp(jsonParser->dataList[jjj].keyword, "ARRAY", 5) == 0)
 		{
-//			CONSOLE_DEBUG_W_STR(jsonParser.dataList[jjj].keyword, jsonParser.dataList[jjj].valueString);
-			if (strncasecmp(jsonParser.dataList[jjj].keyword, "ARRAY", 5) == 0)
-			{
-				foundName	=	false;
-				foundValue	=	false;
-			}
-			else if (strcasecmp(jsonParser.dataList[jjj].keyword, "NAME") == 0)
-			{
-				foundName	=	true;
-				strcpy(nameString, jsonParser.dataList[jjj].valueString);
-			}
-			else if (strcasecmp(jsonParser.dataList[jjj].keyword, "VALUE") == 0)
-			{
-				foundValue	=	true;
-				strcpy(valueString, jsonParser.dataList[jjj].valueString);
-			}
-			if (foundName && foundValue)
+			foundName	=	false;
+			foundValue	=	false;
+		}
+		else if (strcasecmp(jsonParser->dataList[jjj].keyword, "NAME") == 0)
+		{
+			foundName	=	true;
+			strcpy(nameString, jsonParser->dataList[jjj].valueString);
+		}
+		else if (strcasecmp(jsonParser->dataList[jjj].keyword, "VALUE") == 0)
+		{
+			foundValue	=	true;
+			strcpy(valueString, jsonParser->dataList[jjj].valueString);
+		}
+		if (foundName && foundValue)
+		{
+			//*	is the command table present
+			if (cCommandEntryPtr != NULL)
 			{
-				//*	is the command table present
-				if (cCommandEntryPtr != NULL)
+				keywordEnum	=	LookupCmdInCmdTable(jsonParser->dataList[jjj].keyword, cCommandEntryPtr);
+				if (keywordEnum >= 0)
 				{
-					keywordEnum	=	LookupCmdInCmdTable(jsonParser.dataList[jjj].keyword, cCommandEntryPtr);
-					if (keywordEnum >= 0)
+					dataWasHandled	=	AlpacaProcessReadAllIdx(deviceTypeStr,
+																deviceNum,
+																keywordEnum,
+																jsonParser->dataList[jjj].valueString);
+					if (dataWasHandled == false)
 					{
-						dataWasHandled	=	AlpacaProcessReadAllIdx(deviceTypeStr,
-																	deviceNum,
-																	keywordEnum,
-																	jsonParser.dataList[jjj].valueString);
-						if (dataWasHandled == false)
-						{
-							CONSOLE_DEBUG_W_STR("NOT HANDLED", jsonParser.dataList[jjj].keyword);
-						}
+						CONSOLE_DEBUG_W_STR("NOT HANDLED", jsonParser->dataList[jjj].keyword);
 					}
 				}
-				else
-				{
-	//				CONSOLE_DEBUG_W_STR(nameString, valueString);
-					AlpacaProcessReadAll(	deviceTypeStr,
-											deviceNum,
-											nameString,
-											valueString);
-
-				}
-				//*	this will allow the controller to update the DeviceState window if it wants to
-				UpdateDeviceStateEntry(valuePairIdx, nameString, valueString);
-				valuePairIdx++;
+			}
+			else
+			{
+//				CONSOLE_DEBUG_W_STR(nameString, valueString);
+				AlpacaProcessReadAll(	deviceTypeStr,
+										deviceNum,
+										nameString,
+										valueString);
 
-				foundName	=	false;
-				foundValue	=	false;
 			}
+			//*	this will allow the controller to update the DeviceState window if it wants to
+			UpdateDeviceStateEntry(valuePairIdx, nameString, valueString);
+			valuePairIdx++;
+
+			foundName	=	false;
+			foundValue	=	false;
 		}
 	}
-	else
-	{
-		CONSOLE_DEBUG("GetJsonResponse failed")
-	}
-	return(validData);
 }
 
 
@@ -2333,6 +2356,49 @@ char		textBuf[64];
 	}
 }
 
+//*****************************************************************************
+//*	latency and failure counts from alpacapoll.c for readall and devicestate together
+//*****************************************************************************
+void	Controller::UpdatePollStatsEntry(void)
+{
+TYPE_AlpacaPollStats	readAllStats;
+TYPE_AlpacaPollStats	devStateStats;
+uint32_t				requestCnt;
+uint32_t				failureCnt;
+uint32_t				goodCnt;
+uint32_t				avgLatency_ms;
+uint32_t				maxLatency_ms;
+char					textBuf[128];
+
+	if ((cDeviceStateTabNum > 0) && (cDeviceStatePollStats > 0))
+	{
+		AlpacaPoll_GetStats(cPollHandle_ReadAll,		&readAllStats);
+		AlpacaPoll_GetStats(cPollHandle_DeviceState,	&devStateStats);
+		requestCnt		=	readAllStats.RequestCnt + devStateStats.RequestCnt;
+		failureCnt		=	readAllStats.FailureCnt + devStateStats.FailureCnt;
+		goodCnt			=	requestCnt - failureCnt;
+		avgLatency_ms	=	0;
+		if (goodCnt > 0)
+		{
+			avgLatency_ms	=	((readAllStats.AvgLatency_ms * (readAllStats.RequestCnt - readAllStats.FailureCnt)) +
+								(devStateStats.AvgLatency_ms * (devStateStats.RequestCnt - devStateStats.FailureCnt))) / goodCnt;
+		}
+		maxLatency_ms	=	readAllStats.MaxLatency_ms;
+		if (devStateStats.MaxLatency_ms > maxLatency_ms)
+		{
+			maxLatency_ms	=	devStateStats.MaxLatency_ms;
+		}
+		sprintf(textBuf,	"Poll latency avg=%u ms, max=%u ms, failed %u of %u (%1.1f%%)",
+							avgLatency_ms,
+							maxLatency_ms,
+							failureCnt,
+							requestCnt,
+							((requestCnt > 0) ? ((100.0 * failureCnt) / requestCnt) : 0.0));
+		SetWidgetText(	cDeviceStateTabNum,	cDeviceStatePollStats,	textBuf);
+		SetWidgetValid(	cDeviceStateTabNum,	cDeviceStatePollStats,	true);
+	}
+}
+
 //*****************************************************************************
 void	JSON_ExtractKeyword_Value(const char *linebuf, char *keywordStr, char *valueStr)
 {
@@ -26,6 +26,9 @@
 //*	May 18,	2022	<MLS> Added AlpacaGetImageArray_Binary_Int32()
 //*	Feb 19,	2023	<MLS> Added AlpacaGetImageArray_Binary_Int16()
 //*	Feb 19,	2023	<MLS> Changed byte order in 32 bit integer image read
+//*	Oct 17,	2026	<MLS> Added AlpacaOpenImageBytes() & AlpacaReadImageBytes()
+//*	Oct 17,	2026	<MLS> ImageBytes now goes straight into the image, no TYPE_ImageArray
+//*	Oct 17,	2026	<MLS> AlpacaOpenImageBytes() keeps a JSON reply open, added AlpacaReadImageArray_JSON()
 //*****************************************************************************
 
 #include	<string.h>
@@ -1309,3 +1312,273 @@ int				ccc;
 	}
 	return(imgRank);
 }
+
+//*****************************************************************************
+static void	CloseImageSocket(const int socketDesc)
+{
+int		shutDownRetCode;
+int		closeRetCode;
+
+	shutDownRetCode	=	shutdown(socketDesc, SHUT_RDWR);
+	if (shutDownRetCode != 0)
+	{
+		CONSOLE_DEBUG_W_NUM("shutDownRetCode\t=", shutDownRetCode);
+		CONSOLE_DEBUG_W_NUM("errno\t=", errno);
+	}
+
+	closeRetCode	=	close(socketDesc);
+	if (closeRetCode != 0)
+	{
+		CONSOLE_DEBUG("Close error");
+	}
+}
+
+//*****************************************************************************
+//*	Sends the request and reads the http header.
+//*	Returns kImageOpen_ImageBytes if the server is sending ImageBytes, imageReader is then ready
+//*	and AlpacaReadImageBytes() must be called.
+//*	Returns kImageOpen_JSON if the server sent JSON, the connection is still open with the
+//*	start of the body in cReturnedData and AlpacaReadImageArray_JSON() must be called.
+//*	Returns kImageOpen_AlpacaErr if the server sent an ImageBytes error, it is in cBinaryImageHdr.
+//*	Anything else closes the connection and returns kImageOpen_Failed.
+//*****************************************************************************
+int	ControllerCamera::AlpacaOpenImageBytes(	const char				*alpacaDevice,
+											const int				alpacaDevNum,
+											const char				*alpacaCmd,
+											TYPE_ImageBytesReader	*imageReader)
+{
+char			alpacaString[128];
+char			linebuf[kReadBuffLen];
+char			theChar;
+bool			readingHttpHeader;
+bool			headerComplete;
+int				openStatus;
+int				ccc;
+int				readerRetCode;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+
+	openStatus				=	kImageOpen_Failed;
+	cImageArrayIndex		=	0;
+	tStartMillisecs			=	millis();
+	tLastUpdateMillisecs	=	tStartMillisecs;
+	memset(&cHttpHdrStruct, 0, sizeof(TYPE_HTTPheader));
+
+	sprintf(alpacaString,	"/api/v1/%s/%d/%s", alpacaDevice, alpacaDevNum, alpacaCmd);
+	strcpy(cLastAlpacaCmdString, alpacaString);
+
+	cSocket_desc	=	OpenSocketAndSendRequest(	&cDeviceAddress,
+													cPort,
+													"GET",
+													alpacaString,
+													"",
+													true);
+	if (cSocket_desc >= 0)
+	{
+		//*	the header lines end with cr/lf, the lf ends the line so a cr/lf
+		//*	split between two recv()'s does not look like the blank line
+		readingHttpHeader	=	true;
+		headerComplete		=	false;
+		cTotalBytesRead		=	0;
+		cSocketReadCnt		=	0;
+		cData_iii			=	0;
+		cRecvdByteCnt		=	0;
+		ccc					=	0;
+		while (readingHttpHeader)
+		{
+			cRecvdByteCnt	=	recv(cSocket_desc, cReturnedData, kReadBuffLen, 0);
+			if (cRecvdByteCnt > 0)
+			{
+				cSocketReadCnt++;
+				cTotalBytesRead					+=	cRecvdByteCnt;
+				cReturnedData[cRecvdByteCnt]	=	0;
+				cData_iii						=	0;
+				while (readingHttpHeader && (cData_iii < cRecvdByteCnt))
+				{
+					theChar	=	cReturnedData[cData_iii++];
+					if (theChar == 0x0a)
+					{
+						linebuf[ccc]	=	0;
+						if (ccc > 0)
+						{
+							ProcessHTTPheaderLine(linebuf, &cHttpHdrStruct);
+						}
+						else
+						{
+							readingHttpHeader	=	false;
+							headerComplete		=	true;
+						}
+						ccc	=	0;
+					}
+					else if ((theChar != 0x0d) && (ccc < (kReadBuffLen - 1)))
+					{
+						linebuf[ccc++]	=	theChar;
+					}
+				}
+			}
+			else
+			{
+				CONSOLE_DEBUG("Connection closed in the http header");
+				readingHttpHeader			=	false;
+			}
+		}
+
+		if (headerComplete && cHttpHdrStruct.dataIsBinary)
+		{
+			//*	whatever came after the http header is the start of the ImageBytes data
+			readerRetCode	=	ImageBytesReader_Start(	imageReader,
+														cSocket_desc,
+														&cReturnedData[cData_iii],
+														(cRecvdByteCnt - cData_iii));
+			cBinaryImageHdr	=	imageReader->imageHdr;
+			if (readerRetCode == kImageBytesReader_Done)
+			{
+				openStatus	=	kImageOpen_ImageBytes;
+			}
+			else if (readerRetCode == kImageBytesReader_Err_Alpaca)
+			{
+				CONSOLE_DEBUG_W_NUM("Server sent an error\t=", cBinaryImageHdr.ErrorNumber);
+				openStatus	=	kImageOpen_AlpacaErr;
+			}
+			else
+			{
+				CONSOLE_DEBUG_W_NUM("ImageBytesReader_Start() returned\t=", readerRetCode);
+				cReadFailureCnt++;
+			}
+		}
+		else if (headerComplete)
+		{
+			//*	the body has already been started, it gets parsed on this connection
+			CONSOLE_DEBUG("Data is JSON");
+			openStatus	=	kImageOpen_JSON;
+		}
+
+		if ((openStatus != kImageOpen_ImageBytes) && (openStatus != kImageOpen_JSON))
+		{
+			CloseImageSocket(cSocket_desc);
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG("Failed");
+		cReadFailureCnt++;
+	}
+	return(openStatus);
+}
+
+//*****************************************************************************
+//*	for a connection from AlpacaOpenImageBytes() that is not going to be read
+//*****************************************************************************
+void	ControllerCamera::AlpacaCloseImageSocket(void)
+{
+	CloseImageSocket(cSocket_desc);
+}
+
+//*****************************************************************************
+//*	The connection was opened by AlpacaOpenImageBytes() and the server sent JSON,
+//*	parses the rest of the reply into imageArray. Always closes the connection.
+//*	returns the RANK of the data found, 0 means no valid RANK
+//*****************************************************************************
+int	ControllerCamera::AlpacaReadImageArray_JSON(	TYPE_ImageArray	*imageArray,
+												int				imageArrayLen,
+												int				*actualValueCnt)
+{
+int				imgRank;
+double			downLoadSeconds;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+
+	cImgArrayType			=	-1;
+	cImageArrayIndex		=	0;
+	cFirstCharNotDigitCnt	=	0;
+	cValueFoundFlag			=	false;
+	cKeepReading			=	true;
+	cReadBinaryHeader		=	false;
+	cLinesProcessed			=	0;
+	cRanOutOfRoomCnt		=	0;
+
+	START_TIMING();
+	imgRank	=	AlpacaGetImageArray_JSON(imageArray, imageArrayLen, actualValueCnt);
+	DEBUG_TIMING("Time to download image (ms)");
+
+	//*	one last time to show we are done
+	UpdateDownloadProgress(cImageArrayIndex, imageArrayLen);
+	*actualValueCnt	=	cImageArrayIndex;
+	CONSOLE_DEBUG_W_NUM("actualValueCnt\t=", *actualValueCnt);
+
+	tDeltaMillisecs				=	millis() - tStartMillisecs;
+	cLastDownload_Bytes			=	cTotalBytesRead;
+	cLastDownload_Millisecs		=	tDeltaMillisecs;
+	downLoadSeconds				=	tDeltaMillisecs / 1000.0;
+	if (downLoadSeconds > 0)
+	{
+		cLastDownload_MegaBytesPerSec	=	1.0 * cTotalBytesRead / downLoadSeconds;
+	}
+	else
+	{
+		cLastDownload_MegaBytesPerSec	=	0.0;
+	}
+
+	CloseImageSocket(cSocket_desc);
+	return(imgRank);
+}
+
+//*****************************************************************************
+//*	Reads the rest of the image into dstImage (row major), a block of columns at a time.
+//*	Always closes the connection and frees the reader.
+//*	Returns the number of pixels stored, negative on error.
+//*****************************************************************************
+int	ControllerCamera::AlpacaReadImageBytes(	TYPE_ImageBytesReader	*imageReader,
+											unsigned char			*dstImage,
+											const size_t			dstRowStep,
+											const int				dstFormat)
+{
+int				pixelCount;
+int				readerRetCode;
+double			downLoadSeconds;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+
+	pixelCount	=	imageReader->width * imageReader->height;
+	START_TIMING();
+	do
+	{
+		readerRetCode	=	ImageBytesReader_ReadColumns(imageReader, dstImage, dstRowStep, dstFormat);
+
+		//*	the progress bar counts pixels
+		cImageArrayIndex	=	imageReader->columnsDone * imageReader->height;
+		UpdateImageProgressBar(pixelCount);
+	} while (readerRetCode > 0);
+	DEBUG_TIMING("Time to download and store image (ms)");
+
+	//*	one last time to show we are done
+	UpdateDownloadProgress(cImageArrayIndex, pixelCount);
+
+	if (readerRetCode == kImageBytesReader_Done)
+	{
+		readerRetCode	=	cImageArrayIndex;
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_NUM("ImageBytesReader_ReadColumns() returned\t=", readerRetCode);
+		cReadFailureCnt++;
+	}
+
+	tDeltaMillisecs				=	millis() - tStartMillisecs;
+	cTotalBytesRead				=	imageReader->totalBytesRead;
+	cLastDownload_Bytes			=	cTotalBytesRead;
+	cLastDownload_Millisecs		=	tDeltaMillisecs;
+	downLoadSeconds				=	tDeltaMillisecs / 1000.0;
+	if (downLoadSeconds > 0)
+	{
+		cLastDownload_MegaBytesPerSec	=	1.0 * cTotalBytesRead / downLoadSeconds;
+	}
+	else
+	{
+		cLastDownload_MegaBytesPerSec	=	0.0;
+	}
+
+	ImageBytesReader_Free(imageReader);
+	CloseImageSocket(cSocket_desc);
+	return(readerRetCode);
+}
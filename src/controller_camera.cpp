@@ -73,6 +73,8 @@
 //*	Jun 25,	2023	<ADD> Add readoutmode to DeviceState
 //*	Jun 25,	2023	<ADD> Add startx and starty to DeviceState
 //*	Jul  1,	2023	<MLS> Added GetStatus_SubClass() to camera controller
+//*	Oct 17,	2026	<MLS> Added DownloadImage_ImageBytes(), binary images no longer use TYPE_ImageArray
+//*	Oct 17,	2026	<MLS> A JSON imagearray reply is parsed as is, an ImageBytes error is reported, no second download
 //*****************************************************************************
 //*	Jan  1,	2121	<TODO> control key for different step size.
 //*	Jan  1,	2121	<TODO> add error list window
@@ -1982,6 +1984,52 @@ int			pixIdx;
 #endif // _USE_OPENCV_CPP_
 
 #if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+//*****************************************************************************
+//*	ImageBytes is received a block at a time and stored straight into the image,
+//*	openStatus is what AlpacaOpenImageBytes() found, see kImageOpen_xxx
+//*****************************************************************************
+cv::Mat	*ControllerCamera::DownloadImage_ImageBytes(const bool force8BitRead, int *openStatus)
+{
+cv::Mat					*myOpenCVimage	=	NULL;
+TYPE_ImageBytesReader	imageReader;
+int						dstFormat;
+int						pixelsRead;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	*openStatus	=	AlpacaOpenImageBytes("camera", cAlpacaDevNum, "imagearray", &imageReader);
+	if (*openStatus == kImageOpen_ImageBytes)
+	{
+		//*	same image types as the TYPE_ImageArray version
+		if ((cBinaryImageHdr.ImageElementType == kAlpacaImageData_Int16) ||
+			(cBinaryImageHdr.ImageElementType == kAlpacaImageData_UInt16))
+		{
+			dstFormat		=	kImageBytesReader_Gray16;
+			myOpenCVimage	=	new cv::Mat(	cBinaryImageHdr.Dimension2,	//*	Note, Height is FIRST
+												cBinaryImageHdr.Dimension1,
+												CV_16UC1);
+		}
+		else
+		{
+			dstFormat		=	force8BitRead ? kImageBytesReader_BGR24_Low8 : kImageBytesReader_BGR24;
+			myOpenCVimage	=	new cv::Mat(	cBinaryImageHdr.Dimension2,	//*	Note, Height is FIRST
+												cBinaryImageHdr.Dimension1,
+												CV_8UC3);
+		}
+
+		pixelsRead	=	AlpacaReadImageBytes(	&imageReader,
+												myOpenCVimage->data,
+												myOpenCVimage->step[0],
+												dstFormat);
+		CONSOLE_DEBUG_W_NUM("pixelsRead\t\t=",	pixelsRead);
+		if (pixelsRead <= 0)
+		{
+			delete myOpenCVimage;
+			myOpenCVimage	=	NULL;
+		}
+	}
+	return(myOpenCVimage);
+}
+
 //*****************************************************************************
 cv::Mat	*ControllerCamera::DownloadImage_imagearray(const bool force8BitRead, const bool allowBinary)
 {
@@ -1999,6 +2047,8 @@ TYPE_ImageArray	*imageArray;
 int				buffSize;
 int				imageDataLen;
 int				imageWidthStep;
+int				openStatus;
+char			errorMsg[128];
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	CONSOLE_DEBUG_W_NUM(	"cCameraProp.CameraXsize\t=",	cCameraProp.CameraXsize);
@@ -2016,9 +2066,28 @@ int				imageWidthStep;
 //	cBinaryImageHdr.Dimension2				=	cCameraProp.CameraYsize;
 //	cBinaryImageHdr.Dimension3				=	0;
 
+	//*	ImageBytes does not need the TYPE_ImageArray (12 bytes per pixel)
+	//*	if the server answers with JSON, that reply is parsed, the image is not asked for again
+	openStatus	=	kImageOpen_Failed;
+	if (allowBinary)
+	{
+		myOpenCVimage	=	DownloadImage_ImageBytes(force8BitRead, &openStatus);
+	}
+
 	imageArray		=	NULL;
 	pixelCount		=	cCameraProp.CameraXsize * cCameraProp.CameraYsize;
-	if (pixelCount > 0)
+	if (openStatus == kImageOpen_ImageBytes)
+	{
+		CONSOLE_DEBUG("Image was downloaded as ImageBytes");
+	}
+	else if (openStatus == kImageOpen_AlpacaErr)
+	{
+		cLastAlpacaErrNum	=	(TYPE_ASCOM_STATUS)cBinaryImageHdr.ErrorNumber;
+		sprintf(errorMsg, "imagearray failed, Alpaca error %d", cBinaryImageHdr.ErrorNumber);
+		CONSOLE_DEBUG(errorMsg);
+		AlpacaDisplayErrorMessage(errorMsg);
+	}
+	else if (pixelCount > 0)
 	{
 		CONSOLE_DEBUG_W_NUM("pixelCount\t=", pixelCount);
 		buffSize	=	(pixelCount + 100) * sizeof(TYPE_ImageArray);
@@ -2028,16 +2097,23 @@ int				imageWidthStep;
 		{
 			memset(imageArray, 0, buffSize);
 			valuesRead	=	0;
-			CONSOLE_DEBUG("Calling AlpacaGetImageArray()");
 			SETUP_TIMING();
-			imgRank	=	AlpacaGetImageArray(	"camera",
-												cAlpacaDevNum,
-												"imagearray",
-												"",
-												allowBinary,
-												imageArray,
-												pixelCount,
-												&valuesRead);
+			if (openStatus == kImageOpen_JSON)
+			{
+				imgRank	=	AlpacaReadImageArray_JSON(imageArray, pixelCount, &valuesRead);
+			}
+			else
+			{
+				CONSOLE_DEBUG("Calling AlpacaGetImageArray()");
+				imgRank	=	AlpacaGetImageArray(	"camera",
+													cAlpacaDevNum,
+													"imagearray",
+													"",
+													allowBinary,
+													imageArray,
+													pixelCount,
+													&valuesRead);
+			}
 
 			DEBUG_TIMING("Image downloading (ms)");
 			CONSOLE_DEBUG_W_NUM("imgRank\t\t=",		imgRank);
@@ -2144,6 +2220,12 @@ int				imageWidthStep;
 	{
 		CONSOLE_DEBUG("Image size is not known");
 	}
+
+	//*	the JSON reply was not read, it is still open
+	if ((openStatus == kImageOpen_JSON) && (imageArray == NULL))
+	{
+		AlpacaCloseImageSocket();
+	}
 	return(myOpenCVimage);
 }
 #else
@@ -24,6 +24,10 @@
 	#include	"camera_defs.h"
 #endif
 
+#ifndef _IMAGEBYTESREADER_H_
+	#include	"imagebytesreader.h"
+#endif
+
 
 //**************************************************************************************
 typedef struct
@@ -49,6 +53,16 @@ typedef struct
 } TYPE_HTTPheader;
 
 
+//*****************************************************************************
+//*	what AlpacaOpenImageBytes() found
+enum
+{
+	kImageOpen_Failed	=	0,		//*	no connection, no reply or ImageBytes we can not decode
+	kImageOpen_ImageBytes,			//*	call AlpacaReadImageBytes()
+	kImageOpen_JSON,				//*	call AlpacaReadImageArray_JSON(), the connection is still open
+	kImageOpen_AlpacaErr			//*	the server sent an error, see cBinaryImageHdr.ErrorNumber
+};
+
 #define	kMaxRemoteFileCnt		200
 #define	kMaxTemperatureValues	(450)
 #define	kObjectNameMaxLen		31
@@ -172,6 +186,7 @@ class ControllerCamera: public Controller
 			#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
 				cv::Mat		*DownloadImage_rgbarray(void);
 				cv::Mat		*DownloadImage_imagearray(const bool force8BitRead, const bool allowBinary);
+				cv::Mat		*DownloadImage_ImageBytes(const bool force8BitRead, int *openStatus);
 				cv::Mat		*DownloadImage(const bool force8BitRead,  const bool allowBinary);
 			#else
 				IplImage	*DownloadImage_rgbarray(void);
@@ -249,6 +264,20 @@ class ControllerCamera: public Controller
 															int				arrayLength,
 															int				*actualValueCnt);
 
+				//*	ImageBytes straight into the image, no TYPE_ImageArray
+				int		AlpacaOpenImageBytes(	const char				*alpacaDevice,
+												const int				alpacaDevNum,
+												const char				*alpacaCmd,
+												TYPE_ImageBytesReader	*imageReader);
+				int		AlpacaReadImageArray_JSON(	TYPE_ImageArray	*imageArray,
+													int				arrayLength,
+													int				*actualValueCnt);
+				void	AlpacaCloseImageSocket(void);
+				int		AlpacaReadImageBytes(	TYPE_ImageBytesReader	*imageReader,
+												unsigned char			*dstImage,
+												const size_t			dstRowStep,
+												const int				dstFormat);
+
 				void	UpdateImageProgressBar(int maxArrayLength);
 
 				//*	these variables are ONLY for image download
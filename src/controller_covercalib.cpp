@@ -157,7 +157,7 @@ void	ControllerCoverCalib::SetupWindowControls(void)
 	{
 		SetTabWindow(kTab_DeviceState,	cDeviceStateTabObjPtr);
 		cDeviceStateTabObjPtr->SetParentObjectPtr(this);
-		SetDeviceStateTabInfo(kTab_DeviceState, kDeviceState_FirstBoxName, kDeviceState_FirstBoxValue, kDeviceState_Stats);
+		SetDeviceStateTabInfo(kTab_DeviceState, kDeviceState_FirstBoxName, kDeviceState_FirstBoxValue, kDeviceState_Stats, kDeviceState_PollStats);
 	}
 
 	//--------------------------------------------
@@ -213,7 +213,7 @@ char	lineBuff[64];
 		SetTabWindow(kTab_DeviceState,	cDeviceStateTabObjPtr);
 		cDeviceStateTabObjPtr->SetParentObjectPtr(this);
 		cDeviceStateTabObjPtr->SetAlpacaDeviceType(cAlpacaDeviceTypeStr);
-		SetDeviceStateTabInfo(kTab_DeviceState, kDeviceState_FirstBoxName, kDeviceState_FirstBoxValue, kDeviceState_Stats);
+		SetDeviceStateTabInfo(kTab_DeviceState, kDeviceState_FirstBoxName, kDeviceState_FirstBoxValue, kDeviceState_Stats, kDeviceState_PollStats);
 	}
 
 	//=============================================================
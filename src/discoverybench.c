@@ -0,0 +1,409 @@
+//*****************************************************************************
+//*
+//*	Name:			discoverybench.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Times the discovery thread unit queries, one at a time against discoveryfanout.c
+//*
+//*	Usage notes:	Starts a number of fake alpaca units on loopback ports. Each one answers
+//*					configureddevices, libraries and cpustats after a delay, and optionally
+//*					there is one unit that never answers at all, in the middle of the list the
+//*					way it would be in the list sorted by IP address.
+//*					The old way is what PollAllDevices() did, GetJsonResponse() for each url,
+//*					one unit after another. The new way is DiscoveryFanout_Run(), it is run
+//*					once for each in flight limit so the scaling can be seen.
+//*					"live done" is when the last unit that does answer has been heard from,
+//*					"pass done" is when the whole pass returned.
+//*					Every reply is checked to be from the unit and url it was sent to.
+//*
+//*		discoverybench -n 32 -d 20
+//*
+//*		-n	number of units (default 32)
+//*		-d	delay in milliseconds before each reply (default 20)
+//*		-t	deadline per unit in milliseconds (default kFanout_HostDeadline_ms)
+//*		-x	do not include the unit that never answers
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created discoverybench.c
+//*	Oct 17,	2026	<MLS> Loopback units moved to benchresponder.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<strings.h>
+#include	<unistd.h>
+#include	<time.h>
+#include	<errno.h>
+#include	<pthread.h>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<arpa/inet.h>
+#include	<netinet/in.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"json_parse.h"
+#include	"sendrequest_lib.h"
+#include	"alpacapoll.h"
+#include	"discoveryfanout.h"
+#include	"benchresponder.h"
+
+char	gUserAgentAlpacaPiStr[80]	=	"User-Agent: AlpacaPi discoverybench\r\n";
+
+#define	kMaxBenchUnits		128
+#define	kBenchUrlCnt		3
+
+static const char	*gBenchUrls[kBenchUrlCnt]	=
+{
+	"/management/v1/configureddevices",
+	"/api/v1/management/0/libraries",
+	"/api/v1/management/0/cpustats"
+};
+
+static const char	*gBenchQueryNames[kBenchUrlCnt]	=
+{
+	"configureddevices",
+	"libraries",
+	"cpustats"
+};
+
+static const int	gInFlightList[]	=	{1, 2, 4, 8, kFanout_MaxInFlight};
+
+//*****************************************************************************
+typedef struct
+{
+	TYPE_BenchResponder	responder;
+	int					answeredCnt;
+} TYPE_BenchUnit;
+
+static TYPE_BenchUnit	gUnits[kMaxBenchUnits];
+static TYPE_FanoutHost	gFanoutHostList[kMaxBenchUnits];
+static int				gUnitCnt			=	32;
+static int				gReplyDelay_ms		=	20;
+static int				gDeadline_ms		=	kFanout_HostDeadline_ms;
+static bool				gIncludeHungUnit	=	true;
+
+//*	used by the fan out reply proc
+static uint64_t			gPassStartTime;
+static uint64_t			gLiveDone_uS;
+static int				gFanoutErrCnt;
+
+//*****************************************************************************
+static uint64_t	GetMicroSecs(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(((uint64_t)timeSpec.tv_sec * 1000000) + (timeSpec.tv_nsec / 1000));
+}
+
+//*****************************************************************************
+//*	tags the reply with the unit number and which of the urls was asked for
+//*****************************************************************************
+static void	Unit_ReplyProc(TYPE_BenchResponder *responder, const char *requestBuff, char *bodyBuff, const size_t bodyBuffLen)
+{
+const char	*queryName;
+int			iii;
+
+	queryName	=	"unknown";
+	for (iii=0; iii<kBenchUrlCnt; iii++)
+	{
+		if (strstr(requestBuff, gBenchUrls[iii]) != NULL)
+		{
+			queryName	=	gBenchQueryNames[iii];
+		}
+	}
+	snprintf(bodyBuff, bodyBuffLen,	"{\"ErrorNumber\":0,\"ErrorMessage\":\"\",\"unitnum\":%d,\"query\":\"%s\"}",
+									responder->responderNum,
+									queryName);
+}
+
+//*****************************************************************************
+static bool	CheckReply(SJP_Parser_t *jsonParser, const int unitNum, const int urlIdx)
+{
+int		jjj;
+bool	unitOK;
+bool	queryOK;
+
+	unitOK	=	false;
+	queryOK	=	false;
+	for (jjj=0; jjj<jsonParser->tokenCount_Data; jjj++)
+	{
+		if (strcasecmp(jsonParser->dataList[jjj].keyword, "unitnum") == 0)
+		{
+			unitOK	=	(atoi(jsonParser->dataList[jjj].valueString) == unitNum);
+		}
+		else if (strcasecmp(jsonParser->dataList[jjj].keyword, "query") == 0)
+		{
+			queryOK	=	(strcmp(jsonParser->dataList[jjj].valueString, gBenchQueryNames[urlIdx]) == 0);
+		}
+	}
+	return(unitOK && queryOK);
+}
+
+//*****************************************************************************
+//*	one unit after another, the way PollAllDevices() did it
+//*****************************************************************************
+static uint64_t	RunPass_OneAtATime(int *errorCnt, uint64_t *passDone_uS)
+{
+SJP_Parser_t	jsonParser;
+uint64_t		startTime;
+uint64_t		liveDone_uS;
+int				iii;
+int				urlIdx;
+bool			validData;
+
+	liveDone_uS	=	0;
+	startTime	=	GetMicroSecs();
+	for (iii=0; iii<gUnitCnt; iii++)
+	{
+		for (urlIdx=0; urlIdx<kBenchUrlCnt; urlIdx++)
+		{
+			SJP_Init(&jsonParser);
+			validData	=	GetJsonResponse(&gUnits[iii].responder.deviceAddress, gUnits[iii].responder.port, gBenchUrls[urlIdx], NULL, &jsonParser);
+			if (gUnits[iii].responder.neverAnswers == false)
+			{
+				if ((validData == false) || (CheckReply(&jsonParser, gUnits[iii].responder.responderNum, urlIdx) == false))
+				{
+					(*errorCnt)++;
+				}
+				liveDone_uS	=	GetMicroSecs() - startTime;
+			}
+		}
+	}
+	*passDone_uS	=	GetMicroSecs() - startTime;
+	return(liveDone_uS);
+}
+
+//*****************************************************************************
+static void	Fanout_ReplyProc(TYPE_FanoutHost *fanoutHost, const int urlIdx, TYPE_AlpacaPollReply *pollReply)
+{
+TYPE_BenchUnit	*unit;
+SJP_Parser_t	jsonParser;
+bool			replyOK;
+
+	unit	=	(TYPE_BenchUnit *)fanoutHost->userData;
+	if (unit->responder.neverAnswers == false)
+	{
+		replyOK	=	false;
+		if ((pollReply != NULL) && pollReply->validData && (pollReply->httpStatus == 200) &&
+			(pollReply->requestTag == fanoutHost->urlTag[urlIdx]))
+		{
+			SJP_Init(&jsonParser);
+			SJP_ParseDataInPlace(&jsonParser, pollReply->replyData, pollReply->dataLen);
+			replyOK	=	CheckReply(&jsonParser, unit->responder.responderNum, fanoutHost->urlTag[urlIdx]);
+		}
+		if (replyOK)
+		{
+			unit->answeredCnt++;
+		}
+		else
+		{
+			gFanoutErrCnt++;
+		}
+		gLiveDone_uS	=	GetMicroSecs() - gPassStartTime;
+	}
+	else if ((pollReply != NULL) && pollReply->validData)
+	{
+		//*	the unit that never answers can only be reported as timed out or not answered
+		gFanoutErrCnt++;
+	}
+}
+
+//*****************************************************************************
+static uint64_t	RunPass_Fanout(const int maxInFlight, int *errorCnt, uint64_t *passDone_uS)
+{
+int		iii;
+int		urlIdx;
+
+	for (iii=0; iii<gUnitCnt; iii++)
+	{
+		gUnits[iii].answeredCnt	=	0;
+		DiscoveryFanout_InitHost(&gFanoutHostList[iii], &gUnits[iii].responder.deviceAddress, gUnits[iii].responder.port, &gUnits[iii]);
+		for (urlIdx=0; urlIdx<kBenchUrlCnt; urlIdx++)
+		{
+			DiscoveryFanout_AddUrl(&gFanoutHostList[iii], gBenchUrls[urlIdx], urlIdx);
+		}
+	}
+	gFanoutErrCnt	=	0;
+	gLiveDone_uS	=	0;
+	gPassStartTime	=	GetMicroSecs();
+	DiscoveryFanout_Run(gFanoutHostList, gUnitCnt, maxInFlight, gDeadline_ms, Fanout_ReplyProc);
+	*passDone_uS	=	GetMicroSecs() - gPassStartTime;
+
+	for (iii=0; iii<gUnitCnt; iii++)
+	{
+		if ((gUnits[iii].responder.neverAnswers == false) && (gUnits[iii].answeredCnt != kBenchUrlCnt))
+		{
+			printf("unit %d answered %d of %d\n", gUnits[iii].responder.responderNum, gUnits[iii].answeredCnt, kBenchUrlCnt);
+		}
+	}
+	*errorCnt	+=	gFanoutErrCnt;
+	return(gLiveDone_uS);
+}
+
+//*****************************************************************************
+static void	PrintHelp(const char *appName)
+{
+	printf("usage: %s [options]\n", appName);
+	printf("\t-n <count>       number of units (default 32, max %d)\n", kMaxBenchUnits - 1);
+	printf("\t-d <millisecs>   delay before each reply (default 20)\n");
+	printf("\t-t <millisecs>   deadline per unit (default %d)\n", kFanout_HostDeadline_ms);
+	printf("\t-x               do not include the unit that never answers\n");
+}
+
+//*****************************************************************************
+static bool	ProcessCmdLineArgs(int argc, char **argv)
+{
+int			ii;
+char		theChar;
+const char	*argValue;
+
+	ii	=	1;
+	while (ii < argc)
+	{
+		if ((argv[ii][0] == '-') && (argv[ii][1] != 0))
+		{
+			theChar		=	argv[ii][1];
+			argValue	=	NULL;
+			if ((theChar == 'x') || (theChar == 'h'))
+			{
+				//*	no value
+			}
+			else if (argv[ii][2] != 0)
+			{
+				argValue	=	&argv[ii][2];
+			}
+			else if ((ii + 1) < argc)
+			{
+				ii++;
+				argValue	=	argv[ii];
+			}
+			switch(theChar)
+			{
+				case 'n':
+				case 'd':
+				case 't':
+					if (argValue == NULL)
+					{
+						printf("Option -%c needs a value\n", theChar);
+						return(false);
+					}
+					if (theChar == 'n')
+					{
+						gUnitCnt		=	atoi(argValue);
+					}
+					else if (theChar == 'd')
+					{
+						gReplyDelay_ms	=	atoi(argValue);
+					}
+					else
+					{
+						gDeadline_ms	=	atoi(argValue);
+					}
+					break;
+
+				case 'x':
+					gIncludeHungUnit	=	false;
+					break;
+
+				case 'h':
+				default:
+					PrintHelp(argv[0]);
+					return(false);
+			}
+		}
+		else
+		{
+			PrintHelp(argv[0]);
+			return(false);
+		}
+		ii++;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+uint64_t	liveDone_uS;
+uint64_t	passDone_uS;
+int			oneAtATimeErrCnt;
+int			fanoutErrCnt;
+int			hungUnitIdx;
+int			liveUnitCnt;
+int			iii;
+
+	if (ProcessCmdLineArgs(argc, argv) == false)
+	{
+		return(1);
+	}
+	if ((gUnitCnt <= 0) || (gUnitCnt >= kMaxBenchUnits) || (gReplyDelay_ms < 0) || (gDeadline_ms <= 0))
+	{
+		PrintHelp(argv[0]);
+		return(1);
+	}
+
+	liveUnitCnt	=	gUnitCnt;
+	hungUnitIdx	=	-1;
+	if (gIncludeHungUnit)
+	{
+		hungUnitIdx	=	gUnitCnt / 2;
+		gUnitCnt++;
+	}
+	for (iii=0; iii<gUnitCnt; iii++)
+	{
+		if (BenchResponder_Start(&gUnits[iii].responder, iii, (iii == hungUnitIdx), gReplyDelay_ms, Unit_ReplyProc) == false)
+		{
+			printf("Failed to start loopback unit %d\n", iii);
+			return(1);
+		}
+	}
+
+	printf("%d units, %d urls each, %d ms reply delay, %d ms deadline per unit%s\n",
+											liveUnitCnt,
+											kBenchUrlCnt,
+											gReplyDelay_ms,
+											gDeadline_ms,
+											(gIncludeHungUnit ? ", plus one that never answers" : ""));
+	printf("%-16s %14s %14s\n", "method", "live done ms", "pass done ms");
+
+	oneAtATimeErrCnt	=	0;
+	liveDone_uS			=	RunPass_OneAtATime(&oneAtATimeErrCnt, &passDone_uS);
+	printf("%-16s %14.1f %14.1f\n", "one at a time", (liveDone_uS / 1000.0), (passDone_uS / 1000.0));
+
+	fanoutErrCnt	=	0;
+	for (iii=0; iii<(int)(sizeof(gInFlightList) / sizeof(int)); iii++)
+	{
+	char	methodName[32];
+
+		liveDone_uS	=	RunPass_Fanout(gInFlightList[iii], &fanoutErrCnt, &passDone_uS);
+		sprintf(methodName, "fanout %d", gInFlightList[iii]);
+		printf("%-16s %14.1f %14.1f\n", methodName, (liveDone_uS / 1000.0), (passDone_uS / 1000.0));
+	}
+
+	printf("\nErrors: one at a time %d, fanout %d\n", oneAtATimeErrCnt, fanoutErrCnt);
+	printf("%s\n", ((oneAtATimeErrCnt == 0) && (fanoutErrCnt == 0)) ? "All replies matched" : "FAILED");
+	return(((oneAtATimeErrCnt == 0) && (fanoutErrCnt == 0)) ? 0 : 1);
+}
@@ -0,0 +1,277 @@
+//*****************************************************************************
+//*
+//*	Name:			discoveryfanout.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Sends the discovery thread queries to many hosts at once
+//*
+//*	Usage notes:	The discovery thread used to ask each unit for configureddevices,
+//*					libraries and cpustats with GetJsonResponse(), one unit after another,
+//*					each with a 5 second time out. With a lot of units, or a few that were
+//*					off line, one pass could take minutes.
+//*
+//*					This hands the requests to the alpacapoll engine instead. Up to maxInFlight
+//*					hosts are in progress at the same time, each on its own poll handle, the
+//*					urls for one host go out one after the other on the same connection.
+//*					Each host has a deadline for all of its urls together, when it runs out
+//*					the handle is dropped and the next host is started.
+//*
+//*					The replies are handed to replyProc on the calling thread, so whatever
+//*					replyProc updates does not need any locking.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created discoveryfanout.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<time.h>
+#include	<netinet/in.h>
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"alpacapoll.h"
+#include	"discoveryfanout.h"
+
+#define	kMaxFanoutWait_ms	250
+
+//*****************************************************************************
+static uint32_t	GetMilliSecs(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return((currentTime.tv_sec * 1000) + (currentTime.tv_nsec / 1000000));
+}
+
+//*****************************************************************************
+void	DiscoveryFanout_InitHost(TYPE_FanoutHost *fanoutHost, struct sockaddr_in *deviceAddress, const int port, void *userData)
+{
+	memset(fanoutHost, 0, sizeof(TYPE_FanoutHost));
+	fanoutHost->deviceAddress	=	*deviceAddress;
+	fanoutHost->port			=	port;
+	fanoutHost->userData		=	userData;
+	fanoutHost->pollHandle		=	-1;
+}
+
+//*****************************************************************************
+bool	DiscoveryFanout_AddUrl(TYPE_FanoutHost *fanoutHost, const char *urlString, const int urlTag)
+{
+bool	addedOK;
+
+	addedOK	=	false;
+	if ((fanoutHost->urlCnt < kFanout_MaxUrlsPerHost) && (strlen(urlString) < kAlpacaPoll_MaxUrlLen))
+	{
+		strcpy(fanoutHost->urlList[fanoutHost->urlCnt], urlString);
+		fanoutHost->urlTag[fanoutHost->urlCnt]	=	urlTag;
+		fanoutHost->urlCnt++;
+		addedOK	=	true;
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_STR("Url not added\t=", urlString);
+	}
+	return(addedOK);
+}
+
+//*****************************************************************************
+//*	tells replyProc about the urls that were not answered and gives the handle back
+//*****************************************************************************
+static void	Fanout_FinishHost(TYPE_FanoutHost *fanoutHost, FanoutReplyProc replyProc)
+{
+	while (fanoutHost->nextUrlIdx < fanoutHost->urlCnt)
+	{
+		replyProc(fanoutHost, fanoutHost->nextUrlIdx, NULL);
+		fanoutHost->nextUrlIdx++;
+	}
+	if (fanoutHost->pollHandle >= 0)
+	{
+		AlpacaPoll_Unregister(fanoutHost->pollHandle);
+		fanoutHost->pollHandle	=	-1;
+	}
+	fanoutHost->finished	=	true;
+}
+
+//*****************************************************************************
+//*	returns false if there was no poll handle available, nothing has been reported in that case
+//*****************************************************************************
+static bool	Fanout_StartHost(TYPE_FanoutHost *fanoutHost, FanoutReplyProc replyProc)
+{
+bool	registeredOK;
+
+	registeredOK				=	false;
+	fanoutHost->nextUrlIdx		=	0;
+	fanoutHost->finished		=	false;
+	fanoutHost->deadlineExpired	=	false;
+	fanoutHost->startTime_ms	=	GetMilliSecs();
+	fanoutHost->pollHandle		=	AlpacaPoll_Register(&fanoutHost->deviceAddress, fanoutHost->port);
+	if (fanoutHost->pollHandle >= 0)
+	{
+		registeredOK	=	true;
+		if (AlpacaPoll_PostRequest(fanoutHost->pollHandle, fanoutHost->urlList[0], fanoutHost->urlTag[0]) == false)
+		{
+			Fanout_FinishHost(fanoutHost, replyProc);
+		}
+	}
+	return(registeredOK);
+}
+
+//*****************************************************************************
+//*	returns true if anything happened
+//*****************************************************************************
+static bool	Fanout_CheckHost(TYPE_FanoutHost *fanoutHost, FanoutReplyProc replyProc, const uint32_t hostDeadline_ms, int *answeredCnt)
+{
+TYPE_AlpacaPollReply	*pollReply;
+bool					hostAnswered;
+bool					somethingHappened;
+
+	somethingHappened	=	false;
+	pollReply			=	AlpacaPoll_GetReply(fanoutHost->pollHandle);
+	if (pollReply != NULL)
+	{
+		somethingHappened	=	true;
+		hostAnswered		=	pollReply->validData;
+		if (hostAnswered)
+		{
+			*answeredCnt	+=	1;
+		}
+		replyProc(fanoutHost, fanoutHost->nextUrlIdx, pollReply);
+		AlpacaPoll_ReleaseReply(fanoutHost->pollHandle, pollReply);
+		fanoutHost->nextUrlIdx++;
+
+		if (hostAnswered && (fanoutHost->nextUrlIdx < fanoutHost->urlCnt))
+		{
+			if (AlpacaPoll_PostRequest(	fanoutHost->pollHandle,
+										fanoutHost->urlList[fanoutHost->nextUrlIdx],
+										fanoutHost->urlTag[fanoutHost->nextUrlIdx]) == false)
+			{
+				Fanout_FinishHost(fanoutHost, replyProc);
+			}
+		}
+		else
+		{
+			Fanout_FinishHost(fanoutHost, replyProc);
+		}
+	}
+	else if ((GetMilliSecs() - fanoutHost->startTime_ms) >= hostDeadline_ms)
+	{
+		somethingHappened			=	true;
+		fanoutHost->deadlineExpired	=	true;
+		Fanout_FinishHost(fanoutHost, replyProc);
+	}
+	return(somethingHappened);
+}
+
+//*****************************************************************************
+int	DiscoveryFanout_Run(	TYPE_FanoutHost		*hostList,
+							const int			hostCnt,
+							const int			maxInFlight,
+							const uint32_t		hostDeadline_ms,
+							FanoutReplyProc		replyProc)
+{
+int			nextHostIdx;
+int			firstActiveIdx;
+int			activeCnt;
+int			answeredCnt;
+int			iii;
+bool		slotsAvailable;
+bool		somethingHappened;
+uint32_t	replySequence;
+uint32_t	elapsed_ms;
+int			wait_ms;
+
+	nextHostIdx		=	0;
+	firstActiveIdx	=	0;
+	activeCnt		=	0;
+	answeredCnt		=	0;
+	replySequence	=	0;
+	while ((nextHostIdx < hostCnt) || (activeCnt > 0))
+	{
+		//*	start as many hosts as we are allowed to
+		slotsAvailable	=	true;
+		while (slotsAvailable && (nextHostIdx < hostCnt) && (activeCnt < maxInFlight))
+		{
+			if (hostList[nextHostIdx].urlCnt <= 0)
+			{
+				hostList[nextHostIdx].pollHandle	=	-1;
+				hostList[nextHostIdx].finished		=	true;
+				nextHostIdx++;
+			}
+			else if (Fanout_StartHost(&hostList[nextHostIdx], replyProc))
+			{
+				if (hostList[nextHostIdx].finished == false)
+				{
+					activeCnt++;
+				}
+				nextHostIdx++;
+			}
+			else if (activeCnt > 0)
+			{
+				//*	the poll engine is full, try this one again when one of ours is done
+				slotsAvailable	=	false;
+			}
+			else
+			{
+				Fanout_FinishHost(&hostList[nextHostIdx], replyProc);
+				nextHostIdx++;
+			}
+		}
+
+		//*	see what came back
+		somethingHappened	=	false;
+		wait_ms				=	kMaxFanoutWait_ms;
+		for (iii=firstActiveIdx; iii<nextHostIdx; iii++)
+		{
+			if (hostList[iii].finished == false)
+			{
+				if (Fanout_CheckHost(&hostList[iii], replyProc, hostDeadline_ms, &answeredCnt))
+				{
+					somethingHappened	=	true;
+				}
+				if (hostList[iii].finished)
+				{
+					activeCnt--;
+				}
+				else
+				{
+					elapsed_ms	=	GetMilliSecs() - hostList[iii].startTime_ms;
+					if ((elapsed_ms < hostDeadline_ms) && ((int)(hostDeadline_ms - elapsed_ms) < wait_ms))
+					{
+						wait_ms	=	hostDeadline_ms - elapsed_ms;
+					}
+				}
+			}
+			if ((iii == firstActiveIdx) && hostList[iii].finished)
+			{
+				firstActiveIdx++;
+			}
+		}
+
+		if ((somethingHappened == false) && (activeCnt > 0))
+		{
+			AlpacaPoll_WaitForReply(&replySequence, (wait_ms + 1));
+		}
+	}
+	return(answeredCnt);
+}
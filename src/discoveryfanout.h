@@ -0,0 +1,76 @@
+//**************************************************************************
+//*	Name:			discoveryfanout.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Sends the discovery thread queries to many hosts at once
+//*
+//*****************************************************************************
+//#include	"discoveryfanout.h"
+
+#ifndef _DISCOVERYFANOUT_H_
+#define	_DISCOVERYFANOUT_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#include	<netinet/in.h>
+
+#ifndef _ALPACAPOLL_H_
+	#include	"alpacapoll.h"
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kFanout_MaxUrlsPerHost		4
+#define	kFanout_MaxInFlight			16
+#define	kFanout_HostDeadline_ms		5000
+
+//*****************************************************************************
+//*	one host and the urls to ask it for, the urls are sent one after the other
+//*	on the same connection, in the order they are listed
+typedef struct
+{
+	struct sockaddr_in	deviceAddress;
+	int					port;
+	int					urlCnt;
+	char				urlList[kFanout_MaxUrlsPerHost][kAlpacaPoll_MaxUrlLen];
+	int					urlTag[kFanout_MaxUrlsPerHost];
+	void				*userData;
+	int					userValue;
+
+	//*	used by DiscoveryFanout_Run()
+	int					pollHandle;
+	int					nextUrlIdx;
+	uint32_t			startTime_ms;
+	bool				finished;
+	bool				deadlineExpired;
+} TYPE_FanoutHost;
+
+//*	called on the thread that called DiscoveryFanout_Run(), one call for every url in the list.
+//*	pollReply is NULL if the url was never sent or the host ran out of time,
+//*	once a host fails to answer, the rest of its urls are not sent.
+typedef void (*FanoutReplyProc)(TYPE_FanoutHost *fanoutHost, const int urlIdx, TYPE_AlpacaPollReply *pollReply);
+
+void	DiscoveryFanout_InitHost(TYPE_FanoutHost *fanoutHost, struct sockaddr_in *deviceAddress, const int port, void *userData);
+bool	DiscoveryFanout_AddUrl(TYPE_FanoutHost *fanoutHost, const char *urlString, const int urlTag);
+
+//*	returns when every host is finished, the return value is the number of urls that were answered
+int		DiscoveryFanout_Run(	TYPE_FanoutHost		*hostList,
+								const int			hostCnt,
+								const int			maxInFlight,
+								const uint32_t		hostDeadline_ms,
+								FanoutReplyProc		replyProc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_DISCOVERYFANOUT_H_
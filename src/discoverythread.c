@@ -34,6 +34,9 @@
 //*	Dec 22,	2022	<MLS> Added WakeUpDiscoveryThread()
 //*	Feb 10,	2024	<MLS> Added GetLibraryInfo()
 //*	May 15,	2024	<MLS> Added _DEBUG_DISCOVERY_
+//*	Oct 17,	2026	<MLS> PollAllDevices() & GetInformationFromOtherDevices() now use discoveryfanout
+//*	Oct 17,	2026	<MLS> Added hashed indexes for gAlpacaUnitList & gRemoteList
+//*	Oct 17,	2026	<MLS> Removed GetJsonResponse(), the replies now come from alpacapoll
 //*****************************************************************************
 
 //#define		_DEBUG_DISCOVERY_
@@ -68,6 +71,8 @@
 #include	"discoverythread.h"
 #include	"discovery_lib.h"
 #include	"sendrequest_lib.h"
+#include	"alpacapoll.h"
+#include	"discoveryfanout.h"
 #include	"linuxerrors.h"
 #include	"helper_functions.h"
 
@@ -104,6 +109,21 @@ bool				gDiscoveryThreadIsRunning	=	false;
 bool				gDiscoveryThreadKeepRunning	=	true;
 bool				gDiscoveryWakeUp			=	false;
 
+//*	hashed indexes into gAlpacaUnitList and gRemoteList.
+//*	An entry is the list index + 1, 0 is an empty entry, collisions go to the next entry.
+//*	Entries are never removed, the unit table is rebuilt when the sorted list is changed.
+#define	kUnitHashSize		256
+#define	kRemoteHashSize		512
+#if ((kMaxAlpacaIPaddrCnt * 2) > kUnitHashSize) || ((kMaxAlpacaDeviceCnt * 2) > kRemoteHashSize)
+	#error "The discovery hash tables must be at least twice the size of the lists"
+#endif
+static	int16_t		gUnitHashTable[kUnitHashSize];
+static	int16_t		gRemoteHashTable[kRemoteHashSize];
+
+//*	only used by the discovery query thread
+#define	kFanoutHostListSize	((kMaxAlpacaDeviceCnt > kMaxAlpacaIPaddrCnt) ? kMaxAlpacaDeviceCnt : kMaxAlpacaIPaddrCnt)
+static	TYPE_FanoutHost	gFanoutHostList[kFanoutHostListSize];
+
 static	int			gBroadcastSock;
 static	uint32_t	gMyIPaddress		=	0;
 static	int			gAlpacaListenPort	=	9999;
@@ -192,6 +212,8 @@ int	iii;
 	{
 		memset((void *)&gRemoteList[iii], 0, sizeof(TYPE_REMOTE_DEV));
 	}
+	memset((void *)gUnitHashTable,		0, sizeof(gUnitHashTable));
+	memset((void *)gRemoteHashTable,	0, sizeof(gRemoteHashTable));
 	ResetExternalIPaddress();
 
 	gAlpacaUnitCnt	=	0;
@@ -324,6 +346,134 @@ char				errnoString[128];
 	return(NULL);
 }
 
+//*****************************************************************************
+//*	FNV-1a
+//*****************************************************************************
+#define	kFNV_OffsetBasis	2166136261U
+#define	kFNV_Prime			16777619U
+
+static uint32_t	HashBytes(uint32_t hashValue, const void *dataPtr, const size_t byteCnt)
+{
+const uint8_t	*bytePtr;
+size_t			iii;
+
+	bytePtr	=	(const uint8_t *)dataPtr;
+	for (iii=0; iii<byteCnt; iii++)
+	{
+		hashValue	^=	bytePtr[iii];
+		hashValue	*=	kFNV_Prime;
+	}
+	return(hashValue);
+}
+
+//*****************************************************************************
+static uint32_t	UnitHashKey(const uint32_t ipAddress, const int port)
+{
+uint32_t	hashValue;
+
+	hashValue	=	HashBytes(kFNV_OffsetBasis,	&ipAddress,	sizeof(ipAddress));
+	hashValue	=	HashBytes(hashValue,		&port,		sizeof(port));
+	return(hashValue);
+}
+
+//*****************************************************************************
+//*	returns the index into gAlpacaUnitList, -1 if not found
+//*****************************************************************************
+static int	FindUnitIndex(struct sockaddr_in *deviceAddress, const int port)
+{
+uint32_t	hashIdx;
+int			unitIdx;
+int			foundIndex;
+
+	foundIndex	=	-1;
+	hashIdx		=	UnitHashKey(deviceAddress->sin_addr.s_addr, port) & (kUnitHashSize - 1);
+	while ((foundIndex < 0) && (gUnitHashTable[hashIdx] != 0))
+	{
+		unitIdx	=	gUnitHashTable[hashIdx] - 1;
+		if (	(deviceAddress->sin_addr.s_addr	==	gAlpacaUnitList[unitIdx].deviceAddress.sin_addr.s_addr)
+			&&	(port							==	gAlpacaUnitList[unitIdx].port))
+		{
+			foundIndex	=	unitIdx;
+		}
+		hashIdx	=	(hashIdx + 1) & (kUnitHashSize - 1);
+	}
+	return(foundIndex);
+}
+
+//*****************************************************************************
+static void	RebuildUnitHashTable(void)
+{
+uint32_t	hashIdx;
+int			iii;
+
+	memset((void *)gUnitHashTable, 0, sizeof(gUnitHashTable));
+	for (iii=0; iii<gAlpacaUnitCnt; iii++)
+	{
+		hashIdx	=	UnitHashKey(gAlpacaUnitList[iii].deviceAddress.sin_addr.s_addr,
+								gAlpacaUnitList[iii].port) & (kUnitHashSize - 1);
+		while (gUnitHashTable[hashIdx] != 0)
+		{
+			hashIdx	=	(hashIdx + 1) & (kUnitHashSize - 1);
+		}
+		gUnitHashTable[hashIdx]	=	iii + 1;
+	}
+}
+
+//*****************************************************************************
+//*	the same fields that UpdateRemoteList() has always used to match a device
+//*****************************************************************************
+static uint32_t	RemoteHashKey(TYPE_REMOTE_DEV *remoteDevice)
+{
+uint32_t	hashValue;
+
+	hashValue	=	UnitHashKey(remoteDevice->deviceAddress.sin_addr.s_addr, remoteDevice->port);
+	hashValue	=	HashBytes(hashValue, &remoteDevice->alpacaDeviceNum,	sizeof(remoteDevice->alpacaDeviceNum));
+	hashValue	=	HashBytes(hashValue, remoteDevice->deviceTypeStr,		strlen(remoteDevice->deviceTypeStr));
+	hashValue	=	HashBytes(hashValue, remoteDevice->deviceNameStr,		strlen(remoteDevice->deviceNameStr));
+	return(hashValue);
+}
+
+//*****************************************************************************
+//*	returns the index into gRemoteList, -1 if not found
+//*****************************************************************************
+static int	FindRemoteIndex(TYPE_REMOTE_DEV *remoteDevice)
+{
+uint32_t	hashIdx;
+int			remoteIdx;
+int			foundIndex;
+
+	foundIndex	=	-1;
+	hashIdx		=	RemoteHashKey(remoteDevice) & (kRemoteHashSize - 1);
+	while ((foundIndex < 0) && (gRemoteHashTable[hashIdx] != 0))
+	{
+		remoteIdx	=	gRemoteHashTable[hashIdx] - 1;
+		if (	(remoteDevice->deviceAddress.sin_addr.s_addr	==	gRemoteList[remoteIdx].deviceAddress.sin_addr.s_addr)
+			&&	(remoteDevice->port 							==	gRemoteList[remoteIdx].port)
+			&&	(remoteDevice->alpacaDeviceNum					==	gRemoteList[remoteIdx].alpacaDeviceNum)
+			&&	(strcmp(remoteDevice->deviceTypeStr,			gRemoteList[remoteIdx].deviceTypeStr) == 0)
+			&&	(strcmp(remoteDevice->deviceNameStr,			gRemoteList[remoteIdx].deviceNameStr) == 0)
+			)
+		{
+			foundIndex	=	remoteIdx;
+		}
+		hashIdx	=	(hashIdx + 1) & (kRemoteHashSize - 1);
+	}
+	return(foundIndex);
+}
+
+//*****************************************************************************
+static void	AddRemoteToHashTable(const int remoteIdx)
+{
+uint32_t	hashIdx;
+
+	hashIdx	=	RemoteHashKey(&gRemoteList[remoteIdx]) & (kRemoteHashSize - 1);
+	while (gRemoteHashTable[hashIdx] != 0)
+	{
+		hashIdx	=	(hashIdx + 1) & (kRemoteHashSize - 1);
+	}
+	gRemoteHashTable[hashIdx]	=	remoteIdx + 1;
+}
+
 //*****************************************************************************
 static void	BumpNotSeenCounter(void)
 {
@@ -340,37 +490,25 @@ int	iii;
 //*****************************************************************************
 static void	UpdateRemoteList(TYPE_REMOTE_DEV *newRemoteDevice)
 {
-int		iii;
-bool	newDevice;
+int		remoteIdx;
 
 #ifdef _DEBUG_DISCOVERY_
 	CONSOLE_DEBUG(__FUNCTION__);
 #endif
-	newDevice	=	true;
-
 	//*	look to see if it is already in the list
-	for (iii=0; iii<gRemoteCnt; iii++)
+	remoteIdx	=	FindRemoteIndex(newRemoteDevice);
+	if (remoteIdx >= 0)
 	{
-		if (	(newRemoteDevice->deviceAddress.sin_addr.s_addr ==	gRemoteList[iii].deviceAddress.sin_addr.s_addr)
-			&&	(newRemoteDevice->port 							==	gRemoteList[iii].port)
-			&&	(newRemoteDevice->alpacaDeviceNum				==	gRemoteList[iii].alpacaDeviceNum)
-			&&	(strcmp(newRemoteDevice->deviceTypeStr,			gRemoteList[iii].deviceTypeStr) == 0)
-			&&	(strcmp(newRemoteDevice->deviceNameStr,			gRemoteList[iii].deviceNameStr) == 0)
-			)
-		{
-			gRemoteList[iii].notSeenCounter	=	0;
-			newDevice						=	false;
-			break;
-		}
+		gRemoteList[remoteIdx].notSeenCounter	=	0;
 	}
-
-	if (newDevice)
+	else
 	{
 		if (gRemoteCnt < kMaxAlpacaDeviceCnt)
 		{
 			gRemoteList[gRemoteCnt]					=	*newRemoteDevice;
 			gRemoteList[gRemoteCnt].notSeenCounter	=	0;
 			gRemoteList[gRemoteCnt].deviceTypeEnum	=	FindDeviceTypeByString(gRemoteList[gRemoteCnt].deviceTypeStr);
+			AddRemoteToHashTable(gRemoteCnt);
 
 			//*	lookup the host name
 
@@ -548,118 +686,25 @@ int					setOptRetCode;
 }
 
 //*****************************************************************************
-static bool	GetJsonResponse(	struct sockaddr_in	*deviceAddress,
-								const int			port,
-								const char			*sendData,
-								SJP_Parser_t		*jsonParser)
+//*	the reply is the complete http reply, the parser skips over the header
+//*****************************************************************************
+static bool	ParseFanoutReply(TYPE_AlpacaPollReply *pollReply, SJP_Parser_t *jsonParser)
 {
-bool				validData;
-int					socket_desc;
-struct sockaddr_in	remoteDev;
-int					connRetCode;
-int					sendRetCode;
-int					closeRetCode;
-int					shutdownRetCode;
-int					recvByteCnt;
-char				returnedData[kReadBuffLen];
-char				xmitBuffer[kReadBuffLen];
-int					setOptRetCode;
-char				errorString[64];
-
-#ifdef _DEBUG_DISCOVERY_
-	CONSOLE_DEBUG(__FUNCTION__);
-	CONSOLE_DEBUG_W_NUM(	"kReadBuffLen        \t=",	kReadBuffLen);
-	CONSOLE_DEBUG_W_SIZE(	"sizeof(returnedData)\t=",	sizeof(returnedData));
-#endif
+bool	validData;
 
 	validData	=	false;
-	socket_desc	=	socket(AF_INET , SOCK_STREAM , 0);
-	if (socket_desc >= 0)
+	if ((pollReply != NULL) && pollReply->validData)
 	{
-		//*	Mar 13,	2021	<MLS> Added timeout to GetJsonResponse()
-		//*	Jun 25,	2023	<MLS> Increased GetJsonResponse() to 5 seconds (was 3)
-		//*	set a timeout
-		setOptRetCode	=	SetSocketTimeouts(socket_desc, 5);
-		if (setOptRetCode != 0)
-		{
-			CONSOLE_DEBUG("SetSocketTimeouts() returned error");
-		}
-
-		remoteDev.sin_addr.s_addr	=	deviceAddress->sin_addr.s_addr;
-		remoteDev.sin_family		=	AF_INET;
-		remoteDev.sin_port			=	htons(port);
-		//*	Connect to remote device
-		connRetCode	=	connect(socket_desc , (struct sockaddr *)&remoteDev , sizeof(remoteDev));
-		if (connRetCode >= 0)
-		{
-			strcpy(xmitBuffer, "GET ");
-			strcat(xmitBuffer, sendData);
-
-			strcat(xmitBuffer, " HTTP/1.0\r\n");
-			strcat(xmitBuffer, "Host: 127.0.0.1:6800\r\n");
-//			strcat(xmitBuffer, "User-Agent: AlpacaPi\r\n");
-			strcat(xmitBuffer,	gUserAgentAlpacaPiStr);
-			strcat(xmitBuffer, "Accept: text/html,application/json\r\n");
-			strcat(xmitBuffer, "\r\n");
-
-			sendRetCode	=	send(socket_desc , xmitBuffer , strlen(xmitBuffer) , 0);
-			if (sendRetCode >= 0)
-			{
-				recvByteCnt	=	recv(socket_desc, returnedData, kReadBuffLen , 0);
-				if (recvByteCnt >= 0)
-				{
-					validData					=	true;
-					returnedData[recvByteCnt]	=	0;
-//					printf("%s\r\n", returnedData);
-					SJP_Init(jsonParser);
-					SJP_ParseData(jsonParser, returnedData);
-//					SJP_DumpJsonData(jsonParser);
-				}
-			}
-			else
-			{
-				CONSOLE_DEBUG_W_NUM("send() error", errno);
-			}
-			shutdownRetCode	=	shutdown(socket_desc, SHUT_RDWR);
-			if (shutdownRetCode != 0)
-			{
-			//	CONSOLE_DEBUG_W_NUM("shutdown() error", errno);
-				GetLinuxErrorString(errno, errorString);
-				CONSOLE_DEBUG_W_STR("shutdown() error: Error message\t\t=",	errorString);
-			}
-		}
-		else if (errno == ECONNREFUSED)
-		{
-		char	ipString[32];
-
-			PrintIPaddressToString(deviceAddress->sin_addr.s_addr, ipString);
-			sprintf(errorString, "connect refused by %s:%d", ipString, port);
-			CONSOLE_DEBUG(errorString);
-		}
-		else
-		{
-
-		//	CONSOLE_DEBUG("connect error");
-		//	CONSOLE_DEBUG_W_NUM("errno\t=", errno);
-			GetLinuxErrorString(errno, errorString);
-			CONSOLE_DEBUG_W_STR("Connect error: ErrMsg=",	errorString);
-		}
-		//*	Moved 2/4/2021
-		closeRetCode	=	close(socket_desc);
-		if (closeRetCode != 0)
-		{
-			CONSOLE_DEBUG("Close error");
-		}
+		SJP_Init(jsonParser);
+		SJP_ParseDataInPlace(jsonParser, pollReply->replyData, pollReply->dataLen);
+		validData	=	true;
 	}
 	return(validData);
 }
 
-
 //*****************************************************************************
-static void	SendGetRequest(TYPE_ALPACA_UNIT *theDevice, const char *sendData)
+static void	ProcessConfiguredDevices(TYPE_ALPACA_UNIT *theDevice, SJP_Parser_t *jsonParser, const bool validData)
 {
-bool				validData;
-SJP_Parser_t		jsonParser;
 char				ipString[32];
 char				errMsgString[64];
 
@@ -667,16 +712,11 @@ char				errMsgString[64];
 	CONSOLE_DEBUG(__FUNCTION__);
 #endif
 
-	validData	=	GetJsonResponse(	&theDevice->deviceAddress,
-										theDevice->port,
-										sendData,
-										&jsonParser);
 	if (validData)
 	{
-//		CONSOLE_DEBUG(sendData);
-//		SJP_DumpJsonData(&jsonParser, __FUNCTION__);
+//		SJP_DumpJsonData(jsonParser, __FUNCTION__);
 
-		ExtractDevicesFromJSON(&jsonParser, theDevice);
+		ExtractDevicesFromJSON(jsonParser, theDevice);
 		theDevice->queryOKcnt++;
 		theDevice->currentlyActive	=	true;
 	}
@@ -712,106 +752,149 @@ int		iii;
 // 7=LIBRARY-3           	software-cfitsio-4.0
 // 8=LIBRARY-4           	software-opencv-4.5.1
 //*****************************************************************************
-static void	GetLibraryInfo(TYPE_ALPACA_UNIT *alpacaUnit)
+static void	ProcessLibraryInfo(TYPE_ALPACA_UNIT *alpacaUnit, SJP_Parser_t *jsonParser)
 {
 int				jjj;
-bool			validData;
-SJP_Parser_t	jsonParser;
 char			*valuePtr;
 
-	validData	=	GetJsonResponse(	&alpacaUnit->deviceAddress,
-										alpacaUnit->port,
-										"/api/v1/management/0/libraries",
-										&jsonParser);
-	if (validData)
+	for (jjj=0; jjj<jsonParser->tokenCount_Data; jjj++)
 	{
-		for (jjj=0; jjj<jsonParser.tokenCount_Data; jjj++)
+		//*	is this a library response
+		if (strncasecmp(jsonParser->dataList[jjj].keyword, "LIBRARY", 7) == 0)
 		{
-			//*	is this a library response
-			if (strncasecmp(jsonParser.dataList[jjj].keyword, "LIBRARY", 7) == 0)
+			valuePtr	=	strchr(jsonParser->dataList[jjj].valueString, '-');
+			if (valuePtr != NULL)
 			{
-				valuePtr	=	strchr(jsonParser.dataList[jjj].valueString, '-');
-				if (valuePtr != NULL)
+				valuePtr	+=	1;
+				if (strncasecmp(jsonParser->dataList[jjj].valueString, "software-opencv", 15) == 0)
 				{
-					valuePtr	+=	1;
-					if (strncasecmp(jsonParser.dataList[jjj].valueString, "software-opencv", 15) == 0)
-					{
-						strcpy(alpacaUnit->SoftwareVersion[kSoftwareVers_OpenCV].SoftwareVerStr, valuePtr);
-					}
-					else if (strncasecmp(jsonParser.dataList[jjj].valueString, "software-cfitsio", 16) == 0)
-					{
-						strcpy(alpacaUnit->SoftwareVersion[kSoftwareVers_Fits].SoftwareVerStr, valuePtr);
-					}
-					else if (strncasecmp(jsonParser.dataList[jjj].valueString, "software-wiringPi", 17) == 0)
-					{
-						strcpy(alpacaUnit->SoftwareVersion[kSoftwareVers_WiringPi].SoftwareVerStr, valuePtr);
-					}
+					strcpy(alpacaUnit->SoftwareVersion[kSoftwareVers_OpenCV].SoftwareVerStr, valuePtr);
+				}
+				else if (strncasecmp(jsonParser->dataList[jjj].valueString, "software-cfitsio", 16) == 0)
+				{
+					strcpy(alpacaUnit->SoftwareVersion[kSoftwareVers_Fits].SoftwareVerStr, valuePtr);
+				}
+				else if (strncasecmp(jsonParser->dataList[jjj].valueString, "software-wiringPi", 17) == 0)
+				{
+					strcpy(alpacaUnit->SoftwareVersion[kSoftwareVers_WiringPi].SoftwareVerStr, valuePtr);
 				}
 			}
-			else if (strcasecmp(jsonParser.dataList[jjj].keyword, "hardware") == 0)
-			{
-				//*	this is the hardware response
-				strcpy(	alpacaUnit->SoftwareVersion[kSoftwareVers_Hardware].SoftwareVerStr,
-						jsonParser.dataList[jjj].valueString);
-			}
+		}
+		else if (strcasecmp(jsonParser->dataList[jjj].keyword, "hardware") == 0)
+		{
+			//*	this is the hardware response
+			strcpy(	alpacaUnit->SoftwareVersion[kSoftwareVers_Hardware].SoftwareVerStr,
+					jsonParser->dataList[jjj].valueString);
 		}
 	}
-	alpacaUnit->SoftwareVersionOK	=	true;
 }
 
 //*****************************************************************************
-static void	GetCPUstats(TYPE_ALPACA_UNIT *alpacaUnit)
+static void	ProcessCPUstats(TYPE_ALPACA_UNIT *alpacaUnit, SJP_Parser_t *jsonParser)
 {
 int				jjj;
-bool			validData;
-SJP_Parser_t	jsonParser;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
-	validData	=	GetJsonResponse(	&alpacaUnit->deviceAddress,
-										alpacaUnit->port,
-										"/api/v1/management/0/cpustats",
-										&jsonParser);
-	if (validData)
+	for (jjj=0; jjj<jsonParser->tokenCount_Data; jjj++)
 	{
-		for (jjj=0; jjj<jsonParser.tokenCount_Data; jjj++)
+		//*	is this a hardware response
+		if (strcasecmp(jsonParser->dataList[jjj].keyword, "hardware") == 0)
+		{
+			strcpy(	alpacaUnit->SoftwareVersion[kSoftwareVers_Hardware].SoftwareVerStr,
+					jsonParser->dataList[jjj].valueString);
+		}
+		else if (strcasecmp(jsonParser->dataList[jjj].keyword, "platform") == 0)
 		{
-			//*	is this a hardware response
-			if (strcasecmp(jsonParser.dataList[jjj].keyword, "hardware") == 0)
+//			strcpy(alpacaUnit->Platform, jsonParser->dataList[jjj].valueString);
+			strcpy(	alpacaUnit->SoftwareVersion[kSoftwareVers_Platform].SoftwareVerStr,
+					jsonParser->dataList[jjj].valueString);
+		}
+	}
+}
+
+//*	urlTag values for PollAllDevices()
+enum
+{
+	kUnitQuery_ConfiguredDevices	=	0,
+	kUnitQuery_Libraries,
+	kUnitQuery_CPUstats
+};
+
+//*****************************************************************************
+//*	called by DiscoveryFanout_Run() on this thread, pollReply is NULL if the unit never answered
+//*****************************************************************************
+static void	PollAllDevices_ReplyProc(TYPE_FanoutHost *fanoutHost, const int urlIdx, TYPE_AlpacaPollReply *pollReply)
+{
+TYPE_ALPACA_UNIT	*alpacaUnit;
+SJP_Parser_t		jsonParser;
+bool				validData;
+
+	alpacaUnit	=	(TYPE_ALPACA_UNIT *)fanoutHost->userData;
+	validData	=	ParseFanoutReply(pollReply, &jsonParser);
+	switch(fanoutHost->urlTag[urlIdx])
+	{
+		case kUnitQuery_ConfiguredDevices:
+			ProcessConfiguredDevices(alpacaUnit, &jsonParser, validData);
+			break;
+
+		case kUnitQuery_Libraries:
+			if (validData)
 			{
-				strcpy(	alpacaUnit->SoftwareVersion[kSoftwareVers_Hardware].SoftwareVerStr,
-						jsonParser.dataList[jjj].valueString);
+				ProcessLibraryInfo(alpacaUnit, &jsonParser);
 			}
-			else if (strcasecmp(jsonParser.dataList[jjj].keyword, "platform") == 0)
+			//*	we only ask once, good or bad
+			alpacaUnit->SoftwareVersionOK	=	true;
+			break;
+
+		case kUnitQuery_CPUstats:
+			if (validData)
 			{
-//				strcpy(alpacaUnit->Platform, jsonParser.dataList[jjj].valueString);
-				strcpy(	alpacaUnit->SoftwareVersion[kSoftwareVers_Platform].SoftwareVerStr,
-						jsonParser.dataList[jjj].valueString);
+				ProcessCPUstats(alpacaUnit, &jsonParser);
 			}
-		}
+			break;
 	}
 }
 
+//*****************************************************************************
+//*	all of the units are asked at the same time, up to kFanout_MaxInFlight at once
 //*****************************************************************************
 static void	PollAllDevices(void)
 {
 int				iii;
+int				hostCnt;
+TYPE_FanoutHost	*fanoutHost;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 //	CONSOLE_DEBUG_W_NUM("gAlpacaUnitCnt\t=", gAlpacaUnitCnt);
+	hostCnt	=	0;
 	for (iii=0; iii<gAlpacaUnitCnt; iii++)
 	{
+		fanoutHost	=	&gFanoutHostList[hostCnt];
+		DiscoveryFanout_InitHost(	fanoutHost,
+									&gAlpacaUnitList[iii].deviceAddress,
+									gAlpacaUnitList[iii].port,
+									&gAlpacaUnitList[iii]);
 		if (gAlpacaUnitList[iii].noResponseCnt == 0)
 		{
-			SendGetRequest(&gAlpacaUnitList[iii], "/management/v1/configureddevices");
+			DiscoveryFanout_AddUrl(fanoutHost, "/management/v1/configureddevices", kUnitQuery_ConfiguredDevices);
 		}
 		//-----------------------------------------------------------
 		//*	check for software versions
 		if (gAlpacaUnitList[iii].SoftwareVersionOK == false)
 		{
-			GetLibraryInfo(&gAlpacaUnitList[iii]);
-			GetCPUstats(&gAlpacaUnitList[iii]);
+			DiscoveryFanout_AddUrl(fanoutHost, "/api/v1/management/0/libraries",	kUnitQuery_Libraries);
+			DiscoveryFanout_AddUrl(fanoutHost, "/api/v1/management/0/cpustats",	kUnitQuery_CPUstats);
+		}
+		if (fanoutHost->urlCnt > 0)
+		{
+			hostCnt++;
 		}
 	}
+	DiscoveryFanout_Run(	gFanoutHostList,
+							hostCnt,
+							kFanout_MaxInFlight,
+							kFanout_HostDeadline_ms,
+							PollAllDevices_ReplyProc);
 //	CONSOLE_DEBUG_W_NUM("gRemoteCnt\t=", gRemoteCnt);
 }
 
@@ -869,51 +952,16 @@ struct timeval	currentTime;		//*	time exposure or video was started for frame ra
 #endif // LOG_DISCOVERED_IP_ADDRS
 
 
-//**************************************************************************************
-static  int AlpacaUnitQsortProc(const void *e1, const void *e2)
-{
-TYPE_ALPACA_UNIT	*obj1, *obj2;
-int					returnValue;
-uint32_t			ipAddr1;
-uint32_t			ipAddr2;
-
-
-	obj1		=	(TYPE_ALPACA_UNIT *)e1;
-	obj2		=	(TYPE_ALPACA_UNIT *)e2;
-
-	ipAddr1	=	(obj1->deviceAddress.sin_addr.s_addr & 0x000000ff) << 24;
-	ipAddr1	+=	(obj1->deviceAddress.sin_addr.s_addr & 0x0000ff00) << 8;
-	ipAddr1	+=	(obj1->deviceAddress.sin_addr.s_addr & 0x00ff0000) >> 8;
-	ipAddr1	+=	(obj1->deviceAddress.sin_addr.s_addr & 0xff000000) >> 24;
-
-	ipAddr2	=	(obj2->deviceAddress.sin_addr.s_addr & 0x000000ff) << 24;
-	ipAddr2	+=	(obj2->deviceAddress.sin_addr.s_addr & 0x0000ff00) << 8;
-	ipAddr2	+=	(obj2->deviceAddress.sin_addr.s_addr & 0x00ff0000) >> 8;
-	ipAddr2	+=	(obj2->deviceAddress.sin_addr.s_addr & 0xff000000) >> 24;
-
-	returnValue	=	0;
-	if (ipAddr1 < ipAddr2)
-	{
-		returnValue	=	-1;
-	}
-	else if (ipAddr1 > ipAddr2)
-	{
-		returnValue	=	1;
-	}
-
-	return(returnValue);
-
-}
-
 //*****************************************************************************
 static void	AddIPaddressToList(struct sockaddr_in *deviceAddress, SJP_Parser_t *jsonParser)
 {
-int		iii;
-bool	newDevice;
-int		theDeviceIdx;
-bool	foundHostName;
-char	myHostNameStr[128];
-int		alpacaListenPort;
+int					iii;
+int					theDeviceIdx;
+int					insertIdx;
+bool				foundHostName;
+char				myHostNameStr[128];
+int					alpacaListenPort;
+TYPE_ALPACA_UNIT	*newUnit;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 	//------------------------------------------------
@@ -929,19 +977,8 @@ int		alpacaListenPort;
 		}
 	}
 
-	newDevice			=	true;
-	theDeviceIdx		=	-1;
-	for (iii=0; iii<gAlpacaUnitCnt; iii++)
-	{
-		if (	(deviceAddress->sin_addr.s_addr	==	gAlpacaUnitList[iii].deviceAddress.sin_addr.s_addr)
-			&&	(alpacaListenPort				==	gAlpacaUnitList[iii].port))
-		{
-			newDevice		=	false;
-			theDeviceIdx	=	iii;
-			break;
-		}
-	}
-	if (newDevice)
+	theDeviceIdx	=	FindUnitIndex(deviceAddress, alpacaListenPort);
+	if (theDeviceIdx < 0)
 	{
 		//*	add the new devices to our list
 //		CONSOLE_DEBUG("We have a new devices")
@@ -949,17 +986,31 @@ int		alpacaListenPort;
 		{
 //			CONSOLE_DEBUG("Adding to table");
 //			CONSOLE_DEBUG_W_NUM("gAlpacaUnitCnt\t=", gAlpacaUnitCnt);
-			gAlpacaUnitList[gAlpacaUnitCnt].deviceAddress	=	*deviceAddress;
-			gAlpacaUnitList[gAlpacaUnitCnt].port			=	alpacaListenPort;
-			gAlpacaUnitList[gAlpacaUnitCnt].currentlyActive	=	false;
-			gAlpacaUnitList[gAlpacaUnitCnt].displayGraph	=	true;
+			//*	the list is sorted by IP address, open up a spot for it
+			//*	instead of sorting the whole list every time
+			insertIdx	=	gAlpacaUnitCnt;
+			while ((insertIdx > 0) &&
+					(ntohl(gAlpacaUnitList[insertIdx - 1].deviceAddress.sin_addr.s_addr) > ntohl(deviceAddress->sin_addr.s_addr)))
+			{
+				insertIdx--;
+			}
+			memmove((void *)&gAlpacaUnitList[insertIdx + 1],
+					(void *)&gAlpacaUnitList[insertIdx],
+					((gAlpacaUnitCnt - insertIdx) * sizeof(TYPE_ALPACA_UNIT)));
+
+			newUnit		=	&gAlpacaUnitList[insertIdx];
+			memset((void *)newUnit, 0, sizeof(TYPE_ALPACA_UNIT));
+			newUnit->deviceAddress		=	*deviceAddress;
+			newUnit->port				=	alpacaListenPort;
+			newUnit->currentlyActive	=	false;
+			newUnit->displayGraph		=	true;
 
 			//*	and lookup the host name
 			foundHostName	=	LookupNameFromIPaddr(deviceAddress->sin_addr.s_addr, myHostNameStr);
 			if (foundHostName)
 			{
 //				CONSOLE_DEBUG_W_STR("Found host name:", myHostNameStr);
-				strcpy(gAlpacaUnitList[gAlpacaUnitCnt].hostName, myHostNameStr);
+				strcpy(newUnit->hostName, myHostNameStr);
 			}
 			else
 			{
@@ -971,9 +1022,8 @@ int		alpacaListenPort;
 			}
 			gAlpacaUnitCnt++;
 
-			//*	sort by IP address
-			qsort(gAlpacaUnitList, gAlpacaUnitCnt, sizeof(TYPE_ALPACA_UNIT), AlpacaUnitQsortProc);
-
+			//*	the entries after it have moved
+			RebuildUnitHashTable();
 		}
 		else
 		{
@@ -1024,88 +1074,51 @@ char	ipAddrSt[32];
 
 
 
+#ifdef _ENABLE_CAMERA_
+//*	urlTag values for GetInformationFromOtherDevices()
+enum
+{
+	kObsCond_Description	=	0,
+	kObsCond_Pressure,
+	kObsCond_Humidity
+};
+
 //*****************************************************************************
-//*	step through the other devices and see if there is any info we want.
-static	void GetInformationFromOtherDevices(void)
+//*	called by DiscoveryFanout_Run() on this thread, the replies for one device come in the
+//*	order they were added, so the description is always first.
+//*	userValue is set if it is DOME environmental information
+//*****************************************************************************
+static void	ObsCond_ReplyProc(TYPE_FanoutHost *fanoutHost, const int urlIdx, TYPE_AlpacaPollReply *pollReply)
 {
-int				ii;
-//char			ipAddressStr[32];
-#ifdef _ENABLE_CAMERA_
-	int				jjj;
-	SJP_Parser_t	jsonParser;
-	bool			validData;
-	bool			domeInfo;
-	double			pressure_kPa;
-	double			humidity;
-#endif // _ENABLE_CAMERA_
+int				jjj;
+SJP_Parser_t	jsonParser;
+bool			validData;
+double			pressure_kPa;
+double			humidity;
 
-//	CONSOLE_DEBUG(__FUNCTION__);
-//	CONSOLE_DEBUG_W_NUM("gRemoteCnt\t=", gRemoteCnt);
-	for (ii=0; ii<gRemoteCnt; ii++)
+	validData	=	ParseFanoutReply(pollReply, &jsonParser);
+	if (validData)
 	{
-	#ifdef _ENABLE_SKYTRAVEL_
-	//	CONSOLE_DEBUG_W_STR("device type\t=", gRemoteList[ii].deviceTypeStr);
-
-//		inet_ntop(AF_INET, &gRemoteList[ii].deviceAddress.sin_addr, ipAddressStr, INET_ADDRSTRLEN);
-
-//		printf("%-17s\t%-17s\t%-17s\t%-17s\t\r\n",	ipAddressStr,
-//													gRemoteList[ii].deviceTypeStr,
-//													gRemoteList[ii].deviceNameStr,
-//													gRemoteList[ii].versionString);
-	#endif
-	#ifdef _ENABLE_CAMERA_
-		if ((gRemoteList[ii].notSeenCounter == 0) &&
-			(strcmp(gRemoteList[ii].deviceTypeStr, "observingconditions") == 0))
+		for (jjj=0; jjj<jsonParser.tokenCount_Data; jjj++)
 		{
-			domeInfo	=	false;
-			//------------------------------------------------
-			//*	description
-			//*	we need the description to know if it is indoor or outdoor
-			//*	http://192.168.1.166:6800/api/v1/observingconditions/0/description
-			SJP_Init(&jsonParser);
-			validData	=	GetJsonResponse(	&gRemoteList[ii].deviceAddress,
-												gRemoteList[ii].port,
-												"/api/v1/observingconditions/0/description",
-												&jsonParser);
-			if (validData)
+			if (strcmp(jsonParser.dataList[jjj].keyword, "VALUE") == 0)
 			{
-				//*	we have valid description
-				for (jjj=0; jjj<jsonParser.tokenCount_Data; jjj++)
+				switch(fanoutHost->urlTag[urlIdx])
 				{
-					if (strcmp(jsonParser.dataList[jjj].keyword, "VALUE") == 0)
-					{
+					case kObsCond_Description:
 						if (strncasecmp(jsonParser.dataList[jjj].valueString, "dome", 4) == 0)
 						{
 	//						CONSOLE_DEBUG("We have DOME environmental information");
-							domeInfo	=	true;
+							fanoutHost->userValue	=	true;
 						}
-					}
-				}
-			}
-			else
-			{
-				CONSOLE_DEBUG("No valid data");
-			}
+						break;
 
-			//------------------------------------------------
-			//	pressure
-			SJP_Init(&jsonParser);
-			validData	=	GetJsonResponse(	&gRemoteList[ii].deviceAddress,
-												gRemoteList[ii].port,
-												"/api/v1/observingconditions/0/pressure",
-												&jsonParser);
-			if (validData)
-			{
-				//*	we have valid pressure
-				for (jjj=0; jjj<jsonParser.tokenCount_Data; jjj++)
-				{
-					if (strcmp(jsonParser.dataList[jjj].keyword, "VALUE") == 0)
-					{
+					case kObsCond_Pressure:
 						//*	the response is in hectoPascals
 						pressure_kPa	=	atof(jsonParser.dataList[jjj].valueString) / 10.0;
 						if (pressure_kPa > 0.0)
 						{
-							if (domeInfo)
+							if (fanoutHost->userValue)
 							{
 								gEnvData.domeDataValid		=	true;
 								gEnvData.domePressure_kPa	=	pressure_kPa;
@@ -1120,33 +1133,14 @@ int				ii;
 								gettimeofday(&gEnvData.siteLastUpdate, NULL);
 							}
 						}
-					}
-				}
-			}
-			else
-			{
-				CONSOLE_DEBUG("No valid data");
-			}
+						break;
 
-			//------------------------------------------------
-			//	humidity
-			SJP_Init(&jsonParser);
-			validData	=	GetJsonResponse(	&gRemoteList[ii].deviceAddress,
-												gRemoteList[ii].port,
-												"/api/v1/observingconditions/0/humidity",
-												&jsonParser);
-			if (validData)
-			{
-				//*	we have valid humidity
-				for (jjj=0; jjj<jsonParser.tokenCount_Data; jjj++)
-				{
-					if (strcmp(jsonParser.dataList[jjj].keyword, "VALUE") == 0)
-					{
+					case kObsCond_Humidity:
 						humidity	=	atof(jsonParser.dataList[jjj].valueString);
 						if (humidity > 0.0)
 						{
 						//	CONSOLE_DEBUG_W_DBL("Valid humidity data=", humidity);
-							if (domeInfo)
+							if (fanoutHost->userValue)
 							{
 								gEnvData.domeDataValid		=	true;
 								gEnvData.domeHumidity		=	humidity;
@@ -1159,16 +1153,58 @@ int				ii;
 								gettimeofday(&gEnvData.siteLastUpdate, NULL);
 							}
 						}
-					}
+						break;
 				}
 			}
-			else
-			{
-				CONSOLE_DEBUG("No valid data");
-			}
 		}
-	#endif
 	}
+	else
+	{
+		CONSOLE_DEBUG("No valid data");
+	}
+}
+#endif // _ENABLE_CAMERA_
+
+//*****************************************************************************
+//*	step through the other devices and see if there is any info we want.
+//*	all of the devices are asked at the same time
+static	void GetInformationFromOtherDevices(void)
+{
+#ifdef _ENABLE_CAMERA_
+	int				ii;
+	int				hostCnt;
+	TYPE_FanoutHost	*fanoutHost;
+
+//	CONSOLE_DEBUG(__FUNCTION__);
+//	CONSOLE_DEBUG_W_NUM("gRemoteCnt\t=", gRemoteCnt);
+	hostCnt	=	0;
+	for (ii=0; ii<gRemoteCnt; ii++)
+	{
+		if ((gRemoteList[ii].notSeenCounter == 0) &&
+			(strcmp(gRemoteList[ii].deviceTypeStr, "observingconditions") == 0) &&
+			(hostCnt < kFanoutHostListSize))
+		{
+			fanoutHost	=	&gFanoutHostList[hostCnt];
+			DiscoveryFanout_InitHost(	fanoutHost,
+										&gRemoteList[ii].deviceAddress,
+										gRemoteList[ii].port,
+										&gRemoteList[ii]);
+			//------------------------------------------------
+			//*	description
+			//*	we need the description to know if it is indoor or outdoor
+			//*	http://192.168.1.166:6800/api/v1/observingconditions/0/description
+			DiscoveryFanout_AddUrl(fanoutHost, "/api/v1/observingconditions/0/description",	kObsCond_Description);
+			DiscoveryFanout_AddUrl(fanoutHost, "/api/v1/observingconditions/0/pressure",	kObsCond_Pressure);
+			DiscoveryFanout_AddUrl(fanoutHost, "/api/v1/observingconditions/0/humidity",	kObsCond_Humidity);
+			hostCnt++;
+		}
+	}
+	DiscoveryFanout_Run(	gFanoutHostList,
+							hostCnt,
+							kFanout_MaxInFlight,
+							kFanout_HostDeadline_ms,
+							ObsCond_ReplyProc);
+#endif // _ENABLE_CAMERA_
 //	CONSOLE_DEBUG_W_STR(__FUNCTION__, "Exit");
 }
 
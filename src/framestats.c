@@ -0,0 +1,427 @@
+//*****************************************************************************
+//*
+//*	Name:			framestats.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Single pass frame statistics (histogram, min, max, mean, saturation)
+//*
+//*	Usage notes:	The camera driver used to make a separate pass over the frame for
+//*					min, max, saturation count and the histogram, auto exposure did it again.
+//*
+//*					This makes one pass that only fills in the histograms, at full
+//*					16 bit resolution for RAW16. Min, max, mean, std dev, percentiles and
+//*					the saturation count all come from the histograms afterwards,
+//*					which is at most 65536 bins no matter how big the frame is.
+//*
+//*					Incrementing a histogram bin is a load and a store to the same place,
+//*					when neighboring pixels have the same value (most of the sky)
+//*					each one has to wait for the one before it. The 8 bit loops spread
+//*					the pixels over several copies of the histogram so they don't.
+//*
+//*					Big frames are split between threads, each with its own histograms.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created framestats.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<math.h>
+#include	<time.h>
+#include	<unistd.h>
+#include	<pthread.h>
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"framestats.h"
+
+#define	kMaxStatsThreads		8
+
+//*	smaller than this is not worth starting a thread for
+#define	kMinPixelsPerThread		(1024 * 1024)
+
+//*	number of copies of the histogram each worker uses, indexed by kFrameStats_xxx
+static const int	gSubHistogramCnt[kFrameStats_last]	=	{	4,	2,	2	};
+static const int	gChannelCnt[kFrameStats_last]		=	{	1,	1,	3	};
+static const int	gBinCnt[kFrameStats_last]			=	{	256,	65536,	256	};
+static const int	gBytesPerPixel[kFrameStats_last]	=	{	1,	2,	3	};
+
+//*****************************************************************************
+typedef struct	//	TYPE_StatsWorker
+{
+	const unsigned char	*pixelPtr;
+	int					format;
+	size_t				pixelCnt;
+	uint32_t			*histogram;			//*	subHistogramCnt * channelCnt * binCnt
+	uint32_t			saturatedPixelCnt;
+
+} TYPE_StatsWorker;
+
+//*****************************************************************************
+static double	GetMilliSeconds(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return((timeSpec.tv_sec * 1000.0) + (timeSpec.tv_nsec / 1000000.0));
+}
+
+//*****************************************************************************
+static void	FillHistograms(TYPE_StatsWorker *worker)
+{
+const unsigned char	*pixelPtr;
+const uint16_t		*wordPtr;
+uint32_t			*hist0;
+uint32_t			*hist1;
+uint32_t			*hist2;
+uint32_t			*hist3;
+size_t				pixelCnt;
+size_t				iii;
+uint32_t			saturatedCnt;
+
+	pixelPtr		=	worker->pixelPtr;
+	pixelCnt		=	worker->pixelCnt;
+	saturatedCnt	=	0;
+	switch(worker->format)
+	{
+		case kFrameStats_Mono8:
+			hist0	=	worker->histogram;
+			hist1	=	hist0 + 256;
+			hist2	=	hist1 + 256;
+			hist3	=	hist2 + 256;
+			for (iii=0; (iii + 4)<=pixelCnt; iii+=4)
+			{
+				hist0[pixelPtr[iii]]++;
+				hist1[pixelPtr[iii + 1]]++;
+				hist2[pixelPtr[iii + 2]]++;
+				hist3[pixelPtr[iii + 3]]++;
+			}
+			for (; iii<pixelCnt; iii++)
+			{
+				hist0[pixelPtr[iii]]++;
+			}
+			break;
+
+		case kFrameStats_Mono16:
+			wordPtr	=	(const uint16_t *)pixelPtr;
+			hist0	=	worker->histogram;
+			hist1	=	hist0 + 65536;
+			for (iii=0; (iii + 2)<=pixelCnt; iii+=2)
+			{
+				hist0[wordPtr[iii]]++;
+				hist1[wordPtr[iii + 1]]++;
+			}
+			for (; iii<pixelCnt; iii++)
+			{
+				hist0[wordPtr[iii]]++;
+			}
+			break;
+
+		case kFrameStats_BGR24:
+			//*	each copy is red, green, blue, 256 bins each
+			hist0	=	worker->histogram;
+			hist1	=	hist0 + (3 * 256);
+			for (iii=0; (iii + 2)<=pixelCnt; iii+=2)
+			{
+				hist0[pixelPtr[2]]++;
+				hist0[256 + pixelPtr[1]]++;
+				hist0[512 + pixelPtr[0]]++;
+				hist1[pixelPtr[5]]++;
+				hist1[256 + pixelPtr[4]]++;
+				hist1[512 + pixelPtr[3]]++;
+				saturatedCnt	+=	(pixelPtr[0] == 255) | (pixelPtr[1] == 255) | (pixelPtr[2] == 255);
+				saturatedCnt	+=	(pixelPtr[3] == 255) | (pixelPtr[4] == 255) | (pixelPtr[5] == 255);
+				pixelPtr		+=	6;
+			}
+			for (; iii<pixelCnt; iii++)
+			{
+				hist0[pixelPtr[2]]++;
+				hist0[256 + pixelPtr[1]]++;
+				hist0[512 + pixelPtr[0]]++;
+				saturatedCnt	+=	(pixelPtr[0] == 255) | (pixelPtr[1] == 255) | (pixelPtr[2] == 255);
+				pixelPtr		+=	3;
+			}
+			break;
+	}
+	worker->saturatedPixelCnt	=	saturatedCnt;
+}
+
+//*****************************************************************************
+static void	*FillHistogramsThread(void *arg)
+{
+	FillHistograms((TYPE_StatsWorker *)arg);
+	return(NULL);
+}
+
+//*****************************************************************************
+static uint32_t	HistogramPercentile(const uint32_t *histogram, int binCnt, uint64_t totalCnt, double percent)
+{
+uint64_t	targetCnt;
+uint64_t	runningCnt;
+int			iii;
+
+	if (totalCnt == 0)
+	{
+		return(0);
+	}
+	targetCnt	=	(uint64_t)ceil((percent / 100.0) * totalCnt);
+	if (targetCnt < 1)
+	{
+		targetCnt	=	1;
+	}
+	runningCnt	=	0;
+	for (iii=0; iii<binCnt; iii++)
+	{
+		runningCnt	+=	histogram[iii];
+		if (runningCnt >= targetCnt)
+		{
+			return(iii);
+		}
+	}
+	return(binCnt - 1);
+}
+
+//*****************************************************************************
+static void	CalculateChannelStats(TYPE_ChannelStats *channelStats, const uint32_t *histogram, int binCnt)
+{
+uint64_t	totalCnt;
+uint64_t	valueSum;
+double		varianceSum;
+double		delta;
+int			iii;
+
+	memset(channelStats, 0, sizeof(TYPE_ChannelStats));
+	totalCnt	=	0;
+	valueSum	=	0;
+	for (iii=0; iii<binCnt; iii++)
+	{
+		if (histogram[iii] > 0)
+		{
+			if (totalCnt == 0)
+			{
+				channelStats->minValue	=	iii;
+			}
+			channelStats->maxValue	=	iii;
+			totalCnt				+=	histogram[iii];
+			valueSum				+=	(uint64_t)histogram[iii] * iii;
+		}
+	}
+	if (totalCnt > 0)
+	{
+		channelStats->mean	=	(valueSum * 1.0) / totalCnt;
+		varianceSum			=	0.0;
+		for (iii=channelStats->minValue; iii<=(int)channelStats->maxValue; iii++)
+		{
+			delta		=	iii - channelStats->mean;
+			varianceSum	+=	histogram[iii] * delta * delta;
+		}
+		channelStats->stdDev		=	sqrt(varianceSum / totalCnt);
+		channelStats->median		=	HistogramPercentile(histogram, binCnt, totalCnt, 50.0);
+		channelStats->percentile01	=	HistogramPercentile(histogram, binCnt, totalCnt, 1.0);
+		channelStats->percentile99	=	HistogramPercentile(histogram, binCnt, totalCnt, 99.0);
+		channelStats->saturatedCnt	=	histogram[binCnt - 1];
+	}
+}
+
+//*****************************************************************************
+bool	FrameStats_Calculate(	TYPE_FrameStats		*frameStats,
+								const unsigned char	*imageData,
+								int					width,
+								int					height,
+								int					format,
+								int					threadCount)
+{
+TYPE_StatsWorker	workers[kMaxStatsThreads];
+pthread_t			threadIDs[kMaxStatsThreads];
+bool				threadRunning[kMaxStatsThreads];
+uint32_t			combinedHist[256];
+size_t				pixelCount;
+size_t				pixelsPerThread;
+size_t				nextPixel;
+size_t				histogramLen;
+double				startTime_ms;
+int					channelCnt;
+int					binCnt;
+int					subHistCnt;
+int					threadErr;
+int					iii;
+int					ccc;
+int					sss;
+int					bbb;
+bool				allocOK;
+
+	if ((frameStats == NULL) || (imageData == NULL) || (width <= 0) || (height <= 0) ||
+		(format < 0) || (format >= kFrameStats_last))
+	{
+		return(false);
+	}
+	startTime_ms	=	GetMilliSeconds();
+	channelCnt		=	gChannelCnt[format];
+	binCnt			=	gBinCnt[format];
+	subHistCnt		=	gSubHistogramCnt[format];
+	pixelCount		=	(size_t)width * height;
+
+	if (threadCount <= 0)
+	{
+		threadCount	=	sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (threadCount > kMaxStatsThreads)
+	{
+		threadCount	=	kMaxStatsThreads;
+	}
+	if (threadCount > (int)(pixelCount / kMinPixelsPerThread))
+	{
+		threadCount	=	pixelCount / kMinPixelsPerThread;
+	}
+	if (threadCount < 1)
+	{
+		threadCount	=	1;
+	}
+
+	//*	split the frame into equal runs of pixels, each worker gets its own histograms
+	histogramLen	=	(size_t)subHistCnt * channelCnt * binCnt;
+	pixelsPerThread	=	(pixelCount + threadCount - 1) / threadCount;
+	nextPixel		=	0;
+	allocOK			=	true;
+	memset(workers, 0, sizeof(workers));
+	for (iii=0; iii<threadCount; iii++)
+	{
+		workers[iii].pixelPtr	=	imageData + (nextPixel * gBytesPerPixel[format]);
+		workers[iii].format		=	format;
+		workers[iii].pixelCnt	=	pixelCount - nextPixel;
+		if (workers[iii].pixelCnt > pixelsPerThread)
+		{
+			workers[iii].pixelCnt	=	pixelsPerThread;
+		}
+		nextPixel				+=	workers[iii].pixelCnt;
+		workers[iii].histogram	=	(uint32_t *)calloc(histogramLen, sizeof(uint32_t));
+		if (workers[iii].histogram == NULL)
+		{
+			allocOK	=	false;
+		}
+	}
+
+	if (allocOK)
+	{
+		//*	the first one is done on this thread
+		for (iii=1; iii<threadCount; iii++)
+		{
+			threadErr			=	pthread_create(&threadIDs[iii], NULL, &FillHistogramsThread, &workers[iii]);
+			threadRunning[iii]	=	(threadErr == 0);
+			if (threadErr != 0)
+			{
+				FillHistograms(&workers[iii]);
+			}
+		}
+		FillHistograms(&workers[0]);
+		for (iii=1; iii<threadCount; iii++)
+		{
+			if (threadRunning[iii])
+			{
+				pthread_join(threadIDs[iii], NULL);
+			}
+		}
+
+		//*	add up all of the copies
+		memset(frameStats, 0, sizeof(TYPE_FrameStats));
+		frameStats->format			=	format;
+		frameStats->channelCnt		=	channelCnt;
+		frameStats->binCnt			=	binCnt;
+		frameStats->pixelCount		=	pixelCount;
+		frameStats->saturationValue	=	binCnt - 1;
+		for (iii=0; iii<threadCount; iii++)
+		{
+			for (sss=0; sss<subHistCnt; sss++)
+			{
+				for (bbb=0; bbb<(channelCnt * binCnt); bbb++)
+				{
+					frameStats->histogram[bbb]	+=	workers[iii].histogram[(sss * channelCnt * binCnt) + bbb];
+				}
+			}
+			frameStats->saturatedPixelCnt	+=	workers[iii].saturatedPixelCnt;
+		}
+
+		for (ccc=0; ccc<channelCnt; ccc++)
+		{
+			CalculateChannelStats(&frameStats->channel[ccc], &frameStats->histogram[ccc * binCnt], binCnt);
+		}
+		if (channelCnt == 1)
+		{
+			frameStats->all					=	frameStats->channel[0];
+			frameStats->saturatedPixelCnt	=	frameStats->channel[0].saturatedCnt;
+		}
+		else
+		{
+			//*	the channels all have the same pixel count, so they can be put together as is
+			memset(combinedHist, 0, sizeof(combinedHist));
+			for (ccc=0; ccc<channelCnt; ccc++)
+			{
+				for (bbb=0; bbb<binCnt; bbb++)
+				{
+					combinedHist[bbb]	+=	frameStats->histogram[(ccc * binCnt) + bbb];
+				}
+			}
+			CalculateChannelStats(&frameStats->all, combinedHist, binCnt);
+
+			//*	keep the saturation count in pixels, not in channel values
+			frameStats->all.saturatedCnt	=	frameStats->saturatedPixelCnt;
+		}
+		frameStats->calcTime_ms	=	GetMilliSeconds() - startTime_ms;
+		frameStats->valid		=	true;
+	}
+	else
+	{
+		CONSOLE_DEBUG("Failed to allocate memory");
+	}
+
+	for (iii=0; iii<threadCount; iii++)
+	{
+		free(workers[iii].histogram);
+	}
+	return(allocOK);
+}
+
+//*****************************************************************************
+const uint32_t	*FrameStats_GetHistogram(const TYPE_FrameStats *frameStats, const int channelIdx)
+{
+	if ((frameStats == NULL) || (frameStats->valid == false) ||
+		(channelIdx < 0) || (channelIdx >= frameStats->channelCnt))
+	{
+		return(NULL);
+	}
+	return(&frameStats->histogram[channelIdx * frameStats->binCnt]);
+}
+
+//*****************************************************************************
+uint32_t	FrameStats_GetPercentile(const TYPE_FrameStats *frameStats, const int channelIdx, const double percent)
+{
+const uint32_t	*histogram;
+
+	histogram	=	FrameStats_GetHistogram(frameStats, channelIdx);
+	if (histogram == NULL)
+	{
+		return(0);
+	}
+	return(HistogramPercentile(histogram, frameStats->binCnt, frameStats->pixelCount, percent));
+}
@@ -0,0 +1,94 @@
+//**************************************************************************
+//*	Name:			framestats.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Single pass frame statistics (histogram, min, max, mean, saturation)
+//*
+//*****************************************************************************
+//#include	"framestats.h"
+
+#ifndef _FRAMESTATS_H_
+#define	_FRAMESTATS_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+enum
+{
+	kFrameStats_Mono8	=	0,		//*	8 bit pixels
+	kFrameStats_Mono16,				//*	16 bit pixels
+	kFrameStats_BGR24,				//*	24 bit BGR (openCV order), channel 0 = red, 1 = green, 2 = blue
+
+	kFrameStats_last
+};
+
+#define	kFrameStats_MaxChannels		3
+#define	kFrameStats_MaxBins			65536
+
+//*****************************************************************************
+typedef struct	//	TYPE_ChannelStats
+{
+	uint32_t	minValue;
+	uint32_t	maxValue;
+	double		mean;
+	double		stdDev;
+	uint32_t	median;
+	uint32_t	percentile01;		//*	1% of the pixels are at or below this value
+	uint32_t	percentile99;		//*	99% of the pixels are at or below this value
+	uint32_t	saturatedCnt;		//*	pixels at the largest value for the bit depth
+
+} TYPE_ChannelStats;
+
+//*****************************************************************************
+//*	everything is worked out from the histograms, which are filled in one pass
+//*****************************************************************************
+typedef struct	//	TYPE_FrameStats
+{
+	bool				valid;
+	int					format;
+	int					channelCnt;
+	int					binCnt;					//*	256 or 65536
+	uint32_t			pixelCount;
+	uint32_t			saturationValue;		//*	255 or 65535
+	uint32_t			saturatedPixelCnt;		//*	for color, a pixel with any channel saturated
+	double				calcTime_ms;
+
+	TYPE_ChannelStats	all;					//*	all of the channels together
+	TYPE_ChannelStats	channel[kFrameStats_MaxChannels];
+
+	//*	channel N starts at histogram[N * binCnt]
+	uint32_t			histogram[kFrameStats_MaxBins];
+
+} TYPE_FrameStats;
+
+//*	threadCount	0 = one per cpu (up to 8), small images are always done on the calling thread
+bool		FrameStats_Calculate(	TYPE_FrameStats		*frameStats,
+									const unsigned char	*imageData,
+									int					width,
+									int					height,
+									int					format,
+									int					threadCount);
+
+const uint32_t	*FrameStats_GetHistogram(const TYPE_FrameStats *frameStats, const int channelIdx);
+
+//*	percent is 0.0 -> 100.0
+uint32_t	FrameStats_GetPercentile(const TYPE_FrameStats *frameStats, const int channelIdx, const double percent);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif	//	_FRAMESTATS_H_
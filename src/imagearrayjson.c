@@ -0,0 +1,526 @@
+//*****************************************************************************
+//*
+//*	Name:			imagearrayjson.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Fast JSON text encoder for imagearray and rgbarray
+//*
+//*	Usage notes:	The old code did a sprintf() and a strcat() for every pixel and
+//*					a write() every 100 values, a 16 mp frame took over a minute on a Pi.
+//*
+//*					This does the number to text conversion with lookup tables,
+//*					8 bit values come straight out of a 256 entry table of finished strings,
+//*					everything else is done 2 digits at a time.
+//*					The text is built in 1 mbyte chunks and handed to writeFunc in order.
+//*
+//*					imagearray is column major, a few columns at a time are transposed
+//*					with ImageBytes_TransposeColumns() so the formatting reads memory in order.
+//*
+//*					With more than one thread, each thread formats its own stripe of
+//*					columns (rows for rgbarray) into its own buffer, the calling thread
+//*					sends the buffers in order as they are finished.
+//*
+//*					imagearrayjsonbench checks the output against the original code
+//*					and compares the frames/sec.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created imagearrayjson.c
+//*	Oct 16,	2026	<MLS> Table driven number formatting, 1 mbyte chunks, threaded stripes
+//*	Oct 17,	2026	<MLS> SendToSocket() uses SocketListen_SendAll()
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<errno.h>
+#include	<unistd.h>
+#include	<pthread.h>
+#include	<sys/socket.h>
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"imagebytes.h"
+#include	"imagearrayjson.h"
+#include	"socket_listen.h"
+
+//*	each stripe buffer is about this big
+#define	kImageArrayChunkSize	(1024 * 1024)
+
+#define	kMaxEncoderThreads		8
+
+//*	the table entries are copied 16 bytes at a time, the buffers need this much extra at the end
+#define	kTextSlack				16
+
+//*	"[", "]", ",", "\n" around each line
+#define	kLineOverhead			4
+
+//*****************************************************************************
+typedef struct	//	TYPE_NumberText
+{
+	char			text[15];		//*	the number followed by a comma
+	unsigned char	textLen;
+
+} TYPE_NumberText;
+
+//*	value << 8, i.e. "65280,"
+static TYPE_NumberText	gShifted8Text[256];
+//*	value * 0x010101, i.e. "16777215,"
+static TYPE_NumberText	gGray8Text[256];
+static pthread_once_t	gImageArrayInitOnce	=	PTHREAD_ONCE_INIT;
+
+static const char	gDigitPairs[]	=
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+//*****************************************************************************
+typedef struct	//	TYPE_FormatInfo
+{
+	bool	columnMajor;			//*	imagearray = true, rgbarray = false
+	int		srcBytesPerPixel;
+	int		imageBytesFormat;		//*	used to transpose the columns
+	int		maxValueTextLen;		//*	longest text for one pixel, including the comma
+
+} TYPE_FormatInfo;
+
+//*	indexed by kImageArrayJSON_xxx
+static const TYPE_FormatInfo	gFormatInfo[kImageArrayJSON_last]	=
+{
+	{	true,	1,	kImageBytes_Raw8,		6	},	//*	"65280,"
+	{	true,	2,	kImageBytes_Raw16,		6	},	//*	"65535,"
+	{	true,	3,	kImageBytes_BGR24_RGB,	20	},	//*	"[65280,65280,65280],"
+	{	false,	3,	-1,						9	},	//*	"16777215,"
+	{	false,	1,	-1,						9	},
+	{	false,	2,	-1,						9	},
+};
+
+//*****************************************************************************
+typedef struct	//	TYPE_JSONStripe
+{
+	const unsigned char	*src;
+	int					width;
+	int					height;
+	int					format;
+	int					firstLine;
+	int					lineCnt;
+	bool				lastStripe;		//*	the very last line of the image has no trailing comma
+	unsigned char		*scratchBuffer;	//*	transposed columns
+	char				*textBuffer;
+	size_t				textLen;
+
+} TYPE_JSONStripe;
+
+//*****************************************************************************
+//*	the number of digits is worked out first so the digits can go straight into place
+//*****************************************************************************
+static char	*PutUInt(char *textPtr, uint32_t value)
+{
+char	*digitPtr;
+int		digitCnt;
+int		pairIdx;
+
+	if (value < 100)
+	{
+		digitCnt	=	(value < 10) ? 1 : 2;
+	}
+	else if (value < 10000)
+	{
+		digitCnt	=	(value < 1000) ? 3 : 4;
+	}
+	else if (value < 1000000)
+	{
+		digitCnt	=	(value < 100000) ? 5 : 6;
+	}
+	else if (value < 100000000)
+	{
+		digitCnt	=	(value < 10000000) ? 7 : 8;
+	}
+	else
+	{
+		digitCnt	=	(value < 1000000000) ? 9 : 10;
+	}
+	digitPtr	=	textPtr + digitCnt;
+	while (value >= 100)
+	{
+		pairIdx		=	(value % 100) * 2;
+		value		/=	100;
+		digitPtr	-=	2;
+		digitPtr[0]	=	gDigitPairs[pairIdx];
+		digitPtr[1]	=	gDigitPairs[pairIdx + 1];
+	}
+	if (value >= 10)
+	{
+		digitPtr[-2]	=	gDigitPairs[value * 2];
+		digitPtr[-1]	=	gDigitPairs[(value * 2) + 1];
+	}
+	else
+	{
+		digitPtr[-1]	=	'0' + value;
+	}
+	return(textPtr + digitCnt);
+}
+
+//*****************************************************************************
+static void	BuildNumberText(TYPE_NumberText *numberText, uint32_t value)
+{
+char	*textPtr;
+
+	memset(numberText, 0, sizeof(TYPE_NumberText));
+	textPtr		=	PutUInt(numberText->text, value);
+	*textPtr++	=	',';
+	numberText->textLen	=	textPtr - numberText->text;
+}
+
+//*****************************************************************************
+static void	ImageArrayJSON_Init(void)
+{
+int		iii;
+
+	for (iii=0; iii<256; iii++)
+	{
+		BuildNumberText(&gShifted8Text[iii],	(iii << 8));
+		BuildNumberText(&gGray8Text[iii],		(iii * 0x010101));
+	}
+}
+
+//*****************************************************************************
+//*	copies the whole 16 byte entry, only advances by the text length
+//*****************************************************************************
+#define	PUT_TABLE_TEXT(textPtr, numberText)				\
+	{													\
+		memcpy(textPtr, (numberText)->text, 16);		\
+		textPtr	+=	(numberText)->textLen;				\
+	}
+
+//*****************************************************************************
+static void	FormatStripe(TYPE_JSONStripe *stripe)
+{
+const TYPE_FormatInfo	*formatInfo;
+const unsigned char		*pixelPtr;
+const uint16_t			*wordPtr;
+char					*textPtr;
+int						lineIdx;
+int						lineLen;
+int						iii;
+bool					lastLine;
+uint16_t				pixelValue;
+uint32_t				rgbValue;
+
+	formatInfo	=	&gFormatInfo[stripe->format];
+	textPtr		=	stripe->textBuffer;
+	if (formatInfo->columnMajor)
+	{
+		//*	get the columns in order first, then each column is sequential
+		ImageBytes_TransposeColumns(stripe->scratchBuffer,
+									stripe->src,
+									stripe->width,
+									stripe->height,
+									stripe->firstLine,
+									stripe->lineCnt,
+									formatInfo->imageBytesFormat);
+		lineLen	=	stripe->height;
+	}
+	else
+	{
+		lineLen	=	stripe->width;
+	}
+
+	for (lineIdx=0; lineIdx<stripe->lineCnt; lineIdx++)
+	{
+		lastLine	=	stripe->lastStripe && (lineIdx == (stripe->lineCnt - 1));
+		switch(stripe->format)
+		{
+			case kImageArrayJSON_Raw8:
+				pixelPtr	=	stripe->scratchBuffer + ((size_t)lineIdx * lineLen);
+				*textPtr++	=	'[';
+				for (iii=0; iii<lineLen; iii++)
+				{
+					PUT_TABLE_TEXT(textPtr, &gShifted8Text[pixelPtr[iii]]);
+				}
+				break;
+
+			case kImageArrayJSON_Raw16:
+				pixelPtr	=	stripe->scratchBuffer + ((size_t)lineIdx * lineLen * 2);
+				*textPtr++	=	'[';
+				for (iii=0; iii<lineLen; iii++)
+				{
+					//*	ImageBytes output is little endian
+					pixelValue	=	pixelPtr[0] + (pixelPtr[1] << 8);
+					pixelPtr	+=	2;
+					textPtr		=	PutUInt(textPtr, pixelValue);
+					*textPtr++	=	',';
+				}
+				break;
+
+			case kImageArrayJSON_BGR24:
+				//*	already swapped to RGB by the transpose
+				pixelPtr	=	stripe->scratchBuffer + ((size_t)lineIdx * lineLen * 3);
+				*textPtr++	=	'[';
+				for (iii=0; iii<lineLen; iii++)
+				{
+					*textPtr++	=	'[';
+					PUT_TABLE_TEXT(textPtr, &gShifted8Text[pixelPtr[0]]);
+					PUT_TABLE_TEXT(textPtr, &gShifted8Text[pixelPtr[1]]);
+					PUT_TABLE_TEXT(textPtr, &gShifted8Text[pixelPtr[2]]);
+					textPtr[-1]	=	']';
+					*textPtr++	=	',';
+					pixelPtr	+=	3;
+				}
+				break;
+
+			case kImageArrayJSON_RGB_BGR24:
+				pixelPtr	=	stripe->src + ((size_t)(stripe->firstLine + lineIdx) * lineLen * 3);
+				for (iii=0; iii<lineLen; iii++)
+				{
+					rgbValue	=	(pixelPtr[0] << 16) + (pixelPtr[1] << 8) + pixelPtr[2];
+					pixelPtr	+=	3;
+					textPtr		=	PutUInt(textPtr, rgbValue);
+					*textPtr++	=	',';
+				}
+				break;
+
+			case kImageArrayJSON_RGB_Gray8:
+				pixelPtr	=	stripe->src + ((size_t)(stripe->firstLine + lineIdx) * lineLen);
+				for (iii=0; iii<lineLen; iii++)
+				{
+					PUT_TABLE_TEXT(textPtr, &gGray8Text[pixelPtr[iii]]);
+				}
+				break;
+
+			case kImageArrayJSON_RGB_Gray16:
+				wordPtr	=	(const uint16_t *)stripe->src + ((size_t)(stripe->firstLine + lineIdx) * lineLen);
+				for (iii=0; iii<lineLen; iii++)
+				{
+					PUT_TABLE_TEXT(textPtr, &gGray8Text[wordPtr[iii] >> 8]);
+				}
+				break;
+		}
+
+		//*	every value was followed by a comma, fix up the end of the line
+		if (formatInfo->columnMajor)
+		{
+			textPtr[-1]	=	']';
+			if (lastLine == false)
+			{
+				*textPtr++	=	',';
+			}
+			*textPtr++	=	'\n';
+		}
+		else if (lastLine)
+		{
+			textPtr[-1]	=	'\n';
+		}
+		else
+		{
+			*textPtr++	=	'\n';
+		}
+	}
+	stripe->textLen	=	textPtr - stripe->textBuffer;
+}
+
+//*****************************************************************************
+static void	*FormatStripeThread(void *arg)
+{
+	FormatStripe((TYPE_JSONStripe *)arg);
+	return(NULL);
+}
+
+//*****************************************************************************
+long	ImageArrayJSON_Encode(	const unsigned char			*src,
+								int							width,
+								int							height,
+								int							format,
+								int							threadCount,
+								ImageArrayJSON_WriteFunc	writeFunc,
+								void						*userData)
+{
+const TYPE_FormatInfo	*formatInfo;
+TYPE_JSONStripe			stripes[kMaxEncoderThreads];
+pthread_t				threadIDs[kMaxEncoderThreads];
+bool					threadRunning[kMaxEncoderThreads];
+size_t					maxLineLen;
+size_t					textBufferSize;
+size_t					scratchBufferSize;
+long					totalBytesWritten;
+int						lineTotal;
+int						linesPerStripe;
+int						nextLine;
+int						stripeCnt;
+int						threadErr;
+int						iii;
+bool					writeOK;
+
+	if ((src == NULL) || (width <= 0) || (height <= 0) ||
+		(format < 0) || (format >= kImageArrayJSON_last) || (writeFunc == NULL))
+	{
+		CONSOLE_DEBUG("Invalid arguments");
+		return(-1);
+	}
+	pthread_once(&gImageArrayInitOnce, ImageArrayJSON_Init);
+
+	if (threadCount <= 0)
+	{
+		threadCount	=	sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (threadCount < 1)
+	{
+		threadCount	=	1;
+	}
+	if (threadCount > kMaxEncoderThreads)
+	{
+		threadCount	=	kMaxEncoderThreads;
+	}
+
+	formatInfo	=	&gFormatInfo[format];
+	if (formatInfo->columnMajor)
+	{
+		lineTotal	=	width;
+		maxLineLen	=	((size_t)height * formatInfo->maxValueTextLen) + kLineOverhead;
+	}
+	else
+	{
+		lineTotal	=	height;
+		maxLineLen	=	((size_t)width * formatInfo->maxValueTextLen) + kLineOverhead;
+	}
+	linesPerStripe	=	kImageArrayChunkSize / maxLineLen;
+	if (linesPerStripe < 1)
+	{
+		linesPerStripe	=	1;
+	}
+	//*	no point in threads that would have nothing to do
+	if (threadCount > ((lineTotal + linesPerStripe - 1) / linesPerStripe))
+	{
+		threadCount	=	(lineTotal + linesPerStripe - 1) / linesPerStripe;
+	}
+	textBufferSize		=	(linesPerStripe * maxLineLen) + kTextSlack;
+	scratchBufferSize	=	0;
+	if (formatInfo->columnMajor)
+	{
+		scratchBufferSize	=	(size_t)linesPerStripe * height * formatInfo->srcBytesPerPixel;
+	}
+
+	//*	one set of buffers per thread, they are reused for each stripe
+	writeOK	=	true;
+	memset(stripes, 0, sizeof(stripes));
+	for (iii=0; iii<threadCount; iii++)
+	{
+		stripes[iii].src		=	src;
+		stripes[iii].width		=	width;
+		stripes[iii].height		=	height;
+		stripes[iii].format		=	format;
+		stripes[iii].textBuffer	=	(char *)malloc(textBufferSize);
+		if (stripes[iii].textBuffer == NULL)
+		{
+			writeOK	=	false;
+		}
+		if (scratchBufferSize > 0)
+		{
+			stripes[iii].scratchBuffer	=	(unsigned char *)malloc(scratchBufferSize);
+			if (stripes[iii].scratchBuffer == NULL)
+			{
+				writeOK	=	false;
+			}
+		}
+	}
+	if (writeOK == false)
+	{
+		CONSOLE_DEBUG("Failed to allocate memory");
+	}
+
+	totalBytesWritten	=	0;
+	nextLine			=	0;
+	while (writeOK && (nextLine < lineTotal))
+	{
+		//*	hand out the next stripe to each thread
+		stripeCnt	=	0;
+		while ((stripeCnt < threadCount) && (nextLine < lineTotal))
+		{
+			stripes[stripeCnt].firstLine	=	nextLine;
+			stripes[stripeCnt].lineCnt		=	lineTotal - nextLine;
+			if (stripes[stripeCnt].lineCnt > linesPerStripe)
+			{
+				stripes[stripeCnt].lineCnt	=	linesPerStripe;
+			}
+			nextLine						+=	stripes[stripeCnt].lineCnt;
+			stripes[stripeCnt].lastStripe	=	(nextLine >= lineTotal);
+			stripeCnt++;
+		}
+
+		//*	the first stripe is done on this thread
+		for (iii=1; iii<stripeCnt; iii++)
+		{
+			threadErr			=	pthread_create(&threadIDs[iii], NULL, &FormatStripeThread, &stripes[iii]);
+			threadRunning[iii]	=	(threadErr == 0);
+			if (threadErr != 0)
+			{
+				FormatStripe(&stripes[iii]);
+			}
+		}
+		FormatStripe(&stripes[0]);
+
+		//*	send them in order, the later ones keep formatting while the first ones go out
+		for (iii=0; iii<stripeCnt; iii++)
+		{
+			if ((iii > 0) && threadRunning[iii])
+			{
+				pthread_join(threadIDs[iii], NULL);
+			}
+			if (writeOK)
+			{
+				writeOK	=	writeFunc(userData, stripes[iii].textBuffer, stripes[iii].textLen);
+				totalBytesWritten	+=	stripes[iii].textLen;
+			}
+		}
+	}
+
+	for (iii=0; iii<threadCount; iii++)
+	{
+		free(stripes[iii].textBuffer);
+		free(stripes[iii].scratchBuffer);
+	}
+	return(writeOK ? totalBytesWritten : -1);
+}
+
+//*****************************************************************************
+static bool	SendToSocket(void *userData, const char *textPtr, size_t textLen)
+{
+	return(SocketListen_SendAll(*((int *)userData), textPtr, textLen));
+}
+
+//*****************************************************************************
+long	ImageArrayJSON_Send(	int					socketFD,
+								const unsigned char	*src,
+								int					width,
+								int					height,
+								int					format,
+								int					threadCount)
+{
+	return(ImageArrayJSON_Encode(src, width, height, format, threadCount, SendToSocket, &socketFD));
+}
@@ -0,0 +1,74 @@
+//**************************************************************************
+//*	Name:			imagearrayjson.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Fast JSON text encoder for imagearray and rgbarray
+//*
+//*****************************************************************************
+//#include	"imagearrayjson.h"
+
+#ifndef _IMAGEARRAYJSON_H_
+#define	_IMAGEARRAYJSON_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#ifndef _STDDEF_H
+	#include	<stddef.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+enum
+{
+	//*	imagearray, column major, one [...] per column
+	kImageArrayJSON_Raw8	=	0,		//*	8 bit pixels, sent as (value << 8)
+	kImageArrayJSON_Raw16,				//*	16 bit pixels, sent as is
+	kImageArrayJSON_BGR24,				//*	24 bit BGR (openCV order), sent as [R,G,B] each (value << 8)
+
+	//*	rgbarray, row major, one flat list of 0x00RRGGBB values
+	kImageArrayJSON_RGB_BGR24,			//*	24 bit pixels packed as (p[0] << 16) + (p[1] << 8) + p[2]
+	kImageArrayJSON_RGB_Gray8,			//*	8 bit pixels, value * 0x010101
+	kImageArrayJSON_RGB_Gray16,			//*	16 bit pixels, (value >> 8) * 0x010101
+
+	kImageArrayJSON_last
+};
+
+//*	called with each finished chunk of text, in order, return false to stop
+typedef bool (*ImageArrayJSON_WriteFunc)(void *userData, const char *textPtr, size_t textLen);
+
+//*****************************************************************************
+//*	threadCount	0 = one per cpu (up to 8), 1 = do it all on the calling thread
+//*	returns the number of bytes written, -1 on error
+//*****************************************************************************
+long	ImageArrayJSON_Encode(	const unsigned char			*src,
+								int							width,
+								int							height,
+								int							format,
+								int							threadCount,
+								ImageArrayJSON_WriteFunc	writeFunc,
+								void						*userData);
+
+long	ImageArrayJSON_Send(	int							socketFD,
+								const unsigned char			*src,
+								int							width,
+								int							height,
+								int							format,
+								int							threadCount);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif	//	_IMAGEARRAYJSON_H_
@@ -0,0 +1,767 @@
+//*****************************************************************************
+//*
+//*	Name:			imagearrayjsonbench.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Checks and times the JSON imagearray / rgbarray encoder
+//*
+//*	Usage notes:	First the output of ImageArrayJSON_Encode() is compared against the
+//*					original Send_imagearray_xxx() / Send_RGBarray_xxx() code on a set of
+//*					odd sizes. The white space is different, so it is stripped before comparing.
+//*					Then both are timed writing to /dev/null and the frames/sec are reported.
+//*
+//*		imagearrayjsonbench
+//*		imagearrayjsonbench -w 4656 -h 3520 -n 1 -t 4
+//*
+//*		-w	image width (default 1920)
+//*		-h	image height (default 1080)
+//*		-n	number of passes to time, the best one is reported (default 3)
+//*		-t	encoder threads, 0 = one per cpu (default 0)
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created imagearrayjsonbench.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<ctype.h>
+#include	<fcntl.h>
+#include	<time.h>
+#include	<unistd.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"imagearrayjson.h"
+
+typedef void (*TYPE_ReferenceFunc)(int socketFD, const unsigned char *pixelPtr, int width, int height);
+
+//*****************************************************************************
+//*	these are the routines from cameradriver.cpp before the encoder was added,
+//*	the debug output has been taken out, otherwise they are unchanged
+//*****************************************************************************
+static void	Reference_imagearray_raw8(int socketFD, const unsigned char *pixelPtr, int numClms, int numRows)
+{
+int		pixelValue;
+char	lineBuff[256];
+int		xxx;
+int		yyy;
+int		bufLen;
+int		bytesWritten;
+char	longBuffer[2048];
+int		dataElementCnt;
+int		pixelIndex;
+
+	for (xxx=0; xxx < numClms; xxx++)
+	{
+		strcpy(longBuffer, "[");
+		dataElementCnt	=	0;
+		pixelIndex		=	xxx;
+		for (yyy=0; yyy < (numRows - 1); yyy++)
+		{
+			pixelValue		=	((pixelPtr[pixelIndex] & 0x00ff) << 8);
+			sprintf(lineBuff, "%d,", pixelValue);
+			strcat(longBuffer, lineBuff);
+			dataElementCnt++;
+			if (dataElementCnt >= 100)
+			{
+				strcat(longBuffer, "\n");
+				bufLen			=	strlen(longBuffer);
+				bytesWritten	=	write(socketFD, longBuffer, bufLen);
+				dataElementCnt	=	0;
+				longBuffer[0]	=	0;
+			}
+			pixelIndex	+=	numClms;
+		}
+		pixelValue		=	((pixelPtr[pixelIndex] & 0x00ff) << 8);
+		sprintf(lineBuff, "%d]", pixelValue);
+		if (xxx < (numClms - 1))
+		{
+			strcat(lineBuff, ",");
+		}
+		strcat(lineBuff, "\n");
+		strcat(longBuffer, lineBuff);
+		bufLen			=	strlen(longBuffer);
+		bytesWritten	=	write(socketFD, longBuffer, bufLen);
+		if (bytesWritten <= 0)
+		{
+			CONSOLE_DEBUG("Write Error");
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Reference_imagearray_raw16(int socketFD, const unsigned char *bytePtr, int numClms, int numRows)
+{
+const uint16_t	*pixelPtr	=	(const uint16_t *)bytePtr;
+uint32_t		pixelValue;
+char			lineBuff[256];
+int				xxx;
+int				yyy;
+int				bufLen;
+int				bytesWritten;
+char			longBuffer[1024];
+int				dataElementCnt;
+int				pixelIndex;
+
+	for (xxx=0; xxx < numClms; xxx++)
+	{
+		strcpy(longBuffer, "[");
+		dataElementCnt	=	0;
+		pixelIndex		=	xxx;
+		for (yyy=0; yyy < (numRows - 1); yyy++)
+		{
+			pixelValue		=	((pixelPtr[pixelIndex] & 0x0ffff));
+			sprintf(lineBuff, "%d,", pixelValue);
+			strcat(longBuffer, lineBuff);
+			dataElementCnt++;
+			if (dataElementCnt >= 100)
+			{
+				strcat(longBuffer, "\n");
+				bufLen			=	strlen(longBuffer);
+				bytesWritten	=	write(socketFD, longBuffer, bufLen);
+				dataElementCnt	=	0;
+				longBuffer[0]	=	0;
+			}
+			pixelIndex	+=	numClms;
+		}
+		pixelValue		=	((pixelPtr[pixelIndex] & 0x0ffff));
+		sprintf(lineBuff, "%d]", pixelValue);
+		if (xxx < (numClms - 1))
+		{
+			strcat(lineBuff, ",");
+		}
+		strcat(lineBuff, "\n");
+		strcat(longBuffer, lineBuff);
+		bufLen			=	strlen(longBuffer);
+		bytesWritten	=	write(socketFD, longBuffer, bufLen);
+		if (bytesWritten <= 0)
+		{
+			CONSOLE_DEBUG("Write Error");
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Reference_imagearray_rgb24(int socketFD, const unsigned char *pixelPtr, int numClms, int numRows)
+{
+uint32_t	pixelValue_Red;
+uint32_t	pixelValue_Grn;
+uint32_t	pixelValue_Blu;
+char		lineBuff[256];
+int			xxx;
+int			yyy;
+int			bufLen;
+int			bytesWritten;
+char		longBuffer[1024];
+int			dataElementCnt;
+int			pixelIndex;
+
+	for (xxx=0; xxx < numClms; xxx++)
+	{
+		strcpy(longBuffer, "[\n");
+		dataElementCnt	=	0;
+		pixelIndex		=	xxx * 3;
+		for (yyy=0; yyy < numRows; yyy++)
+		{
+			pixelValue_Red		=	((pixelPtr[pixelIndex + 2] & 0x00ff) << 8);
+			pixelValue_Grn		=	((pixelPtr[pixelIndex + 1] & 0x00ff) << 8);
+			pixelValue_Blu		=	((pixelPtr[pixelIndex + 0] & 0x00ff) << 8);
+			sprintf(lineBuff, "[%d,%d,%d]", pixelValue_Red, pixelValue_Grn, pixelValue_Blu);
+			if (yyy < (numRows - 1))
+			{
+				strcat(lineBuff, ",");
+			}
+			strcat(longBuffer, lineBuff);
+			dataElementCnt++;
+			if (dataElementCnt >= 50)
+			{
+				strcat(longBuffer, "\n");
+				bufLen			=	strlen(longBuffer);
+				bytesWritten	=	write(socketFD, longBuffer, bufLen);
+				dataElementCnt	=	0;
+				longBuffer[0]	=	0;
+			}
+			pixelIndex	+=	(3 * numClms);
+		}
+		if (xxx < (numClms - 1))
+		{
+			strcat(longBuffer, "],\n");
+		}
+		else
+		{
+			strcat(longBuffer, "]\n");
+		}
+		bufLen			=	strlen(longBuffer);
+		bytesWritten	=	write(socketFD, longBuffer, bufLen);
+		if (bytesWritten <= 0)
+		{
+			CONSOLE_DEBUG("Write Error");
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Reference_RGBarray_rgb24(int socketFD, const unsigned char *pixelPtr, int width, int height)
+{
+const unsigned char	*myPixelPtr;
+uint32_t			pixelValue;
+char				lineBuff[512];
+int					pixelLimit;
+int					iii;
+int					bufLen;
+int					bytesWritten;
+char				longBuffer[2048];
+int					dataElementCnt;
+
+	pixelLimit		=	(width * height) - 1;
+	myPixelPtr		=	pixelPtr;
+	longBuffer[0]	=	0;
+	dataElementCnt	=	0;
+	for (iii=0; iii < pixelLimit; iii++)
+	{
+		pixelValue		=	((myPixelPtr[0] & 0x00ff) << 16);
+		pixelValue		+=	((myPixelPtr[1] & 0x00ff) << 8);
+		pixelValue		+=	((myPixelPtr[2] & 0x00ff));
+		myPixelPtr		+=	3;
+		sprintf(lineBuff, "%d,\n", pixelValue);
+		strcat(longBuffer, lineBuff);
+		dataElementCnt++;
+		if (dataElementCnt >= 50)
+		{
+			strcat(longBuffer, "\n");
+			bufLen			=	strlen(longBuffer);
+			bytesWritten	=	write(socketFD, longBuffer, bufLen);
+			dataElementCnt	=	0;
+			longBuffer[0]	=	0;
+		}
+	}
+	pixelValue		=	(myPixelPtr[0] << 16) +
+						(myPixelPtr[1] << 8) +
+						(myPixelPtr[2]);
+	sprintf(lineBuff, "%d", pixelValue);
+	strcat(longBuffer, lineBuff);
+	strcat(longBuffer, "\n");
+	bufLen			=	strlen(longBuffer);
+	bytesWritten	=	write(socketFD, longBuffer, bufLen);
+	if (bytesWritten <= 0)
+	{
+		CONSOLE_DEBUG("Write Error");
+	}
+}
+
+//*****************************************************************************
+static void	Reference_RGBarray_raw8(int socketFD, const unsigned char *pixelPtr, int width, int height)
+{
+uint32_t	pixelValue;
+char		lineBuff[256];
+int			pixelLimit;
+int			iii;
+int			bufLen;
+int			bytesWritten;
+char		longBuffer[2000];
+int			dataElementCnt;
+
+	pixelLimit		=	(width * height) - 1;
+	longBuffer[0]	=	0;
+	dataElementCnt	=	0;
+	for (iii=0; iii < pixelLimit; iii++)
+	{
+		pixelValue		=	(pixelPtr[iii] & 0x00ff);
+		pixelValue		=	pixelValue * 0x010101;
+		sprintf(lineBuff, "%d,\n", pixelValue);
+		strcat(longBuffer, lineBuff);
+		dataElementCnt++;
+		if (dataElementCnt >= 25)
+		{
+			bufLen			=	strlen(longBuffer);
+			bytesWritten	=	write(socketFD, longBuffer, bufLen);
+			dataElementCnt	=	0;
+			longBuffer[0]	=	0;
+		}
+	}
+	pixelValue		=	(pixelPtr[iii] & 0x00ff);
+	pixelValue		=	pixelValue * 0x010101;
+	sprintf(lineBuff, "%d", pixelValue);
+	strcat(longBuffer, lineBuff);
+	strcat(longBuffer, "\n");
+	bufLen			=	strlen(longBuffer);
+	bytesWritten	=	write(socketFD, longBuffer, bufLen);
+	if (bytesWritten <= 0)
+	{
+		CONSOLE_DEBUG("Write Error");
+	}
+}
+
+//*****************************************************************************
+//*	the RAW16 case was inline in Get_RGBarray(), it went through JsonResponse_Add_RawText()
+//*	with a 1475 byte buffer. It used the low byte of each pixel, the encoder uses the high byte,
+//*	this uses the high byte so the outputs can be compared.
+//*****************************************************************************
+#define		kBuffSize_MaxSpeed	1475
+
+static void	Reference_RGBarray_raw16(int socketFD, const unsigned char *pixelPtr, int width, int height)
+{
+uint32_t	pixelValue;
+char		lineBuff[256];
+char		jsonTextBuffer[kBuffSize_MaxSpeed + 256];
+int			pixelLimit;
+int			iii;
+int			bytesWritten;
+
+	pixelLimit			=	(width * height) - 1;
+	jsonTextBuffer[0]	=	0;
+	for (iii=0; iii <= pixelLimit; iii++)
+	{
+		pixelValue		=	(pixelPtr[1] & 0x00ff);
+		pixelValue		=	pixelValue * 0x010101;
+		pixelPtr		+=	2;
+		sprintf(lineBuff, ((iii < pixelLimit) ? "%d,\n" : "%d\n"), pixelValue);
+		if ((strlen(jsonTextBuffer) + strlen(lineBuff)) >= kBuffSize_MaxSpeed)
+		{
+			bytesWritten		=	write(socketFD, jsonTextBuffer, strlen(jsonTextBuffer));
+			jsonTextBuffer[0]	=	0;
+		}
+		strcat(jsonTextBuffer, lineBuff);
+	}
+	bytesWritten	=	write(socketFD, jsonTextBuffer, strlen(jsonTextBuffer));
+	if (bytesWritten <= 0)
+	{
+		CONSOLE_DEBUG("Write Error");
+	}
+}
+
+//*****************************************************************************
+typedef struct	//	TYPE_BenchFormat
+{
+	const char			*name;
+	int					encoderFormat;
+	int					srcBytesPerPixel;
+	TYPE_ReferenceFunc	referenceFunc;
+
+} TYPE_BenchFormat;
+
+static const TYPE_BenchFormat	gBenchFormats[]	=
+{
+	{	"imagearray raw8",	kImageArrayJSON_Raw8,		1,	Reference_imagearray_raw8	},
+	{	"imagearray raw16",	kImageArrayJSON_Raw16,		2,	Reference_imagearray_raw16	},
+	{	"imagearray rgb24",	kImageArrayJSON_BGR24,		3,	Reference_imagearray_rgb24	},
+	{	"rgbarray rgb24",	kImageArrayJSON_RGB_BGR24,	3,	Reference_RGBarray_rgb24	},
+	{	"rgbarray raw8",	kImageArrayJSON_RGB_Gray8,	1,	Reference_RGBarray_raw8		},
+	{	"rgbarray raw16",	kImageArrayJSON_RGB_Gray16,	2,	Reference_RGBarray_raw16	},
+};
+#define	kBenchFormatCnt	((int)(sizeof(gBenchFormats) / sizeof(TYPE_BenchFormat)))
+
+static const int	gCheckSizes[][2]	=
+{
+	{	1,		1	},
+	{	1,		7	},
+	{	7,		1	},
+	{	3,		2	},
+	{	17,		15	},
+	{	64,		65	},
+	{	257,	129	},
+	{	1031,	773	},
+	{	2000,	1100	},	//*	more than one stripe per thread for every format
+};
+#define	kCheckSizeCnt	((int)(sizeof(gCheckSizes) / sizeof(gCheckSizes[0])))
+
+static int		gBenchWidth		=	1920;
+static int		gBenchHeight	=	1080;
+static int		gBenchPasses	=	3;
+static int		gBenchThreads	=	0;
+
+//*****************************************************************************
+typedef struct	//	TYPE_TextBuffer
+{
+	char	*textPtr;
+	size_t	textLen;
+	size_t	bufferSize;
+
+} TYPE_TextBuffer;
+
+//*****************************************************************************
+static bool	AppendToBuffer(void *userData, const char *textPtr, size_t textLen)
+{
+TYPE_TextBuffer	*textBuffer	=	(TYPE_TextBuffer *)userData;
+char			*newPtr;
+
+	if ((textBuffer->textLen + textLen) > textBuffer->bufferSize)
+	{
+		textBuffer->bufferSize	=	(textBuffer->textLen + textLen) * 2;
+		newPtr	=	(char *)realloc(textBuffer->textPtr, textBuffer->bufferSize);
+		if (newPtr == NULL)
+		{
+			return(false);
+		}
+		textBuffer->textPtr	=	newPtr;
+	}
+	memcpy(textBuffer->textPtr + textBuffer->textLen, textPtr, textLen);
+	textBuffer->textLen	+=	textLen;
+	return(true);
+}
+
+//*****************************************************************************
+static bool	WriteToFile(void *userData, const char *textPtr, size_t textLen)
+{
+int		fileDesc	=	*((int *)userData);
+ssize_t	bytesWritten;
+
+	while (textLen > 0)
+	{
+		bytesWritten	=	write(fileDesc, textPtr, textLen);
+		if (bytesWritten <= 0)
+		{
+			return(false);
+		}
+		textPtr	+=	bytesWritten;
+		textLen	-=	bytesWritten;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+//*	takes out the white space in place, returns the new length
+//*****************************************************************************
+static size_t	StripWhiteSpace(char *textPtr, size_t textLen)
+{
+size_t	iii;
+size_t	newLen;
+
+	newLen	=	0;
+	for (iii=0; iii<textLen; iii++)
+	{
+		if (isspace((unsigned char)textPtr[iii]) == 0)
+		{
+			textPtr[newLen++]	=	textPtr[iii];
+		}
+	}
+	return(newLen);
+}
+
+//*****************************************************************************
+//*	runs the reference code into a temp file and reads it back
+//*****************************************************************************
+static bool	GetReferenceText(	const TYPE_BenchFormat	*format,
+								const unsigned char		*srcBuffer,
+								int						width,
+								int						height,
+								TYPE_TextBuffer			*textBuffer)
+{
+FILE	*filePointer;
+long	fileLen;
+bool	readOK;
+
+	readOK		=	false;
+	filePointer	=	tmpfile();
+	if (filePointer != NULL)
+	{
+		format->referenceFunc(fileno(filePointer), srcBuffer, width, height);
+		fileLen	=	lseek(fileno(filePointer), 0, SEEK_END);
+		lseek(fileno(filePointer), 0, SEEK_SET);
+		textBuffer->textPtr		=	(char *)malloc(fileLen + 1);
+		textBuffer->bufferSize	=	fileLen + 1;
+		if (textBuffer->textPtr != NULL)
+		{
+			textBuffer->textLen	=	read(fileno(filePointer), textBuffer->textPtr, fileLen);
+			readOK				=	(textBuffer->textLen == (size_t)fileLen);
+		}
+		fclose(filePointer);
+	}
+	return(readOK);
+}
+
+//*****************************************************************************
+//*	returns the number of failures
+//*****************************************************************************
+static int	CheckFormat(const TYPE_BenchFormat *format)
+{
+unsigned char	*srcBuffer;
+size_t			srcLen;
+TYPE_TextBuffer	expectedText;
+TYPE_TextBuffer	singleText;
+TYPE_TextBuffer	threadedText;
+long			encodedLen;
+int				width;
+int				height;
+int				failCnt;
+int				iii;
+size_t			jjj;
+
+	failCnt	=	0;
+	for (iii=0; iii<kCheckSizeCnt; iii++)
+	{
+		width		=	gCheckSizes[iii][0];
+		height		=	gCheckSizes[iii][1];
+		srcLen		=	(size_t)width * height * format->srcBytesPerPixel;
+		srcBuffer	=	(unsigned char *)malloc(srcLen);
+		memset(&expectedText,	0,	sizeof(TYPE_TextBuffer));
+		memset(&singleText,		0,	sizeof(TYPE_TextBuffer));
+		memset(&threadedText,	0,	sizeof(TYPE_TextBuffer));
+		if (srcBuffer != NULL)
+		{
+			for (jjj=0; jjj<srcLen; jjj++)
+			{
+				srcBuffer[jjj]	=	rand() & 0x00ff;
+			}
+			GetReferenceText(format, srcBuffer, width, height, &expectedText);
+			encodedLen	=	ImageArrayJSON_Encode(srcBuffer, width, height, format->encoderFormat, 1, AppendToBuffer, &singleText);
+			ImageArrayJSON_Encode(srcBuffer, width, height, format->encoderFormat, 3, AppendToBuffer, &threadedText);
+
+			//*	the threads have to produce exactly the same text
+			if ((encodedLen != (long)singleText.textLen) ||
+				(singleText.textLen != threadedText.textLen) ||
+				(memcmp(singleText.textPtr, threadedText.textPtr, singleText.textLen) != 0))
+			{
+				printf("FAILED: %-18s %5d x %-5d threaded output is different\n", format->name, width, height);
+				failCnt++;
+			}
+			expectedText.textLen	=	StripWhiteSpace(expectedText.textPtr, expectedText.textLen);
+			singleText.textLen		=	StripWhiteSpace(singleText.textPtr, singleText.textLen);
+			if ((expectedText.textLen == 0) ||
+				(expectedText.textLen != singleText.textLen) ||
+				(memcmp(expectedText.textPtr, singleText.textPtr, expectedText.textLen) != 0))
+			{
+				printf("FAILED: %-18s %5d x %-5d does not match the original\n", format->name, width, height);
+				failCnt++;
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG("Failed to allocate memory");
+			failCnt++;
+		}
+		free(srcBuffer);
+		free(expectedText.textPtr);
+		free(singleText.textPtr);
+		free(threadedText.textPtr);
+	}
+	return(failCnt);
+}
+
+//*****************************************************************************
+static double	GetSeconds(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(timeSpec.tv_sec + (timeSpec.tv_nsec / 1000000000.0));
+}
+
+//*****************************************************************************
+//*	returns the best time for one frame in seconds, useEncoder selects old vs new
+//*	textLen is only set by the encoder, /dev/null does not count what the original wrote
+//*****************************************************************************
+static double	TimeFormat(	const TYPE_BenchFormat	*format,
+							const unsigned char		*srcBuffer,
+							int						nullFD,
+							bool					useEncoder,
+							long					*textLen)
+{
+double	startTime;
+double	elapsedTime;
+double	bestTime;
+int		iii;
+
+	bestTime	=	0.0;
+	for (iii=0; iii<gBenchPasses; iii++)
+	{
+		startTime	=	GetSeconds();
+		if (useEncoder)
+		{
+			*textLen	=	ImageArrayJSON_Encode(	srcBuffer,
+													gBenchWidth,
+													gBenchHeight,
+													format->encoderFormat,
+													gBenchThreads,
+													WriteToFile,
+													&nullFD);
+		}
+		else
+		{
+			format->referenceFunc(nullFD, srcBuffer, gBenchWidth, gBenchHeight);
+		}
+		elapsedTime	=	GetSeconds() - startTime;
+		if ((iii == 0) || (elapsedTime < bestTime))
+		{
+			bestTime	=	elapsedTime;
+		}
+	}
+	return(bestTime);
+}
+
+//*****************************************************************************
+static void	PrintTimeLine(const char *formatName, const char *codeName, const long textLen, const double elapsed_Secs)
+{
+	printf("%-18s %-9s %10.1f %10.3f",	formatName,
+										codeName,
+										(elapsed_Secs * 1000.0),
+										((elapsed_Secs > 0.0) ? (1.0 / elapsed_Secs) : 0.0));
+	if ((textLen > 0) && (elapsed_Secs > 0.0))
+	{
+		printf(" %10.1f", ((textLen / 1.0e6) / elapsed_Secs));
+	}
+	printf("\n");
+}
+
+//*****************************************************************************
+static void	PrintHelp(const char *appName)
+{
+	printf("usage: %s [options]\n", appName);
+	printf("\t-w <width>       image width (default 1920)\n");
+	printf("\t-h <height>      image height (default 1080)\n");
+	printf("\t-n <passes>      number of timed passes, the best is reported (default 3)\n");
+	printf("\t-t <threads>     encoder threads, 0 = one per cpu (default 0)\n");
+}
+
+//*****************************************************************************
+static bool	ProcessCmdLineArgs(int argc, char **argv)
+{
+int			ii;
+char		theChar;
+const char	*argValue;
+
+	ii	=	1;
+	while (ii < argc)
+	{
+		if ((argv[ii][0] == '-') && (argv[ii][1] != 0))
+		{
+			theChar		=	argv[ii][1];
+			argValue	=	NULL;
+			if (argv[ii][2] != 0)
+			{
+				argValue	=	&argv[ii][2];
+			}
+			else if ((ii + 1) < argc)
+			{
+				ii++;
+				argValue	=	argv[ii];
+			}
+			if (argValue == NULL)
+			{
+				PrintHelp(argv[0]);
+				return(false);
+			}
+			switch(theChar)
+			{
+				case 'w':
+					gBenchWidth		=	atoi(argValue);
+					break;
+
+				case 'h':
+					gBenchHeight	=	atoi(argValue);
+					break;
+
+				case 'n':
+					gBenchPasses	=	atoi(argValue);
+					break;
+
+				case 't':
+					gBenchThreads	=	atoi(argValue);
+					break;
+
+				default:
+					PrintHelp(argv[0]);
+					return(false);
+			}
+		}
+		else
+		{
+			PrintHelp(argv[0]);
+			return(false);
+		}
+		ii++;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+unsigned char	*srcBuffer;
+size_t			srcLen;
+size_t			iii;
+int				jjj;
+int				failCnt;
+int				nullFD;
+long			textLen;
+double			originalTime;
+double			encoderTime;
+
+	if (ProcessCmdLineArgs(argc, argv) == false)
+	{
+		return(1);
+	}
+	if ((gBenchWidth <= 0) || (gBenchHeight <= 0) || (gBenchPasses <= 0))
+	{
+		printf("Width, height and passes must be more than 0\n");
+		return(1);
+	}
+	srand(1);
+
+	//*	check the text against the original code
+	failCnt	=	0;
+	for (jjj=0; jjj<kBenchFormatCnt; jjj++)
+	{
+		failCnt	+=	CheckFormat(&gBenchFormats[jjj]);
+	}
+	printf("Output check: %d sizes, %d formats, %d failures\n", kCheckSizeCnt, kBenchFormatCnt, failCnt);
+
+	//*	timing
+	nullFD		=	open("/dev/null", O_WRONLY);
+	srcLen		=	(size_t)gBenchWidth * gBenchHeight * 3;
+	srcBuffer	=	(unsigned char *)malloc(srcLen);
+	if ((srcBuffer != NULL) && (nullFD >= 0))
+	{
+		for (iii=0; iii<srcLen; iii++)
+		{
+			srcBuffer[iii]	=	rand() & 0x00ff;
+		}
+		printf("\n%d x %d, best of %d passes, %d encoder threads (0 = one per cpu)\n",
+								gBenchWidth, gBenchHeight, gBenchPasses, gBenchThreads);
+		printf("%-18s %-9s %10s %10s %10s\n", "format", "code", "ms", "frames/sec", "MB/sec");
+		for (jjj=0; jjj<kBenchFormatCnt; jjj++)
+		{
+			textLen			=	0;
+			originalTime	=	TimeFormat(&gBenchFormats[jjj], srcBuffer, nullFD, false, &textLen);
+			PrintTimeLine(gBenchFormats[jjj].name, "original", textLen, originalTime);
+			encoderTime		=	TimeFormat(&gBenchFormats[jjj], srcBuffer, nullFD, true, &textLen);
+			PrintTimeLine(gBenchFormats[jjj].name, "encoder", textLen, encoderTime);
+			if (encoderTime > 0.0)
+			{
+				printf("%-18s %-9s %9.1fx\n", "", "speedup", (originalTime / encoderTime));
+			}
+		}
+	}
+	else
+	{
+		printf("Failed to allocate memory for a %d x %d image\n", gBenchWidth, gBenchHeight);
+		failCnt++;
+	}
+	free(srcBuffer);
+	if (nullFD >= 0)
+	{
+		close(nullFD);
+	}
+	return((failCnt == 0) ? 0 : 1);
+}
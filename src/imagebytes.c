@@ -0,0 +1,941 @@
+//*****************************************************************************
+//*
+//*	Name:			imagebytes.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Transpose kernels for the Alpaca ImageBytes format
+//*
+//*	Usage notes:	The camera buffers are row major, ImageBytes is column major.
+//*					The old loops walked the source a column at a time, which touches
+//*					a new cache line for every pixel on a large sensor.
+//*					These walk the image in small blocks so both the reads and the writes
+//*					stay in cache.
+//*
+//*					Kernels:
+//*						scalar	blocked transpose, always available, also does the edges for the others
+//*						sse2	16x16 byte / 8x8 word blocks
+//*						avx2	two sse2 sized blocks side by side in one 256 bit register
+//*						neon	8x8 blocks, RGB uses vld3/vst3
+//*
+//*					The best one for the CPU is picked at run time.
+//*					imagebytesbench checks them against the original loops.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created imagebytes.c
+//*	Oct 16,	2026	<MLS> Added blocked scalar, SSE2, AVX2 and NEON transpose kernels
+//*	Oct 16,	2026	<MLS> Added ImageBytes_TransposeColumns() so the image can be sent in chunks
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<pthread.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+	#define	_IMAGEBYTES_X86_
+	#include	<immintrin.h>
+	#define	TARGET_SSE2	__attribute__((target("sse2")))
+	#define	TARGET_AVX2	__attribute__((target("avx2")))
+#endif
+
+#if (defined(__aarch64__) || defined(__ARM_NEON)) && !defined(__ARM_BIG_ENDIAN)
+	#define	_IMAGEBYTES_NEON_
+	#include	<arm_neon.h>
+#endif
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"imagebytes.h"
+
+//*	the scalar kernel works on kTileSize x kTileSize pixel tiles
+#define	kTileSize		64
+
+//*	the SIMD kernels go down kBandRows rows before moving right,
+//*	that way each output row gets a full cache line at a time
+#define	kBandRows		64
+
+//*	srcRowPixels is the width of the whole image, width is the number of columns being transposed
+typedef void (*TYPE_TransposeFunc)(unsigned char *dst, const unsigned char *src, int srcRowPixels, int width, int height, int format);
+
+typedef struct	//	TYPE_ImageBytesKernel
+{
+	const char			*name;
+	TYPE_TransposeFunc	transposeFunc;
+
+} TYPE_ImageBytesKernel;
+
+#define	kMaxImageBytesKernels	4
+
+static TYPE_ImageBytesKernel	gImageBytesKernels[kMaxImageBytesKernels];
+static int						gImageBytesKernelCnt	=	0;
+static int						gImageBytesActiveIdx	=	0;
+static pthread_once_t			gImageBytesInitOnce		=	PTHREAD_ONCE_INIT;
+
+//*	indexed by kImageBytes_xxx
+static const int	gSrcBytesPerPixel[kImageBytes_last]	=	{	1,	1,	1,	2,	2,	3	};
+static const int	gDstBytesPerPixel[kImageBytes_last]	=	{	1,	2,	4,	2,	4,	3	};
+
+//*****************************************************************************
+//*	walks x = xStart..xStop, y = yStart..yStop one tile at a time
+//*	srcIdx and dstIdx are pixel indexes, the inner loop writes sequential output
+//*****************************************************************************
+#define	TILE_LOOP(PIXEL_COPY)																\
+	for (yTile=yStart; yTile<yStop; yTile+=kTileSize)										\
+	{																						\
+		yEnd	=	((yTile + kTileSize) < yStop) ? (yTile + kTileSize) : yStop;			\
+		for (xTile=xStart; xTile<xStop; xTile+=kTileSize)									\
+		{																					\
+			xEnd	=	((xTile + kTileSize) < xStop) ? (xTile + kTileSize) : xStop;		\
+			for (xxx=xTile; xxx<xEnd; xxx++)												\
+			{																				\
+				srcIdx	=	((size_t)yTile * srcRowPixels) + xxx;							\
+				dstIdx	=	((size_t)xxx * height) + yTile;									\
+				for (yyy=yTile; yyy<yEnd; yyy++)											\
+				{																			\
+					PIXEL_COPY;																\
+					srcIdx	+=	srcRowPixels;												\
+					dstIdx++;																\
+				}																			\
+			}																				\
+		}																					\
+	}
+
+//*****************************************************************************
+//*	transposes part of the image, also used for the edges the SIMD blocks do not cover
+//*****************************************************************************
+static void	Scalar_TransposeRange(	unsigned char		*dst,
+									const unsigned char	*src,
+									int					srcRowPixels,
+									int					height,
+									int					xStart,
+									int					xStop,
+									int					yStart,
+									int					yStop,
+									int					format)
+{
+int		xTile;
+int		yTile;
+int		xEnd;
+int		yEnd;
+int		xxx;
+int		yyy;
+size_t	srcIdx;
+size_t	dstIdx;
+
+	switch(format)
+	{
+		case kImageBytes_Raw8:
+			TILE_LOOP(dst[dstIdx]	=	src[srcIdx]);
+			break;
+
+		case kImageBytes_Raw8_16bit:
+			TILE_LOOP(	dst[(dstIdx * 2)]		=	0;
+						dst[(dstIdx * 2) + 1]	=	src[srcIdx]);
+			break;
+
+		case kImageBytes_Raw8_32bit:
+			TILE_LOOP(	dst[(dstIdx * 4)]		=	0;
+						dst[(dstIdx * 4) + 1]	=	src[srcIdx];
+						dst[(dstIdx * 4) + 2]	=	0;
+						dst[(dstIdx * 4) + 3]	=	0);
+			break;
+
+		case kImageBytes_Raw16:
+			TILE_LOOP(	dst[(dstIdx * 2)]		=	src[(srcIdx * 2)];
+						dst[(dstIdx * 2) + 1]	=	src[(srcIdx * 2) + 1]);
+			break;
+
+		case kImageBytes_Raw16_32bit:
+			TILE_LOOP(	dst[(dstIdx * 4)]		=	0;
+						dst[(dstIdx * 4) + 1]	=	0;
+						dst[(dstIdx * 4) + 2]	=	src[(srcIdx * 2)];
+						dst[(dstIdx * 4) + 3]	=	src[(srcIdx * 2) + 1]);
+			break;
+
+		case kImageBytes_BGR24_RGB:
+			//*	openCV uses BGR instead of RGB
+			TILE_LOOP(	dst[(dstIdx * 3)]		=	src[(srcIdx * 3) + 2];
+						dst[(dstIdx * 3) + 1]	=	src[(srcIdx * 3) + 1];
+						dst[(dstIdx * 3) + 2]	=	src[(srcIdx * 3)]);
+			break;
+	}
+}
+
+//*****************************************************************************
+static void	Scalar_Transpose(	unsigned char		*dst,
+								const unsigned char	*src,
+								int					srcRowPixels,
+								int					width,
+								int					height,
+								int					format)
+{
+	Scalar_TransposeRange(dst, src, srcRowPixels, height, 0, width, 0, height, format);
+}
+
+//*****************************************************************************
+//*	runs BLOCK_FUNC over every whole block, then the scalar code does
+//*	the right hand strip and the bottom strip that are left over
+//*****************************************************************************
+#define	BLOCK_LOOP(blockW, blockH, BLOCK_FUNC)												\
+	wFull	=	width - (width % (blockW));													\
+	hFull	=	height - (height % (blockH));												\
+	for (yBand=0; yBand<hFull; yBand+=kBandRows)											\
+	{																						\
+		yBandEnd	=	((yBand + kBandRows) < hFull) ? (yBand + kBandRows) : hFull;		\
+		for (xxx=0; xxx<wFull; xxx+=(blockW))												\
+		{																					\
+			for (yyy=yBand; yyy<yBandEnd; yyy+=(blockH))									\
+			{																				\
+				BLOCK_FUNC;																	\
+			}																				\
+		}																					\
+	}																						\
+	Scalar_TransposeRange(dst, src, srcRowPixels, height, wFull, width, 0, height, format);	\
+	Scalar_TransposeRange(dst, src, srcRowPixels, height, 0, wFull, hFull, height, format);
+
+#ifdef _IMAGEBYTES_X86_
+//*****************************************************************************
+//*	writes one transposed column (16 bytes of 8 bit pixels or 8 words of 16 bit pixels)
+//*	starting at output pixel (column * height + row)
+//*****************************************************************************
+static inline TARGET_SSE2 void	SSE2_StoreColumn(	unsigned char	*dst,
+													int				height,
+													int				column,
+													int				row,
+													__m128i			pixels,
+													int				format)
+{
+size_t	pixelIdx;
+__m128i	zero;
+__m128i	wordsLo;
+__m128i	wordsHi;
+
+	pixelIdx	=	((size_t)column * height) + row;
+	zero		=	_mm_setzero_si128();
+	switch(format)
+	{
+		case kImageBytes_Raw8:
+			_mm_storeu_si128((__m128i *)(dst + pixelIdx), pixels);
+			break;
+
+		case kImageBytes_Raw8_16bit:
+			//*	byte order 0, value
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 2)),			_mm_unpacklo_epi8(zero, pixels));
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 2) + 16),	_mm_unpackhi_epi8(zero, pixels));
+			break;
+
+		case kImageBytes_Raw8_32bit:
+			//*	byte order 0, value, 0, 0
+			wordsLo	=	_mm_unpacklo_epi8(zero, pixels);
+			wordsHi	=	_mm_unpackhi_epi8(zero, pixels);
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 4)),			_mm_unpacklo_epi16(wordsLo, zero));
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 4) + 16),	_mm_unpackhi_epi16(wordsLo, zero));
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 4) + 32),	_mm_unpacklo_epi16(wordsHi, zero));
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 4) + 48),	_mm_unpackhi_epi16(wordsHi, zero));
+			break;
+
+		case kImageBytes_Raw16:
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 2)), pixels);
+			break;
+
+		case kImageBytes_Raw16_32bit:
+			//*	byte order 0, 0, low, high
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 4)),			_mm_unpacklo_epi16(zero, pixels));
+			_mm_storeu_si128((__m128i *)(dst + (pixelIdx * 4) + 16),	_mm_unpackhi_epi16(zero, pixels));
+			break;
+	}
+}
+
+//*****************************************************************************
+//*	16 rows of 16 bytes in, 16 columns of 16 bytes out
+//*****************************************************************************
+static inline TARGET_SSE2 void	SSE2_Transpose16x16_8bit(__m128i rows[16])
+{
+__m128i	aaa[16];
+__m128i	bbb[16];
+int		iii;
+int		base;
+
+	//*	pairs of rows, bytes
+	for (iii=0; iii<16; iii+=2)
+	{
+		aaa[iii]		=	_mm_unpacklo_epi8(rows[iii], rows[iii + 1]);
+		aaa[iii + 1]	=	_mm_unpackhi_epi8(rows[iii], rows[iii + 1]);
+	}
+	//*	groups of 4 rows, words
+	for (base=0; base<16; base+=4)
+	{
+		bbb[base]		=	_mm_unpacklo_epi16(aaa[base],		aaa[base + 2]);
+		bbb[base + 1]	=	_mm_unpackhi_epi16(aaa[base],		aaa[base + 2]);
+		bbb[base + 2]	=	_mm_unpacklo_epi16(aaa[base + 1],	aaa[base + 3]);
+		bbb[base + 3]	=	_mm_unpackhi_epi16(aaa[base + 1],	aaa[base + 3]);
+	}
+	//*	groups of 8 rows, double words
+	for (base=0; base<16; base+=8)
+	{
+		for (iii=0; iii<4; iii++)
+		{
+			aaa[base + (2 * iii)]		=	_mm_unpacklo_epi32(bbb[base + iii], bbb[base + 4 + iii]);
+			aaa[base + (2 * iii) + 1]	=	_mm_unpackhi_epi32(bbb[base + iii], bbb[base + 4 + iii]);
+		}
+	}
+	//*	top and bottom halves, quad words
+	for (iii=0; iii<8; iii++)
+	{
+		rows[2 * iii]		=	_mm_unpacklo_epi64(aaa[iii], aaa[8 + iii]);
+		rows[(2 * iii) + 1]	=	_mm_unpackhi_epi64(aaa[iii], aaa[8 + iii]);
+	}
+}
+
+//*****************************************************************************
+//*	8 rows of 8 words in, 8 columns of 8 words out
+//*****************************************************************************
+static inline TARGET_SSE2 void	SSE2_Transpose8x8_16bit(__m128i rows[8])
+{
+__m128i	aaa[8];
+__m128i	bbb[8];
+int		iii;
+int		base;
+
+	for (iii=0; iii<8; iii+=2)
+	{
+		aaa[iii]		=	_mm_unpacklo_epi16(rows[iii], rows[iii + 1]);
+		aaa[iii + 1]	=	_mm_unpackhi_epi16(rows[iii], rows[iii + 1]);
+	}
+	for (base=0; base<8; base+=4)
+	{
+		bbb[base]		=	_mm_unpacklo_epi32(aaa[base],		aaa[base + 2]);
+		bbb[base + 1]	=	_mm_unpackhi_epi32(aaa[base],		aaa[base + 2]);
+		bbb[base + 2]	=	_mm_unpacklo_epi32(aaa[base + 1],	aaa[base + 3]);
+		bbb[base + 3]	=	_mm_unpackhi_epi32(aaa[base + 1],	aaa[base + 3]);
+	}
+	for (iii=0; iii<4; iii++)
+	{
+		rows[2 * iii]		=	_mm_unpacklo_epi64(bbb[iii], bbb[4 + iii]);
+		rows[(2 * iii) + 1]	=	_mm_unpackhi_epi64(bbb[iii], bbb[4 + iii]);
+	}
+}
+
+//*****************************************************************************
+static inline TARGET_SSE2 void	SSE2_Block_8bit(	unsigned char		*dst,
+													const unsigned char	*src,
+													int					srcRowPixels,
+													int					height,
+													int					xLoc,
+													int					yLoc,
+													int					format)
+{
+__m128i	rows[16];
+int		iii;
+
+	for (iii=0; iii<16; iii++)
+	{
+		rows[iii]	=	_mm_loadu_si128((const __m128i *)(src + ((size_t)(yLoc + iii) * srcRowPixels) + xLoc));
+	}
+	SSE2_Transpose16x16_8bit(rows);
+	for (iii=0; iii<16; iii++)
+	{
+		SSE2_StoreColumn(dst, height, (xLoc + iii), yLoc, rows[iii], format);
+	}
+}
+
+//*****************************************************************************
+static inline TARGET_SSE2 void	SSE2_Block_16bit(	unsigned char		*dst,
+													const unsigned char	*src,
+													int					srcRowPixels,
+													int					height,
+													int					xLoc,
+													int					yLoc,
+													int					format)
+{
+__m128i	rows[8];
+int		iii;
+
+	for (iii=0; iii<8; iii++)
+	{
+		rows[iii]	=	_mm_loadu_si128((const __m128i *)(src + ((((size_t)(yLoc + iii) * srcRowPixels) + xLoc) * 2)));
+	}
+	SSE2_Transpose8x8_16bit(rows);
+	for (iii=0; iii<8; iii++)
+	{
+		SSE2_StoreColumn(dst, height, (xLoc + iii), yLoc, rows[iii], format);
+	}
+}
+
+//*****************************************************************************
+static TARGET_SSE2 void	SSE2_Transpose(	unsigned char		*dst,
+										const unsigned char	*src,
+										int					srcRowPixels,
+										int					width,
+										int					height,
+										int					format)
+{
+int		xxx;
+int		yyy;
+int		yBand;
+int		yBandEnd;
+int		wFull;
+int		hFull;
+
+	switch(format)
+	{
+		case kImageBytes_Raw8:
+		case kImageBytes_Raw8_16bit:
+		case kImageBytes_Raw8_32bit:
+			BLOCK_LOOP(16, 16, SSE2_Block_8bit(dst, src, srcRowPixels, height, xxx, yyy, format));
+			break;
+
+		case kImageBytes_Raw16:
+		case kImageBytes_Raw16_32bit:
+			BLOCK_LOOP(8, 8, SSE2_Block_16bit(dst, src, srcRowPixels, height, xxx, yyy, format));
+			break;
+
+		default:
+			//*	3 byte pixels do not fit the unpack instructions, the blocked scalar code is used
+			Scalar_Transpose(dst, src, srcRowPixels, width, height, format);
+			break;
+	}
+}
+
+//*****************************************************************************
+//*	the AVX2 unpack instructions work on each 128 bit lane separately,
+//*	so the SSE2 sequence transposes two blocks side by side
+//*****************************************************************************
+static inline TARGET_AVX2 void	AVX2_Block_8bit(	unsigned char		*dst,
+													const unsigned char	*src,
+													int					srcRowPixels,
+													int					height,
+													int					xLoc,
+													int					yLoc,
+													int					format)
+{
+__m256i	rows[16];
+__m256i	aaa[16];
+__m256i	bbb[16];
+int		iii;
+int		base;
+
+	for (iii=0; iii<16; iii++)
+	{
+		rows[iii]	=	_mm256_loadu_si256((const __m256i *)(src + ((size_t)(yLoc + iii) * srcRowPixels) + xLoc));
+	}
+	for (iii=0; iii<16; iii+=2)
+	{
+		aaa[iii]		=	_mm256_unpacklo_epi8(rows[iii], rows[iii + 1]);
+		aaa[iii + 1]	=	_mm256_unpackhi_epi8(rows[iii], rows[iii + 1]);
+	}
+	for (base=0; base<16; base+=4)
+	{
+		bbb[base]		=	_mm256_unpacklo_epi16(aaa[base],		aaa[base + 2]);
+		bbb[base + 1]	=	_mm256_unpackhi_epi16(aaa[base],		aaa[base + 2]);
+		bbb[base + 2]	=	_mm256_unpacklo_epi16(aaa[base + 1],	aaa[base + 3]);
+		bbb[base + 3]	=	_mm256_unpackhi_epi16(aaa[base + 1],	aaa[base + 3]);
+	}
+	for (base=0; base<16; base+=8)
+	{
+		for (iii=0; iii<4; iii++)
+		{
+			aaa[base + (2 * iii)]		=	_mm256_unpacklo_epi32(bbb[base + iii], bbb[base + 4 + iii]);
+			aaa[base + (2 * iii) + 1]	=	_mm256_unpackhi_epi32(bbb[base + iii], bbb[base + 4 + iii]);
+		}
+	}
+	for (iii=0; iii<8; iii++)
+	{
+		rows[2 * iii]		=	_mm256_unpacklo_epi64(aaa[iii], aaa[8 + iii]);
+		rows[(2 * iii) + 1]	=	_mm256_unpackhi_epi64(aaa[iii], aaa[8 + iii]);
+	}
+	//*	the low lane has columns xLoc..xLoc+15, the high lane xLoc+16..xLoc+31
+	for (iii=0; iii<16; iii++)
+	{
+		SSE2_StoreColumn(dst, height, (xLoc + iii),			yLoc, _mm256_castsi256_si128(rows[iii]),		format);
+		SSE2_StoreColumn(dst, height, (xLoc + 16 + iii),	yLoc, _mm256_extracti128_si256(rows[iii], 1),	format);
+	}
+}
+
+//*****************************************************************************
+static inline TARGET_AVX2 void	AVX2_Block_16bit(	unsigned char		*dst,
+													const unsigned char	*src,
+													int					srcRowPixels,
+													int					height,
+													int					xLoc,
+													int					yLoc,
+													int					format)
+{
+__m256i	rows[8];
+__m256i	aaa[8];
+__m256i	bbb[8];
+int		iii;
+int		base;
+
+	for (iii=0; iii<8; iii++)
+	{
+		rows[iii]	=	_mm256_loadu_si256((const __m256i *)(src + ((((size_t)(yLoc + iii) * srcRowPixels) + xLoc) * 2)));
+	}
+	for (iii=0; iii<8; iii+=2)
+	{
+		aaa[iii]		=	_mm256_unpacklo_epi16(rows[iii], rows[iii + 1]);
+		aaa[iii + 1]	=	_mm256_unpackhi_epi16(rows[iii], rows[iii + 1]);
+	}
+	for (base=0; base<8; base+=4)
+	{
+		bbb[base]		=	_mm256_unpacklo_epi32(aaa[base],		aaa[base + 2]);
+		bbb[base + 1]	=	_mm256_unpackhi_epi32(aaa[base],		aaa[base + 2]);
+		bbb[base + 2]	=	_mm256_unpacklo_epi32(aaa[base + 1],	aaa[base + 3]);
+		bbb[base + 3]	=	_mm256_unpackhi_epi32(aaa[base + 1],	aaa[base + 3]);
+	}
+	for (iii=0; iii<4; iii++)
+	{
+		rows[2 * iii]		=	_mm256_unpacklo_epi64(bbb[iii], bbb[4 + iii]);
+		rows[(2 * iii) + 1]	=	_mm256_unpackhi_epi64(bbb[iii], bbb[4 + iii]);
+	}
+	//*	the low lane has columns xLoc..xLoc+7, the high lane xLoc+8..xLoc+15
+	for (iii=0; iii<8; iii++)
+	{
+		SSE2_StoreColumn(dst, height, (xLoc + iii),		yLoc, _mm256_castsi256_si128(rows[iii]),		format);
+		SSE2_StoreColumn(dst, height, (xLoc + 8 + iii),	yLoc, _mm256_extracti128_si256(rows[iii], 1),	format);
+	}
+}
+
+//*****************************************************************************
+static TARGET_AVX2 void	AVX2_Transpose(	unsigned char		*dst,
+										const unsigned char	*src,
+										int					srcRowPixels,
+										int					width,
+										int					height,
+										int					format)
+{
+int		xxx;
+int		yyy;
+int		yBand;
+int		yBandEnd;
+int		wFull;
+int		hFull;
+
+	switch(format)
+	{
+		case kImageBytes_Raw8:
+		case kImageBytes_Raw8_16bit:
+		case kImageBytes_Raw8_32bit:
+			BLOCK_LOOP(32, 16, AVX2_Block_8bit(dst, src, srcRowPixels, height, xxx, yyy, format));
+			break;
+
+		case kImageBytes_Raw16:
+		case kImageBytes_Raw16_32bit:
+			BLOCK_LOOP(16, 8, AVX2_Block_16bit(dst, src, srcRowPixels, height, xxx, yyy, format));
+			break;
+
+		default:
+			Scalar_Transpose(dst, src, srcRowPixels, width, height, format);
+			break;
+	}
+}
+#endif	//	_IMAGEBYTES_X86_
+
+#ifdef _IMAGEBYTES_NEON_
+//*****************************************************************************
+//*	8 rows of 8 bytes in, 8 columns of 8 bytes out
+//*****************************************************************************
+static inline void	NEON_Transpose8x8_8bit(uint8x8_t rows[8])
+{
+uint8x8x2_t		t01;
+uint8x8x2_t		t23;
+uint8x8x2_t		t45;
+uint8x8x2_t		t67;
+uint16x4x2_t	u02;
+uint16x4x2_t	u13;
+uint16x4x2_t	u46;
+uint16x4x2_t	u57;
+uint32x2x2_t	v04;
+uint32x2x2_t	v15;
+uint32x2x2_t	v26;
+uint32x2x2_t	v37;
+
+	t01		=	vtrn_u8(rows[0], rows[1]);
+	t23		=	vtrn_u8(rows[2], rows[3]);
+	t45		=	vtrn_u8(rows[4], rows[5]);
+	t67		=	vtrn_u8(rows[6], rows[7]);
+
+	u02		=	vtrn_u16(vreinterpret_u16_u8(t01.val[0]), vreinterpret_u16_u8(t23.val[0]));
+	u13		=	vtrn_u16(vreinterpret_u16_u8(t01.val[1]), vreinterpret_u16_u8(t23.val[1]));
+	u46		=	vtrn_u16(vreinterpret_u16_u8(t45.val[0]), vreinterpret_u16_u8(t67.val[0]));
+	u57		=	vtrn_u16(vreinterpret_u16_u8(t45.val[1]), vreinterpret_u16_u8(t67.val[1]));
+
+	v04		=	vtrn_u32(vreinterpret_u32_u16(u02.val[0]), vreinterpret_u32_u16(u46.val[0]));
+	v26		=	vtrn_u32(vreinterpret_u32_u16(u02.val[1]), vreinterpret_u32_u16(u46.val[1]));
+	v15		=	vtrn_u32(vreinterpret_u32_u16(u13.val[0]), vreinterpret_u32_u16(u57.val[0]));
+	v37		=	vtrn_u32(vreinterpret_u32_u16(u13.val[1]), vreinterpret_u32_u16(u57.val[1]));
+
+	rows[0]	=	vreinterpret_u8_u32(v04.val[0]);
+	rows[1]	=	vreinterpret_u8_u32(v15.val[0]);
+	rows[2]	=	vreinterpret_u8_u32(v26.val[0]);
+	rows[3]	=	vreinterpret_u8_u32(v37.val[0]);
+	rows[4]	=	vreinterpret_u8_u32(v04.val[1]);
+	rows[5]	=	vreinterpret_u8_u32(v15.val[1]);
+	rows[6]	=	vreinterpret_u8_u32(v26.val[1]);
+	rows[7]	=	vreinterpret_u8_u32(v37.val[1]);
+}
+
+//*****************************************************************************
+//*	8 rows of 8 words in, 8 columns of 8 words out
+//*****************************************************************************
+static inline void	NEON_Transpose8x8_16bit(uint16x8_t rows[8])
+{
+uint16x8x2_t	t01;
+uint16x8x2_t	t23;
+uint16x8x2_t	t45;
+uint16x8x2_t	t67;
+uint32x4x2_t	u02;
+uint32x4x2_t	u13;
+uint32x4x2_t	u46;
+uint32x4x2_t	u57;
+
+	t01		=	vtrnq_u16(rows[0], rows[1]);
+	t23		=	vtrnq_u16(rows[2], rows[3]);
+	t45		=	vtrnq_u16(rows[4], rows[5]);
+	t67		=	vtrnq_u16(rows[6], rows[7]);
+
+	//*	each of these has one column in the low half and the column 4 to the right in the high half
+	u02		=	vtrnq_u32(vreinterpretq_u32_u16(t01.val[0]), vreinterpretq_u32_u16(t23.val[0]));
+	u13		=	vtrnq_u32(vreinterpretq_u32_u16(t01.val[1]), vreinterpretq_u32_u16(t23.val[1]));
+	u46		=	vtrnq_u32(vreinterpretq_u32_u16(t45.val[0]), vreinterpretq_u32_u16(t67.val[0]));
+	u57		=	vtrnq_u32(vreinterpretq_u32_u16(t45.val[1]), vreinterpretq_u32_u16(t67.val[1]));
+
+	rows[0]	=	vreinterpretq_u16_u32(vcombine_u32(vget_low_u32(u02.val[0]),	vget_low_u32(u46.val[0])));
+	rows[1]	=	vreinterpretq_u16_u32(vcombine_u32(vget_low_u32(u13.val[0]),	vget_low_u32(u57.val[0])));
+	rows[2]	=	vreinterpretq_u16_u32(vcombine_u32(vget_low_u32(u02.val[1]),	vget_low_u32(u46.val[1])));
+	rows[3]	=	vreinterpretq_u16_u32(vcombine_u32(vget_low_u32(u13.val[1]),	vget_low_u32(u57.val[1])));
+	rows[4]	=	vreinterpretq_u16_u32(vcombine_u32(vget_high_u32(u02.val[0]),	vget_high_u32(u46.val[0])));
+	rows[5]	=	vreinterpretq_u16_u32(vcombine_u32(vget_high_u32(u13.val[0]),	vget_high_u32(u57.val[0])));
+	rows[6]	=	vreinterpretq_u16_u32(vcombine_u32(vget_high_u32(u02.val[1]),	vget_high_u32(u46.val[1])));
+	rows[7]	=	vreinterpretq_u16_u32(vcombine_u32(vget_high_u32(u13.val[1]),	vget_high_u32(u57.val[1])));
+}
+
+//*****************************************************************************
+static inline void	NEON_Block_8bit(	unsigned char		*dst,
+										const unsigned char	*src,
+										int					srcRowPixels,
+										int					height,
+										int					xLoc,
+										int					yLoc,
+										int					format)
+{
+uint8x8_t	rows[8];
+uint16x8_t	words;
+size_t		pixelIdx;
+int			iii;
+
+	for (iii=0; iii<8; iii++)
+	{
+		rows[iii]	=	vld1_u8(src + ((size_t)(yLoc + iii) * srcRowPixels) + xLoc);
+	}
+	NEON_Transpose8x8_8bit(rows);
+	for (iii=0; iii<8; iii++)
+	{
+		pixelIdx	=	((size_t)(xLoc + iii) * height) + yLoc;
+		switch(format)
+		{
+			case kImageBytes_Raw8:
+				vst1_u8(dst + pixelIdx, rows[iii]);
+				break;
+
+			case kImageBytes_Raw8_16bit:
+				words	=	vshlq_n_u16(vmovl_u8(rows[iii]), 8);
+				vst1q_u8(dst + (pixelIdx * 2), vreinterpretq_u8_u16(words));
+				break;
+
+			case kImageBytes_Raw8_32bit:
+				words	=	vshlq_n_u16(vmovl_u8(rows[iii]), 8);
+				vst1q_u8(dst + (pixelIdx * 4),		vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(words))));
+				vst1q_u8(dst + (pixelIdx * 4) + 16,	vreinterpretq_u8_u32(vmovl_u16(vget_high_u16(words))));
+				break;
+		}
+	}
+}
+
+//*****************************************************************************
+static inline void	NEON_Block_16bit(	unsigned char		*dst,
+										const unsigned char	*src,
+										int					srcRowPixels,
+										int					height,
+										int					xLoc,
+										int					yLoc,
+										int					format)
+{
+uint16x8_t	rows[8];
+size_t		pixelIdx;
+int			iii;
+
+	for (iii=0; iii<8; iii++)
+	{
+		rows[iii]	=	vreinterpretq_u16_u8(vld1q_u8(src + ((((size_t)(yLoc + iii) * srcRowPixels) + xLoc) * 2)));
+	}
+	NEON_Transpose8x8_16bit(rows);
+	for (iii=0; iii<8; iii++)
+	{
+		pixelIdx	=	((size_t)(xLoc + iii) * height) + yLoc;
+		switch(format)
+		{
+			case kImageBytes_Raw16:
+				vst1q_u8(dst + (pixelIdx * 2), vreinterpretq_u8_u16(rows[iii]));
+				break;
+
+			case kImageBytes_Raw16_32bit:
+				vst1q_u8(dst + (pixelIdx * 4),
+						vreinterpretq_u8_u32(vshlq_n_u32(vmovl_u16(vget_low_u16(rows[iii])), 16)));
+				vst1q_u8(dst + (pixelIdx * 4) + 16,
+						vreinterpretq_u8_u32(vshlq_n_u32(vmovl_u16(vget_high_u16(rows[iii])), 16)));
+				break;
+		}
+	}
+}
+
+//*****************************************************************************
+//*	vld3 splits the pixels into blue, green and red, each one gets transposed
+//*	and vst3 puts them back together in RGB order
+//*****************************************************************************
+static inline void	NEON_Block_BGR24(	unsigned char		*dst,
+										const unsigned char	*src,
+										int					srcRowPixels,
+										int					height,
+										int					xLoc,
+										int					yLoc)
+{
+uint8x8x3_t	pixels;
+uint8x8_t	blue[8];
+uint8x8_t	green[8];
+uint8x8_t	red[8];
+size_t		pixelIdx;
+int			iii;
+
+	for (iii=0; iii<8; iii++)
+	{
+		pixels		=	vld3_u8(src + ((((size_t)(yLoc + iii) * srcRowPixels) + xLoc) * 3));
+		blue[iii]	=	pixels.val[0];
+		green[iii]	=	pixels.val[1];
+		red[iii]	=	pixels.val[2];
+	}
+	NEON_Transpose8x8_8bit(blue);
+	NEON_Transpose8x8_8bit(green);
+	NEON_Transpose8x8_8bit(red);
+	for (iii=0; iii<8; iii++)
+	{
+		pixelIdx		=	((size_t)(xLoc + iii) * height) + yLoc;
+		pixels.val[0]	=	red[iii];
+		pixels.val[1]	=	green[iii];
+		pixels.val[2]	=	blue[iii];
+		vst3_u8(dst + (pixelIdx * 3), pixels);
+	}
+}
+
+//*****************************************************************************
+static void	NEON_Transpose(	unsigned char		*dst,
+							const unsigned char	*src,
+							int					srcRowPixels,
+							int					width,
+							int					height,
+							int					format)
+{
+int		xxx;
+int		yyy;
+int		yBand;
+int		yBandEnd;
+int		wFull;
+int		hFull;
+
+	switch(format)
+	{
+		case kImageBytes_Raw8:
+		case kImageBytes_Raw8_16bit:
+		case kImageBytes_Raw8_32bit:
+			BLOCK_LOOP(8, 8, NEON_Block_8bit(dst, src, srcRowPixels, height, xxx, yyy, format));
+			break;
+
+		case kImageBytes_Raw16:
+		case kImageBytes_Raw16_32bit:
+			BLOCK_LOOP(8, 8, NEON_Block_16bit(dst, src, srcRowPixels, height, xxx, yyy, format));
+			break;
+
+		case kImageBytes_BGR24_RGB:
+			BLOCK_LOOP(8, 8, NEON_Block_BGR24(dst, src, srcRowPixels, height, xxx, yyy));
+			break;
+	}
+}
+#endif	//	_IMAGEBYTES_NEON_
+
+//*****************************************************************************
+static void	AddKernel(const char *name, TYPE_TransposeFunc transposeFunc)
+{
+	if (gImageBytesKernelCnt < kMaxImageBytesKernels)
+	{
+		gImageBytesKernels[gImageBytesKernelCnt].name			=	name;
+		gImageBytesKernels[gImageBytesKernelCnt].transposeFunc	=	transposeFunc;
+		gImageBytesKernelCnt++;
+	}
+}
+
+//*****************************************************************************
+//*	the list is in order of preference, the last one is the default
+//*****************************************************************************
+static void	ImageBytes_Init(void)
+{
+	AddKernel("scalar",	Scalar_Transpose);
+
+#ifdef _IMAGEBYTES_X86_
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+	{
+		AddKernel("sse2",	SSE2_Transpose);
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		AddKernel("avx2",	AVX2_Transpose);
+	}
+#endif
+
+#ifdef _IMAGEBYTES_NEON_
+	AddKernel("neon",	NEON_Transpose);
+#endif
+	gImageBytesActiveIdx	=	gImageBytesKernelCnt - 1;
+	CONSOLE_DEBUG_W_STR("ImageBytes kernel\t=", gImageBytesKernels[gImageBytesActiveIdx].name);
+}
+
+//*****************************************************************************
+//*	transposes columns startColumn .. startColumn + columnCnt - 1 of the image,
+//*	dst gets (columnCnt * height) output pixels starting with startColumn
+//*****************************************************************************
+void	ImageBytes_TransposeColumns(	unsigned char		*dst,
+										const unsigned char	*src,
+										int					width,
+										int					height,
+										int					startColumn,
+										int					columnCnt,
+										int					format)
+{
+	pthread_once(&gImageBytesInitOnce, ImageBytes_Init);
+	if ((format >= 0) && (format < kImageBytes_last) &&
+		(startColumn >= 0) && (columnCnt > 0) && ((startColumn + columnCnt) <= width) && (height > 0))
+	{
+		gImageBytesKernels[gImageBytesActiveIdx].transposeFunc(	dst,
+																src + ((size_t)startColumn * gSrcBytesPerPixel[format]),
+																width,
+																columnCnt,
+																height,
+																format);
+	}
+}
+
+//*****************************************************************************
+int	ImageBytes_GetOutputBytesPerPixel(const int format)
+{
+int		bytesPerPixel	=	0;
+
+	if ((format >= 0) && (format < kImageBytes_last))
+	{
+		bytesPerPixel	=	gDstBytesPerPixel[format];
+	}
+	return(bytesPerPixel);
+}
+
+//*****************************************************************************
+void	ImageBytes_Raw8(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+	ImageBytes_TransposeColumns(dst, src, width, height, 0, width, kImageBytes_Raw8);
+}
+
+//*****************************************************************************
+void	ImageBytes_Raw8_16bit(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+	ImageBytes_TransposeColumns(dst, src, width, height, 0, width, kImageBytes_Raw8_16bit);
+}
+
+//*****************************************************************************
+void	ImageBytes_Raw8_32bit(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+	ImageBytes_TransposeColumns(dst, src, width, height, 0, width, kImageBytes_Raw8_32bit);
+}
+
+//*****************************************************************************
+void	ImageBytes_Raw16(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+	ImageBytes_TransposeColumns(dst, src, width, height, 0, width, kImageBytes_Raw16);
+}
+
+//*****************************************************************************
+void	ImageBytes_Raw16_32bit(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+	ImageBytes_TransposeColumns(dst, src, width, height, 0, width, kImageBytes_Raw16_32bit);
+}
+
+//*****************************************************************************
+void	ImageBytes_BGR24_RGB(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+	ImageBytes_TransposeColumns(dst, src, width, height, 0, width, kImageBytes_BGR24_RGB);
+}
+
+//*****************************************************************************
+const char	*ImageBytes_GetKernelName(void)
+{
+	pthread_once(&gImageBytesInitOnce, ImageBytes_Init);
+	return(gImageBytesKernels[gImageBytesActiveIdx].name);
+}
+
+//*****************************************************************************
+int	ImageBytes_GetKernelCount(void)
+{
+	pthread_once(&gImageBytesInitOnce, ImageBytes_Init);
+	return(gImageBytesKernelCnt);
+}
+
+//*****************************************************************************
+const char	*ImageBytes_GetKernelNameByIndex(const int kernelIndex)
+{
+const char	*kernelName	=	NULL;
+
+	pthread_once(&gImageBytesInitOnce, ImageBytes_Init);
+	if ((kernelIndex >= 0) && (kernelIndex < gImageBytesKernelCnt))
+	{
+		kernelName	=	gImageBytesKernels[kernelIndex].name;
+	}
+	return(kernelName);
+}
+
+//*****************************************************************************
+//*	returns true if the kernel is available on this CPU
+//*****************************************************************************
+bool	ImageBytes_SelectKernel(const char *kernelName)
+{
+bool	foundIt	=	false;
+int		iii;
+
+	pthread_once(&gImageBytesInitOnce, ImageBytes_Init);
+	for (iii=0; iii<gImageBytesKernelCnt; iii++)
+	{
+		if (strcmp(kernelName, gImageBytesKernels[iii].name) == 0)
+		{
+			gImageBytesActiveIdx	=	iii;
+			foundIt					=	true;
+			break;
+		}
+	}
+	return(foundIt);
+}
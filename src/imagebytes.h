@@ -0,0 +1,86 @@
+//**************************************************************************
+//*	Name:			imagebytes.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Transpose kernels for the Alpaca ImageBytes format
+//*
+//*****************************************************************************
+//#include	"imagebytes.h"
+
+#ifndef _IMAGEBYTES_H_
+#define	_IMAGEBYTES_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+enum
+{
+	kImageBytes_Raw8	=	0,		//*	8 bit pixels, sent as 8 bit
+	kImageBytes_Raw8_16bit,			//*	8 bit pixels, sent as 16 bit (value << 8)
+	kImageBytes_Raw8_32bit,			//*	8 bit pixels, sent as 32 bit (value << 8)
+	kImageBytes_Raw16,				//*	16 bit pixels, sent as 16 bit
+	kImageBytes_Raw16_32bit,		//*	16 bit pixels, sent as 32 bit (value << 16)
+	kImageBytes_BGR24_RGB,			//*	24 bit BGR (openCV order) pixels, sent as RGB bytes
+
+	kImageBytes_last
+};
+
+//*****************************************************************************
+//*	The camera buffers are row major (y * width + x), ImageBytes wants the
+//*	data column major (x * height + y), so every one of these is a transpose.
+//*	The output is always little endian, the destination does not need to be aligned.
+//*****************************************************************************
+
+//*	8 bit pixels, sent as 8 bit
+void	ImageBytes_Raw8(		unsigned char *dst, const unsigned char *src, int width, int height);
+
+//*	8 bit pixels, sent as 16 bit (value << 8)
+void	ImageBytes_Raw8_16bit(	unsigned char *dst, const unsigned char *src, int width, int height);
+
+//*	8 bit pixels, sent as 32 bit (value << 8)
+void	ImageBytes_Raw8_32bit(	unsigned char *dst, const unsigned char *src, int width, int height);
+
+//*	16 bit pixels, sent as 16 bit
+void	ImageBytes_Raw16(		unsigned char *dst, const unsigned char *src, int width, int height);
+
+//*	16 bit pixels, sent as 32 bit (value << 16)
+void	ImageBytes_Raw16_32bit(	unsigned char *dst, const unsigned char *src, int width, int height);
+
+//*	24 bit BGR (openCV order) pixels, sent as RGB bytes
+void	ImageBytes_BGR24_RGB(	unsigned char *dst, const unsigned char *src, int width, int height);
+
+//*	the image can be done a few columns at a time so it can be sent while it is converted,
+//*	dst gets (columnCnt * height) pixels
+void	ImageBytes_TransposeColumns(	unsigned char		*dst,
+										const unsigned char	*src,
+										int					width,
+										int					height,
+										int					startColumn,
+										int					columnCnt,
+										int					format);
+int		ImageBytes_GetOutputBytesPerPixel(const int format);
+
+//*	kernel selection, the best one for this CPU is picked the first time any of the above is called
+const char	*ImageBytes_GetKernelName(void);
+int			ImageBytes_GetKernelCount(void);
+const char	*ImageBytes_GetKernelNameByIndex(const int kernelIndex);
+bool		ImageBytes_SelectKernel(const char *kernelName);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif	//	_IMAGEBYTES_H_
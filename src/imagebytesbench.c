@@ -0,0 +1,545 @@
+//*****************************************************************************
+//*
+//*	Name:			imagebytesbench.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Checks and times the ImageBytes transpose kernels
+//*
+//*	Usage notes:	First every kernel available on this CPU is compared byte for byte
+//*					against the original BuildBinaryImage loops on a set of odd sizes,
+//*					then each one is timed on a full size frame.
+//*					GB/sec is ImageBytes payload written per second.
+//*
+//*		imagebytesbench
+//*		imagebytesbench -w 9576 -h 6388 -n 10
+//*
+//*		-w	image width (default 6248)
+//*		-h	image height (default 4176)
+//*		-n	number of passes to time, the best one is reported (default 5)
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created imagebytesbench.c
+//*	Oct 16,	2026	<MLS> Also checks ImageBytes_TransposeColumns() a chunk at a time
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<time.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"imagebytes.h"
+
+typedef void (*TYPE_ImageBytesFunc)(unsigned char *dst, const unsigned char *src, int width, int height);
+
+//*****************************************************************************
+//*	these are the loops from cameradriver.cpp before the kernels were added,
+//*	x on the outside, y on the inside, one byte at a time
+//*****************************************************************************
+static void	Reference_Raw8(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+int		xxx;
+int		yyy;
+int		ccc;
+int		pixelIndex;
+
+	ccc	=	0;
+	for (xxx=0; xxx<width; xxx++)
+	{
+		pixelIndex	=	xxx;
+		for (yyy=0; yyy<height; yyy++)
+		{
+			dst[ccc++]	=	src[pixelIndex];
+			pixelIndex	+=	width;
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Reference_Raw8_16bit(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+int		xxx;
+int		yyy;
+int		ccc;
+int		pixelIndex;
+
+	ccc	=	0;
+	for (xxx=0; xxx<width; xxx++)
+	{
+		pixelIndex	=	xxx;
+		for (yyy=0; yyy<height; yyy++)
+		{
+			dst[ccc++]	=	0;
+			dst[ccc++]	=	src[pixelIndex];
+			pixelIndex	+=	width;
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Reference_Raw8_32bit(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+int		xxx;
+int		yyy;
+int		ccc;
+int		pixelIndex;
+
+	ccc	=	0;
+	for (xxx=0; xxx<width; xxx++)
+	{
+		pixelIndex	=	xxx;
+		for (yyy=0; yyy<height; yyy++)
+		{
+			dst[ccc++]	=	0;
+			dst[ccc++]	=	src[pixelIndex];
+			dst[ccc++]	=	0;
+			dst[ccc++]	=	0;
+			pixelIndex	+=	width;
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Reference_Raw16(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+int		xxx;
+int		yyy;
+int		ccc;
+int		pixelIndex;
+
+	ccc	=	0;
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			pixelIndex	=	yyy * width * 2;
+			pixelIndex	+=	xxx * 2;
+			dst[ccc++]	=	src[pixelIndex++];
+			dst[ccc++]	=	src[pixelIndex++];
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Reference_Raw16_32bit(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+int		xxx;
+int		yyy;
+int		ccc;
+int		pixelIndex;
+
+	ccc	=	0;
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			pixelIndex	=	yyy * width * 2;
+			pixelIndex	+=	xxx * 2;
+			dst[ccc++]	=	0;
+			dst[ccc++]	=	0;
+			dst[ccc++]	=	src[pixelIndex++];
+			dst[ccc++]	=	src[pixelIndex++];
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Reference_BGR24_RGB(unsigned char *dst, const unsigned char *src, int width, int height)
+{
+int		xxx;
+int		yyy;
+int		ccc;
+int		pixelIndex;
+
+	ccc	=	0;
+	for (xxx=0; xxx<width; xxx++)
+	{
+		pixelIndex	=	xxx * 3;
+		for (yyy=0; yyy<height; yyy++)
+		{
+			dst[ccc++]	=	src[pixelIndex + 2];
+			dst[ccc++]	=	src[pixelIndex + 1];
+			dst[ccc++]	=	src[pixelIndex];
+			pixelIndex	+=	width * 3;
+		}
+	}
+}
+
+//*****************************************************************************
+typedef struct	//	TYPE_BenchFormat
+{
+	const char			*name;
+	int					imageBytesFormat;
+	int					srcBytesPerPixel;
+	int					dstBytesPerPixel;
+	TYPE_ImageBytesFunc	referenceFunc;
+	TYPE_ImageBytesFunc	kernelFunc;
+
+} TYPE_BenchFormat;
+
+static const TYPE_BenchFormat	gBenchFormats[]	=
+{
+	{	"Raw8",			kImageBytes_Raw8,			1,	1,	Reference_Raw8,			ImageBytes_Raw8			},
+	{	"Raw8_16bit",	kImageBytes_Raw8_16bit,		1,	2,	Reference_Raw8_16bit,	ImageBytes_Raw8_16bit	},
+	{	"Raw8_32bit",	kImageBytes_Raw8_32bit,		1,	4,	Reference_Raw8_32bit,	ImageBytes_Raw8_32bit	},
+	{	"Raw16",		kImageBytes_Raw16,			2,	2,	Reference_Raw16,		ImageBytes_Raw16		},
+	{	"Raw16_32bit",	kImageBytes_Raw16_32bit,	2,	4,	Reference_Raw16_32bit,	ImageBytes_Raw16_32bit	},
+	{	"BGR24_RGB",	kImageBytes_BGR24_RGB,		3,	3,	Reference_BGR24_RGB,	ImageBytes_BGR24_RGB	},
+};
+#define	kBenchFormatCnt	((int)(sizeof(gBenchFormats) / sizeof(TYPE_BenchFormat)))
+
+//*	sizes that hit every combination of whole blocks and left over edges
+static const int	gCheckSizes[][2]	=
+{
+	{	1,		1	},
+	{	3,		2	},
+	{	7,		9	},
+	{	8,		8	},
+	{	15,		17	},
+	{	16,		16	},
+	{	17,		15	},
+	{	31,		33	},
+	{	32,		16	},
+	{	33,		64	},
+	{	64,		65	},
+	{	100,	67	},
+	{	257,	129	},
+	{	640,	481	},
+	{	1031,	773	},
+};
+#define	kCheckSizeCnt	((int)(sizeof(gCheckSizes) / sizeof(gCheckSizes[0])))
+
+//*	the chunked check does this many columns at a time, odd so the blocks do not line up
+#define	kCheckChunkColumns	13
+
+//*	extra bytes after the output buffer to catch writes past the end
+#define	kGuardBytes		64
+#define	kGuardValue		0xA5
+
+static int		gBenchWidth		=	6248;
+static int		gBenchHeight	=	4176;
+static int		gBenchPasses	=	5;
+
+//*****************************************************************************
+static double	GetSeconds(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(timeSpec.tv_sec + (timeSpec.tv_nsec / 1000000000.0));
+}
+
+//*****************************************************************************
+static void	FillRandom(unsigned char *buffer, size_t bufferLen)
+{
+size_t	iii;
+
+	for (iii=0; iii<bufferLen; iii++)
+	{
+		buffer[iii]	=	rand() & 0x00ff;
+	}
+}
+
+//*****************************************************************************
+//*	returns the number of failures
+//*****************************************************************************
+static int	CheckKernel(const char *kernelName, const TYPE_BenchFormat *format)
+{
+unsigned char	*srcBuffer;
+unsigned char	*expectedBuffer;
+unsigned char	*dstBuffer;
+size_t			srcLen;
+size_t			dstLen;
+size_t			columnBytes;
+int				width;
+int				height;
+int				startColumn;
+int				columnCnt;
+int				failCnt;
+int				iii;
+int				jjj;
+bool			guardOK;
+
+	failCnt	=	0;
+	for (iii=0; iii<kCheckSizeCnt; iii++)
+	{
+		width			=	gCheckSizes[iii][0];
+		height			=	gCheckSizes[iii][1];
+		srcLen			=	(size_t)width * height * format->srcBytesPerPixel;
+		dstLen			=	(size_t)width * height * format->dstBytesPerPixel;
+		srcBuffer		=	(unsigned char *)malloc(srcLen);
+		expectedBuffer	=	(unsigned char *)malloc(dstLen);
+		//*	+1 so the output is not aligned, it never is after the http header
+		dstBuffer		=	(unsigned char *)malloc(dstLen + kGuardBytes + 1);
+		if ((srcBuffer != NULL) && (expectedBuffer != NULL) && (dstBuffer != NULL))
+		{
+			FillRandom(srcBuffer, srcLen);
+			memset(dstBuffer, kGuardValue, (dstLen + kGuardBytes + 1));
+			format->referenceFunc(expectedBuffer, srcBuffer, width, height);
+			format->kernelFunc(dstBuffer + 1, srcBuffer, width, height);
+
+			guardOK	=	(dstBuffer[0] == kGuardValue);
+			for (jjj=0; jjj<kGuardBytes; jjj++)
+			{
+				if (dstBuffer[1 + dstLen + jjj] != kGuardValue)
+				{
+					guardOK	=	false;
+				}
+			}
+			if ((memcmp(dstBuffer + 1, expectedBuffer, dstLen) != 0) || (guardOK == false))
+			{
+				printf("FAILED: %-6s %-12s %5d x %-5d %s\n",	kernelName,
+																format->name,
+																width,
+																height,
+																(guardOK ? "data mismatch" : "wrote outside of buffer"));
+				failCnt++;
+			}
+
+			//*	same thing a few columns at a time, the way imagearray sends it
+			memset(dstBuffer, kGuardValue, (dstLen + kGuardBytes + 1));
+			columnBytes	=	(size_t)height * format->dstBytesPerPixel;
+			for (startColumn=0; startColumn<width; startColumn+=kCheckChunkColumns)
+			{
+				columnCnt	=	width - startColumn;
+				if (columnCnt > kCheckChunkColumns)
+				{
+					columnCnt	=	kCheckChunkColumns;
+				}
+				ImageBytes_TransposeColumns(dstBuffer + 1 + (startColumn * columnBytes),
+											srcBuffer,
+											width,
+											height,
+											startColumn,
+											columnCnt,
+											format->imageBytesFormat);
+			}
+			guardOK	=	(dstBuffer[0] == kGuardValue);
+			for (jjj=0; jjj<kGuardBytes; jjj++)
+			{
+				if (dstBuffer[1 + dstLen + jjj] != kGuardValue)
+				{
+					guardOK	=	false;
+				}
+			}
+			if ((memcmp(dstBuffer + 1, expectedBuffer, dstLen) != 0) || (guardOK == false))
+			{
+				printf("FAILED: %-6s %-12s %5d x %-5d %s (chunked)\n",	kernelName,
+																		format->name,
+																		width,
+																		height,
+																		(guardOK ? "data mismatch" : "wrote outside of buffer"));
+				failCnt++;
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG("Failed to allocate memory");
+			failCnt++;
+		}
+		free(srcBuffer);
+		free(expectedBuffer);
+		free(dstBuffer);
+	}
+	return(failCnt);
+}
+
+//*****************************************************************************
+//*	returns the best time for one pass in seconds
+//*****************************************************************************
+static double	TimeFunction(	TYPE_ImageBytesFunc	imageBytesFunc,
+								unsigned char		*dstBuffer,
+								const unsigned char	*srcBuffer)
+{
+double	startTime;
+double	elapsedTime;
+double	bestTime;
+int		iii;
+
+	bestTime	=	0.0;
+	for (iii=0; iii<gBenchPasses; iii++)
+	{
+		startTime	=	GetSeconds();
+		imageBytesFunc(dstBuffer, srcBuffer, gBenchWidth, gBenchHeight);
+		elapsedTime	=	GetSeconds() - startTime;
+		if ((iii == 0) || (elapsedTime < bestTime))
+		{
+			bestTime	=	elapsedTime;
+		}
+	}
+	return(bestTime);
+}
+
+//*****************************************************************************
+static void	PrintTimeLine(const char *kernelName, const char *formatName, const size_t dstLen, const double elapsed_Secs)
+{
+	printf("%-10s %-12s %9.2f %9.2f\n",	kernelName,
+										formatName,
+										(elapsed_Secs * 1000.0),
+										((elapsed_Secs > 0.0) ? ((dstLen / 1.0e9) / elapsed_Secs) : 0.0));
+}
+
+//*****************************************************************************
+static void	PrintHelp(const char *appName)
+{
+	printf("usage: %s [options]\n", appName);
+	printf("\t-w <width>       image width (default 6248)\n");
+	printf("\t-h <height>      image height (default 4176)\n");
+	printf("\t-n <passes>      number of timed passes, the best is reported (default 5)\n");
+}
+
+//*****************************************************************************
+static bool	ProcessCmdLineArgs(int argc, char **argv)
+{
+int			ii;
+char		theChar;
+const char	*argValue;
+
+	ii	=	1;
+	while (ii < argc)
+	{
+		if ((argv[ii][0] == '-') && (argv[ii][1] != 0))
+		{
+			theChar		=	argv[ii][1];
+			argValue	=	NULL;
+			if (argv[ii][2] != 0)
+			{
+				argValue	=	&argv[ii][2];
+			}
+			else if ((ii + 1) < argc)
+			{
+				ii++;
+				argValue	=	argv[ii];
+			}
+			if (argValue == NULL)
+			{
+				PrintHelp(argv[0]);
+				return(false);
+			}
+			switch(theChar)
+			{
+				case 'w':
+					gBenchWidth		=	atoi(argValue);
+					break;
+
+				case 'h':
+					gBenchHeight	=	atoi(argValue);
+					break;
+
+				case 'n':
+					gBenchPasses	=	atoi(argValue);
+					break;
+
+				default:
+					PrintHelp(argv[0]);
+					return(false);
+			}
+		}
+		else
+		{
+			PrintHelp(argv[0]);
+			return(false);
+		}
+		ii++;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+unsigned char	*srcBuffer;
+unsigned char	*dstBuffer;
+size_t			srcLen;
+size_t			dstLen;
+int				kernelCnt;
+int				failCnt;
+int				iii;
+int				jjj;
+const char		*kernelName;
+char			defaultKernel[32];
+
+	if (ProcessCmdLineArgs(argc, argv) == false)
+	{
+		return(1);
+	}
+	if ((gBenchWidth <= 0) || (gBenchHeight <= 0) || (gBenchPasses <= 0))
+	{
+		printf("Width, height and passes must be more than 0\n");
+		return(1);
+	}
+	srand(1);
+	strncpy(defaultKernel, ImageBytes_GetKernelName(), (sizeof(defaultKernel) - 1));
+	defaultKernel[sizeof(defaultKernel) - 1]	=	0;
+	kernelCnt	=	ImageBytes_GetKernelCount();
+	printf("Default kernel is %s, %d available\n", defaultKernel, kernelCnt);
+
+	//*	bit exact check against the original loops
+	failCnt	=	0;
+	for (iii=0; iii<kernelCnt; iii++)
+	{
+		kernelName	=	ImageBytes_GetKernelNameByIndex(iii);
+		ImageBytes_SelectKernel(kernelName);
+		for (jjj=0; jjj<kBenchFormatCnt; jjj++)
+		{
+			failCnt	+=	CheckKernel(kernelName, &gBenchFormats[jjj]);
+		}
+	}
+	printf("Bit exact check: %d sizes, %d formats, %d kernels, %d failures\n",
+						kCheckSizeCnt, kBenchFormatCnt, kernelCnt, failCnt);
+
+	//*	timing, the largest formats are 4 bytes per pixel
+	srcLen		=	(size_t)gBenchWidth * gBenchHeight * 4;
+	dstLen		=	(size_t)gBenchWidth * gBenchHeight * 4;
+	srcBuffer	=	(unsigned char *)malloc(srcLen);
+	dstBuffer	=	(unsigned char *)malloc(dstLen + 1);
+	if ((srcBuffer != NULL) && (dstBuffer != NULL))
+	{
+		FillRandom(srcBuffer, srcLen);
+		printf("\n%d x %d, best of %d passes\n", gBenchWidth, gBenchHeight, gBenchPasses);
+		printf("%-10s %-12s %9s %9s\n", "kernel", "format", "ms", "GB/sec");
+		for (jjj=0; jjj<kBenchFormatCnt; jjj++)
+		{
+			dstLen	=	(size_t)gBenchWidth * gBenchHeight * gBenchFormats[jjj].dstBytesPerPixel;
+			PrintTimeLine("original", gBenchFormats[jjj].name, dstLen,
+							TimeFunction(gBenchFormats[jjj].referenceFunc, dstBuffer + 1, srcBuffer));
+			for (iii=0; iii<kernelCnt; iii++)
+			{
+				kernelName	=	ImageBytes_GetKernelNameByIndex(iii);
+				ImageBytes_SelectKernel(kernelName);
+				PrintTimeLine(kernelName, gBenchFormats[jjj].name, dstLen,
+								TimeFunction(gBenchFormats[jjj].kernelFunc, dstBuffer + 1, srcBuffer));
+			}
+		}
+	}
+	else
+	{
+		printf("Failed to allocate memory for a %d x %d image\n", gBenchWidth, gBenchHeight);
+		failCnt++;
+	}
+	free(srcBuffer);
+	free(dstBuffer);
+	ImageBytes_SelectKernel(defaultKernel);
+	return((failCnt == 0) ? 0 : 1);
+}
@@ -0,0 +1,475 @@
+//*****************************************************************************
+//*
+//*	Name:			imagebytesreader.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Client side reader for the Alpaca ImageBytes format
+//*
+//*	Usage notes:	The old client code decoded the ImageBytes stream one byte at a time
+//*					into a TYPE_ImageArray (3 int32 per pixel, 12 bytes per pixel even for
+//*					mono) and then made a second pass to copy it into the openCV image.
+//*
+//*					This reads the ImageBytes header once and then recv()'s the data a block
+//*					of whole columns at a time (about kImageBytesReader_BlockSize bytes).
+//*					Each block is decoded to 16 bit values and then transposed, one tile at a
+//*					time, straight into the caller's row major image (cv::Mat or IplImage).
+//*					The only memory used is one block and its 16 bit copy.
+//*
+//*					Data is column major (x outer, y inner, planes fastest), little endian.
+//*					Byte values are scaled up (value << 8) and Int32 values down (value >> 16)
+//*					the same way the old decoder did it.
+//*
+//*					imagedownloadbench compares it against the old decoder.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created imagebytesreader.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<errno.h>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"alpaca_defs.h"
+#include	"imagebytesreader.h"
+
+//*	rows per tile when storing a block into the destination,
+//*	keeps the destination rows being written in the cache
+#define	kTileRows		64
+
+//*	indexed by kImageBytesReader_xxx
+static const int	gDstBytesPerPixel[kImageBytesReader_last]	=	{	2,	3,	3	};
+
+//*****************************************************************************
+//*	walks one block, kTileRows rows at a time, all of the columns in the block for each tile
+//*	srcIdx is the index of the first plane in stageBuff, dstPtr points to the output pixel
+//*****************************************************************************
+#define	STORE_LOOP(PIXEL_STORE)																\
+	for (yTile=0; yTile<height; yTile+=kTileRows)											\
+	{																						\
+		yEnd	=	((yTile + kTileRows) < height) ? (yTile + kTileRows) : height;			\
+		for (ccc=0; ccc<columnCnt; ccc++)													\
+		{																					\
+			srcIdx	=	(((size_t)ccc * height) + yTile) * planeCnt;						\
+			dstPtr	=	dstImage + ((size_t)yTile * dstRowStep) + ((size_t)(firstColumn + ccc) * dstBytesPerPixel);	\
+			for (yyy=yTile; yyy<yEnd; yyy++)												\
+			{																				\
+				PIXEL_STORE;																\
+				srcIdx	+=	planeCnt;														\
+				dstPtr	+=	dstRowStep;														\
+			}																				\
+		}																					\
+	}
+
+//*****************************************************************************
+//*	returns the number of bytes received, less than byteCnt means the connection closed or failed
+//*****************************************************************************
+static int	RecvAll(const int socketFD, unsigned char *buffPtr, const int byteCnt)
+{
+int		totalRecvd;
+int		recvCnt;
+bool	keepReading;
+
+	totalRecvd	=	0;
+	keepReading	=	true;
+	while (keepReading && (totalRecvd < byteCnt))
+	{
+		recvCnt	=	recv(socketFD, (buffPtr + totalRecvd), (byteCnt - totalRecvd), MSG_WAITALL);
+		if (recvCnt > 0)
+		{
+			totalRecvd	+=	recvCnt;
+		}
+		else if ((recvCnt < 0) && (errno == EINTR))
+		{
+			//*	try again
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("recv() returned\t=", recvCnt);
+			keepReading	=	false;
+		}
+	}
+	return(totalRecvd);
+}
+
+//*****************************************************************************
+static int	GetTransmissionElementSize(const int elementType)
+{
+int		elementSize;
+
+	switch(elementType)
+	{
+		case kAlpacaImageData_Byte:		elementSize	=	1;	break;
+		case kAlpacaImageData_Int16:	elementSize	=	2;	break;
+		case kAlpacaImageData_UInt16:	elementSize	=	2;	break;
+		case kAlpacaImageData_Int32:	elementSize	=	4;	break;
+		default:						elementSize	=	0;	break;
+	}
+	return(elementSize);
+}
+
+//*****************************************************************************
+int		ImageBytesReader_GetDstBytesPerPixel(const int dstFormat)
+{
+int		bytesPerPixel;
+
+	bytesPerPixel	=	0;
+	if ((dstFormat >= 0) && (dstFormat < kImageBytesReader_last))
+	{
+		bytesPerPixel	=	gDstBytesPerPixel[dstFormat];
+	}
+	return(bytesPerPixel);
+}
+
+//*****************************************************************************
+int		ImageBytesReader_Start(	TYPE_ImageBytesReader	*reader,
+								const int				socketFD,
+								const char				*bodyData,
+								const int				bodyByteCnt)
+{
+int				returnCode;
+int				bodyIdx	=	0;
+int				copyCnt;
+int				skipCnt;
+int				blockBytes;
+size_t			stageCnt;
+unsigned char	skipBuff[256];
+
+	returnCode	=	kImageBytesReader_Done;
+	if ((reader != NULL) && (socketFD >= 0) && (bodyByteCnt >= 0) && ((bodyData != NULL) || (bodyByteCnt == 0)))
+	{
+		memset(reader, 0, sizeof(TYPE_ImageBytesReader));
+		reader->socketFD	=	socketFD;
+
+		//*	the ImageBytes header, some or all of it may have come with the http header
+		copyCnt	=	(bodyByteCnt < (int)sizeof(TYPE_BinaryImageHdr)) ? bodyByteCnt : (int)sizeof(TYPE_BinaryImageHdr);
+		if (copyCnt > 0)
+		{
+			memcpy(&reader->imageHdr, bodyData, copyCnt);
+			bodyIdx	+=	copyCnt;
+		}
+		skipCnt	=	(int)sizeof(TYPE_BinaryImageHdr) - copyCnt;
+		if (skipCnt > 0)
+		{
+			if (RecvAll(socketFD, ((unsigned char *)&reader->imageHdr) + copyCnt, skipCnt) != skipCnt)
+			{
+				returnCode	=	kImageBytesReader_Err_Socket;
+			}
+		}
+		reader->totalBytesRead	=	sizeof(TYPE_BinaryImageHdr);
+	}
+	else
+	{
+		returnCode	=	kImageBytesReader_Err_InvalidParameter;
+	}
+
+	//*	check the header
+	if (returnCode == kImageBytesReader_Done)
+	{
+		CONSOLE_DEBUG_W_NUM("MetadataVersion        \t=",	reader->imageHdr.MetadataVersion);
+		CONSOLE_DEBUG_W_NUM("ErrorNumber            \t=",	reader->imageHdr.ErrorNumber);
+		CONSOLE_DEBUG_W_NUM("DataStart              \t=",	reader->imageHdr.DataStart);
+		CONSOLE_DEBUG_W_NUM("TransmissionElementType\t=",	reader->imageHdr.TransmissionElementType);
+		CONSOLE_DEBUG_W_NUM("Rank                   \t=",	reader->imageHdr.Rank);
+		CONSOLE_DEBUG_W_NUM("Dimension1             \t=",	reader->imageHdr.Dimension1);
+		CONSOLE_DEBUG_W_NUM("Dimension2             \t=",	reader->imageHdr.Dimension2);
+
+		reader->width			=	reader->imageHdr.Dimension1;
+		reader->height			=	reader->imageHdr.Dimension2;
+		reader->planeCnt		=	(reader->imageHdr.Rank == 3) ? reader->imageHdr.Dimension3 : 1;
+		reader->bytesPerElement	=	GetTransmissionElementSize(reader->imageHdr.TransmissionElementType);
+
+		if ((reader->imageHdr.MetadataVersion != 1) || (reader->imageHdr.DataStart < (int)sizeof(TYPE_BinaryImageHdr)))
+		{
+			returnCode	=	kImageBytesReader_Err_Header;
+		}
+		else if (reader->imageHdr.ErrorNumber != 0)
+		{
+			returnCode	=	kImageBytesReader_Err_Alpaca;
+		}
+		else if ((reader->bytesPerElement == 0) ||
+				((reader->imageHdr.Rank != 2) && (reader->imageHdr.Rank != 3)) ||
+				((reader->imageHdr.Rank == 3) && (reader->planeCnt != 3)))
+		{
+			returnCode	=	kImageBytesReader_Err_Unsupported;
+		}
+		else if ((reader->width <= 0) || (reader->height <= 0) ||
+				(((int64_t)reader->height * reader->planeCnt * reader->bytesPerElement) > (kImageBytesReader_BlockSize * 16)))
+		{
+			returnCode	=	kImageBytesReader_Err_Header;
+		}
+	}
+
+	//*	skip anything between the header and DataStart
+	if (returnCode == kImageBytesReader_Done)
+	{
+		skipCnt	=	reader->imageHdr.DataStart - (int)sizeof(TYPE_BinaryImageHdr);
+		copyCnt	=	((bodyByteCnt - bodyIdx) < skipCnt) ? (bodyByteCnt - bodyIdx) : skipCnt;
+		bodyIdx	+=	copyCnt;
+		skipCnt	-=	copyCnt;
+		while ((returnCode == kImageBytesReader_Done) && (skipCnt > 0))
+		{
+			copyCnt	=	(skipCnt < (int)sizeof(skipBuff)) ? skipCnt : (int)sizeof(skipBuff);
+			if (RecvAll(socketFD, skipBuff, copyCnt) == copyCnt)
+			{
+				skipCnt	-=	copyCnt;
+			}
+			else
+			{
+				returnCode	=	kImageBytesReader_Err_Socket;
+			}
+		}
+		reader->totalBytesRead	=	reader->imageHdr.DataStart;
+	}
+
+	//*	set up the block buffers
+	if (returnCode == kImageBytesReader_Done)
+	{
+		reader->columnBytes		=	reader->height * reader->planeCnt * reader->bytesPerElement;
+		reader->blockColumns	=	kImageBytesReader_BlockSize / reader->columnBytes;
+		if (reader->blockColumns < 1)
+		{
+			reader->blockColumns	=	1;
+		}
+		if (reader->blockColumns > reader->width)
+		{
+			reader->blockColumns	=	reader->width;
+		}
+		blockBytes			=	reader->blockColumns * reader->columnBytes;
+		stageCnt			=	(size_t)reader->blockColumns * reader->height * reader->planeCnt;
+		reader->blockBuff	=	(unsigned char *)malloc(blockBytes);
+		reader->stageBuff	=	(uint16_t *)malloc(stageCnt * sizeof(uint16_t));
+		if ((reader->blockBuff != NULL) && (reader->stageBuff != NULL))
+		{
+			//*	image data that came with the http header
+			copyCnt	=	bodyByteCnt - bodyIdx;
+			if (copyCnt > blockBytes)
+			{
+				CONSOLE_DEBUG_W_NUM("Extra data ignored\t=", (copyCnt - blockBytes));
+				copyCnt	=	blockBytes;
+			}
+			if (copyCnt > 0)
+			{
+				memcpy(reader->blockBuff, (bodyData + bodyIdx), copyCnt);
+				reader->blockByteCnt	=	copyCnt;
+			}
+		}
+		else
+		{
+			returnCode	=	kImageBytesReader_Err_NoMemory;
+		}
+	}
+
+	if ((returnCode != kImageBytesReader_Done) && (returnCode != kImageBytesReader_Err_InvalidParameter))
+	{
+		CONSOLE_DEBUG_W_NUM("returnCode\t=", returnCode);
+		ImageBytesReader_Free(reader);
+	}
+	return(returnCode);
+}
+
+//*****************************************************************************
+//*	blockBuff -> stageBuff, everything becomes a 16 bit value
+//*****************************************************************************
+static void	DecodeBlock(TYPE_ImageBytesReader *reader, const int columnCnt)
+{
+const unsigned char	*srcPtr;
+uint16_t			*stagePtr;
+size_t				valueCnt;
+size_t				iii;
+
+	srcPtr		=	reader->blockBuff;
+	stagePtr	=	reader->stageBuff;
+	valueCnt	=	(size_t)columnCnt * reader->height * reader->planeCnt;
+	switch(reader->bytesPerElement)
+	{
+		case 1:
+			for (iii=0; iii<valueCnt; iii++)
+			{
+				stagePtr[iii]	=	(uint16_t)(srcPtr[iii] << 8);
+			}
+			break;
+
+		case 2:
+			for (iii=0; iii<valueCnt; iii++)
+			{
+				stagePtr[iii]	=	(uint16_t)(srcPtr[0] | (srcPtr[1] << 8));
+				srcPtr			+=	2;
+			}
+			break;
+
+		case 4:
+			//*	the upper 16 bits of the little endian 32 bit value
+			for (iii=0; iii<valueCnt; iii++)
+			{
+				stagePtr[iii]	=	(uint16_t)(srcPtr[2] | (srcPtr[3] << 8));
+				srcPtr			+=	4;
+			}
+			break;
+	}
+}
+
+//*****************************************************************************
+//*	stageBuff -> destination, one tile at a time
+//*****************************************************************************
+static void	StoreBlock(	TYPE_ImageBytesReader	*reader,
+						const int				columnCnt,
+						unsigned char			*dstImage,
+						const size_t			dstRowStep,
+						const int				dstFormat)
+{
+const uint16_t	*stagePtr;
+unsigned char	*dstPtr;
+size_t			srcIdx;
+int				height;
+int				planeCnt;
+int				firstColumn;
+int				dstBytesPerPixel;
+int				yTile;
+int				yEnd;
+int				yyy;
+int				ccc;
+uint16_t		value16;
+
+	stagePtr			=	reader->stageBuff;
+	height				=	reader->height;
+	planeCnt			=	reader->planeCnt;
+	firstColumn			=	reader->columnsDone;
+	dstBytesPerPixel	=	gDstBytesPerPixel[dstFormat];
+
+	switch(dstFormat)
+	{
+		case kImageBytesReader_Gray16:
+			//*	color images only keep the first (red) plane
+			STORE_LOOP(memcpy(dstPtr, &stagePtr[srcIdx], sizeof(uint16_t)));
+			break;
+
+		case kImageBytesReader_BGR24:
+			if (planeCnt == 3)
+			{
+				//*	the planes are sent R,G,B, openCV wants B,G,R
+				STORE_LOOP(	dstPtr[0]	=	stagePtr[srcIdx + 2] >> 8;
+							dstPtr[1]	=	stagePtr[srcIdx + 1] >> 8;
+							dstPtr[2]	=	stagePtr[srcIdx] >> 8);
+			}
+			else
+			{
+				STORE_LOOP(	value16		=	stagePtr[srcIdx] >> 8;
+							dstPtr[0]	=	value16;
+							dstPtr[1]	=	value16;
+							dstPtr[2]	=	value16);
+			}
+			break;
+
+		case kImageBytesReader_BGR24_Low8:
+			if (planeCnt == 3)
+			{
+				STORE_LOOP(	dstPtr[0]	=	stagePtr[srcIdx + 2] & 0x00ff;
+							dstPtr[1]	=	stagePtr[srcIdx + 1] & 0x00ff;
+							dstPtr[2]	=	stagePtr[srcIdx] & 0x00ff);
+			}
+			else
+			{
+				STORE_LOOP(	value16		=	stagePtr[srcIdx] & 0x00ff;
+							dstPtr[0]	=	value16;
+							dstPtr[1]	=	value16;
+							dstPtr[2]	=	value16);
+			}
+			break;
+	}
+}
+
+//*****************************************************************************
+int		ImageBytesReader_ReadColumns(	TYPE_ImageBytesReader	*reader,
+										unsigned char			*dstImage,
+										const size_t			dstRowStep,
+										const int				dstFormat)
+{
+int		returnCode;
+int		columnCnt;
+int		neededBytes;
+int		recvCnt;
+
+	if ((reader == NULL) || (reader->blockBuff == NULL) || (dstImage == NULL) ||
+		(dstFormat < 0) || (dstFormat >= kImageBytesReader_last) ||
+		(dstRowStep < ((size_t)reader->width * gDstBytesPerPixel[dstFormat])))
+	{
+		returnCode	=	kImageBytesReader_Err_InvalidParameter;
+	}
+	else if (reader->columnsDone < reader->width)
+	{
+		columnCnt	=	reader->width - reader->columnsDone;
+		if (columnCnt > reader->blockColumns)
+		{
+			columnCnt	=	reader->blockColumns;
+		}
+		neededBytes	=	(columnCnt * reader->columnBytes) - reader->blockByteCnt;
+		recvCnt		=	0;
+		if (neededBytes > 0)
+		{
+			recvCnt	=	RecvAll(reader->socketFD, (reader->blockBuff + reader->blockByteCnt), neededBytes);
+		}
+		reader->totalBytesRead	+=	recvCnt;
+		if (recvCnt >= neededBytes)
+		{
+			DecodeBlock(reader, columnCnt);
+			StoreBlock(reader, columnCnt, dstImage, dstRowStep, dstFormat);
+
+			reader->columnsDone		+=	columnCnt;
+			reader->blockByteCnt	=	0;
+			returnCode				=	columnCnt;
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("Connection closed early, columnsDone\t=", reader->columnsDone);
+			returnCode	=	kImageBytesReader_Err_Socket;
+		}
+	}
+	else
+	{
+		returnCode	=	kImageBytesReader_Done;
+	}
+	return(returnCode);
+}
+
+//*****************************************************************************
+void	ImageBytesReader_Free(TYPE_ImageBytesReader *reader)
+{
+	if (reader != NULL)
+	{
+		if (reader->blockBuff != NULL)
+		{
+			free(reader->blockBuff);
+			reader->blockBuff	=	NULL;
+		}
+		if (reader->stageBuff != NULL)
+		{
+			free(reader->stageBuff);
+			reader->stageBuff	=	NULL;
+		}
+	}
+}
@@ -0,0 +1,101 @@
+//**************************************************************************
+//*	Name:			imagebytesreader.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Client side reader for the Alpaca ImageBytes format
+//*
+//*****************************************************************************
+//#include	"imagebytesreader.h"
+
+#ifndef _IMAGEBYTESREADER_H_
+#define	_IMAGEBYTESREADER_H_
+
+#include	<stddef.h>
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#ifndef _ALPACA_DEFS_H_
+	#include	"alpaca_defs.h"
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*	how much of the image is received and converted at a time
+#define	kImageBytesReader_BlockSize		(1024 * 1024)
+
+//*****************************************************************************
+//*	destination pixel formats, the destination is row major (y * rowStep + x)
+enum
+{
+	kImageBytesReader_Gray16	=	0,	//*	16 bit mono, host byte order, the first plane of a color image
+	kImageBytesReader_BGR24,			//*	8 bit BGR (openCV order), the upper 8 bits of each value
+	kImageBytesReader_BGR24_Low8,		//*	8 bit BGR (openCV order), the lower 8 bits of each value
+
+	kImageBytesReader_last
+};
+
+//*****************************************************************************
+//*	return codes, the errors are negative
+enum
+{
+	kImageBytesReader_Done				=	0,
+
+	kImageBytesReader_Err_InvalidParameter	=	-300,
+	kImageBytesReader_Err_NoMemory,
+	kImageBytesReader_Err_Socket,			//*	recv() failed or the connection closed early
+	kImageBytesReader_Err_Header,			//*	not a version 1 ImageBytes header
+	kImageBytesReader_Err_Alpaca,			//*	the server sent an Alpaca error, see imageHdr.ErrorNumber
+	kImageBytesReader_Err_Unsupported		//*	transmission element type or rank we can not decode
+};
+
+//*****************************************************************************
+typedef struct	//	TYPE_ImageBytesReader
+{
+	int					socketFD;
+	TYPE_BinaryImageHdr	imageHdr;
+	int					width;				//*	Dimension1
+	int					height;				//*	Dimension2
+	int					planeCnt;			//*	1 for rank 2, Dimension3 for rank 3
+	int					bytesPerElement;	//*	as sent over the network
+	int					columnBytes;		//*	one column (all rows, all planes) as sent
+	int					blockColumns;		//*	columns received at a time
+	int					columnsDone;
+	unsigned char		*blockBuff;			//*	blockColumns * columnBytes
+	int					blockByteCnt;		//*	bytes already in blockBuff
+	uint16_t			*stageBuff;			//*	one block decoded to 16 bit values, still column major
+	uint64_t			totalBytesRead;		//*	image data and ImageBytes header, not the http header
+} TYPE_ImageBytesReader;
+
+//*	The http header has already been read from socketFD, bodyData is what came with it
+//*	(can be NULL). Reads and checks the ImageBytes header, the data has not been read yet.
+int		ImageBytesReader_Start(	TYPE_ImageBytesReader	*reader,
+								const int				socketFD,
+								const char				*bodyData,
+								const int				bodyByteCnt);
+
+//*	Receives the next block of columns and stores them in dstImage (row major).
+//*	Returns how many columns were stored, kImageBytesReader_Done when the image is complete
+int		ImageBytesReader_ReadColumns(	TYPE_ImageBytesReader	*reader,
+										unsigned char			*dstImage,
+										const size_t			dstRowStep,
+										const int				dstFormat);
+
+//*	does not close the socket
+void	ImageBytesReader_Free(TYPE_ImageBytesReader *reader);
+
+int		ImageBytesReader_GetDstBytesPerPixel(const int dstFormat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_IMAGEBYTESREADER_H_
@@ -0,0 +1,941 @@
+//*****************************************************************************
+//*
+//*	Name:			imagedownloadbench.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Times imagearray ImageBytes downloads, old decoder against imagebytesreader.c
+//*
+//*	Usage notes:	The old way is what AlpacaGetImageArray_Binary_xxx() and DownloadImage_imagearray()
+//*					did, one byte at a time through a state machine into a TYPE_ImageArray
+//*					(12 bytes per pixel) and then a second pass into the image.
+//*					The new way is imagebytesreader.c, straight into the image a block at a time.
+//*					Both produce the same row major image (16 bit mono or 8 bit BGR, the same as
+//*					the openCV image the camera controller makes) and they are compared.
+//*
+//*		imagedownloadbench -a 127.0.0.1 -p 6800 -d 0 -n 10
+//*		imagedownloadbench -l
+//*
+//*		-a	IP address of the server (default 127.0.0.1)
+//*		-p	port (default 6800)
+//*		-d	camera number (default 0)
+//*		-n	number of downloads of each kind (default 5)
+//*		-8	8 bit images use the lower 8 bits (force8BitRead)
+//*		-l	loopback, runs its own server with every transmission type instead of using a camera
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created imagedownloadbench.c
+//*****************************************************************************
+
+#ifndef _GNU_SOURCE
+	#define	_GNU_SOURCE
+#endif
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<strings.h>
+#include	<unistd.h>
+#include	<time.h>
+#include	<errno.h>
+#include	<pthread.h>
+#include	<netdb.h>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<arpa/inet.h>
+#include	<netinet/in.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"alpaca_defs.h"
+#include	"json_parse.h"
+#include	"sendrequest_lib.h"
+#include	"imagebytesreader.h"
+
+char	gUserAgentAlpacaPiStr[80]	=	"User-Agent: AlpacaPi imagedownloadbench\r\n";
+
+//*	the same size as the old client read buffer
+#define	kLegacyReadBuffLen	5000
+
+//*****************************************************************************
+static struct sockaddr_in	gServerAddress;
+static char					gServerName[64]		=	"127.0.0.1";
+static int					gServerPort			=	kAlpacaPiDefaultPORT;
+static int					gCameraNum			=	0;
+static int					gIterations			=	5;
+static bool					gForce8BitRead		=	false;
+static bool					gLoopback			=	false;
+
+//*****************************************************************************
+//*	what the loopback server sends
+typedef struct
+{
+	const char	*name;
+	int			elementType;
+	int			transmissionType;
+	int			rank;
+	int			width;
+	int			height;
+} TYPE_LoopbackImage;
+
+static const TYPE_LoopbackImage	gLoopbackImages[]	=
+{
+	{	"Byte   rank 2",	kAlpacaImageData_Byte,		kAlpacaImageData_Byte,		2,	4656,	3520	},
+	{	"UInt16 rank 2",	kAlpacaImageData_UInt16,	kAlpacaImageData_UInt16,	2,	4656,	3520	},
+	{	"Int32  rank 2",	kAlpacaImageData_Int32,		kAlpacaImageData_Int32,		2,	4656,	3520	},
+	{	"Byte   rank 3",	kAlpacaImageData_Byte,		kAlpacaImageData_Byte,		3,	3096,	2080	},
+	{	"UInt16 odd",		kAlpacaImageData_UInt16,	kAlpacaImageData_UInt16,	2,	1001,	37		},
+	{	NULL,				0,							0,							0,	0,		0		}
+};
+
+static int				gLoopbackListenSocket	=	-1;
+static unsigned char	*gLoopbackReply			=	NULL;
+static size_t			gLoopbackReplyLen		=	0;
+
+//*****************************************************************************
+typedef struct
+{
+	uint64_t	total_uS;
+	uint64_t	bytesRcvd;
+	size_t		workMemory;			//*	memory used besides the image itself
+	int			downloadCnt;
+	int			errorCnt;
+} TYPE_DownloadStats;
+
+//*****************************************************************************
+static uint64_t	GetMicroSecs(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(((uint64_t)timeSpec.tv_sec * 1000000) + (timeSpec.tv_nsec / 1000));
+}
+
+//*****************************************************************************
+//*	reads the http header, bodyData gets whatever came after it
+//*	returns true if the reply is ImageBytes
+//*****************************************************************************
+static bool	ReadHttpHeader(const int socketDesc, char *readBuffer, const int buffLen, char **bodyData, int *bodyByteCnt)
+{
+int		totalRcvd;
+int		recvByteCnt;
+char	*endOfHeader;
+bool	isImageBytes;
+
+	totalRcvd	=	0;
+	endOfHeader	=	NULL;
+	while ((endOfHeader == NULL) && (totalRcvd < (buffLen - 1)))
+	{
+		recvByteCnt	=	recv(socketDesc, (readBuffer + totalRcvd), (buffLen - 1 - totalRcvd), 0);
+		if (recvByteCnt <= 0)
+		{
+			return(false);
+		}
+		totalRcvd				+=	recvByteCnt;
+		readBuffer[totalRcvd]	=	0;
+		endOfHeader				=	strstr(readBuffer, "\r\n\r\n");
+	}
+	if (endOfHeader == NULL)
+	{
+		return(false);
+	}
+	*endOfHeader	=	0;
+	isImageBytes	=	(strcasestr(readBuffer, "imagebytes") != NULL);
+	*bodyData		=	endOfHeader + 4;
+	*bodyByteCnt	=	totalRcvd - (*bodyData - readBuffer);
+	return(isImageBytes);
+}
+
+//*****************************************************************************
+static int	OpenImageRequest(void)
+{
+char	urlString[256];
+
+	sprintf(urlString,	"/api/v1/camera/%d/imagearray?ClientID=1&ClientTransactionID=1", gCameraNum);
+	return(OpenSocketAndSendRequest(&gServerAddress, gServerPort, "GET", urlString, NULL, READ_BINARY_IMAGE));
+}
+
+//*****************************************************************************
+//*	the same image type the camera controller makes
+//*****************************************************************************
+static int	GetDstFormat(const TYPE_BinaryImageHdr *imageHdr)
+{
+int		dstFormat;
+
+	if ((imageHdr->ImageElementType == kAlpacaImageData_Int16) ||
+		(imageHdr->ImageElementType == kAlpacaImageData_UInt16))
+	{
+		dstFormat	=	kImageBytesReader_Gray16;
+	}
+	else
+	{
+		dstFormat	=	gForce8BitRead ? kImageBytesReader_BGR24_Low8 : kImageBytesReader_BGR24;
+	}
+	return(dstFormat);
+}
+
+//*****************************************************************************
+//*	The old way, a copy of the AlpacaGetImageArray_Binary_xxx() state machines
+//*	(byte at a time into TYPE_ImageArray) and the second pass in DownloadImage_imagearray().
+//*	Int32 is little endian here so it can be compared.
+//*	Returns the image, NULL on error
+//*****************************************************************************
+static unsigned char	*Download_Legacy(TYPE_BinaryImageHdr *imageHdr, size_t *imageSize, TYPE_DownloadStats *stats)
+{
+int				socketDesc;
+char			*readBuffer;
+char			*bodyData;
+int				bodyByteCnt;
+TYPE_ImageArray	*imageArray;
+int				imageArrayLen;
+int				imageArrayIdx;
+unsigned char	*hdrPtr;
+int				hdrIdx;
+int				skipCnt;
+int				bytesPerElement;
+int				dataByteIdx;
+uint32_t		binaryDataValue;
+int				rgbIdx;
+int				data_iii;
+int				recvdByteCnt;
+bool			keepReading;
+unsigned char	*dstImage;
+size_t			dstRowStep;
+int				dstFormat;
+int				xxx;
+int				yyy;
+int				iii;
+size_t			pixIdx;
+uint64_t		startTime_uS;
+
+	dstImage	=	NULL;
+	imageArray	=	NULL;
+	readBuffer	=	(char *)malloc(64 * 1024);
+	if (readBuffer == NULL)
+	{
+		return(NULL);
+	}
+	startTime_uS	=	GetMicroSecs();
+	socketDesc		=	OpenImageRequest();
+	if (socketDesc < 0)
+	{
+		free(readBuffer);
+		return(NULL);
+	}
+	if (ReadHttpHeader(socketDesc, readBuffer, (64 * 1024), &bodyData, &bodyByteCnt))
+	{
+		memmove(readBuffer, bodyData, bodyByteCnt);
+		recvdByteCnt	=	bodyByteCnt;
+		data_iii		=	0;
+		hdrPtr			=	(unsigned char *)imageHdr;
+		hdrIdx			=	0;
+		skipCnt			=	-1;
+		imageArrayLen	=	0;
+		imageArrayIdx	=	0;
+		bytesPerElement	=	0;
+		dataByteIdx		=	0;
+		binaryDataValue	=	0;
+		rgbIdx			=	0;
+		keepReading		=	true;
+		while (keepReading)
+		{
+			while (data_iii < recvdByteCnt)
+			{
+				if (hdrIdx < (int)sizeof(TYPE_BinaryImageHdr))
+				{
+					hdrPtr[hdrIdx++]	=	readBuffer[data_iii++];
+					if (hdrIdx == (int)sizeof(TYPE_BinaryImageHdr))
+					{
+						//*	the whole header is here
+						skipCnt			=	imageHdr->DataStart - sizeof(TYPE_BinaryImageHdr);
+						imageArrayLen	=	imageHdr->Dimension1 * imageHdr->Dimension2;
+						bytesPerElement	=	(imageHdr->TransmissionElementType == kAlpacaImageData_Byte) ? 1 :
+											(imageHdr->TransmissionElementType == kAlpacaImageData_Int32) ? 4 : 2;
+						imageArray		=	(TYPE_ImageArray *)calloc((imageArrayLen + 100), sizeof(TYPE_ImageArray));
+						stats->workMemory	=	(imageArrayLen + 100) * sizeof(TYPE_ImageArray);
+						if ((imageArray == NULL) || (imageHdr->ErrorNumber != 0) || (skipCnt < 0))
+						{
+							keepReading	=	false;
+							break;
+						}
+					}
+				}
+				else if (skipCnt > 0)
+				{
+					skipCnt--;
+					data_iii++;
+				}
+				else
+				{
+					//*	the state machine
+					switch(dataByteIdx)
+					{
+						case 0:
+							binaryDataValue	=	readBuffer[data_iii] & 0x00ff;
+							break;
+
+						case 1:
+							binaryDataValue	+=	((readBuffer[data_iii] & 0x00ff) << 8);
+							break;
+
+						case 2:
+							binaryDataValue	+=	((readBuffer[data_iii] & 0x00ff) << 16);
+							break;
+
+						case 3:
+							binaryDataValue	+=	((uint32_t)(readBuffer[data_iii] & 0x00ff) << 24);
+							break;
+					}
+					dataByteIdx++;
+					if (dataByteIdx >= bytesPerElement)
+					{
+						switch(bytesPerElement)
+						{
+							case 1:	binaryDataValue	=	binaryDataValue << 8;	break;
+							case 4:	binaryDataValue	=	binaryDataValue >> 16;	break;
+						}
+						if (imageArrayIdx < imageArrayLen)
+						{
+							if (imageHdr->Rank == 3)
+							{
+								switch(rgbIdx)
+								{
+									case 0:
+										imageArray[imageArrayIdx].RedValue	=	binaryDataValue & 0x00ffff;
+										break;
+
+									case 1:
+										imageArray[imageArrayIdx].GrnValue	=	binaryDataValue & 0x00ffff;
+										break;
+
+									case 2:
+										imageArray[imageArrayIdx].BluValue	=	binaryDataValue & 0x00ffff;
+										imageArrayIdx++;
+										break;
+								}
+								rgbIdx++;
+								if (rgbIdx >= 3)
+								{
+									rgbIdx	=	0;
+								}
+							}
+							else
+							{
+								imageArray[imageArrayIdx].RedValue	=	binaryDataValue;
+								imageArray[imageArrayIdx].GrnValue	=	binaryDataValue;
+								imageArray[imageArrayIdx].BluValue	=	binaryDataValue;
+								imageArrayIdx++;
+							}
+						}
+						dataByteIdx	=	0;
+					}
+					data_iii++;
+				}
+			}
+			if (keepReading)
+			{
+				recvdByteCnt	=	recv(socketDesc, readBuffer, kLegacyReadBuffLen, 0);
+				data_iii		=	0;
+				if (recvdByteCnt > 0)
+				{
+					stats->bytesRcvd	+=	recvdByteCnt;
+				}
+				else
+				{
+					keepReading	=	false;
+				}
+			}
+		}
+
+		//*	the second pass, column major TYPE_ImageArray into the row major image
+		if ((imageArray != NULL) && (imageArrayIdx == imageArrayLen))
+		{
+			dstFormat	=	GetDstFormat(imageHdr);
+			dstRowStep	=	(size_t)imageHdr->Dimension1 * ImageBytesReader_GetDstBytesPerPixel(dstFormat);
+			*imageSize	=	dstRowStep * imageHdr->Dimension2;
+			dstImage	=	(unsigned char *)malloc(*imageSize);
+			if (dstImage != NULL)
+			{
+				iii	=	0;
+				for (xxx=0; xxx < imageHdr->Dimension1; xxx++)
+				{
+					for (yyy=0; yyy < imageHdr->Dimension2; yyy++)
+					{
+						pixIdx	=	((size_t)yyy * dstRowStep) + ((size_t)xxx * ImageBytesReader_GetDstBytesPerPixel(dstFormat));
+						switch(dstFormat)
+						{
+							case kImageBytesReader_Gray16:
+								dstImage[pixIdx++]	=	(imageArray[iii].RedValue) & 0x00ff;
+								dstImage[pixIdx++]	=	(imageArray[iii].RedValue >> 8) & 0x00ff;
+								break;
+
+							case kImageBytesReader_BGR24_Low8:
+								dstImage[pixIdx++]	=	(imageArray[iii].BluValue) & 0x00ff;
+								dstImage[pixIdx++]	=	(imageArray[iii].GrnValue) & 0x00ff;
+								dstImage[pixIdx++]	=	(imageArray[iii].RedValue) & 0x00ff;
+								break;
+
+							case kImageBytesReader_BGR24:
+								dstImage[pixIdx++]	=	(imageArray[iii].BluValue >> 8) & 0x00ff;
+								dstImage[pixIdx++]	=	(imageArray[iii].GrnValue >> 8) & 0x00ff;
+								dstImage[pixIdx++]	=	(imageArray[iii].RedValue >> 8) & 0x00ff;
+								break;
+						}
+						iii++;
+					}
+				}
+			}
+		}
+	}
+	close(socketDesc);
+	stats->total_uS	+=	GetMicroSecs() - startTime_uS;
+	if (imageArray != NULL)
+	{
+		free(imageArray);
+	}
+	free(readBuffer);
+	return(dstImage);
+}
+
+//*****************************************************************************
+//*	the new way, imagebytesreader.c
+//*****************************************************************************
+static unsigned char	*Download_Reader(TYPE_BinaryImageHdr *imageHdr, size_t *imageSize, TYPE_DownloadStats *stats)
+{
+int						socketDesc;
+char					readBuffer[kLegacyReadBuffLen + 1];
+char					*bodyData;
+int						bodyByteCnt;
+TYPE_ImageBytesReader	imageReader;
+unsigned char			*dstImage;
+size_t					dstRowStep;
+int						dstFormat;
+int						readerRetCode;
+uint64_t				startTime_uS;
+
+	dstImage		=	NULL;
+	startTime_uS	=	GetMicroSecs();
+	socketDesc		=	OpenImageRequest();
+	if (socketDesc < 0)
+	{
+		return(NULL);
+	}
+	if (ReadHttpHeader(socketDesc, readBuffer, sizeof(readBuffer), &bodyData, &bodyByteCnt) &&
+		(ImageBytesReader_Start(&imageReader, socketDesc, bodyData, bodyByteCnt) == kImageBytesReader_Done))
+	{
+		*imageHdr			=	imageReader.imageHdr;
+		stats->workMemory	=	((size_t)imageReader.blockColumns * imageReader.columnBytes) +
+								((size_t)imageReader.blockColumns * imageReader.height * imageReader.planeCnt * sizeof(uint16_t));
+		dstFormat			=	GetDstFormat(imageHdr);
+		dstRowStep			=	(size_t)imageReader.width * ImageBytesReader_GetDstBytesPerPixel(dstFormat);
+		*imageSize			=	dstRowStep * imageReader.height;
+		dstImage			=	(unsigned char *)malloc(*imageSize);
+		if (dstImage != NULL)
+		{
+			do
+			{
+				readerRetCode	=	ImageBytesReader_ReadColumns(&imageReader, dstImage, dstRowStep, dstFormat);
+			} while (readerRetCode > 0);
+
+			if (readerRetCode != kImageBytesReader_Done)
+			{
+				printf("ImageBytesReader_ReadColumns() returned %d\n", readerRetCode);
+				free(dstImage);
+				dstImage	=	NULL;
+			}
+		}
+		stats->bytesRcvd	+=	imageReader.totalBytesRead;
+		ImageBytesReader_Free(&imageReader);
+	}
+	close(socketDesc);
+	stats->total_uS	+=	GetMicroSecs() - startTime_uS;
+	return(dstImage);
+}
+
+//*****************************************************************************
+static void	PrintStats(const char *name, const TYPE_DownloadStats *stats)
+{
+double	average_mS;
+double	megaBytesPerSec;
+
+	average_mS		=	0.0;
+	megaBytesPerSec	=	0.0;
+	if (stats->downloadCnt > 0)
+	{
+		average_mS	=	(stats->total_uS / 1000.0) / stats->downloadCnt;
+	}
+	if (stats->total_uS > 0)
+	{
+		megaBytesPerSec	=	(stats->bytesRcvd / (1024.0 * 1024.0)) / (stats->total_uS / 1000000.0);
+	}
+	printf("  %-8s %6d %6d %10.2f %10.2f %12.2f\n",
+			name,
+			stats->downloadCnt,
+			stats->errorCnt,
+			average_mS,
+			megaBytesPerSec,
+			(stats->workMemory / (1024.0 * 1024.0)));
+}
+
+//*****************************************************************************
+//*	downloads the image both ways gIterations times, returns false if they did not match
+//*****************************************************************************
+static bool	RunDownloads(const char *testName)
+{
+TYPE_DownloadStats	legacyStats;
+TYPE_DownloadStats	readerStats;
+TYPE_BinaryImageHdr	legacyHdr;
+TYPE_BinaryImageHdr	readerHdr;
+unsigned char		*legacyImage;
+unsigned char		*readerImage;
+size_t				legacySize;
+size_t				readerSize;
+int					iii;
+int					mismatchCnt;
+
+	memset(&legacyStats, 0, sizeof(TYPE_DownloadStats));
+	memset(&readerStats, 0, sizeof(TYPE_DownloadStats));
+	memset(&legacyHdr, 0, sizeof(TYPE_BinaryImageHdr));
+	memset(&readerHdr, 0, sizeof(TYPE_BinaryImageHdr));
+	mismatchCnt	=	0;
+	for (iii=0; iii<gIterations; iii++)
+	{
+		legacySize	=	0;
+		readerSize	=	0;
+		legacyImage	=	Download_Legacy(&legacyHdr, &legacySize, &legacyStats);
+		readerImage	=	Download_Reader(&readerHdr, &readerSize, &readerStats);
+		if (legacyImage != NULL)
+		{
+			legacyStats.downloadCnt++;
+		}
+		else
+		{
+			legacyStats.errorCnt++;
+		}
+		if (readerImage != NULL)
+		{
+			readerStats.downloadCnt++;
+		}
+		else
+		{
+			readerStats.errorCnt++;
+		}
+		if ((legacyImage != NULL) && (readerImage != NULL))
+		{
+			if ((legacySize != readerSize) || (memcmp(legacyImage, readerImage, readerSize) != 0))
+			{
+				mismatchCnt++;
+			}
+		}
+		free(legacyImage);
+		free(readerImage);
+	}
+
+	printf("%s: %d x %d, rank %d, element type %d, sent as %d\n",
+			testName,
+			readerHdr.Dimension1,
+			readerHdr.Dimension2,
+			readerHdr.Rank,
+			readerHdr.ImageElementType,
+			readerHdr.TransmissionElementType);
+	printf("  %-8s %6s %6s %10s %10s %12s\n", "Decoder", "Count", "Errors", "Mean ms", "MB/sec", "Work MB");
+	PrintStats("old", &legacyStats);
+	PrintStats("reader", &readerStats);
+	if ((legacyStats.total_uS > 0) && (readerStats.total_uS > 0))
+	{
+		printf("  reader is %.2f times as fast\n", (1.0 * legacyStats.total_uS) / readerStats.total_uS);
+	}
+	printf("  images %s\n\n", (mismatchCnt == 0) ? "match" : "DO NOT MATCH");
+	return((mismatchCnt == 0) && (legacyStats.errorCnt == 0) && (readerStats.errorCnt == 0));
+}
+
+//*****************************************************************************
+//*	builds the complete http reply for one of the loopback images
+//*****************************************************************************
+static bool	BuildLoopbackReply(const TYPE_LoopbackImage *loopbackImage)
+{
+TYPE_BinaryImageHdr	imageHdr;
+char				httpHeader[256];
+int					httpHdrLen;
+int					planeCnt;
+int					bytesPerElement;
+size_t				dataLen;
+size_t				valueCnt;
+size_t				iii;
+unsigned char		*dataPtr;
+uint32_t			value;
+
+	planeCnt		=	(loopbackImage->rank == 3) ? 3 : 1;
+	bytesPerElement	=	(loopbackImage->transmissionType == kAlpacaImageData_Byte) ? 1 :
+						(loopbackImage->transmissionType == kAlpacaImageData_Int32) ? 4 : 2;
+	valueCnt		=	(size_t)loopbackImage->width * loopbackImage->height * planeCnt;
+	dataLen			=	sizeof(TYPE_BinaryImageHdr) + (valueCnt * bytesPerElement);
+
+	memset(&imageHdr, 0, sizeof(TYPE_BinaryImageHdr));
+	imageHdr.MetadataVersion			=	1;
+	imageHdr.DataStart					=	sizeof(TYPE_BinaryImageHdr);
+	imageHdr.ImageElementType			=	loopbackImage->elementType;
+	imageHdr.TransmissionElementType	=	loopbackImage->transmissionType;
+	imageHdr.Rank						=	loopbackImage->rank;
+	imageHdr.Dimension1					=	loopbackImage->width;
+	imageHdr.Dimension2					=	loopbackImage->height;
+	imageHdr.Dimension3					=	(loopbackImage->rank == 3) ? 3 : 0;
+
+	httpHdrLen	=	sprintf(httpHeader,	"HTTP/1.1 200 OK\r\n"
+										"Content-Type: application/imagebytes\r\n"
+										"Content-Length: %lu\r\n"
+										"Connection: close\r\n"
+										"\r\n",
+										(unsigned long)dataLen);
+
+	free(gLoopbackReply);
+	gLoopbackReplyLen	=	httpHdrLen + dataLen;
+	gLoopbackReply		=	(unsigned char *)malloc(gLoopbackReplyLen);
+	if (gLoopbackReply == NULL)
+	{
+		return(false);
+	}
+	memcpy(gLoopbackReply, httpHeader, httpHdrLen);
+	memcpy(gLoopbackReply + httpHdrLen, &imageHdr, sizeof(TYPE_BinaryImageHdr));
+
+	//*	a pattern that uses all of the bits, little endian
+	dataPtr	=	gLoopbackReply + httpHdrLen + sizeof(TYPE_BinaryImageHdr);
+	for (iii=0; iii<valueCnt; iii++)
+	{
+		value	=	(uint32_t)((iii * 2654435761u) >> 7);
+		switch(bytesPerElement)
+		{
+			case 1:
+				*dataPtr++	=	value & 0x00ff;
+				break;
+
+			case 2:
+				*dataPtr++	=	value & 0x00ff;
+				*dataPtr++	=	(value >> 8) & 0x00ff;
+				break;
+
+			case 4:
+				//*	16 bit value << 16, the way the server sends 16 bit images as Int32
+				*dataPtr++	=	0;
+				*dataPtr++	=	0;
+				*dataPtr++	=	value & 0x00ff;
+				*dataPtr++	=	(value >> 8) & 0x00ff;
+				break;
+		}
+	}
+	return(true);
+}
+
+//*****************************************************************************
+static void	*LoopbackServerThread(void *arg)
+{
+int		listenSocket;
+int		clientSocket;
+char	requestBuff[2048];
+int		requestLen;
+int		recvByteCnt;
+size_t	sentCnt;
+ssize_t	sendRetCode;
+
+	listenSocket	=	*((int *)arg);
+	while ((clientSocket = accept(listenSocket, NULL, NULL)) >= 0)
+	{
+		//*	read the request, the reply is the same whatever it asks for
+		requestLen	=	0;
+		while ((recvByteCnt = recv(clientSocket, (requestBuff + requestLen), (sizeof(requestBuff) - 1 - requestLen), 0)) > 0)
+		{
+			requestLen				+=	recvByteCnt;
+			requestBuff[requestLen]	=	0;
+			if ((strstr(requestBuff, "\r\n\r\n") != NULL) || (requestLen >= (int)(sizeof(requestBuff) - 1)))
+			{
+				break;
+			}
+		}
+		sentCnt	=	0;
+		while (sentCnt < gLoopbackReplyLen)
+		{
+			sendRetCode	=	send(clientSocket, (gLoopbackReply + sentCnt), (gLoopbackReplyLen - sentCnt), MSG_NOSIGNAL);
+			if (sendRetCode <= 0)
+			{
+				break;
+			}
+			sentCnt	+=	sendRetCode;
+		}
+		close(clientSocket);
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+static bool	StartLoopbackServer(void)
+{
+struct sockaddr_in	serverAddr;
+socklen_t			addrLen;
+pthread_t			threadID;
+
+	gLoopbackListenSocket	=	socket(AF_INET, SOCK_STREAM, 0);
+	if (gLoopbackListenSocket < 0)
+	{
+		return(false);
+	}
+	memset(&serverAddr, 0, sizeof(serverAddr));
+	serverAddr.sin_family		=	AF_INET;
+	serverAddr.sin_addr.s_addr	=	htonl(INADDR_LOOPBACK);
+	serverAddr.sin_port			=	0;
+	addrLen						=	sizeof(serverAddr);
+	if ((bind(gLoopbackListenSocket, (struct sockaddr *)&serverAddr, sizeof(serverAddr)) != 0) ||
+		(listen(gLoopbackListenSocket, 8) != 0) ||
+		(getsockname(gLoopbackListenSocket, (struct sockaddr *)&serverAddr, &addrLen) != 0))
+	{
+		close(gLoopbackListenSocket);
+		return(false);
+	}
+	gServerAddress	=	serverAddr;
+	gServerPort		=	ntohs(serverAddr.sin_port);
+	strcpy(gServerName, "127.0.0.1");
+	return(pthread_create(&threadID, NULL, &LoopbackServerThread, &gLoopbackListenSocket) == 0);
+}
+
+//*****************************************************************************
+//*	there has to be an image before imagearray will return one
+//*****************************************************************************
+static bool	PrepareCamera(void)
+{
+SJP_Parser_t	*jsonParser;
+char			urlString[256];
+char			valueString[64];
+int				waitCnt;
+bool			imageReady;
+
+	jsonParser	=	(SJP_Parser_t *)calloc(1, sizeof(SJP_Parser_t));
+	if (jsonParser == NULL)
+	{
+		return(false);
+	}
+	printf("Taking an exposure on camera/%d\n", gCameraNum);
+
+	sprintf(urlString, "/api/v1/camera/%d/connected", gCameraNum);
+	SendPutCommand(&gServerAddress, gServerPort, urlString, "Connected=true&ClientID=1&ClientTransactionID=1", jsonParser);
+
+	sprintf(urlString, "/api/v1/camera/%d/startexposure", gCameraNum);
+	SendPutCommand(&gServerAddress, gServerPort, urlString, "Duration=0.01&Light=true&ClientID=1&ClientTransactionID=2", jsonParser);
+
+	imageReady	=	false;
+	waitCnt		=	0;
+	sprintf(urlString, "/api/v1/camera/%d/imageready?ClientID=1&ClientTransactionID=3", gCameraNum);
+	while ((imageReady == false) && (waitCnt < 100))
+	{
+		usleep(100 * 1000);
+		if (GetJsonResponse(&gServerAddress, gServerPort, urlString, NULL, jsonParser) &&
+			SJP_FindKeyWordString("VALUE", jsonParser->dataList, jsonParser->tokenCount_Data, valueString))
+		{
+			imageReady	=	(strcasecmp(valueString, "true") == 0);
+		}
+		waitCnt++;
+	}
+	if (imageReady == false)
+	{
+		printf("camera/%d never reported imageready\n", gCameraNum);
+	}
+	free(jsonParser);
+	return(imageReady);
+}
+
+//*****************************************************************************
+static bool	LookupServerAddress(void)
+{
+struct addrinfo	hints;
+struct addrinfo	*addrResult;
+int				returnCode;
+
+	memset(&gServerAddress, 0, sizeof(gServerAddress));
+	gServerAddress.sin_family	=	AF_INET;
+	gServerAddress.sin_port		=	htons(gServerPort);
+	if (inet_pton(AF_INET, gServerName, &gServerAddress.sin_addr) == 1)
+	{
+		return(true);
+	}
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family		=	AF_INET;
+	hints.ai_socktype	=	SOCK_STREAM;
+	returnCode			=	getaddrinfo(gServerName, NULL, &hints, &addrResult);
+	if (returnCode != 0)
+	{
+		printf("Can not find server %s: %s\n", gServerName, gai_strerror(returnCode));
+		return(false);
+	}
+	gServerAddress.sin_addr	=	((struct sockaddr_in *)addrResult->ai_addr)->sin_addr;
+	freeaddrinfo(addrResult);
+	return(true);
+}
+
+//*****************************************************************************
+static void	PrintHelp(const char *appName)
+{
+	printf("usage: %s [options]\n", appName);
+	printf("\t-a <address>     IP address or host name of the server (default 127.0.0.1)\n");
+	printf("\t-p <port>        port (default %d)\n", kAlpacaPiDefaultPORT);
+	printf("\t-d <number>      camera number (default 0)\n");
+	printf("\t-n <count>       number of downloads of each kind (default 5)\n");
+	printf("\t-8               8 bit images use the lower 8 bits (force8BitRead)\n");
+	printf("\t-l               loopback, runs its own server instead of using a camera\n");
+	printf("\n");
+	printf("The camera simulator in drivers/Simulator is the easiest thing to run this against\n");
+}
+
+//*****************************************************************************
+static bool	ProcessCmdLineArgs(int argc, char **argv)
+{
+int			ii;
+char		theChar;
+const char	*argValue;
+
+	ii	=	1;
+	while (ii < argc)
+	{
+		if ((argv[ii][0] == '-') && (argv[ii][1] != 0))
+		{
+			theChar		=	argv[ii][1];
+			argValue	=	NULL;
+			if ((theChar == '8') || (theChar == 'l') || (theChar == 'h'))
+			{
+				//*	no value
+			}
+			else if (argv[ii][2] != 0)
+			{
+				argValue	=	&argv[ii][2];
+			}
+			else if ((ii + 1) < argc)
+			{
+				ii++;
+				argValue	=	argv[ii];
+			}
+			switch(theChar)
+			{
+				case 'a':
+				case 'p':
+				case 'd':
+				case 'n':
+					if (argValue == NULL)
+					{
+						printf("Option -%c needs a value\n", theChar);
+						return(false);
+					}
+					if (theChar == 'a')
+					{
+						strncpy(gServerName, argValue, (sizeof(gServerName) - 1));
+					}
+					else if (theChar == 'p')
+					{
+						gServerPort	=	atoi(argValue);
+					}
+					else if (theChar == 'd')
+					{
+						gCameraNum	=	atoi(argValue);
+					}
+					else
+					{
+						gIterations	=	atoi(argValue);
+					}
+					break;
+
+				case '8':
+					gForce8BitRead	=	true;
+					break;
+
+				case 'l':
+					gLoopback		=	true;
+					break;
+
+				case 'h':
+				default:
+					PrintHelp(argv[0]);
+					return(false);
+			}
+		}
+		else
+		{
+			PrintHelp(argv[0]);
+			return(false);
+		}
+		ii++;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+char	testName[128];
+bool	allMatched;
+int		iii;
+
+	if (ProcessCmdLineArgs(argc, argv) == false)
+	{
+		return(1);
+	}
+	if (gIterations <= 0)
+	{
+		printf("The number of downloads must be more than 0\n");
+		return(1);
+	}
+
+	allMatched	=	true;
+	if (gLoopback)
+	{
+		if (StartLoopbackServer() == false)
+		{
+			printf("Failed to start the loopback server\n");
+			return(1);
+		}
+		iii	=	0;
+		while (gLoopbackImages[iii].name != NULL)
+		{
+			if (BuildLoopbackReply(&gLoopbackImages[iii]) == false)
+			{
+				printf("Failed to allocate the loopback image\n");
+				return(1);
+			}
+			if (RunDownloads(gLoopbackImages[iii].name) == false)
+			{
+				allMatched	=	false;
+			}
+			iii++;
+		}
+		free(gLoopbackReply);
+	}
+	else
+	{
+		if (LookupServerAddress() == false)
+		{
+			return(1);
+		}
+		if (PrepareCamera() == false)
+		{
+			return(1);
+		}
+		sprintf(testName, "%s:%d camera/%d", gServerName, gServerPort, gCameraNum);
+		allMatched	=	RunDownloads(testName);
+	}
+	printf("%s\n", allMatched ? "All downloads matched" : "FAILED");
+	return(allMatched ? 0 : 1);
+}
@@ -0,0 +1,434 @@
+//*****************************************************************************
+//*
+//*	Name:			imagepool.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Pool of large image buffers shared by all cameras
+//*
+//*	Usage notes:	Frame buffers, openCV images, download and save buffers used to be
+//*					malloc()'d and free()'d every time the frame size, binning or image type
+//*					changed, and some of them on every exposure. On a long night on a 32 bit
+//*					Raspberry Pi that chops the heap into pieces that no longer fit a frame.
+//*
+//*					Every buffer now comes from here. Sizes are rounded up to a size class,
+//*					4 classes per power of 2 starting at 64K, so a buffer is never more than
+//*					25% bigger than what was asked for. A freed buffer goes on the free list
+//*					of its class and the next request of that class gets it back.
+//*					Once a sequence has gone through all of its sizes, nothing new gets allocated.
+//*
+//*					The buffers are mmap()'d on their own, so they never touch the malloc heap.
+//*					Optionally they use huge pages (falls back to normal pages if there
+//*					are none) and are mlock()'d so they can not be swapped out.
+//*
+//*					The free buffers are limited to maxCachedBytes, past that a freed buffer
+//*					goes back to the system. If mmap() fails, all of the free buffers are
+//*					given back and it is tried again.
+//*
+//*					imagepooltest checks that a steady state sequence does no new allocations.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created imagepool.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<errno.h>
+#include	<pthread.h>
+#include	<sys/mman.h>
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"imagepool.h"
+
+#define	kImagePoolMagic			0x504f4f4c			//*	"POOL"
+#define	kImagePoolHeaderSize	64					//*	keeps the buffers 64 byte aligned
+#define	kHugePageSize			(2 * 1024 * 1024)
+
+#ifndef MAP_HUGETLB
+	#define	MAP_HUGETLB		0
+#endif
+
+//*****************************************************************************
+//*	this sits in front of every buffer
+typedef struct	//	TYPE_PoolHeader
+{
+	uint32_t				magic;
+	int						classIdx;
+	size_t					mapSize;				//*	the whole mapping, including this header
+	size_t					requestSize;			//*	what the current owner asked for
+	bool					hugePages;
+	void					*nextFree;
+} TYPE_PoolHeader;
+
+typedef struct	//	TYPE_PoolClass
+{
+	TYPE_PoolHeader			*freeList;
+	int						inUseCnt;
+	int						cachedCnt;
+} TYPE_PoolClass;
+
+static pthread_mutex_t		gImagePoolMutex		=	PTHREAD_MUTEX_INITIALIZER;
+static TYPE_PoolClass		gPoolClass[kImagePool_MaxClasses];
+static TYPE_ImagePoolStats	gPoolStats;
+static bool					gUseHugePages		=	false;
+static bool					gLockMemory			=	false;
+static size_t				gMaxCachedBytes		=	kImagePool_DefaultMaxCached;
+
+//*****************************************************************************
+//*	64K, 80K, 96K, 112K, 128K, 160K ...
+//*****************************************************************************
+static size_t	GetClassSize(const int classIdx)
+{
+size_t	baseSize;
+
+	baseSize	=	(size_t)kImagePool_MinSize << (classIdx / kImagePool_ClassesPerDouble);
+	return((baseSize / kImagePool_ClassesPerDouble) * (kImagePool_ClassesPerDouble + (classIdx % kImagePool_ClassesPerDouble)));
+}
+
+//*****************************************************************************
+//*	returns -1 if it is too big
+//*****************************************************************************
+static int	GetClassIndex(const size_t byteCount)
+{
+int		classIdx;
+int		iii;
+
+	classIdx	=	-1;
+	for (iii=0; (iii<kImagePool_MaxClasses) && (classIdx < 0); iii++)
+	{
+		if (GetClassSize(iii) >= byteCount)
+		{
+			classIdx	=	iii;
+		}
+		else if (GetClassSize(iii) > (SIZE_MAX / 2))
+		{
+			//*	the next one would wrap around on a 32 bit system
+			break;
+		}
+	}
+	return(classIdx);
+}
+
+//*****************************************************************************
+//*	gPoolStats.bytesMapped etc need to be updated while locked
+//*****************************************************************************
+static void	UpdateFragmentation(void)
+{
+	gPoolStats.bytesMapped	=	gPoolStats.bytesInUse + gPoolStats.bytesCached;
+	if (gPoolStats.bytesInUse > gPoolStats.highWaterInUse)
+	{
+		gPoolStats.highWaterInUse	=	gPoolStats.bytesInUse;
+	}
+	if (gPoolStats.bytesMapped > gPoolStats.highWaterMapped)
+	{
+		gPoolStats.highWaterMapped	=	gPoolStats.bytesMapped;
+	}
+	gPoolStats.fragmentation_pct	=	0.0;
+	if (gPoolStats.bytesInUse > 0)
+	{
+		gPoolStats.fragmentation_pct	=	(100.0 * (gPoolStats.bytesInUse - gPoolStats.bytesRequested)) /
+											gPoolStats.bytesInUse;
+	}
+}
+
+//*****************************************************************************
+//*	called without the lock, it can take a while
+//*****************************************************************************
+static TYPE_PoolHeader	*MapBuffer(const int classIdx, const bool useHugePages, const bool lockMemory)
+{
+TYPE_PoolHeader	*poolHeader;
+void			*mapPtr;
+size_t			mapSize;
+bool			gotHugePages;
+
+	poolHeader		=	NULL;
+	gotHugePages	=	false;
+	mapSize			=	GetClassSize(classIdx);
+	mapPtr			=	MAP_FAILED;
+	if (useHugePages && (MAP_HUGETLB != 0))
+	{
+		//*	huge page mappings have to be a multiple of the huge page size
+		mapSize	=	((mapSize + kHugePageSize - 1) / kHugePageSize) * kHugePageSize;
+		mapPtr	=	mmap(NULL, mapSize, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB), -1, 0);
+		if (mapPtr != MAP_FAILED)
+		{
+			gotHugePages	=	true;
+		}
+		else
+		{
+			mapSize	=	GetClassSize(classIdx);
+		}
+	}
+	if (mapPtr == MAP_FAILED)
+	{
+		mapPtr	=	mmap(NULL, mapSize, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+	}
+	if (mapPtr != MAP_FAILED)
+	{
+		poolHeader				=	(TYPE_PoolHeader *)mapPtr;
+		poolHeader->magic		=	kImagePoolMagic;
+		poolHeader->classIdx	=	classIdx;
+		poolHeader->mapSize		=	mapSize;
+		poolHeader->hugePages	=	gotHugePages;
+		poolHeader->nextFree	=	NULL;
+		if (lockMemory && (mlock(mapPtr, mapSize) != 0))
+		{
+			//*	still usable, just not locked
+			CONSOLE_DEBUG_W_NUM("mlock() failed, errno\t=", errno);
+			pthread_mutex_lock(&gImagePoolMutex);
+			gPoolStats.lockFailCnt++;
+			pthread_mutex_unlock(&gImagePoolMutex);
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_SIZE("mmap() failed, size\t=", mapSize);
+	}
+	return(poolHeader);
+}
+
+//*****************************************************************************
+static void	UnmapBuffer(TYPE_PoolHeader *poolHeader)
+{
+	poolHeader->magic	=	0;
+	munmap(poolHeader, poolHeader->mapSize);
+}
+
+//*****************************************************************************
+void	ImagePool_SetOptions(const bool useHugePages, const bool lockMemory, const size_t maxCachedBytes)
+{
+	pthread_mutex_lock(&gImagePoolMutex);
+	gUseHugePages	=	useHugePages;
+	gLockMemory		=	lockMemory;
+	gMaxCachedBytes	=	maxCachedBytes;
+	pthread_mutex_unlock(&gImagePoolMutex);
+	if (useHugePages && (MAP_HUGETLB == 0))
+	{
+		CONSOLE_DEBUG("Huge pages are not supported on this system");
+	}
+}
+
+//*****************************************************************************
+void	*ImagePool_Alloc(const size_t byteCount)
+{
+TYPE_PoolHeader	*poolHeader;
+int				classIdx;
+bool			useHugePages;
+bool			lockMemory;
+void			*bufferPtr;
+
+	bufferPtr	=	NULL;
+	poolHeader	=	NULL;
+	classIdx	=	GetClassIndex(byteCount + kImagePoolHeaderSize);
+	if (classIdx >= 0)
+	{
+		pthread_mutex_lock(&gImagePoolMutex);
+		gPoolStats.allocCnt++;
+		poolHeader	=	gPoolClass[classIdx].freeList;
+		if (poolHeader != NULL)
+		{
+			gPoolClass[classIdx].freeList	=	(TYPE_PoolHeader *)poolHeader->nextFree;
+			gPoolClass[classIdx].cachedCnt--;
+			gPoolStats.buffersCached--;
+			gPoolStats.bytesCached			-=	GetClassSize(classIdx);
+			gPoolStats.poolHits++;
+		}
+		useHugePages	=	gUseHugePages;
+		lockMemory		=	gLockMemory;
+		pthread_mutex_unlock(&gImagePoolMutex);
+
+		if (poolHeader == NULL)
+		{
+			poolHeader	=	MapBuffer(classIdx, useHugePages, lockMemory);
+			if (poolHeader == NULL)
+			{
+				//*	give back everything that is not being used and try again
+				ImagePool_Trim();
+				poolHeader	=	MapBuffer(classIdx, useHugePages, lockMemory);
+			}
+			if (poolHeader != NULL)
+			{
+				pthread_mutex_lock(&gImagePoolMutex);
+				gPoolStats.mapCnt++;
+				if (poolHeader->hugePages)
+				{
+					gPoolStats.hugePageCnt++;
+				}
+				pthread_mutex_unlock(&gImagePoolMutex);
+			}
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_SIZE("Request is too big\t=", byteCount);
+	}
+
+	if (poolHeader != NULL)
+	{
+		poolHeader->requestSize	=	byteCount;
+		poolHeader->nextFree	=	NULL;
+
+		pthread_mutex_lock(&gImagePoolMutex);
+		gPoolClass[classIdx].inUseCnt++;
+		gPoolStats.buffersInUse++;
+		gPoolStats.bytesInUse		+=	GetClassSize(classIdx);
+		gPoolStats.bytesRequested	+=	byteCount;
+		UpdateFragmentation();
+		pthread_mutex_unlock(&gImagePoolMutex);
+
+		bufferPtr	=	((unsigned char *)poolHeader) + kImagePoolHeaderSize;
+	}
+	return(bufferPtr);
+}
+
+//*****************************************************************************
+void	ImagePool_Free(void *bufferPtr)
+{
+TYPE_PoolHeader	*poolHeader;
+TYPE_PoolHeader	*unmapHeader;
+int				classIdx;
+size_t			classSize;
+
+	if (bufferPtr != NULL)
+	{
+		poolHeader	=	(TYPE_PoolHeader *)(((unsigned char *)bufferPtr) - kImagePoolHeaderSize);
+		if (poolHeader->magic == kImagePoolMagic)
+		{
+			unmapHeader	=	NULL;
+			classIdx	=	poolHeader->classIdx;
+			classSize	=	GetClassSize(classIdx);
+
+			pthread_mutex_lock(&gImagePoolMutex);
+			gPoolStats.freeCnt++;
+			gPoolClass[classIdx].inUseCnt--;
+			gPoolStats.buffersInUse--;
+			gPoolStats.bytesInUse		-=	classSize;
+			gPoolStats.bytesRequested	-=	poolHeader->requestSize;
+			if ((gPoolStats.bytesCached + classSize) <= gMaxCachedBytes)
+			{
+				poolHeader->nextFree			=	gPoolClass[classIdx].freeList;
+				gPoolClass[classIdx].freeList	=	poolHeader;
+				gPoolClass[classIdx].cachedCnt++;
+				gPoolStats.buffersCached++;
+				gPoolStats.bytesCached			+=	classSize;
+			}
+			else
+			{
+				unmapHeader	=	poolHeader;
+				gPoolStats.unmapCnt++;
+			}
+			UpdateFragmentation();
+			pthread_mutex_unlock(&gImagePoolMutex);
+
+			if (unmapHeader != NULL)
+			{
+				UnmapBuffer(unmapHeader);
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG("Buffer did not come from ImagePool_Alloc()");
+			CONSOLE_ABORT(__FUNCTION__);
+		}
+	}
+}
+
+//*****************************************************************************
+size_t	ImagePool_GetUsableSize(const void *bufferPtr)
+{
+const TYPE_PoolHeader	*poolHeader;
+size_t					usableSize;
+
+	usableSize	=	0;
+	if (bufferPtr != NULL)
+	{
+		poolHeader	=	(const TYPE_PoolHeader *)(((const unsigned char *)bufferPtr) - kImagePoolHeaderSize);
+		if (poolHeader->magic == kImagePoolMagic)
+		{
+			usableSize	=	GetClassSize(poolHeader->classIdx) - kImagePoolHeaderSize;
+		}
+	}
+	return(usableSize);
+}
+
+//*****************************************************************************
+void	ImagePool_Trim(void)
+{
+TYPE_PoolHeader	*trimList;
+TYPE_PoolHeader	*poolHeader;
+int				iii;
+
+	//*	take them all off of the free lists while locked, unmap them after
+	trimList	=	NULL;
+	pthread_mutex_lock(&gImagePoolMutex);
+	for (iii=0; iii<kImagePool_MaxClasses; iii++)
+	{
+		while (gPoolClass[iii].freeList != NULL)
+		{
+			poolHeader						=	gPoolClass[iii].freeList;
+			gPoolClass[iii].freeList		=	(TYPE_PoolHeader *)poolHeader->nextFree;
+			poolHeader->nextFree			=	trimList;
+			trimList						=	poolHeader;
+			gPoolClass[iii].cachedCnt--;
+			gPoolStats.buffersCached--;
+			gPoolStats.bytesCached			-=	GetClassSize(iii);
+			gPoolStats.unmapCnt++;
+		}
+	}
+	UpdateFragmentation();
+	pthread_mutex_unlock(&gImagePoolMutex);
+
+	while (trimList != NULL)
+	{
+		poolHeader	=	trimList;
+		trimList	=	(TYPE_PoolHeader *)poolHeader->nextFree;
+		UnmapBuffer(poolHeader);
+	}
+}
+
+//*****************************************************************************
+void	ImagePool_GetStats(TYPE_ImagePoolStats *poolStats)
+{
+	pthread_mutex_lock(&gImagePoolMutex);
+	*poolStats	=	gPoolStats;
+	pthread_mutex_unlock(&gImagePoolMutex);
+}
+
+//*****************************************************************************
+bool	ImagePool_GetClassStats(const int classIdx, size_t *classSize, int *inUseCnt, int *cachedCnt)
+{
+bool	validClass;
+
+	validClass	=	false;
+	if ((classIdx >= 0) && (classIdx < kImagePool_MaxClasses))
+	{
+		pthread_mutex_lock(&gImagePoolMutex);
+		*classSize	=	GetClassSize(classIdx);
+		*inUseCnt	=	gPoolClass[classIdx].inUseCnt;
+		*cachedCnt	=	gPoolClass[classIdx].cachedCnt;
+		pthread_mutex_unlock(&gImagePoolMutex);
+		validClass	=	true;
+	}
+	return(validClass);
+}
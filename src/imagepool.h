@@ -0,0 +1,76 @@
+//**************************************************************************
+//*	Name:			imagepool.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Pool of large image buffers shared by all cameras
+//*
+//*****************************************************************************
+//#include	"imagepool.h"
+
+#ifndef _IMAGEPOOL_H_
+#define	_IMAGEPOOL_H_
+
+#include	<stdint.h>
+#include	<stddef.h>
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*	4 size classes per power of 2, the most a buffer can be rounded up is 25%
+#define	kImagePool_ClassesPerDouble		4
+#define	kImagePool_MaxClasses			64
+#define	kImagePool_MinSize				(64 * 1024)
+#define	kImagePool_DefaultMaxCached		(256 * 1024 * 1024)
+
+//*****************************************************************************
+typedef struct	//	TYPE_ImagePoolStats
+{
+	uint64_t	allocCnt;				//*	calls to ImagePool_Alloc()
+	uint64_t	freeCnt;
+	uint64_t	poolHits;				//*	satisfied from a free buffer
+	uint64_t	mapCnt;					//*	new large allocations (mmap)
+	uint64_t	unmapCnt;				//*	buffers given back to the system
+	uint64_t	hugePageCnt;			//*	mappings that got huge pages
+	uint64_t	lockFailCnt;			//*	mlock() failures
+	size_t		bytesRequested;			//*	what the callers asked for, buffers in use
+	size_t		bytesInUse;				//*	size class of the buffers in use
+	size_t		bytesCached;			//*	free buffers kept for reuse
+	size_t		bytesMapped;			//*	in use + cached
+	size_t		highWaterInUse;
+	size_t		highWaterMapped;
+	int			buffersInUse;
+	int			buffersCached;
+	double		fragmentation_pct;		//*	part of the buffers in use nobody asked for (size class rounding)
+} TYPE_ImagePoolStats;
+
+//*	huge pages and mlock() are both off by default, call this before the cameras start
+void	ImagePool_SetOptions(const bool useHugePages, const bool lockMemory, const size_t maxCachedBytes);
+
+//*	the memory is not cleared, it is aligned to 64 bytes. NULL if there is no memory
+void	*ImagePool_Alloc(const size_t byteCount);
+
+//*	only for buffers that came from ImagePool_Alloc(), NULL is ignored
+void	ImagePool_Free(void *bufferPtr);
+
+//*	how many bytes can be used in a buffer from ImagePool_Alloc() (the size class)
+size_t	ImagePool_GetUsableSize(const void *bufferPtr);
+
+//*	gives all of the free buffers back to the system
+void	ImagePool_Trim(void);
+
+void	ImagePool_GetStats(TYPE_ImagePoolStats *poolStats);
+
+//*	per size class, returns false past the last class
+bool	ImagePool_GetClassStats(const int classIdx, size_t *classSize, int *inUseCnt, int *cachedCnt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_IMAGEPOOL_H_
@@ -0,0 +1,416 @@
+//*****************************************************************************
+//*
+//*	Name:			imagepooltest.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Checks that imagepool.c stops allocating once a sequence is warmed up
+//*
+//*	Usage notes:	Plays the buffer traffic of a camera sequence against the pool:
+//*					the frame slots (they only grow), a save job copy of each frame,
+//*					the imagearray download chunk, a reduced preview and the FITS
+//*					color planes, with two cameras and a save writer thread that frees
+//*					the save job copies.
+//*
+//*					The warm up goes through every frame size and image type
+//*					(full frame, bin 2, sub frame, RAW8/RAW16/RGB24) including the most
+//*					save job copies that can be waiting for the writer at once.
+//*					Then the same sizes are run over and over in a different order
+//*					and the number of mmap() calls must not go up.
+//*					Every buffer is filled with a pattern and checked before it is freed,
+//*					so two owners of one buffer would show up.
+//*
+//*					Exits with 1 if anything is wrong.
+//*
+//*		imagepooltest
+//*		imagepooltest -n 2000 -H -L
+//*
+//*		-n	number of steady state exposures (default 500)
+//*		-H	use huge pages
+//*		-L	mlock() the buffers
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created imagepooltest.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	<pthread.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"imagepool.h"
+
+#define	kCameraCnt		2
+#define	kSlotCnt		7
+#define	kSaveQueueLen	4
+#define	kChunkSize		(1024 * 1024)
+
+//*	a 1/2 size sensor keeps the test quick, the sizes are what matter
+#define	kSensorWidth	2072
+#define	kSensorHeight	1411
+
+//*****************************************************************************
+typedef struct
+{
+	int		width;
+	int		height;
+	int		bytesPerPixel;
+} TYPE_FrameSize;
+
+static const TYPE_FrameSize	gFrameSizes[]	=
+{
+	{	kSensorWidth,		kSensorHeight,		2	},	//*	RAW16
+	{	kSensorWidth,		kSensorHeight,		1	},	//*	RAW8
+	{	kSensorWidth,		kSensorHeight,		3	},	//*	RGB24
+	{	kSensorWidth / 2,	kSensorHeight / 2,	2	},	//*	bin 2
+	{	kSensorWidth / 2,	kSensorHeight / 2,	3	},
+	{	1024,				768,				2	},	//*	sub frame
+};
+#define	kFrameSizeCnt	((int)(sizeof(gFrameSizes) / sizeof(TYPE_FrameSize)))
+
+typedef struct
+{
+	unsigned char	*dataBuffer;
+	long			dataBuffLen;
+} TYPE_TestSlot;
+
+typedef struct
+{
+	TYPE_TestSlot	slot[kSlotCnt];
+	int				nextSlot;
+} TYPE_TestCamera;
+
+//*****************************************************************************
+//*	save job copies are freed by the writer thread, like cameradriver_save.cpp
+static pthread_mutex_t	gQueueMutex		=	PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	gQueueCond		=	PTHREAD_COND_INITIALIZER;
+static unsigned char	*gSaveQueue[kSaveQueueLen];
+static long				gSaveQueueSize[kSaveQueueLen];
+static int				gSaveQueueCnt	=	0;
+static bool				gWriterRunning	=	true;
+static bool				gPatternOK		=	true;
+
+//*****************************************************************************
+static void	FillPattern(unsigned char *bufferPtr, long byteCount)
+{
+	//*	first and last page is enough to catch two owners of the same buffer
+	memset(bufferPtr, (int)(((uintptr_t)bufferPtr >> 6) & 0x0ff), (byteCount < 4096) ? byteCount : 4096);
+	memset(&bufferPtr[byteCount - 1], 0x5a, 1);
+}
+
+//*****************************************************************************
+static void	CheckPattern(unsigned char *bufferPtr, long byteCount)
+{
+unsigned char	expected;
+long			iii;
+
+	expected	=	(((uintptr_t)bufferPtr >> 6) & 0x0ff);
+	for (iii=0; (iii<4096) && (iii<byteCount) && gPatternOK; iii++)
+	{
+		if (bufferPtr[iii] != expected)
+		{
+			gPatternOK	=	false;
+		}
+	}
+	if (bufferPtr[byteCount - 1] != 0x5a)
+	{
+		gPatternOK	=	false;
+	}
+}
+
+//*****************************************************************************
+static void	*SaveWriterThread(void *arg)
+{
+unsigned char	*saveBuffer;
+long			saveSize;
+
+	(void)arg;
+	pthread_mutex_lock(&gQueueMutex);
+	while (gWriterRunning || (gSaveQueueCnt > 0))
+	{
+		if (gSaveQueueCnt > 0)
+		{
+			gSaveQueueCnt--;
+			saveBuffer	=	gSaveQueue[gSaveQueueCnt];
+			saveSize	=	gSaveQueueSize[gSaveQueueCnt];
+			pthread_cond_broadcast(&gQueueCond);
+			pthread_mutex_unlock(&gQueueMutex);
+
+			CheckPattern(saveBuffer, saveSize);
+			ImagePool_Free(saveBuffer);
+
+			pthread_mutex_lock(&gQueueMutex);
+		}
+		else
+		{
+			pthread_cond_wait(&gQueueCond, &gQueueMutex);
+		}
+	}
+	pthread_mutex_unlock(&gQueueMutex);
+	return(NULL);
+}
+
+//*****************************************************************************
+static void	QueueSave(unsigned char *saveBuffer, long saveSize)
+{
+	pthread_mutex_lock(&gQueueMutex);
+	while (gSaveQueueCnt >= kSaveQueueLen)
+	{
+		pthread_cond_wait(&gQueueCond, &gQueueMutex);
+	}
+	gSaveQueue[gSaveQueueCnt]		=	saveBuffer;
+	gSaveQueueSize[gSaveQueueCnt]	=	saveSize;
+	gSaveQueueCnt++;
+	pthread_cond_broadcast(&gQueueCond);
+	pthread_mutex_unlock(&gQueueMutex);
+}
+
+//*****************************************************************************
+//*	the same as AllocateImageBuffer(), the slot only gets a new buffer if it has to grow
+//*****************************************************************************
+static unsigned char	*GetSlotBuffer(TYPE_TestCamera *camera, long bufferSize)
+{
+TYPE_TestSlot	*slot;
+
+	slot				=	&camera->slot[camera->nextSlot];
+	camera->nextSlot	=	(camera->nextSlot + 1) % kSlotCnt;
+	if ((slot->dataBuffer == NULL) || (bufferSize > slot->dataBuffLen))
+	{
+		ImagePool_Free(slot->dataBuffer);
+		slot->dataBuffer	=	(unsigned char *)ImagePool_Alloc(bufferSize);
+		slot->dataBuffLen	=	bufferSize;
+	}
+	return(slot->dataBuffer);
+}
+
+//*****************************************************************************
+//*	one exposure worth of buffer traffic
+//*****************************************************************************
+static bool	TakeExposure(TYPE_TestCamera *camera, const TYPE_FrameSize *frameSize)
+{
+unsigned char	*frameBuffer;
+unsigned char	*saveBuffer;
+unsigned char	*chunkBuffer;
+unsigned char	*previewBuffer;
+unsigned char	*fitsBuffer;
+long			frameBytes;
+long			previewBytes;
+bool			allocOK;
+
+	frameBytes		=	(long)frameSize->width * frameSize->height * frameSize->bytesPerPixel;
+	previewBytes	=	frameBytes / 16;
+	frameBuffer		=	GetSlotBuffer(camera, frameBytes);
+	saveBuffer		=	(unsigned char *)ImagePool_Alloc(frameBytes);
+	chunkBuffer		=	(unsigned char *)ImagePool_Alloc(kChunkSize + 256);
+	previewBuffer	=	(unsigned char *)ImagePool_Alloc(previewBytes);
+	fitsBuffer		=	NULL;
+	if (frameSize->bytesPerPixel == 3)
+	{
+		fitsBuffer	=	(unsigned char *)ImagePool_Alloc(frameBytes + 100);
+	}
+	allocOK	=	(frameBuffer != NULL) && (saveBuffer != NULL) && (chunkBuffer != NULL) && (previewBuffer != NULL) &&
+				((fitsBuffer != NULL) || (frameSize->bytesPerPixel != 3));
+
+	if (allocOK)
+	{
+		FillPattern(chunkBuffer, kChunkSize + 256);
+		FillPattern(previewBuffer, previewBytes);
+		FillPattern(saveBuffer, frameBytes);
+		if (fitsBuffer != NULL)
+		{
+			FillPattern(fitsBuffer, frameBytes + 100);
+			CheckPattern(fitsBuffer, frameBytes + 100);
+		}
+		CheckPattern(chunkBuffer, kChunkSize + 256);
+		CheckPattern(previewBuffer, previewBytes);
+		QueueSave(saveBuffer, frameBytes);
+	}
+	else
+	{
+		ImagePool_Free(saveBuffer);
+	}
+	ImagePool_Free(chunkBuffer);
+	ImagePool_Free(previewBuffer);
+	ImagePool_Free(fitsBuffer);
+	return(allocOK);
+}
+
+//*****************************************************************************
+//*	the most save job copies that can be out at once are the queue, the one the
+//*	writer is working on and the one being filled, the warm up has to get there for every size
+//*****************************************************************************
+static void	WarmUpSaveCopies(const TYPE_FrameSize *frameSize)
+{
+unsigned char	*saveBuffer[kSaveQueueLen + 2];
+long			frameBytes;
+int				iii;
+
+	frameBytes	=	(long)frameSize->width * frameSize->height * frameSize->bytesPerPixel;
+	for (iii=0; iii<(kSaveQueueLen + 2); iii++)
+	{
+		saveBuffer[iii]	=	(unsigned char *)ImagePool_Alloc(frameBytes);
+	}
+	for (iii=0; iii<(kSaveQueueLen + 2); iii++)
+	{
+		ImagePool_Free(saveBuffer[iii]);
+	}
+}
+
+//*****************************************************************************
+static void	PrintStats(const char *title)
+{
+TYPE_ImagePoolStats	poolStats;
+
+	ImagePool_GetStats(&poolStats);
+	printf("%-14s allocs=%-7ld hits=%-7ld mmaps=%-4ld unmaps=%-4ld huge=%-4ld mapped=%6.1f MB  high water=%6.1f MB  frag=%4.1f%%\r\n",
+											title,
+											(long)poolStats.allocCnt,
+											(long)poolStats.poolHits,
+											(long)poolStats.mapCnt,
+											(long)poolStats.unmapCnt,
+											(long)poolStats.hugePageCnt,
+											(poolStats.bytesMapped / (1024.0 * 1024.0)),
+											(poolStats.highWaterMapped / (1024.0 * 1024.0)),
+											poolStats.fragmentation_pct);
+}
+
+//*****************************************************************************
+int	main(int argc, char *argv[])
+{
+TYPE_TestCamera		camera[kCameraCnt];
+TYPE_ImagePoolStats	warmStats;
+TYPE_ImagePoolStats	endStats;
+pthread_t			writerThreadID;
+int					exposureCnt;
+bool				useHugePages;
+bool				lockMemory;
+bool				allOK;
+int					iii;
+int					ccc;
+int					sss;
+
+	exposureCnt		=	500;
+	useHugePages	=	false;
+	lockMemory		=	false;
+	for (iii=1; iii<argc; iii++)
+	{
+		if ((strcmp(argv[iii], "-n") == 0) && (iii < (argc - 1)))
+		{
+			exposureCnt		=	atoi(argv[++iii]);
+		}
+		else if (strcmp(argv[iii], "-H") == 0)
+		{
+			useHugePages	=	true;
+		}
+		else if (strcmp(argv[iii], "-L") == 0)
+		{
+			lockMemory		=	true;
+		}
+	}
+	//*	room for all of the save job copies of the biggest frame
+	ImagePool_SetOptions(useHugePages, lockMemory, kImagePool_DefaultMaxCached * 2);
+
+	memset(camera, 0, sizeof(camera));
+	pthread_create(&writerThreadID, NULL, &SaveWriterThread, NULL);
+
+	allOK	=	true;
+	//*	warm up, every size on each camera, smallest first so the slots have to grow
+	for (sss=kFrameSizeCnt-1; sss>=0; sss--)
+	{
+		for (ccc=0; ccc<kCameraCnt; ccc++)
+		{
+			for (iii=0; iii<kSlotCnt; iii++)
+			{
+				allOK	&=	TakeExposure(&camera[ccc], &gFrameSizes[sss]);
+			}
+		}
+		//*	as if the writer fell all the way behind
+		while (gSaveQueueCnt > 0)
+		{
+			usleep(1000);
+		}
+		WarmUpSaveCopies(&gFrameSizes[sss]);
+	}
+	PrintStats("warm up");
+	ImagePool_GetStats(&warmStats);
+
+	//*	steady state, the sizes in a different order each time
+	for (iii=0; iii<exposureCnt; iii++)
+	{
+		sss	=	(iii * 7 + (iii / kFrameSizeCnt)) % kFrameSizeCnt;
+		for (ccc=0; ccc<kCameraCnt; ccc++)
+		{
+			allOK	&=	TakeExposure(&camera[ccc], &gFrameSizes[sss]);
+		}
+	}
+
+	pthread_mutex_lock(&gQueueMutex);
+	gWriterRunning	=	false;
+	pthread_cond_broadcast(&gQueueCond);
+	pthread_mutex_unlock(&gQueueMutex);
+	pthread_join(writerThreadID, NULL);
+
+	PrintStats("steady state");
+	ImagePool_GetStats(&endStats);
+
+	if (allOK == false)
+	{
+		printf("Allocation failed\r\n");
+	}
+	if (gPatternOK == false)
+	{
+		printf("A buffer was overwritten, two owners of the same buffer\r\n");
+		allOK	=	false;
+	}
+	if (endStats.mapCnt != warmStats.mapCnt)
+	{
+		printf("%ld large allocations after the warm up, expected 0\r\n", (long)(endStats.mapCnt - warmStats.mapCnt));
+		allOK	=	false;
+	}
+	if (endStats.unmapCnt != warmStats.unmapCnt)
+	{
+		printf("%ld buffers given back after the warm up, expected 0\r\n", (long)(endStats.unmapCnt - warmStats.unmapCnt));
+		allOK	=	false;
+	}
+
+	//*	everything back, then the pool has to be empty
+	for (ccc=0; ccc<kCameraCnt; ccc++)
+	{
+		for (iii=0; iii<kSlotCnt; iii++)
+		{
+			ImagePool_Free(camera[ccc].slot[iii].dataBuffer);
+		}
+	}
+	ImagePool_Trim();
+	ImagePool_GetStats(&endStats);
+	if ((endStats.bytesMapped != 0) || (endStats.buffersInUse != 0) || (endStats.mapCnt != endStats.unmapCnt))
+	{
+		printf("Pool is not empty at the end\r\n");
+		allOK	=	false;
+	}
+
+	printf("%s\r\n", (allOK ? "All tests passed" : "FAILED"));
+	return(allOK ? 0 : 1);
+}
@@ -0,0 +1,240 @@
+//*****************************************************************************
+//*
+//*	Name:			imagereduce.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Crop, software bin and bit depth change of camera frames
+//*
+//*	Usage notes:	Used by imagearray when the client asks for a sub frame, a binned
+//*					preview or a different bit depth, focusing and framing tools
+//*					do not need the whole 20 megapixels.
+//*
+//*					Each output row is done in two passes. The first adds the binFactor
+//*					source rows of the block straight down into a row of 32 bit sums,
+//*					that loop is plain adds over contiguous memory so the compiler turns
+//*					it into SIMD code (the make file builds this file with -O3).
+//*					The second pass adds binFactor neighbouring sums together, divides
+//*					for the mean, shifts to the output depth and clips.
+//*					The second pass only touches 1 / binFactor of the data.
+//*
+//*					On a RAW bayer frame any bin factor mixes the colors,
+//*					the result is a mono image.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created imagereduce.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"imagereduce.h"
+
+//*****************************************************************************
+int	ImageReduce_GetOutputBytesPerPixel(const int srcFormat, const int dstBitDepth)
+{
+int		bytesPerPixel;
+
+	if (srcFormat == kImageReduce_BGR24)
+	{
+		bytesPerPixel	=	3;
+	}
+	else
+	{
+		bytesPerPixel	=	(dstBitDepth > 8) ? 2 : 1;
+	}
+	return(bytesPerPixel);
+}
+
+//*****************************************************************************
+//*	these two are the inner loops, keep them simple enough to vectorize
+//*****************************************************************************
+static void	AddRow_8bit(uint32_t *restrict rowSum, const uint8_t *restrict srcRow, const int valueCnt)
+{
+int		iii;
+
+	for (iii=0; iii<valueCnt; iii++)
+	{
+		rowSum[iii]	+=	srcRow[iii];
+	}
+}
+
+//*****************************************************************************
+static void	AddRow_16bit(uint32_t *restrict rowSum, const uint16_t *restrict srcRow, const int valueCnt)
+{
+int		iii;
+
+	for (iii=0; iii<valueCnt; iii++)
+	{
+		rowSum[iii]	+=	srcRow[iii];
+	}
+}
+
+//*****************************************************************************
+bool	ImageReduce_Frame(	const unsigned char	*srcData,
+							const int			srcWidth,
+							const int			srcHeight,
+							const int			srcFormat,
+							const int			startX,
+							const int			startY,
+							const int			numX,
+							const int			numY,
+							const int			binFactor,
+							const int			binMode,
+							const int			dstBitDepth,
+							unsigned char		*dstData)
+{
+int				channelCnt;
+int				srcBytesPerPixel;
+int				srcBitDepth;
+int				outBitDepth;
+int				dstBytesPerPixel;
+int				dstWidth;
+int				dstHeight;
+int				valueCnt;
+long			srcRowBytes;
+long			dstRowBytes;
+uint32_t		*rowSum;
+uint64_t		blockSum;
+uint32_t		blockArea;
+uint32_t		maxValue;
+const uint8_t	*srcRow;
+uint8_t			*dstRow8;
+uint16_t		*dstRow16;
+int				dx;
+int				dy;
+int				bbb;
+int				ccc;
+int				valueIdx;
+bool			reduceOK;
+
+	reduceOK	=	false;
+	if ((srcData != NULL) && (dstData != NULL) &&
+		(srcFormat >= 0) && (srcFormat < kImageReduce_last) &&
+		(binMode >= kImageReduce_Mean) && (binMode <= kImageReduce_Sum) &&
+		(binFactor >= 1) && (binFactor <= kImageReduce_MaxBin) &&
+		((dstBitDepth == 8) || (dstBitDepth == 16)) &&
+		(startX >= 0) && (startY >= 0) && (numX >= binFactor) && (numY >= binFactor) &&
+		((startX + numX) <= srcWidth) && ((startY + numY) <= srcHeight))
+	{
+		channelCnt			=	(srcFormat == kImageReduce_BGR24) ? 3 : 1;
+		srcBytesPerPixel	=	(srcFormat == kImageReduce_Mono16) ? 2 : channelCnt;
+		srcBitDepth			=	(srcFormat == kImageReduce_Mono16) ? 16 : 8;
+		outBitDepth			=	(srcFormat == kImageReduce_BGR24) ? 8 : dstBitDepth;
+		dstBytesPerPixel	=	ImageReduce_GetOutputBytesPerPixel(srcFormat, dstBitDepth);
+		maxValue			=	(outBitDepth == 16) ? 0x0ffff : 0x0ff;
+		blockArea			=	binFactor * binFactor;
+
+		dstWidth			=	numX / binFactor;
+		dstHeight			=	numY / binFactor;
+		valueCnt			=	dstWidth * binFactor * channelCnt;
+		srcRowBytes			=	(long)srcWidth * srcBytesPerPixel;
+		dstRowBytes			=	(long)dstWidth * dstBytesPerPixel;
+
+		if ((binFactor == 1) && (srcBitDepth == outBitDepth))
+		{
+			//*	just a crop
+			for (dy=0; dy<dstHeight; dy++)
+			{
+				memcpy(	&dstData[dy * dstRowBytes],
+						&srcData[((startY + dy) * srcRowBytes) + ((long)startX * srcBytesPerPixel)],
+						dstRowBytes);
+			}
+			reduceOK	=	true;
+		}
+		else
+		{
+			rowSum	=	(uint32_t *)malloc(valueCnt * sizeof(uint32_t));
+			if (rowSum != NULL)
+			{
+				for (dy=0; dy<dstHeight; dy++)
+				{
+					//*	pass 1, add the rows of this block straight down
+					memset(rowSum, 0, valueCnt * sizeof(uint32_t));
+					for (bbb=0; bbb<binFactor; bbb++)
+					{
+						srcRow	=	&srcData[((startY + (dy * binFactor) + bbb) * srcRowBytes) + ((long)startX * srcBytesPerPixel)];
+						if (srcFormat == kImageReduce_Mono16)
+						{
+							AddRow_16bit(rowSum, (const uint16_t *)srcRow, valueCnt);
+						}
+						else
+						{
+							AddRow_8bit(rowSum, srcRow, valueCnt);
+						}
+					}
+
+					//*	pass 2, add across the block and convert
+					dstRow8		=	&dstData[dy * dstRowBytes];
+					dstRow16	=	(uint16_t *)dstRow8;
+					for (dx=0; dx<dstWidth; dx++)
+					{
+						for (ccc=0; ccc<channelCnt; ccc++)
+						{
+							valueIdx	=	(dx * binFactor * channelCnt) + ccc;
+							blockSum	=	0;
+							for (bbb=0; bbb<binFactor; bbb++)
+							{
+								blockSum	+=	rowSum[valueIdx];
+								valueIdx	+=	channelCnt;
+							}
+							if (binMode == kImageReduce_Mean)
+							{
+								blockSum	=	(blockSum + (blockArea / 2)) / blockArea;
+							}
+							if (srcBitDepth > outBitDepth)
+							{
+								blockSum	=	blockSum >> 8;
+							}
+							else if (srcBitDepth < outBitDepth)
+							{
+								blockSum	=	blockSum << 8;
+							}
+							if (blockSum > maxValue)
+							{
+								blockSum	=	maxValue;
+							}
+							if (outBitDepth == 16)
+							{
+								dstRow16[dx]	=	blockSum;
+							}
+							else
+							{
+								dstRow8[(dx * channelCnt) + ccc]	=	blockSum;
+							}
+						}
+					}
+				}
+				free(rowSum);
+				reduceOK	=	true;
+			}
+			else
+			{
+				CONSOLE_DEBUG("Failed to allocate memory");
+			}
+		}
+	}
+	return(reduceOK);
+}
@@ -0,0 +1,64 @@
+//**************************************************************************
+//*	Name:			imagereduce.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Crop, software bin and bit depth change of camera frames
+//*
+//*****************************************************************************
+//#include	"imagereduce.h"
+
+#ifndef _IMAGEREDUCE_H_
+#define	_IMAGEREDUCE_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+enum
+{
+	kImageReduce_Mono8	=	0,		//*	8 bit pixels (also RAW8 bayer)
+	kImageReduce_Mono16,			//*	16 bit pixels in native byte order
+	kImageReduce_BGR24,				//*	24 bit BGR (openCV order), output is always 8 bits per color
+
+	kImageReduce_last
+};
+
+//*	what happens to the pixels of a bin block
+enum
+{
+	kImageReduce_Mean	=	0,		//*	average, rounded
+	kImageReduce_Sum				//*	sum, clipped at the largest value of the output bit depth
+};
+
+#define	kImageReduce_MaxBin		16
+
+//*	the output is (numX / binFactor) x (numY / binFactor), a partial block at the edge is dropped
+int		ImageReduce_GetOutputBytesPerPixel(const int srcFormat, const int dstBitDepth);
+
+//*	crops startX,startY,numX,numY out of the source, bins it and converts it
+//*	to dstBitDepth (8 or 16), the output is packed row major in the same layout as the source.
+//*	returns false if the arguments do not make sense, nothing is written in that case
+bool	ImageReduce_Frame(	const unsigned char	*srcData,
+							const int			srcWidth,
+							const int			srcHeight,
+							const int			srcFormat,
+							const int			startX,
+							const int			startY,
+							const int			numX,
+							const int			numY,
+							const int			binFactor,
+							const int			binMode,
+							const int			dstBitDepth,
+							unsigned char		*dstData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_IMAGEREDUCE_H_
@@ -0,0 +1,266 @@
+//*****************************************************************************
+//*
+//*	Name:			imagescale.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Box filter down scaling of camera frames to 8 bit preview images
+//*
+//*	Usage notes:	Used for the MJPEG live view, a 20 megapixel frame gets shrunk to
+//*					something a browser can show before it is JPEG compressed,
+//*					which is much cheaper than compressing the full frame.
+//*
+//*					Every source pixel is read exactly once, each output pixel is the
+//*					average of the block of source pixels it covers. On a RAW bayer
+//*					frame the block covers all of the colors so the result is a clean
+//*					mono image instead of the checker board that skipping pixels gives.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created imagescale.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+
+//#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"imagescale.h"
+
+//*****************************************************************************
+void	ImageScale_FitSize(	const int	srcWidth,
+							const int	srcHeight,
+							const int	maxWidth,
+							const int	maxHeight,
+							int			*dstWidth,
+							int			*dstHeight)
+{
+double	scaleFactor;
+double	heightScale;
+
+	scaleFactor	=	1.0;
+	if ((maxWidth > 0) && (maxWidth < srcWidth))
+	{
+		scaleFactor	=	(1.0 * maxWidth) / srcWidth;
+	}
+	if ((maxHeight > 0) && (maxHeight < srcHeight))
+	{
+		heightScale	=	(1.0 * maxHeight) / srcHeight;
+		if (heightScale < scaleFactor)
+		{
+			scaleFactor	=	heightScale;
+		}
+	}
+	*dstWidth	=	(int)((srcWidth * scaleFactor) + 0.5);
+	*dstHeight	=	(int)((srcHeight * scaleFactor) + 0.5);
+	if (*dstWidth < 1)
+	{
+		*dstWidth	=	1;
+	}
+	if (*dstHeight < 1)
+	{
+		*dstHeight	=	1;
+	}
+	if (*dstWidth > srcWidth)
+	{
+		*dstWidth	=	srcWidth;
+	}
+	if (*dstHeight > srcHeight)
+	{
+		*dstHeight	=	srcHeight;
+	}
+}
+
+//*****************************************************************************
+int	ImageScale_OutputChannels(const int srcFormat)
+{
+	return((srcFormat == kImageScale_BGR24) ? 3 : 1);
+}
+
+//*****************************************************************************
+//*	adds one source row into the column sums
+//*	xStart[] has dstWidth + 1 entries, the block for dx is xStart[dx] to xStart[dx+1]
+//*****************************************************************************
+static void	AddRow_Mono8(const unsigned char *srcRow, const int *xStart, const int dstWidth, uint64_t *colSum)
+{
+int			dx;
+int			xxx;
+uint32_t	blockSum;
+
+	for (dx=0; dx<dstWidth; dx++)
+	{
+		blockSum	=	0;
+		for (xxx=xStart[dx]; xxx<xStart[dx + 1]; xxx++)
+		{
+			blockSum	+=	srcRow[xxx];
+		}
+		colSum[dx]	+=	blockSum;
+	}
+}
+
+//*****************************************************************************
+static void	AddRow_Mono16(const unsigned char *srcRow, const int *xStart, const int dstWidth, uint64_t *colSum)
+{
+int			dx;
+int			xxx;
+uint32_t	blockSum;
+
+	for (dx=0; dx<dstWidth; dx++)
+	{
+		blockSum	=	0;
+		for (xxx=xStart[dx]; xxx<xStart[dx + 1]; xxx++)
+		{
+			blockSum	+=	srcRow[(xxx * 2)] | (srcRow[(xxx * 2) + 1] << 8);
+		}
+		colSum[dx]	+=	blockSum;
+	}
+}
+
+//*****************************************************************************
+static void	AddRow_BGR24(const unsigned char *srcRow, const int *xStart, const int dstWidth, uint64_t *colSum)
+{
+int			dx;
+int			xxx;
+uint32_t	blueSum;
+uint32_t	greenSum;
+uint32_t	redSum;
+
+	for (dx=0; dx<dstWidth; dx++)
+	{
+		blueSum		=	0;
+		greenSum	=	0;
+		redSum		=	0;
+		for (xxx=xStart[dx]; xxx<xStart[dx + 1]; xxx++)
+		{
+			blueSum		+=	srcRow[(xxx * 3)];
+			greenSum	+=	srcRow[(xxx * 3) + 1];
+			redSum		+=	srcRow[(xxx * 3) + 2];
+		}
+		colSum[(dx * 3)]		+=	blueSum;
+		colSum[(dx * 3) + 1]	+=	greenSum;
+		colSum[(dx * 3) + 2]	+=	redSum;
+	}
+}
+
+//*****************************************************************************
+bool	ImageScale_BoxDownsample(	const unsigned char	*srcData,
+									const int			srcWidth,
+									const int			srcHeight,
+									const int			srcFormat,
+									unsigned char		*dstData,
+									const int			dstWidth,
+									const int			dstHeight,
+									const bool			swapRedBlue)
+{
+int				bytesPerPixel;
+int				channelCnt;
+long			srcRowBytes;
+int				*xStart;
+uint64_t		*colSum;
+uint64_t		blockArea;
+uint64_t		pixelValue;
+unsigned char	*dstRow;
+int				yStart;
+int				yEnd;
+int				dx;
+int				dy;
+int				yyy;
+int				ccc;
+int				srcChannel;
+bool			scaleOK;
+
+	scaleOK	=	false;
+	if ((srcData != NULL) && (dstData != NULL) &&
+		(srcFormat >= 0) && (srcFormat < kImageScale_last) &&
+		(dstWidth > 0) && (dstHeight > 0) &&
+		(dstWidth <= srcWidth) && (dstHeight <= srcHeight))
+	{
+		channelCnt		=	ImageScale_OutputChannels(srcFormat);
+		bytesPerPixel	=	(srcFormat == kImageScale_Mono16) ? 2 : channelCnt;
+		srcRowBytes		=	(long)srcWidth * bytesPerPixel;
+
+		xStart	=	(int *)malloc((dstWidth + 1) * sizeof(int));
+		colSum	=	(uint64_t *)malloc(dstWidth * channelCnt * sizeof(uint64_t));
+		if ((xStart != NULL) && (colSum != NULL))
+		{
+			//*	dstWidth <= srcWidth so every block is at least one pixel wide
+			for (dx=0; dx<=dstWidth; dx++)
+			{
+				xStart[dx]	=	(int)(((long)dx * srcWidth) / dstWidth);
+			}
+
+			for (dy=0; dy<dstHeight; dy++)
+			{
+				yStart	=	(int)(((long)dy * srcHeight) / dstHeight);
+				yEnd	=	(int)(((long)(dy + 1) * srcHeight) / dstHeight);
+				memset(colSum, 0, dstWidth * channelCnt * sizeof(uint64_t));
+				for (yyy=yStart; yyy<yEnd; yyy++)
+				{
+					switch(srcFormat)
+					{
+						case kImageScale_Mono8:
+							AddRow_Mono8(&srcData[yyy * srcRowBytes], xStart, dstWidth, colSum);
+							break;
+
+						case kImageScale_Mono16:
+							AddRow_Mono16(&srcData[yyy * srcRowBytes], xStart, dstWidth, colSum);
+							break;
+
+						case kImageScale_BGR24:
+							AddRow_BGR24(&srcData[yyy * srcRowBytes], xStart, dstWidth, colSum);
+							break;
+					}
+				}
+
+				dstRow	=	&dstData[(long)dy * dstWidth * channelCnt];
+				for (dx=0; dx<dstWidth; dx++)
+				{
+					blockArea	=	(uint64_t)(yEnd - yStart) * (xStart[dx + 1] - xStart[dx]);
+					for (ccc=0; ccc<channelCnt; ccc++)
+					{
+						srcChannel	=	(swapRedBlue && (channelCnt == 3)) ? (2 - ccc) : ccc;
+						pixelValue	=	(colSum[(dx * channelCnt) + srcChannel] + (blockArea / 2)) / blockArea;
+						if (srcFormat == kImageScale_Mono16)
+						{
+							pixelValue	=	pixelValue >> 8;
+						}
+						dstRow[(dx * channelCnt) + ccc]	=	pixelValue;
+					}
+				}
+			}
+			scaleOK	=	true;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Failed to allocate memory");
+		}
+		if (xStart != NULL)
+		{
+			free(xStart);
+		}
+		if (colSum != NULL)
+		{
+			free(colSum);
+		}
+	}
+	return(scaleOK);
+}
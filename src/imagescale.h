@@ -0,0 +1,60 @@
+//**************************************************************************
+//*	Name:			imagescale.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Box filter down scaling of camera frames to 8 bit preview images
+//*
+//*****************************************************************************
+//#include	"imagescale.h"
+
+#ifndef _IMAGESCALE_H_
+#define	_IMAGESCALE_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+enum
+{
+	kImageScale_Mono8	=	0,		//*	8 bit pixels (also RAW8 bayer, the box averages out the color)
+	kImageScale_Mono16,				//*	16 bit little endian pixels, the output is the high byte
+	kImageScale_BGR24,				//*	24 bit BGR (openCV order)
+
+	kImageScale_last
+};
+
+//*	largest size that fits in maxWidth x maxHeight with the same aspect ratio,
+//*	never larger than the source. 0 means no limit for that direction
+void	ImageScale_FitSize(	const int	srcWidth,
+							const int	srcHeight,
+							const int	maxWidth,
+							const int	maxHeight,
+							int			*dstWidth,
+							int			*dstHeight);
+
+//*	number of bytes per pixel in the output, 1 for mono, 3 for color
+int		ImageScale_OutputChannels(const int srcFormat);
+
+//*	each output pixel is the average of the source pixels it covers.
+//*	the output must not be larger than the source.
+//*	color output is BGR unless swapRedBlue is set (libjpeg wants RGB)
+bool	ImageScale_BoxDownsample(	const unsigned char	*srcData,
+									const int			srcWidth,
+									const int			srcHeight,
+									const int			srcFormat,
+									unsigned char		*dstData,
+									const int			dstWidth,
+									const int			dstHeight,
+									const bool			swapRedBlue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_IMAGESCALE_H_
@@ -0,0 +1,534 @@
+//*****************************************************************************
+//*
+//*	Name:			jsonparsebench.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Checks and times the json parser
+//*
+//*	Usage notes:	SJP_ParseData() now uses the in place tokenizer (json_tokenizer.c).
+//*					First its token lists are compared against SJP_ParseData_Legacy()
+//*					on a set of typical Alpaca replies, the tokenizer is also fed the
+//*					data a few bytes at a time to check that it picks up where it left off.
+//*					Then the old parser, the new one and the tokenizer by itself are timed.
+//*
+//*		jsonparsebench
+//*		jsonparsebench -n 20000
+//*
+//*		-n	number of times each reply is parsed for the timing (default 10000)
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created jsonparsebench.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<time.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"json_parse.h"
+#include	"json_tokenizer.h"
+
+static int	gBenchLoops	=	10000;
+
+//*****************************************************************************
+typedef struct
+{
+	const char	*name;
+	char		*jsonText;
+	const char	*lookupKey;		//*	key used for the lookup timing
+} TYPE_BenchReply;
+
+#define	kBenchReplyCnt	7
+static TYPE_BenchReply	gBenchReplies[kBenchReplyCnt];
+
+static const char	gHttpHeader[]	=	"HTTP/1.1 200 OK\r\n"
+										"Content-Type: application/json; charset=utf-8\r\n"
+										"Connection: keep-alive\r\n"
+										"Content-Length: 105\r\n"
+										"\r\n";
+
+//*****************************************************************************
+static char	*CopyString(const char *theString)
+{
+char	*newString;
+
+	newString	=	(char *)malloc(strlen(theString) + 1);
+	if (newString != NULL)
+	{
+		strcpy(newString, theString);
+	}
+	return(newString);
+}
+
+//*****************************************************************************
+//*	about 100 keys, like a camera readall
+//*****************************************************************************
+static char	*MakeReadAllReply(void)
+{
+char	*jsonText;
+char	*textPtr;
+int		iii;
+int		jjj;
+
+	jsonText	=	(char *)malloc(32768);
+	if (jsonText != NULL)
+	{
+		textPtr	=	jsonText;
+		textPtr	+=	sprintf(textPtr, "{\r\n\t\"Value\": {\r\n");
+		for (iii=0; iii<96; iii++)
+		{
+			switch(iii % 4)
+			{
+				case 0:	textPtr	+=	sprintf(textPtr, "\t\t\"property%02d\": %d,\r\n", iii, iii * 37);			break;
+				case 1:	textPtr	+=	sprintf(textPtr, "\t\t\"Property%02d\": %s,\r\n", iii, ((iii & 2) ? "true" : "false"));	break;
+				case 2:	textPtr	+=	sprintf(textPtr, "\t\t\"PROPERTY%02d\": %1.6f,\r\n", iii, iii / 7.0);		break;
+				case 3:	textPtr	+=	sprintf(textPtr, "\t\t\"propertyName%02d\": \"text \\\"%d\\\" a\\/b\\tc\",\r\n", iii, iii);	break;
+			}
+		}
+		//*	a value longer than the token list can hold, it gets cut off
+		textPtr	+=	sprintf(textPtr, "\t\t\"description\": \"");
+		for (jjj=0; jjj<40; jjj++)
+		{
+			textPtr	+=	sprintf(textPtr, "long text ");
+		}
+		textPtr	+=	sprintf(textPtr, "\",\r\n");
+		textPtr	+=	sprintf(textPtr, "\t\t\"readall-end\": true\r\n\t},\r\n");
+		textPtr	+=	sprintf(textPtr, "\t\"ClientTransactionID\": 0,\r\n\t\"ServerTransactionID\": 1234,\r\n");
+		textPtr	+=	sprintf(textPtr, "\t\"ErrorNumber\": 0,\r\n\t\"ErrorMessage\": \"\"\r\n}\r\n");
+	}
+	return(jsonText);
+}
+
+//*****************************************************************************
+static void	SetupReplies(void)
+{
+char	*httpReply;
+
+	gBenchReplies[0].name		=	"value";
+	gBenchReplies[0].jsonText	=	CopyString("{\"Value\":1.5,\"ClientTransactionID\":0,\"ServerTransactionID\":123,\"ErrorNumber\":0,\"ErrorMessage\":\"\"}");
+	gBenchReplies[0].lookupKey	=	"ErrorNumber";
+
+	gBenchReplies[1].name		=	"readall";
+	gBenchReplies[1].jsonText	=	MakeReadAllReply();
+	gBenchReplies[1].lookupKey	=	"readall-end";
+
+	gBenchReplies[2].name		=	"devicelist";
+	gBenchReplies[2].jsonText	=	CopyString(
+						"{\"Value\":[{\"DeviceName\":\"ZWO ASI1600MM\",\"DeviceType\":\"Camera\",\"DeviceNumber\":0,\"UniqueID\":\"a1b2c3\"},"
+						"{\"DeviceName\":\"EAF\",\"DeviceType\":\"Focuser\",\"DeviceNumber\":0,\"UniqueID\":\"d4e5f6\"},"
+						"{\"DeviceName\":\"EFW\",\"DeviceType\":\"FilterWheel\",\"DeviceNumber\":0,\"UniqueID\":\"g7h8i9\"}],"
+						"\"ClientTransactionID\":0,\"ServerTransactionID\":5,\"ErrorNumber\":0,\"ErrorMessage\":\"\"}");
+	gBenchReplies[2].lookupKey	=	"ErrorMessage";
+
+	gBenchReplies[3].name		=	"arrays";
+	gBenchReplies[3].jsonText	=	CopyString(
+						"{\"Names\":[\"Red\",\"Green\",\"Blue\",\"Luminance\"],\"FocusOffsets\":[0,12,-7,3],"
+						"\"SupportedActions\":[],\"Single\":[\"only\"],\"ErrorNumber\":0}");
+	gBenchReplies[3].lookupKey	=	"ErrorNumber";
+
+	gBenchReplies[4].name		=	"nested";
+	gBenchReplies[4].jsonText	=	CopyString(
+						"{\"hdr\":{\"version\":1,\"sender\":\"alpacapi\"},"
+						"\"data\":{\"track\":{\"ra\":12.5,\"dec\":-30.25},\"state\":\"slewing\",\"list\":[{\"a\":1},{\"a\":2}]},"
+						"\"error\":{\"code\":0}}");
+	gBenchReplies[4].lookupKey	=	"state";
+
+	gBenchReplies[5].name		=	"discovery";
+	gBenchReplies[5].jsonText	=	CopyString("{\"AlpacaPort\": 6800}");
+	gBenchReplies[5].lookupKey	=	"AlpacaPort";
+
+	//*	the same as "value" with the http header in front, the way sendrequest_lib.c gets it
+	httpReply	=	(char *)malloc(strlen(gHttpHeader) + strlen(gBenchReplies[0].jsonText) + 1);
+	if (httpReply != NULL)
+	{
+		strcpy(httpReply, gHttpHeader);
+		strcat(httpReply, gBenchReplies[0].jsonText);
+	}
+	gBenchReplies[6].name		=	"http-value";
+	gBenchReplies[6].jsonText	=	httpReply;
+	gBenchReplies[6].lookupKey	=	"ErrorNumber";
+}
+
+//*****************************************************************************
+static int	CompareTokenLists(	const char			*replyName,
+								const char			*listName,
+								const SJP_token_t	*legacyList,
+								const short			legacyCnt,
+								const SJP_token_t	*newList,
+								const short			newCnt)
+{
+int		errorCnt;
+int		iii;
+
+	errorCnt	=	0;
+	if (legacyCnt != newCnt)
+	{
+		printf("%-12s %-5s token count: legacy=%d new=%d\n", replyName, listName, legacyCnt, newCnt);
+		errorCnt++;
+	}
+	for (iii=0; (iii < legacyCnt) && (iii < newCnt); iii++)
+	{
+		if ((strcmp(legacyList[iii].keyword, newList[iii].keyword) != 0) ||
+			(strcmp(legacyList[iii].valueString, newList[iii].valueString) != 0))
+		{
+			printf("%-12s %-5s [%3d] legacy=%s:%s new=%s:%s\n",	replyName, listName, iii,
+																legacyList[iii].keyword,
+																legacyList[iii].valueString,
+																newList[iii].keyword,
+																newList[iii].valueString);
+			errorCnt++;
+		}
+	}
+	return(errorCnt);
+}
+
+//*****************************************************************************
+//*	the old parser turned the http header lines into tokens with no keyword,
+//*	the new one skips the header, so the old one gets only the json part
+//*****************************************************************************
+static int	CheckReply(const TYPE_BenchReply *benchReply)
+{
+SJP_Parser_t	*legacyParser;
+SJP_Parser_t	*newParser;
+const char		*jsonStart;
+int				errorCnt;
+
+	errorCnt		=	0;
+	legacyParser	=	(SJP_Parser_t *)malloc(sizeof(SJP_Parser_t));
+	newParser		=	(SJP_Parser_t *)malloc(sizeof(SJP_Parser_t));
+	if ((legacyParser != NULL) && (newParser != NULL) && (benchReply->jsonText != NULL))
+	{
+		jsonStart	=	benchReply->jsonText;
+		if (strncmp(jsonStart, "HTTP/", 5) == 0)
+		{
+			jsonStart	=	strstr(jsonStart, "\r\n\r\n") + 4;
+		}
+		SJP_Init(legacyParser);
+		SJP_ParseData_Legacy(legacyParser, jsonStart);
+		SJP_Init(newParser);
+		SJP_ParseData(newParser, benchReply->jsonText);
+
+		errorCnt	+=	CompareTokenLists(	benchReply->name, "hdr",
+											legacyParser->headerList,	legacyParser->tokenCount_Hdr,
+											newParser->headerList,		newParser->tokenCount_Hdr);
+		errorCnt	+=	CompareTokenLists(	benchReply->name, "data",
+											legacyParser->dataList,		legacyParser->tokenCount_Data,
+											newParser->dataList,		newParser->tokenCount_Data);
+		errorCnt	+=	CompareTokenLists(	benchReply->name, "error",
+											legacyParser->errorList,	legacyParser->tokenCount_Errs,
+											newParser->errorList,		newParser->tokenCount_Errs);
+		printf("%-12s %4d bytes %4d tokens  %s\n",	benchReply->name,
+													(int)strlen(benchReply->jsonText),
+													newParser->tokenCount_Data,
+													((errorCnt == 0) ? "OK" : "FAILED"));
+	}
+	else
+	{
+		printf("Out of memory\n");
+		errorCnt++;
+	}
+	if (legacyParser != NULL)
+	{
+		free(legacyParser);
+	}
+	if (newParser != NULL)
+	{
+		free(newParser);
+	}
+	return(errorCnt);
+}
+
+//*****************************************************************************
+//*	feeds the tokenizer a few bytes at a time, the tokens have to come out
+//*	the same as parsing it all at once
+//*****************************************************************************
+static int	CheckResume(const TYPE_BenchReply *benchReply, const int chunkSize)
+{
+JTK_Parser_t	wholeParser;
+JTK_Parser_t	chunkParser;
+char			*wholeData;
+char			*chunkData;
+size_t			dataLen;
+size_t			bytesGiven;
+size_t			copyLen;
+int				returnCode;
+int				errorCnt;
+uint32_t		iii;
+
+	errorCnt	=	0;
+	dataLen		=	strlen(benchReply->jsonText);
+	wholeData	=	CopyString(benchReply->jsonText);
+	chunkData	=	(char *)malloc(dataLen + 1);
+	JTK_Init(&wholeParser);
+	JTK_Init(&chunkParser);
+	if ((wholeData != NULL) && (chunkData != NULL))
+	{
+		JTK_Parse(&wholeParser, wholeData, dataLen);
+
+		returnCode	=	kJTK_NeedMore;
+		bytesGiven	=	0;
+		while ((returnCode == kJTK_NeedMore) && (bytesGiven < dataLen))
+		{
+			copyLen	=	((bytesGiven + chunkSize) < dataLen) ? (size_t)chunkSize : (dataLen - bytesGiven);
+			memcpy(&chunkData[bytesGiven], &benchReply->jsonText[bytesGiven], copyLen);
+			bytesGiven	+=	copyLen;
+			returnCode	=	JTK_Parse(&chunkParser, chunkData, bytesGiven);
+		}
+		if ((returnCode != kJTK_Complete) || (wholeParser.tokenCnt != chunkParser.tokenCnt))
+		{
+			printf("%-12s resume %d: returnCode=%d tokens %d/%d\n",	benchReply->name, chunkSize, returnCode,
+																	wholeParser.tokenCnt, chunkParser.tokenCnt);
+			errorCnt++;
+		}
+		for (iii=0; (iii < wholeParser.tokenCnt) && (iii < chunkParser.tokenCnt); iii++)
+		{
+			if ((strcmp(JTK_GetKey(&wholeParser, iii), JTK_GetKey(&chunkParser, iii)) != 0) ||
+				(strcmp(JTK_GetValue(&wholeParser, iii), JTK_GetValue(&chunkParser, iii)) != 0) ||
+				(wholeParser.tokens[iii].endIdx != chunkParser.tokens[iii].endIdx))
+			{
+				printf("%-12s resume %d: token %d is different\n", benchReply->name, chunkSize, iii);
+				errorCnt++;
+			}
+		}
+		if (JTK_FindKey(&wholeParser, benchReply->lookupKey) != JTK_FindKey(&chunkParser, benchReply->lookupKey))
+		{
+			printf("%-12s resume %d: lookup of %s is different\n", benchReply->name, chunkSize, benchReply->lookupKey);
+			errorCnt++;
+		}
+	}
+	JTK_Free(&wholeParser);
+	JTK_Free(&chunkParser);
+	if (wholeData != NULL)
+	{
+		free(wholeData);
+	}
+	if (chunkData != NULL)
+	{
+		free(chunkData);
+	}
+	return(errorCnt);
+}
+
+//*****************************************************************************
+static double	GetSeconds(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(timeSpec.tv_sec + (timeSpec.tv_nsec / 1000000000.0));
+}
+
+//*****************************************************************************
+enum
+{
+	kBenchCode_Legacy	=	0,
+	kBenchCode_ParseData,
+	kBenchCode_InPlace,
+	kBenchCode_Tokenizer,
+
+	kBenchCode_Last
+};
+
+static const char	*gBenchCodeNames[kBenchCode_Last]	=
+{
+	"legacy",
+	"parse",
+	"inplace",
+	"tokenizer"
+};
+
+//*****************************************************************************
+//*	returns the time for one parse plus one key lookup in seconds
+//*	the in place versions have to copy the reply every time, that is included
+//*****************************************************************************
+static double	TimeReply(	const TYPE_BenchReply	*benchReply,
+							const int				benchCode,
+							SJP_Parser_t			*jsonParser,
+							JTK_Parser_t			*tokenizer,
+							char					*workBuffer)
+{
+double	startTime;
+double	elapsedTime;
+size_t	dataLen;
+int		iii;
+int		foundCnt;
+char	valueString[kSJP_MaxValueLen];
+
+	dataLen		=	strlen(benchReply->jsonText);
+	foundCnt	=	0;
+	startTime	=	GetSeconds();
+	for (iii=0; iii<gBenchLoops; iii++)
+	{
+		switch(benchCode)
+		{
+			case kBenchCode_Legacy:
+				SJP_ParseData_Legacy(jsonParser, benchReply->jsonText);
+				foundCnt	+=	SJP_FindKeyWordString(benchReply->lookupKey, jsonParser->dataList, jsonParser->tokenCount_Data, valueString);
+				break;
+
+			case kBenchCode_ParseData:
+				SJP_ParseData(jsonParser, benchReply->jsonText);
+				foundCnt	+=	SJP_FindKeyWordString(benchReply->lookupKey, jsonParser->dataList, jsonParser->tokenCount_Data, valueString);
+				break;
+
+			case kBenchCode_InPlace:
+				memcpy(workBuffer, benchReply->jsonText, dataLen + 1);
+				SJP_ParseDataInPlace(jsonParser, workBuffer, dataLen);
+				foundCnt	+=	SJP_FindKeyWordString(benchReply->lookupKey, jsonParser->dataList, jsonParser->tokenCount_Data, valueString);
+				break;
+
+			case kBenchCode_Tokenizer:
+				memcpy(workBuffer, benchReply->jsonText, dataLen + 1);
+				JTK_Reset(tokenizer);
+				JTK_Parse(tokenizer, workBuffer, dataLen);
+				foundCnt	+=	(JTK_FindKey(tokenizer, benchReply->lookupKey) >= 0);
+				break;
+		}
+	}
+	elapsedTime	=	(GetSeconds() - startTime) / gBenchLoops;
+	if (foundCnt != gBenchLoops)
+	{
+		printf("%s %s: %s found %d times out of %d\n",	benchReply->name, gBenchCodeNames[benchCode],
+														benchReply->lookupKey, foundCnt, gBenchLoops);
+	}
+	return(elapsedTime);
+}
+
+//*****************************************************************************
+static void	PrintHelp(const char *appName)
+{
+	printf("usage: %s [options]\n", appName);
+	printf("\t-n <loops>       number of times each reply is parsed (default 10000)\n");
+}
+
+//*****************************************************************************
+static bool	ProcessCmdLineArgs(int argc, char **argv)
+{
+int			ii;
+const char	*argValue;
+
+	ii	=	1;
+	while (ii < argc)
+	{
+		argValue	=	NULL;
+		if ((argv[ii][0] == '-') && (argv[ii][1] == 'n'))
+		{
+			if (argv[ii][2] != 0)
+			{
+				argValue	=	&argv[ii][2];
+			}
+			else if ((ii + 1) < argc)
+			{
+				ii++;
+				argValue	=	argv[ii];
+			}
+		}
+		if (argValue == NULL)
+		{
+			PrintHelp(argv[0]);
+			return(false);
+		}
+		gBenchLoops	=	atoi(argValue);
+		ii++;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+SJP_Parser_t	*jsonParser;
+JTK_Parser_t	tokenizer;
+char			*workBuffer;
+int				failCnt;
+int				jjj;
+int				benchCode;
+double			elapsed_Secs[kBenchCode_Last];
+size_t			dataLen;
+
+	if (ProcessCmdLineArgs(argc, argv) == false)
+	{
+		return(1);
+	}
+	if (gBenchLoops <= 0)
+	{
+		printf("Loops must be more than 0\n");
+		return(1);
+	}
+	SetupReplies();
+
+	//*	check the token lists against the old parser
+	failCnt	=	0;
+	for (jjj=0; jjj<kBenchReplyCnt; jjj++)
+	{
+		failCnt	+=	CheckReply(&gBenchReplies[jjj]);
+		failCnt	+=	CheckResume(&gBenchReplies[jjj], 1);
+		failCnt	+=	CheckResume(&gBenchReplies[jjj], 7);
+		failCnt	+=	CheckResume(&gBenchReplies[jjj], 100);
+	}
+	printf("Output check: %d replies, %d failures\n", kBenchReplyCnt, failCnt);
+
+	//*	timing
+	jsonParser	=	(SJP_Parser_t *)malloc(sizeof(SJP_Parser_t));
+	workBuffer	=	(char *)malloc(65536);
+	JTK_Init(&tokenizer);
+	if ((jsonParser != NULL) && (workBuffer != NULL))
+	{
+		SJP_Init(jsonParser);
+		printf("\n%d loops, one parse plus one key lookup\n", gBenchLoops);
+		printf("%-12s %-10s %10s %10s\n", "reply", "code", "usec", "MB/sec");
+		for (jjj=0; jjj<kBenchReplyCnt; jjj++)
+		{
+			dataLen	=	strlen(gBenchReplies[jjj].jsonText);
+			for (benchCode=0; benchCode<kBenchCode_Last; benchCode++)
+			{
+				elapsed_Secs[benchCode]	=	TimeReply(&gBenchReplies[jjj], benchCode, jsonParser, &tokenizer, workBuffer);
+				printf("%-12s %-10s %10.2f %10.1f\n",	gBenchReplies[jjj].name,
+														gBenchCodeNames[benchCode],
+														(elapsed_Secs[benchCode] * 1.0e6),
+														((elapsed_Secs[benchCode] > 0.0) ? ((dataLen / 1.0e6) / elapsed_Secs[benchCode]) : 0.0));
+			}
+			if (elapsed_Secs[kBenchCode_ParseData] > 0.0)
+			{
+				printf("%-12s %-10s %9.1fx\n", "", "speedup", (elapsed_Secs[kBenchCode_Legacy] / elapsed_Secs[kBenchCode_ParseData]));
+			}
+		}
+	}
+	else
+	{
+		printf("Out of memory\n");
+		failCnt++;
+	}
+	JTK_Free(&tokenizer);
+	if (jsonParser != NULL)
+	{
+		free(jsonParser);
+	}
+	if (workBuffer != NULL)
+	{
+		free(workBuffer);
+	}
+	return((failCnt == 0) ? 0 : 1);
+}
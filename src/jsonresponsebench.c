@@ -0,0 +1,236 @@
+//*****************************************************************************
+//*
+//*	Name:			jsonresponsebench.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Times building a readall sized JSON response
+//*
+//*	Usage notes:	The drivers build their replies with the JsonResponse_Add_xxx() calls,
+//*					which only get the text buffer. If each call has to find the end of the
+//*					buffer with strlen(), building a reply is quadratic in its length.
+//*					This builds the same reply with the JsonResponse_Add_xxx() calls and with
+//*					a TYPE_JsonWriter of its own (JsonWriter_Add_xxx(), the length is always known)
+//*					and checks that the bytes are the same. The timing sends them to /dev/null.
+//*
+//*		jsonresponsebench -f 200 -n 5000
+//*
+//*		-f	number of fields in the reply (default 200, max 1000)
+//*		-n	number of replies per round, the best of 5 rounds is reported (default 5000)
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created jsonresponsebench.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	<time.h>
+#include	<fcntl.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"JsonDefs.h"
+#include	"JsonResponse.h"
+
+#define	kMaxBenchFields	1000
+#define	kBenchRounds	5
+
+static int		gFieldCnt	=	200;
+static int		gReplyCnt	=	5000;
+
+//*****************************************************************************
+static uint64_t	GetMicroSecs(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(((uint64_t)timeSpec.tv_sec * 1000000) + (timeSpec.tv_nsec / 1000));
+}
+
+//*****************************************************************************
+//*	the same mix of fields as a readall
+//*****************************************************************************
+static int	BuildReply_Response(const int socketFD, char *jsonTextBuffer)
+{
+char	itemName[32];
+int		bytesWritten;
+int		iii;
+
+	bytesWritten		=	0;
+	jsonTextBuffer[0]	=	0;
+	for (iii=0; iii<gFieldCnt; iii++)
+	{
+		sprintf(itemName, "property%d", iii);
+		switch(iii & 3)
+		{
+			case 0:	bytesWritten	+=	JsonResponse_Add_Int32(	socketFD, jsonTextBuffer, kMaxJsonBuffLen, itemName, (iii * 1000),			INCLUDE_COMMA);	break;
+			case 1:	bytesWritten	+=	JsonResponse_Add_Double(socketFD, jsonTextBuffer, kMaxJsonBuffLen, itemName, (iii * 0.125),			INCLUDE_COMMA);	break;
+			case 2:	bytesWritten	+=	JsonResponse_Add_String(socketFD, jsonTextBuffer, kMaxJsonBuffLen, itemName, "Some string value",	INCLUDE_COMMA);	break;
+			case 3:	bytesWritten	+=	JsonResponse_Add_Bool(	socketFD, jsonTextBuffer, kMaxJsonBuffLen, itemName, ((iii & 4) != 0),		INCLUDE_COMMA);	break;
+		}
+	}
+	bytesWritten	+=	JsonResponse_Add_Finish(socketFD, 200, jsonTextBuffer, kInclude_HTTP_Header);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+static int	BuildReply_Writer(const int socketFD, char *jsonTextBuffer)
+{
+TYPE_JsonWriter	jsonWriter;
+char			itemName[32];
+int				bytesWritten;
+int				iii;
+
+	bytesWritten	=	0;
+	JsonWriter_Init(&jsonWriter, socketFD, jsonTextBuffer, kMaxJsonBuffLen);
+	for (iii=0; iii<gFieldCnt; iii++)
+	{
+		sprintf(itemName, "property%d", iii);
+		switch(iii & 3)
+		{
+			case 0:	bytesWritten	+=	JsonWriter_Add_Int32(	&jsonWriter, itemName, (iii * 1000),			INCLUDE_COMMA);	break;
+			case 1:	bytesWritten	+=	JsonWriter_Add_Double(	&jsonWriter, itemName, (iii * 0.125),			INCLUDE_COMMA);	break;
+			case 2:	bytesWritten	+=	JsonWriter_Add_String(	&jsonWriter, itemName, "Some string value",		INCLUDE_COMMA);	break;
+			case 3:	bytesWritten	+=	JsonWriter_Add_Bool(	&jsonWriter, itemName, ((iii & 4) != 0),		INCLUDE_COMMA);	break;
+		}
+	}
+	bytesWritten	+=	JsonWriter_Finish(&jsonWriter, 200, kInclude_HTTP_Header);
+	return(bytesWritten);
+}
+
+//*****************************************************************************
+//*	builds one reply into a pipe and reads it back, it has to fit in the pipe
+//*	returns the number of bytes, -1 on error
+//*****************************************************************************
+static int	CaptureReply(int (*buildProc)(const int socketFD, char *jsonTextBuffer), char *jsonTextBuffer, char *replyBuff, const int replyBuffLen)
+{
+int		pipeFD[2];
+int		replyLen;
+int		readCnt;
+
+	replyLen	=	-1;
+	if (pipe(pipeFD) == 0)
+	{
+		buildProc(pipeFD[1], jsonTextBuffer);
+		close(pipeFD[1]);
+		replyLen	=	0;
+		while ((replyLen < replyBuffLen) && ((readCnt = read(pipeFD[0], &replyBuff[replyLen], (replyBuffLen - replyLen))) > 0))
+		{
+			replyLen	+=	readCnt;
+		}
+		close(pipeFD[0]);
+	}
+	return(replyLen);
+}
+
+//*****************************************************************************
+//*	the replies go to /dev/null so only building them is timed, best of kBenchRounds
+//*****************************************************************************
+static void	TimeReplies(const char *methodName, int (*buildProc)(const int socketFD, char *jsonTextBuffer), char *jsonTextBuffer, const int replyLen)
+{
+int			nullFD;
+uint64_t	startTime;
+uint64_t	elapsed_uS;
+uint64_t	best_uS;
+int			round;
+int			iii;
+
+	nullFD	=	open("/dev/null", O_WRONLY);
+	if (nullFD >= 0)
+	{
+		best_uS	=	UINT64_MAX;
+		for (round=0; round<kBenchRounds; round++)
+		{
+			startTime	=	GetMicroSecs();
+			for (iii=0; iii<gReplyCnt; iii++)
+			{
+				buildProc(nullFD, jsonTextBuffer);
+			}
+			elapsed_uS	=	GetMicroSecs() - startTime;
+			if (elapsed_uS < best_uS)
+			{
+				best_uS	=	elapsed_uS;
+			}
+		}
+		close(nullFD);
+		printf("%-22s %10d %12.2f\n", methodName, replyLen, ((double)best_uS / gReplyCnt));
+	}
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+char		*jsonTextBuffer;
+char		*responseReply;
+char		*writerReply;
+int			responseLen;
+int			writerLen;
+int			opt;
+
+	while ((opt = getopt(argc, argv, "f:n:")) != -1)
+	{
+		switch(opt)
+		{
+			case 'f':	gFieldCnt	=	atoi(optarg);	break;
+			case 'n':	gReplyCnt	=	atoi(optarg);	break;
+			default:
+				printf("usage: %s [-f fields] [-n replies]\n", argv[0]);
+				return(1);
+		}
+	}
+	if ((gFieldCnt <= 0) || (gFieldCnt > kMaxBenchFields) || (gReplyCnt <= 0))
+	{
+		printf("usage: %s [-f fields, max %d] [-n replies]\n", argv[0], kMaxBenchFields);
+		return(1);
+	}
+
+	jsonTextBuffer	=	(char *)malloc(kMaxJsonBuffLen);
+	responseReply	=	(char *)malloc(kMaxBenchFields * 100);
+	writerReply		=	(char *)malloc(kMaxBenchFields * 100);
+	if ((jsonTextBuffer == NULL) || (responseReply == NULL) || (writerReply == NULL))
+	{
+		printf("Failed to allocate buffers\n");
+		return(1);
+	}
+	responseLen	=	CaptureReply(BuildReply_Response,	jsonTextBuffer, responseReply,	(kMaxBenchFields * 100));
+	writerLen	=	CaptureReply(BuildReply_Writer,		jsonTextBuffer, writerReply,	(kMaxBenchFields * 100));
+
+	printf("%d fields per reply, %d replies, %d byte buffer\n", gFieldCnt, gReplyCnt, kMaxJsonBuffLen);
+	printf("%-22s %10s %12s\n", "method", "bytes", "uS/reply");
+	TimeReplies("JsonResponse_Add_xxx",	BuildReply_Response,	jsonTextBuffer, responseLen);
+	TimeReplies("JsonWriter_Add_xxx",	BuildReply_Writer,		jsonTextBuffer, writerLen);
+
+	free(jsonTextBuffer);
+	if ((responseLen > 0) && (responseLen == writerLen) && (memcmp(responseReply, writerReply, responseLen) == 0))
+	{
+		printf("Replies match\n");
+		free(responseReply);
+		free(writerReply);
+		return(0);
+	}
+	printf("FAILED: the replies are not the same\n");
+	free(responseReply);
+	free(writerReply);
+	return(1);
+}
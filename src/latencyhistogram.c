@@ -0,0 +1,89 @@
+//*****************************************************************************
+//*
+//*	Name:			latencyhistogram.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	log-linear latency histogram
+//*
+//*	Usage notes:	The server command timing and alpacabench both use these so
+//*					the percentiles they report come from the same buckets.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 17,	2026	<MLS> Created latencyhistogram.c from alpacadriver.cpp and alpacabench.c
+//*****************************************************************************
+
+#include	<stdint.h>
+
+#include	"latencyhistogram.h"
+
+//*****************************************************************************
+//*	the largest value that goes into this bucket
+//*****************************************************************************
+uint32_t	LatencyHist_BucketUpperLimit(const int bucketIdx)
+{
+int			msBit;
+uint64_t	bucketWidth;
+uint64_t	upperLimit;
+
+	if (bucketIdx < (1 << kLatencySubBucketBits))
+	{
+		return(bucketIdx);
+	}
+	msBit		=	(bucketIdx >> kLatencySubBucketBits) + kLatencySubBucketBits - 1;
+	bucketWidth	=	1ULL << (msBit - kLatencySubBucketBits);
+	upperLimit	=	((uint64_t)((1 << kLatencySubBucketBits) + (bucketIdx & ((1 << kLatencySubBucketBits) - 1))) * bucketWidth) + bucketWidth - 1;
+	if (upperLimit > 0xffffffff)
+	{
+		upperLimit	=	0xffffffff;
+	}
+	return(upperLimit);
+}
+
+//*****************************************************************************
+//*	percentile is 1 to 100, the answer is never more than the max
+//*	bucket[] has kLatencyBucketCnt entries
+//*****************************************************************************
+uint32_t	LatencyHist_Percentile(	const uint32_t	*bucket,
+									const uint32_t	count,
+									const uint32_t	max_uS,
+									const int		percentile)
+{
+uint32_t	targetCount;
+uint32_t	runningCount;
+uint32_t	upperLimit;
+int			iii;
+
+	if (count == 0)
+	{
+		return(0);
+	}
+	targetCount		=	(((uint64_t)count * percentile) + 99) / 100;
+	runningCount	=	0;
+	for (iii=0; iii<kLatencyBucketCnt; iii++)
+	{
+		runningCount	+=	bucket[iii];
+		if (runningCount >= targetCount)
+		{
+			upperLimit	=	LatencyHist_BucketUpperLimit(iii);
+			return((upperLimit < max_uS) ? upperLimit : max_uS);
+		}
+	}
+	return(max_uS);
+}
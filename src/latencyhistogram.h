@@ -0,0 +1,53 @@
+//**************************************************************************
+//*	Name:			latencyhistogram.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	log-linear latency histogram, used by the server command timing and alpacabench
+//*
+//*****************************************************************************
+//#include	"latencyhistogram.h"
+
+#ifndef _LATENCYHISTOGRAM_H_
+#define	_LATENCYHISTOGRAM_H_
+
+#include	<stdint.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+//*	log-linear histogram, 4 buckets per power of 2, the first 4 are 0,1,2,3 micro-seconds
+//*	31 powers of 2 covers all of uint32_t, the worst case error is 25%
+#define	kLatencySubBucketBits	2
+#define	kLatencyBucketCnt		(31 << kLatencySubBucketBits)
+
+//*****************************************************************************
+//*	the bucket that this many micro-seconds goes into
+//*****************************************************************************
+static inline int	LatencyHist_BucketIndex(const uint32_t micro_Secs)
+{
+int		msBit;
+int		subBucket;
+
+	if (micro_Secs < (1 << kLatencySubBucketBits))
+	{
+		return(micro_Secs);
+	}
+	msBit		=	31 - __builtin_clz(micro_Secs);
+	subBucket	=	(micro_Secs >> (msBit - kLatencySubBucketBits)) & ((1 << kLatencySubBucketBits) - 1);
+	return(((msBit - kLatencySubBucketBits + 1) << kLatencySubBucketBits) + subBucket);
+}
+
+uint32_t	LatencyHist_BucketUpperLimit(const int bucketIdx);
+uint32_t	LatencyHist_Percentile(	const uint32_t	*bucket,
+									const uint32_t	count,
+									const uint32_t	max_uS,
+									const int		percentile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	//	_LATENCYHISTOGRAM_H_
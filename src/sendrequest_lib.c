@@ -38,13 +38,25 @@
 //*	Sep  4,	2021	<MLS> Added microsecs arg to SetSocketTimeouts()
 //*	Sep  8,	2021	<MLS> Added "Connection: close" as per suggestion from Patrick Chevalley
 //*	Dec 14,	2021	<MLS> Added imagebytes option to OpenSocketAndSendRequest()
+//*	Oct 17,	2026	<MLS> GetJsonResponse() and SendPutCommand() now use a pool of keep-alive connections
+//*	Oct 17,	2026	<MLS> Replies are read into a growable buffer, no more 12000 byte limit
+//*	Oct 17,	2026	<MLS> Reading stops at Content-Length instead of waiting for the server to close
+//*	Oct 17,	2026	<MLS> Added SendRequest_GetStats()
+//*	Oct 17,	2026	<MLS> Replies are parsed in place with SJP_ParseDataInPlace()
+//*	Oct 17,	2026	<MLS> Only retry when the server closed the connection, never after a time out or a sent PUT
+//*	Oct 17,	2026	<MLS> Socket counters are only changed with gClientConnMutex locked
 //*****************************************************************************
 
 #include	<stdio.h>
 #include	<stdlib.h>
 #include	<unistd.h>
 #include	<stdbool.h>
+#include	<stdint.h>
 #include	<string.h>
+#include	<strings.h>
+#include	<time.h>
+#include	<sys/time.h>
+#include	<pthread.h>
 #include	<sys/types.h>
 #include	<sys/socket.h>
 #include	<arpa/inet.h>
@@ -66,6 +78,7 @@
 //#define		kTimeOutLenSeconds	1
 
 
+//*	the socket counters are protected by gClientConnMutex, any thread can send requests
 int		gNumSocketOpenOKcnt		=	0;
 int		gNumSocketOpenErrCnt	=	0;
 int		gNumSocketConnOKcnt		=	0;
@@ -73,6 +86,16 @@ int		gNumSocketConnErrCnt	=	0;
 bool	gReportError			=	true;
 bool	gEnableDebug			=	false;
 
+static pthread_mutex_t	gClientConnMutex	=	PTHREAD_MUTEX_INITIALIZER;
+
+//*****************************************************************************
+static void	CountSocketEvent(int *eventCounter)
+{
+	pthread_mutex_lock(&gClientConnMutex);
+	*eventCounter	+=	1;
+	pthread_mutex_unlock(&gClientConnMutex);
+}
+
 //*****************************************************************************
 void	Set_SendRequestLibDebug(bool enableFlag)
 {
@@ -139,7 +162,7 @@ int					so_oobinline;
 	socket_desc	=	socket(AF_INET , SOCK_STREAM , 0);
 	if (socket_desc >= 0)
 	{
-		gNumSocketOpenOKcnt++;
+		CountSocketEvent(&gNumSocketOpenOKcnt);
 
 		//*	set a timeout
 		setOptRetCode	=	SetSocketTimeouts(socket_desc, kTimeOutLenSeconds, 0);
@@ -169,7 +192,7 @@ int					so_oobinline;
 		connRetCode	=	connect(socket_desc , (struct sockaddr *)&remoteDev , sizeof(remoteDev));
 		if (connRetCode >= 0)
 		{
-			gNumSocketConnOKcnt++;
+			CountSocketEvent(&gNumSocketConnOKcnt);
 			//*	Must be HTTP/1.0 to disable "Transfer-Encoding: chunked"
 			strcpy(xmitBuffer,	"GET ");
 			strcat(xmitBuffer,	sendData);
@@ -243,60 +266,70 @@ int					so_oobinline;
 
 
 //*****************************************************************************
-bool	GetJsonResponse(	struct sockaddr_in	*deviceAddress,
-							const int			port,
-							const char			*sendData,
-							const char			*dataString,
-							SJP_Parser_t		*jsonParser)
+//*	Keep-alive connection pool
+//*		GetJsonResponse() and SendPutCommand() ask for "Connection: keep-alive".
+//*		They still send HTTP/1.0 so the server never answers with
+//*		"Transfer-Encoding: chunked". If the reply has a Content-Length and the
+//*		server did not say "Connection: close", the socket goes back into the pool
+//*		for the next request to the same ip/port, otherwise it is closed as before.
+//*		A pooled connection that the server closed while it was idle is
+//*		re-opened and the request sent again, the caller never sees it.
+//*		A time out is never retried, see SendRequestAndParseReply().
+//*
+//*		OpenSocketAndSendRequest() still opens a socket for every request,
+//*		its callers read that socket until the server closes it.
+//*****************************************************************************
+#define	kMaxClientConnections		32
+#define	kClientIdleTimeOut_secs		10		//*	the AlpacaPi server closes idle connections after 15
+#define	kRxBufferStartSize			(16 * 1024)
+#define	kRxBufferMaxSize			(16 * 1024 * 1024)
+
+//*****************************************************************************
+typedef struct
+{
+	bool		inUse;				//*	checked out by a request
+	bool		connected;
+	int			socketFD;
+	in_addr_t	ipAddress;
+	int			port;
+	time_t		lastUsed;
+	char		*rxBuffer;			//*	grows as needed, kept for the next request
+	size_t		rxBufferSize;
+} TYPE_ClientConnection;
+
+static TYPE_ClientConnection	gClientConn[kMaxClientConnections];
+
+//*	these are protected by gClientConnMutex
+static int						gNumRequestCnt			=	0;
+static int						gNumSocketReuseCnt		=	0;	//*	requests sent on a connection that was already open
+static int						gNumSocketReconnectCnt	=	0;	//*	pooled connections the server had closed
+static uint64_t					gNumBytesReceived		=	0;
+static double					gRequestTotalSecs		=	0.0;
+
+//*****************************************************************************
+static bool	ClientConn_Open(TYPE_ClientConnection	*connection,
+							struct sockaddr_in		*deviceAddress,
+							const int				port,
+							const char				*ipString)
 {
-bool				validData;
 int					socket_desc;
 struct sockaddr_in	remoteDev;
 int					connRetCode;
-int					sendRetCode;
-int					shutDownRetCode;
-int					closeRetCode;
-int					recvByteCnt;
-char				returnedData[kReadBuffLen + 10];
-char				xmitBuffer[kReadBuffLen + 10];
-char				longBuffer[kLargeBufferSize + 10];
-char				linebuf[100];
-int					dataStrLen;
-char				ipString[32];
-bool				keepReading;
 int					setOptRetCode;
-int					readLoopCnt;		//*	for debugging
-int					readSuccessCnt;		//*	for debugging
-int					parseReturnCode;
-
-	if (gEnableDebug)
-	{
-		CONSOLE_DEBUG_W_STR(__FUNCTION__, "------start-------");
-		CONSOLE_DEBUG(sendData);
-		CONSOLE_DEBUG_W_SIZE("sizeof(xmitBuffer)  \t=", sizeof(xmitBuffer));
-		CONSOLE_DEBUG_W_SIZE("sizeof(returnedData)\t=", sizeof(returnedData));
-		CONSOLE_DEBUG_W_SIZE("sizeof(longBuffer)  \t=", sizeof(longBuffer));
-	}
-	inet_ntop(AF_INET, &deviceAddress->sin_addr.s_addr, ipString, INET_ADDRSTRLEN);
-
-	SETUP_TIMING();
+char				portString[32];
+char				errorString[64];
 
-	validData	=	false;
-	socket_desc	=	socket(AF_INET , SOCK_STREAM , 0);
+	connection->connected	=	false;
+	socket_desc				=	socket(AF_INET , SOCK_STREAM , 0);
 	if (socket_desc >= 0)
 	{
-		if (gEnableDebug)
-		{
-			CONSOLE_DEBUG("Setting Timeout");
-		}
+		CountSocketEvent(&gNumSocketOpenOKcnt);
 		//*	set a timeout
 		setOptRetCode	=	SetSocketTimeouts(socket_desc, kTimeOutLenSeconds, 0);
-	//	setOptRetCode	=	SetSocketTimeouts(socket_desc, 0, 25000);
 		if (setOptRetCode != 0)
 		{
 			CONSOLE_DEBUG("SetSocketTimeouts() failed");
 		}
-		gNumSocketOpenOKcnt++;
 		remoteDev.sin_addr.s_addr	=	deviceAddress->sin_addr.s_addr;
 		remoteDev.sin_family		=	AF_INET;
 		remoteDev.sin_port			=	htons(port);
@@ -305,189 +338,487 @@ int					parseReturnCode;
 		connRetCode	=	connect(socket_desc , (struct sockaddr *)&remoteDev , sizeof(remoteDev));
 		if (connRetCode >= 0)
 		{
-//			CONSOLE_DEBUG("Connected");
+			CountSocketEvent(&gNumSocketConnOKcnt);
+			connection->socketFD	=	socket_desc;
+			connection->ipAddress	=	deviceAddress->sin_addr.s_addr;
+			connection->port		=	port;
+			connection->connected	=	true;
+		}
+		else
+		{
+			CountSocketEvent(&gNumSocketConnErrCnt);
+			if (errno == ECONNREFUSED)
+			{
+				sprintf(portString, ":%d", port);
+				CONSOLE_DEBUG_W_2STR("connect refused", ipString, portString);
+			}
+			else
+			{
+				CONSOLE_DEBUG_W_STR("connect error, ipaddress\t=",	ipString);
+				GetLinuxErrorString(errno, errorString);
+				CONSOLE_DEBUG_W_STR("Error message\t\t=",	errorString);
+			}
+			close(socket_desc);
+		}
+	}
+	else
+	{
+		CountSocketEvent(&gNumSocketOpenErrCnt);
+		if (errno == EMFILE)
+		{
+			CONSOLE_DEBUG("Too many files open!!!!!!!!!!!!!!!!!!!!!!!!!");
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("socket_desc\t=", socket_desc);
+			CONSOLE_DEBUG_W_NUM("errno\t\t=", errno);
+		}
+	}
+	return(connection->connected);
+}
 
-			gNumSocketConnOKcnt++;
-//	GET /api/v1/camera/0/supportedactions HTTP/1.1
-//	Host: newt16:6800
-//	User-Agent: Mozilla/5.0 (X11; Ubuntu; Linux x86_64; rv:71.0) Gecko/20100101 Firefox/71.0
-//	Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8
-//	Accept-Language: en-US,en;q=0.5
-//	Accept-Encoding: gzip, deflate
-//	Connection: keep-alive
-//	Upgrade-Insecure-Requests: 1
-//	Cache-Control: max-age=0
+//*****************************************************************************
+static void	ClientConn_Close(TYPE_ClientConnection *connection)
+{
+int		closeRetCode;
 
-//	GET /api/v1/camera/0/supportedactions HTTP/1.1
-//	Host: ascom:11111
-//	User-Agent: AlpacaPi
-//	Accept: text/html,application/json
-//	Accept-Language: en-US,en;q=0.5
-//	Connection: keep-alive
+	if (connection->connected)
+	{
+		shutdown(connection->socketFD, SHUT_RDWR);
+		closeRetCode	=	close(connection->socketFD);
+		if (closeRetCode != 0)
+		{
+			CONSOLE_DEBUG("Close error");
+		}
+		connection->connected	=	false;
+		connection->socketFD	=	-1;
+	}
+}
+
+//*****************************************************************************
+//*	returns an open connection to this device if there is one,
+//*	otherwise a closed one that the caller has to open
+//*****************************************************************************
+static TYPE_ClientConnection	*ClientConn_Get(struct sockaddr_in *deviceAddress, const int port)
+{
+TYPE_ClientConnection	*connection;
+time_t					currentTime;
+int						oldestIdx;
+int						iii;
 
+	connection	=	NULL;
+	oldestIdx	=	-1;
+	currentTime	=	time(NULL);
 
-			if (gEnableDebug)
+	pthread_mutex_lock(&gClientConnMutex);
+	for (iii=0; iii<kMaxClientConnections; iii++)
+	{
+		if ((gClientConn[iii].inUse == false) && gClientConn[iii].connected)
+		{
+			if ((currentTime - gClientConn[iii].lastUsed) >= kClientIdleTimeOut_secs)
 			{
-				CONSOLE_DEBUG("Building xmitBuffer");
+				//*	the server is about to close it anyway
+				ClientConn_Close(&gClientConn[iii]);
 			}
-			strcpy(xmitBuffer,	"GET ");
-			strcat(xmitBuffer,	sendData);
-			strcat(xmitBuffer,	" HTTP/1.0\r\n");
-//			strcat(xmitBuffer,	"Host: ascom:11111\r\n");
-			sprintf(linebuf,	"Host: %s:%d\r\n", ipString, port);
-			strcat(xmitBuffer,	linebuf);
-//			strcat(xmitBuffer,	"User-Agent: AlpacaPi\r\n");
-			if (strlen(gUserAgentAlpacaPiStr))
+			else if ((connection == NULL) &&
+					(gClientConn[iii].ipAddress == deviceAddress->sin_addr.s_addr) &&
+					(gClientConn[iii].port == port))
 			{
-				//*	add User-Agent:
-				strcat(xmitBuffer,	gUserAgentAlpacaPiStr);
+				connection	=	&gClientConn[iii];
 			}
-			strcat(xmitBuffer,	"Accept: text/html,application/json\r\n");
-
-			strcat(xmitBuffer,	"Accept-Language: en-US,en;q=0.5\r\n");
-			strcat(xmitBuffer,	"Connection: close\r\n");
+		}
+	}
 
-			if (gEnableDebug)
+	//*	no open connection, use an empty slot or the idle connection used the longest time ago
+	iii	=	0;
+	while ((connection == NULL) && (iii < kMaxClientConnections))
+	{
+		if (gClientConn[iii].inUse == false)
+		{
+			if (gClientConn[iii].connected == false)
 			{
-				CONSOLE_DEBUG_W_SIZE("length xmitBuffer\t=", strlen(xmitBuffer));
+				connection	=	&gClientConn[iii];
 			}
+			else if ((oldestIdx < 0) || (gClientConn[iii].lastUsed < gClientConn[oldestIdx].lastUsed))
+			{
+				oldestIdx	=	iii;
+			}
+		}
+		iii++;
+	}
+	if ((connection == NULL) && (oldestIdx >= 0))
+	{
+		connection	=	&gClientConn[oldestIdx];
+		ClientConn_Close(connection);
+	}
+	if (connection != NULL)
+	{
+		connection->inUse	=	true;
+	}
+	pthread_mutex_unlock(&gClientConnMutex);
+	return(connection);
+}
 
-//			if (strstr(sendData, "switch") !=  NULL)
-//			{
-//				CONSOLE_DEBUG_W_STR("xmitBuffer\t=", xmitBuffer);
-//			}
+//*****************************************************************************
+static void	ClientConn_Release(	TYPE_ClientConnection	*connection,
+								const bool				keepOpen,
+								const long				bytesReceived,
+								const double			elapsedSecs,
+								const int				reuseCnt,
+								const int				reconnectCnt)
+{
+	pthread_mutex_lock(&gClientConnMutex);
+	if (keepOpen == false)
+	{
+		ClientConn_Close(connection);
+	}
+	connection->lastUsed	=	time(NULL);
+	connection->inUse		=	false;
+
+	gNumRequestCnt++;
+	gNumSocketReuseCnt		+=	reuseCnt;
+	gNumSocketReconnectCnt	+=	reconnectCnt;
+	gNumBytesReceived		+=	bytesReceived;
+	gRequestTotalSecs		+=	elapsedSecs;
+	pthread_mutex_unlock(&gClientConnMutex);
+}
 
-			if (dataString != NULL)
+//*****************************************************************************
+//*	reads the whole reply (header and body) into connection->rxBuffer, null terminated.
+//*	With a Content-Length it stops as soon as the body is complete,
+//*	without one it reads until the server closes the connection.
+//*	returns the number of bytes read,
+//*	*serverClosed is true if it ended because the server closed or reset the connection
+//*****************************************************************************
+static long	ClientConn_ReadResponse(TYPE_ClientConnection *connection, bool *keepOpen, bool *serverClosed)
+{
+long		bytesInBuffer;
+long		headerLen;
+long		contentLength;
+long		recvByteCnt;
+size_t		newSize;
+char		*newBuffer;
+char		*endOfHdrPtr;
+char		*linePtr;
+bool		serverKeepAlive;
+bool		keepReading;
+
+	bytesInBuffer	=	0;
+	headerLen		=	-1;
+	contentLength	=	-1;
+	serverKeepAlive	=	false;
+	keepReading		=	true;
+	*serverClosed	=	false;
+	while (keepReading)
+	{
+		//*	make room for another read and the terminating null
+		if ((connection->rxBufferSize - bytesInBuffer) < (kReadBuffLen + 1))
+		{
+			newSize		=	(connection->rxBufferSize > 0) ? (connection->rxBufferSize * 2) : kRxBufferStartSize;
+			newBuffer	=	NULL;
+			if (newSize <= kRxBufferMaxSize)
 			{
-//				CONSOLE_DEBUG_W_STR("dataString\t=", dataString);
-				dataStrLen	=	strlen(dataString);
-				sprintf(linebuf, "Content-Length: %d\r\n", dataStrLen);
-				strcat(xmitBuffer, linebuf);
-				strcat(xmitBuffer, "\r\n");
-
-				strcat(xmitBuffer, dataString);
-				strcat(xmitBuffer, "\r\n");
+				newBuffer	=	(char *)realloc(connection->rxBuffer, newSize);
 			}
-			//*	this EXTRA CR/LF is VERY important for Alpaca Remote Server
-			strcat(xmitBuffer, "\r\n");
-
-			if (gEnableDebug)
+			if (newBuffer != NULL)
 			{
-				CONSOLE_DEBUG_W_SIZE("length xmitBuffer\t=", strlen(xmitBuffer));
+				connection->rxBuffer		=	newBuffer;
+				connection->rxBufferSize	=	newSize;
 			}
-
-//			CONSOLE_DEBUG(xmitBuffer);
-
-			sendRetCode	=	send(socket_desc , xmitBuffer , strlen(xmitBuffer) , MSG_NOSIGNAL);
-			if (sendRetCode >= 0)
+			else
 			{
-				if (gEnableDebug)
-				{
-					CONSOLE_DEBUG("Request sent");
-				}
-				keepReading		=	true;
-				longBuffer[0]	=	0;
-				readLoopCnt		=	0;
-				readSuccessCnt	=	0;
-				while (keepReading && ((strlen(longBuffer) + kReadBuffLen) < kLargeBufferSize))
+				CONSOLE_DEBUG_W_LONG("Reply too large, bytesInBuffer\t=", bytesInBuffer);
+				serverKeepAlive	=	false;
+				keepReading		=	false;
+			}
+		}
+		if (keepReading)
+		{
+			recvByteCnt	=	recv(	connection->socketFD,
+									&connection->rxBuffer[bytesInBuffer],
+									(connection->rxBufferSize - bytesInBuffer - 1),
+									MSG_NOSIGNAL);
+			if (recvByteCnt > 0)
+			{
+				bytesInBuffer							+=	recvByteCnt;
+				connection->rxBuffer[bytesInBuffer]		=	0;
+				if (headerLen < 0)
 				{
-					readLoopCnt++;
-				//	recvByteCnt	=	recv(socket_desc, returnedData, kReadBuffLen, 0);
-					recvByteCnt	=	recv(socket_desc, returnedData, kReadBuffLen, MSG_NOSIGNAL);
-					if (gEnableDebug)
+					endOfHdrPtr	=	strstr(connection->rxBuffer, "\r\n\r\n");
+					if (endOfHdrPtr != NULL)
 					{
-						CONSOLE_DEBUG_W_NUM("errno      \t=",	errno);
-						CONSOLE_DEBUG_W_NUM("recvByteCnt\t=",	recvByteCnt);
+						headerLen		=	(endOfHdrPtr - connection->rxBuffer) + 4;
+						//*	HTTP/1.1 replies default to keep-alive
+						serverKeepAlive	=	(strncmp(connection->rxBuffer, "HTTP/1.1", 8) == 0);
+						linePtr			=	strstr(connection->rxBuffer, "\r\n");
+						while ((linePtr != NULL) && (linePtr < endOfHdrPtr))
+						{
+							linePtr	+=	2;
+							if (strncasecmp(linePtr, "Content-Length:", 15) == 0)
+							{
+								contentLength	=	atol(linePtr + 15);
+							}
+							else if (strncasecmp(linePtr, "Connection: close", 17) == 0)
+							{
+								serverKeepAlive	=	false;
+							}
+							else if (strncasecmp(linePtr, "Connection: keep-alive", 22) == 0)
+							{
+								serverKeepAlive	=	true;
+							}
+							linePtr	=	strstr(linePtr, "\r\n");
+						}
 					}
-					if (recvByteCnt > 0)
-					{
-						readSuccessCnt++;
-						returnedData[recvByteCnt]	=	0;
-//						CONSOLE_DEBUG_W_NUM("recvByteCnt\t=",	recvByteCnt);
-//						if (strstr(sendData, "switch") !=  NULL)
-//						{
-//							CONSOLE_DEBUG_W_STR("returnedData\t=", returnedData);
-//						}
-						validData	=	true;
-
-//						CONSOLE_DEBUG_W_STR("returnedData\t=",	returnedData);
-
-						strcat(longBuffer, returnedData);
-					}
-					else
-					{
-						keepReading		=	false;
-					}
-				}
-				if (gEnableDebug)
-				{
-					CONSOLE_DEBUG_W_NUM("readLoopCnt   \t=",	readLoopCnt);
-					CONSOLE_DEBUG_W_NUM("readSuccessCnt\t=",	readSuccessCnt);
-					CONSOLE_DEBUG_W_STR("longBuffer    \t=",	longBuffer);
 				}
-				SJP_Init(jsonParser);
-				parseReturnCode	=	SJP_ParseData(jsonParser, longBuffer);
-				if ((parseReturnCode != 0) || gEnableDebug)
+				if ((headerLen >= 0) && (contentLength >= 0) && (bytesInBuffer >= (headerLen + contentLength)))
 				{
-					CONSOLE_DEBUG_W_NUM("parseReturnCode   \t=",	parseReturnCode);
+					keepReading	=	false;
 				}
 			}
+			else if ((recvByteCnt < 0) && (errno == EINTR))
+			{
+				//*	try again
+			}
 			else
 			{
-				CONSOLE_DEBUG_W_NUM("sendRetCode\t=", sendRetCode);
+				//*	closed by the server or timed out
+				*serverClosed	=	((recvByteCnt == 0) || (errno == ECONNRESET));
+				serverKeepAlive	=	false;
+				keepReading		=	false;
 			}
-			if (gEnableDebug)
+		}
+	}
+	*keepOpen	=	(serverKeepAlive && (headerLen >= 0) && (contentLength >= 0) &&
+					(bytesInBuffer == (headerLen + contentLength)));
+	return(bytesInBuffer);
+}
+
+//*****************************************************************************
+//*	sends a complete request on a pooled connection and parses the reply
+//*
+//*	A pooled connection may have been closed by the server while it was idle.
+//*	The request is only sent again if the server closed or reset the connection
+//*	before any of the reply came back, never after a time out, the server may
+//*	still be working on it. A PUT is only sent again if send() itself failed,
+//*	once it has gone out it may have been acted on.
+//*****************************************************************************
+static bool	SendRequestAndParseReply(	struct sockaddr_in	*deviceAddress,
+										const int			port,
+										const char			*xmitBuffer,
+										SJP_Parser_t		*jsonParser,
+										const bool			isPutRequest)
+{
+TYPE_ClientConnection	*connection;
+bool					validData;
+bool					connectionOK;
+bool					wasReused;
+bool					keepOpen;
+bool					serverClosed;
+bool					tryAgain;
+int						sendRetCode;
+long					recvByteCnt;
+int						reuseCnt;
+int						reconnectCnt;
+int						parseReturnCode;
+char					ipString[32];
+struct timeval			startTime;
+struct timeval			endTime;
+double					elapsedSecs;
+
+	validData		=	false;
+	recvByteCnt		=	0;
+	keepOpen		=	false;
+	reuseCnt		=	0;
+	reconnectCnt	=	0;
+	inet_ntop(AF_INET, &deviceAddress->sin_addr.s_addr, ipString, INET_ADDRSTRLEN);
+
+	gettimeofday(&startTime, NULL);
+	connection	=	ClientConn_Get(deviceAddress, port);
+	if (connection != NULL)
+	{
+		do
+		{
+			tryAgain		=	false;
+			serverClosed	=	false;
+			wasReused		=	connection->connected;
+			connectionOK	=	wasReused;
+			if (wasReused)
+			{
+				reuseCnt++;
+			}
+			else
 			{
-				CONSOLE_DEBUG("Calling shutdown");
+				connectionOK	=	ClientConn_Open(connection, deviceAddress, port, ipString);
 			}
-			shutDownRetCode	=	shutdown(socket_desc, SHUT_RDWR);
-			if (shutDownRetCode != 0)
+			if (connectionOK)
 			{
-				CONSOLE_DEBUG_W_NUM("shutDownRetCode\t=", shutDownRetCode);
-				CONSOLE_DEBUG_W_NUM("errno\t=", errno);
-				CONSOLE_DEBUG(strerror(errno));
+				sendRetCode	=	send(connection->socketFD, xmitBuffer, strlen(xmitBuffer), MSG_NOSIGNAL);
+				if (sendRetCode >= 0)
+				{
+					recvByteCnt	=	ClientConn_ReadResponse(connection, &keepOpen, &serverClosed);
+					if (isPutRequest)
+					{
+						serverClosed	=	false;
+					}
+				}
+				else
+				{
+					serverClosed	=	((errno == EPIPE) || (errno == ECONNRESET));
+					if (wasReused == false)
+					{
+						CONSOLE_DEBUG_W_NUM("sendRetCode\t=", sendRetCode);
+					}
+				}
+				if (recvByteCnt == 0)
+				{
+					ClientConn_Close(connection);
+					if (wasReused && serverClosed)
+					{
+						//*	the server closed it while it was idle, try again on a new connection
+						reconnectCnt++;
+						tryAgain	=	true;
+					}
+				}
+			}
+		} while (tryAgain);
 
+		if (recvByteCnt > 0)
+		{
+			validData		=	true;
+			//*	the buffer gets reused for the next reply, so it can be parsed in place
+			parseReturnCode	=	SJP_ParseDataInPlace(jsonParser, connection->rxBuffer, recvByteCnt);
+			if ((parseReturnCode != 0) || gEnableDebug)
+			{
+				CONSOLE_DEBUG_W_NUM("parseReturnCode   \t=",	parseReturnCode);
 			}
-//			CONSOLE_DEBUG(__FUNCTION__);
 		}
-		else if (errno == ECONNREFUSED)
-		{
-		char	portString[32];
+		gettimeofday(&endTime, NULL);
+		elapsedSecs	=	(endTime.tv_sec - startTime.tv_sec) + ((endTime.tv_usec - startTime.tv_usec) / 1000000.0);
+		ClientConn_Release(connection, keepOpen, recvByteCnt, elapsedSecs, reuseCnt, reconnectCnt);
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_NUM("All client connections are busy, kMaxClientConnections\t=", kMaxClientConnections);
+	}
+	return(validData);
+}
 
-			sprintf(portString, ":%d", port);
-			CONSOLE_DEBUG_W_2STR("connect refused", ipString, portString);
-		}
-		else
+//*****************************************************************************
+void	SendRequest_GetStats(TYPE_SendRequestStats *requestStats)
+{
+int		iii;
+
+	memset(requestStats, 0, sizeof(TYPE_SendRequestStats));
+
+	pthread_mutex_lock(&gClientConnMutex);
+	requestStats->SocketOpenOKcnt	=	gNumSocketOpenOKcnt;
+	requestStats->SocketOpenErrCnt	=	gNumSocketOpenErrCnt;
+	requestStats->SocketConnOKcnt	=	gNumSocketConnOKcnt;
+	requestStats->SocketConnErrCnt	=	gNumSocketConnErrCnt;
+	requestStats->RequestCnt		=	gNumRequestCnt;
+	requestStats->ReusedConnCnt		=	gNumSocketReuseCnt;
+	requestStats->ReconnectCnt		=	gNumSocketReconnectCnt;
+	requestStats->BytesReceived		=	gNumBytesReceived;
+	if (gNumRequestCnt > 0)
+	{
+		requestStats->ConnectionsPerRequest	=	1.0 * (gNumRequestCnt - gNumSocketReuseCnt + gNumSocketReconnectCnt) / gNumRequestCnt;
+	}
+	if (gRequestTotalSecs > 0.0)
+	{
+		requestStats->BytesPerSecond	=	gNumBytesReceived / gRequestTotalSecs;
+	}
+	for (iii=0; iii<kMaxClientConnections; iii++)
+	{
+		if (gClientConn[iii].connected && (gClientConn[iii].inUse == false))
 		{
-		char	errorString[64];
+			requestStats->IdleConnCnt++;
+		}
+	}
+	pthread_mutex_unlock(&gClientConnMutex);
+}
 
-			CONSOLE_DEBUG_W_STR("connect error, ipaddress\t=",	ipString);
-			CONSOLE_DEBUG_W_STR("connect error, send data\t=",	sendData);
-		//	CONSOLE_DEBUG_W_NUM("errno\t\t\t=", errno);
+//*****************************************************************************
+bool	GetJsonResponse(	struct sockaddr_in	*deviceAddress,
+							const int			port,
+							const char			*sendData,
+							const char			*dataString,
+							SJP_Parser_t		*jsonParser)
+{
+bool				validData;
+char				xmitBuffer[kReadBuffLen + 10];
+char				linebuf[100];
+int					dataStrLen;
+char				ipString[32];
 
-			GetLinuxErrorString(errno, errorString);
+	if (gEnableDebug)
+	{
+		CONSOLE_DEBUG_W_STR(__FUNCTION__, "------start-------");
+		CONSOLE_DEBUG(sendData);
+		CONSOLE_DEBUG_W_SIZE("sizeof(xmitBuffer)  \t=", sizeof(xmitBuffer));
+	}
+	inet_ntop(AF_INET, &deviceAddress->sin_addr.s_addr, ipString, INET_ADDRSTRLEN);
 
-			CONSOLE_DEBUG_W_STR("Error message\t\t=",	errorString);
-		}
-		closeRetCode	=	close(socket_desc);
-		if (closeRetCode != 0)
-		{
-			CONSOLE_DEBUG("Close error");
-		}
-//		CONSOLE_DEBUG(__FUNCTION__);
+	SETUP_TIMING();
+
+//	GET /api/v1/camera/0/supportedactions HTTP/1.1
+//	Host: newt16:6800
+//	User-Agent: Mozilla/5.0 (X11; Ubuntu; Linux x86_64; rv:71.0) Gecko/20100101 Firefox/71.0
+//	Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8
+//	Accept-Language: en-US,en;q=0.5
+//	Accept-Encoding: gzip, deflate
+//	Connection: keep-alive
+//	Upgrade-Insecure-Requests: 1
+//	Cache-Control: max-age=0
+
+//	GET /api/v1/camera/0/supportedactions HTTP/1.1
+//	Host: ascom:11111
+//	User-Agent: AlpacaPi
+//	Accept: text/html,application/json
+//	Accept-Language: en-US,en;q=0.5
+//	Connection: keep-alive
+
+	strcpy(xmitBuffer,	"GET ");
+	strcat(xmitBuffer,	sendData);
+	strcat(xmitBuffer,	" HTTP/1.0\r\n");
+//	strcat(xmitBuffer,	"Host: ascom:11111\r\n");
+	sprintf(linebuf,	"Host: %s:%d\r\n", ipString, port);
+	strcat(xmitBuffer,	linebuf);
+//	strcat(xmitBuffer,	"User-Agent: AlpacaPi\r\n");
+	if (strlen(gUserAgentAlpacaPiStr))
+	{
+		//*	add User-Agent:
+		strcat(xmitBuffer,	gUserAgentAlpacaPiStr);
+	}
+	strcat(xmitBuffer,	"Accept: text/html,application/json\r\n");
+
+	strcat(xmitBuffer,	"Accept-Language: en-US,en;q=0.5\r\n");
+	strcat(xmitBuffer,	"Connection: keep-alive\r\n");
+
+	//*	on a connection that stays open nothing may follow the body,
+	//*	the server would take it as the start of the next request
+	if (dataString != NULL)
+	{
+//		CONSOLE_DEBUG_W_STR("dataString\t=", dataString);
+		dataStrLen	=	strlen(dataString);
+		sprintf(linebuf, "Content-Length: %d\r\n", dataStrLen);
+		strcat(xmitBuffer, linebuf);
+		strcat(xmitBuffer, "\r\n");
+
+		strcat(xmitBuffer, dataString);
 	}
 	else
 	{
-		if (errno == EMFILE)
-		{
-			CONSOLE_DEBUG("Too many files open!!!!!!!!!!!!!!!!!!!!!!!!!");
-		}
-		else
-		{
-			CONSOLE_DEBUG_W_NUM("socket_desc\t=", socket_desc);
-			CONSOLE_DEBUG_W_NUM("errno\t\t=", errno);
-		}
+		//*	this EXTRA CR/LF is VERY important for Alpaca Remote Server
+		strcat(xmitBuffer, "\r\n");
 	}
+
+	if (gEnableDebug)
+	{
+		CONSOLE_DEBUG_W_SIZE("length xmitBuffer\t=", strlen(xmitBuffer));
+	}
+
+	validData	=	SendRequestAndParseReply(deviceAddress, port, xmitBuffer, jsonParser, false);
+
 	if (gEnableDebug)
 	{
 		CONSOLE_DEBUG_W_STR(__FUNCTION__, "EXIT");
@@ -512,19 +843,10 @@ bool	SendPutCommand(	struct sockaddr_in	*deviceAddress,
 						SJP_Parser_t		*jsonParser)
 {
 bool				validData;
-int					socket_desc;
-struct sockaddr_in	remoteDev;
-int					connRetCode;
-int					sendRetCode;
-int					shutDownRetCode;
-int					closeRetCode;
-int					recvByteCnt;
-char				returnedData[kReadBuffLen];
 char				xmitBuffer[kReadBuffLen];
 char				linebuf[128];
 int					dataStrLen;
 char				ipString[32];
-int					setOptRetCode;
 
 //	CONSOLE_DEBUG_W_STR("putCommand\t=", putCommand);
 //	CONSOLE_DEBUG_W_STR("dataString\t=", dataString);
@@ -532,144 +854,62 @@ int					setOptRetCode;
 
 	inet_ntop(AF_INET, &deviceAddress->sin_addr.s_addr, ipString, INET_ADDRSTRLEN);
 
-	validData	=	false;
-	socket_desc	=	socket(AF_INET , SOCK_STREAM , 0);
-	if (socket_desc >= 0)
+	//	PUT /api/v1/dome/0/openshutter HTTP/1.1
+	//	Host: test:6800
+	//	User-Agent: curl/7.47.0
+	//	accept: application/json
+	//	Content-Type: application/x-www-form-urlencoded
+	//	Content-Length: 32
+
+	//	ClientID=2&ClientTransactionID=4
+
+
+	//PUT /api/v1/camera/0/connected HTTP/1.1
+	//Host: newt16:6800
+	//User-Agent: curl/7.58.0
+	//accept: application/json
+	//Content-Length: 14
+	//Content-Type: application/x-www-form-urlencoded
+	//
+	//Connected=true
+
+	//PUT /api/v1/camera/0/connected HTTP/1.0
+	//Host: 127.0.0.1:6800
+	//User-Agent: AlpacaPi
+	//Accept: text/html,application/json
+	//Content-Length: 47
+	//
+	//Connected=true&ClientID=1&ClientTransactionID=1
+
+	strcpy(xmitBuffer,	"PUT ");
+	strcat(xmitBuffer,	putCommand);
+	strcat(xmitBuffer,	" HTTP/1.0\r\n");
+//	strcat(xmitBuffer,	"Host: 192.168.1.156:32323\r\n");
+	sprintf(linebuf,	"Host: %s:%d\r\n", ipString, port);
+	strcat(xmitBuffer,	linebuf);
+//	strcat(xmitBuffer,	"User-Agent: AlpacaPi\r\n");
+	if (strlen(gUserAgentAlpacaPiStr))
 	{
-		//*	set a timeout
-		setOptRetCode	=	SetSocketTimeouts(socket_desc, kTimeOutLenSeconds, 0);
-	//	setOptRetCode	=	SetSocketTimeouts(socket_desc, 0, 25000);
-		if (setOptRetCode != 0)
-		{
-			CONSOLE_DEBUG("SetSocketTimeouts() failed");
-		}
-
-		remoteDev.sin_addr.s_addr	=	deviceAddress->sin_addr.s_addr;
-		remoteDev.sin_family		=	AF_INET;
-		remoteDev.sin_port			=	htons(port);
-		//*	Connect to remote device
-		connRetCode	=	connect(socket_desc , (struct sockaddr *)&remoteDev , sizeof(remoteDev));
-		if (connRetCode >= 0)
-		{
-//			CONSOLE_DEBUG_W_STR("connect open", ipString);
-
-			//	PUT /api/v1/dome/0/openshutter HTTP/1.1
-			//	Host: test:6800
-			//	User-Agent: curl/7.47.0
-			//	accept: application/json
-			//	Content-Type: application/x-www-form-urlencoded
-			//	Content-Length: 32
-
-			//	ClientID=2&ClientTransactionID=4
-
-
-			//PUT /api/v1/camera/0/connected HTTP/1.1
-			//Host: newt16:6800
-			//User-Agent: curl/7.58.0
-			//accept: application/json
-			//Content-Length: 14
-			//Content-Type: application/x-www-form-urlencoded
-			//
-			//Connected=true
-
-			//PUT /api/v1/camera/0/connected HTTP/1.0
-			//Host: 127.0.0.1:6800
-			//User-Agent: AlpacaPi
-			//Accept: text/html,application/json
-			//Content-Length: 47
-			//
-			//Connected=true&ClientID=1&ClientTransactionID=1
-
-			//PUT /api/v1/camera/0/connected HTTP/1.0
-			//Host: 127.0.0.1:32323
-			//User-Agent: AlpacaPi
-			//Accept: text/html,application/json
-			//Content-Length: 47
-			//
-			//Connected=true&ClientID=1&ClientTransactionID=1
-
-			strcpy(xmitBuffer,	"PUT ");
-			strcat(xmitBuffer,	putCommand);
-			strcat(xmitBuffer,	" HTTP/1.0\r\n");
-//			strcat(xmitBuffer,	"Host: 192.168.1.156:32323\r\n");
-			sprintf(linebuf,	"Host: %s:%d\r\n", ipString, port);
-			strcat(xmitBuffer,	linebuf);
-//			strcat(xmitBuffer,	"User-Agent: AlpacaPi\r\n");
-			if (strlen(gUserAgentAlpacaPiStr))
-			{
-				//*	add User-Agent:
-				strcat(xmitBuffer,	gUserAgentAlpacaPiStr);
-			}
-			strcat(xmitBuffer,	"Connection: close\r\n");
-			strcat(xmitBuffer,	"Accept: text/html,application/json\r\n");
-			strcat(xmitBuffer,	"Content-Type: application/x-www-form-urlencoded\r\n");
-
-			if (dataString != NULL)
-			{
-				dataStrLen	=	strlen(dataString);
-				sprintf(linebuf, "Content-Length: %d\r\n", dataStrLen);
-				strcat(xmitBuffer, linebuf);
-				strcat(xmitBuffer, "\r\n");
-
-				strcat(xmitBuffer, dataString);
-				strcat(xmitBuffer, "\r\n");
-			}
-			else
-			{
-				//*	this EXTRA CR/LF is VERY important for Alpaca Remote Server
-				strcat(xmitBuffer, "\r\n");
-			}
-			strcat(xmitBuffer, "\r\n");
-//			CONSOLE_DEBUG_W_STR("Sending:", xmitBuffer);
-
-			sendRetCode	=	send(socket_desc , xmitBuffer , strlen(xmitBuffer) , MSG_NOSIGNAL);
-			if (sendRetCode >= 0)
-			{
-				recvByteCnt	=	recv(socket_desc, returnedData , kReadBuffLen , MSG_NOSIGNAL);
-				if (recvByteCnt >= 0)
-				{
-//					CONSOLE_DEBUG("Setting validData to true");
-					validData					=	true;
-					returnedData[recvByteCnt]	=	0;
-					SJP_Init(jsonParser);
-					SJP_ParseData(jsonParser, returnedData);
-//					CONSOLE_DEBUG_W_STR("returnedData=\r\n", returnedData);
-				}
-			}
-			shutDownRetCode	=	shutdown(socket_desc, SHUT_RDWR);
-			if (shutDownRetCode != 0)
-			{
-				CONSOLE_DEBUG_W_NUM("shutDownRetCode\t=", shutDownRetCode);
-				CONSOLE_DEBUG_W_NUM("errno\t=", errno);
-			}
-			closeRetCode	=	close(socket_desc);
-			if (closeRetCode != 0)
-			{
-				CONSOLE_DEBUG("Close error");
-			}
-		}
-		else if (errno == ECONNREFUSED)
-		{
-			CONSOLE_DEBUG_W_STR("connect refused", ipString);
-		}
-		else
-		{
-			CONSOLE_DEBUG("connect error");
-			CONSOLE_DEBUG_W_NUM("errno\t=", errno);
-		}
+		//*	add User-Agent:
+		strcat(xmitBuffer,	gUserAgentAlpacaPiStr);
 	}
-	else
+	strcat(xmitBuffer,	"Connection: keep-alive\r\n");
+	strcat(xmitBuffer,	"Accept: text/html,application/json\r\n");
+	strcat(xmitBuffer,	"Content-Type: application/x-www-form-urlencoded\r\n");
+
+	//*	exactly Content-Length bytes after the header, see GetJsonResponse()
+	dataStrLen	=	(dataString != NULL) ? strlen(dataString) : 0;
+	sprintf(linebuf, "Content-Length: %d\r\n", dataStrLen);
+	strcat(xmitBuffer, linebuf);
+	strcat(xmitBuffer, "\r\n");
+	if (dataString != NULL)
 	{
-		if (errno == EMFILE)
-		{
-			CONSOLE_DEBUG("Too many files open!!!!!!!!!!!!!!!!!!!!!!!!!");
-		}
-		else
-		{
-			CONSOLE_DEBUG_W_NUM("socket_desc\t=", socket_desc);
-			CONSOLE_DEBUG_W_NUM("errno\t\t=", errno);
-		}
+		strcat(xmitBuffer, dataString);
 	}
+//	CONSOLE_DEBUG_W_STR("Sending:", xmitBuffer);
+
+	validData	=	SendRequestAndParseReply(deviceAddress, port, xmitBuffer, jsonParser, true);
+
 //	CONSOLE_DEBUG_W_STR(__FUNCTION__, (validData ? "Valid Data" : "Not Valid"));
 	return(validData);
 }
@@ -4,6 +4,10 @@
 #ifndef _SENDREQUEST_LIB_H
 #define _SENDREQUEST_LIB_H
 
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
 #ifndef _JSON_PARSE_H_
 	#include	"json_parse.h"
 #endif
@@ -15,6 +19,23 @@
 #define		kReadBuffLen		5000
 #define		kLargeBufferSize	12000
 
+//*****************************************************************************
+//*	outgoing requests, GetJsonResponse() and SendPutCommand() reuse connections
+typedef struct
+{
+	int			SocketOpenOKcnt;
+	int			SocketOpenErrCnt;
+	int			SocketConnOKcnt;			//*	TCP connections made
+	int			SocketConnErrCnt;
+	int			RequestCnt;
+	int			ReusedConnCnt;				//*	each one saved a TCP handshake
+	int			ReconnectCnt;				//*	pooled connections the server had closed
+	int			IdleConnCnt;				//*	open and waiting in the pool
+	double		ConnectionsPerRequest;
+	uint64_t	BytesReceived;
+	double		BytesPerSecond;				//*	while waiting for replies
+} TYPE_SendRequestStats;
+
 
 void	PrintIPaddressToString(const long ipAddress, char *ipString);
 bool	GetJsonResponse(	struct sockaddr_in	*deviceAddress,
@@ -29,6 +50,7 @@ bool	SendPutCommand(		struct sockaddr_in	*deviceAddress,
 							SJP_Parser_t		*jsonParser);
 
 void	Set_SendRequestLibDebug(bool enableFlag);
+void	SendRequest_GetStats(TYPE_SendRequestStats *requestStats);
 #define	READ_BINARY_IMAGE		true
 #define	READ_JSON_IMAGE			false
 int		OpenSocketAndSendRequest(	struct sockaddr_in	*deviceAddress,
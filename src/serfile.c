@@ -0,0 +1,536 @@
+//*****************************************************************************
+//*
+//*	Name:			serfile.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	SER video file writer (and reader for checking)
+//*
+//*	Usage notes:	SER is the standard for planetary video. It is a 178 byte header,
+//*					the raw frames one after the other and a trailer with one
+//*					64 bit UTC time stamp per frame.
+//*
+//*					The frames go in exactly as the camera gave them, 8 or 16 bits,
+//*					mono, bayer or BGR, so there is no encoding cost and nothing is lost.
+//*
+//*					Small frames are collected in a 4 MB page aligned buffer so the
+//*					disk sees a few large writes instead of many small ones.
+//*					The file is extended with posix_fallocate() ahead of the writes
+//*					so the filesystem is not allocating blocks on every write, and it is
+//*					trimmed to the real size when it is closed.
+//*
+//*	Limitations:	The frame count in the header is written when the file is closed.
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created serfile.c
+//*****************************************************************************
+
+#ifndef _GNU_SOURCE
+	#define	_GNU_SOURCE
+#endif
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<errno.h>
+#include	<fcntl.h>
+#include	<time.h>
+#include	<unistd.h>
+#include	<sys/time.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"serfile.h"
+
+#define	kSER_WriteBufferSize	(4 * 1024 * 1024)
+#define	kSER_WriteAlignment		4096
+#define	kSER_PreallocStep		(256 * 1024 * 1024)
+
+//*	100 ns ticks from Jan 1, 0001 to Jan 1, 1970
+#define	kSER_TicksToUnixEpoch	621355968000000000ULL
+#define	kSER_TicksPerSecond		10000000ULL
+
+//*****************************************************************************
+static void	PutInt32(unsigned char *bufPtr, uint32_t value)
+{
+	bufPtr[0]	=	value & 0x0ff;
+	bufPtr[1]	=	(value >> 8) & 0x0ff;
+	bufPtr[2]	=	(value >> 16) & 0x0ff;
+	bufPtr[3]	=	(value >> 24) & 0x0ff;
+}
+
+//*****************************************************************************
+static void	PutInt64(unsigned char *bufPtr, uint64_t value)
+{
+	PutInt32(bufPtr,		(uint32_t)(value & 0x0ffffffff));
+	PutInt32(bufPtr + 4,	(uint32_t)(value >> 32));
+}
+
+//*****************************************************************************
+static uint32_t	GetInt32(const unsigned char *bufPtr)
+{
+	return(bufPtr[0] | (bufPtr[1] << 8) | (bufPtr[2] << 16) | ((uint32_t)bufPtr[3] << 24));
+}
+
+//*****************************************************************************
+static uint64_t	GetInt64(const unsigned char *bufPtr)
+{
+	return(GetInt32(bufPtr) | ((uint64_t)GetInt32(bufPtr + 4) << 32));
+}
+
+//*****************************************************************************
+static void	PutString(unsigned char *bufPtr, const char *theString)
+{
+size_t	stringLen;
+
+	memset(bufPtr, 0, kSER_StringLen);
+	stringLen	=	strlen(theString);
+	if (stringLen > kSER_StringLen)
+	{
+		stringLen	=	kSER_StringLen;
+	}
+	memcpy(bufPtr, theString, stringLen);
+}
+
+//*****************************************************************************
+static void	EncodeHeader(const TYPE_SERheader *serHeader, unsigned char *headerBuf)
+{
+	memset(headerBuf, 0, kSER_HeaderSize);
+	memcpy(headerBuf, "LUCAM-RECORDER", 14);
+	PutInt32(&headerBuf[14],	serHeader->luID);
+	PutInt32(&headerBuf[18],	serHeader->colorID);
+	PutInt32(&headerBuf[22],	serHeader->littleEndian);
+	PutInt32(&headerBuf[26],	serHeader->imageWidth);
+	PutInt32(&headerBuf[30],	serHeader->imageHeight);
+	PutInt32(&headerBuf[34],	serHeader->pixelDepth);
+	PutInt32(&headerBuf[38],	serHeader->frameCount);
+	PutString(&headerBuf[42],	serHeader->observer);
+	PutString(&headerBuf[82],	serHeader->instrument);
+	PutString(&headerBuf[122],	serHeader->telescope);
+	PutInt64(&headerBuf[162],	serHeader->dateTime);
+	PutInt64(&headerBuf[170],	serHeader->dateTime_UTC);
+}
+
+//*****************************************************************************
+uint64_t	SERfile_TimeValToTicks(const struct timeval *timeStamp)
+{
+uint64_t	ticks;
+
+	ticks	=	kSER_TicksToUnixEpoch;
+	ticks	+=	(uint64_t)timeStamp->tv_sec * kSER_TicksPerSecond;
+	ticks	+=	(uint64_t)timeStamp->tv_usec * 10;
+	return(ticks);
+}
+
+//*****************************************************************************
+void	SERfile_TicksToTimeVal(uint64_t ticks, struct timeval *timeStamp)
+{
+	ticks				-=	kSER_TicksToUnixEpoch;
+	timeStamp->tv_sec	=	ticks / kSER_TicksPerSecond;
+	timeStamp->tv_usec	=	(ticks % kSER_TicksPerSecond) / 10;
+}
+
+//*****************************************************************************
+long	SERfile_GetFrameSize(int width, int height, int colorID, int pixelDepth)
+{
+long	frameSize;
+
+	frameSize	=	(long)width * height;
+	if ((colorID == kSER_RGB) || (colorID == kSER_BGR))
+	{
+		frameSize	*=	3;
+	}
+	if (pixelDepth > 8)
+	{
+		frameSize	*=	2;
+	}
+	return(frameSize);
+}
+
+//*****************************************************************************
+static bool	WriteAll(TYPE_SERfile *serFile, const unsigned char *dataPtr, long dataLen)
+{
+ssize_t		bytesWritten;
+
+	while ((dataLen > 0) && (serFile->writeError == false))
+	{
+		bytesWritten	=	pwrite(serFile->fileDesc, dataPtr, dataLen, serFile->fileOffset);
+		if (bytesWritten > 0)
+		{
+			dataPtr					+=	bytesWritten;
+			dataLen					-=	bytesWritten;
+			serFile->fileOffset		+=	bytesWritten;
+		}
+		else if ((bytesWritten < 0) && (errno == EINTR))
+		{
+			//*	try again
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("SER write failed, errno\t=", errno);
+			serFile->writeError	=	true;
+		}
+	}
+	return(serFile->writeError == false);
+}
+
+//*****************************************************************************
+static bool	FlushWriteBuffer(TYPE_SERfile *serFile)
+{
+bool	writeOK;
+
+	writeOK	=	true;
+	if (serFile->writeBufferUsed > 0)
+	{
+		writeOK						=	WriteAll(serFile, serFile->writeBuffer, serFile->writeBufferUsed);
+		serFile->writeBufferUsed	=	0;
+	}
+	return(writeOK);
+}
+
+//*****************************************************************************
+//*	keep the preallocated part of the file ahead of what we are about to write
+//*****************************************************************************
+static void	Preallocate(TYPE_SERfile *serFile, uint64_t neededSize)
+{
+uint64_t	newSize;
+int			allocErr;
+
+	if (serFile->preallocOK && (neededSize > serFile->preallocatedSize))
+	{
+		newSize	=	serFile->preallocatedSize + kSER_PreallocStep;
+		if (newSize < neededSize)
+		{
+			newSize	=	neededSize;
+		}
+		allocErr	=	posix_fallocate(serFile->fileDesc, serFile->preallocatedSize, newSize - serFile->preallocatedSize);
+		if (allocErr == 0)
+		{
+			serFile->preallocatedSize	=	newSize;
+		}
+		else
+		{
+			//*	not supported on this filesystem or out of space, the writes will tell us which
+			CONSOLE_DEBUG_W_NUM("posix_fallocate() failed\t=", allocErr);
+			serFile->preallocOK	=	false;
+		}
+	}
+}
+
+//*****************************************************************************
+bool	SERfile_Create(	TYPE_SERfile	*serFile,
+						const char		*filePath,
+						int				width,
+						int				height,
+						int				colorID,
+						int				pixelDepth,
+						const char		*observer,
+						const char		*instrument,
+						const char		*telescope,
+						int				expectedFrameCnt)
+{
+bool	createOK;
+int		allocErr;
+
+	memset(serFile, 0, sizeof(TYPE_SERfile));
+	serFile->fileDesc		=	-1;
+	serFile->frameSize		=	SERfile_GetFrameSize(width, height, colorID, pixelDepth);
+	serFile->preallocOK		=	true;
+
+	strcpy(serFile->header.fileID, "LUCAM-RECORDER");
+	serFile->header.luID			=	0;
+	serFile->header.colorID			=	colorID;
+	//*	the spec says 1 means little endian, but FireCapture, SharpCap and the
+	//*	stacking programs all use 0 for little endian data, so we do too
+	serFile->header.littleEndian	=	0;
+	serFile->header.imageWidth		=	width;
+	serFile->header.imageHeight		=	height;
+	serFile->header.pixelDepth		=	pixelDepth;
+	serFile->header.frameCount		=	0;
+	strncpy(serFile->header.observer,	((observer != NULL) ? observer : ""),		kSER_StringLen);
+	strncpy(serFile->header.instrument,	((instrument != NULL) ? instrument : ""),	kSER_StringLen);
+	strncpy(serFile->header.telescope,	((telescope != NULL) ? telescope : ""),		kSER_StringLen);
+
+	createOK	=	false;
+	if ((serFile->frameSize > 0) && ((pixelDepth == 8) || (pixelDepth == 16)))
+	{
+		serFile->writeBufferSize	=	kSER_WriteBufferSize;
+		allocErr					=	posix_memalign((void **)&serFile->writeBuffer, kSER_WriteAlignment, serFile->writeBufferSize);
+		if (allocErr == 0)
+		{
+			serFile->fileDesc	=	open(filePath, (O_WRONLY | O_CREAT | O_TRUNC), 0644);
+			if (serFile->fileDesc >= 0)
+			{
+				if (expectedFrameCnt > 0)
+				{
+					Preallocate(serFile, kSER_HeaderSize + ((uint64_t)expectedFrameCnt * (serFile->frameSize + 8)));
+				}
+				//*	the header goes out with the first block of frames, it gets rewritten at the end
+				EncodeHeader(&serFile->header, serFile->writeBuffer);
+				serFile->writeBufferUsed	=	kSER_HeaderSize;
+				createOK					=	true;
+			}
+			else
+			{
+				CONSOLE_DEBUG_W_STR("Failed to create", filePath);
+			}
+		}
+	}
+	if (createOK == false)
+	{
+		if (serFile->writeBuffer != NULL)
+		{
+			free(serFile->writeBuffer);
+			serFile->writeBuffer	=	NULL;
+		}
+	}
+	return(createOK);
+}
+
+//*****************************************************************************
+bool	SERfile_AddFrame(	TYPE_SERfile			*serFile,
+							const unsigned char		*frameData,
+							const struct timeval	*timeStamp)
+{
+uint64_t	*newTimeStamps;
+int32_t		newAlloc;
+
+	if ((serFile->fileDesc >= 0) && (serFile->writeError == false))
+	{
+		//*	save the time stamp for the trailer
+		if (serFile->header.frameCount >= serFile->timeStampAlloc)
+		{
+			newAlloc		=	(serFile->timeStampAlloc > 0) ? (serFile->timeStampAlloc * 2) : 1024;
+			newTimeStamps	=	(uint64_t *)realloc(serFile->timeStamps, newAlloc * sizeof(uint64_t));
+			if (newTimeStamps != NULL)
+			{
+				serFile->timeStamps		=	newTimeStamps;
+				serFile->timeStampAlloc	=	newAlloc;
+			}
+			else
+			{
+				serFile->writeError	=	true;
+				return(false);
+			}
+		}
+		serFile->timeStamps[serFile->header.frameCount]	=	SERfile_TimeValToTicks(timeStamp);
+		serFile->header.frameCount++;
+
+		Preallocate(serFile, serFile->fileOffset + serFile->writeBufferUsed + serFile->frameSize);
+
+		if (serFile->frameSize > (serFile->writeBufferSize / 2))
+		{
+			//*	big frames are already a large write, don't copy them
+			FlushWriteBuffer(serFile);
+			WriteAll(serFile, frameData, serFile->frameSize);
+		}
+		else
+		{
+			if ((serFile->writeBufferUsed + serFile->frameSize) > serFile->writeBufferSize)
+			{
+				FlushWriteBuffer(serFile);
+			}
+			memcpy(&serFile->writeBuffer[serFile->writeBufferUsed], frameData, serFile->frameSize);
+			serFile->writeBufferUsed	+=	serFile->frameSize;
+		}
+	}
+	return(serFile->writeError == false);
+}
+
+//*****************************************************************************
+bool	SERfile_Close(TYPE_SERfile *serFile)
+{
+unsigned char	headerBuf[kSER_HeaderSize];
+unsigned char	*trailerBuf;
+uint64_t		dataEnd;
+struct tm		localTime;
+time_t			firstFrameSecs;
+struct timeval	firstFrameTime;
+int32_t			iii;
+bool			closeOK;
+
+	closeOK	=	false;
+	if (serFile->fileDesc >= 0)
+	{
+		FlushWriteBuffer(serFile);
+		dataEnd	=	serFile->fileOffset;
+
+		//*	time stamp trailer
+		if (serFile->header.frameCount > 0)
+		{
+			trailerBuf	=	(unsigned char *)malloc(serFile->header.frameCount * 8);
+			if (trailerBuf != NULL)
+			{
+				for (iii=0; iii<serFile->header.frameCount; iii++)
+				{
+					PutInt64(&trailerBuf[iii * 8], serFile->timeStamps[iii]);
+				}
+				WriteAll(serFile, trailerBuf, (serFile->header.frameCount * 8));
+				free(trailerBuf);
+			}
+			else
+			{
+				serFile->writeError	=	true;
+			}
+
+			//*	the file time is the time of the first frame
+			SERfile_TicksToTimeVal(serFile->timeStamps[0], &firstFrameTime);
+			firstFrameSecs					=	firstFrameTime.tv_sec;
+			localtime_r(&firstFrameSecs, &localTime);
+			serFile->header.dateTime_UTC	=	serFile->timeStamps[0];
+			serFile->header.dateTime		=	serFile->timeStamps[0] + ((int64_t)localTime.tm_gmtoff * (int64_t)kSER_TicksPerSecond);
+		}
+
+		//*	give back whatever was preallocated past the end
+		if (ftruncate(serFile->fileDesc, serFile->fileOffset) != 0)
+		{
+			CONSOLE_DEBUG_W_NUM("ftruncate() failed, errno\t=", errno);
+		}
+
+		//*	now the header with the real frame count
+		EncodeHeader(&serFile->header, headerBuf);
+		serFile->fileOffset	=	0;
+		WriteAll(serFile, headerBuf, kSER_HeaderSize);
+		serFile->fileOffset	=	dataEnd;
+
+		if (close(serFile->fileDesc) != 0)
+		{
+			serFile->writeError	=	true;
+		}
+		serFile->fileDesc	=	-1;
+		closeOK				=	(serFile->writeError == false);
+	}
+
+	if (serFile->writeBuffer != NULL)
+	{
+		free(serFile->writeBuffer);
+		serFile->writeBuffer	=	NULL;
+	}
+	if (serFile->timeStamps != NULL)
+	{
+		free(serFile->timeStamps);
+		serFile->timeStamps		=	NULL;
+	}
+	serFile->timeStampAlloc	=	0;
+	return(closeOK);
+}
+
+#pragma mark -
+//*****************************************************************************
+bool	SERfile_ReadHeader(const char *filePath, TYPE_SERheader *serHeader)
+{
+unsigned char	headerBuf[kSER_HeaderSize];
+int				fileDesc;
+bool			readOK;
+
+	readOK		=	false;
+	memset(serHeader, 0, sizeof(TYPE_SERheader));
+	fileDesc	=	open(filePath, O_RDONLY);
+	if (fileDesc >= 0)
+	{
+		if (read(fileDesc, headerBuf, kSER_HeaderSize) == kSER_HeaderSize)
+		{
+			memcpy(serHeader->fileID, headerBuf, 14);
+			serHeader->luID			=	GetInt32(&headerBuf[14]);
+			serHeader->colorID		=	GetInt32(&headerBuf[18]);
+			serHeader->littleEndian	=	GetInt32(&headerBuf[22]);
+			serHeader->imageWidth	=	GetInt32(&headerBuf[26]);
+			serHeader->imageHeight	=	GetInt32(&headerBuf[30]);
+			serHeader->pixelDepth	=	GetInt32(&headerBuf[34]);
+			serHeader->frameCount	=	GetInt32(&headerBuf[38]);
+			memcpy(serHeader->observer,		&headerBuf[42],		kSER_StringLen);
+			memcpy(serHeader->instrument,	&headerBuf[82],		kSER_StringLen);
+			memcpy(serHeader->telescope,	&headerBuf[122],	kSER_StringLen);
+			serHeader->dateTime		=	GetInt64(&headerBuf[162]);
+			serHeader->dateTime_UTC	=	GetInt64(&headerBuf[170]);
+
+			readOK	=	(strcmp(serHeader->fileID, "LUCAM-RECORDER") == 0);
+		}
+		close(fileDesc);
+	}
+	return(readOK);
+}
+
+//*****************************************************************************
+//*	returns the number of time stamps read, -1 on error
+//*****************************************************************************
+int	SERfile_ReadTimeStamps(const char *filePath, const TYPE_SERheader *serHeader, uint64_t *timeStamps, int maxCount)
+{
+unsigned char	*trailerBuf;
+long			frameSize;
+off_t			trailerOffset;
+int				fileDesc;
+int				stampCnt;
+int				iii;
+
+	stampCnt	=	-1;
+	frameSize	=	SERfile_GetFrameSize(serHeader->imageWidth, serHeader->imageHeight, serHeader->colorID, serHeader->pixelDepth);
+	fileDesc	=	open(filePath, O_RDONLY);
+	if (fileDesc >= 0)
+	{
+		stampCnt	=	serHeader->frameCount;
+		if (stampCnt > maxCount)
+		{
+			stampCnt	=	maxCount;
+		}
+		trailerOffset	=	kSER_HeaderSize + ((off_t)frameSize * serHeader->frameCount);
+		trailerBuf		=	(unsigned char *)malloc((stampCnt * 8) + 8);
+		if ((trailerBuf != NULL) && (pread(fileDesc, trailerBuf, (stampCnt * 8), trailerOffset) == (stampCnt * 8)))
+		{
+			for (iii=0; iii<stampCnt; iii++)
+			{
+				timeStamps[iii]	=	GetInt64(&trailerBuf[iii * 8]);
+			}
+		}
+		else
+		{
+			stampCnt	=	-1;
+		}
+		if (trailerBuf != NULL)
+		{
+			free(trailerBuf);
+		}
+		close(fileDesc);
+	}
+	return(stampCnt);
+}
+
+//*****************************************************************************
+bool	SERfile_ReadFrame(const char *filePath, const TYPE_SERheader *serHeader, int frameIdx, unsigned char *frameData)
+{
+long	frameSize;
+int		fileDesc;
+bool	readOK;
+
+	readOK		=	false;
+	frameSize	=	SERfile_GetFrameSize(serHeader->imageWidth, serHeader->imageHeight, serHeader->colorID, serHeader->pixelDepth);
+	fileDesc	=	open(filePath, O_RDONLY);
+	if ((fileDesc >= 0) && (frameIdx >= 0) && (frameIdx < serHeader->frameCount))
+	{
+		readOK	=	(pread(fileDesc, frameData, frameSize, kSER_HeaderSize + ((off_t)frameSize * frameIdx)) == frameSize);
+	}
+	if (fileDesc >= 0)
+	{
+		close(fileDesc);
+	}
+	return(readOK);
+}
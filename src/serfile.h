@@ -0,0 +1,129 @@
+//**************************************************************************
+//*	Name:			serfile.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	SER video file writer (and reader for checking)
+//*
+//*	References:		SER format description version 3, Grischa Hahn, 2014
+//*					http://www.grischa-hahn.homepage.t-online.de/astro/ser/
+//*
+//*****************************************************************************
+//#include	"serfile.h"
+
+#ifndef _SERFILE_H_
+#define	_SERFILE_H_
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#ifndef _SYS_TIME_H
+	#include	<sys/time.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+//*	color IDs from the SER spec
+enum
+{
+	kSER_Mono			=	0,
+	kSER_BayerRGGB		=	8,
+	kSER_BayerGRBG		=	9,
+	kSER_BayerGBRG		=	10,
+	kSER_BayerBGGR		=	11,
+	kSER_RGB			=	100,
+	kSER_BGR			=	101			//*	openCV order, what RGB24 cameras give us
+};
+
+#define	kSER_HeaderSize			178
+#define	kSER_StringLen			40
+
+//*****************************************************************************
+typedef struct	//	TYPE_SERheader
+{
+	char		fileID[16];
+	int32_t		luID;
+	int32_t		colorID;
+	int32_t		littleEndian;
+	int32_t		imageWidth;
+	int32_t		imageHeight;
+	int32_t		pixelDepth;					//*	bits per plane, 8 or 16
+	int32_t		frameCount;
+	char		observer[kSER_StringLen + 1];
+	char		instrument[kSER_StringLen + 1];
+	char		telescope[kSER_StringLen + 1];
+	uint64_t	dateTime;					//*	local time of the first frame, 100 ns ticks since Jan 1, 0001
+	uint64_t	dateTime_UTC;
+
+} TYPE_SERheader;
+
+//*****************************************************************************
+//*	frames are copied into an aligned write buffer and written out in large blocks,
+//*	frames bigger than half the buffer are written straight from the caller's buffer.
+//*	the file is preallocated ahead of the writes and trimmed when it is closed
+//*****************************************************************************
+typedef struct	//	TYPE_SERfile
+{
+	int				fileDesc;
+	TYPE_SERheader	header;
+	long			frameSize;				//*	bytes
+	uint64_t		fileOffset;				//*	where the next write goes
+	uint64_t		preallocatedSize;
+	bool			preallocOK;
+	bool			writeError;
+
+	unsigned char	*writeBuffer;
+	long			writeBufferSize;
+	long			writeBufferUsed;
+
+	uint64_t		*timeStamps;			//*	written as the trailer when the file is closed
+	int32_t			timeStampAlloc;
+
+} TYPE_SERfile;
+
+
+//*	expectedFrameCnt is only a hint for the preallocation, 0 if not known
+bool		SERfile_Create(	TYPE_SERfile	*serFile,
+							const char		*filePath,
+							int				width,
+							int				height,
+							int				colorID,
+							int				pixelDepth,
+							const char		*observer,
+							const char		*instrument,
+							const char		*telescope,
+							int				expectedFrameCnt);
+
+//*	frameData is frameSize bytes, 16 bit data is little endian
+bool		SERfile_AddFrame(	TYPE_SERfile			*serFile,
+								const unsigned char		*frameData,
+								const struct timeval	*timeStamp);
+
+//*	writes the time stamp trailer and the final header, returns false if any write failed
+bool		SERfile_Close(TYPE_SERfile *serFile);
+
+long		SERfile_GetFrameSize(int width, int height, int colorID, int pixelDepth);
+
+uint64_t	SERfile_TimeValToTicks(const struct timeval *timeStamp);
+void		SERfile_TicksToTimeVal(uint64_t ticks, struct timeval *timeStamp);
+
+//*	these are for reading the file back
+bool		SERfile_ReadHeader(const char *filePath, TYPE_SERheader *serHeader);
+int			SERfile_ReadTimeStamps(const char *filePath, const TYPE_SERheader *serHeader, uint64_t *timeStamps, int maxCount);
+bool		SERfile_ReadFrame(const char *filePath, const TYPE_SERheader *serHeader, int frameIdx, unsigned char *frameData);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif	//	_SERFILE_H_
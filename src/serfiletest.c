@@ -0,0 +1,280 @@
+//*****************************************************************************
+//*
+//*	Name:			serfiletest.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Writes a SER file, reads it back and checks it
+//*
+//*	Usage notes:	For each of mono 8, bayer 16 and BGR 24 a file is written with
+//*					frames that each have their own pattern and time stamps 10 ms apart.
+//*					It is then read back to check the header, the frame count,
+//*					every time stamp and the contents of the first, middle and last frames.
+//*					Exits with 1 if anything does not match.
+//*
+//*		serfiletest
+//*		serfiletest -w 1920 -h 1080 -n 2000 -f /mnt/ssd/test.ser
+//*
+//*		-w	image width (default 640)
+//*		-h	image height (default 480)
+//*		-n	number of frames (default 500)
+//*		-f	file to write (default /tmp/serfiletest.ser), it is deleted afterwards
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 16,	2026	<MLS> Created serfiletest.c
+//*****************************************************************************
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	<sys/time.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"serfile.h"
+
+//*****************************************************************************
+static void	FillFrame(unsigned char *frameData, long frameSize, int frameNum)
+{
+long	iii;
+
+	for (iii=0; iii<frameSize; iii++)
+	{
+		frameData[iii]	=	(iii + (frameNum * 7)) & 0x0ff;
+	}
+	//*	so a frame that got written twice or in the wrong place shows up
+	memcpy(frameData, &frameNum, sizeof(frameNum));
+}
+
+//*****************************************************************************
+static double	ElapsedSecs(struct timeval *startTime, struct timeval *endTime)
+{
+	return((endTime->tv_sec - startTime->tv_sec) + ((endTime->tv_usec - startTime->tv_usec) / 1000000.0));
+}
+
+//*****************************************************************************
+static bool	TestFormat(	const char	*filePath,
+						const char	*formatName,
+						int			width,
+						int			height,
+						int			colorID,
+						int			pixelDepth,
+						int			frameCnt)
+{
+TYPE_SERfile	serFile;
+TYPE_SERheader	serHeader;
+unsigned char	*frameData;
+unsigned char	*readData;
+uint64_t		*timeStamps;
+long			frameSize;
+struct timeval	startTime;
+struct timeval	endTime;
+struct timeval	frameTime;
+struct timeval	checkTime;
+double			elapsedSecs;
+int				stampCnt;
+int				checkFrames[3];
+int				iii;
+bool			testOK;
+
+	testOK		=	true;
+	frameSize	=	SERfile_GetFrameSize(width, height, colorID, pixelDepth);
+	frameData	=	(unsigned char *)malloc(frameSize);
+	readData	=	(unsigned char *)malloc(frameSize);
+	timeStamps	=	(uint64_t *)malloc(frameCnt * sizeof(uint64_t));
+	if ((frameData == NULL) || (readData == NULL) || (timeStamps == NULL))
+	{
+		printf("Failed to allocate memory\r\n");
+		exit(1);
+	}
+
+	//------------------------------------------------------------
+	//*	write it, the time is only the writing, not filling in the frames
+	frameTime.tv_sec	=	1760600000;
+	frameTime.tv_usec	=	123456;
+	elapsedSecs			=	0.0;
+	if (SERfile_Create(&serFile, filePath, width, height, colorID, pixelDepth, "observer", "serfiletest", "telescope", frameCnt))
+	{
+		for (iii=0; iii<frameCnt; iii++)
+		{
+			FillFrame(frameData, frameSize, iii);
+			gettimeofday(&startTime, NULL);
+			SERfile_AddFrame(&serFile, frameData, &frameTime);
+			gettimeofday(&endTime, NULL);
+			elapsedSecs	+=	ElapsedSecs(&startTime, &endTime);
+
+			frameTime.tv_usec	+=	10000;
+			frameTime.tv_sec	+=	frameTime.tv_usec / 1000000;
+			frameTime.tv_usec	=	frameTime.tv_usec % 1000000;
+		}
+		gettimeofday(&startTime, NULL);
+		if (SERfile_Close(&serFile) == false)
+		{
+			printf("%-8s SERfile_Close() reported a write error\r\n", formatName);
+			testOK	=	false;
+		}
+		gettimeofday(&endTime, NULL);
+		elapsedSecs	+=	ElapsedSecs(&startTime, &endTime);
+	}
+	else
+	{
+		printf("%-8s Failed to create %s\r\n", formatName, filePath);
+		testOK	=	false;
+	}
+
+	//------------------------------------------------------------
+	//*	read it back
+	if (testOK)
+	{
+		if (SERfile_ReadHeader(filePath, &serHeader))
+		{
+			if ((serHeader.imageWidth != width) || (serHeader.imageHeight != height) ||
+				(serHeader.colorID != colorID) || (serHeader.pixelDepth != pixelDepth))
+			{
+				printf("%-8s Header does not match\r\n", formatName);
+				testOK	=	false;
+			}
+			if (serHeader.frameCount != frameCnt)
+			{
+				printf("%-8s Frame count is %d, expected %d\r\n", formatName, serHeader.frameCount, frameCnt);
+				testOK	=	false;
+			}
+		}
+		else
+		{
+			printf("%-8s Failed to read the header\r\n", formatName);
+			testOK	=	false;
+		}
+	}
+
+	if (testOK)
+	{
+		stampCnt	=	SERfile_ReadTimeStamps(filePath, &serHeader, timeStamps, frameCnt);
+		if (stampCnt != frameCnt)
+		{
+			printf("%-8s Read %d time stamps, expected %d\r\n", formatName, stampCnt, frameCnt);
+			testOK	=	false;
+		}
+		checkTime.tv_sec	=	1760600000;
+		checkTime.tv_usec	=	123456;
+		for (iii=0; (iii<stampCnt) && testOK; iii++)
+		{
+			SERfile_TicksToTimeVal(timeStamps[iii], &frameTime);
+			if ((frameTime.tv_sec != checkTime.tv_sec) || (frameTime.tv_usec != checkTime.tv_usec))
+			{
+				printf("%-8s Time stamp %d is wrong\r\n", formatName, iii);
+				testOK	=	false;
+			}
+			checkTime.tv_usec	+=	10000;
+			checkTime.tv_sec	+=	checkTime.tv_usec / 1000000;
+			checkTime.tv_usec	=	checkTime.tv_usec % 1000000;
+		}
+		if (testOK && (serHeader.dateTime_UTC != timeStamps[0]))
+		{
+			printf("%-8s Header UTC time is not the first frame time\r\n", formatName);
+			testOK	=	false;
+		}
+	}
+
+	if (testOK)
+	{
+		checkFrames[0]	=	0;
+		checkFrames[1]	=	frameCnt / 2;
+		checkFrames[2]	=	frameCnt - 1;
+		for (iii=0; (iii<3) && testOK; iii++)
+		{
+			FillFrame(frameData, frameSize, checkFrames[iii]);
+			if ((SERfile_ReadFrame(filePath, &serHeader, checkFrames[iii], readData) == false) ||
+				(memcmp(frameData, readData, frameSize) != 0))
+			{
+				printf("%-8s Frame %d does not match\r\n", formatName, checkFrames[iii]);
+				testOK	=	false;
+			}
+		}
+	}
+
+	if (testOK)
+	{
+		printf("%-8s OK  %5d frames  %8.1f frames/sec  %8.1f MB/sec\r\n",
+												formatName,
+												frameCnt,
+												(frameCnt / elapsedSecs),
+												((frameSize * (double)frameCnt) / elapsedSecs) / (1024.0 * 1024.0));
+	}
+	unlink(filePath);
+
+	free(frameData);
+	free(readData);
+	free(timeStamps);
+	return(testOK);
+}
+
+//*****************************************************************************
+int	main(int argc, char *argv[])
+{
+int			width;
+int			height;
+int			frameCnt;
+const char	*filePath;
+int			iii;
+bool		allOK;
+
+	width		=	640;
+	height		=	480;
+	frameCnt	=	500;
+	filePath	=	"/tmp/serfiletest.ser";
+
+	for (iii=1; iii<(argc - 1); iii++)
+	{
+		if (strcmp(argv[iii], "-w") == 0)
+		{
+			width		=	atoi(argv[++iii]);
+		}
+		else if (strcmp(argv[iii], "-h") == 0)
+		{
+			height		=	atoi(argv[++iii]);
+		}
+		else if (strcmp(argv[iii], "-n") == 0)
+		{
+			frameCnt	=	atoi(argv[++iii]);
+		}
+		else if (strcmp(argv[iii], "-f") == 0)
+		{
+			filePath	=	argv[++iii];
+		}
+	}
+	if ((width < 2) || (height < 2) || (frameCnt < 3))
+	{
+		printf("Invalid size\r\n");
+		return(1);
+	}
+	printf("%d x %d, %d frames, %s\r\n", width, height, frameCnt, filePath);
+
+	allOK	=	true;
+	allOK	&=	TestFormat(filePath, "mono8",	width, height, kSER_Mono,		8,	frameCnt);
+	allOK	&=	TestFormat(filePath, "bayer16",	width, height, kSER_BayerRGGB,	16,	frameCnt);
+	allOK	&=	TestFormat(filePath, "bgr24",	width, height, kSER_BGR,		8,	frameCnt);
+
+	printf("%s\r\n", (allOK ? "All tests passed" : "FAILED"));
+	return(allOK ? 0 : 1);
+}
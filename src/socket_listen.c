@@ -26,16 +26,50 @@
 //*	Feb 10,	2021	<MLS> Reduced timeout to 2500 (micro-secs)
 //*	Dec  3,	2022	<MLS> Added ipAddressString to SendDataToSocket()
 //*	Jan  8,	2024	<MLS> Added _SHOW_HTTP_DATA_
+//*	Oct 16,	2026	<MLS> Switched to epoll based listener with a pool of worker threads
+//*	Oct 16,	2026	<MLS> Increased listen backlog from 5 to kListenBacklog
+//*	Oct 16,	2026	<MLS> Added SocketListen_SetWorkerCount() & SocketListen_GetStats()
+//*	Oct 16,	2026	<MLS> Added RequestReader_ReadRequest(), reads until end of header + Content-Length
+//*	Oct 16,	2026	<MLS> Request buffer grows as needed, no more 2K limit
+//*	Oct 16,	2026	<MLS> Added HTTP/1.1 keep-alive and pipelined requests
+//*	Oct 16,	2026	<MLS> Added SocketListen_StartFramedResponse() & SocketListen_UnframedResponse()
+//*	Oct 16,	2026	<MLS> Removed FixEscapedChars(), parameters are now decoded by the request parser
+//*	Oct 17,	2026	<MLS> Added SocketListen_DetachSocket(), a worker can hand a socket off to a stream
+//*	Oct 17,	2026	<MLS> Keep-alive now uses the version token from the request line, bare LF requests work
+//*	Oct 17,	2026	<MLS> Added SocketListen_SendAll(), one send loop for the binary and streaming writers
+//*****************************************************************************
+//*	Threading model
+//*		SocketListen_Poll() is called in a loop by the listen thread.
+//*		It waits on epoll for the listening socket to become readable, accepts
+//*		every pending connection and puts it in a bounded queue.
+//*		A pool of worker threads takes connections off the queue and runs
+//*		the read/callback sequence (ProcessConnection()).
+//*		When the queue is full, the listen thread stops accepting, the rest
+//*		of the connections wait in the kernel accept queue.
+//*
+//*	Keep-alive
+//*		After a response, the connection is kept open only if the client asked
+//*		for it (HTTP/1.1 or "Connection: keep-alive") AND the response was sent
+//*		with a Content-Length by one of the writers that call
+//*		SocketListen_StartFramedResponse(). Anything else still closes the
+//*		connection, exactly as HTTP/1.0 did.
+//*		Idle connections are put back into epoll (EPOLLONESHOT) and go back
+//*		in the worker queue when the next request arrives.
+//*		Requests already in the buffer (pipelined) are processed in order
+//*		by the same worker.
+//*
+//*	Detached sockets
+//*		A response that never ends (the camera MJPEG stream) calls
+//*		SocketListen_DetachSocket(), the socket then belongs to the caller.
+//*		The worker frees the connection without closing the socket and goes
+//*		back to the queue instead of being tied up for as long as the stream lasts.
 //*****************************************************************************
 
 #define	_SHOW_HTTP_DATA_
 
-#ifdef _ALPACA_PI_
-	#define	_FIX_ESCAPE_CHARS_
-#endif // _ALPACA_PI_
-
 //*****************************************************************************
 #include	<stdlib.h>
+#include	<stdbool.h>
 #include	<string.h>
 #include	<strings.h>
 #include	<unistd.h>
@@ -45,6 +79,12 @@
 #include	<sys/socket.h>
 #include	<netinet/in.h>
 #include	<arpa/inet.h>
+#include	<netinet/tcp.h>
+#include	<fcntl.h>
+#include	<pthread.h>
+#include	<sys/epoll.h>
+#include	<poll.h>
+#include	<time.h>
 
 
 #ifdef _BANDWIDTH_
@@ -58,13 +98,85 @@
 
 #define		kTimeOut_MicroSecs	2500		//*	Allow 0.5 seconds so POST bodies arrive before timeout
 
+#define		kListenBacklog		SOMAXCONN	//*	was 5, way too small when a big download is in progress
+#define		kMaxEpollEvents		16
+#define		kEpollTimeOut_ms	1000
+#define		kConnectionQueueLen	64
+
+#define		kKeepAliveIdleTimeOut_secs	15		//*	close keep-alive connections idle this long
+#define		kMaxRequestsPerConnection	1000
+#define		kMaxIdleConnections			256
+
 SocketData_Callback			gSocketCallbackProcPtr		=	NULL;
 
 //*****************************************************************************
 //*	globals so we can make this code non-blocking
-static	int		gSocketFD;		//*	socket File Descriptor
+static	int		gSocketFD			=	-1;		//*	socket File Descriptor
+static	int		gEpollFD			=	-1;
 
-void SendDataToSocket(const int sock, const char *ipAddressString);
+//*****************************************************************************
+//*	HTTP request framing
+//*		read until we have the complete header (blank line) and then
+//*		Content-Length bytes of body. No more waiting for read() to time out.
+//*****************************************************************************
+typedef struct
+{
+	char	*buffer;
+	int		bufferSize;
+	int		bytesInBuffer;
+	int		headerLen;			//*	0 until the end of header has been found
+	int		contentLength;
+	bool	expectContinue;		//*	client sent "Expect: 100-continue"
+	bool	continueSent;		//*	"100 Continue" has been sent
+	bool	clientKeepAlive;	//*	HTTP/1.1 or "Connection: keep-alive" and no "Connection: close"
+} TYPE_RequestReader;
+
+//*****************************************************************************
+enum
+{
+	kResponse_None	=	0,
+	kResponse_Framed,			//*	HTTP/1.1 with Content-Length, connection can be reused
+	kResponse_Unframed,			//*	connection has to be closed to end the response
+	kResponse_Detached			//*	the socket was handed off, it is not ours to close
+};
+
+//*****************************************************************************
+typedef struct TYPE_Connection
+{
+	int						socketFD;
+	char					ipAddrString[INET_ADDRSTRLEN + 2];
+	TYPE_RequestReader		reader;
+	int						requestCnt;
+	bool					inEpoll;
+	bool					keepAliveAllowed;	//*	for the request being processed
+	int						responseState;		//*	for the request being processed
+	time_t					lastActivity;
+	struct TYPE_Connection	*nextIdle;
+	struct TYPE_Connection	*prevIdle;
+} TYPE_Connection;
+
+//*	connections waiting for a worker thread
+static	TYPE_Connection			*gConnectionQueue[kConnectionQueueLen];
+static	int						gQueueHead			=	0;		//*	next one to be taken by a worker
+static	int						gQueueCount			=	0;
+static	pthread_mutex_t			gQueueMutex			=	PTHREAD_MUTEX_INITIALIZER;
+static	pthread_cond_t			gQueueNotEmpty		=	PTHREAD_COND_INITIALIZER;
+static	pthread_cond_t			gQueueNotFull		=	PTHREAD_COND_INITIALIZER;
+
+static	int						gWorkerThreadCnt	=	kSocketListen_DefaultWorkers;
+static	pthread_t				gWorkerThreadIDs[kSocketListen_MaxWorkers];
+
+//*	statistics, protected by gQueueMutex
+static	TYPE_SocketListenStats	gListenStats;
+
+//*	keep-alive connections waiting in epoll for the next request, protected by gQueueMutex
+static	TYPE_Connection			*gIdleListHead		=	NULL;
+static	int						gIdleCnt			=	0;
+
+//*	the connection being processed by this worker thread
+static	__thread TYPE_Connection	*gCurrentConnection	=	NULL;
+
+static void	*SocketListen_WorkerThread(void *arg);
 
 
 //*****************************************************************************
@@ -74,6 +186,21 @@ static void error(char *msg)
 	exit(1);
 }
 
+//*****************************************************************************
+//*	must be called before SocketListen_Init()
+//*****************************************************************************
+void	SocketListen_SetWorkerCount(const int workerCount)
+{
+	gWorkerThreadCnt	=	workerCount;
+	if (gWorkerThreadCnt < 1)
+	{
+		gWorkerThreadCnt	=	1;
+	}
+	if (gWorkerThreadCnt > kSocketListen_MaxWorkers)
+	{
+		gWorkerThreadCnt	=	kSocketListen_MaxWorkers;
+	}
+}
 
 //*****************************************************************************
 int SocketListen_Init(const int listenPortNum)
@@ -82,10 +209,16 @@ int					bindRetCode;
 int					listenRetCode;
 int					socketOption;
 int					setOptRetCode;
+int					fileFlags;
+int					threadErr;
+int					iii;
 struct	sockaddr_in serv_addr;
+struct epoll_event	epollEvent;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 
+	memset(&gListenStats, 0, sizeof(TYPE_SocketListenStats));
+
 	gSocketFD	=	socket(AF_INET, SOCK_STREAM, 0);
 	if (gSocketFD < 0)
 	{
@@ -121,7 +254,44 @@ struct	sockaddr_in serv_addr;
 		CONSOLE_DEBUG(__FUNCTION__);
 		error("ERROR on binding");
 	}
-	listenRetCode	=	listen(gSocketFD, 5);
+	listenRetCode	=	listen(gSocketFD, kListenBacklog);
+
+	//*	the listen socket is non-blocking so that we can drain the accept queue
+	fileFlags	=	fcntl(gSocketFD, F_GETFL, 0);
+	fcntl(gSocketFD, F_SETFL, (fileFlags | O_NONBLOCK));
+
+	gEpollFD	=	epoll_create1(0);
+	if (gEpollFD < 0)
+	{
+		error("ERROR on epoll_create1");
+	}
+	memset(&epollEvent, 0, sizeof(struct epoll_event));
+	epollEvent.events	=	EPOLLIN;
+	epollEvent.data.ptr	=	NULL;		//*	NULL means the listen socket, otherwise TYPE_Connection
+	if (epoll_ctl(gEpollFD, EPOLL_CTL_ADD, gSocketFD, &epollEvent) < 0)
+	{
+		error("ERROR on epoll_ctl");
+	}
+
+	//*	now start the worker threads
+	gListenStats.WorkerThreadCnt	=	0;
+	for (iii=0; iii<gWorkerThreadCnt; iii++)
+	{
+		threadErr	=	pthread_create(&gWorkerThreadIDs[iii], NULL, &SocketListen_WorkerThread, NULL);
+		if (threadErr == 0)
+		{
+			gListenStats.WorkerThreadCnt++;
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("Error creating worker thread, err=", threadErr);
+		}
+	}
+	if (gListenStats.WorkerThreadCnt == 0)
+	{
+		error("ERROR no worker threads");
+	}
+	CONSOLE_DEBUG_W_NUM("Worker threads\t=", gListenStats.WorkerThreadCnt);
 
 	return(listenRetCode);
 }
@@ -134,125 +304,352 @@ void	SocketListen_SetCallback(SocketData_Callback callBackPtr)
 	gSocketCallbackProcPtr	=	callBackPtr;
 }
 
+//*****************************************************************************
+//*	get the kernel accept queue length of the listening socket
+//*	for a socket in the LISTEN state, tcpi_unacked is the current accept queue
+//*	length and tcpi_sacked is the backlog
+//*****************************************************************************
+static void	UpdateAcceptQueueStats(void)
+{
+struct tcp_info	tcpInfo;
+socklen_t		tcpInfoLen;
 
+	memset(&tcpInfo, 0, sizeof(struct tcp_info));
+	tcpInfoLen	=	sizeof(struct tcp_info);
+	if (getsockopt(gSocketFD, IPPROTO_TCP, TCP_INFO, &tcpInfo, &tcpInfoLen) == 0)
+	{
+		pthread_mutex_lock(&gQueueMutex);
+		gListenStats.AcceptQueueDepth		=	tcpInfo.tcpi_unacked;
+		gListenStats.AcceptQueueBacklog		=	tcpInfo.tcpi_sacked;
+		if (gListenStats.AcceptQueueDepth > gListenStats.AcceptQueueDepth_Max)
+		{
+			gListenStats.AcceptQueueDepth_Max	=	gListenStats.AcceptQueueDepth;
+		}
+		pthread_mutex_unlock(&gQueueMutex);
+	}
+}
 
+//*****************************************************************************
+//*	called with gQueueMutex locked
+//*****************************************************************************
+static void	ConnectionQueue_Add(TYPE_Connection *connection)
+{
+int		queueTail;
+
+	queueTail					=	(gQueueHead + gQueueCount) % kConnectionQueueLen;
+	gConnectionQueue[queueTail]	=	connection;
+	gQueueCount++;
+	gListenStats.QueueDepth		=	gQueueCount;
+	if (gQueueCount > gListenStats.QueueDepth_Max)
+	{
+		gListenStats.QueueDepth_Max	=	gQueueCount;
+	}
+	pthread_cond_signal(&gQueueNotEmpty);
+}
 
 //*****************************************************************************
-int SocketListen_Poll(void)
+//*	wait for room in the queue, leave the rest in the kernel accept queue
+//*	returns with gQueueMutex locked
+//*****************************************************************************
+static void	ConnectionQueue_WaitForRoom(void)
+{
+	pthread_mutex_lock(&gQueueMutex);
+	while (gQueueCount >= kConnectionQueueLen)
+	{
+		gListenStats.QueueFullCnt++;
+		pthread_cond_wait(&gQueueNotFull, &gQueueMutex);
+	}
+}
+
+//*****************************************************************************
+//*	called with gQueueMutex locked
+//*****************************************************************************
+static void	IdleList_Remove(TYPE_Connection *connection)
+{
+	if (connection->prevIdle != NULL)
+	{
+		connection->prevIdle->nextIdle	=	connection->nextIdle;
+	}
+	else
+	{
+		gIdleListHead	=	connection->nextIdle;
+	}
+	if (connection->nextIdle != NULL)
+	{
+		connection->nextIdle->prevIdle	=	connection->prevIdle;
+	}
+	connection->nextIdle	=	NULL;
+	connection->prevIdle	=	NULL;
+	gIdleCnt--;
+}
+
+//*****************************************************************************
+static void	Connection_Close(TYPE_Connection *connection)
+{
+int		closeRetCode;
+int		shutDownRetCode;
+
+	if (connection->responseState != kResponse_Detached)
+	{
+		shutDownRetCode	=	shutdown(connection->socketFD, SHUT_RDWR);
+		if ((shutDownRetCode != 0) && (errno != ENOTCONN))
+		{
+			CONSOLE_DEBUG_W_NUM("shutDownRetCode\t=", shutDownRetCode);
+			CONSOLE_DEBUG_W_NUM("errno\t=", errno);
+		}
+		//*	close() also removes it from epoll
+		closeRetCode	=	close(connection->socketFD);
+		if (closeRetCode != 0)
+		{
+			CONSOLE_DEBUG_W_NUM("Error closing socket\t=",	closeRetCode);
+			CONSOLE_DEBUG_W_NUM("errno\t=", errno);
+		}
+	}
+	if (connection->reader.buffer != NULL)
+	{
+		free(connection->reader.buffer);
+	}
+	free(connection);
+
+	pthread_mutex_lock(&gQueueMutex);
+	gListenStats.ConnectionsCompleted++;
+	pthread_mutex_unlock(&gQueueMutex);
+}
+
+//*****************************************************************************
+//*	put a keep-alive connection back in epoll to wait for the next request
+//*	returns false if it could not be done, the connection has to be closed
+//*****************************************************************************
+static bool	Connection_WaitForNextRequest(TYPE_Connection *connection)
+{
+struct epoll_event	epollEvent;
+int					epollRetCode;
+bool				waiting;
+
+	waiting	=	false;
+	memset(&epollEvent, 0, sizeof(struct epoll_event));
+	epollEvent.events	=	EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+	epollEvent.data.ptr	=	connection;
+
+	pthread_mutex_lock(&gQueueMutex);
+	if (gIdleCnt < kMaxIdleConnections)
+	{
+		//*	it has to be in the idle list before epoll can report it
+		connection->lastActivity	=	time(NULL);
+		connection->prevIdle		=	NULL;
+		connection->nextIdle		=	gIdleListHead;
+		if (gIdleListHead != NULL)
+		{
+			gIdleListHead->prevIdle	=	connection;
+		}
+		gIdleListHead	=	connection;
+		gIdleCnt++;
+
+		epollRetCode	=	epoll_ctl(	gEpollFD,
+										(connection->inEpoll ? EPOLL_CTL_MOD : EPOLL_CTL_ADD),
+										connection->socketFD,
+										&epollEvent);
+		if (epollRetCode == 0)
+		{
+			connection->inEpoll		=	true;
+			waiting					=	true;
+			gListenStats.IdleConnections	=	gIdleCnt;
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("epoll_ctl() failed, errno\t=", errno);
+			IdleList_Remove(connection);
+		}
+	}
+	pthread_mutex_unlock(&gQueueMutex);
+	return(waiting);
+}
+
+//*****************************************************************************
+//*	a keep-alive connection has a new request (or was closed by the client)
+//*****************************************************************************
+static void	Connection_Ready(TYPE_Connection *connection)
+{
+	ConnectionQueue_WaitForRoom();
+	IdleList_Remove(connection);
+	gListenStats.IdleConnections	=	gIdleCnt;
+	ConnectionQueue_Add(connection);
+	pthread_mutex_unlock(&gQueueMutex);
+}
+
+//*****************************************************************************
+//*	close keep-alive connections that have been idle too long
+//*	only called from the listen thread, so no epoll event can be processed
+//*	for these connections at the same time
+//*****************************************************************************
+static void	CloseIdleConnections(void)
+{
+TYPE_Connection	*connection;
+TYPE_Connection	*nextConnection;
+TYPE_Connection	*closeList;
+time_t			currentTime;
+
+	currentTime	=	time(NULL);
+	closeList	=	NULL;
+	pthread_mutex_lock(&gQueueMutex);
+	connection	=	gIdleListHead;
+	while (connection != NULL)
+	{
+		nextConnection	=	connection->nextIdle;
+		if ((currentTime - connection->lastActivity) >= kKeepAliveIdleTimeOut_secs)
+		{
+			IdleList_Remove(connection);
+			epoll_ctl(gEpollFD, EPOLL_CTL_DEL, connection->socketFD, NULL);
+			connection->nextIdle	=	closeList;
+			closeList				=	connection;
+			gListenStats.IdleTimeOutCnt++;
+		}
+		connection	=	nextConnection;
+	}
+	gListenStats.IdleConnections	=	gIdleCnt;
+	pthread_mutex_unlock(&gQueueMutex);
+
+	while (closeList != NULL)
+	{
+		nextConnection	=	closeList->nextIdle;
+		Connection_Close(closeList);
+		closeList		=	nextConnection;
+	}
+}
+
+//*****************************************************************************
+//*	returns TRUE if the connection was put in the queue
+//*****************************************************************************
+static bool	AcceptOneConnection(void)
 {
 int					newsockfd;
-unsigned int		clilen;
+socklen_t			clilen;
 struct	sockaddr_in	client_addr;
-int					closeRetCode;
-int					shutDownRetCode;
-char				ipAddrString[64];
+TYPE_Connection		*newConnection;
+bool				connectionQueued;
+
+	connectionQueued	=	false;
 
 	//*	Started getting EINVAL (Invalid argument) errors on accept
 	//*	fixed the problem by cleared args first
 	memset(&client_addr, 0, sizeof(struct	sockaddr_in));
 
 	clilen		=	sizeof(client_addr);
+	ConnectionQueue_WaitForRoom();
+	pthread_mutex_unlock(&gQueueMutex);
 	newsockfd	=	accept(gSocketFD, (struct sockaddr *) &client_addr, &clilen);
-
-	inet_ntop(AF_INET, &(client_addr.sin_addr), ipAddrString, INET_ADDRSTRLEN);
-#ifdef _SHOW_HTTP_DATA_
-	CONSOLE_DEBUG_W_STR("Accepted from ", ipAddrString);
-#endif // _SHOW_HTTP_DATA_
 	if (newsockfd >= 0)
 	{
-		SendDataToSocket(newsockfd, ipAddrString);
-
-		shutDownRetCode	=	shutdown(newsockfd, SHUT_RDWR);
-		if (shutDownRetCode != 0)
+		newConnection	=	(TYPE_Connection *)calloc(1, sizeof(TYPE_Connection));
+		if (newConnection != NULL)
 		{
-			CONSOLE_DEBUG_W_NUM("shutDownRetCode\t=", shutDownRetCode);
-			CONSOLE_DEBUG_W_NUM("errno\t=", errno);
+			newConnection->socketFD	=	newsockfd;
+			inet_ntop(AF_INET, &(client_addr.sin_addr), newConnection->ipAddrString, INET_ADDRSTRLEN);
+		#ifdef _SHOW_HTTP_DATA_
+			CONSOLE_DEBUG_W_STR("Accepted from ", newConnection->ipAddrString);
+		#endif // _SHOW_HTTP_DATA_
+			pthread_mutex_lock(&gQueueMutex);
+			gListenStats.ConnectionsAccepted++;
+			ConnectionQueue_Add(newConnection);
+			pthread_mutex_unlock(&gQueueMutex);
+			connectionQueued	=	true;
 		}
-		closeRetCode	=	close(newsockfd);
-		if (closeRetCode != 0)
+		else
 		{
-			CONSOLE_DEBUG_W_NUM("Error closing socket\t=",	closeRetCode);
-			CONSOLE_DEBUG_W_NUM("errno\t=", errno);
+			CONSOLE_DEBUG("Failed to allocate connection");
+			close(newsockfd);
 		}
 	}
-	else if (newsockfd < 0)
+	else if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) && (errno != ECONNABORTED))
 	{
 		CONSOLE_DEBUG(__FUNCTION__);
 		CONSOLE_DEBUG_W_NUM("gSocketFD\t=", gSocketFD);
 		CONSOLE_DEBUG_W_NUM("newsockfd\t=", newsockfd);
 		CONSOLE_DEBUG_W_NUM("errno\t=", errno);
-		error("ERROR on accept");
+		if ((errno != EMFILE) && (errno != ENFILE) && (errno != ENOBUFS) && (errno != ENOMEM))
+		{
+			error("ERROR on accept");
+		}
+		pthread_mutex_lock(&gQueueMutex);
+		gListenStats.AcceptErrors++;
+		pthread_mutex_unlock(&gQueueMutex);
+		//*	out of resources, give the workers a chance to close some
+		usleep(10000);
 	}
-
-	return 0;
+	return(connectionQueued);
 }
 
-#ifdef _FIX_ESCAPE_CHARS_
 //*****************************************************************************
-static int	FixEscapedChars(char *buffer)
+//*	Waits for incoming connections and requests on keep-alive connections
+//*	and hands them to the worker threads
+//*	returns the number of connections accepted
+//*****************************************************************************
+int SocketListen_Poll(void)
 {
-int		cc;
-int		ii;
-int		sLen;
-char	hi4bits;
-char	lo4bits;
-int		escCharCnt;
+struct epoll_event	epollEvents[kMaxEpollEvents];
+int					eventCnt;
+int					acceptedCnt;
+int					iii;
 
-//	CONSOLE_DEBUG("---------------------------------------------------------");
-//	CONSOLE_DEBUG_W_STR("buffer\t=", buffer);
-	ii			=	0;
-	cc			=	0;
-	escCharCnt	=	0;
-	sLen		=	strlen(buffer);
-	while (ii<sLen)
+	acceptedCnt	=	0;
+	eventCnt	=	epoll_wait(gEpollFD, epollEvents, kMaxEpollEvents, kEpollTimeOut_ms);
+	if (eventCnt > 0)
 	{
-		if (buffer[ii] == '%')
+		for (iii=0; iii<eventCnt; iii++)
 		{
-			ii++;
-			hi4bits			=	(buffer[ii++] & 0x0f) << 4;
-			lo4bits			=	buffer[ii++];
-			if (lo4bits >= 'A')
+			if (epollEvents[iii].data.ptr == NULL)
 			{
-				lo4bits	=	9 + (lo4bits & 0x0f);
+				//*	record the kernel queue depth before we drain it
+				UpdateAcceptQueueStats();
+				while (AcceptOneConnection())
+				{
+					acceptedCnt++;
+				}
 			}
 			else
 			{
-				lo4bits	=	lo4bits & 0x0f;
+				Connection_Ready((TYPE_Connection *)epollEvents[iii].data.ptr);
 			}
-			buffer[cc++]	=	hi4bits + lo4bits;
-
-			escCharCnt++;
 		}
-		else
+	}
+	else if ((eventCnt < 0) && (errno != EINTR))
+	{
+		CONSOLE_DEBUG_W_NUM("epoll_wait() errno\t=", errno);
+	}
+	CloseIdleConnections();
+	return(acceptedCnt);
+}
+
+//*****************************************************************************
+void	SocketListen_GetStats(TYPE_SocketListenStats *listenStats)
+{
+	if (listenStats != NULL)
+	{
+		if (gSocketFD >= 0)
 		{
-			buffer[cc++]	=	buffer[ii++];
+			UpdateAcceptQueueStats();
 		}
+		pthread_mutex_lock(&gQueueMutex);
+		gListenStats.QueueDepth	=	gQueueCount;
+		*listenStats			=	gListenStats;
+		pthread_mutex_unlock(&gQueueMutex);
 	}
-	buffer[cc]	=	0;
-
-	sLen	=	strlen(buffer);
-
-//	if (escCharCnt > 0)
-//	{
-//	//	printf("%s\tescCharCnt=%d\r\n", __FUNCTION__, escCharCnt);
-//		CONSOLE_DEBUG_W_STR("buffer\t=", buffer);
-//		CONSOLE_DEBUG_W_NUM("escCharCnt\t=", escCharCnt);
-//	}
-	return(sLen);
 }
-#endif // _FIX_ESCAPE_CHARS_
-
 
 int	gMessageCnt	=	1;
 
-#define	kReadBuffLen	2048
-#define	kMaxResponseLen	2048
+#define	kInitialRequestBufLen	4096
+#define	kReadChunkLen			1024
+#define	kMaxRequestLen			(256 * 1024)
+#define	kRequestTimeOut_ms		1500		//*	max time to receive the complete request
 
 #ifdef _BANDWIDTH_
 
 #warning "_BANDWIDTH_ is defined"
 #error "_BANDWIDTH_ is defined"
 
+#define	kReadBuffLen	2048
+
 //*****************************************************************************
 //*	SendDataToSocket()
 //*		There is a separate instance of this function
@@ -304,72 +701,509 @@ int				setOptRetCode;
 #else
 
 //*****************************************************************************
-//*	SendDataToSocket()
-//*		There is a separate instance of this function
-//*		for each connection.  It handles all communication
-//*		once a connection has been established.
+static bool	RequestReader_Init(TYPE_RequestReader *reader)
+{
+	memset(reader, 0, sizeof(TYPE_RequestReader));
+	reader->buffer	=	(char *)malloc(kInitialRequestBufLen);
+	if (reader->buffer != NULL)
+	{
+		reader->bufferSize	=	kInitialRequestBufLen;
+		reader->buffer[0]	=	0;
+	}
+	return(reader->buffer != NULL);
+}
+
 //*****************************************************************************
-void SendDataToSocket(const int sock, const char *ipAddressString)
+//*	remove the request that has been processed, keep anything after it
+//*	(the next pipelined request)
+//*****************************************************************************
+static void	RequestReader_Consume(TYPE_RequestReader *reader, const int requestLen)
 {
-int				bytesRead;
-//int			bytesWritten;
-//int			resultsMsgLen;
-char			readBuffer[kReadBuffLen];
-char			htmlBuffer[kReadBuffLen];
-struct timeval	timeoutLength;
-int				setOptRetCode;
+int		bytesLeft;
 
-//	CONSOLE_DEBUG(__FUNCTION__);
+	bytesLeft	=	reader->bytesInBuffer - requestLen;
+	if (bytesLeft > 0)
+	{
+		memmove(reader->buffer, &reader->buffer[requestLen], bytesLeft);
+	}
+	else
+	{
+		bytesLeft	=	0;
+	}
+	reader->bytesInBuffer			=	bytesLeft;
+	reader->buffer[bytesLeft]		=	0;
+	reader->headerLen				=	0;
+	reader->contentLength			=	0;
+	reader->expectContinue			=	false;
+	reader->continueSent			=	false;
+	reader->clientKeepAlive			=	false;
+}
 
-	memset(readBuffer, 0, kReadBuffLen);
-	//*	3/31/2020, trying to see if we are missing anything
-	memset(htmlBuffer, 0, kReadBuffLen);
-	//*	set a timeout
-	timeoutLength.tv_sec	=	0;
-	timeoutLength.tv_usec	=	kTimeOut_MicroSecs;
-	setOptRetCode			=	setsockopt(	sock,
-											SOL_SOCKET,
-											SO_RCVTIMEO,
-											&timeoutLength,
-											sizeof(timeoutLength));
-	if (setOptRetCode != 0)
+//*****************************************************************************
+//*	make sure there is room for at least kReadChunkLen more bytes
+//*****************************************************************************
+static bool	RequestReader_MakeRoom(TYPE_RequestReader *reader)
+{
+char	*newBuffer;
+int		newSize;
+bool	roomOK;
+
+	roomOK	=	true;
+	if ((reader->bufferSize - reader->bytesInBuffer) < kReadChunkLen)
 	{
-		CONSOLE_DEBUG_W_NUM("setsockopt() returned", setOptRetCode);
+		newSize	=	reader->bufferSize * 2;
+		if (newSize <= kMaxRequestLen)
+		{
+			newBuffer	=	(char *)realloc(reader->buffer, newSize);
+			if (newBuffer != NULL)
+			{
+				reader->buffer		=	newBuffer;
+				reader->bufferSize	=	newSize;
+			}
+			else
+			{
+				roomOK	=	false;
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("Request too long, bytes\t=", reader->bytesInBuffer);
+			roomOK	=	false;
+		}
 	}
+	return(roomOK);
+}
 
-	do
+//*****************************************************************************
+//*	the version is the token after the LAST space on the request line,
+//*	the same way TokenizeRequest() finds it, the line can end in CR/LF or just LF
+//*	returns the offset of the version, *versionLen is 0 if there is not one
+//*****************************************************************************
+static int	RequestReader_FindVersion(const char *requestLine, const int dataLen, int *versionLen)
+{
+int		lineEnd;
+int		versionEnd;
+int		versionStart;
+
+	lineEnd	=	0;
+	while ((lineEnd < dataLen) && (requestLine[lineEnd] != 0x0d) && (requestLine[lineEnd] != 0x0a))
 	{
-		bytesRead	=	read(sock, readBuffer, (kReadBuffLen - 2));
-//		CONSOLE_DEBUG_W_NUM("bytesRead=", bytesRead);
-		if (bytesRead > 0)
+		lineEnd++;
+	}
+	versionEnd	=	lineEnd;
+	while ((versionEnd > 0) && (requestLine[versionEnd - 1] == 0x20))
+	{
+		versionEnd--;
+	}
+	versionStart	=	versionEnd;
+	while ((versionStart > 0) && (requestLine[versionStart - 1] != 0x20))
+	{
+		versionStart--;
+	}
+	*versionLen	=	0;
+	if ((versionStart > 0) && (strncmp(&requestLine[versionStart], "HTTP/", 5) == 0))
+	{
+		*versionLen	=	versionEnd - versionStart;
+	}
+	return(versionStart);
+}
+
+//*****************************************************************************
+//*	look for the end of the header, once found get the Content-Length
+//*	returns the total length of the request if it is complete, else 0
+//*****************************************************************************
+static int	RequestReader_CheckComplete(TYPE_RequestReader *reader)
+{
+char	*endOfHdrPtr;
+char	*linePtr;
+int		requestLen;
+int		versionOffset;
+int		versionLen;
+
+	requestLen	=	0;
+	if (reader->headerLen == 0)
+	{
+		endOfHdrPtr	=	strstr(reader->buffer, "\r\n\r\n");
+		if (endOfHdrPtr != NULL)
 		{
-			readBuffer[bytesRead]	=	0;
-			strcat(htmlBuffer, readBuffer);
+			reader->headerLen	=	(endOfHdrPtr - reader->buffer) + 4;
 		}
-		else if (bytesRead < 0)
+		else
 		{
-		//	error("ERROR reading from socket");
+			//*	some clients only send line feeds
+			endOfHdrPtr	=	strstr(reader->buffer, "\n\n");
+			if (endOfHdrPtr != NULL)
+			{
+				reader->headerLen	=	(endOfHdrPtr - reader->buffer) + 2;
+			}
 		}
-	} while (bytesRead > 0);
+		if (reader->headerLen > 0)
+		{
+			//*	HTTP/1.1 defaults to keep-alive, HTTP/1.0 has to ask for it
+			versionOffset			=	RequestReader_FindVersion(reader->buffer, reader->headerLen, &versionLen);
+			reader->clientKeepAlive	=	((versionLen == 8) &&
+										(strncmp(&reader->buffer[versionOffset], "HTTP/1.1", 8) == 0));
 
-#ifdef _FIX_ESCAPE_CHARS_
-//	CONSOLE_DEBUG_W_NUM("bytesRead=", bytesRead);
-	bytesRead	=	FixEscapedChars(htmlBuffer);
-#endif
-	if (gSocketCallbackProcPtr != NULL)
+			linePtr	=	strchr(reader->buffer, '\n');
+
+			//*	step through the header lines looking for Content-Length
+			reader->contentLength	=	0;
+			while ((linePtr != NULL) && ((linePtr - reader->buffer) < reader->headerLen))
+			{
+				linePtr++;
+				if (strncasecmp(linePtr, "Content-Length:", 15) == 0)
+				{
+					reader->contentLength	=	atoi(linePtr + 15);
+					if (reader->contentLength < 0)
+					{
+						reader->contentLength	=	0;
+					}
+				}
+				else if (strncasecmp(linePtr, "Expect: 100-continue", 20) == 0)
+				{
+					reader->expectContinue	=	true;
+				}
+				else if (strncasecmp(linePtr, "Connection: close", 17) == 0)
+				{
+					reader->clientKeepAlive	=	false;
+				}
+				else if (strncasecmp(linePtr, "Connection: keep-alive", 22) == 0)
+				{
+					reader->clientKeepAlive	=	true;
+				}
+				linePtr	=	strchr(linePtr, '\n');
+			}
+		}
+	}
+	if ((reader->headerLen > 0) && (reader->bytesInBuffer >= (reader->headerLen + reader->contentLength)))
 	{
-//		CONSOLE_DEBUG("Calling gSocketCallbackProcPtr");
-		gSocketCallbackProcPtr(sock, htmlBuffer, bytesRead, ipAddressString);
+		requestLen	=	reader->headerLen + reader->contentLength;
 	}
+	return(requestLen);
+}
 
-//	printf("Here is the message (%d bytes long):\r\n%s\r\n", bytesRead, readBuffer);
-#if 0
-	resultsMsgLen	=	strlen(returnBuffer);
-	bytesWritten	=	write(sock, returnBuffer, resultsMsgLen);
-#endif
+//*****************************************************************************
+//*	a client that sent "Expect: 100-continue" waits for us before sending the body
+//*****************************************************************************
+static void	RequestReader_CheckForContinue(const int sock, TYPE_RequestReader *reader)
+{
+char	continueMsg[]	=	"HTTP/1.1 100 Continue\r\n\r\n";
+
+	if (reader->expectContinue && (reader->continueSent == false))
+	{
+		reader->continueSent	=	true;
+		if (write(sock, continueMsg, strlen(continueMsg)) < 0)
+		{
+			CONSOLE_DEBUG_W_NUM("Failed to send 100 Continue, errno\t=", errno);
+		}
+	}
+}
 
+//*****************************************************************************
+//*	returns the length of the complete request in reader->buffer
+//*	if the client closes the connection or stops sending, whatever has
+//*	been received is returned (same as before)
+//*	returns 0 if nothing was received, -1 on error
+//*****************************************************************************
+static int	RequestReader_ReadRequest(const int sock, TYPE_RequestReader *reader)
+{
+struct pollfd	pollFD;
+struct timespec	startTime;
+struct timespec	currentTime;
+int				elapsed_ms;
+int				pollRetCode;
+int				bytesRead;
+int				requestLen;
+bool			keepReading;
+
+	requestLen	=	RequestReader_CheckComplete(reader);
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+	keepReading	=	(requestLen == 0);
+	while (keepReading)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &currentTime);
+		elapsed_ms	=	((currentTime.tv_sec - startTime.tv_sec) * 1000) +
+						((currentTime.tv_nsec - startTime.tv_nsec) / 1000000);
+		if (elapsed_ms >= kRequestTimeOut_ms)
+		{
+			//*	timed out, give them what we have
+			requestLen	=	reader->bytesInBuffer;
+			break;
+		}
+		pollFD.fd		=	sock;
+		pollFD.events	=	POLLIN;
+		pollFD.revents	=	0;
+		pollRetCode		=	poll(&pollFD, 1, (kRequestTimeOut_ms - elapsed_ms));
+		if (pollRetCode < 0)
+		{
+			if (errno != EINTR)
+			{
+				requestLen	=	(reader->bytesInBuffer > 0) ? reader->bytesInBuffer : -1;
+				keepReading	=	false;
+			}
+		}
+		else if (pollRetCode > 0)
+		{
+			if (RequestReader_MakeRoom(reader) == false)
+			{
+				requestLen	=	-1;
+				break;
+			}
+			bytesRead	=	read(sock,
+								&reader->buffer[reader->bytesInBuffer],
+								(reader->bufferSize - reader->bytesInBuffer - 1));
+			if (bytesRead > 0)
+			{
+				reader->bytesInBuffer					+=	bytesRead;
+				reader->buffer[reader->bytesInBuffer]	=	0;
+				requestLen								=	RequestReader_CheckComplete(reader);
+				if (requestLen > 0)
+				{
+					keepReading	=	false;
+				}
+				else
+				{
+					RequestReader_CheckForContinue(sock, reader);
+				}
+			}
+			else if (bytesRead == 0)
+			{
+				//*	the other end closed the connection
+				requestLen	=	reader->bytesInBuffer;
+				keepReading	=	false;
+			}
+			else if ((errno != EINTR) && (errno != EAGAIN))
+			{
+				requestLen	=	(reader->bytesInBuffer > 0) ? reader->bytesInBuffer : -1;
+				keepReading	=	false;
+			}
+		}
+	}
+	return(requestLen);
+}
+
+//*****************************************************************************
+//*	ProcessConnection()
+//*		Reads and processes requests from a connection.
+//*		Pipelined requests that are already in the buffer are processed in order.
+//*		returns true if the connection should be kept open for the next request
+//*****************************************************************************
+static bool	ProcessConnection(TYPE_Connection *connection)
+{
+TYPE_RequestReader	*reader;
+int					requestLen;
+long				bytesRead;
+char				savedChar;
+bool				keepAlive;
+bool				nextRequestReady;
+
+//	CONSOLE_DEBUG(__FUNCTION__);
+	keepAlive	=	false;
+	reader		=	&connection->reader;
+	if (reader->buffer == NULL)
+	{
+		if (RequestReader_Init(reader) == false)
+		{
+			CONSOLE_DEBUG("Failed to allocate request buffer");
+			return(false);
+		}
+	}
+	do
+	{
+		nextRequestReady	=	false;
+		requestLen			=	RequestReader_ReadRequest(connection->socketFD, reader);
+		if (requestLen <= 0)
+		{
+			keepAlive	=	false;
+			break;
+		}
+		connection->requestCnt++;
+		connection->keepAliveAllowed	=	(reader->clientKeepAlive &&
+											(reader->headerLen > 0) &&
+											(connection->requestCnt < kMaxRequestsPerConnection));
+		connection->responseState		=	kResponse_None;
+
+		pthread_mutex_lock(&gQueueMutex);
+		gListenStats.RequestsProcessed++;
+		if (connection->requestCnt > 1)
+		{
+			//*	a request that did not need a new connection
+			gListenStats.RequestsOnReusedConn++;
+		}
+		pthread_mutex_unlock(&gQueueMutex);
+
+		//*	the callback expects a null terminated string
+		savedChar					=	reader->buffer[requestLen];
+		reader->buffer[requestLen]	=	0;
+		bytesRead					=	requestLen;
+		if (gSocketCallbackProcPtr != NULL)
+		{
+			gCurrentConnection	=	connection;
+	//		CONSOLE_DEBUG("Calling gSocketCallbackProcPtr");
+			gSocketCallbackProcPtr(connection->socketFD, reader->buffer, bytesRead, connection->ipAddrString);
+			gCurrentConnection	=	NULL;
+		}
+		gMessageCnt++;
+		reader->buffer[requestLen]	=	savedChar;
+
+		keepAlive	=	(connection->keepAliveAllowed && (connection->responseState == kResponse_Framed));
+		RequestReader_Consume(reader, requestLen);
+		if (keepAlive && (reader->bytesInBuffer > 0))
+		{
+			nextRequestReady	=	(RequestReader_CheckComplete(reader) > 0);
+			if (nextRequestReady)
+			{
+				pthread_mutex_lock(&gQueueMutex);
+				gListenStats.PipelinedRequests++;
+				pthread_mutex_unlock(&gQueueMutex);
+			}
+		}
+	} while (nextRequestReady);
 
-	gMessageCnt++;
 //	CONSOLE_DEBUG("EXIT");
+	return(keepAlive);
+}
+
+//*****************************************************************************
+//*	Called by a response writer that is about to send a header with Content-Length.
+//*	returns true if the connection will be kept open after this response,
+//*	the writer should then use HTTP/1.1 and "Connection: keep-alive",
+//*	otherwise "Connection: close"
+//*****************************************************************************
+bool	SocketListen_StartFramedResponse(const int socketFD)
+{
+bool	keepAlive;
+
+	keepAlive	=	false;
+	if ((gCurrentConnection != NULL) && (gCurrentConnection->socketFD == socketFD))
+	{
+		if ((gCurrentConnection->responseState == kResponse_None) && gCurrentConnection->keepAliveAllowed)
+		{
+			gCurrentConnection->responseState	=	kResponse_Framed;
+			keepAlive							=	true;
+		}
+		else if (gCurrentConnection->responseState != kResponse_Detached)
+		{
+			gCurrentConnection->responseState	=	kResponse_Unframed;
+		}
+	}
+	return(keepAlive);
+}
+
+//*****************************************************************************
+//*	Called by a response writer that keeps the socket after the request is done.
+//*	The socket is taken out of epoll and will not be closed by the worker,
+//*	the caller is responsible for closing it.
+//*	returns false if the socket is not the one being processed by this thread
+//*****************************************************************************
+bool	SocketListen_DetachSocket(const int socketFD)
+{
+bool	detached;
+
+	detached	=	false;
+	if ((gCurrentConnection != NULL) && (gCurrentConnection->socketFD == socketFD))
+	{
+		if (gCurrentConnection->inEpoll)
+		{
+			epoll_ctl(gEpollFD, EPOLL_CTL_DEL, socketFD, NULL);
+			gCurrentConnection->inEpoll	=	false;
+		}
+		gCurrentConnection->responseState	=	kResponse_Detached;
+		detached							=	true;
+	}
+	return(detached);
+}
+
+//*****************************************************************************
+//*	Called by anything that writes to the socket without a Content-Length header
+//*	The connection will be closed at the end of the request
+//*****************************************************************************
+void	SocketListen_UnframedResponse(const int socketFD)
+{
+	if ((gCurrentConnection != NULL) &&
+		(gCurrentConnection->socketFD == socketFD) &&
+		(gCurrentConnection->responseState != kResponse_Detached))
+	{
+		gCurrentConnection->responseState	=	kResponse_Unframed;
+	}
+}
+
+//*****************************************************************************
+//*	keeps calling send() until it is all gone, for binary data and big buffers
+//*	SocketWriteData() is for null terminated text
+//*****************************************************************************
+bool	SocketListen_SendAll(const int socketFD, const void *dataPtr, size_t dataLen)
+{
+const char	*bytePtr;
+ssize_t		bytesWritten;
+bool		sendOK;
+
+	bytePtr	=	(const char *)dataPtr;
+	sendOK	=	true;
+	while (sendOK && (dataLen > 0))
+	{
+		bytesWritten	=	send(socketFD, bytePtr, dataLen, MSG_NOSIGNAL);
+		if (bytesWritten > 0)
+		{
+			bytePtr		+=	bytesWritten;
+			dataLen		-=	bytesWritten;
+		}
+		else if ((bytesWritten < 0) && (errno == EINTR))
+		{
+			//*	try again
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("Error writting to socket, errno\t=", errno);
+			sendOK	=	false;
+		}
+	}
+	return(sendOK);
 }
 #endif // _BANDWIDTH_
+
+//*****************************************************************************
+static void	*SocketListen_WorkerThread(void *arg)
+{
+TYPE_Connection	*myConnection;
+bool			keepAlive;
+
+	(void)arg;
+	while (1)
+	{
+		//*	wait for a connection to show up in the queue
+		pthread_mutex_lock(&gQueueMutex);
+		while (gQueueCount <= 0)
+		{
+			pthread_cond_wait(&gQueueNotEmpty, &gQueueMutex);
+		}
+		myConnection	=	gConnectionQueue[gQueueHead];
+		gQueueHead		=	(gQueueHead + 1) % kConnectionQueueLen;
+		gQueueCount--;
+		gListenStats.ConnectionsInFlight++;
+		if (gListenStats.ConnectionsInFlight > gListenStats.ConnectionsInFlight_Max)
+		{
+			gListenStats.ConnectionsInFlight_Max	=	gListenStats.ConnectionsInFlight;
+		}
+		pthread_cond_signal(&gQueueNotFull);
+		pthread_mutex_unlock(&gQueueMutex);
+
+		keepAlive	=	ProcessConnection(myConnection);
+		if (keepAlive)
+		{
+			keepAlive	=	Connection_WaitForNextRequest(myConnection);
+		}
+
+		pthread_mutex_lock(&gQueueMutex);
+		gListenStats.ConnectionsInFlight--;
+		pthread_mutex_unlock(&gQueueMutex);
+
+		//*	do not touch myConnection after it is back in epoll,
+		//*	another worker may already have it
+		if (keepAlive == false)
+		{
+			Connection_Close(myConnection);
+		}
+	}
+	return(NULL);
+}
@@ -9,6 +9,10 @@
 //*	<MLS>	=	Mark L Sproul
 //*****************************************************************************
 //*	Feb 14,	2019	<MLS> Created socket_listen.h
+//*	Oct 16,	2026	<MLS> Added TYPE_SocketListenStats and worker thread count
+//*	Oct 16,	2026	<MLS> Added keep-alive support and connection reuse statistics
+//*	Oct 17,	2026	<MLS> Added SocketListen_DetachSocket() for streaming responses
+//*	Oct 17,	2026	<MLS> Added SocketListen_SendAll()
 //*****************************************************************************
 
 
@@ -16,6 +20,42 @@
 #define	_SOCKET_LISTEN_H_
 
 
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#include	<stddef.h>
+
+#define	kSocketListen_DefaultWorkers	4
+#define	kSocketListen_MaxWorkers		32
+
+//*****************************************************************************
+typedef struct
+{
+	int			WorkerThreadCnt;
+	int			ConnectionsInFlight;		//*	being processed by a worker right now
+	int			ConnectionsInFlight_Max;
+	int			QueueDepth;					//*	accepted, waiting for a worker
+	int			QueueDepth_Max;
+	int			AcceptQueueDepth;			//*	kernel accept queue (not accepted yet)
+	int			AcceptQueueDepth_Max;
+	int			AcceptQueueBacklog;
+	uint32_t	ConnectionsAccepted;
+	uint32_t	ConnectionsCompleted;
+	uint32_t	QueueFullCnt;
+	uint32_t	AcceptErrors;
+	int			IdleConnections;			//*	keep-alive connections waiting for the next request
+	uint32_t	IdleTimeOutCnt;
+	uint32_t	RequestsProcessed;
+	uint32_t	RequestsOnReusedConn;		//*	each one saved a TCP handshake
+	uint32_t	PipelinedRequests;
+} TYPE_SocketListenStats;
+
+
 #ifdef __cplusplus
 	extern "C" {
 #endif
@@ -24,6 +64,18 @@ typedef	int (*SocketData_Callback)(int socket, char *htmlData, long bytesRead, c
 int		SocketListen_Init(const int listenPortNum);
 int		SocketListen_Poll(void);
 void	SocketListen_SetCallback(SocketData_Callback callBackPtr);
+void	SocketListen_SetWorkerCount(const int workerCount);
+void	SocketListen_GetStats(TYPE_SocketListenStats *listenStats);
+
+//*	used by the response writers for HTTP/1.1 keep-alive
+bool	SocketListen_StartFramedResponse(const int socketFD);
+void	SocketListen_UnframedResponse(const int socketFD);
+
+//*	the caller takes over the socket (and has to close it), used for streams that never end
+bool	SocketListen_DetachSocket(const int socketFD);
+
+//*	returns false if the socket failed before everything was sent
+bool	SocketListen_SendAll(const int socketFD, const void *dataPtr, size_t dataLen);
 
 #ifdef __cplusplus
 }
@@ -20,6 +20,7 @@
 //*****************************************************************************
 //*	Jun 19,	2023	<MLS> Created windowtab_DeviceState.cpp
 //*	Jun 24,	2023	<MLS> Added SetDeviceStateNotSupported()
+//*	Oct 17,	2026	<MLS> Added kDeviceState_PollStats for the background poll latency
 //*****************************************************************************
 
 
@@ -78,12 +79,20 @@ int		boxWidth;
 	valueLeft		=	nameLeft + nameWidth  + 2;
 	valueWidth		=	(cClmWidth * 4);
 	boxHeight		=	cSmallBtnHt + 2;
+	boxWidth		=	nameWidth + 2 + valueWidth;
+
+	//*	this is for readall as well, so it stays when device state is not supported
+	SetWidget(				kDeviceState_PollStats,	nameLeft,		yLoc,	boxWidth,	boxHeight);
+	SetWidgetFont(			kDeviceState_PollStats,	kFont_Medium);
+	SetWidgetJustification(	kDeviceState_PollStats,	kJustification_Center);
+	SetWidgetValid(			kDeviceState_PollStats,	true);
+	yLoc			+=	boxHeight;
+	yLoc			+=	4;
 
 	//*	save this info for not supported
 	cFirstBoxXloc	=	nameLeft;
 	cFirstBoxYloc	=	yLoc;
 
-	boxWidth		=	nameWidth + 2 + valueWidth;
 	SetWidget(				kDeviceState_Stats,	nameLeft,		yLoc,	boxWidth,	boxHeight);
 	SetWidgetFont(			kDeviceState_Stats,	kFont_Medium);
 	SetWidgetJustification(	kDeviceState_Stats,	kJustification_Center);
@@ -21,6 +21,7 @@ enum
 	kDeviceState_Title	=	0,
 
 //	kDeviceState_Connected,
+	kDeviceState_PollStats,
 	kDeviceState_Stats,
 
 	kDeviceState_FirstBoxName,